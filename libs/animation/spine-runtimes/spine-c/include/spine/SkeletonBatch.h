@@ -0,0 +1,95 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef SPINE_SKELETONBATCH_H_
+#define SPINE_SKELETONBATCH_H_
+
+#include <spine/Skeleton.h>
+#include <spine/AnimationState.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Updates many skeletons which share the same spSkeletonData at once. Skeletons are updated in small blocks which are split
+ * across threads. The local transforms of a block are copied to arrays holding one field of one bone for every skeleton of
+ * the block, the world transforms are computed bone by bone across the block, with SSE2 or NEON where available, then
+ * stored in the spBone objects, as with spSkeleton_updateWorldTransform. */
+typedef struct spSkeletonBatch {
+	spSkeletonData* const data;
+	const int threadsCount;
+
+	int skeletonsCount;
+	spSkeleton** const skeletons;
+
+#ifdef __cplusplus
+	spSkeletonBatch() :
+		data(0),
+		threadsCount(0),
+		skeletonsCount(0),
+		skeletons(0) {
+	}
+#endif
+} spSkeletonBatch;
+
+/* @param threadsCount The number of threads updating skeletons, including the calling thread. 0 uses one per CPU. */
+spSkeletonBatch* spSkeletonBatch_create (spSkeletonData* data, int threadsCount);
+void spSkeletonBatch_dispose (spSkeletonBatch* self);
+
+/* The skeleton must have been created from the batch's data. The batch does not own the skeleton. */
+void spSkeletonBatch_addSkeleton (spSkeletonBatch* self, spSkeleton* skeleton);
+/* Returns 0 if the skeleton was not found. Skeletons after it move down one index. */
+int spSkeletonBatch_removeSkeleton (spSkeletonBatch* self, spSkeleton* skeleton);
+
+/* Does the same as spSkeleton_updateWorldTransform for every skeleton. Sines and cosines are computed with a polynomial,
+ * so the transforms can differ from spSkeleton_updateWorldTransform by float rounding. */
+void spSkeletonBatch_updateWorldTransform (spSkeletonBatch* self);
+
+/* Calls spAnimationState_apply for each skeleton with states[i] for skeletons[i], then updates the world transforms.
+ * Listeners are called on the thread that applies the state, states of different skeletons are applied concurrently.
+ * @param states May contain 0 for skeletons without animation state. */
+void spSkeletonBatch_apply (spSkeletonBatch* self, spAnimationState** states);
+
+#ifdef SPINE_SHORT_NAMES
+typedef spSkeletonBatch SkeletonBatch;
+#define SkeletonBatch_create(...) spSkeletonBatch_create(__VA_ARGS__)
+#define SkeletonBatch_dispose(...) spSkeletonBatch_dispose(__VA_ARGS__)
+#define SkeletonBatch_addSkeleton(...) spSkeletonBatch_addSkeleton(__VA_ARGS__)
+#define SkeletonBatch_removeSkeleton(...) spSkeletonBatch_removeSkeleton(__VA_ARGS__)
+#define SkeletonBatch_updateWorldTransform(...) spSkeletonBatch_updateWorldTransform(__VA_ARGS__)
+#define SkeletonBatch_apply(...) spSkeletonBatch_apply(__VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPINE_SKELETONBATCH_H_ */
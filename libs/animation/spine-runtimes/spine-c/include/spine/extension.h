@@ -146,6 +146,61 @@ void _spTrackEntry_dispose (spTrackEntry* self);
 
 /**/
 
+typedef struct _spSkinEntry _spSkinEntry;
+struct _spSkinEntry {
+	int slotIndex;
+	const char* name;
+	spAttachment* attachment;
+	_spSkinEntry* next;
+};
+
+typedef struct _spSkin {
+	spSkin super;
+	_spSkinEntry* entries;
+
+#ifdef __cplusplus
+	_spSkin() :
+		super(),
+		entries(0) {
+	}
+#endif
+} _spSkin;
+
+/**/
+
+typedef struct _spAtlas {
+	spAtlas super;
+	int/*bool*/arena; /* Read by spSkeletonBinary into one allocation starting at super. */
+
+#ifdef __cplusplus
+	_spAtlas() :
+		super(),
+		arena(0) {
+	}
+#endif
+} _spAtlas;
+
+int/*bool*/_spAtlas_isBinary (const char* data, int length);
+spAtlas* _spAtlas_createBinary (const char* data, int length, const char* dir, void* rendererObject);
+
+/**/
+
+typedef struct _spSkeletonData {
+	spSkeletonData super;
+	/* Nonzero when spSkeletonBinary read the data into one allocation of this size, starting at super. Only the attachments
+	 * are allocated separately. */
+	size_t arenaSize;
+
+#ifdef __cplusplus
+	_spSkeletonData() :
+		super(),
+		arenaSize(0) {
+	}
+#endif
+} _spSkeletonData;
+
+/**/
+
 void _spAttachmentLoader_init (spAttachmentLoader* self, /**/
 void (*dispose) (spAttachmentLoader* self), /**/
 		spAttachment* (*newAttachment) (spAttachmentLoader* self, spSkin* skin, spAttachmentType type, const char* name,
@@ -179,10 +234,13 @@ void (*dispose) (spTimeline* self), /**/
 		void (*apply) (const spTimeline* self, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
 				int* eventsCount, float alpha));
 void _spTimeline_deinit (spTimeline* self);
+/* For timelines allocated in a skeleton data arena: uses a shared vtable for the type and does not own any memory. */
+void _spTimeline_initArena (spTimeline* self, spTimelineType type);
 
 #ifdef SPINE_SHORT_NAMES
 #define _Timeline_init(...) _spTimeline_init(__VA_ARGS__)
 #define _Timeline_deinit(...) _spTimeline_deinit(__VA_ARGS__)
+#define _Timeline_initArena(...) _spTimeline_initArena(__VA_ARGS__)
 #endif
 
 /**/
@@ -46,6 +46,8 @@
 #include <spine/SkinnedMeshAttachment.h>
 #include <spine/BoundingBoxAttachment.h>
 #include <spine/Skeleton.h>
+#include <spine/SkeletonBatch.h>
+#include <spine/SkeletonBinary.h>
 #include <spine/SkeletonBounds.h>
 #include <spine/SkeletonData.h>
 #include <spine/SkeletonJson.h>
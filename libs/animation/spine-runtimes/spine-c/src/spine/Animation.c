@@ -834,3 +834,27 @@ void spFlipTimeline_setFrame (spFlipTimeline* self, int frameIndex, float time,
 }
 
 /**/
+
+static void _spTimeline_disposeArena (spTimeline* self) {
+	/* The skeleton data arena owns the timeline. */
+}
+
+/* Indexed by spTimelineType. */
+static const _spTimelineVtable arenaVtables[] = {
+	{_spScaleTimeline_apply, _spTimeline_disposeArena},
+	{_spRotateTimeline_apply, _spTimeline_disposeArena},
+	{_spTranslateTimeline_apply, _spTimeline_disposeArena},
+	{_spColorTimeline_apply, _spTimeline_disposeArena},
+	{_spAttachmentTimeline_apply, _spTimeline_disposeArena},
+	{_spEventTimeline_apply, _spTimeline_disposeArena},
+	{_spDrawOrderTimeline_apply, _spTimeline_disposeArena},
+	{_spFFDTimeline_apply, _spTimeline_disposeArena},
+	{_spIkConstraintTimeline_apply, _spTimeline_disposeArena},
+	{_spFlipTimeline_apply, _spTimeline_disposeArena},
+	{_spFlipTimeline_apply, _spTimeline_disposeArena}
+};
+
+void _spTimeline_initArena (spTimeline* self, spTimelineType type) {
+	CONST_CAST(spTimelineType, self->type) = type;
+	CONST_CAST(const _spTimelineVtable*, self->vtable) = &arenaVtables[type];
+}
@@ -184,7 +184,9 @@ spAtlas* spAtlas_create (const char* begin, int length, const char* dir, void* r
 	Str str;
 	Str tuple[4];
 
-	self = NEW(spAtlas);
+	if (_spAtlas_isBinary(begin, length)) return _spAtlas_createBinary(begin, length, dir, rendererObject);
+
+	self = SUPER(NEW(_spAtlas));
 	self->rendererObject = rendererObject;
 
 	readLine(begin, 0, 0);
@@ -324,6 +326,13 @@ spAtlas* spAtlas_createFromFile (const char* path, void* rendererObject) {
 void spAtlas_dispose (spAtlas* self) {
 	spAtlasRegion* region, *nextRegion;
 	spAtlasPage* page = self->pages;
+	if (SUB_CAST(_spAtlas, self)->arena) {
+		for (; page; page = page->next)
+			_spAtlasPage_disposeTexture(page);
+		FREE(self);
+		return;
+	}
+
 	while (page) {
 		spAtlasPage* nextPage = page->next;
 		spAtlasPage_dispose(page);
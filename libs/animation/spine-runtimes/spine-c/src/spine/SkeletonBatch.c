@@ -0,0 +1,611 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <spine/SkeletonBatch.h>
+#include <string.h>
+#include <spine/extension.h>
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SP_BATCH_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SP_BATCH_NEON
+#endif
+
+/* Skeletons are updated in blocks of this many, each block by one thread. A block's bones stay in the L1 cache. */
+#define BLOCK_SIZE 16
+#define MAX_THREADS 64
+
+/* Operations on VEC_WIDTH lanes of floats. VEC_AND_INT ands integral lanes with an int mask. */
+#if defined(SP_BATCH_SSE2)
+#define VEC_WIDTH 4
+typedef __m128 _spVec;
+#define VEC_LOAD(p) _mm_loadu_ps(p)
+#define VEC_STORE(p, a) _mm_storeu_ps(p, a)
+#define VEC_SET(f) _mm_set1_ps(f)
+#define VEC_ADD(a, b) _mm_add_ps(a, b)
+#define VEC_SUB(a, b) _mm_sub_ps(a, b)
+#define VEC_MUL(a, b) _mm_mul_ps(a, b)
+#define VEC_AND_INT(a, mask) _mm_cvtepi32_ps(_mm_and_si128(_mm_cvttps_epi32(a), _mm_set1_epi32(mask)))
+#elif defined(SP_BATCH_NEON)
+#define VEC_WIDTH 4
+typedef float32x4_t _spVec;
+#define VEC_LOAD(p) vld1q_f32(p)
+#define VEC_STORE(p, a) vst1q_f32(p, a)
+#define VEC_SET(f) vdupq_n_f32(f)
+#define VEC_ADD(a, b) vaddq_f32(a, b)
+#define VEC_SUB(a, b) vsubq_f32(a, b)
+#define VEC_MUL(a, b) vmulq_f32(a, b)
+#define VEC_AND_INT(a, mask) vcvtq_f32_s32(vandq_s32(vcvtq_s32_f32(a), vdupq_n_s32(mask)))
+#else
+#define VEC_WIDTH 1
+typedef float _spVec;
+#define VEC_LOAD(p) (*(p))
+#define VEC_STORE(p, a) (*(p) = (a))
+#define VEC_SET(f) (f)
+#define VEC_ADD(a, b) ((a) + (b))
+#define VEC_SUB(a, b) ((a) - (b))
+#define VEC_MUL(a, b) ((a) * (b))
+#define VEC_AND_INT(a, mask) ((float)((int)(a) & (mask)))
+#endif
+
+/* Local and world transforms of one bone for a block of skeletons. Flips are stored as 1 or -1 so that they combine by
+ * multiplying. The local transforms of root bones already include the skeleton's flips. */
+typedef struct {
+	float x[BLOCK_SIZE], y[BLOCK_SIZE], rotation[BLOCK_SIZE];
+	float scaleX[BLOCK_SIZE], scaleY[BLOCK_SIZE];
+	float flipX[BLOCK_SIZE], flipY[BLOCK_SIZE];
+
+	float m00[BLOCK_SIZE], m01[BLOCK_SIZE], worldX[BLOCK_SIZE];
+	float m10[BLOCK_SIZE], m11[BLOCK_SIZE], worldY[BLOCK_SIZE];
+	float worldRotation[BLOCK_SIZE];
+	float worldScaleX[BLOCK_SIZE], worldScaleY[BLOCK_SIZE];
+	float worldFlipX[BLOCK_SIZE], worldFlipY[BLOCK_SIZE];
+} _spBoneLanes;
+
+struct _spSkeletonBatch;
+
+typedef struct {
+	struct _spSkeletonBatch* batch;
+	int generation;
+
+	/* One entry per bone, reused for every block the worker updates. */
+	_spBoneLanes* lanes;
+
+#ifdef _WIN32
+	HANDLE thread;
+#else
+	pthread_t thread;
+#endif
+} _spSkeletonBatchWorker;
+
+typedef struct _spSkeletonBatch {
+	spSkeletonBatch super;
+
+	int skeletonsCapacity;
+
+	/* Index of each bone's parent, -1 for the root, and the first stage which updates the bone. */
+	int* parents;
+	int* firstStages;
+
+	/* The bones of stage i are updated before IK constraint i is applied, as in spSkeleton_updateCache. */
+	int stagesCount;
+	int* stageBonesCounts;
+	int** stageBones;
+
+	/* The bones of the skeletons, BLOCK_SIZE entries per bone for the first block of skeletons, then for the second block
+	 * and so on. */
+	spBone** bones;
+
+	/* workers[0] is the calling thread. */
+	_spSkeletonBatchWorker* workers;
+
+	spAnimationState** states;
+	int nextBlock;
+
+#ifdef _WIN32
+	CRITICAL_SECTION lock;
+	CONDITION_VARIABLE start;
+	CONDITION_VARIABLE done;
+#else
+	pthread_mutex_t lock;
+	pthread_cond_t start;
+	pthread_cond_t done;
+#endif
+	int generation;
+	int busy;
+	int quit;
+} _spSkeletonBatch;
+
+static void _lock (_spSkeletonBatch* internal) {
+#ifdef _WIN32
+	EnterCriticalSection(&internal->lock);
+#else
+	pthread_mutex_lock(&internal->lock);
+#endif
+}
+
+static void _unlock (_spSkeletonBatch* internal) {
+#ifdef _WIN32
+	LeaveCriticalSection(&internal->lock);
+#else
+	pthread_mutex_unlock(&internal->lock);
+#endif
+}
+
+/* Returns the IK constraint whose bones include the bone or one of its ancestors, -1 if there is none. */
+static int _findIkConstraint (spSkeletonData* data, spBoneData* bone) {
+	int i;
+	spBoneData* current = bone;
+	do {
+		for (i = 0; i < data->ikConstraintsCount; ++i) {
+			spIkConstraintData* ikConstraint = data->ikConstraints[i];
+			spBoneData* parent = ikConstraint->bones[0];
+			spBoneData* child = ikConstraint->bones[ikConstraint->bonesCount - 1];
+			while (1) {
+				if (current == child) return i;
+				if (child == parent) break;
+				child = child->parent;
+			}
+		}
+		current = current->parent;
+	} while (current);
+	return -1;
+}
+
+/* Sets the sines and cosines of angles in degrees. The angles are reduced to [-45, 45] degrees around the nearest multiple
+ * of 90 degrees and the polynomials of Cephes' sinf and cosf are used. There are no branches or calls, unlike sinf and cosf. */
+static void _sinCos (_spVec degrees, _spVec* sine, _spVec* cosine) {
+	_spVec quadrants = VEC_SUB(VEC_ADD(VEC_MUL(degrees, VEC_SET(1.0f / 90.0f)), VEC_SET(12582912.0f)), VEC_SET(12582912.0f));
+	_spVec x = VEC_MUL(VEC_SUB(degrees, VEC_MUL(quadrants, VEC_SET(90.0f))), VEC_SET(DEG_RAD));
+	_spVec z = VEC_MUL(x, x);
+	_spVec s = VEC_MUL(VEC_ADD(VEC_MUL(VEC_ADD(VEC_MUL(VEC_SET(-1.9515295891e-4f), z), VEC_SET(8.3321608736e-3f)), z),
+			VEC_SET(-1.6666654611e-1f)), z);
+	_spVec c = VEC_MUL(VEC_ADD(VEC_MUL(VEC_ADD(VEC_MUL(VEC_SET(2.443315711809948e-5f), z), VEC_SET(-1.388731625493765e-3f)), z),
+			VEC_SET(4.166664568298827e-2f)), VEC_MUL(z, z));
+	_spVec sign = VEC_SUB(VEC_SET(1.0f), VEC_AND_INT(quadrants, 2));
+	_spVec odd = VEC_AND_INT(quadrants, 1), even = VEC_SUB(VEC_SET(1.0f), odd);
+	s = VEC_ADD(VEC_MUL(s, x), x);
+	c = VEC_ADD(VEC_SUB(c, VEC_MUL(VEC_SET(0.5f), z)), VEC_SET(1.0f));
+	*sine = VEC_MUL(VEC_ADD(VEC_MUL(c, odd), VEC_MUL(s, even)), sign);
+	*cosine = VEC_MUL(VEC_SUB(VEC_MUL(c, even), VEC_MUL(s, odd)), sign);
+}
+
+/* Copies the local transforms of the bones of a block of skeletons to the lanes. */
+static void _gather (_spSkeletonBatch* internal, _spBoneLanes* lanes, spSkeleton** skeletons, int start, int count,
+		int yDown) {
+	int bonesCount = SUPER(internal)->data->bonesCount;
+	spBone** bones = internal->bones + start / BLOCK_SIZE * bonesCount * BLOCK_SIZE;
+	int boneIndex, i;
+
+	for (boneIndex = 0; boneIndex < bonesCount; ++boneIndex, bones += BLOCK_SIZE) {
+		_spBoneLanes* bone = lanes + boneIndex;
+		for (i = 0; i < count; ++i) {
+			spBone* source = bones[i];
+			source->rotationIK = source->rotation;
+			bone->x[i] = source->x;
+			bone->y[i] = source->y;
+			bone->rotation[i] = source->rotation;
+			bone->scaleX[i] = source->scaleX;
+			bone->scaleY[i] = source->scaleY;
+			bone->flipX[i] = source->flipX ? -1.0f : 1.0f;
+			bone->flipY[i] = source->flipY ? -1.0f : 1.0f;
+		}
+		if (internal->parents[boneIndex] >= 0) continue;
+		for (i = 0; i < count; ++i) {
+			spSkeleton* skeleton = skeletons[i];
+			if (skeleton->flipX) {
+				bone->x[i] = -bone->x[i];
+				bone->flipX[i] = -bone->flipX[i];
+			}
+			if (skeleton->flipY != yDown) bone->y[i] = -bone->y[i];
+			if (skeleton->flipY) bone->flipY[i] = -bone->flipY[i];
+		}
+	}
+}
+
+/* Computes the world transforms of a bone in the lanes from its local transforms and its parent's world transforms. */
+static void _updateBone (_spSkeletonBatch* internal, _spBoneLanes* lanes, int boneIndex, int yDown) {
+	spBoneData* data = SUPER(internal)->data->bones[boneIndex];
+	_spBoneLanes* bone = lanes + boneIndex;
+	_spBoneLanes* parent = internal->parents[boneIndex] >= 0 ? lanes + internal->parents[boneIndex] : 0;
+	_spVec ySign = VEC_SET(yDown ? -1.0f : 1.0f);
+	int i;
+
+	for (i = 0; i < BLOCK_SIZE; i += VEC_WIDTH) {
+		_spVec x = VEC_LOAD(bone->x + i), y = VEC_LOAD(bone->y + i), rotation = VEC_LOAD(bone->rotation + i);
+		_spVec scaleX = VEC_LOAD(bone->scaleX + i), scaleY = VEC_LOAD(bone->scaleY + i);
+		_spVec flipX = VEC_LOAD(bone->flipX + i), flipY = VEC_LOAD(bone->flipY + i);
+		_spVec sine, cosine, signX, signY;
+
+		if (parent) {
+			_spVec localX = x;
+			x = VEC_ADD(VEC_ADD(VEC_MUL(localX, VEC_LOAD(parent->m00 + i)), VEC_MUL(y, VEC_LOAD(parent->m01 + i))),
+					VEC_LOAD(parent->worldX + i));
+			y = VEC_ADD(VEC_ADD(VEC_MUL(localX, VEC_LOAD(parent->m10 + i)), VEC_MUL(y, VEC_LOAD(parent->m11 + i))),
+					VEC_LOAD(parent->worldY + i));
+			if (data->inheritScale) {
+				scaleX = VEC_MUL(scaleX, VEC_LOAD(parent->worldScaleX + i));
+				scaleY = VEC_MUL(scaleY, VEC_LOAD(parent->worldScaleY + i));
+			}
+			if (data->inheritRotation) rotation = VEC_ADD(rotation, VEC_LOAD(parent->worldRotation + i));
+			flipX = VEC_MUL(flipX, VEC_LOAD(parent->worldFlipX + i));
+			flipY = VEC_MUL(flipY, VEC_LOAD(parent->worldFlipY + i));
+		}
+		_sinCos(rotation, &sine, &cosine);
+		signX = flipX;
+		signY = VEC_MUL(flipY, ySign);
+
+		VEC_STORE(bone->m00 + i, VEC_MUL(VEC_MUL(cosine, signX), scaleX));
+		VEC_STORE(bone->m01 + i, VEC_SUB(VEC_SET(0.0f), VEC_MUL(VEC_MUL(sine, signX), scaleY)));
+		VEC_STORE(bone->m10 + i, VEC_MUL(VEC_MUL(sine, signY), scaleX));
+		VEC_STORE(bone->m11 + i, VEC_MUL(VEC_MUL(cosine, signY), scaleY));
+		VEC_STORE(bone->worldX + i, x);
+		VEC_STORE(bone->worldY + i, y);
+		VEC_STORE(bone->worldRotation + i, rotation);
+		VEC_STORE(bone->worldScaleX + i, scaleX);
+		VEC_STORE(bone->worldScaleY + i, scaleY);
+		VEC_STORE(bone->worldFlipX + i, flipX);
+		VEC_STORE(bone->worldFlipY + i, flipY);
+	}
+}
+
+/* Copies the world transforms of a bone from the lanes to the bones of a block of skeletons. */
+static void _scatter (_spSkeletonBatch* internal, _spBoneLanes* lanes, int boneIndex, int start, int count) {
+	_spBoneLanes* bone = lanes + boneIndex;
+	spBone** bones = internal->bones + (start / BLOCK_SIZE * SUPER(internal)->data->bonesCount + boneIndex) * BLOCK_SIZE;
+	int i;
+	for (i = 0; i < count; ++i) {
+		spBone* target = bones[i];
+		CONST_CAST(float, target->m00) = bone->m00[i];
+		CONST_CAST(float, target->m01) = bone->m01[i];
+		CONST_CAST(float, target->m10) = bone->m10[i];
+		CONST_CAST(float, target->m11) = bone->m11[i];
+		CONST_CAST(float, target->worldX) = bone->worldX[i];
+		CONST_CAST(float, target->worldY) = bone->worldY[i];
+		CONST_CAST(float, target->worldRotation) = bone->worldRotation[i];
+		CONST_CAST(float, target->worldScaleX) = bone->worldScaleX[i];
+		CONST_CAST(float, target->worldScaleY) = bone->worldScaleY[i];
+		CONST_CAST(int, target->worldFlipX) = bone->worldFlipX[i] < 0;
+		CONST_CAST(int, target->worldFlipY) = bone->worldFlipY[i] < 0;
+	}
+}
+
+static void _updateBlock (_spSkeletonBatch* internal, _spBoneLanes* lanes, int start, int count) {
+	spSkeleton** skeletons = SUPER(internal)->skeletons + start;
+	spBone** blockBones = internal->bones + start / BLOCK_SIZE * SUPER(internal)->data->bonesCount * BLOCK_SIZE;
+	int yDown = spBone_isYDown();
+	int stage, boneIndex, i, ii;
+
+	_gather(internal, lanes, skeletons, start, count, yDown);
+	stage = 0;
+	while (1) {
+		for (ii = 0; ii < internal->stageBonesCounts[stage]; ++ii) {
+			boneIndex = internal->stageBones[stage][ii];
+			/* After an IK constraint, only the rotations it set have changed. */
+			if (stage > 0) {
+				for (i = 0; i < count; ++i)
+					lanes[boneIndex].rotation[i] = blockBones[boneIndex * BLOCK_SIZE + i]->rotationIK;
+			}
+			_updateBone(internal, lanes, boneIndex, yDown);
+			_scatter(internal, lanes, boneIndex, start, count);
+		}
+		if (stage == internal->stagesCount - 1) break;
+		for (i = 0; i < count; ++i)
+			spIkConstraint_apply(skeletons[i]->ikConstraints[stage]);
+		stage++;
+	}
+}
+
+/* Applies animations and updates blocks of skeletons until there are none left. Called by all threads. */
+static void _run (_spSkeletonBatchWorker* worker) {
+	_spSkeletonBatch* internal = worker->batch;
+	spSkeletonBatch* self = SUPER(internal);
+	int start, count, i;
+	while (1) {
+		if (self->threadsCount > 1) _lock(internal);
+		start = internal->nextBlock++ * BLOCK_SIZE;
+		if (self->threadsCount > 1) _unlock(internal);
+		if (start >= self->skeletonsCount) break;
+
+		count = self->skeletonsCount - start < BLOCK_SIZE ? self->skeletonsCount - start : BLOCK_SIZE;
+		if (internal->states) {
+			for (i = start; i < start + count; ++i)
+				if (internal->states[i]) spAnimationState_apply(internal->states[i], self->skeletons[i]);
+		}
+		_updateBlock(internal, worker->lanes, start, count);
+	}
+}
+
+#ifdef _WIN32
+static DWORD WINAPI _workerMain (LPVOID arg) {
+#else
+static void* _workerMain (void* arg) {
+#endif
+	_spSkeletonBatchWorker* worker = (_spSkeletonBatchWorker*)arg;
+	_spSkeletonBatch* internal = worker->batch;
+
+	_lock(internal);
+	while (1) {
+		while (worker->generation == internal->generation && !internal->quit) {
+#ifdef _WIN32
+			SleepConditionVariableCS(&internal->start, &internal->lock, INFINITE);
+#else
+			pthread_cond_wait(&internal->start, &internal->lock);
+#endif
+		}
+		if (internal->quit) break;
+		worker->generation = internal->generation;
+		_unlock(internal);
+
+		_run(worker);
+
+		_lock(internal);
+		if (--internal->busy == 0) {
+#ifdef _WIN32
+			WakeConditionVariable(&internal->done);
+#else
+			pthread_cond_signal(&internal->done);
+#endif
+		}
+	}
+	_unlock(internal);
+	return 0;
+}
+
+static void _destroyLock (_spSkeletonBatch* internal) {
+#ifdef _WIN32
+	DeleteCriticalSection(&internal->lock);
+#else
+	pthread_cond_destroy(&internal->start);
+	pthread_cond_destroy(&internal->done);
+	pthread_mutex_destroy(&internal->lock);
+#endif
+}
+
+static int _cpuCount () {
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (int)info.dwNumberOfProcessors;
+#else
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (int)count : 1;
+#endif
+}
+
+spSkeletonBatch* spSkeletonBatch_create (spSkeletonData* data, int threadsCount) {
+	int i, ii, stage;
+	_spSkeletonBatch* internal = NEW(_spSkeletonBatch);
+	spSkeletonBatch* self = SUPER(internal);
+	CONST_CAST(spSkeletonData*, self->data) = data;
+
+	internal->parents = MALLOC(int, data->bonesCount);
+	for (i = 0; i < data->bonesCount; ++i) {
+		internal->parents[i] = -1;
+		for (ii = 0; ii < i; ++ii) {
+			if (data->bones[ii] == data->bones[i]->parent) {
+				internal->parents[i] = ii;
+				break;
+			}
+		}
+	}
+
+	/* Bones constrained by IK constraint i, or whose ancestors are, are updated before and after it is applied. */
+	internal->stagesCount = data->ikConstraintsCount + 1;
+	internal->stageBonesCounts = CALLOC(int, internal->stagesCount);
+	internal->stageBones = MALLOC(int*, internal->stagesCount);
+	internal->firstStages = MALLOC(int, data->bonesCount);
+	for (i = 0; i < data->bonesCount; ++i) {
+		stage = _findIkConstraint(data, data->bones[i]);
+		internal->firstStages[i] = stage >= 0 ? stage : 0;
+		if (stage >= 0) {
+			internal->stageBonesCounts[stage]++;
+			internal->stageBonesCounts[stage + 1]++;
+		} else
+			internal->stageBonesCounts[0]++;
+	}
+	for (i = 0; i < internal->stagesCount; ++i)
+		internal->stageBones[i] = MALLOC(int, internal->stageBonesCounts[i]);
+	memset(internal->stageBonesCounts, 0, internal->stagesCount * sizeof(int));
+	for (i = 0; i < data->bonesCount; ++i) {
+		stage = _findIkConstraint(data, data->bones[i]);
+		if (stage >= 0) {
+			internal->stageBones[stage][internal->stageBonesCounts[stage]++] = i;
+			internal->stageBones[stage + 1][internal->stageBonesCounts[stage + 1]++] = i;
+		} else
+			internal->stageBones[0][internal->stageBonesCounts[0]++] = i;
+	}
+
+	if (threadsCount <= 0) threadsCount = _cpuCount();
+	if (threadsCount > MAX_THREADS) threadsCount = MAX_THREADS;
+	internal->workers = CALLOC(_spSkeletonBatchWorker, threadsCount);
+	for (i = 0; i < threadsCount; ++i)
+		internal->workers[i].batch = internal;
+
+	if (threadsCount > 1) {
+#ifdef _WIN32
+		InitializeCriticalSection(&internal->lock);
+		InitializeConditionVariable(&internal->start);
+		InitializeConditionVariable(&internal->done);
+#else
+		pthread_mutex_init(&internal->lock, 0);
+		pthread_cond_init(&internal->start, 0);
+		pthread_cond_init(&internal->done, 0);
+#endif
+		for (i = 1; i < threadsCount; ++i) {
+#ifdef _WIN32
+			internal->workers[i].thread = CreateThread(0, 0, _workerMain, &internal->workers[i], 0, 0);
+			if (!internal->workers[i].thread) break;
+#else
+			if (pthread_create(&internal->workers[i].thread, 0, _workerMain, &internal->workers[i]) != 0) break;
+#endif
+		}
+		threadsCount = i;
+		if (threadsCount == 1) _destroyLock(internal);
+	}
+	CONST_CAST(int, self->threadsCount) = threadsCount;
+	/* Lanes past the last skeleton of a partial block are computed but not stored, they only need to hold numbers. */
+	for (i = 0; i < threadsCount; ++i)
+		internal->workers[i].lanes = CALLOC(_spBoneLanes, data->bonesCount);
+
+	return self;
+}
+
+void spSkeletonBatch_dispose (spSkeletonBatch* self) {
+	int i;
+	_spSkeletonBatch* internal = SUB_CAST(_spSkeletonBatch, self);
+
+	if (self->threadsCount > 1) {
+		_lock(internal);
+		internal->quit = 1;
+#ifdef _WIN32
+		WakeAllConditionVariable(&internal->start);
+#else
+		pthread_cond_broadcast(&internal->start);
+#endif
+		_unlock(internal);
+		for (i = 1; i < self->threadsCount; ++i) {
+#ifdef _WIN32
+			WaitForSingleObject(internal->workers[i].thread, INFINITE);
+			CloseHandle(internal->workers[i].thread);
+#else
+			pthread_join(internal->workers[i].thread, 0);
+#endif
+		}
+		_destroyLock(internal);
+	}
+	for (i = 0; i < self->threadsCount; ++i)
+		FREE(internal->workers[i].lanes);
+	FREE(internal->workers);
+
+	for (i = 0; i < internal->stagesCount; ++i)
+		FREE(internal->stageBones[i]);
+	FREE(internal->stageBones);
+	FREE(internal->stageBonesCounts);
+	FREE(internal->parents);
+	FREE(internal->firstStages);
+	FREE(internal->bones);
+	FREE(self->skeletons);
+	FREE(self);
+}
+
+static void _setBones (_spSkeletonBatch* internal, int index, spSkeleton* skeleton) {
+	int i, bonesCount = skeleton->bonesCount;
+	spBone** bones = internal->bones + index / BLOCK_SIZE * bonesCount * BLOCK_SIZE + index % BLOCK_SIZE;
+	for (i = 0; i < bonesCount; ++i)
+		bones[i * BLOCK_SIZE] = skeleton->bones[i];
+}
+
+void spSkeletonBatch_addSkeleton (spSkeletonBatch* self, spSkeleton* skeleton) {
+	_spSkeletonBatch* internal = SUB_CAST(_spSkeletonBatch, self);
+
+	if (self->skeletonsCount == internal->skeletonsCapacity) {
+		int capacity = internal->skeletonsCapacity ? internal->skeletonsCapacity * 2 : BLOCK_SIZE;
+		int size = self->data->bonesCount * capacity;
+		spSkeleton** skeletons = MALLOC(spSkeleton*, capacity);
+		spBone** bones = MALLOC(spBone*, size);
+		memcpy(skeletons, self->skeletons, self->skeletonsCount * sizeof(spSkeleton*));
+		memcpy(bones, internal->bones, self->data->bonesCount * internal->skeletonsCapacity * sizeof(spBone*));
+		FREE(self->skeletons);
+		FREE(internal->bones);
+		CONST_CAST(spSkeleton**, self->skeletons) = skeletons;
+		internal->bones = bones;
+		internal->skeletonsCapacity = capacity;
+	}
+	_setBones(internal, self->skeletonsCount, skeleton);
+	self->skeletons[self->skeletonsCount++] = skeleton;
+}
+
+int spSkeletonBatch_removeSkeleton (spSkeletonBatch* self, spSkeleton* skeleton) {
+	int i, ii;
+	_spSkeletonBatch* internal = SUB_CAST(_spSkeletonBatch, self);
+	for (i = 0; i < self->skeletonsCount; ++i) {
+		if (self->skeletons[i] != skeleton) continue;
+		self->skeletonsCount--;
+		for (ii = i; ii < self->skeletonsCount; ++ii) {
+			self->skeletons[ii] = self->skeletons[ii + 1];
+			_setBones(internal, ii, self->skeletons[ii]);
+		}
+		return 1;
+	}
+	return 0;
+}
+
+static void _runAll (spSkeletonBatch* self, spAnimationState** states) {
+	_spSkeletonBatch* internal = SUB_CAST(_spSkeletonBatch, self);
+
+	internal->states = states;
+	internal->nextBlock = 0;
+	if (self->threadsCount == 1 || self->skeletonsCount <= BLOCK_SIZE) {
+		_run(&internal->workers[0]);
+		return;
+	}
+
+	_lock(internal);
+	internal->generation++;
+	internal->busy = self->threadsCount - 1;
+#ifdef _WIN32
+	WakeAllConditionVariable(&internal->start);
+#else
+	pthread_cond_broadcast(&internal->start);
+#endif
+	_unlock(internal);
+
+	_run(&internal->workers[0]);
+
+	_lock(internal);
+	while (internal->busy > 0) {
+#ifdef _WIN32
+		SleepConditionVariableCS(&internal->done, &internal->lock, INFINITE);
+#else
+		pthread_cond_wait(&internal->done, &internal->lock);
+#endif
+	}
+	_unlock(internal);
+}
+
+void spSkeletonBatch_updateWorldTransform (spSkeletonBatch* self) {
+	_runAll(self, 0);
+}
+
+void spSkeletonBatch_apply (spSkeletonBatch* self, spAnimationState** states) {
+	_runAll(self, states);
+}
@@ -0,0 +1,1482 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <spine/SkeletonBinary.h>
+#include <limits.h>
+#include <spine/extension.h>
+#include <spine/AtlasAttachmentLoader.h>
+
+/* A file is a magic, a version byte, the counts that size the arena pools and then the data in the order spSkeletonJson reads
+ * it. Counts and indices are varints (unsigned LEB128), signed values are zigzag varints, floats are 4 byte little endian and
+ * strings are a varint of the length including the terminating 0 followed by that many bytes, or a 0 varint for null. */
+
+static const unsigned char SKELETON_MAGIC[] = {0, 'S', 'P', 'S'};
+static const unsigned char ATLAS_MAGIC[] = {0, 'S', 'P', 'A'};
+static const int VERSION = 1;
+
+/* As in Animation.c. */
+static const int CURVE_BEZIER = 2;
+static const int BEZIER_SIZE = 10 * 2 - 1;
+
+/* The pools of a skeleton data arena, in the order of the header counts. The strings pool is always the last. */
+typedef enum {
+	POOL_BONES,
+	POOL_SLOTS,
+	POOL_IK_CONSTRAINTS,
+	POOL_SKINS,
+	POOL_SKIN_ENTRIES,
+	POOL_EVENTS,
+	POOL_ANIMATIONS,
+	POOL_BASE_TIMELINES, /* Rotate, translate, scale, color and IK constraint timelines all have the spBaseTimeline layout. */
+	POOL_ATTACHMENT_TIMELINES,
+	POOL_EVENT_TIMELINES,
+	POOL_DRAW_ORDER_TIMELINES,
+	POOL_FFD_TIMELINES,
+	POOL_FLIP_TIMELINES,
+	POOL_TIMELINE_EVENTS,
+	POOL_POINTERS, /* Elements of all the pointer arrays. */
+	POOL_FLOATS, /* Frames, curves and FFD vertices. */
+	POOL_INTS, /* Draw orders. */
+	POOLS
+} _Pool;
+
+/* The pools of an atlas arena. */
+typedef enum {
+	ATLAS_POOL_PAGES, ATLAS_POOL_REGIONS, ATLAS_POOL_INTS, ATLAS_POOLS
+} _AtlasPool;
+
+static const size_t poolElementSizes[] = {sizeof(spBoneData), sizeof(spSlotData), sizeof(spIkConstraintData), sizeof(_spSkin),
+		sizeof(_spSkinEntry), sizeof(spEventData), sizeof(spAnimation), sizeof(spBaseTimeline), sizeof(spAttachmentTimeline),
+		sizeof(spEventTimeline), sizeof(spDrawOrderTimeline), sizeof(spFFDTimeline), sizeof(spFlipTimeline), sizeof(spEvent),
+		sizeof(void*), sizeof(float), sizeof(int)};
+static const size_t atlasPoolElementSizes[] = {sizeof(spAtlasPage), sizeof(spAtlasRegion), sizeof(int)};
+
+#define ALIGN(SIZE) (((SIZE) + 7) & ~(size_t)7)
+
+/**/
+
+typedef struct {
+	unsigned char* data;
+	int length, capacity;
+	int counts[POOLS];
+	int stringsLength;
+} _Output;
+
+static void _Output_ensure (_Output* self, int size) {
+	unsigned char* data;
+	if (self->length + size <= self->capacity) return;
+	self->capacity = self->capacity * 2 > self->length + size ? self->capacity * 2 : self->length + size + 256;
+	data = MALLOC(unsigned char, self->capacity);
+	if (self->length) memcpy(data, self->data, self->length);
+	FREE(self->data);
+	self->data = data;
+}
+
+static void _Output_dispose (_Output* self) {
+	FREE(self->data);
+}
+
+static void _writeBytes (_Output* self, const void* bytes, int length) {
+	_Output_ensure(self, length);
+	memcpy(self->data + self->length, bytes, length);
+	self->length += length;
+}
+
+static void _writeByte (_Output* self, int value) {
+	_Output_ensure(self, 1);
+	self->data[self->length++] = (unsigned char)value;
+}
+
+static void _writeVarint (_Output* self, unsigned int value) {
+	_Output_ensure(self, 5);
+	while (value > 0x7f) {
+		self->data[self->length++] = (unsigned char)(value | 0x80);
+		value >>= 7;
+	}
+	self->data[self->length++] = (unsigned char)value;
+}
+
+static void _writeInt (_Output* self, int value) {
+	_writeVarint(self, value < 0 ? ~((unsigned int)value << 1) : (unsigned int)value << 1);
+}
+
+static void _writeFloats (_Output* self, const float* values, int count) {
+	int i;
+	_Output_ensure(self, count * 4);
+	for (i = 0; i < count; ++i) {
+		union {
+			float f;
+			unsigned int i;
+		} value;
+		unsigned char* bytes = self->data + self->length + i * 4;
+		value.f = values[i];
+		bytes[0] = (unsigned char)value.i;
+		bytes[1] = (unsigned char)(value.i >> 8);
+		bytes[2] = (unsigned char)(value.i >> 16);
+		bytes[3] = (unsigned char)(value.i >> 24);
+	}
+	self->length += count * 4;
+}
+
+static void _writeFloat (_Output* self, float value) {
+	_writeFloats(self, &value, 1);
+}
+
+/* Strings the reader keeps are counted for the strings pool. The others are only passed to the attachment loader. */
+static void _writeString (_Output* self, const char* value, int/*bool*/keep) {
+	int length;
+	if (!value) {
+		_writeVarint(self, 0);
+		return;
+	}
+	length = (int)strlen(value) + 1;
+	_writeVarint(self, length);
+	_writeBytes(self, value, length);
+	if (keep) self->stringsLength += length;
+}
+
+/* Writes the magic, the version, the pool counts and then the body. */
+static unsigned char* _writeFile (_Output* body, const unsigned char* magic, const int* counts, int countsCount, int* length) {
+	_Output output;
+	int i;
+	memset(&output, 0, sizeof(output));
+	_writeBytes(&output, magic, 4);
+	_writeByte(&output, VERSION);
+	for (i = 0; i < countsCount; ++i)
+		_writeVarint(&output, counts[i]);
+	_writeVarint(&output, body->stringsLength);
+	_writeBytes(&output, body->data, body->length);
+	_Output_dispose(body);
+	*length = output.length;
+	return output.data;
+}
+
+/**/
+
+static int _indexOf (void** values, int count, const void* value) {
+	int i;
+	for (i = 0; i < count; ++i)
+		if (values[i] == value) return i;
+	return -1;
+}
+
+static void _writeCurveTimeline (_Output* self, const spCurveTimeline* timeline, int index, const float* frames, int framesCount,
+		int frameSize) {
+	int i;
+	_writeVarint(self, index);
+	_writeVarint(self, framesCount);
+	_writeFloats(self, frames, framesCount * frameSize);
+	for (i = 0; i < framesCount - 1; ++i) {
+		const float* curve = timeline->curves + i * BEZIER_SIZE;
+		_writeByte(self, (int)curve[0]);
+		if (curve[0] == CURVE_BEZIER) _writeFloats(self, curve + 1, BEZIER_SIZE - 1);
+	}
+	self->counts[POOL_BASE_TIMELINES]++;
+	self->counts[POOL_FLOATS] += framesCount * frameSize + (framesCount - 1) * BEZIER_SIZE;
+}
+
+/* Returns 0 if the attachment of an FFD timeline is not in a skin. */
+static int _writeTimeline (_Output* self, const spSkeletonData* skeletonData, const spTimeline* timeline) {
+	int i, ii;
+	_writeByte(self, timeline->type);
+	switch (timeline->type) {
+	case SP_TIMELINE_ROTATE: {
+		const spRotateTimeline* rotate = SUB_CAST(spRotateTimeline, timeline);
+		_writeCurveTimeline(self, SUPER(rotate), rotate->boneIndex, rotate->frames, rotate->framesCount / 2, 2);
+		break;
+	}
+	case SP_TIMELINE_TRANSLATE:
+	case SP_TIMELINE_SCALE: {
+		const spTranslateTimeline* translate = SUB_CAST(spTranslateTimeline, timeline);
+		_writeCurveTimeline(self, SUPER(translate), translate->boneIndex, translate->frames, translate->framesCount / 3, 3);
+		break;
+	}
+	case SP_TIMELINE_COLOR: {
+		const spColorTimeline* color = SUB_CAST(spColorTimeline, timeline);
+		_writeCurveTimeline(self, SUPER(color), color->slotIndex, color->frames, color->framesCount / 5, 5);
+		break;
+	}
+	case SP_TIMELINE_IKCONSTRAINT: {
+		const spIkConstraintTimeline* ik = SUB_CAST(spIkConstraintTimeline, timeline);
+		_writeCurveTimeline(self, SUPER(ik), ik->ikConstraintIndex, ik->frames, ik->framesCount / 3, 3);
+		break;
+	}
+	case SP_TIMELINE_ATTACHMENT: {
+		const spAttachmentTimeline* attachment = SUB_CAST(spAttachmentTimeline, timeline);
+		_writeVarint(self, attachment->slotIndex);
+		_writeVarint(self, attachment->framesCount);
+		_writeFloats(self, attachment->frames, attachment->framesCount);
+		for (i = 0; i < attachment->framesCount; ++i)
+			_writeString(self, attachment->attachmentNames[i], 1);
+		self->counts[POOL_ATTACHMENT_TIMELINES]++;
+		self->counts[POOL_FLOATS] += attachment->framesCount;
+		self->counts[POOL_POINTERS] += attachment->framesCount;
+		break;
+	}
+	case SP_TIMELINE_EVENT: {
+		const spEventTimeline* event = SUB_CAST(spEventTimeline, timeline);
+		_writeVarint(self, event->framesCount);
+		_writeFloats(self, event->frames, event->framesCount);
+		for (i = 0; i < event->framesCount; ++i) {
+			const spEvent* frameEvent = event->events[i];
+			_writeVarint(self, _indexOf((void**)skeletonData->events, skeletonData->eventsCount, frameEvent->data));
+			_writeInt(self, frameEvent->intValue);
+			_writeFloat(self, frameEvent->floatValue);
+			_writeString(self, frameEvent->stringValue, 1);
+		}
+		self->counts[POOL_EVENT_TIMELINES]++;
+		self->counts[POOL_TIMELINE_EVENTS] += event->framesCount;
+		self->counts[POOL_FLOATS] += event->framesCount;
+		self->counts[POOL_POINTERS] += event->framesCount;
+		break;
+	}
+	case SP_TIMELINE_DRAWORDER: {
+		const spDrawOrderTimeline* drawOrder = SUB_CAST(spDrawOrderTimeline, timeline);
+		_writeVarint(self, drawOrder->framesCount);
+		_writeVarint(self, drawOrder->slotsCount);
+		_writeFloats(self, drawOrder->frames, drawOrder->framesCount);
+		for (i = 0; i < drawOrder->framesCount; ++i) {
+			_writeByte(self, drawOrder->drawOrders[i] != 0);
+			if (!drawOrder->drawOrders[i]) continue;
+			for (ii = 0; ii < drawOrder->slotsCount; ++ii)
+				_writeVarint(self, drawOrder->drawOrders[i][ii]);
+			self->counts[POOL_INTS] += drawOrder->slotsCount;
+		}
+		self->counts[POOL_DRAW_ORDER_TIMELINES]++;
+		self->counts[POOL_FLOATS] += drawOrder->framesCount;
+		self->counts[POOL_POINTERS] += drawOrder->framesCount;
+		break;
+	}
+	case SP_TIMELINE_FFD: {
+		const spFFDTimeline* ffd = SUB_CAST(spFFDTimeline, timeline);
+		const float* setupVertices = ffd->attachment->type == SP_ATTACHMENT_MESH ?
+				SUB_CAST(spMeshAttachment, ffd->attachment)->vertices : 0;
+		int skinIndex, entryIndex = -1;
+
+		/* The reader finds the attachment by the position of its entry in the skin. */
+		for (skinIndex = 0; skinIndex < skeletonData->skinsCount && entryIndex == -1; ++skinIndex) {
+			const _spSkinEntry* entry = SUB_CAST(_spSkin, skeletonData->skins[skinIndex])->entries;
+			for (i = 0; entry; entry = entry->next, ++i) {
+				if (entry->attachment == ffd->attachment && entry->slotIndex == ffd->slotIndex) {
+					entryIndex = i;
+					break;
+				}
+			}
+		}
+		if (entryIndex == -1) return 0;
+		_writeVarint(self, skinIndex - 1);
+		_writeVarint(self, ffd->slotIndex);
+		_writeVarint(self, entryIndex);
+		_writeVarint(self, ffd->framesCount);
+		_writeVarint(self, ffd->frameVerticesCount);
+		_writeFloats(self, ffd->frames, ffd->framesCount);
+		for (i = 0; i < ffd->framesCount - 1; ++i) {
+			const float* curve = SUPER(ffd)->curves + i * BEZIER_SIZE;
+			_writeByte(self, (int)curve[0]);
+			if (curve[0] == CURVE_BEZIER) _writeFloats(self, curve + 1, BEZIER_SIZE - 1);
+		}
+		/* Vertices are stored relative to the setup pose with the unchanged vertices at both ends left out. */
+		for (i = 0; i < ffd->framesCount; ++i) {
+			const float* vertices = ffd->frameVertices[i];
+			int start = 0, end = vertices ? ffd->frameVerticesCount : 0;
+			while (start < end && vertices[start] == (setupVertices ? setupVertices[start] : 0))
+				start++;
+			while (end > start && vertices[end - 1] == (setupVertices ? setupVertices[end - 1] : 0))
+				end--;
+			_writeVarint(self, start);
+			_writeVarint(self, end - start);
+			for (ii = start; ii < end; ++ii)
+				_writeFloat(self, vertices[ii] - (setupVertices ? setupVertices[ii] : 0));
+		}
+		self->counts[POOL_FFD_TIMELINES]++;
+		self->counts[POOL_FLOATS] += ffd->framesCount + (ffd->framesCount - 1) * BEZIER_SIZE
+				+ ffd->framesCount * ffd->frameVerticesCount;
+		self->counts[POOL_POINTERS] += ffd->framesCount;
+		break;
+	}
+	case SP_TIMELINE_FLIPX:
+	case SP_TIMELINE_FLIPY: {
+		const spFlipTimeline* flip = SUB_CAST(spFlipTimeline, timeline);
+		_writeVarint(self, flip->boneIndex);
+		_writeVarint(self, flip->framesCount / 2);
+		_writeFloats(self, flip->frames, flip->framesCount);
+		self->counts[POOL_FLIP_TIMELINES]++;
+		self->counts[POOL_FLOATS] += flip->framesCount;
+		break;
+	}
+	}
+	return 1;
+}
+
+static void _writeColor (_Output* self, float r, float g, float b, float a) {
+	float color[4];
+	color[0] = r;
+	color[1] = g;
+	color[2] = b;
+	color[3] = a;
+	_writeFloats(self, color, 4);
+}
+
+static void _writeAttachment (_Output* self, const char* entryName, const spAttachment* attachment) {
+	const char* path = 0;
+	int i;
+	switch (attachment->type) {
+	case SP_ATTACHMENT_REGION:
+		path = SUB_CAST(spRegionAttachment, attachment)->path;
+		break;
+	case SP_ATTACHMENT_MESH:
+		path = SUB_CAST(spMeshAttachment, attachment)->path;
+		break;
+	case SP_ATTACHMENT_SKINNED_MESH:
+		path = SUB_CAST(spSkinnedMeshAttachment, attachment)->path;
+		break;
+	case SP_ATTACHMENT_BOUNDING_BOX:
+		break;
+	}
+	_writeByte(self, attachment->type);
+	_writeString(self, strcmp(attachment->name, entryName) == 0 ? 0 : attachment->name, 0);
+	_writeString(self, !path || strcmp(path, attachment->name) == 0 ? 0 : path, 0);
+
+	switch (attachment->type) {
+	case SP_ATTACHMENT_REGION: {
+		const spRegionAttachment* region = SUB_CAST(spRegionAttachment, attachment);
+		_writeFloat(self, region->x);
+		_writeFloat(self, region->y);
+		_writeFloat(self, region->scaleX);
+		_writeFloat(self, region->scaleY);
+		_writeFloat(self, region->rotation);
+		_writeFloat(self, region->width);
+		_writeFloat(self, region->height);
+		_writeColor(self, region->r, region->g, region->b, region->a);
+		break;
+	}
+	case SP_ATTACHMENT_MESH: {
+		const spMeshAttachment* mesh = SUB_CAST(spMeshAttachment, attachment);
+		_writeVarint(self, mesh->verticesCount);
+		_writeFloats(self, mesh->vertices, mesh->verticesCount);
+		_writeFloats(self, mesh->regionUVs, mesh->verticesCount);
+		_writeVarint(self, mesh->trianglesCount);
+		for (i = 0; i < mesh->trianglesCount; ++i)
+			_writeVarint(self, mesh->triangles[i]);
+		_writeColor(self, mesh->r, mesh->g, mesh->b, mesh->a);
+		_writeVarint(self, mesh->hullLength);
+		_writeVarint(self, mesh->edgesCount);
+		for (i = 0; i < mesh->edgesCount; ++i)
+			_writeVarint(self, mesh->edges[i]);
+		_writeFloat(self, mesh->width);
+		_writeFloat(self, mesh->height);
+		break;
+	}
+	case SP_ATTACHMENT_SKINNED_MESH: {
+		const spSkinnedMeshAttachment* mesh = SUB_CAST(spSkinnedMeshAttachment, attachment);
+		_writeVarint(self, mesh->uvsCount);
+		_writeFloats(self, mesh->regionUVs, mesh->uvsCount);
+		_writeVarint(self, mesh->bonesCount);
+		for (i = 0; i < mesh->bonesCount; ++i)
+			_writeVarint(self, mesh->bones[i]);
+		_writeVarint(self, mesh->weightsCount);
+		_writeFloats(self, mesh->weights, mesh->weightsCount);
+		_writeVarint(self, mesh->trianglesCount);
+		for (i = 0; i < mesh->trianglesCount; ++i)
+			_writeVarint(self, mesh->triangles[i]);
+		_writeColor(self, mesh->r, mesh->g, mesh->b, mesh->a);
+		_writeVarint(self, mesh->hullLength);
+		_writeVarint(self, mesh->edgesCount);
+		for (i = 0; i < mesh->edgesCount; ++i)
+			_writeVarint(self, mesh->edges[i]);
+		_writeFloat(self, mesh->width);
+		_writeFloat(self, mesh->height);
+		break;
+	}
+	case SP_ATTACHMENT_BOUNDING_BOX: {
+		const spBoundingBoxAttachment* box = SUB_CAST(spBoundingBoxAttachment, attachment);
+		_writeVarint(self, box->verticesCount);
+		_writeFloats(self, box->vertices, box->verticesCount);
+		break;
+	}
+	}
+}
+
+unsigned char* spSkeletonBinary_writeSkeletonData (const spSkeletonData* skeletonData, int* length) {
+	_Output body, attachment;
+	int i, ii;
+
+	memset(&body, 0, sizeof(body));
+	memset(&attachment, 0, sizeof(attachment));
+
+	_writeString(&body, skeletonData->hash, 1);
+	_writeString(&body, skeletonData->version, 1);
+	_writeFloat(&body, skeletonData->width);
+	_writeFloat(&body, skeletonData->height);
+
+	/* Bones. */
+	_writeVarint(&body, skeletonData->bonesCount);
+	for (i = 0; i < skeletonData->bonesCount; ++i) {
+		const spBoneData* boneData = skeletonData->bones[i];
+		_writeString(&body, boneData->name, 1);
+		_writeVarint(&body, _indexOf((void**)skeletonData->bones, i, boneData->parent) + 1);
+		_writeFloat(&body, boneData->length);
+		_writeFloat(&body, boneData->x);
+		_writeFloat(&body, boneData->y);
+		_writeFloat(&body, boneData->rotation);
+		_writeFloat(&body, boneData->scaleX);
+		_writeFloat(&body, boneData->scaleY);
+		_writeByte(&body, (boneData->flipX ? 1 : 0) | (boneData->flipY ? 2 : 0) | (boneData->inheritScale ? 4 : 0)
+				| (boneData->inheritRotation ? 8 : 0));
+	}
+	body.counts[POOL_BONES] = skeletonData->bonesCount;
+	body.counts[POOL_POINTERS] += skeletonData->bonesCount;
+
+	/* IK constraints. */
+	_writeVarint(&body, skeletonData->ikConstraintsCount);
+	for (i = 0; i < skeletonData->ikConstraintsCount; ++i) {
+		const spIkConstraintData* ikConstraintData = skeletonData->ikConstraints[i];
+		_writeString(&body, ikConstraintData->name, 1);
+		_writeVarint(&body, ikConstraintData->bonesCount);
+		for (ii = 0; ii < ikConstraintData->bonesCount; ++ii)
+			_writeVarint(&body, _indexOf((void**)skeletonData->bones, skeletonData->bonesCount, ikConstraintData->bones[ii]));
+		_writeVarint(&body, _indexOf((void**)skeletonData->bones, skeletonData->bonesCount, ikConstraintData->target));
+		_writeByte(&body, ikConstraintData->bendDirection > 0);
+		_writeFloat(&body, ikConstraintData->mix);
+		body.counts[POOL_POINTERS] += 1 + ikConstraintData->bonesCount;
+	}
+	body.counts[POOL_IK_CONSTRAINTS] = skeletonData->ikConstraintsCount;
+
+	/* Slots. */
+	_writeVarint(&body, skeletonData->slotsCount);
+	for (i = 0; i < skeletonData->slotsCount; ++i) {
+		const spSlotData* slotData = skeletonData->slots[i];
+		_writeString(&body, slotData->name, 1);
+		_writeVarint(&body, _indexOf((void**)skeletonData->bones, skeletonData->bonesCount, slotData->boneData));
+		_writeColor(&body, slotData->r, slotData->g, slotData->b, slotData->a);
+		_writeString(&body, slotData->attachmentName, 1);
+		_writeByte(&body, slotData->blendMode);
+	}
+	body.counts[POOL_SLOTS] = skeletonData->slotsCount;
+	body.counts[POOL_POINTERS] += skeletonData->slotsCount;
+
+	/* Skins. Each attachment is prefixed with its size, so the reader can skip attachments the loader does not create. */
+	_writeVarint(&body, skeletonData->skinsCount);
+	_writeVarint(&body, _indexOf((void**)skeletonData->skins, skeletonData->skinsCount, skeletonData->defaultSkin) + 1);
+	for (i = 0; i < skeletonData->skinsCount; ++i) {
+		const _spSkinEntry* entry;
+		int entriesCount = 0;
+		_writeString(&body, skeletonData->skins[i]->name, 1);
+		for (entry = SUB_CAST(_spSkin, skeletonData->skins[i])->entries; entry; entry = entry->next)
+			entriesCount++;
+		_writeVarint(&body, entriesCount);
+		for (entry = SUB_CAST(_spSkin, skeletonData->skins[i])->entries; entry; entry = entry->next) {
+			_writeVarint(&body, entry->slotIndex);
+			_writeString(&body, entry->name, 1);
+			attachment.length = 0;
+			_writeAttachment(&attachment, entry->name, entry->attachment);
+			_writeVarint(&body, attachment.length);
+			_writeBytes(&body, attachment.data, attachment.length);
+		}
+		body.counts[POOL_SKIN_ENTRIES] += entriesCount;
+	}
+	body.counts[POOL_SKINS] = skeletonData->skinsCount;
+	body.counts[POOL_POINTERS] += skeletonData->skinsCount;
+	_Output_dispose(&attachment);
+
+	/* Events. */
+	_writeVarint(&body, skeletonData->eventsCount);
+	for (i = 0; i < skeletonData->eventsCount; ++i) {
+		const spEventData* eventData = skeletonData->events[i];
+		_writeString(&body, eventData->name, 1);
+		_writeInt(&body, eventData->intValue);
+		_writeFloat(&body, eventData->floatValue);
+		_writeString(&body, eventData->stringValue, 1);
+	}
+	body.counts[POOL_EVENTS] = skeletonData->eventsCount;
+	body.counts[POOL_POINTERS] += skeletonData->eventsCount;
+
+	/* Animations. */
+	_writeVarint(&body, skeletonData->animationsCount);
+	for (i = 0; i < skeletonData->animationsCount; ++i) {
+		const spAnimation* animation = skeletonData->animations[i];
+		_writeString(&body, animation->name, 1);
+		_writeFloat(&body, animation->duration);
+		_writeVarint(&body, animation->timelinesCount);
+		for (ii = 0; ii < animation->timelinesCount; ++ii) {
+			if (!_writeTimeline(&body, skeletonData, animation->timelines[ii])) {
+				_Output_dispose(&body);
+				return 0;
+			}
+		}
+		body.counts[POOL_POINTERS] += animation->timelinesCount;
+	}
+	body.counts[POOL_ANIMATIONS] = skeletonData->animationsCount;
+	body.counts[POOL_POINTERS] += skeletonData->animationsCount;
+
+	return _writeFile(&body, SKELETON_MAGIC, body.counts, POOLS, length);
+}
+
+unsigned char* spSkeletonBinary_writeAtlas (const spAtlas* atlas, int* length) {
+	_Output body;
+	int counts[ATLAS_POOLS];
+	const spAtlasPage* page;
+	const spAtlasRegion* region;
+	int i, pageIndex;
+
+	memset(&body, 0, sizeof(body));
+	memset(counts, 0, sizeof(counts));
+
+	for (page = atlas->pages; page; page = page->next)
+		counts[ATLAS_POOL_PAGES]++;
+	_writeVarint(&body, counts[ATLAS_POOL_PAGES]);
+	for (page = atlas->pages; page; page = page->next) {
+		_writeString(&body, page->name, 1);
+		_writeVarint(&body, page->width);
+		_writeVarint(&body, page->height);
+		_writeInt(&body, page->format);
+		_writeInt(&body, page->minFilter);
+		_writeInt(&body, page->magFilter);
+		_writeInt(&body, page->uWrap);
+		_writeInt(&body, page->vWrap);
+	}
+
+	for (region = atlas->regions; region; region = region->next)
+		counts[ATLAS_POOL_REGIONS]++;
+	_writeVarint(&body, counts[ATLAS_POOL_REGIONS]);
+	for (region = atlas->regions; region; region = region->next) {
+		for (page = atlas->pages, pageIndex = 0; page != region->page; page = page->next)
+			pageIndex++;
+		_writeString(&body, region->name, 1);
+		_writeVarint(&body, pageIndex);
+		_writeByte(&body, (region->rotate ? 1 : 0) | (region->flip ? 2 : 0) | (region->splits ? 4 : 0) | (region->pads ? 8 : 0));
+		_writeInt(&body, region->x);
+		_writeInt(&body, region->y);
+		_writeInt(&body, region->width);
+		_writeInt(&body, region->height);
+		_writeInt(&body, region->originalWidth);
+		_writeInt(&body, region->originalHeight);
+		_writeInt(&body, region->offsetX);
+		_writeInt(&body, region->offsetY);
+		_writeInt(&body, region->index);
+		for (i = 0; region->splits && i < 4; ++i)
+			_writeInt(&body, region->splits[i]);
+		for (i = 0; region->pads && i < 4; ++i)
+			_writeInt(&body, region->pads[i]);
+		counts[ATLAS_POOL_INTS] += (region->splits ? 4 : 0) + (region->pads ? 4 : 0);
+	}
+
+	return _writeFile(&body, ATLAS_MAGIC, counts, ATLAS_POOLS, length);
+}
+
+/**/
+
+typedef struct {
+	const unsigned char* cursor;
+	const unsigned char* end;
+	int/*bool*/error;
+	char* pools[POOLS];
+	char* poolEnds[POOLS];
+	char* strings;
+	char* stringsEnd;
+} _Input;
+
+#define TAKE(INPUT,POOL,TYPE,COUNT) ((TYPE*)_take(INPUT, POOL, sizeof(TYPE), COUNT))
+
+/* Returns the next count elements of a pool, or 0 if the header did not count them. */
+static void* _take (_Input* self, int pool, size_t elementSize, int count) {
+	char* elements = self->pools[pool];
+	if (count < 0 || (size_t)(self->poolEnds[pool] - elements) / elementSize < (size_t)count) {
+		self->error = 1;
+		return 0;
+	}
+	self->pools[pool] = elements + elementSize * count;
+	return elements;
+}
+
+/* Lays out the pools after a header struct of the given size and allocates the zeroed arena. */
+static char* _Input_createArena (_Input* self, size_t headerSize, const size_t* elementSizes, const int* counts, int poolsCount,
+		int stringsLength, size_t* arenaSize) {
+	char* arena;
+	size_t offsets[POOLS], size = ALIGN(headerSize);
+	int i;
+	for (i = 0; i < poolsCount; ++i) {
+		offsets[i] = size;
+		size += ALIGN(elementSizes[i] * counts[i]);
+	}
+	arena = CALLOC(char, size + stringsLength);
+	if (!arena) return 0;
+	for (i = 0; i < poolsCount; ++i) {
+		self->pools[i] = arena + offsets[i];
+		self->poolEnds[i] = self->pools[i] + elementSizes[i] * counts[i];
+	}
+	self->strings = arena + size;
+	self->stringsEnd = self->strings + stringsLength;
+	*arenaSize = size + stringsLength;
+	return arena;
+}
+
+static int _readByte (_Input* self) {
+	if (self->cursor == self->end) {
+		self->error = 1;
+		return 0;
+	}
+	return *self->cursor++;
+}
+
+static unsigned int _readVarint (_Input* self) {
+	unsigned int value = 0;
+	int shift;
+	for (shift = 0; shift < 35; shift += 7) {
+		int b = _readByte(self);
+		value |= (unsigned int)(b & 0x7f) << shift;
+		if (!(b & 0x80)) return value;
+	}
+	self->error = 1;
+	return 0;
+}
+
+static int _readInt (_Input* self) {
+	unsigned int value = _readVarint(self);
+	return value & 1 ? (int)~(value >> 1) : (int)(value >> 1);
+}
+
+/* Counts of elements that each take at least one byte of the file. */
+static int _readCount (_Input* self) {
+	unsigned int value = _readVarint(self);
+	if (value > (unsigned int)(self->end - self->cursor)) {
+		self->error = 1;
+		return 0;
+	}
+	return (int)value;
+}
+
+static int _readIndex (_Input* self, int count) {
+	unsigned int value = _readVarint(self);
+	if (value >= (unsigned int)count) {
+		self->error = 1;
+		return 0;
+	}
+	return (int)value;
+}
+
+
+/* Counts in the header, which may be larger than the file. */
+static int _readHeaderCount (_Input* self) {
+	unsigned int value = _readVarint(self);
+	if (value > INT_MAX) {
+		self->error = 1;
+		return 0;
+	}
+	return (int)value;
+}
+
+static void _readFloats (_Input* self, float* values, int count, float scale) {
+	const unsigned char* bytes = self->cursor;
+	int i;
+	if ((self->end - bytes) / 4 < count) {
+		self->error = 1;
+		return;
+	}
+	for (i = 0; i < count; ++i, bytes += 4) {
+		union {
+			float f;
+			unsigned int i;
+		} value;
+		value.i = bytes[0] | bytes[1] << 8 | (unsigned int)bytes[2] << 16 | (unsigned int)bytes[3] << 24;
+		values[i] = value.f;
+	}
+	self->cursor = bytes;
+	if (scale != 1) {
+		for (i = 0; i < count; ++i)
+			values[i] *= scale;
+	}
+}
+
+static float _readFloat (_Input* self) {
+	float value = 0;
+	_readFloats(self, &value, 1, 1);
+	return value;
+}
+
+/* Reads frames of a time followed by frameSize - 1 values and scales the values. */
+static void _readFrames (_Input* self, float* frames, int framesCount, int frameSize, float scale) {
+	int i, ii;
+	_readFloats(self, frames, framesCount * frameSize, 1);
+	if (scale == 1) return;
+	for (i = 0; i < framesCount * frameSize; i += frameSize)
+		for (ii = 1; ii < frameSize; ++ii)
+			frames[i + ii] *= scale;
+}
+
+/* Every frame has at least a time. */
+static int _readFramesCount (_Input* self) {
+	int count = _readCount(self);
+	if (count < 1 || count > (self->end - self->cursor) / 4) {
+		self->error = 1;
+		return 0;
+	}
+	return count;
+}
+
+static void _readInts (_Input* self, int* values, int count) {
+	int i;
+	for (i = 0; i < count; ++i)
+		values[i] = (int)_readVarint(self);
+}
+
+/* Returns a string that points into the file. */
+static const char* _readString (_Input* self) {
+	const char* value;
+	int length = _readCount(self);
+	if (length == 0) return 0;
+	value = (const char*)self->cursor;
+	if (value[length - 1] != 0) {
+		self->error = 1;
+		return 0;
+	}
+	self->cursor += length;
+	return value;
+}
+
+/* Returns a copy of a string in the arena. */
+static const char* _readArenaString (_Input* self) {
+	const char* value = _readString(self);
+	char* copy;
+	int length;
+	if (!value) return 0;
+	length = (int)strlen(value) + 1;
+	if (self->stringsEnd - self->strings < length) {
+		self->error = 1;
+		return 0;
+	}
+	copy = self->strings;
+	memcpy(copy, value, length);
+	self->strings += length;
+	return copy;
+}
+
+/* Reads an arena string that may not be null. */
+static const char* _readName (_Input* self) {
+	const char* value = _readArenaString(self);
+	if (!value) self->error = 1;
+	return value;
+}
+
+/**/
+
+typedef struct {
+	spSkeletonBinary super;
+	int ownsLoader;
+} _spSkeletonBinary;
+
+spSkeletonBinary* spSkeletonBinary_createWithLoader (spAttachmentLoader* attachmentLoader) {
+	spSkeletonBinary* self = SUPER(NEW(_spSkeletonBinary));
+	self->scale = 1;
+	self->attachmentLoader = attachmentLoader;
+	return self;
+}
+
+spSkeletonBinary* spSkeletonBinary_create (spAtlas* atlas) {
+	spAtlasAttachmentLoader* attachmentLoader = spAtlasAttachmentLoader_create(atlas);
+	spSkeletonBinary* self = spSkeletonBinary_createWithLoader(SUPER(attachmentLoader));
+	SUB_CAST(_spSkeletonBinary, self)->ownsLoader = 1;
+	return self;
+}
+
+void spSkeletonBinary_dispose (spSkeletonBinary* self) {
+	if (SUB_CAST(_spSkeletonBinary, self)->ownsLoader) spAttachmentLoader_dispose(self->attachmentLoader);
+	FREE(self->error);
+	FREE(self);
+}
+
+void _spSkeletonBinary_setError (spSkeletonBinary* self, const char* value1, const char* value2) {
+	char message[256];
+	int length;
+	FREE(self->error);
+	strcpy(message, value1);
+	length = (int)strlen(value1);
+	if (value2) strncat(message + length, value2, 255 - length);
+	MALLOC_STR(self->error, message);
+}
+
+/* The entries of a skin in the order they were written, including those of attachments the loader did not create. */
+typedef struct {
+	_spSkinEntry* entries;
+	int entriesCount;
+} _SkinEntries;
+
+static void _readColor (_Input* input, float* r, float* g, float* b, float* a) {
+	float color[4] = {0, 0, 0, 0};
+	_readFloats(input, color, 4, 1);
+	*r = color[0];
+	*g = color[1];
+	*b = color[2];
+	*a = color[3];
+}
+
+static int* _readIntArray (_Input* input, int* count) {
+	int* values;
+	*count = _readCount(input);
+	values = MALLOC(int, *count);
+	_readInts(input, values, *count);
+	return values;
+}
+
+static float* _readFloatArray (_Input* input, int count, float scale) {
+	float* values = MALLOC(float, count);
+	_readFloats(input, values, count, scale);
+	return values;
+}
+
+/* Reads the fields after the type and names, with the same defaults and scaling as spSkeletonJson. */
+static void _readAttachment (spSkeletonBinary* self, _Input* input, spAttachment* attachment, const char* path) {
+	switch (attachment->type) {
+	case SP_ATTACHMENT_REGION: {
+		spRegionAttachment* region = SUB_CAST(spRegionAttachment, attachment);
+		MALLOC_STR(region->path, path);
+		region->x = _readFloat(input) * self->scale;
+		region->y = _readFloat(input) * self->scale;
+		region->scaleX = _readFloat(input);
+		region->scaleY = _readFloat(input);
+		region->rotation = _readFloat(input);
+		region->width = _readFloat(input) * self->scale;
+		region->height = _readFloat(input) * self->scale;
+		_readColor(input, &region->r, &region->g, &region->b, &region->a);
+		spRegionAttachment_updateOffset(region);
+		break;
+	}
+	case SP_ATTACHMENT_MESH: {
+		spMeshAttachment* mesh = SUB_CAST(spMeshAttachment, attachment);
+		MALLOC_STR(mesh->path, path);
+		mesh->verticesCount = _readCount(input) & ~1;
+		mesh->vertices = _readFloatArray(input, mesh->verticesCount, self->scale);
+		mesh->regionUVs = _readFloatArray(input, mesh->verticesCount, 1);
+		mesh->triangles = _readIntArray(input, &mesh->trianglesCount);
+		spMeshAttachment_updateUVs(mesh);
+		_readColor(input, &mesh->r, &mesh->g, &mesh->b, &mesh->a);
+		mesh->hullLength = (int)_readVarint(input);
+		mesh->edges = _readIntArray(input, &mesh->edgesCount);
+		if (!mesh->edgesCount) {
+			FREE(mesh->edges);
+			mesh->edges = 0;
+		}
+		mesh->width = _readFloat(input) * self->scale;
+		mesh->height = _readFloat(input) * self->scale;
+		break;
+	}
+	case SP_ATTACHMENT_SKINNED_MESH: {
+		spSkinnedMeshAttachment* mesh = SUB_CAST(spSkinnedMeshAttachment, attachment);
+		int i;
+		MALLOC_STR(mesh->path, path);
+		mesh->uvsCount = _readCount(input) & ~1;
+		mesh->regionUVs = _readFloatArray(input, mesh->uvsCount, 1);
+		mesh->bones = _readIntArray(input, &mesh->bonesCount);
+		mesh->weightsCount = _readCount(input) / 3 * 3;
+		mesh->weights = _readFloatArray(input, mesh->weightsCount, 1);
+		if (self->scale != 1) {
+			for (i = 0; i < mesh->weightsCount; i += 3) {
+				mesh->weights[i] *= self->scale;
+				mesh->weights[i + 1] *= self->scale;
+			}
+		}
+		mesh->triangles = _readIntArray(input, &mesh->trianglesCount);
+		spSkinnedMeshAttachment_updateUVs(mesh);
+		_readColor(input, &mesh->r, &mesh->g, &mesh->b, &mesh->a);
+		mesh->hullLength = (int)_readVarint(input);
+		mesh->edges = _readIntArray(input, &mesh->edgesCount);
+		if (!mesh->edgesCount) {
+			FREE(mesh->edges);
+			mesh->edges = 0;
+		}
+		mesh->width = _readFloat(input) * self->scale;
+		mesh->height = _readFloat(input) * self->scale;
+		break;
+	}
+	case SP_ATTACHMENT_BOUNDING_BOX: {
+		spBoundingBoxAttachment* box = SUB_CAST(spBoundingBoxAttachment, attachment);
+		box->verticesCount = _readCount(input) & ~1;
+		box->vertices = _readFloatArray(input, box->verticesCount, self->scale);
+		break;
+	}
+	}
+}
+
+static void _readCurves (_Input* input, spCurveTimeline* timeline, int framesCount) {
+	int i, n = (framesCount - 1) * BEZIER_SIZE;
+	timeline->curves = TAKE(input, POOL_FLOATS, float, n);
+	if (!timeline->curves) return;
+	for (i = 0; i < n && !input->error; i += BEZIER_SIZE) {
+		int type = _readByte(input);
+		timeline->curves[i] = (float)type;
+		if (type == CURVE_BEZIER) _readFloats(input, timeline->curves + i + 1, BEZIER_SIZE - 1, 1);
+	}
+}
+
+/* Returns 0 on failure. */
+static spTimeline* _readTimeline (spSkeletonBinary* self, _Input* input, spSkeletonData* skeletonData,
+		const _SkinEntries* skinEntries) {
+	int i, ii, framesCount;
+	float* frames;
+	int type = _readByte(input);
+
+	switch (type) {
+	case SP_TIMELINE_ROTATE:
+	case SP_TIMELINE_TRANSLATE:
+	case SP_TIMELINE_SCALE:
+	case SP_TIMELINE_COLOR:
+	case SP_TIMELINE_IKCONSTRAINT: {
+		spBaseTimeline* timeline = TAKE(input, POOL_BASE_TIMELINES, spBaseTimeline, 1);
+		int frameSize = type == SP_TIMELINE_ROTATE ? 2 : (type == SP_TIMELINE_COLOR ? 5 : 3);
+		int index = _readIndex(input, type == SP_TIMELINE_COLOR ? skeletonData->slotsCount :
+				(type == SP_TIMELINE_IKCONSTRAINT ? skeletonData->ikConstraintsCount : skeletonData->bonesCount));
+		framesCount = _readFramesCount(input);
+		frames = TAKE(input, POOL_FLOATS, float, framesCount * frameSize);
+		if (input->error) return 0;
+
+		_spTimeline_initArena(SUPER(SUPER(timeline)), (spTimelineType)type);
+		if (type == SP_TIMELINE_COLOR)
+			SUB_CAST(spColorTimeline, timeline)->slotIndex = index;
+		else if (type == SP_TIMELINE_IKCONSTRAINT)
+			SUB_CAST(spIkConstraintTimeline, timeline)->ikConstraintIndex = index;
+		else
+			timeline->boneIndex = index;
+		CONST_CAST(int, timeline->framesCount) = framesCount * frameSize;
+		CONST_CAST(float*, timeline->frames) = frames;
+		_readFrames(input, frames, framesCount, frameSize, type == SP_TIMELINE_TRANSLATE ? self->scale : 1);
+		_readCurves(input, SUPER(timeline), framesCount);
+		return SUPER(SUPER(timeline));
+	}
+	case SP_TIMELINE_ATTACHMENT: {
+		spAttachmentTimeline* timeline = TAKE(input, POOL_ATTACHMENT_TIMELINES, spAttachmentTimeline, 1);
+		int slotIndex = _readIndex(input, skeletonData->slotsCount);
+		const char** attachmentNames;
+		framesCount = _readFramesCount(input);
+		frames = TAKE(input, POOL_FLOATS, float, framesCount);
+		attachmentNames = TAKE(input, POOL_POINTERS, const char*, framesCount);
+		if (input->error) return 0;
+
+		_spTimeline_initArena(SUPER(timeline), SP_TIMELINE_ATTACHMENT);
+		timeline->slotIndex = slotIndex;
+		CONST_CAST(int, timeline->framesCount) = framesCount;
+		CONST_CAST(float*, timeline->frames) = frames;
+		CONST_CAST(const char**, timeline->attachmentNames) = attachmentNames;
+		_readFloats(input, frames, framesCount, 1);
+		for (i = 0; i < framesCount; ++i)
+			attachmentNames[i] = _readArenaString(input);
+		return SUPER(timeline);
+	}
+	case SP_TIMELINE_EVENT: {
+		spEventTimeline* timeline = TAKE(input, POOL_EVENT_TIMELINES, spEventTimeline, 1);
+		spEvent** events;
+		spEvent* frameEvents;
+		framesCount = _readFramesCount(input);
+		frames = TAKE(input, POOL_FLOATS, float, framesCount);
+		events = TAKE(input, POOL_POINTERS, spEvent*, framesCount);
+		frameEvents = TAKE(input, POOL_TIMELINE_EVENTS, spEvent, framesCount);
+		if (input->error) return 0;
+
+		_spTimeline_initArena(SUPER(timeline), SP_TIMELINE_EVENT);
+		CONST_CAST(int, timeline->framesCount) = framesCount;
+		CONST_CAST(float*, timeline->frames) = frames;
+		CONST_CAST(spEvent**, timeline->events) = events;
+		_readFloats(input, frames, framesCount, 1);
+		for (i = 0; i < framesCount; ++i) {
+			spEvent* event = frameEvents + i;
+			int eventIndex = _readIndex(input, skeletonData->eventsCount);
+			if (input->error) return 0;
+			CONST_CAST(spEventData*, event->data) = skeletonData->events[eventIndex];
+			event->intValue = _readInt(input);
+			event->floatValue = _readFloat(input);
+			event->stringValue = _readArenaString(input);
+			events[i] = event;
+		}
+		return SUPER(timeline);
+	}
+	case SP_TIMELINE_DRAWORDER: {
+		spDrawOrderTimeline* timeline = TAKE(input, POOL_DRAW_ORDER_TIMELINES, spDrawOrderTimeline, 1);
+		int slotsCount;
+		int** drawOrders;
+		framesCount = _readFramesCount(input);
+		slotsCount = (int)_readVarint(input);
+		frames = TAKE(input, POOL_FLOATS, float, framesCount);
+		drawOrders = TAKE(input, POOL_POINTERS, int*, framesCount);
+		if (input->error || slotsCount != skeletonData->slotsCount) return 0;
+
+		_spTimeline_initArena(SUPER(timeline), SP_TIMELINE_DRAWORDER);
+		CONST_CAST(int, timeline->framesCount) = framesCount;
+		CONST_CAST(float*, timeline->frames) = frames;
+		CONST_CAST(const int**, timeline->drawOrders) = (const int**)drawOrders;
+		CONST_CAST(int, timeline->slotsCount) = slotsCount;
+		_readFloats(input, frames, framesCount, 1);
+		for (i = 0; i < framesCount; ++i) {
+			if (!_readByte(input)) continue;
+			drawOrders[i] = TAKE(input, POOL_INTS, int, slotsCount);
+			if (!drawOrders[i]) return 0;
+			for (ii = 0; ii < slotsCount; ++ii)
+				drawOrders[i][ii] = _readIndex(input, slotsCount);
+		}
+		return SUPER(timeline);
+	}
+	case SP_TIMELINE_FFD: {
+		spFFDTimeline* timeline = TAKE(input, POOL_FFD_TIMELINES, spFFDTimeline, 1);
+		int skinIndex = _readIndex(input, skeletonData->skinsCount);
+		int slotIndex = _readIndex(input, skeletonData->slotsCount);
+		int verticesCount;
+		const _spSkinEntry* entry;
+		const float* setupVertices = 0;
+		float** frameVertices;
+		if (input->error) return 0;
+		entry = skinEntries[skinIndex].entries + _readIndex(input, skinEntries[skinIndex].entriesCount);
+		framesCount = _readFramesCount(input);
+		verticesCount = (int)_readVarint(input);
+		frames = TAKE(input, POOL_FLOATS, float, framesCount);
+		frameVertices = TAKE(input, POOL_POINTERS, float*, framesCount);
+		if (input->error || entry->slotIndex != slotIndex) return 0;
+
+		if (!entry->attachment) {
+			_spSkeletonBinary_setError(self, "Attachment not found: ", entry->name);
+			return 0;
+		}
+		if (entry->attachment->type == SP_ATTACHMENT_MESH) {
+			setupVertices = SUB_CAST(spMeshAttachment, entry->attachment)->vertices;
+			if (verticesCount != SUB_CAST(spMeshAttachment, entry->attachment)->verticesCount) return 0;
+		} else if (entry->attachment->type == SP_ATTACHMENT_SKINNED_MESH) {
+			if (verticesCount != SUB_CAST(spSkinnedMeshAttachment, entry->attachment)->weightsCount / 3 * 2) return 0;
+		} else
+			return 0;
+
+		_spTimeline_initArena(SUPER(SUPER(timeline)), SP_TIMELINE_FFD);
+		CONST_CAST(int, timeline->framesCount) = framesCount;
+		CONST_CAST(float*, timeline->frames) = frames;
+		CONST_CAST(int, timeline->frameVerticesCount) = verticesCount;
+		CONST_CAST(const float**, timeline->frameVertices) = (const float**)frameVertices;
+		timeline->slotIndex = slotIndex;
+		timeline->attachment = entry->attachment;
+		_readFloats(input, frames, framesCount, 1);
+		_readCurves(input, SUPER(timeline), framesCount);
+		for (i = 0; i < framesCount; ++i) {
+			float* vertices = TAKE(input, POOL_FLOATS, float, verticesCount);
+			unsigned int start = _readVarint(input);
+			unsigned int count = _readVarint(input);
+			if (!vertices || start > (unsigned int)verticesCount || count > verticesCount - start) return 0;
+			_readFloats(input, vertices + start, (int)count, self->scale);
+			if (setupVertices) {
+				for (ii = 0; ii < verticesCount; ++ii)
+					vertices[ii] += setupVertices[ii];
+			}
+			frameVertices[i] = vertices;
+		}
+		return SUPER(SUPER(timeline));
+	}
+	case SP_TIMELINE_FLIPX:
+	case SP_TIMELINE_FLIPY: {
+		spFlipTimeline* timeline = TAKE(input, POOL_FLIP_TIMELINES, spFlipTimeline, 1);
+		int boneIndex = _readIndex(input, skeletonData->bonesCount);
+		framesCount = _readFramesCount(input);
+		frames = TAKE(input, POOL_FLOATS, float, framesCount * 2);
+		if (input->error) return 0;
+
+		_spTimeline_initArena(SUPER(timeline), (spTimelineType)type);
+		CONST_CAST(int, timeline->x) = type == SP_TIMELINE_FLIPX;
+		CONST_CAST(int, timeline->framesCount) = framesCount * 2;
+		CONST_CAST(float*, timeline->frames) = frames;
+		timeline->boneIndex = boneIndex;
+		_readFloats(input, frames, framesCount * 2, 1);
+		return SUPER(timeline);
+	}
+	}
+	return 0;
+}
+
+static spBoneData* _readBone (_Input* input, const spSkeletonData* skeletonData) {
+	int index = _readIndex(input, skeletonData->bonesCount);
+	return input->error ? 0 : skeletonData->bones[index];
+}
+
+/* Returns 0 on failure. skinEntries is set to a temporary array the caller frees. */
+static int _readSkeletonData (spSkeletonBinary* self, _Input* input, spSkeletonData* skeletonData, _SkinEntries** skinEntries) {
+	int i, ii, count, defaultSkinIndex;
+
+	skeletonData->hash = _readArenaString(input);
+	skeletonData->version = _readArenaString(input);
+	skeletonData->width = _readFloat(input);
+	skeletonData->height = _readFloat(input);
+
+	/* Bones. */
+	{
+		spBoneData* bones;
+		count = _readCount(input);
+		skeletonData->bones = TAKE(input, POOL_POINTERS, spBoneData*, count);
+		bones = TAKE(input, POOL_BONES, spBoneData, count);
+		for (i = 0; i < count && !input->error; ++i) {
+			spBoneData* boneData = bones + i;
+			int parentIndex, flags;
+			CONST_CAST(const char*, boneData->name) = _readName(input);
+			parentIndex = _readIndex(input, i + 1);
+			CONST_CAST(spBoneData*, boneData->parent) = parentIndex ? skeletonData->bones[parentIndex - 1] : 0;
+			boneData->length = _readFloat(input) * self->scale;
+			boneData->x = _readFloat(input) * self->scale;
+			boneData->y = _readFloat(input) * self->scale;
+			boneData->rotation = _readFloat(input);
+			boneData->scaleX = _readFloat(input);
+			boneData->scaleY = _readFloat(input);
+			flags = _readByte(input);
+			boneData->flipX = flags & 1;
+			boneData->flipY = (flags >> 1) & 1;
+			boneData->inheritScale = (flags >> 2) & 1;
+			boneData->inheritRotation = (flags >> 3) & 1;
+			skeletonData->bones[i] = boneData;
+			skeletonData->bonesCount++;
+		}
+		if (input->error) return 0;
+	}
+
+	/* IK constraints. */
+	{
+		spIkConstraintData* ikConstraints;
+		count = _readCount(input);
+		skeletonData->ikConstraints = TAKE(input, POOL_POINTERS, spIkConstraintData*, count);
+		ikConstraints = TAKE(input, POOL_IK_CONSTRAINTS, spIkConstraintData, count);
+		for (i = 0; i < count && !input->error; ++i) {
+			spIkConstraintData* ikConstraintData = ikConstraints + i;
+			CONST_CAST(const char*, ikConstraintData->name) = _readName(input);
+			ikConstraintData->bonesCount = _readCount(input);
+			ikConstraintData->bones = TAKE(input, POOL_POINTERS, spBoneData*, ikConstraintData->bonesCount);
+			for (ii = 0; ii < ikConstraintData->bonesCount && !input->error; ++ii)
+				ikConstraintData->bones[ii] = _readBone(input, skeletonData);
+			ikConstraintData->target = _readBone(input, skeletonData);
+			ikConstraintData->bendDirection = _readByte(input) ? 1 : -1;
+			ikConstraintData->mix = _readFloat(input);
+			skeletonData->ikConstraints[i] = ikConstraintData;
+			skeletonData->ikConstraintsCount++;
+		}
+		if (input->error) return 0;
+	}
+
+	/* Slots. */
+	{
+		spSlotData* slots;
+		count = _readCount(input);
+		skeletonData->slots = TAKE(input, POOL_POINTERS, spSlotData*, count);
+		slots = TAKE(input, POOL_SLOTS, spSlotData, count);
+		for (i = 0; i < count && !input->error; ++i) {
+			spSlotData* slotData = slots + i;
+			CONST_CAST(const char*, slotData->name) = _readName(input);
+			CONST_CAST(spBoneData*, slotData->boneData) = _readBone(input, skeletonData);
+			_readColor(input, &slotData->r, &slotData->g, &slotData->b, &slotData->a);
+			slotData->attachmentName = _readArenaString(input);
+			slotData->blendMode = (spBlendMode)_readByte(input);
+			skeletonData->slots[i] = slotData;
+			skeletonData->slotsCount++;
+		}
+		if (input->error) return 0;
+	}
+
+	/* Skins. */
+	{
+		_spSkin* skins;
+		count = _readCount(input);
+		defaultSkinIndex = _readIndex(input, count + 1);
+		skeletonData->skins = TAKE(input, POOL_POINTERS, spSkin*, count);
+		skins = TAKE(input, POOL_SKINS, _spSkin, count);
+		if (input->error) return 0;
+		*skinEntries = MALLOC(_SkinEntries, count);
+		for (i = 0; i < count; ++i) {
+			_spSkin* skin = skins + i;
+			_spSkinEntry** lastEntry = &skin->entries;
+			_spSkinEntry* entries;
+			int entriesCount;
+			CONST_CAST(const char*, SUPER(skin)->name) = _readName(input);
+			entriesCount = _readCount(input);
+			entries = TAKE(input, POOL_SKIN_ENTRIES, _spSkinEntry, entriesCount);
+			if (input->error) return 0;
+			skeletonData->skins[i] = SUPER(skin);
+			skeletonData->skinsCount++;
+			(*skinEntries)[i].entries = entries;
+			(*skinEntries)[i].entriesCount = entriesCount;
+
+			for (ii = 0; ii < entriesCount; ++ii) {
+				_spSkinEntry* entry = entries + ii;
+				const unsigned char* end;
+				const char *attachmentName, *path;
+				spAttachment* attachment;
+				int type, size;
+
+				entry->slotIndex = _readIndex(input, skeletonData->slotsCount);
+				entry->name = _readName(input);
+				size = _readCount(input);
+				end = input->cursor + size;
+				type = _readByte(input);
+				attachmentName = _readString(input);
+				path = _readString(input);
+				if (input->error || type > SP_ATTACHMENT_SKINNED_MESH) return 0;
+				if (!attachmentName) attachmentName = entry->name;
+				if (!path) path = attachmentName;
+
+				attachment = spAttachmentLoader_newAttachment(self->attachmentLoader, SUPER(skin), (spAttachmentType)type,
+						attachmentName, path);
+				if (!attachment) {
+					if (self->attachmentLoader->error1) {
+						_spSkeletonBinary_setError(self, self->attachmentLoader->error1, self->attachmentLoader->error2);
+						return 0;
+					}
+					input->cursor = end;
+					continue;
+				}
+
+				_readAttachment(self, input, attachment, path);
+				if (input->error || input->cursor != end) {
+					spAttachment_dispose(attachment);
+					return 0;
+				}
+				entry->attachment = attachment;
+				*lastEntry = entry;
+				lastEntry = &entry->next;
+			}
+		}
+		skeletonData->defaultSkin = defaultSkinIndex ? skeletonData->skins[defaultSkinIndex - 1] : 0;
+	}
+
+	/* Events. */
+	{
+		spEventData* events;
+		count = _readCount(input);
+		skeletonData->events = TAKE(input, POOL_POINTERS, spEventData*, count);
+		events = TAKE(input, POOL_EVENTS, spEventData, count);
+		for (i = 0; i < count && !input->error; ++i) {
+			spEventData* eventData = events + i;
+			CONST_CAST(const char*, eventData->name) = _readName(input);
+			eventData->intValue = _readInt(input);
+			eventData->floatValue = _readFloat(input);
+			eventData->stringValue = _readArenaString(input);
+			skeletonData->events[i] = eventData;
+			skeletonData->eventsCount++;
+		}
+		if (input->error) return 0;
+	}
+
+	/* Animations. */
+	{
+		spAnimation* animations;
+		count = _readCount(input);
+		skeletonData->animations = TAKE(input, POOL_POINTERS, spAnimation*, count);
+		animations = TAKE(input, POOL_ANIMATIONS, spAnimation, count);
+		for (i = 0; i < count && !input->error; ++i) {
+			spAnimation* animation = animations + i;
+			CONST_CAST(const char*, animation->name) = _readName(input);
+			animation->duration = _readFloat(input);
+			animation->timelinesCount = _readCount(input);
+			animation->timelines = TAKE(input, POOL_POINTERS, spTimeline*, animation->timelinesCount);
+			for (ii = 0; ii < animation->timelinesCount && !input->error; ++ii) {
+				animation->timelines[ii] = _readTimeline(self, input, skeletonData, *skinEntries);
+				if (!animation->timelines[ii]) return 0;
+			}
+			skeletonData->animations[i] = animation;
+			skeletonData->animationsCount++;
+		}
+		if (input->error) return 0;
+	}
+
+	return 1;
+}
+
+spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const unsigned char* binary, int length) {
+	_Input input;
+	int counts[POOLS], stringsLength, i, ok;
+	_spSkeletonData* skeletonData;
+	_SkinEntries* skinEntries = 0;
+	size_t arenaSize;
+
+	FREE(self->error);
+	CONST_CAST(char*, self->error) = 0;
+
+	if (length < 5 || memcmp(binary, SKELETON_MAGIC, 4) != 0) {
+		_spSkeletonBinary_setError(self, "Invalid skeleton binary: ", "bad magic");
+		return 0;
+	}
+	if (binary[4] != VERSION) {
+		_spSkeletonBinary_setError(self, "Invalid skeleton binary: ", "unsupported version");
+		return 0;
+	}
+
+	memset(&input, 0, sizeof(input));
+	input.cursor = binary + 5;
+	input.end = binary + length;
+	for (i = 0; i < POOLS; ++i)
+		counts[i] = _readHeaderCount(&input);
+	stringsLength = _readHeaderCount(&input);
+	if (input.error) {
+		_spSkeletonBinary_setError(self, "Invalid skeleton binary: ", "truncated header");
+		return 0;
+	}
+
+	skeletonData = (_spSkeletonData*)_Input_createArena(&input, sizeof(_spSkeletonData), poolElementSizes, counts, POOLS,
+			stringsLength, &arenaSize);
+	if (!skeletonData) {
+		_spSkeletonBinary_setError(self, "Unable to allocate skeleton data.", 0);
+		return 0;
+	}
+	skeletonData->arenaSize = arenaSize;
+
+	ok = _readSkeletonData(self, &input, SUPER(skeletonData), &skinEntries);
+	FREE(skinEntries);
+	if (!ok) {
+		spSkeletonData_dispose(SUPER(skeletonData));
+		if (!self->error) _spSkeletonBinary_setError(self, "Invalid skeleton binary: ", "corrupt data");
+		return 0;
+	}
+	return SUPER(skeletonData);
+}
+
+spSkeletonData* spSkeletonBinary_readSkeletonDataFile (spSkeletonBinary* self, const char* path) {
+	int length;
+	spSkeletonData* skeletonData;
+	const char* binary = _spUtil_readFile(path, &length);
+	if (!binary) {
+		_spSkeletonBinary_setError(self, "Unable to read skeleton file: ", path);
+		return 0;
+	}
+	skeletonData = spSkeletonBinary_readSkeletonData(self, (const unsigned char*)binary, length);
+	FREE(binary);
+	return skeletonData;
+}
+
+/**/
+
+int/*bool*/_spAtlas_isBinary (const char* data, int length) {
+	return length >= 5 && memcmp(data, ATLAS_MAGIC, 4) == 0;
+}
+
+spAtlas* _spAtlas_createBinary (const char* data, int length, const char* dir, void* rendererObject) {
+	_Input input;
+	int counts[ATLAS_POOLS], stringsLength, count, i;
+	int dirLength = (int)strlen(dir);
+	int needsSlash = dirLength > 0 && dir[dirLength - 1] != '/' && dir[dirLength - 1] != '\\';
+	size_t arenaSize;
+	spAtlas* self;
+	spAtlasPage* pages;
+	spAtlasRegion* regions;
+
+	if ((unsigned char)data[4] != VERSION) return 0;
+	memset(&input, 0, sizeof(input));
+	input.cursor = (const unsigned char*)data + 5;
+	input.end = (const unsigned char*)data + length;
+	for (i = 0; i < ATLAS_POOLS; ++i)
+		counts[i] = _readHeaderCount(&input);
+	stringsLength = _readHeaderCount(&input);
+	if (input.error) return 0;
+
+	self = (spAtlas*)_Input_createArena(&input, sizeof(_spAtlas), atlasPoolElementSizes, counts, ATLAS_POOLS, stringsLength,
+			&arenaSize);
+	if (!self) return 0;
+	SUB_CAST(_spAtlas, self)->arena = 1;
+	self->rendererObject = rendererObject;
+
+	count = _readCount(&input);
+	pages = TAKE(&input, ATLAS_POOL_PAGES, spAtlasPage, count);
+	for (i = 0; i < count && !input.error; ++i) {
+		spAtlasPage* page = pages + i;
+		char* path;
+		CONST_CAST(spAtlas*, page->atlas) = self;
+		page->name = _readName(&input);
+		page->width = (int)_readVarint(&input);
+		page->height = (int)_readVarint(&input);
+		page->format = (spAtlasFormat)_readInt(&input);
+		page->minFilter = (spAtlasFilter)_readInt(&input);
+		page->magFilter = (spAtlasFilter)_readInt(&input);
+		page->uWrap = (spAtlasWrap)_readInt(&input);
+		page->vWrap = (spAtlasWrap)_readInt(&input);
+		if (input.error) break;
+
+		if (i > 0)
+			pages[i - 1].next = page;
+		else
+			self->pages = page;
+
+		path = MALLOC(char, dirLength + needsSlash + strlen(page->name) + 1);
+		memcpy(path, dir, dirLength);
+		if (needsSlash) path[dirLength] = '/';
+		strcpy(path + dirLength + needsSlash, page->name);
+		_spAtlasPage_createTexture(page, path);
+		FREE(path);
+	}
+
+	count = _readCount(&input);
+	regions = TAKE(&input, ATLAS_POOL_REGIONS, spAtlasRegion, count);
+	for (i = 0; i < count && !input.error; ++i) {
+		spAtlasRegion* region = regions + i;
+		spAtlasPage* page;
+		int flags, ii;
+		region->name = _readName(&input);
+		page = pages + _readIndex(&input, counts[ATLAS_POOL_PAGES]);
+		flags = _readByte(&input);
+		region->rotate = flags & 1;
+		region->flip = (flags >> 1) & 1;
+		region->x = _readInt(&input);
+		region->y = _readInt(&input);
+		region->width = _readInt(&input);
+		region->height = _readInt(&input);
+		region->originalWidth = _readInt(&input);
+		region->originalHeight = _readInt(&input);
+		region->offsetX = _readInt(&input);
+		region->offsetY = _readInt(&input);
+		region->index = _readInt(&input);
+		if (flags & 4) {
+			region->splits = TAKE(&input, ATLAS_POOL_INTS, int, 4);
+			for (ii = 0; ii < 4 && region->splits; ++ii)
+				region->splits[ii] = _readInt(&input);
+		}
+		if (flags & 8) {
+			region->pads = TAKE(&input, ATLAS_POOL_INTS, int, 4);
+			for (ii = 0; ii < 4 && region->pads; ++ii)
+				region->pads[ii] = _readInt(&input);
+		}
+		if (input.error) break;
+
+		region->page = page;
+		region->u = region->x / (float)page->width;
+		region->v = region->y / (float)page->height;
+		if (region->rotate) {
+			region->u2 = (region->x + region->height) / (float)page->width;
+			region->v2 = (region->y + region->width) / (float)page->height;
+		} else {
+			region->u2 = (region->x + region->width) / (float)page->width;
+			region->v2 = (region->y + region->height) / (float)page->height;
+		}
+
+		if (i > 0)
+			regions[i - 1].next = region;
+		else
+			self->regions = region;
+	}
+
+	if (input.error) {
+		spAtlas_dispose(self);
+		return 0;
+	}
+	return self;
+}
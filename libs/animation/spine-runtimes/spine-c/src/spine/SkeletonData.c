@@ -34,11 +34,36 @@
 #include <spine/extension.h>
 
 spSkeletonData* spSkeletonData_create () {
-	return NEW(spSkeletonData);
+	return SUPER(NEW(_spSkeletonData));
+}
+
+static void _spSkeletonData_disposeArena (spSkeletonData* self) {
+	const char* arena = (const char*)self;
+	const char* arenaEnd = arena + SUB_CAST(_spSkeletonData, self)->arenaSize;
+	int i;
+	for (i = 0; i < self->skinsCount; ++i) {
+		_spSkinEntry* entry = SUB_CAST(_spSkin, self->skins[i])->entries;
+		while (entry) {
+			_spSkinEntry* nextEntry = entry->next;
+			spAttachment_dispose(entry->attachment);
+			/* Entries added with spSkin_addAttachment after loading are not in the arena. */
+			if ((const char*)entry < arena || (const char*)entry >= arenaEnd) {
+				FREE(entry->name);
+				FREE(entry);
+			}
+			entry = nextEntry;
+		}
+	}
+	FREE(self);
 }
 
 void spSkeletonData_dispose (spSkeletonData* self) {
 	int i;
+	if (SUB_CAST(_spSkeletonData, self)->arenaSize) {
+		_spSkeletonData_disposeArena(self);
+		return;
+	}
+
 	for (i = 0; i < self->bonesCount; ++i)
 		spBoneData_dispose(self->bones[i]);
 	FREE(self->bones);
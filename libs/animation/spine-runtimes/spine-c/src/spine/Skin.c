@@ -32,23 +32,15 @@
 #include <spine/Skin.h>
 #include <spine/extension.h>
 
-typedef struct _Entry _Entry;
-struct _Entry {
-	int slotIndex;
-	const char* name;
-	spAttachment* attachment;
-	_Entry* next;
-};
-
-_Entry* _Entry_create (int slotIndex, const char* name, spAttachment* attachment) {
-	_Entry* self = NEW(_Entry);
+_spSkinEntry* _spSkinEntry_create (int slotIndex, const char* name, spAttachment* attachment) {
+	_spSkinEntry* self = NEW(_spSkinEntry);
 	self->slotIndex = slotIndex;
 	MALLOC_STR(self->name, name);
 	self->attachment = attachment;
 	return self;
 }
 
-void _Entry_dispose (_Entry* self) {
+void _spSkinEntry_dispose (_spSkinEntry* self) {
 	spAttachment_dispose(self->attachment);
 	FREE(self->name);
 	FREE(self);
@@ -56,11 +48,6 @@ void _Entry_dispose (_Entry* self) {
 
 /**/
 
-typedef struct {
-	spSkin super;
-	_Entry* entries;
-} _spSkin;
-
 spSkin* spSkin_create (const char* name) {
 	spSkin* self = SUPER(NEW(_spSkin));
 	MALLOC_STR(self->name, name);
@@ -68,10 +55,10 @@ spSkin* spSkin_create (const char* name) {
 }
 
 void spSkin_dispose (spSkin* self) {
-	_Entry* entry = SUB_CAST(_spSkin, self)->entries;
+	_spSkinEntry* entry = SUB_CAST(_spSkin, self)->entries;
 	while (entry) {
-		_Entry* nextEntry = entry->next;
-		_Entry_dispose(entry);
+		_spSkinEntry* nextEntry = entry->next;
+		_spSkinEntry_dispose(entry);
 		entry = nextEntry;
 	}
 
@@ -80,13 +67,13 @@ void spSkin_dispose (spSkin* self) {
 }
 
 void spSkin_addAttachment (spSkin* self, int slotIndex, const char* name, spAttachment* attachment) {
-	_Entry* newEntry = _Entry_create(slotIndex, name, attachment);
+	_spSkinEntry* newEntry = _spSkinEntry_create(slotIndex, name, attachment);
 	newEntry->next = SUB_CAST(_spSkin, self)->entries;
 	SUB_CAST(_spSkin, self)->entries = newEntry;
 }
 
 spAttachment* spSkin_getAttachment (const spSkin* self, int slotIndex, const char* name) {
-	const _Entry* entry = SUB_CAST(_spSkin, self)->entries;
+	const _spSkinEntry* entry = SUB_CAST(_spSkin, self)->entries;
 	while (entry) {
 		if (entry->slotIndex == slotIndex && strcmp(entry->name, name) == 0) return entry->attachment;
 		entry = entry->next;
@@ -95,7 +82,7 @@ spAttachment* spSkin_getAttachment (const spSkin* self, int slotIndex, const cha
 }
 
 const char* spSkin_getAttachmentName (const spSkin* self, int slotIndex, int attachmentIndex) {
-	const _Entry* entry = SUB_CAST(_spSkin, self)->entries;
+	const _spSkinEntry* entry = SUB_CAST(_spSkin, self)->entries;
 	int i = 0;
 	while (entry) {
 		if (entry->slotIndex == slotIndex) {
@@ -108,7 +95,7 @@ const char* spSkin_getAttachmentName (const spSkin* self, int slotIndex, int att
 }
 
 void spSkin_attachAll (const spSkin* self, spSkeleton* skeleton, const spSkin* oldSkin) {
-	const _Entry *entry = SUB_CAST(_spSkin, oldSkin)->entries;
+	const _spSkinEntry *entry = SUB_CAST(_spSkin, oldSkin)->entries;
 	while (entry) {
 		spSlot *slot = skeleton->slots[entry->slotIndex];
 		if (slot->attachment == entry->attachment) {
@@ -0,0 +1,204 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+/* Poses many skeletons, by default 2000 spineboys each playing one animation, with spSkeletonBatch_apply and with
+ * spAnimationState_apply and spSkeleton_updateWorldTransform per skeleton, prints the time per frame of both and checks that
+ * both give the same world transforms.
+ *   spine-batch-bench [skeletons [frames [threads [skeleton.json skeleton.atlas]]]] */
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include <spine/spine.h>
+#include <spine/SkeletonBatch.h>
+#include <spine/extension.h>
+
+#ifdef _WIN32
+#include <windows.h>
+static double getTime () {
+	LARGE_INTEGER freq, t;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&t);
+	return (double)t.QuadPart / (double)freq.QuadPart;
+}
+#else
+static double getTime () {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+#endif
+
+void _spAtlasPage_createTexture (spAtlasPage* self, const char* path) {
+	self->width = 1024;
+	self->height = 1024;
+}
+
+void _spAtlasPage_disposeTexture (spAtlasPage* self) {
+}
+
+char* _spUtil_readFile (const char* path, int* length) {
+	return _readFile(path, length);
+}
+
+/* Creates a skeleton and a state playing one of the animations, each skeleton starting at a different time. Every third
+ * skeleton is flipped. */
+static void createSkeletons (spSkeletonData* skeletonData, spAnimationStateData* stateData, int count, spSkeleton** skeletons,
+		spAnimationState** states) {
+	int i;
+	for (i = 0; i < count; ++i) {
+		skeletons[i] = spSkeleton_create(skeletonData);
+		skeletons[i]->flipX = i % 3 == 1;
+		skeletons[i]->flipY = i % 3 == 2;
+		states[i] = spAnimationState_create(stateData);
+		spAnimationState_setAnimation(states[i], 0, skeletonData->animations[i % skeletonData->animationsCount], 1);
+		spAnimationState_update(states[i], i * 0.013f);
+	}
+}
+
+/* Returns the largest difference of the world transforms of two skeletons, relative to the size of the values. */
+static float compareBones (spSkeleton* a, spSkeleton* b) {
+	float maxDifference = 0;
+	int i;
+	for (i = 0; i < a->bonesCount; ++i) {
+		const spBone* boneA = a->bones[i];
+		const spBone* boneB = b->bones[i];
+		float difference = fabsf(boneA->m00 - boneB->m00) + fabsf(boneA->m01 - boneB->m01) + fabsf(boneA->m10 - boneB->m10)
+				+ fabsf(boneA->m11 - boneB->m11)
+				+ (fabsf(boneA->worldX - boneB->worldX) + fabsf(boneA->worldY - boneB->worldY))
+				/ (1 + fabsf(boneA->worldX) + fabsf(boneA->worldY));
+		if (difference > maxDifference) maxDifference = difference;
+		if (boneA->worldFlipX != boneB->worldFlipX || boneA->worldFlipY != boneB->worldFlipY) return 1e9f;
+	}
+	return maxDifference;
+}
+
+int main (int argc, char** argv) {
+	int count = argc > 1 ? atoi(argv[1]) : 2000;
+	int frames = argc > 2 ? atoi(argv[2]) : 200;
+	int threadsCount = argc > 3 ? atoi(argv[3]) : 0;
+	const char* jsonPath = argc > 5 ? argv[4] : "data/spineboy.json";
+	const char* atlasPath = argc > 5 ? argv[5] : "data/spineboy.atlas";
+	spAtlas* atlas;
+	spSkeletonJson* json;
+	spSkeletonData* skeletonData;
+	spAnimationStateData* stateData;
+	spSkeletonBatch* batch;
+	spSkeleton **skeletons, **batchSkeletons;
+	spAnimationState **states, **batchStates;
+	double t0, time = 0, batchTime = 0, updateTime = 0, batchUpdateTime = 0;
+	float difference, maxDifference = 0;
+	int i, frame;
+
+	if (count < 1) count = 1;
+	if (frames < 1) frames = 1;
+
+	atlas = spAtlas_createFromFile(atlasPath, 0);
+	if (!atlas) {
+		printf("Unable to read %s.\n", atlasPath);
+		return 1;
+	}
+	json = spSkeletonJson_create(atlas);
+	skeletonData = spSkeletonJson_readSkeletonDataFile(json, jsonPath);
+	if (!skeletonData) {
+		printf("%s\n", json->error ? json->error : "Unable to read skeleton.");
+		return 1;
+	}
+	spSkeletonJson_dispose(json);
+	stateData = spAnimationStateData_create(skeletonData);
+
+	skeletons = MALLOC(spSkeleton*, count);
+	batchSkeletons = MALLOC(spSkeleton*, count);
+	states = MALLOC(spAnimationState*, count);
+	batchStates = MALLOC(spAnimationState*, count);
+	createSkeletons(skeletonData, stateData, count, skeletons, states);
+	createSkeletons(skeletonData, stateData, count, batchSkeletons, batchStates);
+	batch = spSkeletonBatch_create(skeletonData, threadsCount);
+	for (i = 0; i < count; ++i)
+		spSkeletonBatch_addSkeleton(batch, batchSkeletons[i]);
+
+	for (frame = 0; frame < frames; ++frame) {
+		for (i = 0; i < count; ++i) {
+			spAnimationState_update(states[i], 1 / 60.0f);
+			spAnimationState_update(batchStates[i], 1 / 60.0f);
+		}
+
+		t0 = getTime();
+		for (i = 0; i < count; ++i) {
+			spAnimationState_apply(states[i], skeletons[i]);
+			spSkeleton_updateWorldTransform(skeletons[i]);
+		}
+		time += getTime() - t0;
+
+		t0 = getTime();
+		spSkeletonBatch_apply(batch, batchStates);
+		batchTime += getTime() - t0;
+
+		for (i = 0; i < count; ++i) {
+			difference = compareBones(skeletons[i], batchSkeletons[i]);
+			if (difference > maxDifference) maxDifference = difference;
+		}
+
+		t0 = getTime();
+		for (i = 0; i < count; ++i)
+			spSkeleton_updateWorldTransform(skeletons[i]);
+		updateTime += getTime() - t0;
+
+		t0 = getTime();
+		spSkeletonBatch_updateWorldTransform(batch);
+		batchUpdateTime += getTime() - t0;
+	}
+
+	printf("%d skeletons, %d bones, %d threads\n", count, skeletonData->bonesCount, batch->threadsCount);
+	printf("%-16s %12s %12s %8s\n", "", "per skeleton", "batch", "speedup");
+	printf("%-16s %9.1f us %9.1f us %7.2fx\n", "apply + update", time / frames * 1e6, batchTime / frames * 1e6,
+			time / batchTime);
+	printf("%-16s %9.1f us %9.1f us %7.2fx\n", "update", updateTime / frames * 1e6, batchUpdateTime / frames * 1e6,
+			updateTime / batchUpdateTime);
+	printf("largest world transform difference %g\n", maxDifference);
+
+	spSkeletonBatch_dispose(batch);
+	for (i = 0; i < count; ++i) {
+		spAnimationState_dispose(states[i]);
+		spAnimationState_dispose(batchStates[i]);
+		spSkeleton_dispose(skeletons[i]);
+		spSkeleton_dispose(batchSkeletons[i]);
+	}
+	FREE(skeletons);
+	FREE(batchSkeletons);
+	FREE(states);
+	FREE(batchStates);
+	spAnimationStateData_dispose(stateData);
+	spSkeletonData_dispose(skeletonData);
+	spAtlas_dispose(atlas);
+	printf(maxDifference < 1e-3f ? "ok\n" : "FAILED\n");
+	return maxDifference < 1e-3f ? 0 : 1;
+}
@@ -0,0 +1,219 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+/* Loads an atlas and skeleton, by default those in data/, from text and from the binary format, prints the time per load and
+ * checks that both skeleton datas pose every animation the same, at scale 1 and at a different scale.
+ *   spine-bench [iterations [skeleton.json skeleton.atlas]] */
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include <spine/spine.h>
+#include <spine/extension.h>
+
+#ifdef _WIN32
+#include <windows.h>
+static double getTime () {
+	LARGE_INTEGER freq, t;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&t);
+	return (double)t.QuadPart / (double)freq.QuadPart;
+}
+#else
+static double getTime () {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+#endif
+
+void _spAtlasPage_createTexture (spAtlasPage* self, const char* path) {
+	self->width = 1024;
+	self->height = 1024;
+}
+
+void _spAtlasPage_disposeTexture (spAtlasPage* self) {
+}
+
+char* _spUtil_readFile (const char* path, int* length) {
+	return _readFile(path, length);
+}
+
+static spSkeletonData* readJson (spAtlas* atlas, const char* json, float scale) {
+	spSkeletonJson* reader = spSkeletonJson_create(atlas);
+	spSkeletonData* skeletonData;
+	reader->scale = scale;
+	skeletonData = spSkeletonJson_readSkeletonData(reader, json);
+	if (!skeletonData) printf("%s\n", reader->error);
+	spSkeletonJson_dispose(reader);
+	return skeletonData;
+}
+
+static spSkeletonData* readBinary (spAtlas* atlas, const unsigned char* binary, int length, float scale) {
+	spSkeletonBinary* reader = spSkeletonBinary_create(atlas);
+	spSkeletonData* skeletonData;
+	reader->scale = scale;
+	skeletonData = spSkeletonBinary_readSkeletonData(reader, binary, length);
+	if (!skeletonData) printf("%s\n", reader->error);
+	spSkeletonBinary_dispose(reader);
+	return skeletonData;
+}
+
+/* Returns the largest difference of the world transforms and attachment vertices, or 1e9 if the poses differ otherwise. */
+static float comparePoses (spSkeletonData* a, spSkeletonData* b) {
+	spSkeleton* skeletonA = spSkeleton_create(a);
+	spSkeleton* skeletonB = spSkeleton_create(b);
+	spEvent* eventsA[64];
+	spEvent* eventsB[64];
+	float maxDifference = 0;
+	int i, ii, iii;
+	/* Every animation with every skin. */
+	for (i = 0; i < a->animationsCount * (a->skinsCount ? a->skinsCount : 1); ++i) {
+		const spAnimation* animationA = a->animations[i % a->animationsCount];
+		const spAnimation* animationB = b->animations[i % a->animationsCount];
+		if (a->skinsCount) {
+			spSkeleton_setSkin(skeletonA, a->skins[i / a->animationsCount]);
+			spSkeleton_setSkin(skeletonB, b->skins[i / a->animationsCount]);
+		}
+		for (ii = 0; ii <= 20; ++ii) {
+			float lastTime = animationA->duration * (ii - 1) / 20, time = animationA->duration * ii / 20;
+			int eventsCountA = 0, eventsCountB = 0;
+			spSkeleton_setToSetupPose(skeletonA);
+			spSkeleton_setToSetupPose(skeletonB);
+			spAnimation_apply(animationA, skeletonA, lastTime, time, 0, eventsA, &eventsCountA);
+			spAnimation_apply(animationB, skeletonB, lastTime, time, 0, eventsB, &eventsCountB);
+			if (eventsCountA != eventsCountB) return 1e9f;
+			for (iii = 0; iii < eventsCountA; ++iii) {
+				if (strcmp(eventsA[iii]->data->name, eventsB[iii]->data->name) != 0) return 1e9f;
+				if (eventsA[iii]->intValue != eventsB[iii]->intValue) return 1e9f;
+				if (eventsA[iii]->floatValue != eventsB[iii]->floatValue) return 1e9f;
+				if ((eventsA[iii]->stringValue == 0) != (eventsB[iii]->stringValue == 0)) return 1e9f;
+				if (eventsA[iii]->stringValue && strcmp(eventsA[iii]->stringValue, eventsB[iii]->stringValue) != 0) return 1e9f;
+			}
+			spSkeleton_updateWorldTransform(skeletonA);
+			spSkeleton_updateWorldTransform(skeletonB);
+			for (iii = 0; iii < skeletonA->bonesCount; ++iii) {
+				const spBone* boneA = skeletonA->bones[iii];
+				const spBone* boneB = skeletonB->bones[iii];
+				float difference = fabsf(boneA->worldX - boneB->worldX) + fabsf(boneA->worldY - boneB->worldY)
+						+ fabsf(boneA->m00 - boneB->m00) + fabsf(boneA->m01 - boneB->m01) + fabsf(boneA->m10 - boneB->m10)
+						+ fabsf(boneA->m11 - boneB->m11);
+				if (difference > maxDifference) maxDifference = difference;
+			}
+			for (iii = 0; iii < skeletonA->slotsCount; ++iii) {
+				const spSlot* slotA = skeletonA->drawOrder[iii];
+				const spSlot* slotB = skeletonB->drawOrder[iii];
+				int v;
+				if (strcmp(slotA->data->name, slotB->data->name) != 0) return 1e9f;
+				if ((slotA->attachment == 0) != (slotB->attachment == 0)) return 1e9f;
+				if (slotA->attachment && strcmp(slotA->attachment->name, slotB->attachment->name) != 0) return 1e9f;
+				if (slotA->attachmentVerticesCount != slotB->attachmentVerticesCount) return 1e9f;
+				for (v = 0; v < slotA->attachmentVerticesCount; ++v) {
+					float difference = fabsf(slotA->attachmentVertices[v] - slotB->attachmentVertices[v]);
+					if (difference > maxDifference) maxDifference = difference;
+				}
+			}
+		}
+	}
+	spSkeleton_dispose(skeletonA);
+	spSkeleton_dispose(skeletonB);
+	return maxDifference;
+}
+
+int main (int argc, char** argv) {
+	int iterations = argc > 1 ? atoi(argv[1]) : 200;
+	const char* jsonPath = argc > 3 ? argv[2] : "data/spineboy.json";
+	const char* atlasPath = argc > 3 ? argv[3] : "data/spineboy.atlas";
+	int atlasLength, atlasBinaryLength, jsonLength, binaryLength, i, ok = 1;
+	char* atlasText = _readFile(atlasPath, &atlasLength);
+	char* json = _readFile(jsonPath, &jsonLength);
+	unsigned char *atlasBinary, *binary;
+	spAtlas* atlas;
+	spSkeletonData* skeletonData;
+	double t0, atlasTextTime, atlasBinaryTime, jsonTime, binaryTime;
+	float scale;
+
+	if (!atlasText || !json) {
+		printf("Unable to read %s or %s.\n", jsonPath, atlasPath);
+		return 1;
+	}
+	if (iterations < 1) iterations = 1;
+
+	atlas = spAtlas_create(atlasText, atlasLength, "", 0);
+	atlasBinary = spSkeletonBinary_writeAtlas(atlas, &atlasBinaryLength);
+	skeletonData = readJson(atlas, json, 1);
+	binary = spSkeletonBinary_writeSkeletonData(skeletonData, &binaryLength);
+	spSkeletonData_dispose(skeletonData);
+	spAtlas_dispose(atlas);
+
+	t0 = getTime();
+	for (i = 0; i < iterations; ++i)
+		spAtlas_dispose(spAtlas_create(atlasText, atlasLength, "", 0));
+	atlasTextTime = (getTime() - t0) / iterations;
+	t0 = getTime();
+	for (i = 0; i < iterations; ++i)
+		spAtlas_dispose(spAtlas_create((const char*)atlasBinary, atlasBinaryLength, "", 0));
+	atlasBinaryTime = (getTime() - t0) / iterations;
+
+	atlas = spAtlas_create((const char*)atlasBinary, atlasBinaryLength, "", 0);
+	t0 = getTime();
+	for (i = 0; i < iterations; ++i)
+		spSkeletonData_dispose(readJson(atlas, json, 1));
+	jsonTime = (getTime() - t0) / iterations;
+	t0 = getTime();
+	for (i = 0; i < iterations; ++i)
+		spSkeletonData_dispose(readBinary(atlas, binary, binaryLength, 1));
+	binaryTime = (getTime() - t0) / iterations;
+
+	printf("%-10s %10s %10s %12s %12s %8s\n", "", "text", "binary", "text load", "binary load", "speedup");
+	printf("%-10s %8d B %8d B %9.1f us %9.1f us %7.1fx\n", "atlas", atlasLength, atlasBinaryLength, atlasTextTime * 1e6,
+			atlasBinaryTime * 1e6, atlasTextTime / atlasBinaryTime);
+	printf("%-10s %8d B %8d B %9.1f us %9.1f us %7.1fx\n", "skeleton", jsonLength, binaryLength, jsonTime * 1e6,
+			binaryTime * 1e6, jsonTime / binaryTime);
+
+	for (scale = 1; scale > 0.4f; scale -= 0.5f) {
+		spSkeletonData* fromJson = readJson(atlas, json, scale);
+		spSkeletonData* fromBinary = readBinary(atlas, binary, binaryLength, scale);
+		float difference = fromJson && fromBinary ? comparePoses(fromJson, fromBinary) : 1e9f;
+		printf("scale %.1f: largest pose difference %g\n", scale, difference);
+		if (difference > 1e-3f) ok = 0;
+		if (fromJson) spSkeletonData_dispose(fromJson);
+		if (fromBinary) spSkeletonData_dispose(fromBinary);
+	}
+
+	spAtlas_dispose(atlas);
+	FREE(atlasText);
+	FREE(json);
+	FREE(atlasBinary);
+	FREE(binary);
+	printf(ok ? "ok\n" : "FAILED\n");
+	return ok ? 0 : 1;
+}
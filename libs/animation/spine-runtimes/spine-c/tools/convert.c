@@ -0,0 +1,120 @@
+/******************************************************************************
+ * Spine Runtimes Software License
+ * Version 2.3
+ * 
+ * Copyright (c) 2013-2015, Esoteric Software
+ * All rights reserved.
+ * 
+ * You are granted a perpetual, non-exclusive, non-sublicensable and
+ * non-transferable license to use, install, execute and perform the Spine
+ * Runtimes Software (the "Software") and derivative works solely for personal
+ * or internal use. Without the written permission of Esoteric Software (see
+ * Section 2 of the Spine Software License Agreement), you may not (a) modify,
+ * translate, adapt or otherwise create derivative works, improvements of the
+ * Software or develop new applications using the Software or (b) remove,
+ * delete, alter or obscure any trademarks or any copyright, trademark, patent
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+/* Converts a JSON skeleton or a text atlas to the binary format read by spSkeletonBinary and spAtlas_create.
+ *   spine-convert skeleton.json skeleton.skel
+ *   spine-convert skeleton.atlas skeleton.atlasb */
+
+#include <stdio.h>
+#include <spine/spine.h>
+#include <spine/extension.h>
+
+void _spAtlasPage_createTexture (spAtlasPage* self, const char* path) {
+}
+
+void _spAtlasPage_disposeTexture (spAtlasPage* self) {
+}
+
+char* _spUtil_readFile (const char* path, int* length) {
+	return _readFile(path, length);
+}
+
+/* Creates attachments without looking up atlas regions, which the binary format does not store. */
+static spAttachment* _newAttachment (spAttachmentLoader* loader, spSkin* skin, spAttachmentType type, const char* name,
+		const char* path) {
+	switch (type) {
+	case SP_ATTACHMENT_REGION:
+		return SUPER(spRegionAttachment_create(name));
+	case SP_ATTACHMENT_MESH:
+		return SUPER(spMeshAttachment_create(name));
+	case SP_ATTACHMENT_SKINNED_MESH:
+		return SUPER(spSkinnedMeshAttachment_create(name));
+	case SP_ATTACHMENT_BOUNDING_BOX:
+		return SUPER(spBoundingBoxAttachment_create(name));
+	default:
+		_spAttachmentLoader_setUnknownTypeError(loader, type);
+		return 0;
+	}
+}
+
+static int endsWith (const char* value, const char* suffix) {
+	size_t length = strlen(value), suffixLength = strlen(suffix);
+	return length >= suffixLength && strcmp(value + length - suffixLength, suffix) == 0;
+}
+
+int main (int argc, char** argv) {
+	unsigned char* binary;
+	int length;
+	FILE* file;
+
+	if (argc != 3) {
+		printf("Usage: %s input.json|input.atlas output\n", argv[0]);
+		return 1;
+	}
+
+	if (endsWith(argv[1], ".atlas")) {
+		spAtlas* atlas = spAtlas_createFromFile(argv[1], 0);
+		if (!atlas) {
+			printf("Unable to read atlas: %s\n", argv[1]);
+			return 1;
+		}
+		binary = spSkeletonBinary_writeAtlas(atlas, &length);
+		spAtlas_dispose(atlas);
+	} else {
+		spAttachmentLoader* loader = NEW(spAttachmentLoader);
+		spSkeletonJson* json;
+		spSkeletonData* skeletonData;
+		_spAttachmentLoader_init(loader, _spAttachmentLoader_deinit, _newAttachment);
+		json = spSkeletonJson_createWithLoader(loader);
+		skeletonData = spSkeletonJson_readSkeletonDataFile(json, argv[1]);
+		if (!skeletonData) {
+			printf("%s\n", json->error);
+			return 1;
+		}
+		binary = spSkeletonBinary_writeSkeletonData(skeletonData, &length);
+		spSkeletonData_dispose(skeletonData);
+		spSkeletonJson_dispose(json);
+		spAttachmentLoader_dispose(loader);
+		if (!binary) {
+			printf("An FFD timeline's attachment is not in a skin: %s\n", argv[1]);
+			return 1;
+		}
+	}
+
+	file = fopen(argv[2], "wb");
+	if (!file || fwrite(binary, 1, length, file) != (size_t)length) {
+		printf("Unable to write: %s\n", argv[2]);
+		return 1;
+	}
+	fclose(file);
+	FREE(binary);
+	return 0;
+}
@@ -0,0 +1,129 @@
+/*
+SoLoud audio engine
+Copyright (c) 2013-2015 Jari Komppa
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+
+#include "soloud.h"
+
+// Offline render benchmark: mixes many voices through the null driver as fast as possible and
+// reports the render speed for each resampler and speaker setup.
+//
+//   mixbench [voices] [seconds of audio] [mix threads]
+
+// Looping noise source with a given channel count and sample rate
+class NoiseInstance : public SoLoud::AudioSourceInstance
+{
+	unsigned int mSeed;
+public:
+	NoiseInstance(unsigned int aSeed)
+	{
+		mSeed = aSeed;
+	}
+
+	virtual void getAudio(float *aBuffer, unsigned int aSamples)
+	{
+		unsigned int i;
+		for (i = 0; i < aSamples * mChannels; i++)
+		{
+			mSeed = mSeed * 1103515245 + 12345;
+			aBuffer[i] = ((mSeed >> 16) & 0x7fff) * (1 / 16384.0f) - 1;
+		}
+	}
+
+	virtual bool hasEnded()
+	{
+		return false;
+	}
+};
+
+class Noise : public SoLoud::AudioSource
+{
+public:
+	virtual SoLoud::AudioSourceInstance *createInstance()
+	{
+		return new NoiseInstance(mAudioSourceID * 7919);
+	}
+};
+
+static const char *gResamplerName[] = { "point", "linear", "sinc" };
+
+int main(int argc, char *argv[])
+{
+	unsigned int voices = argc > 1 ? atoi(argv[1]) : 256;
+	unsigned int seconds = argc > 2 ? atoi(argv[2]) : 10;
+	unsigned int threads = argc > 3 ? atoi(argv[3]) : 0;
+	unsigned int channels[] = { 2, 6 };
+	unsigned int c, r, i;
+
+	for (c = 0; c < 2; c++)
+	{
+		for (r = SoLoud::Soloud::RESAMPLE_POINT; r <= SoLoud::Soloud::RESAMPLE_SINC; r++)
+		{
+			SoLoud::Soloud soloud;
+			if (soloud.init(0, SoLoud::Soloud::NULLDRIVER, 48000, 1024, channels[c]) != SoLoud::SO_NO_ERROR)
+			{
+				printf("Could not initialize the null driver\n");
+				return 1;
+			}
+			soloud.setMaxActiveVoiceCount(voices);
+			soloud.setMixThreadCount(threads);
+
+			// Mono and stereo sources at rates that don't match the output, so every voice is resampled
+			Noise *noise = new Noise[voices];
+			SoLoud::handle *handle = new SoLoud::handle[voices];
+			for (i = 0; i < voices; i++)
+			{
+				noise[i].mChannels = (i & 1) ? 2 : 1;
+				noise[i].mBaseSamplerate = (i & 2) ? 44100.0f : 22050.0f;
+				noise[i].setResampler(r);
+				handle[i] = soloud.play(noise[i], 1.0f / voices, (i % 9) / 4.0f - 1);
+			}
+
+			float *buf = new float[1024 * channels[c]];
+			unsigned int frames = seconds * 48000 / 1024;
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			for (i = 0; i < frames; i++)
+			{
+				// Keep the pan ramps busy
+				if ((i & 15) == 0)
+					soloud.setPan(handle[i % voices], (i % 7) / 3.0f - 1);
+				soloud.mix(buf, 1024);
+			}
+			int ms = (int)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+			printf("%u ch, %-6s: %u voices, %u s of audio in %d ms (%.1fx realtime), %u deadline misses\n",
+				channels[c], gResamplerName[r], voices, seconds, ms, ms ? seconds * 1000.0f / ms : 0.0f, soloud.getMixDeadlineMissCount());
+
+			soloud.deinit();
+			delete[] buf;
+			delete[] handle;
+			delete[] noise;
+		}
+	}
+
+	return 0;
+}
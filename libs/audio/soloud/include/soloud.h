@@ -39,6 +39,9 @@ freely, subject to the following restrictions:
 #if !defined(DISABLE_SIMD)
 #if defined(__x86_64__) || defined( _M_X64 ) || defined( __i386 ) || defined( _M_IX86 )
 #define SOLOUD_SSE_INTRINSICS
+#if defined(__AVX__)
+#define SOLOUD_AVX_INTRINSICS
+#endif
 #endif
 #endif
 
@@ -57,12 +60,21 @@ freely, subject to the following restrictions:
 // Maximum number of concurrent voices (hard limit is 4095)
 #define VOICE_COUNT 1024
 
-// Use linear resampler
+// Use linear resampler by default (otherwise point sample); see Soloud::RESAMPLERS
 #define RESAMPLER_LINEAR
 
 // 1)mono, 2)stereo 4)quad 6)5.1
 #define MAX_CHANNELS 6
 
+// Maximum number of voice mixing worker threads
+#define MAX_MIX_THREADS 16
+
+// Number of voices per mixing worker task
+#define MIX_VOICE_BATCH 16
+
+// Share of a buffer's duration, in percent, the audio thread waits for mixing workers before leaving their voices out
+#define MIX_DEADLINE_PERCENT 50
+
 //
 /////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////
@@ -147,6 +159,13 @@ namespace SoLoud
 			LEFT_HANDED_3D = 4
 		};
 
+		enum RESAMPLERS
+		{
+			RESAMPLE_POINT = 0,
+			RESAMPLE_LINEAR,
+			RESAMPLE_SINC
+		};
+
 		// Initialize SoLoud. Must be called before SoLoud can be used.
 		result init(unsigned int aFlags = Soloud::CLIP_ROUNDOFF, unsigned int aBackend = Soloud::AUTO, unsigned int aSamplerate = Soloud::AUTO, unsigned int aBufferSize = Soloud::AUTO, unsigned int aChannels = 2);
 
@@ -228,13 +247,21 @@ namespace SoLoud
 		float getGlobalVolume() const;
 		// Get current maximum active voice setting
 		unsigned int getMaxActiveVoiceCount() const;
+		// Get current number of voice mixing worker threads
+		unsigned int getMixThreadCount() const;
+		// Get number of buffers in which voices were left out because a mixing worker missed its deadline
+		unsigned int getMixDeadlineMissCount() const;
 		// Query whether a voice is set to loop.
 		bool getLooping(handle aVoiceHandle);
+		// Get current resampler (RESAMPLERS enum)
+		unsigned int getResampler(handle aVoiceHandle);
 		
 		// Set voice's loop state
 		void setLooping(handle aVoiceHandle, bool aLooping);
 		// Set current maximum active voice setting
 		result setMaxActiveVoiceCount(unsigned int aVoiceCount);
+		// Set number of worker threads mixing voices alongside the audio thread; 0 mixes on the audio thread only. Call after init. Audio sources must not share mutable state between instances.
+		result setMixThreadCount(unsigned int aThreadCount);
 		// Set behavior for inaudible sounds
 		void setInaudibleBehavior(handle aVoiceHandle, bool aMustTick, bool aKill);
 		// Set the global volume
@@ -251,6 +278,8 @@ namespace SoLoud
 		void setProtectVoice(handle aVoiceHandle, bool aProtect);
 		// Set the sample rate
 		void setSamplerate(handle aVoiceHandle, float aSamplerate);
+		// Set the resampler (RESAMPLERS enum); sinc is the highest quality and most expensive
+		result setResampler(handle aVoiceHandle, unsigned int aResampler);
 		// Set panning value; -1 is left, 0 is center, 1 is right
 		void setPan(handle aVoiceHandle, float aPan);
 		// Set absolute left/right volumes
@@ -358,6 +387,21 @@ namespace SoLoud
 		void calcActiveVoices();
 		// Perform mixing for a specific bus
 		void mixBus(float *aBuffer, unsigned int aSamples, float *aScratch, unsigned int aBus, float aSamplerate, unsigned int aChannels);
+		// Perform mixing for the main bus on the mixing workers
+		void mixBusParallel(float *aBuffer, unsigned int aSamples, float *aScratch, float aSamplerate, unsigned int aChannels);
+		// Resample, filter and pan one voice, accumulating into the buffer
+		void mixVoice(float *aBuffer, unsigned int aSamples, float *aScratch, unsigned int aVoice, float aSamplerate, unsigned int aChannels);
+		// Stop a voice that has ended during mixing, deferred while mixing in parallel
+		void endVoice(unsigned int aVoice);
+		// Retire the last parallel mix once all its batches are done, optionally waiting for late workers.
+		// Returns false if a worker is still mixing. Called with the audio mutex held.
+		bool finishMixJob(bool aWait);
+		// Voice mixing workers, NULL when mixing on the audio thread only
+		void *mMixPool;
+		// Number of voice mixing worker threads
+		unsigned int mMixThreadCount;
+		// Number of buffers in which voices were left out because a mixing worker missed its deadline
+		unsigned int mMixDeadlineMissCount;
 		// Max. number of active voices. Busses and tickable inaudibles also count against this.
 		unsigned int mMaxActiveVoices;
 		// Highest voice in use so far
@@ -186,6 +186,8 @@ namespace SoLoud
 		unsigned int mSrcOffset;
 		// Samples left over from earlier pass
 		unsigned int mLeftoverSamples;
+		// Resampler; see Soloud::RESAMPLERS
+		unsigned int mResampler;
 		// Number of samples to delay streaming
 		unsigned int mDelaySamples;
 
@@ -268,6 +270,8 @@ namespace SoLoud
 		AudioAttenuator *mAttenuator;
 		// User data related to audio collider
 		int mColliderData;
+		// Resampler for created instances; see Soloud::RESAMPLERS
+		unsigned int mResampler;
 
 		// CTor
 		AudioSource();
@@ -299,6 +303,9 @@ namespace SoLoud
 		// Set behavior for inaudible sounds
 		void setInaudibleBehavior(bool aMustTick, bool aKill);
 
+		// Set the resampler for the instances created from this audio source; see Soloud::RESAMPLERS
+		void setResampler(unsigned int aResampler);
+
 		// Set filter. Set to NULL to clear the filter.
 		virtual void setFilter(unsigned int aFilterId, Filter *aFilter);
 		// DTor
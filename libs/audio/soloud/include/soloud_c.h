@@ -53,6 +53,9 @@ enum SOLOUD_ENUMS
 	SOLOUD_CLIP_ROUNDOFF = 1,
 	SOLOUD_ENABLE_VISUALIZATION = 2,
 	SOLOUD_LEFT_HANDED_3D = 4,
+	SOLOUD_RESAMPLE_POINT = 0,
+	SOLOUD_RESAMPLE_LINEAR = 1,
+	SOLOUD_RESAMPLE_SINC = 2,
 	BIQUADRESONANTFILTER_NONE = 0,
 	BIQUADRESONANTFILTER_LOWPASS = 1,
 	BIQUADRESONANTFILTER_HIGHPASS = 2,
@@ -73,6 +76,9 @@ enum SOLOUD_ENUMS
 	SFXR_HURT = 4,
 	SFXR_JUMP = 5,
 	SFXR_BLIP = 6,
+	WAV_STORE_FLOAT = 0,
+	WAV_STORE_PCM16 = 1,
+	WAV_STORE_ADPCM = 2,
 	FLANGERFILTER_WET = 0,
 	FLANGERFILTER_DELAY = 1,
 	FLANGERFILTER_FREQ = 2,
@@ -151,9 +157,13 @@ float Soloud_getRelativePlaySpeed(Soloud * aSoloud, unsigned int aVoiceHandle);
 float Soloud_getPostClipScaler(Soloud * aSoloud);
 float Soloud_getGlobalVolume(Soloud * aSoloud);
 unsigned int Soloud_getMaxActiveVoiceCount(Soloud * aSoloud);
+unsigned int Soloud_getMixThreadCount(Soloud * aSoloud);
+unsigned int Soloud_getMixDeadlineMissCount(Soloud * aSoloud);
 int Soloud_getLooping(Soloud * aSoloud, unsigned int aVoiceHandle);
+unsigned int Soloud_getResampler(Soloud * aSoloud, unsigned int aVoiceHandle);
 void Soloud_setLooping(Soloud * aSoloud, unsigned int aVoiceHandle, int aLooping);
 int Soloud_setMaxActiveVoiceCount(Soloud * aSoloud, unsigned int aVoiceCount);
+int Soloud_setMixThreadCount(Soloud * aSoloud, unsigned int aThreadCount);
 void Soloud_setInaudibleBehavior(Soloud * aSoloud, unsigned int aVoiceHandle, int aMustTick, int aKill);
 void Soloud_setGlobalVolume(Soloud * aSoloud, float aVolume);
 void Soloud_setPostClipScaler(Soloud * aSoloud, float aScaler);
@@ -162,6 +172,7 @@ void Soloud_setPauseAll(Soloud * aSoloud, int aPause);
 int Soloud_setRelativePlaySpeed(Soloud * aSoloud, unsigned int aVoiceHandle, float aSpeed);
 void Soloud_setProtectVoice(Soloud * aSoloud, unsigned int aVoiceHandle, int aProtect);
 void Soloud_setSamplerate(Soloud * aSoloud, unsigned int aVoiceHandle, float aSamplerate);
+int Soloud_setResampler(Soloud * aSoloud, unsigned int aVoiceHandle, unsigned int aResampler);
 void Soloud_setPan(Soloud * aSoloud, unsigned int aVoiceHandle, float aPan);
 void Soloud_setPanAbsolute(Soloud * aSoloud, unsigned int aVoiceHandle, float aLVolume, float aRVolume);
 void Soloud_setVolume(Soloud * aSoloud, unsigned int aVoiceHandle, float aVolume);
@@ -307,6 +318,7 @@ int Wav_load(Wav * aWav, const char * aFilename);
 int Wav_loadMem(Wav * aWav, unsigned char * aMem, unsigned int aLength);
 int Wav_loadMemEx(Wav * aWav, unsigned char * aMem, unsigned int aLength, int aCopy /* = false */, int aTakeOwnership /* = true */);
 int Wav_loadFile(Wav * aWav, File * aFile);
+int Wav_setStorage(Wav * aWav, unsigned int aStorage);
 double Wav_getLength(Wav * aWav);
 void Wav_setVolume(Wav * aWav, float aVolume);
 void Wav_setLooping(Wav * aWav, int aLoop);
@@ -73,8 +73,18 @@ namespace SoLoud
 
 	// Convert to 16-bit and interlace samples in a buffer. From 11112222 to 12121212
 	void interlace_samples_s16(const float *aSourceBuffer, short *aDestBuffer, unsigned int aSamples, unsigned int aChannels);
+
+	// Resample one channel of a voice. aSrc is the current block, aSrc1 the previous one; aResampler is Soloud::RESAMPLERS
+	void resample(unsigned int aResampler, float *aSrc, float *aSrc1, float *aDst, int aSrcOffset, int aDstSampleCount, int aStepFixed);
+
+	// Accumulate a channel with a volume ramp: aDst[i] += aSrc[i] * (aVolume + aVolumeStep * (i + 1))
+	void panAccumulate(float *aDst, const float *aSrc, unsigned int aSamples, float aVolume, float aVolumeStep);
 };
 
+#define FIXPOINT_FRAC_BITS 20
+#define FIXPOINT_FRAC_MUL (1 << FIXPOINT_FRAC_BITS)
+#define FIXPOINT_FRAC_MASK ((1 << FIXPOINT_FRAC_BITS) - 1)
+
 #define FOR_ALL_VOICES_PRE \
 		handle *h_ = NULL; \
 		handle th_[2] = { aVoiceHandle, 0 }; \
@@ -41,9 +41,23 @@ namespace SoLoud
 		void lockMutex(void *aHandle);
 		void unlockMutex(void *aHandle);
 
+		// Counting semaphore. Posting never blocks, so it is safe to call from the audio thread.
+		void * createSemaphore();
+		void destroySemaphore(void *aHandle);
+		void postSemaphore(void *aHandle);
+		void waitSemaphore(void *aHandle);
+
+		// Full-barrier atomics. Increment returns the new value, compare-exchange the previous one.
+		// Load has acquire semantics.
+		int atomicLoad(volatile int *aValue);
+		int atomicIncrement(volatile int *aValue);
+		int atomicCompareExchange(volatile int *aValue, int aExchange, int aComparand);
+
 		ThreadHandle createThread(threadFunction aThreadFunction, void *aParameter);
 
 		void sleep(int aMSec);
+		// Monotonic clock, for mixing deadlines
+		unsigned long long getTimeMicroseconds();
         void wait(ThreadHandle aThreadHandle);
         void release(ThreadHandle aThreadHandle);
 
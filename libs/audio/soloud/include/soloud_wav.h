@@ -34,10 +34,20 @@ namespace SoLoud
 	class Wav;
 	class File;
 
+	// Where an ADPCM channel was last decoded, so sequential reads continue without going back to the block start
+	struct WavAdpcmDecoder
+	{
+		// Next sample the predictor is positioned at; ~0 if nothing has been decoded yet
+		unsigned int mOffset;
+		int mPredictor;
+		int mIndex;
+	};
+
 	class WavInstance : public AudioSourceInstance
 	{
 		Wav *mParent;
 		unsigned int mOffset;
+		WavAdpcmDecoder mAdpcm[MAX_CHANNELS];
 	public:
 		WavInstance(Wav *aParent);
 		virtual void getAudio(float *aBuffer, unsigned int aSamples);
@@ -50,8 +60,29 @@ namespace SoLoud
 		result loadwav(File *aReader);
 		result loadogg(stb_vorbis *aVorbis);
 		result testAndLoadFile(File *aReader);
+		result compress();
+		void clear();
 	public:
+		enum STORAGE
+		{
+			// 32-bit float samples, 4 bytes per sample
+			STORE_FLOAT = 0,
+			// 16-bit PCM, 2 bytes per sample
+			STORE_PCM16,
+			// IMA ADPCM blocks, about half a byte per sample; each voice decodes its own position
+			STORE_ADPCM
+		};
+
+		// Float samples; NULL if the sound is stored compressed
 		float *mData;
+		// 16-bit samples for STORE_PCM16
+		short *mPcm16Data;
+		// ADPCM blocks for STORE_ADPCM
+		unsigned char *mAdpcmData;
+		// Number of ADPCM blocks per channel
+		unsigned int mAdpcmBlockCount;
+		// Storage format; see STORAGE
+		unsigned int mStorage;
 		unsigned int mSampleCount;
 
 		Wav();
@@ -59,6 +90,10 @@ namespace SoLoud
 		result load(const char *aFilename);
 		result loadMem(unsigned char *aMem, unsigned int aLength, bool aCopy = false, bool aTakeOwnership = true);
 		result loadFile(File *aFile);
+		// Set the storage format. Converts loaded samples (stopping playing instances) and applies to later loads.
+		result setStorage(unsigned int aStorage);
+		// Decode samples of one channel into aDst. aDecoder keeps the ADPCM position between calls; may be NULL.
+		void decodeSamples(float *aDst, unsigned int aChannel, unsigned int aOffset, unsigned int aSamples, WavAdpcmDecoder *aDecoder = NULL);
 		
 		virtual AudioSourceInstance *createInstance();
 		time getLength();
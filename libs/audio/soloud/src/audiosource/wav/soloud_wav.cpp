@@ -25,22 +25,153 @@ freely, subject to the following restrictions:
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
 #include "soloud.h"
 #include "soloud_wav.h"
 #include "soloud_file.h"
 #include "stb_vorbis.h"
 
+// Samples per ADPCM block. Blocks are independent so any offset can be decoded without history.
+#define ADPCM_BLOCK_SAMPLES 1024
+// Block header (16-bit first sample, step index, padding) followed by a nibble for each of the other samples
+#define ADPCM_BLOCK_BYTES (4 + ADPCM_BLOCK_SAMPLES / 2)
+
 namespace SoLoud
 {
+	static const int gAdpcmStepTable[89] =
+	{
+		7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+		50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+		253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+		1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+		3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+		12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+	};
+
+	static const int gAdpcmIndexTable[16] =
+	{
+		-1, -1, -1, -1, 2, 4, 6, 8,
+		-1, -1, -1, -1, 2, 4, 6, 8
+	};
+
+	// Applies one nibble to the predictor; shared by the encoder and the decoder so they stay in sync
+	static inline void adpcmStep(int aNibble, int &aPredictor, int &aIndex)
+	{
+		int step = gAdpcmStepTable[aIndex];
+		int diff = step >> 3;
+		if (aNibble & 4) diff += step;
+		if (aNibble & 2) diff += step >> 1;
+		if (aNibble & 1) diff += step >> 2;
+		aPredictor += (aNibble & 8) ? -diff : diff;
+		if (aPredictor > 32767) aPredictor = 32767;
+		if (aPredictor < -32768) aPredictor = -32768;
+		aIndex += gAdpcmIndexTable[aNibble];
+		if (aIndex < 0) aIndex = 0;
+		if (aIndex > 88) aIndex = 88;
+	}
+
+	static inline int toPcm16(float aSample)
+	{
+		int v = (int)floor(aSample * 0x8000 + 0.5f);
+		return v > 32767 ? 32767 : v < -32768 ? -32768 : v;
+	}
+
+	// Encodes up to ADPCM_BLOCK_SAMPLES samples (the rest of the block is silence). aIndex carries the step size between blocks.
+	static void encodeAdpcmBlock(const float *aSrc, unsigned int aSamples, unsigned char *aBlock, int &aIndex)
+	{
+		int predictor = aSamples ? toPcm16(aSrc[0]) : 0;
+		unsigned int i;
+		aBlock[0] = (unsigned char)(predictor & 0xff);
+		aBlock[1] = (unsigned char)((predictor >> 8) & 0xff);
+		aBlock[2] = (unsigned char)aIndex;
+		aBlock[3] = 0;
+		memset(aBlock + 4, 0, ADPCM_BLOCK_SAMPLES / 2);
+		for (i = 1; i < ADPCM_BLOCK_SAMPLES; i++)
+		{
+			int diff = (i < aSamples ? toPcm16(aSrc[i]) : 0) - predictor;
+			int step = gAdpcmStepTable[aIndex];
+			int nibble = 0;
+			if (diff < 0)
+			{
+				nibble = 8;
+				diff = -diff;
+			}
+			if (diff >= step) { nibble |= 4; diff -= step; }
+			if (diff >= step >> 1) { nibble |= 2; diff -= step >> 1; }
+			if (diff >= step >> 2) { nibble |= 1; }
+			adpcmStep(nibble, predictor, aIndex);
+			aBlock[4 + ((i - 1) >> 1)] |= (unsigned char)(nibble << (((i - 1) & 1) * 4));
+		}
+	}
+
+	static void decodeAdpcmBlock(const unsigned char *aBlock, float *aDst)
+	{
+		int predictor = (short)(aBlock[0] | (aBlock[1] << 8));
+		int index = aBlock[2];
+		unsigned int i;
+		aDst[0] = predictor / (float)0x8000;
+		for (i = 1; i < ADPCM_BLOCK_SAMPLES; i++)
+		{
+			int nibble = (aBlock[4 + ((i - 1) >> 1)] >> (((i - 1) & 1) * 4)) & 0xf;
+			adpcmStep(nibble, predictor, index);
+			aDst[i] = predictor / (float)0x8000;
+		}
+	}
+
+	// Decodes aSamples samples of one channel starting at aOffset. The decoder continues from its last position
+	// when the read follows on from it, and otherwise seeks forward from the start of the block.
+	static void decodeAdpcm(const unsigned char *aBlocks, WavAdpcmDecoder &aDecoder, float *aDst, unsigned int aOffset, unsigned int aSamples)
+	{
+		unsigned int end = aOffset + aSamples;
+		if (aDecoder.mOffset != aOffset)
+		{
+			aDecoder.mOffset = aOffset - aOffset % ADPCM_BLOCK_SAMPLES;
+		}
+		while (aDecoder.mOffset < end)
+		{
+			const unsigned char *block = aBlocks + (aDecoder.mOffset / ADPCM_BLOCK_SAMPLES) * ADPCM_BLOCK_BYTES;
+			unsigned int i = aDecoder.mOffset % ADPCM_BLOCK_SAMPLES;
+			unsigned int last = end - aDecoder.mOffset < ADPCM_BLOCK_SAMPLES - i ? i + end - aDecoder.mOffset : ADPCM_BLOCK_SAMPLES;
+			int predictor = aDecoder.mPredictor;
+			int index = aDecoder.mIndex;
+			for (; i < last; i++, aDecoder.mOffset++)
+			{
+				if (i == 0)
+				{
+					predictor = (short)(block[0] | (block[1] << 8));
+					index = block[2];
+				}
+				else
+				{
+					int nibble = (block[4 + ((i - 1) >> 1)] >> (((i - 1) & 1) * 4)) & 0xf;
+					adpcmStep(nibble, predictor, index);
+				}
+				if (aDecoder.mOffset >= aOffset)
+				{
+					*aDst++ = predictor / (float)0x8000;
+				}
+			}
+			aDecoder.mPredictor = predictor;
+			aDecoder.mIndex = index;
+		}
+	}
+
 	WavInstance::WavInstance(Wav *aParent)
 	{
 		mParent = aParent;
 		mOffset = 0;
+		unsigned int i;
+		for (i = 0; i < MAX_CHANNELS; i++)
+		{
+			mAdpcm[i].mOffset = ~0u;
+			mAdpcm[i].mPredictor = 0;
+			mAdpcm[i].mIndex = 0;
+		}
 	}
 
 	void WavInstance::getAudio(float *aBuffer, unsigned int aSamples)
 	{		
-		if (mParent->mData == NULL)
+		if (mParent->mSampleCount == 0)
 			return;
 
 		// Buffer size may be bigger than samples, and samples may loop..
@@ -65,7 +196,7 @@ namespace SoLoud
 			unsigned int i;
 			for (i = 0; i < channels; i++)
 			{
-				memcpy(aBuffer + i * aSamples + written, mParent->mData + mOffset + i * mParent->mSampleCount, sizeof(float) * copysize);
+				mParent->decodeSamples(aBuffer + i * aSamples + written, i, mOffset, copysize, &mAdpcm[i]);
 			}
 
 			written += copysize;
@@ -113,13 +244,167 @@ namespace SoLoud
 	Wav::Wav()
 	{
 		mData = NULL;
+		mPcm16Data = NULL;
+		mAdpcmData = NULL;
+		mAdpcmBlockCount = 0;
+		mStorage = STORE_FLOAT;
 		mSampleCount = 0;
 	}
 	
 	Wav::~Wav()
 	{
 		stop();
+		clear();
+	}
+
+	void Wav::clear()
+	{
+		delete[] mData;
+		delete[] mPcm16Data;
+		delete[] mAdpcmData;
+		mData = NULL;
+		mPcm16Data = NULL;
+		mAdpcmData = NULL;
+		mAdpcmBlockCount = 0;
+		mSampleCount = 0;
+	}
+
+	result Wav::compress()
+	{
+		unsigned int i, j, channels = mChannels;
+		if (mData == NULL || mStorage == STORE_FLOAT)
+		{
+			return SO_NO_ERROR;
+		}
+
+		if (mStorage == STORE_PCM16)
+		{
+			mPcm16Data = new short[mSampleCount * channels];
+			if (mPcm16Data == NULL)
+			{
+				return OUT_OF_MEMORY;
+			}
+			for (i = 0; i < mSampleCount * channels; i++)
+			{
+				mPcm16Data[i] = (short)toPcm16(mData[i]);
+			}
+		}
+		else
+		{
+			mAdpcmBlockCount = (mSampleCount + ADPCM_BLOCK_SAMPLES - 1) / ADPCM_BLOCK_SAMPLES;
+			mAdpcmData = new unsigned char[mAdpcmBlockCount * channels * ADPCM_BLOCK_BYTES];
+			if (mAdpcmData == NULL)
+			{
+				mAdpcmBlockCount = 0;
+				return OUT_OF_MEMORY;
+			}
+			for (i = 0; i < channels; i++)
+			{
+				// Later blocks carry the step size over; the first one starts from whichever step fits it best,
+				// so the sound doesn't begin (or loop) with a burst of error while the step adapts.
+				unsigned int first = mSampleCount < ADPCM_BLOCK_SAMPLES ? mSampleCount : ADPCM_BLOCK_SAMPLES;
+				int index = 0, k;
+				float bestError = -1;
+				for (k = 0; k <= 88; k++)
+				{
+					unsigned char block[ADPCM_BLOCK_BYTES];
+					float decoded[ADPCM_BLOCK_SAMPLES], error = 0;
+					int tryindex = k;
+					encodeAdpcmBlock(mData + i * mSampleCount, first, block, tryindex);
+					decodeAdpcmBlock(block, decoded);
+					for (j = 0; j < first; j++)
+					{
+						float d = decoded[j] - mData[i * mSampleCount + j];
+						error += d * d;
+					}
+					if (bestError < 0 || error < bestError)
+					{
+						bestError = error;
+						index = k;
+					}
+				}
+				for (j = 0; j < mAdpcmBlockCount; j++)
+				{
+					unsigned int ofs = j * ADPCM_BLOCK_SAMPLES;
+					unsigned int samples = mSampleCount - ofs < ADPCM_BLOCK_SAMPLES ? mSampleCount - ofs : ADPCM_BLOCK_SAMPLES;
+					encodeAdpcmBlock(mData + i * mSampleCount + ofs, samples, mAdpcmData + (i * mAdpcmBlockCount + j) * ADPCM_BLOCK_BYTES, index);
+				}
+			}
+		}
+
 		delete[] mData;
+		mData = NULL;
+		return SO_NO_ERROR;
+	}
+
+	result Wav::setStorage(unsigned int aStorage)
+	{
+		unsigned int i;
+		if (aStorage > STORE_ADPCM)
+		{
+			return INVALID_PARAMETER;
+		}
+		if (aStorage == mStorage)
+		{
+			return SO_NO_ERROR;
+		}
+		if (mSampleCount == 0)
+		{
+			mStorage = aStorage;
+			return SO_NO_ERROR;
+		}
+
+		// Convert through float
+		stop();
+		if (mData == NULL)
+		{
+			float *data = new float[mSampleCount * mChannels];
+			if (data == NULL)
+			{
+				return OUT_OF_MEMORY;
+			}
+			for (i = 0; i < mChannels; i++)
+			{
+				decodeSamples(data + i * mSampleCount, i, 0, mSampleCount);
+			}
+			delete[] mPcm16Data;
+			delete[] mAdpcmData;
+			mPcm16Data = NULL;
+			mAdpcmData = NULL;
+			mAdpcmBlockCount = 0;
+			mData = data;
+		}
+		mStorage = aStorage;
+		return compress();
+	}
+
+	void Wav::decodeSamples(float *aDst, unsigned int aChannel, unsigned int aOffset, unsigned int aSamples, WavAdpcmDecoder *aDecoder)
+	{
+		unsigned int i;
+		if (mData)
+		{
+			memcpy(aDst, mData + aOffset + aChannel * mSampleCount, sizeof(float) * aSamples);
+		}
+		else
+		if (mPcm16Data)
+		{
+			const short *src = mPcm16Data + aOffset + aChannel * mSampleCount;
+			for (i = 0; i < aSamples; i++)
+			{
+				aDst[i] = src[i] / (float)0x8000;
+			}
+		}
+		else
+		if (mAdpcmData)
+		{
+			WavAdpcmDecoder decoder;
+			if (aDecoder == NULL)
+			{
+				decoder.mOffset = ~0u;
+				aDecoder = &decoder;
+			}
+			decodeAdpcm(mAdpcmData + aChannel * mAdpcmBlockCount * ADPCM_BLOCK_BYTES, *aDecoder, aDst, aOffset, aSamples);
+		}
 	}
 
 #define MAKEDWORD(a,b,c,d) (((d) << 24) | ((c) << 16) | ((b) << 8) | (a))
@@ -277,9 +562,9 @@ namespace SoLoud
 
     result Wav::testAndLoadFile(File *aReader)
     {
-		delete[] mData;
-		mData = 0;
-		mSampleCount = 0;
+		clear();
+		mChannels = 1;
+		int res = FILE_LOAD_FAILED;
         int tag = aReader->read32();
 		if (tag == MAKEDWORD('O','g','g','S')) 
         {
@@ -290,15 +575,19 @@ namespace SoLoud
 
 			if (0 != v)
             {
-				return loadogg(v);
+				res = loadogg(v);
             }
-			return FILE_LOAD_FAILED;
 		} 
         else if (tag == MAKEDWORD('R','I','F','F')) 
         {
-			return loadwav(aReader);
+			res = loadwav(aReader);
+		}
+		if (res != SO_NO_ERROR)
+		{
+			return res;
 		}
-		return FILE_LOAD_FAILED;
+		// Loaders decode to float; other storage formats are converted from that
+		return compress();
     }
 
 	result Wav::load(const char *aFilename)
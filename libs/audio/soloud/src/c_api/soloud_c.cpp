@@ -299,12 +299,30 @@ unsigned int Soloud_getMaxActiveVoiceCount(void * aClassPtr)
 	return cl->getMaxActiveVoiceCount();
 }
 
+unsigned int Soloud_getMixThreadCount(void * aClassPtr)
+{
+	Soloud * cl = (Soloud *)aClassPtr;
+	return cl->getMixThreadCount();
+}
+
+unsigned int Soloud_getMixDeadlineMissCount(void * aClassPtr)
+{
+	Soloud * cl = (Soloud *)aClassPtr;
+	return cl->getMixDeadlineMissCount();
+}
+
 int Soloud_getLooping(void * aClassPtr, unsigned int aVoiceHandle)
 {
 	Soloud * cl = (Soloud *)aClassPtr;
 	return cl->getLooping(aVoiceHandle);
 }
 
+unsigned int Soloud_getResampler(void * aClassPtr, unsigned int aVoiceHandle)
+{
+	Soloud * cl = (Soloud *)aClassPtr;
+	return cl->getResampler(aVoiceHandle);
+}
+
 void Soloud_setLooping(void * aClassPtr, unsigned int aVoiceHandle, int aLooping)
 {
 	Soloud * cl = (Soloud *)aClassPtr;
@@ -317,6 +335,12 @@ int Soloud_setMaxActiveVoiceCount(void * aClassPtr, unsigned int aVoiceCount)
 	return cl->setMaxActiveVoiceCount(aVoiceCount);
 }
 
+int Soloud_setMixThreadCount(void * aClassPtr, unsigned int aThreadCount)
+{
+	Soloud * cl = (Soloud *)aClassPtr;
+	return cl->setMixThreadCount(aThreadCount);
+}
+
 void Soloud_setInaudibleBehavior(void * aClassPtr, unsigned int aVoiceHandle, int aMustTick, int aKill)
 {
 	Soloud * cl = (Soloud *)aClassPtr;
@@ -365,6 +389,12 @@ void Soloud_setSamplerate(void * aClassPtr, unsigned int aVoiceHandle, float aSa
 	cl->setSamplerate(aVoiceHandle, aSamplerate);
 }
 
+int Soloud_setResampler(void * aClassPtr, unsigned int aVoiceHandle, unsigned int aResampler)
+{
+	Soloud * cl = (Soloud *)aClassPtr;
+	return cl->setResampler(aVoiceHandle, aResampler);
+}
+
 void Soloud_setPan(void * aClassPtr, unsigned int aVoiceHandle, float aPan)
 {
 	Soloud * cl = (Soloud *)aClassPtr;
@@ -1002,6 +1032,12 @@ int Wav_loadFile(void * aClassPtr, File * aFile)
 	return cl->loadFile(aFile);
 }
 
+int Wav_setStorage(void * aClassPtr, unsigned int aStorage)
+{
+	Wav * cl = (Wav *)aClassPtr;
+	return cl->setStorage(aStorage);
+}
+
 double Wav_getLength(void * aClassPtr)
 {
 	Wav * cl = (Wav *)aClassPtr;
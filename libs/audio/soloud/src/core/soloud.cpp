@@ -107,6 +107,9 @@ namespace SoLoud
 		mAudioSourceID = 1;
 		mBackendString = 0;
 		mBackendID = 0;
+		mMixPool = 0;
+		mMixThreadCount = 0;
+		mMixDeadlineMissCount = 0;
 		int i;
 		for (i = 0; i < FILTERS_PER_STREAM; i++)
 		{
@@ -164,6 +167,7 @@ namespace SoLoud
 		if (mBackendCleanupFunc)
 			mBackendCleanupFunc(this);
 		mBackendCleanupFunc = 0;
+		setMixThreadCount(0);
 		if (mAudioThreadMutex)
 			Thread::destroyMutex(mAudioThreadMutex);
 		mAudioThreadMutex = NULL;
@@ -718,54 +722,340 @@ namespace SoLoud
 }
 #endif
 
-#define FIXPOINT_FRAC_BITS 20
-#define FIXPOINT_FRAC_MUL (1 << FIXPOINT_FRAC_BITS)
-#define FIXPOINT_FRAC_MASK ((1 << FIXPOINT_FRAC_BITS) - 1)
-
-	void resample(float *aSrc,
-		          float *aSrc1, 
-				  float *aDst, 
-				  int aSrcOffset,
-				  int aDstSampleCount,
-				  float aSrcSamplerate, 
-				  float aDstSamplerate,
-				  int aStepFixed)
+	// Workers for mixing the voices of the main bus in parallel. The audio thread never waits for a worker
+	// to wake up: voice batches are claimed with compare-exchange, and the audio thread claims and mixes
+	// whatever is left itself. It waits for batches a worker has already claimed only until the mixing
+	// deadline; batches still unfinished then are left out of the buffer, and their voices stay untouched
+	// until the worker is done (see Soloud::finishMixJob).
+	struct MixPool
 	{
-#if 0
+		struct Worker
+		{
+			MixPool *mPool;
+			unsigned int mIndex;
+		};
+
+		Soloud *mSoloud;
+		unsigned int mThreadCount;
+		Thread::ThreadHandle *mThread;
+		Worker *mWorker;
+		void *mWakeSemaphore;
+		volatile int mRunning;
+
+		// Current job, written by the audio thread before the batches are published
+		unsigned int mVoiceList[VOICE_COUNT];
+		unsigned int mVoiceCount;
+		unsigned int mSamples;
+		unsigned int mChannels;
+		float mSamplerate;
+		// One accumulation buffer per batch, reduced into the bus in batch order
+		AlignedFloatBuffer mBatchBuffer;
+		unsigned int mBatchBufferSize;
+		// One resample scratch per worker; the audio thread uses the bus scratch
+		AlignedFloatBuffer mScratch;
+		unsigned int mScratchSize;
+
+		// (batch count << 16) | next unclaimed batch
+		volatile int mBatchState;
+		unsigned int mBatchCount;
+		volatile int mBatchesDone;
+		// Set per batch once its buffer is complete
+		volatile int mBatchDone[VOICE_COUNT / MIX_VOICE_BATCH];
+		// Set when the audio thread gave up waiting for a worker; only accessed with the audio mutex held
+		int mLate;
+		// Set while batches may be mixing on other threads
+		volatile int mParallel;
+
+		// Voices that ended while mixing in parallel; stopped after the reduction
+		unsigned int mEndedVoice[VOICE_COUNT];
+		volatile int mEndedVoiceCount;
+	};
+
+	static bool claimMixBatch(MixPool *aPool, unsigned int &aBatch)
+	{
+		for (;;)
+		{
+			int state = Thread::atomicLoad(&aPool->mBatchState);
+			if ((state & 0xffff) >= (state >> 16))
+				return false;
+			if (Thread::atomicCompareExchange(&aPool->mBatchState, state + 1, state) == state)
+			{
+				aBatch = state & 0xffff;
+				return true;
+			}
+		}
+	}
 
-#elif defined(RESAMPLER_LINEAR)
-		int i;
-		int pos = aSrcOffset;
+	static void mixBatch(MixPool *aPool, unsigned int aBatch, float *aScratch)
+	{
+		unsigned int i;
+		unsigned int floats = aPool->mSamples * aPool->mChannels;
+		float *buffer = aPool->mBatchBuffer.mData + aBatch * floats;
+		for (i = 0; i < floats; i++)
+		{
+			buffer[i] = 0;
+		}
 
-		for (i = 0; i < aDstSampleCount; i++, pos += aStepFixed)
+		unsigned int last = (aBatch + 1) * MIX_VOICE_BATCH;
+		if (last > aPool->mVoiceCount)
+			last = aPool->mVoiceCount;
+		for (i = aBatch * MIX_VOICE_BATCH; i < last; i++)
 		{
-			int p = pos >> FIXPOINT_FRAC_BITS;
-			int f = pos & FIXPOINT_FRAC_MASK;
-#ifdef _DEBUG
-			if (p >= SAMPLE_GRANULARITY || p < 0)
+			aPool->mSoloud->mixVoice(buffer, aPool->mSamples, aScratch, aPool->mVoiceList[i], aPool->mSamplerate, aPool->mChannels);
+		}
+
+		Thread::atomicIncrement(&aPool->mBatchDone[aBatch]);
+		Thread::atomicIncrement(&aPool->mBatchesDone);
+	}
+
+	static void mixWorker(void *aParam)
+	{
+		MixPool::Worker *worker = (MixPool::Worker *)aParam;
+		MixPool *pool = worker->mPool;
+		for (;;)
+		{
+			Thread::waitSemaphore(pool->mWakeSemaphore);
+			if (!pool->mRunning)
+				break;
+
+			unsigned int batch;
+			while (claimMixBatch(pool, batch))
 			{
-				// This should never actually happen
-				p = SAMPLE_GRANULARITY - 1;
+				mixBatch(pool, batch, pool->mScratch.mData + worker->mIndex * pool->mScratchSize * MAX_CHANNELS);
 			}
-#endif
-			float s1 = aSrc1[SAMPLE_GRANULARITY - 1];
-			float s2 = aSrc[p];
-			if (p != 0)
+		}
+	}
+
+	static void destroyMixPool(MixPool *aPool)
+	{
+		unsigned int i;
+		aPool->mRunning = 0;
+		for (i = 0; i < aPool->mThreadCount; i++)
+		{
+			Thread::postSemaphore(aPool->mWakeSemaphore);
+		}
+		for (i = 0; i < aPool->mThreadCount; i++)
+		{
+			if (aPool->mThread[i])
 			{
-				s1 = aSrc[p-1];
+				Thread::wait(aPool->mThread[i]);
+				Thread::release(aPool->mThread[i]);
 			}
-			aDst[i] = s1 + (s2 - s1) * f * (1 / (float)FIXPOINT_FRAC_MUL);
 		}
-#else // Point sample
-		int i;
-		int pos = aSrcOffset;
+		Thread::destroySemaphore(aPool->mWakeSemaphore);
+		delete[] aPool->mThread;
+		delete[] aPool->mWorker;
+		delete aPool;
+	}
 
-		for (i = 0; i < aDstSampleCount; i++, pos += aStepFixed)
+	result Soloud::setMixThreadCount(unsigned int aThreadCount)
+	{
+		if (aThreadCount > MAX_MIX_THREADS)
+			return INVALID_PARAMETER;
+
+		lockAudioMutex();
+		MixPool *old = (MixPool *)mMixPool;
+		mMixPool = 0;
+		mMixThreadCount = 0;
+		unlockAudioMutex();
+
+		if (old)
+			destroyMixPool(old);
+
+		if (aThreadCount == 0)
+			return SO_NO_ERROR;
+
+		MixPool *pool = new MixPool;
+		pool->mSoloud = this;
+		pool->mThreadCount = 0;
+		pool->mWakeSemaphore = Thread::createSemaphore();
+		pool->mRunning = 1;
+		pool->mVoiceCount = 0;
+		pool->mBatchBufferSize = 0;
+		pool->mScratchSize = 0;
+		pool->mBatchState = 0;
+		pool->mBatchCount = 0;
+		pool->mBatchesDone = 0;
+		pool->mLate = 0;
+		pool->mParallel = 0;
+		pool->mEndedVoiceCount = 0;
+		pool->mThread = new Thread::ThreadHandle[aThreadCount];
+		pool->mWorker = new MixPool::Worker[aThreadCount];
+		if (!pool->mWakeSemaphore)
 		{
-			int p = pos >> FIXPOINT_FRAC_BITS;
-			aDst[i] = aSrc[p];
+			destroyMixPool(pool);
+			return UNKNOWN_ERROR;
 		}
-#endif
+
+		unsigned int i;
+		for (i = 0; i < aThreadCount; i++)
+		{
+			pool->mWorker[i].mPool = pool;
+			pool->mWorker[i].mIndex = i;
+			pool->mThread[i] = Thread::createThread(mixWorker, &pool->mWorker[i]);
+			if (!pool->mThread[i])
+			{
+				destroyMixPool(pool);
+				return UNKNOWN_ERROR;
+			}
+			pool->mThreadCount++;
+		}
+
+		lockAudioMutex();
+		mMixPool = pool;
+		mMixThreadCount = aThreadCount;
+		unlockAudioMutex();
+		return SO_NO_ERROR;
+	}
+
+	void Soloud::endVoice(unsigned int aVoice)
+	{
+		MixPool *pool = (MixPool *)mMixPool;
+		if (pool && pool->mParallel)
+		{
+			// Other threads may be reading the voice list; stop once they're done.
+			pool->mEndedVoice[Thread::atomicIncrement(&pool->mEndedVoiceCount) - 1] = aVoice;
+		}
+		else
+		{
+			stopVoice(aVoice);
+		}
+	}
+
+	bool Soloud::finishMixJob(bool aWait)
+	{
+		MixPool *pool = (MixPool *)mMixPool;
+		unsigned int i;
+		for (i = 0; Thread::atomicLoad(&pool->mBatchesDone) != (int)pool->mBatchCount; i++)
+		{
+			if (!aWait)
+				return false;
+			Thread::sleep(i < 64 ? 0 : 1);
+		}
+
+		pool->mLate = 0;
+		pool->mParallel = 0;
+
+		for (i = 0; i < (unsigned int)Thread::atomicLoad(&pool->mEndedVoiceCount); i++)
+		{
+			stopVoice(pool->mEndedVoice[i]);
+		}
+		pool->mEndedVoiceCount = 0;
+		return true;
+	}
+
+	void Soloud::mixBusParallel(float *aBuffer, unsigned int aSamples, float *aScratch, float aSamplerate, unsigned int aChannels)
+	{
+		MixPool *pool = (MixPool *)mMixPool;
+		unsigned int i, j;
+		unsigned long long deadline = Thread::getTimeMicroseconds() + (unsigned long long)(aSamples * (10000.0f * MIX_DEADLINE_PERCENT) / aSamplerate);
+
+		pool->mVoiceCount = 0;
+		for (i = 0; i < mActiveVoiceCount; i++)
+		{
+			AudioSourceInstance *voice = mVoice[mActiveVoice[i]];
+			if (voice &&
+				voice->mBusHandle == 0 &&
+				!(voice->mFlags & AudioSourceInstance::PAUSED) &&
+				(!(voice->mFlags & AudioSourceInstance::INAUDIBLE) || (voice->mFlags & AudioSourceInstance::INAUDIBLE_TICK)))
+			{
+				pool->mVoiceList[pool->mVoiceCount++] = mActiveVoice[i];
+			}
+		}
+
+		// Not worth waking anyone for a single batch
+		if (pool->mVoiceCount <= MIX_VOICE_BATCH)
+		{
+			for (i = 0; i < pool->mVoiceCount; i++)
+			{
+				mixVoice(aBuffer, aSamples, aScratch, pool->mVoiceList[i], aSamplerate, aChannels);
+			}
+			return;
+		}
+
+		unsigned int batches = (pool->mVoiceCount + MIX_VOICE_BATCH - 1) / MIX_VOICE_BATCH;
+		unsigned int floats = aSamples * aChannels;
+
+		// Buffers only grow, and only here, while no batch is in flight.
+		if (pool->mBatchBufferSize < batches * floats)
+		{
+			pool->mBatchBufferSize = batches * floats;
+			pool->mBatchBuffer.init(pool->mBatchBufferSize);
+		}
+		if (pool->mScratchSize != mScratchSize)
+		{
+			pool->mScratchSize = mScratchSize;
+			pool->mScratch.init(mScratchSize * MAX_CHANNELS * pool->mThreadCount);
+		}
+
+		pool->mSamples = aSamples;
+		pool->mChannels = aChannels;
+		pool->mSamplerate = aSamplerate;
+		pool->mBatchCount = batches;
+		pool->mBatchesDone = 0;
+		for (i = 0; i < batches; i++)
+		{
+			pool->mBatchDone[i] = 0;
+		}
+		pool->mEndedVoiceCount = 0;
+		pool->mParallel = 1;
+
+		// Publish the batches
+		int state = Thread::atomicLoad(&pool->mBatchState);
+		while (Thread::atomicCompareExchange(&pool->mBatchState, batches << 16, state) != state)
+		{
+			state = Thread::atomicLoad(&pool->mBatchState);
+		}
+
+		unsigned int wake = batches - 1 < pool->mThreadCount ? batches - 1 : pool->mThreadCount;
+		for (i = 0; i < wake; i++)
+		{
+			Thread::postSemaphore(pool->mWakeSemaphore);
+		}
+
+		// Mix every batch no worker has claimed, then wait for the ones being mixed by workers, up to the deadline.
+		unsigned int batch;
+		for (i = 0; Thread::atomicLoad(&pool->mBatchesDone) != (int)batches; i++)
+		{
+			if (claimMixBatch(pool, batch))
+			{
+				mixBatch(pool, batch, aScratch);
+			}
+			else if (Thread::getTimeMicroseconds() > deadline)
+			{
+				break;
+			}
+			else if ((i & 63) == 63)
+			{
+				Thread::sleep(0);
+			}
+		}
+
+		// Deterministic reduction, independent of which thread mixed what. Batches a worker is still
+		// mixing are left out of this buffer.
+		bool late = false;
+		for (i = 0; i < batches; i++)
+		{
+			if (!Thread::atomicLoad(&pool->mBatchDone[i]))
+			{
+				late = true;
+				continue;
+			}
+			float *buffer = pool->mBatchBuffer.mData + i * floats;
+			for (j = 0; j < floats; j++)
+			{
+				aBuffer[j] += buffer[j];
+			}
+		}
+
+		if (late)
+		{
+			pool->mLate = 1;
+			mMixDeadlineMissCount++;
+			return;
+		}
+
+		finishMixJob(false);
 	}
 
 	void Soloud::mixBus(float *aBuffer, unsigned int aSamples, float *aScratch, unsigned int aBus, float aSamplerate, unsigned int aChannels)
@@ -777,486 +1067,342 @@ namespace SoLoud
 			aBuffer[i] = 0;
 		}
 
+		// The main bus may fan out to the mixing workers. Busses nested in it are mixed by whoever mixes the bus voice.
+		if (mMixPool && aBus == 0)
+		{
+			mixBusParallel(aBuffer, aSamples, aScratch, aSamplerate, aChannels);
+			return;
+		}
+
 		// Accumulate sound sources		
 		for (i = 0; i < mActiveVoiceCount; i++)
 		{
 			AudioSourceInstance *voice = mVoice[mActiveVoice[i]];
 			if (voice &&
 				voice->mBusHandle == aBus &&
-				!(voice->mFlags & AudioSourceInstance::PAUSED) &&
-				!(voice->mFlags & AudioSourceInstance::INAUDIBLE))
+				!(voice->mFlags & AudioSourceInstance::PAUSED))
 			{
-				unsigned int j, k;
-				float step = voice->mSamplerate / aSamplerate;
-				// avoid step overflow
-				if (step > (1 << (32 - FIXPOINT_FRAC_BITS)))
-					step = 0;
-				unsigned int step_fixed = (int)floor(step * FIXPOINT_FRAC_MUL);
-				unsigned int outofs = 0;
-			
-				if (voice->mDelaySamples)
-				{
-					if (voice->mDelaySamples > aSamples)
-					{
-						outofs = aSamples;
-						voice->mDelaySamples -= aSamples;
-					}
-					else
-					{
-						outofs = voice->mDelaySamples;
-						voice->mDelaySamples = 0;
-					}
-					
-					// Clear scratch where we're skipping
-					for (j = 0; j < voice->mChannels; j++)
-					{
-						memset(aScratch + j * aSamples, 0, sizeof(float) * outofs); 
-					}
-				}												
-
-				while (step_fixed != 0 && outofs < aSamples)
-				{
-					if (voice->mLeftoverSamples == 0)
-					{
-						// Swap resample buffers (ping-pong)
-						AudioSourceResampleData * t = voice->mResampleData[0];
-						voice->mResampleData[0] = voice->mResampleData[1];
-						voice->mResampleData[1] = t;
+				mixVoice(aBuffer, aSamples, aScratch, mActiveVoice[i], aSamplerate, aChannels);
+			}
+		}
+	}
 
-						// Get a block of source data
+	// Speaker mapping for mixing a voice into a bus: bus channel mDst += voice channel mSrc * mGain,
+	// ramped by the bus channel volume unless mFixed.
+	struct PanTerm
+	{
+		unsigned char mDst, mSrc, mFixed;
+		float mGain;
+	};
 
-						if (voice->hasEnded())
-						{
-							memset(voice->mResampleData[0]->mBuffer, 0, sizeof(float) * SAMPLE_GRANULARITY * voice->mChannels);
-						}
-						else
-						{
-							voice->getAudio(voice->mResampleData[0]->mBuffer, SAMPLE_GRANULARITY);
-						}
+	struct PanMap
+	{
+		unsigned int mBusChannels, mVoiceChannels, mTermCount;
+		PanTerm mTerm[10];
+	};
 
-						
-						
+	static const PanMap gPanMap[] =
+	{
+		// 6->2, just sum lefties and righties, add a bit of center, ignore sub?
+		{ 2, 6, 6, { { 0, 0, 0, 0.3f }, { 0, 2, 0, 0.3f }, { 0, 4, 0, 0.3f }, { 1, 1, 0, 0.3f }, { 1, 2, 0, 0.3f }, { 1, 5, 0, 0.3f } } },
+		// 4->2, just sum lefties and righties
+		{ 2, 4, 4, { { 0, 0, 0, 0.5f }, { 0, 2, 0, 0.5f }, { 1, 1, 0, 0.5f }, { 1, 3, 0, 0.5f } } },
+		// 2->2
+		{ 2, 2, 2, { { 0, 0, 0, 1 }, { 1, 1, 0, 1 } } },
+		// 1->2
+		{ 2, 1, 2, { { 0, 0, 0, 1 }, { 1, 0, 0, 1 } } },
+		// 6->4, add a bit of center, ignore sub?
+		{ 4, 6, 6, { { 0, 0, 0, 1 }, { 1, 1, 0, 1 }, { 2, 4, 0, 1 }, { 3, 5, 0, 1 }, { 0, 2, 1, 0.7f }, { 1, 2, 1, 0.7f } } },
+		// 4->4
+		{ 4, 4, 4, { { 0, 0, 0, 1 }, { 1, 1, 0, 1 }, { 2, 2, 0, 1 }, { 3, 3, 0, 1 } } },
+		// 2->4
+		{ 4, 2, 4, { { 0, 0, 0, 1 }, { 1, 1, 0, 1 }, { 2, 0, 0, 1 }, { 3, 1, 0, 1 } } },
+		// 1->4
+		{ 4, 1, 4, { { 0, 0, 0, 1 }, { 1, 0, 0, 1 }, { 2, 0, 0, 1 }, { 3, 0, 0, 1 } } },
+		// 6->6
+		{ 6, 6, 6, { { 0, 0, 0, 1 }, { 1, 1, 0, 1 }, { 2, 2, 0, 1 }, { 3, 3, 0, 1 }, { 4, 4, 0, 1 }, { 5, 5, 0, 1 } } },
+		// 4->6
+		{ 6, 4, 10, { { 0, 0, 0, 1 }, { 1, 1, 0, 1 }, { 2, 0, 0, 0.5f }, { 2, 1, 0, 0.5f }, { 3, 0, 0, 0.25f }, { 3, 1, 0, 0.25f }, { 3, 2, 0, 0.25f }, { 3, 3, 0, 0.25f }, { 4, 2, 0, 1 }, { 5, 3, 0, 1 } } },
+		// 2->6
+		{ 6, 2, 8, { { 0, 0, 0, 1 }, { 1, 1, 0, 1 }, { 2, 0, 0, 0.5f }, { 2, 1, 0, 0.5f }, { 3, 0, 0, 0.5f }, { 3, 1, 0, 0.5f }, { 4, 0, 0, 1 }, { 5, 1, 0, 1 } } },
+		// 1->6
+		{ 6, 1, 6, { { 0, 0, 0, 1 }, { 1, 0, 0, 1 }, { 2, 0, 0, 1 }, { 3, 0, 0, 1 }, { 4, 0, 0, 1 }, { 5, 0, 0, 1 } } },
+	};
+
+	void Soloud::mixVoice(float *aBuffer, unsigned int aSamples, float *aScratch, unsigned int aVoice, float aSamplerate, unsigned int aChannels)
+	{
+		AudioSourceInstance *voice = mVoice[aVoice];
+		if (!(voice->mFlags & AudioSourceInstance::INAUDIBLE))
+		{
+			unsigned int j, k;
+			float step = voice->mSamplerate / aSamplerate;
+			// avoid step overflow
+			if (step > (1 << (32 - FIXPOINT_FRAC_BITS)))
+				step = 0;
+			unsigned int step_fixed = (int)floor(step * FIXPOINT_FRAC_MUL);
+			unsigned int outofs = 0;
+		
+			if (voice->mDelaySamples)
+			{
+				if (voice->mDelaySamples > aSamples)
+				{
+					outofs = aSamples;
+					voice->mDelaySamples -= aSamples;
+				}
+				else
+				{
+					outofs = voice->mDelaySamples;
+					voice->mDelaySamples = 0;
+				}
+				
+				// Clear scratch where we're skipping
+				for (j = 0; j < voice->mChannels; j++)
+				{
+					memset(aScratch + j * aSamples, 0, sizeof(float) * outofs); 
+				}
+			}												
 
-						// If we go past zero, crop to zero (a bit of a kludge)
-						if (voice->mSrcOffset < SAMPLE_GRANULARITY * FIXPOINT_FRAC_MUL)
-						{
-							voice->mSrcOffset = 0;
-						}
-						else
-						{
-							// We have new block of data, move pointer backwards
-							voice->mSrcOffset -= SAMPLE_GRANULARITY * FIXPOINT_FRAC_MUL;
-						}
+			while (step_fixed != 0 && outofs < aSamples)
+			{
+				if (voice->mLeftoverSamples == 0)
+				{
+					// Swap resample buffers (ping-pong)
+					AudioSourceResampleData * t = voice->mResampleData[0];
+					voice->mResampleData[0] = voice->mResampleData[1];
+					voice->mResampleData[1] = t;
 
-					
-						// Run the per-stream filters to get our source data
+					// Get a block of source data
 
-						for (j = 0; j < FILTERS_PER_STREAM; j++)
-						{
-							if (voice->mFilter[j])
-							{
-								voice->mFilter[j]->filter(
-									voice->mResampleData[0]->mBuffer,
-									SAMPLE_GRANULARITY, 
-									voice->mChannels,
-									voice->mSamplerate,
-									mStreamTime);
-							}
-						}
+					if (voice->hasEnded())
+					{
+						memset(voice->mResampleData[0]->mBuffer, 0, sizeof(float) * SAMPLE_GRANULARITY * voice->mChannels);
 					}
 					else
 					{
-						voice->mLeftoverSamples = 0;
+						voice->getAudio(voice->mResampleData[0]->mBuffer, SAMPLE_GRANULARITY);
 					}
 
-					// Figure out how many samples we can generate from this source data.
-					// The value may be zero.
-
-					unsigned int writesamples = 0;
+					
+					
 
+					// If we go past zero, crop to zero (a bit of a kludge)
 					if (voice->mSrcOffset < SAMPLE_GRANULARITY * FIXPOINT_FRAC_MUL)
 					{
-						writesamples = ((SAMPLE_GRANULARITY * FIXPOINT_FRAC_MUL) - voice->mSrcOffset) / step_fixed + 1;
-
-						// avoid reading past the current buffer..
-						if (((writesamples * step_fixed + voice->mSrcOffset) >> FIXPOINT_FRAC_BITS) >= SAMPLE_GRANULARITY)
-							writesamples--;
+						voice->mSrcOffset = 0;
 					}
-
-
-					// If this is too much for our output buffer, don't write that many:
-					if (writesamples + outofs > aSamples)
+					else
 					{
-						voice->mLeftoverSamples = (writesamples + outofs) - aSamples;
-						writesamples = aSamples - outofs;
+						// We have new block of data, move pointer backwards
+						voice->mSrcOffset -= SAMPLE_GRANULARITY * FIXPOINT_FRAC_MUL;
 					}
 
-					// Call resampler to generate the samples, once per channel
-					if (writesamples)
+				
+					// Run the per-stream filters to get our source data
+
+					for (j = 0; j < FILTERS_PER_STREAM; j++)
 					{
-						for (j = 0; j < voice->mChannels; j++)
+						if (voice->mFilter[j])
 						{
-							resample(voice->mResampleData[0]->mBuffer + SAMPLE_GRANULARITY * j,
-								voice->mResampleData[1]->mBuffer + SAMPLE_GRANULARITY * j,
-									 aScratch + aSamples * j + outofs, 
-									 voice->mSrcOffset,
-									 writesamples,
-									 voice->mSamplerate,
-									 aSamplerate,
-									 step_fixed);
+							voice->mFilter[j]->filter(
+								voice->mResampleData[0]->mBuffer,
+								SAMPLE_GRANULARITY, 
+								voice->mChannels,
+								voice->mSamplerate,
+								mStreamTime);
 						}
 					}
+				}
+				else
+				{
+					voice->mLeftoverSamples = 0;
+				}
+
+				// Figure out how many samples we can generate from this source data.
+				// The value may be zero.
 
-					// Keep track of how many samples we've written so far
-					outofs += writesamples;
+				unsigned int writesamples = 0;
 
-					// Move source pointer onwards (writesamples may be zero)
-					voice->mSrcOffset += writesamples * step_fixed;
+				if (voice->mSrcOffset < SAMPLE_GRANULARITY * FIXPOINT_FRAC_MUL)
+				{
+					writesamples = ((SAMPLE_GRANULARITY * FIXPOINT_FRAC_MUL) - voice->mSrcOffset) / step_fixed + 1;
+
+					// avoid reading past the current buffer..
+					if (((writesamples * step_fixed + voice->mSrcOffset) >> FIXPOINT_FRAC_BITS) >= SAMPLE_GRANULARITY)
+						writesamples--;
 				}
-				
-				float pan[MAX_CHANNELS]; // current speaker volume
-				float pand[MAX_CHANNELS]; // destination speaker volume
-				float pani[MAX_CHANNELS]; // speaker volume increment per sample
-				for (k = 0; k < aChannels; k++)
+
+
+				// If this is too much for our output buffer, don't write that many:
+				if (writesamples + outofs > aSamples)
 				{
-					pan[k] = voice->mCurrentChannelVolume[k];
-					pand[k] = voice->mChannelVolume[k] * voice->mOverallVolume;
-					pani[k] = (pand[k] - pan[k]) / aSamples;
+					voice->mLeftoverSamples = (writesamples + outofs) - aSamples;
+					writesamples = aSamples - outofs;
 				}
 
-				int ofs = 0;
-				switch (aChannels)
+				// Call resampler to generate the samples, once per channel
+				if (writesamples)
 				{
-				case 1: // Target is mono. Sum everything. (1->1, 2->1, 4->1, 6->1)
-					for (j = 0, ofs = 0; j < voice->mChannels; j++, ofs += aSamples)
-					{
-						pan[0] = voice->mCurrentChannelVolume[0];
-						for (k = 0; k < aSamples; k++)
-						{
-							pan[0] += pani[0];
-							aBuffer[k] += aScratch[ofs + k] * pan[0];
-						}
-					}
-					break;
-				case 2:
-					switch (voice->mChannels)
-					{
-					case 6: // 6->2, just sum lefties and righties, add a bit of center, ignore sub?
-						for (j = 0; j < aSamples; j++)
-						{
-							pan[0] += pani[0];
-							pan[1] += pani[1];
-							float s1 = aScratch[j];
-							float s2 = aScratch[aSamples + j];
-							float s3 = aScratch[aSamples * 2 + j];
-							//float s4 = aScratch[aSamples * 3 + j];
-							float s5 = aScratch[aSamples * 4 + j];
-							float s6 = aScratch[aSamples * 5 + j];
-							aBuffer[j + 0] += 0.3f * (s1 + s3 + s5) * pan[0];
-							aBuffer[j + aSamples] += 0.3f * (s2 + s3 + s6) * pan[1];
-						}
-						break;
-					case 4: // 4->2, just sum lefties and righties
-						for (j = 0; j < aSamples; j++)
-						{
-							pan[0] += pani[0];
-							pan[1] += pani[1];
-							float s1 = aScratch[j];
-							float s2 = aScratch[aSamples + j];
-							float s3 = aScratch[aSamples * 2 + j];
-							float s4 = aScratch[aSamples * 3 + j];
-							aBuffer[j + 0] += 0.5f * (s1 + s3) * pan[0];
-							aBuffer[j + aSamples] += 0.5f * (s2 + s4) * pan[1];
-						}
-						break;
-					case 2: // 2->2
-						for (j = 0; j < aSamples; j++)
-						{
-							pan[0] += pani[0];
-							pan[1] += pani[1];
-							float s1 = aScratch[j];
-							float s2 = aScratch[aSamples + j];
-							aBuffer[j + 0] += s1 * pan[0];
-							aBuffer[j + aSamples] += s2 * pan[1];
-						}
-						break;
-					case 1: // 1->2
-						for (j = 0; j < aSamples; j++)
-						{
-							pan[0] += pani[0];
-							pan[1] += pani[1];
-							float s = aScratch[j];
-							aBuffer[j + 0] += s * pan[0];
-							aBuffer[j + aSamples] += s * pan[1];
-						}
-						break;
-					}
-					break;
-				case 4:
-					switch (voice->mChannels)
+					for (j = 0; j < voice->mChannels; j++)
 					{
-					case 6: // 6->4, add a bit of center, ignore sub?
-						for (j = 0; j < aSamples; j++)
-						{
-							pan[0] += pani[0];
-							pan[1] += pani[1];
-							pan[2] += pani[2];
-							pan[3] += pani[3];
-							float s1 = aScratch[j];
-							float s2 = aScratch[aSamples + j];
-							float s3 = aScratch[aSamples * 2 + j];
-							//float s4 = aScratch[aSamples * 3 + j];
-							float s5 = aScratch[aSamples * 4 + j];
-							float s6 = aScratch[aSamples * 5 + j];
-							float c = s3 * 0.7f;
-							aBuffer[j + 0] += s1 * pan[0] + c;
-							aBuffer[j + aSamples] += s2 * pan[1] + c;
-							aBuffer[j + aSamples * 2] += s5 * pan[2];
-							aBuffer[j + aSamples * 3] += s6 * pan[3];
-						}
-						break;
-					case 4: // 4->4
-						for (j = 0; j < aSamples; j++)
-						{
-							pan[0] += pani[0];
-							pan[1] += pani[1];
-							pan[2] += pani[2];
-							pan[3] += pani[3];
-							float s1 = aScratch[j];
-							float s2 = aScratch[aSamples + j];
-							float s3 = aScratch[aSamples * 2 + j];
-							float s4 = aScratch[aSamples * 3 + j];
-							aBuffer[j + 0] += s1 * pan[0];
-							aBuffer[j + aSamples] += s2 * pan[1];
-							aBuffer[j + aSamples * 2] += s3 * pan[2];
-							aBuffer[j + aSamples * 3] += s4 * pan[3];
-						}
-						break;
-					case 2: // 2->4
-						for (j = 0; j < aSamples; j++)
-						{
-							pan[0] += pani[0];
-							pan[1] += pani[1];
-							pan[2] += pani[2];
-							pan[3] += pani[3];
-							float s1 = aScratch[j];
-							float s2 = aScratch[aSamples + j];
-							aBuffer[j + 0] += s1 * pan[0];
-							aBuffer[j + aSamples] += s2 * pan[1];
-							aBuffer[j + aSamples * 2] += s1 * pan[2];
-							aBuffer[j + aSamples * 3] += s2 * pan[3];
-						}
-						break;
-					case 1: // 1->4
-						for (j = 0; j < aSamples; j++)
-						{
-							pan[0] += pani[0];
-							pan[1] += pani[1];
-							pan[2] += pani[2];
-							pan[3] += pani[3];
-							float s = aScratch[j];
-							aBuffer[j + 0] += s * pan[0];
-							aBuffer[j + aSamples] += s * pan[1];
-							aBuffer[j + aSamples * 2] += s * pan[2];
-							aBuffer[j + aSamples * 3] += s * pan[3];
-						}
-						break;
+						resample(voice->mResampler,
+							voice->mResampleData[0]->mBuffer + SAMPLE_GRANULARITY * j,
+							voice->mResampleData[1]->mBuffer + SAMPLE_GRANULARITY * j,
+							aScratch + aSamples * j + outofs,
+							voice->mSrcOffset,
+							writesamples,
+							step_fixed);
 					}
-					break;
-				case 6:
-					switch (voice->mChannels)
+				}
+
+				// Keep track of how many samples we've written so far
+				outofs += writesamples;
+
+				// Move source pointer onwards (writesamples may be zero)
+				voice->mSrcOffset += writesamples * step_fixed;
+			}
+			
+			float pan[MAX_CHANNELS]; // current speaker volume
+			float pand[MAX_CHANNELS]; // destination speaker volume
+			float pani[MAX_CHANNELS]; // speaker volume increment per sample
+			for (k = 0; k < aChannels; k++)
+			{
+				pan[k] = voice->mCurrentChannelVolume[k];
+				pand[k] = voice->mChannelVolume[k] * voice->mOverallVolume;
+				pani[k] = (pand[k] - pan[k]) / aSamples;
+			}
+
+			if (aChannels == 1)
+			{
+				// Target is mono. Sum everything. (1->1, 2->1, 4->1, 6->1)
+				for (j = 0; j < voice->mChannels; j++)
+				{
+					panAccumulate(aBuffer, aScratch + aSamples * j, aSamples, pan[0], pani[0]);
+				}
+			}
+			else
+			{
+				for (j = 0; j < sizeof(gPanMap) / sizeof(gPanMap[0]); j++)
+				{
+					const PanMap &map = gPanMap[j];
+					if (map.mBusChannels != aChannels || map.mVoiceChannels != voice->mChannels)
+						continue;
+					for (k = 0; k < map.mTermCount; k++)
 					{
-					case 6: // 6->6
-						for (j = 0; j < aSamples; j++)
-						{
-							pan[0] += pani[0];
-							pan[1] += pani[1];
-							pan[2] += pani[2];
-							pan[3] += pani[3];
-							pan[4] += pani[4];
-							pan[5] += pani[5];
-							float s1 = aScratch[j];
-							float s2 = aScratch[aSamples + j];
-							float s3 = aScratch[aSamples * 2 + j];
-							float s4 = aScratch[aSamples * 3 + j];
-							float s5 = aScratch[aSamples * 4 + j];
-							float s6 = aScratch[aSamples * 5 + j];
-							aBuffer[j + 0] += s1 * pan[0];
-							aBuffer[j + aSamples] += s2 * pan[1];
-							aBuffer[j + aSamples * 2] += s3 * pan[2];
-							aBuffer[j + aSamples * 3] += s4 * pan[3];
-							aBuffer[j + aSamples * 4] += s5 * pan[4];
-							aBuffer[j + aSamples * 5] += s6 * pan[5];
-						}
-						break;
-					case 4: // 4->6
-						for (j = 0; j < aSamples; j++)
-						{
-							pan[0] += pani[0];
-							pan[1] += pani[1];
-							pan[2] += pani[2];
-							pan[3] += pani[3];
-							pan[4] += pani[4];
-							pan[5] += pani[5];
-							float s1 = aScratch[j];
-							float s2 = aScratch[aSamples + j];
-							float s3 = aScratch[aSamples * 2 + j];
-							float s4 = aScratch[aSamples * 3 + j];
-							aBuffer[j + 0] += s1 * pan[0];
-							aBuffer[j + aSamples] += s2 * pan[1];
-							aBuffer[j + aSamples * 2] += 0.5f * (s1 + s2) * pan[2];
-							aBuffer[j + aSamples * 3] += 0.25f * (s1 + s2 + s3 + s4) * pan[3];
-							aBuffer[j + aSamples * 4] += s3 * pan[4];
-							aBuffer[j + aSamples * 5] += s4 * pan[5];
-						}
-						break;
-					case 2: // 2->6
-						for (j = 0; j < aSamples; j++)
+						const PanTerm &t = map.mTerm[k];
+						if (t.mFixed)
 						{
-							pan[0] += pani[0];
-							pan[1] += pani[1];
-							pan[2] += pani[2];
-							pan[3] += pani[3];
-							pan[4] += pani[4];
-							pan[5] += pani[5];
-							float s1 = aScratch[j];
-							float s2 = aScratch[aSamples + j];
-							aBuffer[j + 0] += s1 * pan[0];
-							aBuffer[j + aSamples] += s2 * pan[1];
-							aBuffer[j + aSamples * 2] += 0.5f * (s1 + s2) * pan[2];
-							aBuffer[j + aSamples * 3] += 0.5f * (s1 + s2) * pan[3];
-							aBuffer[j + aSamples * 4] += s1 * pan[4];
-							aBuffer[j + aSamples * 5] += s2 * pan[5];
+							panAccumulate(aBuffer + aSamples * t.mDst, aScratch + aSamples * t.mSrc, aSamples, t.mGain, 0);
 						}
-						break;
-					case 1: // 1->6
-						for (j = 0; j < aSamples; j++)
+						else
 						{
-							pan[0] += pani[0];
-							pan[1] += pani[1];
-							pan[2] += pani[2];
-							pan[3] += pani[3];
-							pan[4] += pani[4];
-							pan[5] += pani[5];
-							float s = aScratch[j];
-							aBuffer[j + 0] += s * pan[0];
-							aBuffer[j + aSamples] += s * pan[1];
-							aBuffer[j + aSamples * 2] += s * pan[2];
-							aBuffer[j + aSamples * 3] += s * pan[3];
-							aBuffer[j + aSamples * 4] += s * pan[4];
-							aBuffer[j + aSamples * 5] += s * pan[5];
+							panAccumulate(aBuffer + aSamples * t.mDst, aScratch + aSamples * t.mSrc, aSamples, pan[t.mDst] * t.mGain, pani[t.mDst] * t.mGain);
 						}
-						break;
 					}
 					break;
 				}
-				
-				for (k = 0; k < aChannels; k++)
-					voice->mCurrentChannelVolume[k] = pand[k];
-
-				// clear voice if the sound is over
-				if (!(voice->mFlags & AudioSourceInstance::LOOPING) && voice->hasEnded())
-				{
-					stopVoice(mActiveVoice[i]);
-				}
 			}
-			else
-				if (voice &&
-					voice->mBusHandle == aBus &&
-					!(voice->mFlags & AudioSourceInstance::PAUSED) &&
-					(voice->mFlags & AudioSourceInstance::INAUDIBLE) &&
-					(voice->mFlags & AudioSourceInstance::INAUDIBLE_TICK))
+			
+			for (k = 0; k < aChannels; k++)
+				voice->mCurrentChannelVolume[k] = pand[k];
+
+			// clear voice if the sound is over
+			if (!(voice->mFlags & AudioSourceInstance::LOOPING) && voice->hasEnded())
 			{
-				// Inaudible but needs ticking. Do minimal work (keep counters up to date and ask audiosource for data)
-				float step = voice->mSamplerate / aSamplerate;
-				int step_fixed = (int)floor(step * FIXPOINT_FRAC_MUL);
-				unsigned int outofs = 0;
+				endVoice(aVoice);
+			}
+		}
+		else
+			if (voice->mFlags & AudioSourceInstance::INAUDIBLE_TICK)
+		{
+			// Inaudible but needs ticking. Do minimal work (keep counters up to date and ask audiosource for data)
+			float step = voice->mSamplerate / aSamplerate;
+			int step_fixed = (int)floor(step * FIXPOINT_FRAC_MUL);
+			unsigned int outofs = 0;
 
-				if (voice->mDelaySamples)
+			if (voice->mDelaySamples)
+			{
+				if (voice->mDelaySamples > aSamples)
 				{
-					if (voice->mDelaySamples > aSamples)
-					{
-						outofs = aSamples;
-						voice->mDelaySamples -= aSamples;
-					}
-					else
-					{
-						outofs = voice->mDelaySamples;
-						voice->mDelaySamples = 0;
-					}
+					outofs = aSamples;
+					voice->mDelaySamples -= aSamples;
 				}
-
-				while (step_fixed != 0 && outofs < aSamples)
+				else
 				{
-					if (voice->mLeftoverSamples == 0)
-					{
-						// Swap resample buffers (ping-pong)
-						AudioSourceResampleData * t = voice->mResampleData[0];
-						voice->mResampleData[0] = voice->mResampleData[1];
-						voice->mResampleData[1] = t;
-
-						// Get a block of source data
+					outofs = voice->mDelaySamples;
+					voice->mDelaySamples = 0;
+				}
+			}
 
-						if (!voice->hasEnded())
-						{
-							voice->getAudio(voice->mResampleData[0]->mBuffer, SAMPLE_GRANULARITY);
-						}
+			while (step_fixed != 0 && outofs < aSamples)
+			{
+				if (voice->mLeftoverSamples == 0)
+				{
+					// Swap resample buffers (ping-pong)
+					AudioSourceResampleData * t = voice->mResampleData[0];
+					voice->mResampleData[0] = voice->mResampleData[1];
+					voice->mResampleData[1] = t;
 
+					// Get a block of source data
 
-						// If we go past zero, crop to zero (a bit of a kludge)
-						if (voice->mSrcOffset < SAMPLE_GRANULARITY * FIXPOINT_FRAC_MUL)
-						{
-							voice->mSrcOffset = 0;
-						}
-						else
-						{
-							// We have new block of data, move pointer backwards
-							voice->mSrcOffset -= SAMPLE_GRANULARITY * FIXPOINT_FRAC_MUL;
-						}
-
-						// Skip filters
-					}
-					else
+					if (!voice->hasEnded())
 					{
-						voice->mLeftoverSamples = 0;
+						voice->getAudio(voice->mResampleData[0]->mBuffer, SAMPLE_GRANULARITY);
 					}
 
-					// Figure out how many samples we can generate from this source data.
-					// The value may be zero.
-
-					unsigned int writesamples = 0;
 
+					// If we go past zero, crop to zero (a bit of a kludge)
 					if (voice->mSrcOffset < SAMPLE_GRANULARITY * FIXPOINT_FRAC_MUL)
 					{
-						writesamples = ((SAMPLE_GRANULARITY * FIXPOINT_FRAC_MUL) - voice->mSrcOffset) / step_fixed + 1;
-
-						// avoid reading past the current buffer..
-						if (((writesamples * step_fixed + voice->mSrcOffset) >> FIXPOINT_FRAC_BITS) >= SAMPLE_GRANULARITY)
-							writesamples--;
+						voice->mSrcOffset = 0;
 					}
-
-
-					// If this is too much for our output buffer, don't write that many:
-					if (writesamples + outofs > aSamples)
+					else
 					{
-						voice->mLeftoverSamples = (writesamples + outofs) - aSamples;
-						writesamples = aSamples - outofs;
+						// We have new block of data, move pointer backwards
+						voice->mSrcOffset -= SAMPLE_GRANULARITY * FIXPOINT_FRAC_MUL;
 					}
 
-					// Skip resampler
+					// Skip filters
+				}
+				else
+				{
+					voice->mLeftoverSamples = 0;
+				}
 
-					// Keep track of how many samples we've written so far
-					outofs += writesamples;
+				// Figure out how many samples we can generate from this source data.
+				// The value may be zero.
 
-					// Move source pointer onwards (writesamples may be zero)
-					voice->mSrcOffset += writesamples * step_fixed;
+				unsigned int writesamples = 0;
+
+				if (voice->mSrcOffset < SAMPLE_GRANULARITY * FIXPOINT_FRAC_MUL)
+				{
+					writesamples = ((SAMPLE_GRANULARITY * FIXPOINT_FRAC_MUL) - voice->mSrcOffset) / step_fixed + 1;
+
+					// avoid reading past the current buffer..
+					if (((writesamples * step_fixed + voice->mSrcOffset) >> FIXPOINT_FRAC_BITS) >= SAMPLE_GRANULARITY)
+						writesamples--;
 				}
 
-				// clear voice if the sound is over
-				if (!(voice->mFlags & AudioSourceInstance::LOOPING) && voice->hasEnded())
+
+				// If this is too much for our output buffer, don't write that many:
+				if (writesamples + outofs > aSamples)
 				{
-					stopVoice(mActiveVoice[i]);
+					voice->mLeftoverSamples = (writesamples + outofs) - aSamples;
+					writesamples = aSamples - outofs;
 				}
+
+				// Skip resampler
+
+				// Keep track of how many samples we've written so far
+				outofs += writesamples;
+
+				// Move source pointer onwards (writesamples may be zero)
+				voice->mSrcOffset += writesamples * step_fixed;
+			}
+
+			// clear voice if the sound is over
+			if (!(voice->mFlags & AudioSourceInstance::LOOPING) && voice->hasEnded())
+			{
+				endVoice(aVoice);
 			}
 		}
 	}
@@ -1374,10 +1520,25 @@ namespace SoLoud
 		}
 		globalVolume[1] = mGlobalVolume;
 
-		lockAudioMutex();
+		if (mAudioThreadMutex)
+			Thread::lockMutex(mAudioThreadMutex);
 
-		// Process faders. May change scratch size.
 		int i;
+
+		// A worker that missed the previous mixing deadline still owns some voices. Rather than wait for it,
+		// leave this buffer silent; no voice advances until the worker is done.
+		if (mMixPool && ((MixPool *)mMixPool)->mLate && !finishMixJob(false))
+		{
+			mMixDeadlineMissCount++;
+			unlockAudioMutex();
+			for (i = 0; i < (signed)(aSamples * mChannels); i++)
+			{
+				mScratch.mData[i] = 0;
+			}
+			return;
+		}
+
+		// Process faders. May change scratch size.
 		for (i = 0; i < (signed)mHighestVoice; i++)
 		{
 			if (mVoice[i] && !(mVoice[i]->mFlags & AudioSourceInstance::PAUSED))
@@ -1552,7 +1713,12 @@ namespace SoLoud
 	void Soloud::lockAudioMutex()
 	{
 		if (mAudioThreadMutex)
+		{
 			Thread::lockMutex(mAudioThreadMutex);
+			// Voices a late mixing worker is still processing must not change under it
+			if (mMixPool && ((MixPool *)mMixPool)->mLate)
+				finishMixJob(true);
+		}
 	}
 
 	void Soloud::unlockAudioMutex()
@@ -24,6 +24,12 @@ freely, subject to the following restrictions:
 
 #include "soloud.h"
 
+#ifdef RESAMPLER_LINEAR
+#define DEFAULT_RESAMPLER Soloud::RESAMPLE_LINEAR
+#else
+#define DEFAULT_RESAMPLER Soloud::RESAMPLE_POINT
+#endif
+
 namespace SoLoud
 {
 
@@ -102,6 +108,7 @@ namespace SoLoud
 		mSrcOffset = 0;
 		mLeftoverSamples = 0;
 		mDelaySamples = 0;
+		mResampler = DEFAULT_RESAMPLER;
 
 	}
 
@@ -123,6 +130,7 @@ namespace SoLoud
 		mSamplerate = mBaseSamplerate;
 		mChannels = aSource.mChannels;
 		mStreamTime = 0.0f;
+		mResampler = aSource.mResampler;
 
 		if (aSource.mFlags & AudioSource::SHOULD_LOOP)
 		{
@@ -199,6 +207,7 @@ namespace SoLoud
 		mAttenuator = 0;
 		mColliderData = 0;
 		mVolume = 1;
+		mResampler = DEFAULT_RESAMPLER;
 	}
 
 	AudioSource::~AudioSource() 
@@ -328,6 +337,11 @@ namespace SoLoud
 		}
 	}
 
+	void AudioSource::setResampler(unsigned int aResampler)
+	{
+		mResampler = aResampler;
+	}
+
 
 	float AudioSourceInstance::getInfo(unsigned int aInfoKey)
 	{
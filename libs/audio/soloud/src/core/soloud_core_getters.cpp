@@ -76,6 +76,16 @@ namespace SoLoud
 		return mMaxActiveVoices;
 	}
 
+	unsigned int Soloud::getMixThreadCount() const
+	{
+		return mMixThreadCount;
+	}
+
+	unsigned int Soloud::getMixDeadlineMissCount() const
+	{
+		return mMixDeadlineMissCount;
+	}
+
 	unsigned int Soloud::getActiveVoiceCount()
 	{
 		lockAudioMutex();
@@ -131,6 +141,20 @@ namespace SoLoud
 		return v;
 	}
 
+	unsigned int Soloud::getResampler(handle aVoiceHandle)
+	{
+		lockAudioMutex();
+		int ch = getVoiceFromHandle(aVoiceHandle);
+		if (ch == -1)
+		{
+			unlockAudioMutex();
+			return 0;
+		}
+		unsigned int v = mVoice[ch]->mResampler;
+		unlockAudioMutex();
+		return v;
+	}
+
 	float Soloud::getInfo(handle aVoiceHandle, unsigned int mInfoKey)
 	{
 		lockAudioMutex();
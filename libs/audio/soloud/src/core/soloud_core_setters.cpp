@@ -142,6 +142,17 @@ namespace SoLoud
 		FOR_ALL_VOICES_POST
 	}
 
+	result Soloud::setResampler(handle aVoiceHandle, unsigned int aResampler)
+	{
+		if (aResampler > RESAMPLE_SINC)
+			return INVALID_PARAMETER;
+
+		FOR_ALL_VOICES_PRE
+			mVoice[ch]->mResampler = aResampler;
+		FOR_ALL_VOICES_POST
+		return SO_NO_ERROR;
+	}
+
 	void Soloud::setLooping(handle aVoiceHandle, bool aLooping)
 	{
 		FOR_ALL_VOICES_PRE
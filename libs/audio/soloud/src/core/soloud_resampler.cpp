@@ -0,0 +1,249 @@
+/*
+SoLoud audio engine
+Copyright (c) 2013-2015 Jari Komppa
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+*/
+
+#include <string.h>
+#include <math.h>
+#include "soloud_internal.h"
+
+#ifdef SOLOUD_SSE_INTRINSICS
+#include <xmmintrin.h>
+#endif
+#ifdef SOLOUD_AVX_INTRINSICS
+#include <immintrin.h>
+#endif
+
+// Windowed sinc kernel: 8 taps, SINC_PHASES fractional positions (interpolated linearly in between)
+#define SINC_TAPS 8
+#define SINC_PHASE_BITS 7
+#define SINC_PHASES (1 << SINC_PHASE_BITS)
+#define SINC_PHASE_SHIFT (FIXPOINT_FRAC_BITS - SINC_PHASE_BITS)
+// Cutoff relative to the source nyquist; a bit below 1 to keep images out of the pass band
+#define SINC_CUTOFF 0.9f
+
+namespace SoLoud
+{
+	// Kernel for each phase; phase n covers the output position p - 4 + n / SINC_PHASES, taps p - 7 .. p.
+	// The extra row lets phase SINC_PHASES - 1 interpolate towards the next full sample.
+	static float gSincTable[SINC_PHASES + 1][SINC_TAPS];
+
+	static struct SincTableInit
+	{
+		SincTableInit()
+		{
+			int i, j;
+			for (i = 0; i <= SINC_PHASES; i++)
+			{
+				float frac = i / (float)SINC_PHASES;
+				float sum = 0;
+				for (j = 0; j < SINC_TAPS; j++)
+				{
+					// Distance of tap j from the output position, in source samples
+					float t = 3 + frac - j;
+					float x = (float)M_PI * t * SINC_CUTOFF;
+					float sinc = fabs(x) < 1e-6f ? 1.0f : (float)sin(x) / x;
+					// Blackman window over -4..4
+					float w = t / (SINC_TAPS / 2);
+					float window = fabs(w) >= 1 ? 0 : 0.42f + 0.5f * (float)cos(M_PI * w) + 0.08f * (float)cos(2 * M_PI * w);
+					gSincTable[i][j] = sinc * window;
+					sum += gSincTable[i][j];
+				}
+				// Normalize for unity gain at DC
+				for (j = 0; j < SINC_TAPS; j++)
+				{
+					gSincTable[i][j] /= sum;
+				}
+			}
+		}
+	} gSincTableInit;
+
+	static void resamplePoint(float *aSrc, float *aDst, int aSrcOffset, int aDstSampleCount, int aStepFixed)
+	{
+		int i;
+		int pos = aSrcOffset;
+
+		if (aStepFixed == FIXPOINT_FRAC_MUL)
+		{
+			memcpy(aDst, aSrc + (pos >> FIXPOINT_FRAC_BITS), sizeof(float) * aDstSampleCount);
+			return;
+		}
+
+		for (i = 0; i < aDstSampleCount; i++, pos += aStepFixed)
+		{
+			int p = pos >> FIXPOINT_FRAC_BITS;
+			aDst[i] = aSrc[p];
+		}
+	}
+
+	static void resampleLinear(float *aSrc, float *aSrc1, float *aDst, int aSrcOffset, int aDstSampleCount, int aStepFixed)
+	{
+		int i = 0;
+		int pos = aSrcOffset;
+
+		// The first source sample interpolates from the end of the previous block
+		for (; i < aDstSampleCount && (pos >> FIXPOINT_FRAC_BITS) == 0; i++, pos += aStepFixed)
+		{
+			float s1 = aSrc1[SAMPLE_GRANULARITY - 1];
+			float s2 = aSrc[0];
+			aDst[i] = s1 + (s2 - s1) * (pos & FIXPOINT_FRAC_MASK) * (1 / (float)FIXPOINT_FRAC_MUL);
+		}
+
+#ifdef SOLOUD_SSE_INTRINSICS
+		if (aStepFixed == FIXPOINT_FRAC_MUL)
+		{
+			// Same rate: the fraction stays constant and the source is read linearly
+			const float *s = aSrc + (pos >> FIXPOINT_FRAC_BITS);
+			__m128 f = _mm_set_ps1((pos & FIXPOINT_FRAC_MASK) * (1 / (float)FIXPOINT_FRAC_MUL));
+			for (; i + 4 <= aDstSampleCount; i += 4, s += 4, pos += 4 * FIXPOINT_FRAC_MUL)
+			{
+				__m128 s1 = _mm_loadu_ps(s - 1);
+				__m128 s2 = _mm_loadu_ps(s);
+				_mm_storeu_ps(aDst + i, _mm_add_ps(s1, _mm_mul_ps(_mm_sub_ps(s2, s1), f)));
+			}
+		}
+		else
+		{
+			__m128 scale = _mm_set_ps1(1 / (float)FIXPOINT_FRAC_MUL);
+			for (; i + 4 <= aDstSampleCount; i += 4, pos += 4 * aStepFixed)
+			{
+				int pos1 = pos + aStepFixed;
+				int pos2 = pos1 + aStepFixed;
+				int pos3 = pos2 + aStepFixed;
+				int p0 = pos >> FIXPOINT_FRAC_BITS;
+				int p1 = pos1 >> FIXPOINT_FRAC_BITS;
+				int p2 = pos2 >> FIXPOINT_FRAC_BITS;
+				int p3 = pos3 >> FIXPOINT_FRAC_BITS;
+				__m128 s1 = _mm_setr_ps(aSrc[p0 - 1], aSrc[p1 - 1], aSrc[p2 - 1], aSrc[p3 - 1]);
+				__m128 s2 = _mm_setr_ps(aSrc[p0], aSrc[p1], aSrc[p2], aSrc[p3]);
+				__m128 f = _mm_setr_ps((float)(pos & FIXPOINT_FRAC_MASK), (float)(pos1 & FIXPOINT_FRAC_MASK), (float)(pos2 & FIXPOINT_FRAC_MASK), (float)(pos3 & FIXPOINT_FRAC_MASK));
+				_mm_storeu_ps(aDst + i, _mm_add_ps(s1, _mm_mul_ps(_mm_sub_ps(s2, s1), _mm_mul_ps(f, scale))));
+			}
+		}
+#endif
+
+		for (; i < aDstSampleCount; i++, pos += aStepFixed)
+		{
+			int p = pos >> FIXPOINT_FRAC_BITS;
+			int f = pos & FIXPOINT_FRAC_MASK;
+			float s1 = aSrc[p - 1];
+			float s2 = aSrc[p];
+			aDst[i] = s1 + (s2 - s1) * f * (1 / (float)FIXPOINT_FRAC_MUL);
+		}
+	}
+
+	static void resampleSinc(float *aSrc, float *aSrc1, float *aDst, int aSrcOffset, int aDstSampleCount, int aStepFixed)
+	{
+		int i;
+		int pos = aSrcOffset;
+
+		// Taps that reach back into the previous block read from a short stitched copy
+		float edge[(SINC_TAPS - 1) * 2];
+		memcpy(edge, aSrc1 + SAMPLE_GRANULARITY - (SINC_TAPS - 1), sizeof(float) * (SINC_TAPS - 1));
+		memcpy(edge + SINC_TAPS - 1, aSrc, sizeof(float) * (SINC_TAPS - 1));
+
+		for (i = 0; i < aDstSampleCount; i++, pos += aStepFixed)
+		{
+			int p = pos >> FIXPOINT_FRAC_BITS;
+			int phase = (pos & FIXPOINT_FRAC_MASK) >> SINC_PHASE_SHIFT;
+			float ff = (pos & ((1 << SINC_PHASE_SHIFT) - 1)) * (1 / (float)(1 << SINC_PHASE_SHIFT));
+			const float *s = p >= SINC_TAPS - 1 ? aSrc + p - (SINC_TAPS - 1) : edge + p;
+			const float *c0 = gSincTable[phase];
+			const float *c1 = gSincTable[phase + 1];
+#if defined(SOLOUD_AVX_INTRINSICS)
+			__m256 c = _mm256_loadu_ps(c0);
+			c = _mm256_add_ps(c, _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(c1), c), _mm256_set1_ps(ff)));
+			__m256 acc = _mm256_mul_ps(_mm256_loadu_ps(s), c);
+			__m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+			sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+			sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+			_mm_store_ss(aDst + i, sum);
+#elif defined(SOLOUD_SSE_INTRINSICS)
+			__m128 f = _mm_set_ps1(ff);
+			__m128 ca = _mm_loadu_ps(c0);
+			__m128 cb = _mm_loadu_ps(c0 + 4);
+			ca = _mm_add_ps(ca, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(c1), ca), f));
+			cb = _mm_add_ps(cb, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(c1 + 4), cb), f));
+			__m128 sum = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(s), ca), _mm_mul_ps(_mm_loadu_ps(s + 4), cb));
+			sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+			sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+			_mm_store_ss(aDst + i, sum);
+#else
+			float sum = 0;
+			int j;
+			for (j = 0; j < SINC_TAPS; j++)
+			{
+				sum += s[j] * (c0[j] + (c1[j] - c0[j]) * ff);
+			}
+			aDst[i] = sum;
+#endif
+		}
+	}
+
+	void resample(unsigned int aResampler, float *aSrc, float *aSrc1, float *aDst, int aSrcOffset, int aDstSampleCount, int aStepFixed)
+	{
+		switch (aResampler)
+		{
+		case Soloud::RESAMPLE_POINT:
+			resamplePoint(aSrc, aDst, aSrcOffset, aDstSampleCount, aStepFixed);
+			break;
+		case Soloud::RESAMPLE_SINC:
+			resampleSinc(aSrc, aSrc1, aDst, aSrcOffset, aDstSampleCount, aStepFixed);
+			break;
+		default:
+			resampleLinear(aSrc, aSrc1, aDst, aSrcOffset, aDstSampleCount, aStepFixed);
+			break;
+		}
+	}
+
+	void panAccumulate(float *aDst, const float *aSrc, unsigned int aSamples, float aVolume, float aVolumeStep)
+	{
+		unsigned int i = 0;
+#if defined(SOLOUD_AVX_INTRINSICS)
+		__m256 vol = _mm256_set1_ps(aVolume);
+		__m256 step = _mm256_set1_ps(aVolumeStep);
+		__m256 n = _mm256_setr_ps(1, 2, 3, 4, 5, 6, 7, 8);
+		__m256 eight = _mm256_set1_ps(8);
+		for (; i + 8 <= aSamples; i += 8)
+		{
+			__m256 v = _mm256_add_ps(vol, _mm256_mul_ps(step, n));
+			_mm256_storeu_ps(aDst + i, _mm256_add_ps(_mm256_loadu_ps(aDst + i), _mm256_mul_ps(_mm256_loadu_ps(aSrc + i), v)));
+			n = _mm256_add_ps(n, eight);
+		}
+#elif defined(SOLOUD_SSE_INTRINSICS)
+		__m128 vol = _mm_set_ps1(aVolume);
+		__m128 step = _mm_set_ps1(aVolumeStep);
+		__m128 n = _mm_setr_ps(1, 2, 3, 4);
+		__m128 four = _mm_set_ps1(4);
+		for (; i + 4 <= aSamples; i += 4)
+		{
+			__m128 v = _mm_add_ps(vol, _mm_mul_ps(step, n));
+			_mm_storeu_ps(aDst + i, _mm_add_ps(_mm_loadu_ps(aDst + i), _mm_mul_ps(_mm_loadu_ps(aSrc + i), v)));
+			n = _mm_add_ps(n, four);
+		}
+#endif
+		for (; i < aSamples; i++)
+		{
+			aDst[i] += aSrc[i] * (aVolume + aVolumeStep * (float)(i + 1));
+		}
+	}
+};
@@ -30,6 +30,13 @@ freely, subject to the following restrictions:
 #else
 #include <pthread.h>
 #include <unistd.h>
+#ifdef __APPLE__
+#include <dispatch/dispatch.h>
+#include <mach/mach_time.h>
+#else
+#include <semaphore.h>
+#include <time.h>
+#endif
 #endif
 
 namespace SoLoud
@@ -74,6 +81,43 @@ namespace SoLoud
 			}
 		}
 
+		void * createSemaphore()
+		{
+			return (void*)CreateSemaphore(NULL, 0, 0x7fffffff, NULL);
+		}
+
+		void destroySemaphore(void *aHandle)
+		{
+			if (aHandle)
+				CloseHandle((HANDLE)aHandle);
+		}
+
+		void postSemaphore(void *aHandle)
+		{
+			ReleaseSemaphore((HANDLE)aHandle, 1, NULL);
+		}
+
+		void waitSemaphore(void *aHandle)
+		{
+			WaitForSingleObject((HANDLE)aHandle, INFINITE);
+		}
+
+		int atomicLoad(volatile int *aValue)
+		{
+			// Volatile reads have acquire semantics with MSVC
+			return *aValue;
+		}
+
+		int atomicIncrement(volatile int *aValue)
+		{
+			return (int)InterlockedIncrement((volatile LONG *)aValue);
+		}
+
+		int atomicCompareExchange(volatile int *aValue, int aExchange, int aComparand)
+		{
+			return (int)InterlockedCompareExchange((volatile LONG *)aValue, aExchange, aComparand);
+		}
+
 		struct soloud_thread_data
 		{
 			threadFunction mFunc;
@@ -108,6 +152,15 @@ namespace SoLoud
 			Sleep(aMSec);
 		}
 
+		unsigned long long getTimeMicroseconds()
+		{
+			LARGE_INTEGER frequency, counter;
+			QueryPerformanceFrequency(&frequency);
+			QueryPerformanceCounter(&counter);
+			return (unsigned long long)(counter.QuadPart / frequency.QuadPart) * 1000000 +
+				(unsigned long long)(counter.QuadPart % frequency.QuadPart) * 1000000 / frequency.QuadPart;
+		}
+
         void wait(ThreadHandle aThreadHandle)
         {
             WaitForSingleObject(aThreadHandle->thread, INFINITE);
@@ -167,6 +220,77 @@ namespace SoLoud
 			}
 		}
 
+#ifdef __APPLE__
+		// Unnamed POSIX semaphores are not implemented on OS X
+		void * createSemaphore()
+		{
+			return (void*)dispatch_semaphore_create(0);
+		}
+
+		void destroySemaphore(void *aHandle)
+		{
+			if (aHandle)
+				dispatch_release((dispatch_semaphore_t)aHandle);
+		}
+
+		void postSemaphore(void *aHandle)
+		{
+			dispatch_semaphore_signal((dispatch_semaphore_t)aHandle);
+		}
+
+		void waitSemaphore(void *aHandle)
+		{
+			dispatch_semaphore_wait((dispatch_semaphore_t)aHandle, DISPATCH_TIME_FOREVER);
+		}
+#else
+		void * createSemaphore()
+		{
+			sem_t *semaphore = new sem_t;
+			if (sem_init(semaphore, 0, 0) != 0)
+			{
+				delete semaphore;
+				return 0;
+			}
+			return (void*)semaphore;
+		}
+
+		void destroySemaphore(void *aHandle)
+		{
+			sem_t *semaphore = (sem_t*)aHandle;
+			if (semaphore)
+			{
+				sem_destroy(semaphore);
+				delete semaphore;
+			}
+		}
+
+		void postSemaphore(void *aHandle)
+		{
+			sem_post((sem_t*)aHandle);
+		}
+
+		void waitSemaphore(void *aHandle)
+		{
+			// Retry when interrupted by a signal
+			while (sem_wait((sem_t*)aHandle) != 0) {}
+		}
+#endif
+
+		int atomicLoad(volatile int *aValue)
+		{
+			return __atomic_load_n(aValue, __ATOMIC_ACQUIRE);
+		}
+
+		int atomicIncrement(volatile int *aValue)
+		{
+			return __sync_add_and_fetch(aValue, 1);
+		}
+
+		int atomicCompareExchange(volatile int *aValue, int aExchange, int aComparand)
+		{
+			return __sync_val_compare_and_swap(aValue, aComparand, aExchange);
+		}
+
 		struct soloud_thread_data
 		{
 			threadFunction mFunc;
@@ -197,6 +321,20 @@ namespace SoLoud
 			usleep(aMSec * 1000);
 		}
 
+		unsigned long long getTimeMicroseconds()
+		{
+#ifdef __APPLE__
+			static mach_timebase_info_data_t timebase;
+			if (timebase.denom == 0)
+				mach_timebase_info(&timebase);
+			return mach_absolute_time() * timebase.numer / timebase.denom / 1000;
+#else
+			struct timespec ts;
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+			return (unsigned long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+		}
+
         void wait(ThreadHandle aThreadHandle)
         {
             pthread_join(aThreadHandle->thread, 0);
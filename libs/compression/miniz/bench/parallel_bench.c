@@ -0,0 +1,155 @@
+// miniz parallel deflate benchmark: wall-clock throughput of tdefl_compress_mem_to_heap_parallel() and
+// mz_zip_writer_add_mem_batch() for 1..N threads. Every result is decompressed and verified.
+//
+//   cc -O2 -pthread parallel_bench.c -o parallel_bench && ./parallel_bench [megabytes] [max_threads] [level]
+
+#include "../miniz.c"
+
+#include <stdio.h>
+#include <time.h>
+
+static double now(void)
+{
+  struct timespec ts; timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Word soup with some repetition, so blocks benefit from the primed dictionary.
+static void fill(mz_uint8 *buf, size_t size)
+{
+  static const char *s_words[] = { "deflate ", "block ", "thread ", "window ", "match ", "literal ", "huffman ", "stream ", "\n", "0123456789 " };
+  mz_uint32 seed = 12345; size_t i = 0;
+  while (i < size)
+  {
+    const char *w; seed = seed * 1103515245 + 12345; w = s_words[(seed >> 16) % 10];
+    while ((*w) && (i < size)) buf[i++] = (mz_uint8)*w++;
+    if ((seed & 0xF000) == 0) { mz_uint32 bits; seed = seed * 1103515245 + 12345; bits = seed; while ((i < size) && ((bits >>= 3) & 7)) buf[i++] = (mz_uint8)(bits & 0xFF); }
+  }
+}
+
+static int verify_gzip(const mz_uint8 *pComp, size_t comp_len, const mz_uint8 *pSrc, size_t src_len)
+{
+  mz_uint8 *pOut = (mz_uint8 *)malloc(src_len ? src_len : 1);
+  size_t out_len; int ok;
+  if ((comp_len < 18) || (pComp[0] != 0x1F) || (pComp[1] != 0x8B)) { free(pOut); return 0; }
+  out_len = tinfl_decompress_mem_to_mem(pOut, src_len, pComp + 10, comp_len - 18, 0);
+  ok = (out_len == src_len) && (!memcmp(pOut, pSrc, src_len)) &&
+       (MZ_READ_LE32(pComp + comp_len - 8) == (mz_uint32)mz_crc32(MZ_CRC32_INIT, pSrc, src_len)) &&
+       (MZ_READ_LE32(pComp + comp_len - 4) == (mz_uint32)src_len);
+  free(pOut);
+  return ok;
+}
+
+static int verify_zlib(const mz_uint8 *pComp, size_t comp_len, const mz_uint8 *pSrc, size_t src_len)
+{
+  mz_uint8 *pOut = (mz_uint8 *)malloc(src_len ? src_len : 1);
+  mz_ulong out_len = (mz_ulong)src_len; int ok;
+  ok = (mz_uncompress(pOut, &out_len, pComp, (mz_ulong)comp_len) == MZ_OK) && (out_len == src_len) && (!memcmp(pOut, pSrc, src_len));
+  free(pOut);
+  return ok;
+}
+
+static int bench_stream(const mz_uint8 *buf, size_t size, int level, mz_uint max_threads)
+{
+  mz_uint threads; int ok = 1;
+  int flags = (int)tdefl_create_comp_flags_from_zip_params(level, 15, MZ_DEFAULT_STRATEGY);
+  double serial = 0;
+
+  // Reference: the existing single-stream compressor
+  {
+    size_t comp_len; double t0 = now(), t1; void *p = tdefl_compress_mem_to_heap(buf, size, &comp_len, flags);
+    t1 = now(); serial = t1 - t0;
+    printf("%-22s %8.1f MB/s  ratio %.3f\n", "zlib serial", size / (1024.0 * 1024.0) / serial, (double)comp_len / size);
+    ok &= verify_zlib((const mz_uint8 *)p, comp_len, buf, size);
+    mz_free(p);
+  }
+
+  for (threads = 1; threads <= max_threads; threads *= 2)
+  {
+    size_t comp_len; double t0 = now(), t1; char name[32];
+    void *p = tdefl_compress_mem_to_heap_parallel(buf, size, &comp_len, flags, threads, 0);
+    t1 = now();
+    sprintf(name, "zlib parallel x%u", threads);
+    if ((!p) || (!verify_zlib((const mz_uint8 *)p, comp_len, buf, size))) { printf("%-22s FAILED\n", name); ok = 0; }
+    else printf("%-22s %8.1f MB/s  ratio %.3f  speedup %.2f\n", name, size / (1024.0 * 1024.0) / (t1 - t0), (double)comp_len / size, serial / (t1 - t0));
+    mz_free(p);
+  }
+
+  // gzip framing, and block sizes that don't divide the input evenly
+  {
+    size_t comp_len, sizes[] = { 0, 1, 100, 65536 + 7 }; mz_uint i;
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+      size_t len = MZ_MIN(sizes[i] ? sizes[i] * 37 : 0, size);
+      void *p = tdefl_compress_mem_to_heap_parallel(buf, len, &comp_len, (flags & ~TDEFL_WRITE_ZLIB_HEADER) | TDEFL_WRITE_GZIP_HEADER, max_threads, sizes[i] ? sizes[i] : 1);
+      if ((!p) || (!verify_gzip((const mz_uint8 *)p, comp_len, buf, len))) { printf("gzip %u bytes, block %u: FAILED\n", (unsigned)len, (unsigned)sizes[i]); ok = 0; }
+      mz_free(p);
+    }
+  }
+  return ok;
+}
+
+static int bench_zip(const mz_uint8 *buf, size_t size, int level, mz_uint max_threads)
+{
+  enum { NUM_FILES = 256 };
+  const char *names[NUM_FILES]; const void *bufs[NUM_FILES]; size_t sizes[NUM_FILES];
+  char name_storage[NUM_FILES][16];
+  mz_uint i, threads; int ok = 1; double serial = 0;
+  size_t ofs = 0;
+
+  // Mostly small entries plus one large one, a typical asset pack
+  for (i = 0; i < NUM_FILES; i++)
+  {
+    sizes[i] = (i == NUM_FILES / 2) ? size / 4 : ((size - size / 4) / NUM_FILES) - (i * 31) % 1024;
+    if (i == 7) sizes[i] = 2;
+    if (ofs + sizes[i] > size) sizes[i] = size - ofs;
+    bufs[i] = buf + ofs; ofs += sizes[i];
+    sprintf(name_storage[i], "file%03u.txt", i); names[i] = name_storage[i];
+  }
+
+  for (threads = 1; threads <= max_threads; threads *= 2)
+  {
+    mz_zip_archive zip; void *pArchive; size_t archive_size; double t0, t1; char name[32];
+    MZ_CLEAR_OBJ(zip);
+    t0 = now();
+    if ((!mz_zip_writer_init_heap(&zip, 0, size)) || (!mz_zip_writer_add_mem_batch(&zip, NUM_FILES, names, bufs, sizes, (mz_uint)level, threads)) ||
+        (!mz_zip_writer_finalize_heap_archive(&zip, &pArchive, &archive_size)))
+    {
+      printf("zip batch x%u FAILED\n", threads); mz_zip_writer_end(&zip); return 0;
+    }
+    t1 = now();
+    mz_zip_writer_end(&zip);
+    if (threads == 1) serial = t1 - t0;
+    sprintf(name, "zip batch x%u", threads);
+    printf("%-22s %8.1f MB/s  ratio %.3f  speedup %.2f\n", name, size / (1024.0 * 1024.0) / (t1 - t0), (double)archive_size / size, serial / (t1 - t0));
+
+    MZ_CLEAR_OBJ(zip);
+    if (!mz_zip_reader_init_mem(&zip, pArchive, archive_size, 0)) ok = 0;
+    for (i = 0; (ok) && (i < NUM_FILES); i++)
+    {
+      size_t len; void *p = mz_zip_reader_extract_file_to_heap(&zip, names[i], &len, 0);
+      ok = (p != NULL) && (len == sizes[i]) && (!memcmp(p, bufs[i], len));
+      mz_free(p);
+    }
+    mz_zip_reader_end(&zip);
+    mz_free(pArchive);
+    if (!ok) { printf("%-22s verify FAILED\n", name); return 0; }
+  }
+  return ok;
+}
+
+int main(int argc, char **argv)
+{
+  size_t size = (size_t)(argc > 1 ? atoi(argv[1]) : 64) * 1024 * 1024;
+  mz_uint max_threads = (mz_uint)(argc > 2 ? atoi(argv[2]) : 8);
+  int level = argc > 3 ? atoi(argv[3]) : MZ_DEFAULT_LEVEL, ok = 1;
+  mz_uint8 *buf = (mz_uint8 *)malloc(size);
+  if (!buf) return 1;
+  fill(buf, size);
+
+  ok &= bench_stream(buf, size, level, max_threads);
+  ok &= bench_zip(buf, size, level, max_threads);
+
+  free(buf);
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
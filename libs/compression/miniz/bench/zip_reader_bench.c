@@ -0,0 +1,127 @@
+// miniz zip reader benchmark: locate + extract of many small entries through the stdio reader (sorted central directory)
+// versus the memory mapped reader (hash index, zero-copy stored entries), and concurrent extraction from one shared mapped reader.
+//
+//   cc -O2 -pthread zip_reader_bench.c -o zip_reader_bench && ./zip_reader_bench [num_files] [threads]
+
+#include "../miniz.c"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <time.h>
+
+static const char *s_archive_name = "miniz-reader-bench.zip";
+
+static double now(void)
+{
+  struct timespec ts; timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void entry_name(char *pName, mz_uint i)
+{
+  sprintf(pName, "levels/%03u/Asset_%05u.%s", i % 97, i, (i & 1) ? "tex" : "mesh");
+}
+
+static size_t entry_data(mz_uint8 *pBuf, mz_uint i)
+{
+  size_t size = 64 + (i * 2654435761U) % 4032, j;
+  for (j = 0; j < size; j++) pBuf[j] = (mz_uint8)((j % 61) ^ (i * 7) ^ ((j * i) >> 9));
+  return size;
+}
+
+static double time_locate(mz_zip_archive *pZip, mz_uint num_files)
+{
+  char name[64]; mz_uint i; double t0 = now();
+  for (i = 0; i < num_files; i++) { entry_name(name, i); if (mz_zip_reader_locate_file(pZip, name, NULL, 0) != (int)i) return -1.0; }
+  return (now() - t0) * 1000.0;
+}
+
+typedef struct
+{
+  mz_zip_archive *m_pZip;
+  mz_uint m_num_files;
+  volatile long m_errors;
+} extract_job;
+
+// Looks up and extracts one entry into a caller buffer, using a pointer into the mapping for stored entries.
+static int extract_one(mz_zip_archive *pZip, mz_uint i)
+{
+  char name[64]; mz_uint8 expected[4096], out[4096];
+  size_t size = entry_data(expected, i), ptr_size; const void *p;
+  int file_index;
+  entry_name(name, i);
+  if ((file_index = mz_zip_reader_locate_file(pZip, name, NULL, 0)) < 0)
+    return 0;
+  if (NULL != (p = mz_zip_reader_extract_to_ptr(pZip, file_index, &ptr_size, 0)))
+    return (ptr_size == size) && (!memcmp(p, expected, size));
+  return mz_zip_reader_extract_to_mem_no_alloc(pZip, file_index, out, sizeof(out), 0, NULL, 0) && (!memcmp(out, expected, size));
+}
+
+static void extract_range(void *pUser, mz_uint job_index)
+{
+  extract_job *pJob = (extract_job *)pUser;
+  mz_uint i;
+  for (i = job_index * 256; i < MZ_MIN((job_index + 1) * 256, pJob->m_num_files); i++)
+    if (!extract_one(pJob->m_pZip, i)) MZ_ATOMIC_FETCH_INC(&pJob->m_errors);
+}
+
+int main(int argc, char **argv)
+{
+  mz_uint num_files = (mz_uint)(argc > 1 ? atoi(argv[1]) : 20000), num_threads = (mz_uint)(argc > 2 ? atoi(argv[2]) : 4), i;
+  mz_zip_archive zip; mz_uint8 buf[4096]; char name[64];
+  double t0, t1; int ok = 1;
+
+  // Every third entry is stored, the rest deflated
+  MZ_CLEAR_OBJ(zip);
+  if (!mz_zip_writer_init_file(&zip, s_archive_name, 0)) return EXIT_FAILURE;
+  for (i = 0; i < num_files; i++)
+  {
+    size_t size = entry_data(buf, i); entry_name(name, i);
+    if (!mz_zip_writer_add_mem(&zip, name, buf, size, (i % 3) ? MZ_BEST_SPEED : MZ_NO_COMPRESSION)) return EXIT_FAILURE;
+  }
+  if ((!mz_zip_writer_finalize_archive(&zip)) || (!mz_zip_writer_end(&zip))) return EXIT_FAILURE;
+
+  // stdio reader, binary search on the sorted central directory
+  MZ_CLEAR_OBJ(zip);
+  t0 = now();
+  if (!mz_zip_reader_init_file(&zip, s_archive_name, 0)) return EXIT_FAILURE;
+  for (i = 0; (ok) && (i < num_files); i++)
+  {
+    int file_index; mz_uint8 out[4096]; size_t size = entry_data(buf, i);
+    entry_name(name, i);
+    ok = ((file_index = mz_zip_reader_locate_file(&zip, name, NULL, 0)) >= 0) && mz_zip_reader_extract_to_mem(&zip, file_index, out, sizeof(out), 0) && (!memcmp(out, buf, size));
+  }
+  t1 = now();
+  printf("%-24s %8.1f ms%s\n", "stdio reader", (t1 - t0) * 1000.0, ok ? "" : "  FAILED");
+  printf("%-24s %8.1f ms\n", "  locate (sorted)", time_locate(&zip, num_files));
+  mz_zip_reader_end(&zip);
+
+  // Mapped reader, hash index, stored entries zero-copy. The hash makes the sorted directory unnecessary.
+  MZ_CLEAR_OBJ(zip);
+  t0 = now();
+  if (!mz_zip_reader_init_file_mapped(&zip, s_archive_name, MZ_ZIP_FLAG_DO_NOT_SORT_CENTRAL_DIRECTORY)) return EXIT_FAILURE;
+  for (i = 0; (ok) && (i < num_files); i++)
+    ok = extract_one(&zip, i);
+  t1 = now();
+  printf("%-24s %8.1f ms%s\n", "mapped reader", (t1 - t0) * 1000.0, ok ? "" : "  FAILED");
+  printf("%-24s %8.1f ms\n", "  locate (hash)", time_locate(&zip, num_files));
+
+  // Case insensitive and missing names still resolve through the index
+  entry_name(name, num_files / 2); for (i = 0; name[i]; i++) name[i] = (char)toupper((unsigned char)name[i]);
+  ok &= (mz_zip_reader_locate_file(&zip, name, NULL, 0) == (int)(num_files / 2)) && (mz_zip_reader_locate_file(&zip, name, NULL, MZ_ZIP_FLAG_CASE_SENSITIVE) < 0);
+  ok &= (mz_zip_reader_locate_file(&zip, "levels/none.tex", NULL, 0) < 0);
+
+  // The same reader shared by several threads
+  {
+    extract_job job; job.m_pZip = &zip; job.m_num_files = num_files; job.m_errors = 0;
+    t0 = now();
+    mz_parallel_for((num_files + 255) / 256, num_threads, extract_range, &job);
+    t1 = now();
+    ok &= !job.m_errors;
+    printf("mapped reader x%-9u %8.1f ms%s\n", num_threads, (t1 - t0) * 1000.0, job.m_errors ? "  FAILED" : "");
+  }
+  mz_zip_reader_end(&zip);
+
+  remove(s_archive_name);
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
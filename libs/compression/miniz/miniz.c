@@ -240,6 +240,10 @@ mz_ulong mz_adler32(mz_ulong adler, const unsigned char *ptr, size_t buf_len);
 // mz_crc32() returns the initial CRC-32 value to use when called with ptr==NULL.
 mz_ulong mz_crc32(mz_ulong crc, const unsigned char *ptr, size_t buf_len);
 
+// mz_adler32_combine()/mz_crc32_combine() return the checksum of the concatenation of two buffers, given the checksums of each and the length of the second one.
+mz_ulong mz_adler32_combine(mz_ulong adler1, mz_ulong adler2, size_t len2);
+mz_ulong mz_crc32_combine(mz_ulong crc1, mz_ulong crc2, size_t len2);
+
 // Compression strategies.
 enum { MZ_DEFAULT_STRATEGY = 0, MZ_FILTERED = 1, MZ_HUFFMAN_ONLY = 2, MZ_RLE = 3, MZ_FIXED = 4 };
 
@@ -560,13 +564,15 @@ typedef enum
   MZ_ZIP_FLAG_CASE_SENSITIVE                = 0x0100,
   MZ_ZIP_FLAG_IGNORE_PATH                   = 0x0200,
   MZ_ZIP_FLAG_COMPRESSED_DATA               = 0x0400,
-  MZ_ZIP_FLAG_DO_NOT_SORT_CENTRAL_DIRECTORY = 0x0800
+  MZ_ZIP_FLAG_DO_NOT_SORT_CENTRAL_DIRECTORY = 0x0800,
+  MZ_ZIP_FLAG_HASH_INDEX                    = 0x1000
 } mz_zip_flags;
 
 // ZIP archive reading
 
 // Inits a ZIP archive reader.
 // These functions read and validate the archive's central directory.
+// MZ_ZIP_FLAG_HASH_INDEX additionally builds a hash table of the filenames, making mz_zip_reader_locate_file() O(1) for lookups without a comment or MZ_ZIP_FLAG_IGNORE_PATH.
 mz_bool mz_zip_reader_init(mz_zip_archive *pZip, mz_uint64 size, mz_uint32 flags);
 mz_bool mz_zip_reader_init_mem(mz_zip_archive *pZip, const void *pMem, size_t size, mz_uint32 flags);
 
@@ -574,6 +580,13 @@ mz_bool mz_zip_reader_init_mem(mz_zip_archive *pZip, const void *pMem, size_t si
 mz_bool mz_zip_reader_init_file(mz_zip_archive *pZip, const char *pFilename, mz_uint32 flags);
 #endif
 
+#if !defined(MINIZ_NO_STDIO) && !defined(MINIZ_NO_MMAP)
+// Memory maps the archive file (read only) instead of reading it with stdio, and always builds the filename hash index.
+// Readers over memory (this one or mz_zip_reader_init_mem()) are never modified by the locate, stat, extract_to_mem_no_alloc and extract_to_ptr
+// functions, so those may be called concurrently from any number of threads. Define MINIZ_NO_MMAP to remove this function.
+mz_bool mz_zip_reader_init_file_mapped(mz_zip_archive *pZip, const char *pFilename, mz_uint32 flags);
+#endif
+
 // Returns the total number of files in the archive.
 mz_uint mz_zip_reader_get_num_files(mz_zip_archive *pZip);
 
@@ -597,6 +610,11 @@ int mz_zip_reader_locate_file(mz_zip_archive *pZip, const char *pName, const cha
 mz_bool mz_zip_reader_extract_to_mem_no_alloc(mz_zip_archive *pZip, mz_uint file_index, void *pBuf, size_t buf_size, mz_uint flags, void *pUser_read_buf, size_t user_read_buf_size);
 mz_bool mz_zip_reader_extract_file_to_mem_no_alloc(mz_zip_archive *pZip, const char *pFilename, void *pBuf, size_t buf_size, mz_uint flags, void *pUser_read_buf, size_t user_read_buf_size);
 
+// Returns a pointer to a stored (uncompressed) file's data inside an archive opened with mz_zip_reader_init_mem() or mz_zip_reader_init_file_mapped(), without copying it.
+// The CRC is not checked. With MZ_ZIP_FLAG_COMPRESSED_DATA the raw data of any entry is returned. Returns NULL for deflated entries (extract those with
+// mz_zip_reader_extract_to_mem_no_alloc()), and for archives which aren't in memory. The pointer is valid until mz_zip_reader_end().
+const void *mz_zip_reader_extract_to_ptr(mz_zip_archive *pZip, mz_uint file_index, size_t *pSize, mz_uint flags);
+
 // Extracts a archive file to a memory buffer.
 mz_bool mz_zip_reader_extract_to_mem(mz_zip_archive *pZip, mz_uint file_index, void *pBuf, size_t buf_size, mz_uint flags);
 mz_bool mz_zip_reader_extract_file_to_mem(mz_zip_archive *pZip, const char *pFilename, void *pBuf, size_t buf_size, mz_uint flags);
@@ -645,6 +663,11 @@ mz_bool mz_zip_writer_init_from_reader(mz_zip_archive *pZip, const char *pFilena
 mz_bool mz_zip_writer_add_mem(mz_zip_archive *pZip, const char *pArchive_name, const void *pBuf, size_t buf_size, mz_uint level_and_flags);
 mz_bool mz_zip_writer_add_mem_ex(mz_zip_archive *pZip, const char *pArchive_name, const void *pBuf, size_t buf_size, const void *pComment, mz_uint16 comment_size, mz_uint level_and_flags, mz_uint64 uncomp_size, mz_uint32 uncomp_crc32);
 
+// Adds num_files memory buffers to an archive, compressing them concurrently on up to num_threads threads. Entries are appended in array order.
+// Small entries are compressed one per thread; entries spanning several TDEFL_PARALLEL_DEFAULT_BLOCK_SIZE blocks are split across all threads instead.
+// The compressed entries are held in memory from the archive's m_pAlloc/m_pRealloc callbacks, which are then called from the worker threads.
+mz_bool mz_zip_writer_add_mem_batch(mz_zip_archive *pZip, mz_uint num_files, const char * const *ppArchive_names, const void * const *ppBufs, const size_t *pBuf_sizes, mz_uint level_and_flags, mz_uint num_threads);
+
 #ifndef MINIZ_NO_STDIO
 // Adds the contents of a disk file to an archive. This function also records the disk file's modified time into the archive.
 // level_and_flags - compression level (0-10, see MZ_BEST_SPEED, MZ_BEST_COMPRESSION, etc.) logically OR'd with zero or more mz_zip_flags, or just set to MZ_DEFAULT_COMPRESSION.
@@ -792,6 +815,7 @@ enum
 // TDEFL_FILTER_MATCHES: Discards matches <= 5 chars if enabled.
 // TDEFL_FORCE_ALL_STATIC_BLOCKS: Disable usage of optimized Huffman tables.
 // TDEFL_FORCE_ALL_RAW_BLOCKS: Only use raw (uncompressed) deflate blocks.
+// TDEFL_WRITE_GZIP_HEADER: Wrap the deflate data in a gzip header and CRC-32/size trailer. Only honored by the tdefl_compress_*_parallel() helpers.
 // The low 12 bits are reserved to control the max # of hash probes per dictionary lookup (see TDEFL_MAX_PROBES_MASK).
 enum
 {
@@ -802,7 +826,8 @@ enum
   TDEFL_RLE_MATCHES                   = 0x10000,
   TDEFL_FILTER_MATCHES                = 0x20000,
   TDEFL_FORCE_ALL_STATIC_BLOCKS       = 0x40000,
-  TDEFL_FORCE_ALL_RAW_BLOCKS          = 0x80000
+  TDEFL_FORCE_ALL_RAW_BLOCKS          = 0x80000,
+  TDEFL_WRITE_GZIP_HEADER             = 0x100000
 };
 
 // High level compression functions:
@@ -839,6 +864,15 @@ typedef mz_bool (*tdefl_put_buf_func_ptr)(const void* pBuf, int len, void *pUser
 // tdefl_compress_mem_to_output() compresses a block to an output stream. The above helpers use this function internally.
 mz_bool tdefl_compress_mem_to_output(const void *pBuf, size_t buf_len, tdefl_put_buf_func_ptr pPut_buf_func, void *pPut_buf_user, int flags);
 
+// Parallel compression (pigz-style). The source is split into blocks of block_size bytes (0 selects TDEFL_PARALLEL_DEFAULT_BLOCK_SIZE), which are
+// compressed concurrently on up to num_threads threads (0 or 1 compresses on the calling thread). Each block is primed with the preceding 32KB of
+// input as its dictionary and ends on a byte boundary (sync flush), so the blocks concatenate into one ordinary deflate stream. Block checksums are
+// combined with mz_adler32_combine()/mz_crc32_combine() for the zlib or gzip trailer. Output is delivered in order, a batch of blocks at a time.
+// Define MINIZ_NO_THREADS to build these helpers without thread support (they then run on the calling thread).
+enum { TDEFL_PARALLEL_DEFAULT_BLOCK_SIZE = 512 * 1024 };
+mz_bool tdefl_compress_mem_to_output_parallel(const void *pBuf, size_t buf_len, tdefl_put_buf_func_ptr pPut_buf_func, void *pPut_buf_user, int flags, mz_uint num_threads, size_t block_size);
+void *tdefl_compress_mem_to_heap_parallel(const void *pSrc_buf, size_t src_buf_len, size_t *pOut_len, int flags, mz_uint num_threads, size_t block_size);
+
 enum { TDEFL_MAX_HUFF_TABLES = 3, TDEFL_MAX_HUFF_SYMBOLS_0 = 288, TDEFL_MAX_HUFF_SYMBOLS_1 = 32, TDEFL_MAX_HUFF_SYMBOLS_2 = 19, TDEFL_LZ_DICT_SIZE = 32768, TDEFL_LZ_DICT_SIZE_MASK = TDEFL_LZ_DICT_SIZE - 1, TDEFL_MIN_MATCH_LEN = 3, TDEFL_MAX_MATCH_LEN = 258 };
 
 // TDEFL_OUT_BUF_SIZE MUST be large enough to hold a single entire compressed output block (using static/fixed Huffman codes).
@@ -911,6 +945,11 @@ tdefl_status tdefl_compress_buffer(tdefl_compressor *d, const void *pIn_buf, siz
 tdefl_status tdefl_get_prev_return_status(tdefl_compressor *d);
 mz_uint32 tdefl_get_adler32(tdefl_compressor *d);
 
+// Primes a freshly initialized compressor with up to TDEFL_LZ_DICT_SIZE bytes of data that logically precede the input, so matches may refer back
+// into it. Must be called before the first tdefl_compress() call. Unlike zlib's deflateSetDictionary(), no dictionary ID is recorded, so this is meant
+// for raw deflate streams whose decoder already holds that data (e.g. the previous part of the same stream).
+tdefl_status tdefl_set_dictionary(tdefl_compressor *d, const void *pDict, size_t dict_size);
+
 // Can't use tdefl_create_comp_flags_from_zip_params if MINIZ_NO_ZLIB_APIS isn't defined, because it uses some of its macros.
 #ifndef MINIZ_NO_ZLIB_APIS
 // Create tdefl_compress() flags given zlib-style compression parameters.
@@ -975,10 +1014,70 @@ typedef unsigned char mz_validate_uint64[sizeof(mz_uint64)==8 ? 1 : -1];
 
 // ------------------- zlib-style API's
 
-mz_ulong mz_adler32(mz_ulong adler, const unsigned char *ptr, size_t buf_len)
+// Checksum fast paths. mz_crc32() and mz_adler32() pick the best routine supported by the CPU on first use:
+// CRC-32 folds 64 bytes at a time with PCLMULQDQ (Intel's "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ"),
+// Adler-32 sums 32 bytes at a time with SSSE3 or AVX2. The portable fallbacks are slice-by-8 CRC-32 and the unrolled scalar Adler-32.
+// Define MINIZ_NO_SIMD to build only the portable routines.
+#if !defined(MINIZ_NO_SIMD) && (defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)) && \
+    ((defined(_MSC_VER) && _MSC_VER >= 1700) || defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+  #define MINIZ_USE_X86_SIMD 1
+#endif
+
+#if MINIZ_USE_X86_SIMD
+  #ifdef _MSC_VER
+    #include <intrin.h>
+    #define MZ_TARGET(x)
+  #else
+    #include <cpuid.h>
+    #define MZ_TARGET(x) __attribute__((target(x)))
+  #endif
+  #include <immintrin.h>
+
+enum { MZ_CPU_PCLMUL = 1, MZ_CPU_SSSE3 = 2, MZ_CPU_AVX2 = 4, MZ_CPU_DETECTED = 0x80 };
+
+static int mz_cpu_features(void)
 {
-  mz_uint32 i, s1 = (mz_uint32)(adler & 0xffff), s2 = (mz_uint32)(adler >> 16); size_t block_len = buf_len % 5552;
-  if (!ptr) return MZ_ADLER32_INIT;
+  static volatile int s_features;
+  int features = s_features;
+  if (!features)
+  {
+    unsigned int regs[4] = { 0, 0, 0, 0 }, max_leaf, xcr0 = 0;
+#ifdef _MSC_VER
+    __cpuid((int *)regs, 0); max_leaf = regs[0];
+    __cpuid((int *)regs, 1);
+#else
+    max_leaf = __get_cpuid_max(0, NULL);
+    __cpuid(1, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    features = MZ_CPU_DETECTED;
+    if ((regs[2] & (1 << 1)) && (regs[2] & (1 << 19))) features |= MZ_CPU_PCLMUL; // PCLMULQDQ + SSE4.1
+    if (regs[2] & (1 << 9)) features |= MZ_CPU_SSSE3;
+    if (regs[2] & (1 << 27)) // OSXSAVE: the OS must save YMM state before AVX2 can be used
+    {
+#ifdef _MSC_VER
+      xcr0 = (unsigned int)_xgetbv(0);
+#else
+      __asm__ __volatile__("xgetbv" : "=a"(xcr0) : "c"(0) : "%edx");
+#endif
+    }
+    if (max_leaf >= 7 && (xcr0 & 6) == 6)
+    {
+#ifdef _MSC_VER
+      __cpuidex((int *)regs, 7, 0);
+#else
+      __cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+      if (regs[1] & (1 << 5)) features |= MZ_CPU_AVX2;
+    }
+    s_features = features;
+  }
+  return features;
+}
+#endif // MINIZ_USE_X86_SIMD
+
+static mz_uint32 mz_adler32_scalar(mz_uint32 adler, const mz_uint8 *ptr, size_t buf_len)
+{
+  mz_uint32 i, s1 = adler & 0xffff, s2 = adler >> 16; size_t block_len = buf_len % 5552;
   while (buf_len) {
     for (i = 0; i + 7 < block_len; i += 8, ptr += 8) {
       s1 += ptr[0], s2 += s1; s1 += ptr[1], s2 += s1; s1 += ptr[2], s2 += s1; s1 += ptr[3], s2 += s1;
@@ -990,15 +1089,480 @@ mz_ulong mz_adler32(mz_ulong adler, const unsigned char *ptr, size_t buf_len)
   return (s2 << 16) + s1;
 }
 
-// Karl Malbrain's compact CRC-32. See "A compact CCITT crc16 and crc32 C implementation that balances processor cache usage against speed": http://www.geocities.com/malbrain/
+#if MINIZ_USE_X86_SIMD
+// Both SIMD Adler-32 routines consume 32-byte blocks. Within a block s2 grows by 32*s1 + sum((32-i)*byte[i]); the per-block s1 values are
+// accumulated in v_ps and scaled by 32 at the end. 5552/32 blocks keep every lane below 2^32 before the modulo, as in the scalar code.
+MZ_TARGET("ssse3") static mz_uint32 mz_adler32_ssse3(mz_uint32 adler, const mz_uint8 *ptr, size_t buf_len)
+{
+  mz_uint32 s1 = adler & 0xffff, s2 = adler >> 16;
+  size_t blocks = buf_len / 32;
+  const __m128i tap1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+  const __m128i tap2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+  const __m128i zero = _mm_setzero_si128(), ones = _mm_set1_epi16(1);
+  buf_len -= blocks * 32;
+  while (blocks)
+  {
+    mz_uint32 n = (mz_uint32)MZ_MIN(blocks, 5552 / 32);
+    __m128i v_ps = _mm_set_epi32(0, 0, 0, s1 * n), v_s2 = _mm_set_epi32(0, 0, 0, s2), v_s1 = _mm_setzero_si128();
+    blocks -= n;
+    do
+    {
+      const __m128i bytes1 = _mm_loadu_si128((const __m128i *)ptr), bytes2 = _mm_loadu_si128((const __m128i *)(ptr + 16));
+      v_ps = _mm_add_epi32(v_ps, v_s1);
+      v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes1, zero));
+      v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes1, tap1), ones));
+      v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes2, zero));
+      v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes2, tap2), ones));
+      ptr += 32;
+    } while (--n);
+    v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_ps, 5));
+    v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(1, 0, 3, 2)));
+    v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(2, 3, 0, 1)));
+    v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(1, 0, 3, 2)));
+    s1 = (s1 + (mz_uint32)_mm_cvtsi128_si32(v_s1)) % 65521U;
+    s2 = (mz_uint32)_mm_cvtsi128_si32(v_s2) % 65521U;
+  }
+  return mz_adler32_scalar((s2 << 16) + s1, ptr, buf_len);
+}
+
+MZ_TARGET("avx2") static mz_uint32 mz_adler32_avx2(mz_uint32 adler, const mz_uint8 *ptr, size_t buf_len)
+{
+  mz_uint32 s1 = adler & 0xffff, s2 = adler >> 16;
+  size_t blocks = buf_len / 32;
+  const __m256i tap = _mm256_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+  const __m256i zero = _mm256_setzero_si256(), ones = _mm256_set1_epi16(1);
+  buf_len -= blocks * 32;
+  while (blocks)
+  {
+    mz_uint32 n = (mz_uint32)MZ_MIN(blocks, 5552 / 32);
+    __m256i v_ps = _mm256_setr_epi32(s1 * n, 0, 0, 0, 0, 0, 0, 0), v_s2 = _mm256_setr_epi32(s2, 0, 0, 0, 0, 0, 0, 0), v_s1 = _mm256_setzero_si256();
+    __m128i sum1, sum2;
+    blocks -= n;
+    do
+    {
+      const __m256i bytes = _mm256_loadu_si256((const __m256i *)ptr);
+      v_ps = _mm256_add_epi32(v_ps, v_s1);
+      v_s1 = _mm256_add_epi32(v_s1, _mm256_sad_epu8(bytes, zero));
+      v_s2 = _mm256_add_epi32(v_s2, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, tap), ones));
+      ptr += 32;
+    } while (--n);
+    v_s2 = _mm256_add_epi32(v_s2, _mm256_slli_epi32(v_ps, 5));
+    sum1 = _mm_add_epi32(_mm256_castsi256_si128(v_s1), _mm256_extracti128_si256(v_s1, 1));
+    sum2 = _mm_add_epi32(_mm256_castsi256_si128(v_s2), _mm256_extracti128_si256(v_s2, 1));
+    sum1 = _mm_add_epi32(sum1, _mm_shuffle_epi32(sum1, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum2 = _mm_add_epi32(sum2, _mm_shuffle_epi32(sum2, _MM_SHUFFLE(2, 3, 0, 1)));
+    sum2 = _mm_add_epi32(sum2, _mm_shuffle_epi32(sum2, _MM_SHUFFLE(1, 0, 3, 2)));
+    s1 = (s1 + (mz_uint32)_mm_cvtsi128_si32(sum1)) % 65521U;
+    s2 = (mz_uint32)_mm_cvtsi128_si32(sum2) % 65521U;
+  }
+  return mz_adler32_scalar((s2 << 16) + s1, ptr, buf_len);
+}
+#endif // MINIZ_USE_X86_SIMD
+
+mz_ulong mz_adler32(mz_ulong adler, const unsigned char *ptr, size_t buf_len)
+{
+  if (!ptr) return MZ_ADLER32_INIT;
+#if MINIZ_USE_X86_SIMD
+  if (buf_len >= 64)
+  {
+    int features = mz_cpu_features();
+    if (features & MZ_CPU_AVX2) return mz_adler32_avx2((mz_uint32)adler, ptr, buf_len);
+    if (features & MZ_CPU_SSSE3) return mz_adler32_ssse3((mz_uint32)adler, ptr, buf_len);
+  }
+#endif
+  return mz_adler32_scalar((mz_uint32)adler, ptr, buf_len);
+}
+
+// Slice-by-8 CRC-32 tables: s_crc32_slice8[0] is the classic byte-wise table for the reflected polynomial 0xEDB88320,
+// s_crc32_slice8[k][i] advances s_crc32_slice8[k-1][i] by one more zero byte.
+static const mz_uint32 s_crc32_slice8[8][256] = {
+  {
+    0x00000000, 0x77073096, 0xee0e612c, 0x990951ba, 0x076dc419, 0x706af48f, 0xe963a535, 0x9e6495a3,
+    0x0edb8832, 0x79dcb8a4, 0xe0d5e91e, 0x97d2d988, 0x09b64c2b, 0x7eb17cbd, 0xe7b82d07, 0x90bf1d91,
+    0x1db71064, 0x6ab020f2, 0xf3b97148, 0x84be41de, 0x1adad47d, 0x6ddde4eb, 0xf4d4b551, 0x83d385c7,
+    0x136c9856, 0x646ba8c0, 0xfd62f97a, 0x8a65c9ec, 0x14015c4f, 0x63066cd9, 0xfa0f3d63, 0x8d080df5,
+    0x3b6e20c8, 0x4c69105e, 0xd56041e4, 0xa2677172, 0x3c03e4d1, 0x4b04d447, 0xd20d85fd, 0xa50ab56b,
+    0x35b5a8fa, 0x42b2986c, 0xdbbbc9d6, 0xacbcf940, 0x32d86ce3, 0x45df5c75, 0xdcd60dcf, 0xabd13d59,
+    0x26d930ac, 0x51de003a, 0xc8d75180, 0xbfd06116, 0x21b4f4b5, 0x56b3c423, 0xcfba9599, 0xb8bda50f,
+    0x2802b89e, 0x5f058808, 0xc60cd9b2, 0xb10be924, 0x2f6f7c87, 0x58684c11, 0xc1611dab, 0xb6662d3d,
+    0x76dc4190, 0x01db7106, 0x98d220bc, 0xefd5102a, 0x71b18589, 0x06b6b51f, 0x9fbfe4a5, 0xe8b8d433,
+    0x7807c9a2, 0x0f00f934, 0x9609a88e, 0xe10e9818, 0x7f6a0dbb, 0x086d3d2d, 0x91646c97, 0xe6635c01,
+    0x6b6b51f4, 0x1c6c6162, 0x856530d8, 0xf262004e, 0x6c0695ed, 0x1b01a57b, 0x8208f4c1, 0xf50fc457,
+    0x65b0d9c6, 0x12b7e950, 0x8bbeb8ea, 0xfcb9887c, 0x62dd1ddf, 0x15da2d49, 0x8cd37cf3, 0xfbd44c65,
+    0x4db26158, 0x3ab551ce, 0xa3bc0074, 0xd4bb30e2, 0x4adfa541, 0x3dd895d7, 0xa4d1c46d, 0xd3d6f4fb,
+    0x4369e96a, 0x346ed9fc, 0xad678846, 0xda60b8d0, 0x44042d73, 0x33031de5, 0xaa0a4c5f, 0xdd0d7cc9,
+    0x5005713c, 0x270241aa, 0xbe0b1010, 0xc90c2086, 0x5768b525, 0x206f85b3, 0xb966d409, 0xce61e49f,
+    0x5edef90e, 0x29d9c998, 0xb0d09822, 0xc7d7a8b4, 0x59b33d17, 0x2eb40d81, 0xb7bd5c3b, 0xc0ba6cad,
+    0xedb88320, 0x9abfb3b6, 0x03b6e20c, 0x74b1d29a, 0xead54739, 0x9dd277af, 0x04db2615, 0x73dc1683,
+    0xe3630b12, 0x94643b84, 0x0d6d6a3e, 0x7a6a5aa8, 0xe40ecf0b, 0x9309ff9d, 0x0a00ae27, 0x7d079eb1,
+    0xf00f9344, 0x8708a3d2, 0x1e01f268, 0x6906c2fe, 0xf762575d, 0x806567cb, 0x196c3671, 0x6e6b06e7,
+    0xfed41b76, 0x89d32be0, 0x10da7a5a, 0x67dd4acc, 0xf9b9df6f, 0x8ebeeff9, 0x17b7be43, 0x60b08ed5,
+    0xd6d6a3e8, 0xa1d1937e, 0x38d8c2c4, 0x4fdff252, 0xd1bb67f1, 0xa6bc5767, 0x3fb506dd, 0x48b2364b,
+    0xd80d2bda, 0xaf0a1b4c, 0x36034af6, 0x41047a60, 0xdf60efc3, 0xa867df55, 0x316e8eef, 0x4669be79,
+    0xcb61b38c, 0xbc66831a, 0x256fd2a0, 0x5268e236, 0xcc0c7795, 0xbb0b4703, 0x220216b9, 0x5505262f,
+    0xc5ba3bbe, 0xb2bd0b28, 0x2bb45a92, 0x5cb36a04, 0xc2d7ffa7, 0xb5d0cf31, 0x2cd99e8b, 0x5bdeae1d,
+    0x9b64c2b0, 0xec63f226, 0x756aa39c, 0x026d930a, 0x9c0906a9, 0xeb0e363f, 0x72076785, 0x05005713,
+    0x95bf4a82, 0xe2b87a14, 0x7bb12bae, 0x0cb61b38, 0x92d28e9b, 0xe5d5be0d, 0x7cdcefb7, 0x0bdbdf21,
+    0x86d3d2d4, 0xf1d4e242, 0x68ddb3f8, 0x1fda836e, 0x81be16cd, 0xf6b9265b, 0x6fb077e1, 0x18b74777,
+    0x88085ae6, 0xff0f6a70, 0x66063bca, 0x11010b5c, 0x8f659eff, 0xf862ae69, 0x616bffd3, 0x166ccf45,
+    0xa00ae278, 0xd70dd2ee, 0x4e048354, 0x3903b3c2, 0xa7672661, 0xd06016f7, 0x4969474d, 0x3e6e77db,
+    0xaed16a4a, 0xd9d65adc, 0x40df0b66, 0x37d83bf0, 0xa9bcae53, 0xdebb9ec5, 0x47b2cf7f, 0x30b5ffe9,
+    0xbdbdf21c, 0xcabac28a, 0x53b39330, 0x24b4a3a6, 0xbad03605, 0xcdd70693, 0x54de5729, 0x23d967bf,
+    0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94, 0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d },
+  {
+    0x00000000, 0x191b3141, 0x32366282, 0x2b2d53c3, 0x646cc504, 0x7d77f445, 0x565aa786, 0x4f4196c7,
+    0xc8d98a08, 0xd1c2bb49, 0xfaefe88a, 0xe3f4d9cb, 0xacb54f0c, 0xb5ae7e4d, 0x9e832d8e, 0x87981ccf,
+    0x4ac21251, 0x53d92310, 0x78f470d3, 0x61ef4192, 0x2eaed755, 0x37b5e614, 0x1c98b5d7, 0x05838496,
+    0x821b9859, 0x9b00a918, 0xb02dfadb, 0xa936cb9a, 0xe6775d5d, 0xff6c6c1c, 0xd4413fdf, 0xcd5a0e9e,
+    0x958424a2, 0x8c9f15e3, 0xa7b24620, 0xbea97761, 0xf1e8e1a6, 0xe8f3d0e7, 0xc3de8324, 0xdac5b265,
+    0x5d5daeaa, 0x44469feb, 0x6f6bcc28, 0x7670fd69, 0x39316bae, 0x202a5aef, 0x0b07092c, 0x121c386d,
+    0xdf4636f3, 0xc65d07b2, 0xed705471, 0xf46b6530, 0xbb2af3f7, 0xa231c2b6, 0x891c9175, 0x9007a034,
+    0x179fbcfb, 0x0e848dba, 0x25a9de79, 0x3cb2ef38, 0x73f379ff, 0x6ae848be, 0x41c51b7d, 0x58de2a3c,
+    0xf0794f05, 0xe9627e44, 0xc24f2d87, 0xdb541cc6, 0x94158a01, 0x8d0ebb40, 0xa623e883, 0xbf38d9c2,
+    0x38a0c50d, 0x21bbf44c, 0x0a96a78f, 0x138d96ce, 0x5ccc0009, 0x45d73148, 0x6efa628b, 0x77e153ca,
+    0xbabb5d54, 0xa3a06c15, 0x888d3fd6, 0x91960e97, 0xded79850, 0xc7cca911, 0xece1fad2, 0xf5facb93,
+    0x7262d75c, 0x6b79e61d, 0x4054b5de, 0x594f849f, 0x160e1258, 0x0f152319, 0x243870da, 0x3d23419b,
+    0x65fd6ba7, 0x7ce65ae6, 0x57cb0925, 0x4ed03864, 0x0191aea3, 0x188a9fe2, 0x33a7cc21, 0x2abcfd60,
+    0xad24e1af, 0xb43fd0ee, 0x9f12832d, 0x8609b26c, 0xc94824ab, 0xd05315ea, 0xfb7e4629, 0xe2657768,
+    0x2f3f79f6, 0x362448b7, 0x1d091b74, 0x04122a35, 0x4b53bcf2, 0x52488db3, 0x7965de70, 0x607eef31,
+    0xe7e6f3fe, 0xfefdc2bf, 0xd5d0917c, 0xcccba03d, 0x838a36fa, 0x9a9107bb, 0xb1bc5478, 0xa8a76539,
+    0x3b83984b, 0x2298a90a, 0x09b5fac9, 0x10aecb88, 0x5fef5d4f, 0x46f46c0e, 0x6dd93fcd, 0x74c20e8c,
+    0xf35a1243, 0xea412302, 0xc16c70c1, 0xd8774180, 0x9736d747, 0x8e2de606, 0xa500b5c5, 0xbc1b8484,
+    0x71418a1a, 0x685abb5b, 0x4377e898, 0x5a6cd9d9, 0x152d4f1e, 0x0c367e5f, 0x271b2d9c, 0x3e001cdd,
+    0xb9980012, 0xa0833153, 0x8bae6290, 0x92b553d1, 0xddf4c516, 0xc4eff457, 0xefc2a794, 0xf6d996d5,
+    0xae07bce9, 0xb71c8da8, 0x9c31de6b, 0x852aef2a, 0xca6b79ed, 0xd37048ac, 0xf85d1b6f, 0xe1462a2e,
+    0x66de36e1, 0x7fc507a0, 0x54e85463, 0x4df36522, 0x02b2f3e5, 0x1ba9c2a4, 0x30849167, 0x299fa026,
+    0xe4c5aeb8, 0xfdde9ff9, 0xd6f3cc3a, 0xcfe8fd7b, 0x80a96bbc, 0x99b25afd, 0xb29f093e, 0xab84387f,
+    0x2c1c24b0, 0x350715f1, 0x1e2a4632, 0x07317773, 0x4870e1b4, 0x516bd0f5, 0x7a468336, 0x635db277,
+    0xcbfad74e, 0xd2e1e60f, 0xf9ccb5cc, 0xe0d7848d, 0xaf96124a, 0xb68d230b, 0x9da070c8, 0x84bb4189,
+    0x03235d46, 0x1a386c07, 0x31153fc4, 0x280e0e85, 0x674f9842, 0x7e54a903, 0x5579fac0, 0x4c62cb81,
+    0x8138c51f, 0x9823f45e, 0xb30ea79d, 0xaa1596dc, 0xe554001b, 0xfc4f315a, 0xd7626299, 0xce7953d8,
+    0x49e14f17, 0x50fa7e56, 0x7bd72d95, 0x62cc1cd4, 0x2d8d8a13, 0x3496bb52, 0x1fbbe891, 0x06a0d9d0,
+    0x5e7ef3ec, 0x4765c2ad, 0x6c48916e, 0x7553a02f, 0x3a1236e8, 0x230907a9, 0x0824546a, 0x113f652b,
+    0x96a779e4, 0x8fbc48a5, 0xa4911b66, 0xbd8a2a27, 0xf2cbbce0, 0xebd08da1, 0xc0fdde62, 0xd9e6ef23,
+    0x14bce1bd, 0x0da7d0fc, 0x268a833f, 0x3f91b27e, 0x70d024b9, 0x69cb15f8, 0x42e6463b, 0x5bfd777a,
+    0xdc656bb5, 0xc57e5af4, 0xee530937, 0xf7483876, 0xb809aeb1, 0xa1129ff0, 0x8a3fcc33, 0x9324fd72 },
+  {
+    0x00000000, 0x01c26a37, 0x0384d46e, 0x0246be59, 0x0709a8dc, 0x06cbc2eb, 0x048d7cb2, 0x054f1685,
+    0x0e1351b8, 0x0fd13b8f, 0x0d9785d6, 0x0c55efe1, 0x091af964, 0x08d89353, 0x0a9e2d0a, 0x0b5c473d,
+    0x1c26a370, 0x1de4c947, 0x1fa2771e, 0x1e601d29, 0x1b2f0bac, 0x1aed619b, 0x18abdfc2, 0x1969b5f5,
+    0x1235f2c8, 0x13f798ff, 0x11b126a6, 0x10734c91, 0x153c5a14, 0x14fe3023, 0x16b88e7a, 0x177ae44d,
+    0x384d46e0, 0x398f2cd7, 0x3bc9928e, 0x3a0bf8b9, 0x3f44ee3c, 0x3e86840b, 0x3cc03a52, 0x3d025065,
+    0x365e1758, 0x379c7d6f, 0x35dac336, 0x3418a901, 0x3157bf84, 0x3095d5b3, 0x32d36bea, 0x331101dd,
+    0x246be590, 0x25a98fa7, 0x27ef31fe, 0x262d5bc9, 0x23624d4c, 0x22a0277b, 0x20e69922, 0x2124f315,
+    0x2a78b428, 0x2bbade1f, 0x29fc6046, 0x283e0a71, 0x2d711cf4, 0x2cb376c3, 0x2ef5c89a, 0x2f37a2ad,
+    0x709a8dc0, 0x7158e7f7, 0x731e59ae, 0x72dc3399, 0x7793251c, 0x76514f2b, 0x7417f172, 0x75d59b45,
+    0x7e89dc78, 0x7f4bb64f, 0x7d0d0816, 0x7ccf6221, 0x798074a4, 0x78421e93, 0x7a04a0ca, 0x7bc6cafd,
+    0x6cbc2eb0, 0x6d7e4487, 0x6f38fade, 0x6efa90e9, 0x6bb5866c, 0x6a77ec5b, 0x68315202, 0x69f33835,
+    0x62af7f08, 0x636d153f, 0x612bab66, 0x60e9c151, 0x65a6d7d4, 0x6464bde3, 0x662203ba, 0x67e0698d,
+    0x48d7cb20, 0x4915a117, 0x4b531f4e, 0x4a917579, 0x4fde63fc, 0x4e1c09cb, 0x4c5ab792, 0x4d98dda5,
+    0x46c49a98, 0x4706f0af, 0x45404ef6, 0x448224c1, 0x41cd3244, 0x400f5873, 0x4249e62a, 0x438b8c1d,
+    0x54f16850, 0x55330267, 0x5775bc3e, 0x56b7d609, 0x53f8c08c, 0x523aaabb, 0x507c14e2, 0x51be7ed5,
+    0x5ae239e8, 0x5b2053df, 0x5966ed86, 0x58a487b1, 0x5deb9134, 0x5c29fb03, 0x5e6f455a, 0x5fad2f6d,
+    0xe1351b80, 0xe0f771b7, 0xe2b1cfee, 0xe373a5d9, 0xe63cb35c, 0xe7fed96b, 0xe5b86732, 0xe47a0d05,
+    0xef264a38, 0xeee4200f, 0xeca29e56, 0xed60f461, 0xe82fe2e4, 0xe9ed88d3, 0xebab368a, 0xea695cbd,
+    0xfd13b8f0, 0xfcd1d2c7, 0xfe976c9e, 0xff5506a9, 0xfa1a102c, 0xfbd87a1b, 0xf99ec442, 0xf85cae75,
+    0xf300e948, 0xf2c2837f, 0xf0843d26, 0xf1465711, 0xf4094194, 0xf5cb2ba3, 0xf78d95fa, 0xf64fffcd,
+    0xd9785d60, 0xd8ba3757, 0xdafc890e, 0xdb3ee339, 0xde71f5bc, 0xdfb39f8b, 0xddf521d2, 0xdc374be5,
+    0xd76b0cd8, 0xd6a966ef, 0xd4efd8b6, 0xd52db281, 0xd062a404, 0xd1a0ce33, 0xd3e6706a, 0xd2241a5d,
+    0xc55efe10, 0xc49c9427, 0xc6da2a7e, 0xc7184049, 0xc25756cc, 0xc3953cfb, 0xc1d382a2, 0xc011e895,
+    0xcb4dafa8, 0xca8fc59f, 0xc8c97bc6, 0xc90b11f1, 0xcc440774, 0xcd866d43, 0xcfc0d31a, 0xce02b92d,
+    0x91af9640, 0x906dfc77, 0x922b422e, 0x93e92819, 0x96a63e9c, 0x976454ab, 0x9522eaf2, 0x94e080c5,
+    0x9fbcc7f8, 0x9e7eadcf, 0x9c381396, 0x9dfa79a1, 0x98b56f24, 0x99770513, 0x9b31bb4a, 0x9af3d17d,
+    0x8d893530, 0x8c4b5f07, 0x8e0de15e, 0x8fcf8b69, 0x8a809dec, 0x8b42f7db, 0x89044982, 0x88c623b5,
+    0x839a6488, 0x82580ebf, 0x801eb0e6, 0x81dcdad1, 0x8493cc54, 0x8551a663, 0x8717183a, 0x86d5720d,
+    0xa9e2d0a0, 0xa820ba97, 0xaa6604ce, 0xaba46ef9, 0xaeeb787c, 0xaf29124b, 0xad6fac12, 0xacadc625,
+    0xa7f18118, 0xa633eb2f, 0xa4755576, 0xa5b73f41, 0xa0f829c4, 0xa13a43f3, 0xa37cfdaa, 0xa2be979d,
+    0xb5c473d0, 0xb40619e7, 0xb640a7be, 0xb782cd89, 0xb2cddb0c, 0xb30fb13b, 0xb1490f62, 0xb08b6555,
+    0xbbd72268, 0xba15485f, 0xb853f606, 0xb9919c31, 0xbcde8ab4, 0xbd1ce083, 0xbf5a5eda, 0xbe9834ed },
+  {
+    0x00000000, 0xb8bc6765, 0xaa09c88b, 0x12b5afee, 0x8f629757, 0x37def032, 0x256b5fdc, 0x9dd738b9,
+    0xc5b428ef, 0x7d084f8a, 0x6fbde064, 0xd7018701, 0x4ad6bfb8, 0xf26ad8dd, 0xe0df7733, 0x58631056,
+    0x5019579f, 0xe8a530fa, 0xfa109f14, 0x42acf871, 0xdf7bc0c8, 0x67c7a7ad, 0x75720843, 0xcdce6f26,
+    0x95ad7f70, 0x2d111815, 0x3fa4b7fb, 0x8718d09e, 0x1acfe827, 0xa2738f42, 0xb0c620ac, 0x087a47c9,
+    0xa032af3e, 0x188ec85b, 0x0a3b67b5, 0xb28700d0, 0x2f503869, 0x97ec5f0c, 0x8559f0e2, 0x3de59787,
+    0x658687d1, 0xdd3ae0b4, 0xcf8f4f5a, 0x7733283f, 0xeae41086, 0x525877e3, 0x40edd80d, 0xf851bf68,
+    0xf02bf8a1, 0x48979fc4, 0x5a22302a, 0xe29e574f, 0x7f496ff6, 0xc7f50893, 0xd540a77d, 0x6dfcc018,
+    0x359fd04e, 0x8d23b72b, 0x9f9618c5, 0x272a7fa0, 0xbafd4719, 0x0241207c, 0x10f48f92, 0xa848e8f7,
+    0x9b14583d, 0x23a83f58, 0x311d90b6, 0x89a1f7d3, 0x1476cf6a, 0xaccaa80f, 0xbe7f07e1, 0x06c36084,
+    0x5ea070d2, 0xe61c17b7, 0xf4a9b859, 0x4c15df3c, 0xd1c2e785, 0x697e80e0, 0x7bcb2f0e, 0xc377486b,
+    0xcb0d0fa2, 0x73b168c7, 0x6104c729, 0xd9b8a04c, 0x446f98f5, 0xfcd3ff90, 0xee66507e, 0x56da371b,
+    0x0eb9274d, 0xb6054028, 0xa4b0efc6, 0x1c0c88a3, 0x81dbb01a, 0x3967d77f, 0x2bd27891, 0x936e1ff4,
+    0x3b26f703, 0x839a9066, 0x912f3f88, 0x299358ed, 0xb4446054, 0x0cf80731, 0x1e4da8df, 0xa6f1cfba,
+    0xfe92dfec, 0x462eb889, 0x549b1767, 0xec277002, 0x71f048bb, 0xc94c2fde, 0xdbf98030, 0x6345e755,
+    0x6b3fa09c, 0xd383c7f9, 0xc1366817, 0x798a0f72, 0xe45d37cb, 0x5ce150ae, 0x4e54ff40, 0xf6e89825,
+    0xae8b8873, 0x1637ef16, 0x048240f8, 0xbc3e279d, 0x21e91f24, 0x99557841, 0x8be0d7af, 0x335cb0ca,
+    0xed59b63b, 0x55e5d15e, 0x47507eb0, 0xffec19d5, 0x623b216c, 0xda874609, 0xc832e9e7, 0x708e8e82,
+    0x28ed9ed4, 0x9051f9b1, 0x82e4565f, 0x3a58313a, 0xa78f0983, 0x1f336ee6, 0x0d86c108, 0xb53aa66d,
+    0xbd40e1a4, 0x05fc86c1, 0x1749292f, 0xaff54e4a, 0x322276f3, 0x8a9e1196, 0x982bbe78, 0x2097d91d,
+    0x78f4c94b, 0xc048ae2e, 0xd2fd01c0, 0x6a4166a5, 0xf7965e1c, 0x4f2a3979, 0x5d9f9697, 0xe523f1f2,
+    0x4d6b1905, 0xf5d77e60, 0xe762d18e, 0x5fdeb6eb, 0xc2098e52, 0x7ab5e937, 0x680046d9, 0xd0bc21bc,
+    0x88df31ea, 0x3063568f, 0x22d6f961, 0x9a6a9e04, 0x07bda6bd, 0xbf01c1d8, 0xadb46e36, 0x15080953,
+    0x1d724e9a, 0xa5ce29ff, 0xb77b8611, 0x0fc7e174, 0x9210d9cd, 0x2aacbea8, 0x38191146, 0x80a57623,
+    0xd8c66675, 0x607a0110, 0x72cfaefe, 0xca73c99b, 0x57a4f122, 0xef189647, 0xfdad39a9, 0x45115ecc,
+    0x764dee06, 0xcef18963, 0xdc44268d, 0x64f841e8, 0xf92f7951, 0x41931e34, 0x5326b1da, 0xeb9ad6bf,
+    0xb3f9c6e9, 0x0b45a18c, 0x19f00e62, 0xa14c6907, 0x3c9b51be, 0x842736db, 0x96929935, 0x2e2efe50,
+    0x2654b999, 0x9ee8defc, 0x8c5d7112, 0x34e11677, 0xa9362ece, 0x118a49ab, 0x033fe645, 0xbb838120,
+    0xe3e09176, 0x5b5cf613, 0x49e959fd, 0xf1553e98, 0x6c820621, 0xd43e6144, 0xc68bceaa, 0x7e37a9cf,
+    0xd67f4138, 0x6ec3265d, 0x7c7689b3, 0xc4caeed6, 0x591dd66f, 0xe1a1b10a, 0xf3141ee4, 0x4ba87981,
+    0x13cb69d7, 0xab770eb2, 0xb9c2a15c, 0x017ec639, 0x9ca9fe80, 0x241599e5, 0x36a0360b, 0x8e1c516e,
+    0x866616a7, 0x3eda71c2, 0x2c6fde2c, 0x94d3b949, 0x090481f0, 0xb1b8e695, 0xa30d497b, 0x1bb12e1e,
+    0x43d23e48, 0xfb6e592d, 0xe9dbf6c3, 0x516791a6, 0xccb0a91f, 0x740cce7a, 0x66b96194, 0xde0506f1 },
+  {
+    0x00000000, 0x3d6029b0, 0x7ac05360, 0x47a07ad0, 0xf580a6c0, 0xc8e08f70, 0x8f40f5a0, 0xb220dc10,
+    0x30704bc1, 0x0d106271, 0x4ab018a1, 0x77d03111, 0xc5f0ed01, 0xf890c4b1, 0xbf30be61, 0x825097d1,
+    0x60e09782, 0x5d80be32, 0x1a20c4e2, 0x2740ed52, 0x95603142, 0xa80018f2, 0xefa06222, 0xd2c04b92,
+    0x5090dc43, 0x6df0f5f3, 0x2a508f23, 0x1730a693, 0xa5107a83, 0x98705333, 0xdfd029e3, 0xe2b00053,
+    0xc1c12f04, 0xfca106b4, 0xbb017c64, 0x866155d4, 0x344189c4, 0x0921a074, 0x4e81daa4, 0x73e1f314,
+    0xf1b164c5, 0xccd14d75, 0x8b7137a5, 0xb6111e15, 0x0431c205, 0x3951ebb5, 0x7ef19165, 0x4391b8d5,
+    0xa121b886, 0x9c419136, 0xdbe1ebe6, 0xe681c256, 0x54a11e46, 0x69c137f6, 0x2e614d26, 0x13016496,
+    0x9151f347, 0xac31daf7, 0xeb91a027, 0xd6f18997, 0x64d15587, 0x59b17c37, 0x1e1106e7, 0x23712f57,
+    0x58f35849, 0x659371f9, 0x22330b29, 0x1f532299, 0xad73fe89, 0x9013d739, 0xd7b3ade9, 0xead38459,
+    0x68831388, 0x55e33a38, 0x124340e8, 0x2f236958, 0x9d03b548, 0xa0639cf8, 0xe7c3e628, 0xdaa3cf98,
+    0x3813cfcb, 0x0573e67b, 0x42d39cab, 0x7fb3b51b, 0xcd93690b, 0xf0f340bb, 0xb7533a6b, 0x8a3313db,
+    0x0863840a, 0x3503adba, 0x72a3d76a, 0x4fc3feda, 0xfde322ca, 0xc0830b7a, 0x872371aa, 0xba43581a,
+    0x9932774d, 0xa4525efd, 0xe3f2242d, 0xde920d9d, 0x6cb2d18d, 0x51d2f83d, 0x167282ed, 0x2b12ab5d,
+    0xa9423c8c, 0x9422153c, 0xd3826fec, 0xeee2465c, 0x5cc29a4c, 0x61a2b3fc, 0x2602c92c, 0x1b62e09c,
+    0xf9d2e0cf, 0xc4b2c97f, 0x8312b3af, 0xbe729a1f, 0x0c52460f, 0x31326fbf, 0x7692156f, 0x4bf23cdf,
+    0xc9a2ab0e, 0xf4c282be, 0xb362f86e, 0x8e02d1de, 0x3c220dce, 0x0142247e, 0x46e25eae, 0x7b82771e,
+    0xb1e6b092, 0x8c869922, 0xcb26e3f2, 0xf646ca42, 0x44661652, 0x79063fe2, 0x3ea64532, 0x03c66c82,
+    0x8196fb53, 0xbcf6d2e3, 0xfb56a833, 0xc6368183, 0x74165d93, 0x49767423, 0x0ed60ef3, 0x33b62743,
+    0xd1062710, 0xec660ea0, 0xabc67470, 0x96a65dc0, 0x248681d0, 0x19e6a860, 0x5e46d2b0, 0x6326fb00,
+    0xe1766cd1, 0xdc164561, 0x9bb63fb1, 0xa6d61601, 0x14f6ca11, 0x2996e3a1, 0x6e369971, 0x5356b0c1,
+    0x70279f96, 0x4d47b626, 0x0ae7ccf6, 0x3787e546, 0x85a73956, 0xb8c710e6, 0xff676a36, 0xc2074386,
+    0x4057d457, 0x7d37fde7, 0x3a978737, 0x07f7ae87, 0xb5d77297, 0x88b75b27, 0xcf1721f7, 0xf2770847,
+    0x10c70814, 0x2da721a4, 0x6a075b74, 0x576772c4, 0xe547aed4, 0xd8278764, 0x9f87fdb4, 0xa2e7d404,
+    0x20b743d5, 0x1dd76a65, 0x5a7710b5, 0x67173905, 0xd537e515, 0xe857cca5, 0xaff7b675, 0x92979fc5,
+    0xe915e8db, 0xd475c16b, 0x93d5bbbb, 0xaeb5920b, 0x1c954e1b, 0x21f567ab, 0x66551d7b, 0x5b3534cb,
+    0xd965a31a, 0xe4058aaa, 0xa3a5f07a, 0x9ec5d9ca, 0x2ce505da, 0x11852c6a, 0x562556ba, 0x6b457f0a,
+    0x89f57f59, 0xb49556e9, 0xf3352c39, 0xce550589, 0x7c75d999, 0x4115f029, 0x06b58af9, 0x3bd5a349,
+    0xb9853498, 0x84e51d28, 0xc34567f8, 0xfe254e48, 0x4c059258, 0x7165bbe8, 0x36c5c138, 0x0ba5e888,
+    0x28d4c7df, 0x15b4ee6f, 0x521494bf, 0x6f74bd0f, 0xdd54611f, 0xe03448af, 0xa794327f, 0x9af41bcf,
+    0x18a48c1e, 0x25c4a5ae, 0x6264df7e, 0x5f04f6ce, 0xed242ade, 0xd044036e, 0x97e479be, 0xaa84500e,
+    0x4834505d, 0x755479ed, 0x32f4033d, 0x0f942a8d, 0xbdb4f69d, 0x80d4df2d, 0xc774a5fd, 0xfa148c4d,
+    0x78441b9c, 0x4524322c, 0x028448fc, 0x3fe4614c, 0x8dc4bd5c, 0xb0a494ec, 0xf704ee3c, 0xca64c78c },
+  {
+    0x00000000, 0xcb5cd3a5, 0x4dc8a10b, 0x869472ae, 0x9b914216, 0x50cd91b3, 0xd659e31d, 0x1d0530b8,
+    0xec53826d, 0x270f51c8, 0xa19b2366, 0x6ac7f0c3, 0x77c2c07b, 0xbc9e13de, 0x3a0a6170, 0xf156b2d5,
+    0x03d6029b, 0xc88ad13e, 0x4e1ea390, 0x85427035, 0x9847408d, 0x531b9328, 0xd58fe186, 0x1ed33223,
+    0xef8580f6, 0x24d95353, 0xa24d21fd, 0x6911f258, 0x7414c2e0, 0xbf481145, 0x39dc63eb, 0xf280b04e,
+    0x07ac0536, 0xccf0d693, 0x4a64a43d, 0x81387798, 0x9c3d4720, 0x57619485, 0xd1f5e62b, 0x1aa9358e,
+    0xebff875b, 0x20a354fe, 0xa6372650, 0x6d6bf5f5, 0x706ec54d, 0xbb3216e8, 0x3da66446, 0xf6fab7e3,
+    0x047a07ad, 0xcf26d408, 0x49b2a6a6, 0x82ee7503, 0x9feb45bb, 0x54b7961e, 0xd223e4b0, 0x197f3715,
+    0xe82985c0, 0x23755665, 0xa5e124cb, 0x6ebdf76e, 0x73b8c7d6, 0xb8e41473, 0x3e7066dd, 0xf52cb578,
+    0x0f580a6c, 0xc404d9c9, 0x4290ab67, 0x89cc78c2, 0x94c9487a, 0x5f959bdf, 0xd901e971, 0x125d3ad4,
+    0xe30b8801, 0x28575ba4, 0xaec3290a, 0x659ffaaf, 0x789aca17, 0xb3c619b2, 0x35526b1c, 0xfe0eb8b9,
+    0x0c8e08f7, 0xc7d2db52, 0x4146a9fc, 0x8a1a7a59, 0x971f4ae1, 0x5c439944, 0xdad7ebea, 0x118b384f,
+    0xe0dd8a9a, 0x2b81593f, 0xad152b91, 0x6649f834, 0x7b4cc88c, 0xb0101b29, 0x36846987, 0xfdd8ba22,
+    0x08f40f5a, 0xc3a8dcff, 0x453cae51, 0x8e607df4, 0x93654d4c, 0x58399ee9, 0xdeadec47, 0x15f13fe2,
+    0xe4a78d37, 0x2ffb5e92, 0xa96f2c3c, 0x6233ff99, 0x7f36cf21, 0xb46a1c84, 0x32fe6e2a, 0xf9a2bd8f,
+    0x0b220dc1, 0xc07ede64, 0x46eaacca, 0x8db67f6f, 0x90b34fd7, 0x5bef9c72, 0xdd7beedc, 0x16273d79,
+    0xe7718fac, 0x2c2d5c09, 0xaab92ea7, 0x61e5fd02, 0x7ce0cdba, 0xb7bc1e1f, 0x31286cb1, 0xfa74bf14,
+    0x1eb014d8, 0xd5ecc77d, 0x5378b5d3, 0x98246676, 0x852156ce, 0x4e7d856b, 0xc8e9f7c5, 0x03b52460,
+    0xf2e396b5, 0x39bf4510, 0xbf2b37be, 0x7477e41b, 0x6972d4a3, 0xa22e0706, 0x24ba75a8, 0xefe6a60d,
+    0x1d661643, 0xd63ac5e6, 0x50aeb748, 0x9bf264ed, 0x86f75455, 0x4dab87f0, 0xcb3ff55e, 0x006326fb,
+    0xf135942e, 0x3a69478b, 0xbcfd3525, 0x77a1e680, 0x6aa4d638, 0xa1f8059d, 0x276c7733, 0xec30a496,
+    0x191c11ee, 0xd240c24b, 0x54d4b0e5, 0x9f886340, 0x828d53f8, 0x49d1805d, 0xcf45f2f3, 0x04192156,
+    0xf54f9383, 0x3e134026, 0xb8873288, 0x73dbe12d, 0x6eded195, 0xa5820230, 0x2316709e, 0xe84aa33b,
+    0x1aca1375, 0xd196c0d0, 0x5702b27e, 0x9c5e61db, 0x815b5163, 0x4a0782c6, 0xcc93f068, 0x07cf23cd,
+    0xf6999118, 0x3dc542bd, 0xbb513013, 0x700de3b6, 0x6d08d30e, 0xa65400ab, 0x20c07205, 0xeb9ca1a0,
+    0x11e81eb4, 0xdab4cd11, 0x5c20bfbf, 0x977c6c1a, 0x8a795ca2, 0x41258f07, 0xc7b1fda9, 0x0ced2e0c,
+    0xfdbb9cd9, 0x36e74f7c, 0xb0733dd2, 0x7b2fee77, 0x662adecf, 0xad760d6a, 0x2be27fc4, 0xe0beac61,
+    0x123e1c2f, 0xd962cf8a, 0x5ff6bd24, 0x94aa6e81, 0x89af5e39, 0x42f38d9c, 0xc467ff32, 0x0f3b2c97,
+    0xfe6d9e42, 0x35314de7, 0xb3a53f49, 0x78f9ecec, 0x65fcdc54, 0xaea00ff1, 0x28347d5f, 0xe368aefa,
+    0x16441b82, 0xdd18c827, 0x5b8cba89, 0x90d0692c, 0x8dd55994, 0x46898a31, 0xc01df89f, 0x0b412b3a,
+    0xfa1799ef, 0x314b4a4a, 0xb7df38e4, 0x7c83eb41, 0x6186dbf9, 0xaada085c, 0x2c4e7af2, 0xe712a957,
+    0x15921919, 0xdececabc, 0x585ab812, 0x93066bb7, 0x8e035b0f, 0x455f88aa, 0xc3cbfa04, 0x089729a1,
+    0xf9c19b74, 0x329d48d1, 0xb4093a7f, 0x7f55e9da, 0x6250d962, 0xa90c0ac7, 0x2f987869, 0xe4c4abcc },
+  {
+    0x00000000, 0xa6770bb4, 0x979f1129, 0x31e81a9d, 0xf44f2413, 0x52382fa7, 0x63d0353a, 0xc5a73e8e,
+    0x33ef4e67, 0x959845d3, 0xa4705f4e, 0x020754fa, 0xc7a06a74, 0x61d761c0, 0x503f7b5d, 0xf64870e9,
+    0x67de9cce, 0xc1a9977a, 0xf0418de7, 0x56368653, 0x9391b8dd, 0x35e6b369, 0x040ea9f4, 0xa279a240,
+    0x5431d2a9, 0xf246d91d, 0xc3aec380, 0x65d9c834, 0xa07ef6ba, 0x0609fd0e, 0x37e1e793, 0x9196ec27,
+    0xcfbd399c, 0x69ca3228, 0x582228b5, 0xfe552301, 0x3bf21d8f, 0x9d85163b, 0xac6d0ca6, 0x0a1a0712,
+    0xfc5277fb, 0x5a257c4f, 0x6bcd66d2, 0xcdba6d66, 0x081d53e8, 0xae6a585c, 0x9f8242c1, 0x39f54975,
+    0xa863a552, 0x0e14aee6, 0x3ffcb47b, 0x998bbfcf, 0x5c2c8141, 0xfa5b8af5, 0xcbb39068, 0x6dc49bdc,
+    0x9b8ceb35, 0x3dfbe081, 0x0c13fa1c, 0xaa64f1a8, 0x6fc3cf26, 0xc9b4c492, 0xf85cde0f, 0x5e2bd5bb,
+    0x440b7579, 0xe27c7ecd, 0xd3946450, 0x75e36fe4, 0xb044516a, 0x16335ade, 0x27db4043, 0x81ac4bf7,
+    0x77e43b1e, 0xd19330aa, 0xe07b2a37, 0x460c2183, 0x83ab1f0d, 0x25dc14b9, 0x14340e24, 0xb2430590,
+    0x23d5e9b7, 0x85a2e203, 0xb44af89e, 0x123df32a, 0xd79acda4, 0x71edc610, 0x4005dc8d, 0xe672d739,
+    0x103aa7d0, 0xb64dac64, 0x87a5b6f9, 0x21d2bd4d, 0xe47583c3, 0x42028877, 0x73ea92ea, 0xd59d995e,
+    0x8bb64ce5, 0x2dc14751, 0x1c295dcc, 0xba5e5678, 0x7ff968f6, 0xd98e6342, 0xe86679df, 0x4e11726b,
+    0xb8590282, 0x1e2e0936, 0x2fc613ab, 0x89b1181f, 0x4c162691, 0xea612d25, 0xdb8937b8, 0x7dfe3c0c,
+    0xec68d02b, 0x4a1fdb9f, 0x7bf7c102, 0xdd80cab6, 0x1827f438, 0xbe50ff8c, 0x8fb8e511, 0x29cfeea5,
+    0xdf879e4c, 0x79f095f8, 0x48188f65, 0xee6f84d1, 0x2bc8ba5f, 0x8dbfb1eb, 0xbc57ab76, 0x1a20a0c2,
+    0x8816eaf2, 0x2e61e146, 0x1f89fbdb, 0xb9fef06f, 0x7c59cee1, 0xda2ec555, 0xebc6dfc8, 0x4db1d47c,
+    0xbbf9a495, 0x1d8eaf21, 0x2c66b5bc, 0x8a11be08, 0x4fb68086, 0xe9c18b32, 0xd82991af, 0x7e5e9a1b,
+    0xefc8763c, 0x49bf7d88, 0x78576715, 0xde206ca1, 0x1b87522f, 0xbdf0599b, 0x8c184306, 0x2a6f48b2,
+    0xdc27385b, 0x7a5033ef, 0x4bb82972, 0xedcf22c6, 0x28681c48, 0x8e1f17fc, 0xbff70d61, 0x198006d5,
+    0x47abd36e, 0xe1dcd8da, 0xd034c247, 0x7643c9f3, 0xb3e4f77d, 0x1593fcc9, 0x247be654, 0x820cede0,
+    0x74449d09, 0xd23396bd, 0xe3db8c20, 0x45ac8794, 0x800bb91a, 0x267cb2ae, 0x1794a833, 0xb1e3a387,
+    0x20754fa0, 0x86024414, 0xb7ea5e89, 0x119d553d, 0xd43a6bb3, 0x724d6007, 0x43a57a9a, 0xe5d2712e,
+    0x139a01c7, 0xb5ed0a73, 0x840510ee, 0x22721b5a, 0xe7d525d4, 0x41a22e60, 0x704a34fd, 0xd63d3f49,
+    0xcc1d9f8b, 0x6a6a943f, 0x5b828ea2, 0xfdf58516, 0x3852bb98, 0x9e25b02c, 0xafcdaab1, 0x09baa105,
+    0xfff2d1ec, 0x5985da58, 0x686dc0c5, 0xce1acb71, 0x0bbdf5ff, 0xadcafe4b, 0x9c22e4d6, 0x3a55ef62,
+    0xabc30345, 0x0db408f1, 0x3c5c126c, 0x9a2b19d8, 0x5f8c2756, 0xf9fb2ce2, 0xc813367f, 0x6e643dcb,
+    0x982c4d22, 0x3e5b4696, 0x0fb35c0b, 0xa9c457bf, 0x6c636931, 0xca146285, 0xfbfc7818, 0x5d8b73ac,
+    0x03a0a617, 0xa5d7ada3, 0x943fb73e, 0x3248bc8a, 0xf7ef8204, 0x519889b0, 0x6070932d, 0xc6079899,
+    0x304fe870, 0x9638e3c4, 0xa7d0f959, 0x01a7f2ed, 0xc400cc63, 0x6277c7d7, 0x539fdd4a, 0xf5e8d6fe,
+    0x647e3ad9, 0xc209316d, 0xf3e12bf0, 0x55962044, 0x90311eca, 0x3646157e, 0x07ae0fe3, 0xa1d90457,
+    0x579174be, 0xf1e67f0a, 0xc00e6597, 0x66796e23, 0xa3de50ad, 0x05a95b19, 0x34414184, 0x92364a30 },
+  {
+    0x00000000, 0xccaa009e, 0x4225077d, 0x8e8f07e3, 0x844a0efa, 0x48e00e64, 0xc66f0987, 0x0ac50919,
+    0xd3e51bb5, 0x1f4f1b2b, 0x91c01cc8, 0x5d6a1c56, 0x57af154f, 0x9b0515d1, 0x158a1232, 0xd92012ac,
+    0x7cbb312b, 0xb01131b5, 0x3e9e3656, 0xf23436c8, 0xf8f13fd1, 0x345b3f4f, 0xbad438ac, 0x767e3832,
+    0xaf5e2a9e, 0x63f42a00, 0xed7b2de3, 0x21d12d7d, 0x2b142464, 0xe7be24fa, 0x69312319, 0xa59b2387,
+    0xf9766256, 0x35dc62c8, 0xbb53652b, 0x77f965b5, 0x7d3c6cac, 0xb1966c32, 0x3f196bd1, 0xf3b36b4f,
+    0x2a9379e3, 0xe639797d, 0x68b67e9e, 0xa41c7e00, 0xaed97719, 0x62737787, 0xecfc7064, 0x205670fa,
+    0x85cd537d, 0x496753e3, 0xc7e85400, 0x0b42549e, 0x01875d87, 0xcd2d5d19, 0x43a25afa, 0x8f085a64,
+    0x562848c8, 0x9a824856, 0x140d4fb5, 0xd8a74f2b, 0xd2624632, 0x1ec846ac, 0x9047414f, 0x5ced41d1,
+    0x299dc2ed, 0xe537c273, 0x6bb8c590, 0xa712c50e, 0xadd7cc17, 0x617dcc89, 0xeff2cb6a, 0x2358cbf4,
+    0xfa78d958, 0x36d2d9c6, 0xb85dde25, 0x74f7debb, 0x7e32d7a2, 0xb298d73c, 0x3c17d0df, 0xf0bdd041,
+    0x5526f3c6, 0x998cf358, 0x1703f4bb, 0xdba9f425, 0xd16cfd3c, 0x1dc6fda2, 0x9349fa41, 0x5fe3fadf,
+    0x86c3e873, 0x4a69e8ed, 0xc4e6ef0e, 0x084cef90, 0x0289e689, 0xce23e617, 0x40ace1f4, 0x8c06e16a,
+    0xd0eba0bb, 0x1c41a025, 0x92cea7c6, 0x5e64a758, 0x54a1ae41, 0x980baedf, 0x1684a93c, 0xda2ea9a2,
+    0x030ebb0e, 0xcfa4bb90, 0x412bbc73, 0x8d81bced, 0x8744b5f4, 0x4beeb56a, 0xc561b289, 0x09cbb217,
+    0xac509190, 0x60fa910e, 0xee7596ed, 0x22df9673, 0x281a9f6a, 0xe4b09ff4, 0x6a3f9817, 0xa6959889,
+    0x7fb58a25, 0xb31f8abb, 0x3d908d58, 0xf13a8dc6, 0xfbff84df, 0x37558441, 0xb9da83a2, 0x7570833c,
+    0x533b85da, 0x9f918544, 0x111e82a7, 0xddb48239, 0xd7718b20, 0x1bdb8bbe, 0x95548c5d, 0x59fe8cc3,
+    0x80de9e6f, 0x4c749ef1, 0xc2fb9912, 0x0e51998c, 0x04949095, 0xc83e900b, 0x46b197e8, 0x8a1b9776,
+    0x2f80b4f1, 0xe32ab46f, 0x6da5b38c, 0xa10fb312, 0xabcaba0b, 0x6760ba95, 0xe9efbd76, 0x2545bde8,
+    0xfc65af44, 0x30cfafda, 0xbe40a839, 0x72eaa8a7, 0x782fa1be, 0xb485a120, 0x3a0aa6c3, 0xf6a0a65d,
+    0xaa4de78c, 0x66e7e712, 0xe868e0f1, 0x24c2e06f, 0x2e07e976, 0xe2ade9e8, 0x6c22ee0b, 0xa088ee95,
+    0x79a8fc39, 0xb502fca7, 0x3b8dfb44, 0xf727fbda, 0xfde2f2c3, 0x3148f25d, 0xbfc7f5be, 0x736df520,
+    0xd6f6d6a7, 0x1a5cd639, 0x94d3d1da, 0x5879d144, 0x52bcd85d, 0x9e16d8c3, 0x1099df20, 0xdc33dfbe,
+    0x0513cd12, 0xc9b9cd8c, 0x4736ca6f, 0x8b9ccaf1, 0x8159c3e8, 0x4df3c376, 0xc37cc495, 0x0fd6c40b,
+    0x7aa64737, 0xb60c47a9, 0x3883404a, 0xf42940d4, 0xfeec49cd, 0x32464953, 0xbcc94eb0, 0x70634e2e,
+    0xa9435c82, 0x65e95c1c, 0xeb665bff, 0x27cc5b61, 0x2d095278, 0xe1a352e6, 0x6f2c5505, 0xa386559b,
+    0x061d761c, 0xcab77682, 0x44387161, 0x889271ff, 0x825778e6, 0x4efd7878, 0xc0727f9b, 0x0cd87f05,
+    0xd5f86da9, 0x19526d37, 0x97dd6ad4, 0x5b776a4a, 0x51b26353, 0x9d1863cd, 0x1397642e, 0xdf3d64b0,
+    0x83d02561, 0x4f7a25ff, 0xc1f5221c, 0x0d5f2282, 0x079a2b9b, 0xcb302b05, 0x45bf2ce6, 0x89152c78,
+    0x50353ed4, 0x9c9f3e4a, 0x121039a9, 0xdeba3937, 0xd47f302e, 0x18d530b0, 0x965a3753, 0x5af037cd,
+    0xff6b144a, 0x33c114d4, 0xbd4e1337, 0x71e413a9, 0x7b211ab0, 0xb78b1a2e, 0x39041dcd, 0xf5ae1d53,
+    0x2c8e0fff, 0xe0240f61, 0x6eab0882, 0xa201081c, 0xa8c40105, 0x646e019b, 0xeae10678, 0x264b06e6 } };
+
+// Works on the inverted CRC register. Processes 8 bytes per iteration with 8 independent table lookups.
+static mz_uint32 mz_crc32_slice8(mz_uint32 crcu32, const mz_uint8 *ptr, size_t buf_len)
+{
+  for ( ; buf_len >= 8; ptr += 8, buf_len -= 8)
+  {
+    mz_uint32 lo = MZ_READ_LE32(ptr) ^ crcu32, hi = MZ_READ_LE32(ptr + 4);
+    crcu32 = s_crc32_slice8[7][lo & 0xFF] ^ s_crc32_slice8[6][(lo >> 8) & 0xFF] ^ s_crc32_slice8[5][(lo >> 16) & 0xFF] ^ s_crc32_slice8[4][lo >> 24] ^
+             s_crc32_slice8[3][hi & 0xFF] ^ s_crc32_slice8[2][(hi >> 8) & 0xFF] ^ s_crc32_slice8[1][(hi >> 16) & 0xFF] ^ s_crc32_slice8[0][hi >> 24];
+  }
+  while (buf_len--) crcu32 = (crcu32 >> 8) ^ s_crc32_slice8[0][(crcu32 ^ *ptr++) & 0xFF];
+  return crcu32;
+}
+
+#if MINIZ_USE_X86_SIMD
+// Works on the inverted CRC register. buf_len must be a multiple of 16 and at least 64. Folds four 128-bit lanes in parallel,
+// then folds them down to one and Barrett-reduces to 32 bits. Constants are the bit-reflected k1..k5, P(x) and u from the paper.
+MZ_TARGET("pclmul,sse4.1") static mz_uint32 mz_crc32_pclmul(mz_uint32 crcu32, const mz_uint8 *ptr, size_t buf_len)
+{
+  const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596LL, 0x0154442bd4LL), k3k4 = _mm_set_epi64x(0x00ccaa009eLL, 0x01751997d0LL);
+  const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124LL), poly = _mm_set_epi64x(0x01f7011641LL, 0x01db710641LL);
+  const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+  __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+
+  x1 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)ptr), _mm_cvtsi32_si128((int)crcu32));
+  x2 = _mm_loadu_si128((const __m128i *)(ptr + 16));
+  x3 = _mm_loadu_si128((const __m128i *)(ptr + 32));
+  x4 = _mm_loadu_si128((const __m128i *)(ptr + 48));
+  ptr += 64; buf_len -= 64;
+
+  // Fold 64 bytes per iteration
+  for (x0 = k1k2; buf_len >= 64; ptr += 64, buf_len -= 64)
+  {
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00); x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x6 = _mm_clmulepi64_si128(x2, x0, 0x00); x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+    x7 = _mm_clmulepi64_si128(x3, x0, 0x00); x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+    x8 = _mm_clmulepi64_si128(x4, x0, 0x00); x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i *)ptr));
+    x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i *)(ptr + 16)));
+    x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i *)(ptr + 32)));
+    x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i *)(ptr + 48)));
+  }
+
+  // Fold the four lanes into one, then any remaining 16 byte blocks
+  x0 = k3k4;
+  x5 = _mm_clmulepi64_si128(x1, x0, 0x00); x1 = _mm_clmulepi64_si128(x1, x0, 0x11); x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+  x5 = _mm_clmulepi64_si128(x1, x0, 0x00); x1 = _mm_clmulepi64_si128(x1, x0, 0x11); x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+  x5 = _mm_clmulepi64_si128(x1, x0, 0x00); x1 = _mm_clmulepi64_si128(x1, x0, 0x11); x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+  for ( ; buf_len >= 16; ptr += 16, buf_len -= 16)
+  {
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00); x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i *)ptr)), x5);
+  }
+
+  // 128 -> 64 bits
+  x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k5k0, 0x00), x2);
+
+  // Barrett reduction to 32 bits
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), poly, 0x10);
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask32), poly, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+  return (mz_uint32)_mm_extract_epi32(x1, 1);
+}
+#endif // MINIZ_USE_X86_SIMD
+
 mz_ulong mz_crc32(mz_ulong crc, const mz_uint8 *ptr, size_t buf_len)
 {
-  static const mz_uint32 s_crc32[16] = { 0, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
-    0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c };
   mz_uint32 crcu32 = (mz_uint32)crc;
   if (!ptr) return MZ_CRC32_INIT;
-  crcu32 = ~crcu32; while (buf_len--) { mz_uint8 b = *ptr++; crcu32 = (crcu32 >> 4) ^ s_crc32[(crcu32 & 0xF) ^ (b & 0xF)]; crcu32 = (crcu32 >> 4) ^ s_crc32[(crcu32 & 0xF) ^ (b >> 4)]; }
-  return ~crcu32;
+  crcu32 = ~crcu32;
+#if MINIZ_USE_X86_SIMD
+  if ((buf_len >= 64) && (mz_cpu_features() & MZ_CPU_PCLMUL))
+  {
+    size_t n = buf_len & ~(size_t)15;
+    crcu32 = mz_crc32_pclmul(crcu32, ptr, n); ptr += n; buf_len -= n;
+  }
+#endif
+  return ~mz_crc32_slice8(crcu32, ptr, buf_len);
+}
+
+mz_ulong mz_adler32_combine(mz_ulong adler1, mz_ulong adler2, size_t len2)
+{
+  mz_uint32 rem = (mz_uint32)(len2 % 65521U), s1 = (mz_uint32)(adler1 & 0xffff), s2 = (mz_uint32)((rem * (mz_uint64)s1) % 65521U);
+  s1 += (mz_uint32)(adler2 & 0xffff) + 65521U - 1;
+  s2 += (mz_uint32)((adler1 >> 16) & 0xffff) + (mz_uint32)((adler2 >> 16) & 0xffff) + 65521U - rem;
+  if (s1 >= 65521U) s1 -= 65521U;
+  if (s1 >= 65521U) s1 -= 65521U;
+  if (s2 >= (65521U << 1)) s2 -= (65521U << 1);
+  if (s2 >= 65521U) s2 -= 65521U;
+  return (s2 << 16) | s1;
+}
+
+// CRC-32 combination by repeated squaring of the "append one zero bit" operator over GF(2), as in zlib's crc32_combine().
+static mz_uint32 mz_gf2_matrix_times(const mz_uint32 *pMat, mz_uint32 vec)
+{
+  mz_uint32 sum = 0;
+  for ( ; vec; vec >>= 1, pMat++) if (vec & 1) sum ^= *pMat;
+  return sum;
+}
+
+static void mz_gf2_matrix_square(mz_uint32 *pSquare, const mz_uint32 *pMat)
+{
+  int n; for (n = 0; n < 32; n++) pSquare[n] = mz_gf2_matrix_times(pMat, pMat[n]);
+}
+
+mz_ulong mz_crc32_combine(mz_ulong crc1, mz_ulong crc2, size_t len2)
+{
+  mz_uint32 even[32], odd[32], row = 1, crcu32 = (mz_uint32)crc1; int n;
+  if (!len2) return crc1;
+  odd[0] = 0xEDB88320; for (n = 1; n < 32; n++, row <<= 1) odd[n] = row;
+  mz_gf2_matrix_square(even, odd); // 2 zero bits
+  mz_gf2_matrix_square(odd, even); // 4 zero bits
+  do
+  {
+    mz_gf2_matrix_square(even, odd); if (len2 & 1) crcu32 = mz_gf2_matrix_times(even, crcu32);
+    if (!(len2 >>= 1)) break;
+    mz_gf2_matrix_square(odd, even); if (len2 & 1) crcu32 = mz_gf2_matrix_times(odd, crcu32);
+    len2 >>= 1;
+  } while (len2);
+  return crcu32 ^ (mz_uint32)crc2;
 }
 
 void mz_free(void *p)
@@ -1681,19 +2245,8 @@ common_exit:
   *pIn_buf_size = pIn_buf_cur - pIn_buf_next; *pOut_buf_size = pOut_buf_cur - pOut_buf_next;
   if ((decomp_flags & (TINFL_FLAG_PARSE_ZLIB_HEADER | TINFL_FLAG_COMPUTE_ADLER32)) && (status >= 0))
   {
-    const mz_uint8 *ptr = pOut_buf_next; size_t buf_len = *pOut_buf_size;
-    mz_uint32 i, s1 = r->m_check_adler32 & 0xffff, s2 = r->m_check_adler32 >> 16; size_t block_len = buf_len % 5552;
-    while (buf_len)
-    {
-      for (i = 0; i + 7 < block_len; i += 8, ptr += 8)
-      {
-        s1 += ptr[0], s2 += s1; s1 += ptr[1], s2 += s1; s1 += ptr[2], s2 += s1; s1 += ptr[3], s2 += s1;
-        s1 += ptr[4], s2 += s1; s1 += ptr[5], s2 += s1; s1 += ptr[6], s2 += s1; s1 += ptr[7], s2 += s1;
-      }
-      for ( ; i < block_len; ++i) s1 += *ptr++, s2 += s1;
-      s1 %= 65521U, s2 %= 65521U; buf_len -= block_len; block_len = 5552;
-    }
-    r->m_check_adler32 = (s2 << 16) + s1; if ((status == TINFL_STATUS_DONE) && (decomp_flags & TINFL_FLAG_PARSE_ZLIB_HEADER) && (r->m_check_adler32 != r->m_z_adler32)) status = TINFL_STATUS_ADLER32_MISMATCH;
+    if (*pOut_buf_size) r->m_check_adler32 = (mz_uint32)mz_adler32(r->m_check_adler32, pOut_buf_next, *pOut_buf_size);
+    if ((status == TINFL_STATUS_DONE) && (decomp_flags & TINFL_FLAG_PARSE_ZLIB_HEADER) && (r->m_check_adler32 != r->m_z_adler32)) status = TINFL_STATUS_ADLER32_MISMATCH;
   }
   return status;
 }
@@ -2773,6 +3326,223 @@ size_t tdefl_compress_mem_to_mem(void *pOut_buf, size_t out_buf_len, const void
   return out_buf.m_size;
 }
 
+tdefl_status tdefl_set_dictionary(tdefl_compressor *d, const void *pDict, size_t dict_size)
+{
+  const mz_uint8 *pSrc = (const mz_uint8 *)pDict; mz_uint i, n;
+  if ((!d) || ((dict_size) && (!pDict)) || (d->m_lookahead_pos) || (d->m_lookahead_size) || (d->m_block_index)) return TDEFL_STATUS_BAD_PARAM;
+  n = (mz_uint)MZ_MIN(dict_size, (size_t)TDEFL_LZ_DICT_SIZE);
+  pSrc += dict_size - n;
+  memcpy(d->m_dict, pSrc, n);
+  memcpy(d->m_dict + TDEFL_LZ_DICT_SIZE, d->m_dict, MZ_MIN(n, TDEFL_MAX_MATCH_LEN - 1));
+  // Insert every complete trigram into the hash the matching compressor will search. The last two positions are inserted by the compressor
+  // itself once the following input bytes arrive, exactly as if the dictionary had been compressed.
+#if MINIZ_USE_UNALIGNED_LOADS_AND_STORES && MINIZ_LITTLE_ENDIAN
+  if (((d->m_flags & TDEFL_MAX_PROBES_MASK) == 1) && ((d->m_flags & TDEFL_GREEDY_PARSING_FLAG) != 0) && ((d->m_flags & (TDEFL_FILTER_MATCHES | TDEFL_FORCE_ALL_RAW_BLOCKS | TDEFL_RLE_MATCHES)) == 0))
+  {
+    for (i = 0; i + 2 < n; i++)
+    {
+      mz_uint first_trigram = d->m_dict[i] | (d->m_dict[i + 1] << 8) | (d->m_dict[i + 2] << 16);
+      d->m_hash[(first_trigram ^ (first_trigram >> (24 - (TDEFL_LZ_HASH_BITS - 8)))) & TDEFL_LEVEL1_HASH_SIZE_MASK] = (mz_uint16)i;
+    }
+  }
+  else
+#endif
+  {
+    for (i = 0; i + 2 < n; i++)
+    {
+      mz_uint hash = ((d->m_dict[i] << (TDEFL_LZ_HASH_SHIFT * 2)) ^ (d->m_dict[i + 1] << TDEFL_LZ_HASH_SHIFT) ^ d->m_dict[i + 2]) & (TDEFL_LZ_HASH_SIZE - 1);
+      d->m_next[i] = d->m_hash[hash]; d->m_hash[hash] = (mz_uint16)i;
+    }
+  }
+  d->m_lookahead_pos = d->m_lz_code_buf_dict_pos = d->m_dict_size = n;
+  return TDEFL_STATUS_OKAY;
+}
+
+// ------------------- Parallel job helper (one atomic job counter shared by a handful of short-lived threads)
+
+typedef void (*mz_parallel_func)(void *pUser, mz_uint job_index);
+
+typedef struct
+{
+  mz_parallel_func m_pFunc;
+  void *m_pUser;
+  mz_uint m_num_jobs;
+  volatile long m_next_job;
+} mz_parallel_state;
+
+#ifndef MINIZ_NO_THREADS
+#ifdef _WIN32
+  #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+  #endif
+  #include <windows.h>
+  #include <process.h>
+  #define MZ_ATOMIC_FETCH_INC(p) (InterlockedIncrement(p) - 1)
+#else
+  #include <pthread.h>
+  #define MZ_ATOMIC_FETCH_INC(p) __sync_fetch_and_add(p, 1)
+#endif
+#else
+  #define MZ_ATOMIC_FETCH_INC(p) ((*(p))++)
+#endif
+
+static void mz_parallel_worker(mz_parallel_state *pState)
+{
+  long job;
+  while ((job = MZ_ATOMIC_FETCH_INC(&pState->m_next_job)) < (long)pState->m_num_jobs)
+    pState->m_pFunc(pState->m_pUser, (mz_uint)job);
+}
+
+#ifndef MINIZ_NO_THREADS
+#ifdef _WIN32
+static unsigned __stdcall mz_parallel_thread(void *p) { mz_parallel_worker((mz_parallel_state *)p); return 0; }
+#else
+static void *mz_parallel_thread(void *p) { mz_parallel_worker((mz_parallel_state *)p); return NULL; }
+#endif
+#endif
+
+// Runs pFunc(pUser, 0..num_jobs-1) on up to num_threads threads, the calling thread included. Returns once every job has finished.
+// If threads can't be created the remaining jobs simply run on the calling thread.
+static void mz_parallel_for(mz_uint num_jobs, mz_uint num_threads, mz_parallel_func pFunc, void *pUser)
+{
+  enum { MZ_PARALLEL_MAX_THREADS = 64 };
+  mz_parallel_state state;
+  mz_uint i, num_started = 0;
+  state.m_pFunc = pFunc; state.m_pUser = pUser; state.m_num_jobs = num_jobs; state.m_next_job = 0;
+  num_threads = MZ_MIN(MZ_MIN(num_threads, num_jobs), (mz_uint)MZ_PARALLEL_MAX_THREADS);
+#ifndef MINIZ_NO_THREADS
+  {
+#ifdef _WIN32
+    HANDLE threads[MZ_PARALLEL_MAX_THREADS];
+    for (i = 1; i < num_threads; i++, num_started++)
+      if (!(threads[num_started] = (HANDLE)_beginthreadex(NULL, 0, mz_parallel_thread, &state, 0, NULL))) break;
+    mz_parallel_worker(&state);
+    for (i = 0; i < num_started; i++) { WaitForSingleObject(threads[i], INFINITE); CloseHandle(threads[i]); }
+#else
+    pthread_t threads[MZ_PARALLEL_MAX_THREADS];
+    for (i = 1; i < num_threads; i++, num_started++)
+      if (pthread_create(&threads[num_started], NULL, mz_parallel_thread, &state) != 0) break;
+    mz_parallel_worker(&state);
+    for (i = 0; i < num_started; i++) pthread_join(threads[i], NULL);
+#endif
+  }
+#else
+  (void)i; (void)num_started; (void)num_threads;
+  mz_parallel_worker(&state);
+#endif
+}
+
+// ------------------- Parallel (block split) compression
+
+typedef struct
+{
+  const mz_uint8 *m_pSrc;
+  size_t m_src_len, m_block_size;
+  mz_uint m_first_block, m_total_blocks;
+  int m_flags;
+  tdefl_output_buffer *m_pOut;
+  mz_uint32 *m_pCheck;
+  volatile long m_failed;
+} tdefl_parallel_batch;
+
+static void tdefl_parallel_compress_block(void *pUser, mz_uint job_index)
+{
+  tdefl_parallel_batch *pBatch = (tdefl_parallel_batch *)pUser;
+  mz_uint block = pBatch->m_first_block + job_index;
+  size_t ofs = (size_t)block * pBatch->m_block_size, len = MZ_MIN(pBatch->m_block_size, pBatch->m_src_len - ofs);
+  const mz_uint8 *pBlock = pBatch->m_pSrc + ofs;
+  mz_bool last = (block + 1 == pBatch->m_total_blocks);
+  tdefl_compressor *pComp;
+
+  if (pBatch->m_failed) return;
+  if (pBatch->m_flags & TDEFL_WRITE_GZIP_HEADER)
+    pBatch->m_pCheck[job_index] = (mz_uint32)mz_crc32(MZ_CRC32_INIT, pBlock, len);
+  else if (pBatch->m_flags & TDEFL_WRITE_ZLIB_HEADER)
+    pBatch->m_pCheck[job_index] = (mz_uint32)mz_adler32(MZ_ADLER32_INIT, pBlock, len);
+
+  if (NULL == (pComp = (tdefl_compressor*)MZ_MALLOC(sizeof(tdefl_compressor)))) { pBatch->m_failed = 1; return; }
+  if ((tdefl_init(pComp, tdefl_output_buffer_putter, &pBatch->m_pOut[job_index], pBatch->m_flags & ~(TDEFL_WRITE_ZLIB_HEADER | TDEFL_WRITE_GZIP_HEADER | TDEFL_COMPUTE_ADLER32)) != TDEFL_STATUS_OKAY) ||
+      (tdefl_set_dictionary(pComp, pBlock - MZ_MIN(ofs, (size_t)TDEFL_LZ_DICT_SIZE), MZ_MIN(ofs, (size_t)TDEFL_LZ_DICT_SIZE)) != TDEFL_STATUS_OKAY) ||
+      (tdefl_compress_buffer(pComp, pBlock, len, last ? TDEFL_FINISH : TDEFL_SYNC_FLUSH) != (last ? TDEFL_STATUS_DONE : TDEFL_STATUS_OKAY)))
+    pBatch->m_failed = 1;
+  MZ_FREE(pComp);
+}
+
+mz_bool tdefl_compress_mem_to_output_parallel(const void *pBuf, size_t buf_len, tdefl_put_buf_func_ptr pPut_buf_func, void *pPut_buf_user, int flags, mz_uint num_threads, size_t block_size)
+{
+  tdefl_parallel_batch batch;
+  mz_uint batch_size, i, block;
+  mz_uint32 check = (flags & TDEFL_WRITE_GZIP_HEADER) ? MZ_CRC32_INIT : MZ_ADLER32_INIT;
+  mz_uint8 trailer[8];
+  mz_bool succeeded = MZ_TRUE;
+
+  if (((buf_len) && (!pBuf)) || (!pPut_buf_func)) return MZ_FALSE;
+  if (!block_size) block_size = TDEFL_PARALLEL_DEFAULT_BLOCK_SIZE;
+  if ((num_threads = MZ_MAX(num_threads, 1U)) > 64) num_threads = 64;
+
+  MZ_CLEAR_OBJ(batch);
+  batch.m_pSrc = (const mz_uint8 *)pBuf; batch.m_src_len = buf_len; batch.m_block_size = block_size; batch.m_flags = flags;
+  batch.m_total_blocks = (mz_uint)MZ_MAX((buf_len + block_size - 1) / block_size, 1);
+  // A few blocks per thread per batch keeps every thread busy while bounding the compressed data held in memory.
+  batch_size = MZ_MIN(batch.m_total_blocks, num_threads * 4);
+  batch.m_pOut = (tdefl_output_buffer *)MZ_MALLOC(batch_size * sizeof(tdefl_output_buffer));
+  batch.m_pCheck = (mz_uint32 *)MZ_MALLOC(batch_size * sizeof(mz_uint32));
+  if ((!batch.m_pOut) || (!batch.m_pCheck)) { MZ_FREE(batch.m_pOut); MZ_FREE(batch.m_pCheck); return MZ_FALSE; }
+  memset(batch.m_pOut, 0, batch_size * sizeof(tdefl_output_buffer));
+
+  if (flags & TDEFL_WRITE_GZIP_HEADER)
+  {
+    static const mz_uint8 s_gzip_header[10] = { 0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF };
+    succeeded = pPut_buf_func(s_gzip_header, sizeof(s_gzip_header), pPut_buf_user);
+  }
+  else if (flags & TDEFL_WRITE_ZLIB_HEADER)
+  {
+    static const mz_uint8 s_zlib_header[2] = { 0x78, 0x01 };
+    succeeded = pPut_buf_func(s_zlib_header, sizeof(s_zlib_header), pPut_buf_user);
+  }
+
+  for (block = 0; (succeeded) && (block < batch.m_total_blocks); block += batch_size)
+  {
+    mz_uint n = MZ_MIN(batch_size, batch.m_total_blocks - block);
+    for (i = 0; i < n; i++) { batch.m_pOut[i].m_size = 0; batch.m_pOut[i].m_expandable = MZ_TRUE; }
+    batch.m_first_block = block;
+    mz_parallel_for(n, num_threads, tdefl_parallel_compress_block, &batch);
+    succeeded = !batch.m_failed;
+
+    for (i = 0; (succeeded) && (i < n); i++)
+    {
+      size_t len = MZ_MIN(block_size, buf_len - (size_t)(block + i) * block_size);
+      if (batch.m_pOut[i].m_size) succeeded = pPut_buf_func(batch.m_pOut[i].m_pBuf, (int)batch.m_pOut[i].m_size, pPut_buf_user);
+      if (flags & TDEFL_WRITE_GZIP_HEADER) check = (mz_uint32)mz_crc32_combine(check, batch.m_pCheck[i], len);
+      else if (flags & TDEFL_WRITE_ZLIB_HEADER) check = (mz_uint32)mz_adler32_combine(check, batch.m_pCheck[i], len);
+    }
+  }
+
+  if ((succeeded) && (flags & TDEFL_WRITE_GZIP_HEADER))
+  {
+    for (i = 0; i < 4; i++) { trailer[i] = (mz_uint8)(check >> (i * 8)); trailer[4 + i] = (mz_uint8)((mz_uint64)buf_len >> (i * 8)); }
+    succeeded = pPut_buf_func(trailer, 8, pPut_buf_user);
+  }
+  else if ((succeeded) && (flags & TDEFL_WRITE_ZLIB_HEADER))
+  {
+    for (i = 0; i < 4; i++) trailer[i] = (mz_uint8)(check >> (24 - i * 8));
+    succeeded = pPut_buf_func(trailer, 4, pPut_buf_user);
+  }
+
+  for (i = 0; i < batch_size; i++) MZ_FREE(batch.m_pOut[i].m_pBuf);
+  MZ_FREE(batch.m_pOut); MZ_FREE(batch.m_pCheck);
+  return succeeded;
+}
+
+void *tdefl_compress_mem_to_heap_parallel(const void *pSrc_buf, size_t src_buf_len, size_t *pOut_len, int flags, mz_uint num_threads, size_t block_size)
+{
+  tdefl_output_buffer out_buf; MZ_CLEAR_OBJ(out_buf);
+  if (!pOut_len) return NULL; else *pOut_len = 0;
+  out_buf.m_expandable = MZ_TRUE;
+  if (!tdefl_compress_mem_to_output_parallel(pSrc_buf, src_buf_len, tdefl_output_buffer_putter, &out_buf, flags, num_threads, block_size)) { MZ_FREE(out_buf.m_pBuf); return NULL; }
+  *pOut_len = out_buf.m_size; return out_buf.m_pBuf;
+}
+
 #ifndef MINIZ_NO_ZLIB_APIS
 static const mz_uint s_tdefl_num_probes[11] = { 0, 1, 6, 32,  16, 32, 128, 256,  512, 768, 1500 };
 
@@ -2945,6 +3715,19 @@ void *tdefl_write_image_to_png_file_in_memory(const void *pImage, int w, int h,
   #endif // #ifdef _MSC_VER
 #endif // #ifdef MINIZ_NO_STDIO
 
+#if !defined(MINIZ_NO_STDIO) && !defined(MINIZ_NO_MMAP)
+  #ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+      #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+  #else
+    #include <sys/mman.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+  #endif
+#endif
+
 #define MZ_TOLOWER(c) ((((c) >= 'A') && ((c) <= 'Z')) ? ((c) - 'A' + 'a') : (c))
 
 // Various ZIP archive enums. To completely avoid cross platform compiler alignment and platform endian issues, miniz.c doesn't use structs for any of this stuff.
@@ -2979,10 +3762,12 @@ struct mz_zip_internal_state_tag
   mz_zip_array m_central_dir;
   mz_zip_array m_central_dir_offsets;
   mz_zip_array m_sorted_central_dir_offsets;
+  mz_zip_array m_hash_index;
   MZ_FILE *m_pFile;
   void *m_pMem;
   size_t m_mem_size;
   size_t m_mem_capacity;
+  mz_bool m_mem_mapped;
 };
 
 #define MZ_ZIP_ARRAY_SET_ELEMENT_SIZE(array_ptr, element_size) (array_ptr)->m_element_size = element_size
@@ -3102,6 +3887,7 @@ static mz_bool mz_zip_reader_init_internal(mz_zip_archive *pZip, mz_uint32 flags
   MZ_ZIP_ARRAY_SET_ELEMENT_SIZE(&pZip->m_pState->m_central_dir, sizeof(mz_uint8));
   MZ_ZIP_ARRAY_SET_ELEMENT_SIZE(&pZip->m_pState->m_central_dir_offsets, sizeof(mz_uint32));
   MZ_ZIP_ARRAY_SET_ELEMENT_SIZE(&pZip->m_pState->m_sorted_central_dir_offsets, sizeof(mz_uint32));
+  MZ_ZIP_ARRAY_SET_ELEMENT_SIZE(&pZip->m_pState->m_hash_index, sizeof(mz_uint32));
   return MZ_TRUE;
 }
 
@@ -3166,6 +3952,38 @@ static void mz_zip_reader_sort_central_dir_offsets_by_filename(mz_zip_archive *p
   }
 }
 
+static MZ_FORCEINLINE mz_uint32 mz_zip_reader_hash_filename(const char *pName, mz_uint len)
+{
+  // FNV-1a of the lowercased name, so the index serves both case sensitive and insensitive lookups.
+  mz_uint32 h = 2166136261U; mz_uint i;
+  for (i = 0; i < len; ++i)
+    h = (h ^ (mz_uint8)MZ_TOLOWER(pName[i])) * 16777619U;
+  return h;
+}
+
+// Open addressing table of file_index + 1 (0 marks an empty slot), at most half full.
+static mz_bool mz_zip_reader_build_hash_index(mz_zip_archive *pZip)
+{
+  mz_zip_internal_state *pState = pZip->m_pState;
+  mz_uint i, table_size = 16;
+  mz_uint32 *pTable;
+  while (table_size < pZip->m_total_files * 2)
+    table_size <<= 1;
+  if (!mz_zip_array_resize(pZip, &pState->m_hash_index, table_size, MZ_FALSE))
+    return MZ_FALSE;
+  pTable = &MZ_ZIP_ARRAY_ELEMENT(&pState->m_hash_index, mz_uint32, 0);
+  memset(pTable, 0, table_size * sizeof(mz_uint32));
+  for (i = 0; i < pZip->m_total_files; ++i)
+  {
+    const mz_uint8 *pHeader = &MZ_ZIP_ARRAY_ELEMENT(&pState->m_central_dir, mz_uint8, MZ_ZIP_ARRAY_ELEMENT(&pState->m_central_dir_offsets, mz_uint32, i));
+    mz_uint32 slot = mz_zip_reader_hash_filename((const char *)pHeader + MZ_ZIP_CENTRAL_DIR_HEADER_SIZE, MZ_READ_LE16(pHeader + MZ_ZIP_CDH_FILENAME_LEN_OFS)) & (table_size - 1);
+    while (pTable[slot])
+      slot = (slot + 1) & (table_size - 1);
+    pTable[slot] = i + 1;
+  }
+  return MZ_TRUE;
+}
+
 static mz_bool mz_zip_reader_read_central_dir(mz_zip_archive *pZip, mz_uint32 flags)
 {
   mz_uint cdir_size, num_this_disk, cdir_disk_index;
@@ -3263,6 +4081,9 @@ static mz_bool mz_zip_reader_read_central_dir(mz_zip_archive *pZip, mz_uint32 fl
   if (sort_central_dir)
     mz_zip_reader_sort_central_dir_offsets_by_filename(pZip);
 
+  if ((flags & MZ_ZIP_FLAG_HASH_INDEX) && (!mz_zip_reader_build_hash_index(pZip)))
+    return MZ_FALSE;
+
   return MZ_TRUE;
 }
 
@@ -3350,6 +4171,61 @@ mz_bool mz_zip_reader_init_file(mz_zip_archive *pZip, const char *pFilename, mz_
 }
 #endif // #ifndef MINIZ_NO_STDIO
 
+#if !defined(MINIZ_NO_STDIO) && !defined(MINIZ_NO_MMAP)
+mz_bool mz_zip_reader_init_file_mapped(mz_zip_archive *pZip, const char *pFilename, mz_uint32 flags)
+{
+  void *pMem = NULL; mz_uint64 file_size = 0;
+#ifdef _WIN32
+  LARGE_INTEGER size;
+  HANDLE hMapping = NULL, hFile = CreateFileA(pFilename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, NULL);
+  if (hFile == INVALID_HANDLE_VALUE)
+    return MZ_FALSE;
+  if ((GetFileSizeEx(hFile, &size)) && ((file_size = (mz_uint64)size.QuadPart) != 0) && ((size_t)file_size == file_size))
+  {
+    if (NULL != (hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL)))
+      pMem = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+  }
+  // The view keeps the file mapped after both handles are closed.
+  if (hMapping) CloseHandle(hMapping);
+  CloseHandle(hFile);
+#else
+  struct stat st;
+  int fd = open(pFilename, O_RDONLY);
+  if (fd < 0)
+    return MZ_FALSE;
+  if ((!fstat(fd, &st)) && ((file_size = (mz_uint64)st.st_size) != 0) && ((size_t)file_size == file_size))
+  {
+    if (MAP_FAILED == (pMem = mmap(NULL, (size_t)file_size, PROT_READ, MAP_SHARED, fd, 0)))
+      pMem = NULL;
+  }
+  close(fd);
+#endif
+  if (!pMem)
+    return MZ_FALSE;
+  if (!mz_zip_reader_init_internal(pZip, flags))
+  {
+#ifdef _WIN32
+    UnmapViewOfFile(pMem);
+#else
+    munmap(pMem, (size_t)file_size);
+#endif
+    return MZ_FALSE;
+  }
+  pZip->m_archive_size = file_size;
+  pZip->m_pRead = mz_zip_mem_read_func;
+  pZip->m_pIO_opaque = pZip;
+  pZip->m_pState->m_pMem = pMem;
+  pZip->m_pState->m_mem_size = (size_t)file_size;
+  pZip->m_pState->m_mem_mapped = MZ_TRUE;
+  if (!mz_zip_reader_read_central_dir(pZip, flags | MZ_ZIP_FLAG_HASH_INDEX))
+  {
+    mz_zip_reader_end(pZip);
+    return MZ_FALSE;
+  }
+  return MZ_TRUE;
+}
+#endif // #if !defined(MINIZ_NO_STDIO) && !defined(MINIZ_NO_MMAP)
+
 mz_uint mz_zip_reader_get_num_files(mz_zip_archive *pZip)
 {
   return pZip ? pZip->m_total_files : 0;
@@ -3496,11 +4372,32 @@ static int mz_zip_reader_locate_file_binary_search(mz_zip_archive *pZip, const c
   return -1;
 }
 
+static int mz_zip_reader_locate_file_hash(mz_zip_archive *pZip, const char *pFilename, mz_uint flags)
+{
+  mz_zip_internal_state *pState = pZip->m_pState;
+  const mz_uint32 *pTable = &MZ_ZIP_ARRAY_ELEMENT(&pState->m_hash_index, mz_uint32, 0);
+  const mz_uint32 mask = (mz_uint32)pState->m_hash_index.m_size - 1;
+  size_t filename_len = strlen(pFilename);
+  mz_uint32 slot;
+  if (filename_len > 0xFFFF)
+    return -1;
+  for (slot = mz_zip_reader_hash_filename(pFilename, (mz_uint)filename_len) & mask; pTable[slot]; slot = (slot + 1) & mask)
+  {
+    mz_uint file_index = pTable[slot] - 1;
+    const mz_uint8 *pHeader = &MZ_ZIP_ARRAY_ELEMENT(&pState->m_central_dir, mz_uint8, MZ_ZIP_ARRAY_ELEMENT(&pState->m_central_dir_offsets, mz_uint32, file_index));
+    if ((MZ_READ_LE16(pHeader + MZ_ZIP_CDH_FILENAME_LEN_OFS) == filename_len) && (mz_zip_reader_string_equal(pFilename, (const char *)pHeader + MZ_ZIP_CENTRAL_DIR_HEADER_SIZE, (mz_uint)filename_len, flags)))
+      return (int)file_index;
+  }
+  return -1;
+}
+
 int mz_zip_reader_locate_file(mz_zip_archive *pZip, const char *pName, const char *pComment, mz_uint flags)
 {
   mz_uint file_index; size_t name_len, comment_len;
   if ((!pZip) || (!pZip->m_pState) || (!pName) || (pZip->m_zip_mode != MZ_ZIP_MODE_READING))
     return -1;
+  if (((flags & MZ_ZIP_FLAG_IGNORE_PATH) == 0) && (!pComment) && (pZip->m_pState->m_hash_index.m_size))
+    return mz_zip_reader_locate_file_hash(pZip, pName, flags);
   if (((flags & (MZ_ZIP_FLAG_IGNORE_PATH | MZ_ZIP_FLAG_CASE_SENSITIVE)) == 0) && (!pComment) && (pZip->m_pState->m_sorted_central_dir_offsets.m_size))
     return mz_zip_reader_locate_file_binary_search(pZip, pName);
   name_len = strlen(pName); if (name_len > 0xFFFF) return -1;
@@ -3671,6 +4568,36 @@ mz_bool mz_zip_reader_extract_file_to_mem_no_alloc(mz_zip_archive *pZip, const c
   return mz_zip_reader_extract_to_mem_no_alloc(pZip, file_index, pBuf, buf_size, flags, pUser_read_buf, user_read_buf_size);
 }
 
+const void *mz_zip_reader_extract_to_ptr(mz_zip_archive *pZip, mz_uint file_index, size_t *pSize, mz_uint flags)
+{
+  const mz_uint8 *p = mz_zip_reader_get_cdh(pZip, file_index), *pLocal_header;
+  mz_uint64 cur_file_ofs, comp_size;
+  if (pSize)
+    *pSize = 0;
+  if ((!p) || (!pZip->m_pState->m_pMem))
+    return NULL;
+
+  // Only stored data can be handed out as is, and encryption and patch files are not supported.
+  if ((MZ_READ_LE16(p + MZ_ZIP_CDH_BIT_FLAG_OFS) & (1 | 32)) || ((!(flags & MZ_ZIP_FLAG_COMPRESSED_DATA)) && (MZ_READ_LE16(p + MZ_ZIP_CDH_METHOD_OFS) != 0)))
+    return NULL;
+
+  // Parse the local directory entry in place to find where the data starts.
+  comp_size = MZ_READ_LE32(p + MZ_ZIP_CDH_COMPRESSED_SIZE_OFS);
+  cur_file_ofs = MZ_READ_LE32(p + MZ_ZIP_CDH_LOCAL_HEADER_OFS);
+  if ((cur_file_ofs + MZ_ZIP_LOCAL_DIR_HEADER_SIZE) > pZip->m_archive_size)
+    return NULL;
+  pLocal_header = (const mz_uint8 *)pZip->m_pState->m_pMem + cur_file_ofs;
+  if (MZ_READ_LE32(pLocal_header) != MZ_ZIP_LOCAL_DIR_HEADER_SIG)
+    return NULL;
+  cur_file_ofs += MZ_ZIP_LOCAL_DIR_HEADER_SIZE + MZ_READ_LE16(pLocal_header + MZ_ZIP_LDH_FILENAME_LEN_OFS) + MZ_READ_LE16(pLocal_header + MZ_ZIP_LDH_EXTRA_LEN_OFS);
+  if ((cur_file_ofs + comp_size) > pZip->m_archive_size)
+    return NULL;
+
+  if (pSize)
+    *pSize = (size_t)comp_size;
+  return (const mz_uint8 *)pZip->m_pState->m_pMem + cur_file_ofs;
+}
+
 mz_bool mz_zip_reader_extract_to_mem(mz_zip_archive *pZip, mz_uint file_index, void *pBuf, size_t buf_size, mz_uint flags)
 {
   return mz_zip_reader_extract_to_mem_no_alloc(pZip, file_index, pBuf, buf_size, flags, NULL, 0);
@@ -3935,6 +4862,7 @@ mz_bool mz_zip_reader_end(mz_zip_archive *pZip)
     mz_zip_array_clear(pZip, &pState->m_central_dir);
     mz_zip_array_clear(pZip, &pState->m_central_dir_offsets);
     mz_zip_array_clear(pZip, &pState->m_sorted_central_dir_offsets);
+    mz_zip_array_clear(pZip, &pState->m_hash_index);
 
 #ifndef MINIZ_NO_STDIO
     if (pState->m_pFile)
@@ -3942,6 +4870,17 @@ mz_bool mz_zip_reader_end(mz_zip_archive *pZip)
       MZ_FCLOSE(pState->m_pFile);
       pState->m_pFile = NULL;
     }
+#ifndef MINIZ_NO_MMAP
+    if (pState->m_mem_mapped)
+    {
+#ifdef _WIN32
+      UnmapViewOfFile(pState->m_pMem);
+#else
+      munmap(pState->m_pMem, pState->m_mem_size);
+#endif
+      pState->m_pMem = NULL;
+    }
+#endif
 #endif // #ifndef MINIZ_NO_STDIO
 
     pZip->m_pFree(pZip->m_pAlloc_opaque, pState);
@@ -3997,6 +4936,7 @@ mz_bool mz_zip_writer_init(mz_zip_archive *pZip, mz_uint64 existing_size)
   MZ_ZIP_ARRAY_SET_ELEMENT_SIZE(&pZip->m_pState->m_central_dir, sizeof(mz_uint8));
   MZ_ZIP_ARRAY_SET_ELEMENT_SIZE(&pZip->m_pState->m_central_dir_offsets, sizeof(mz_uint32));
   MZ_ZIP_ARRAY_SET_ELEMENT_SIZE(&pZip->m_pState->m_sorted_central_dir_offsets, sizeof(mz_uint32));
+  MZ_ZIP_ARRAY_SET_ELEMENT_SIZE(&pZip->m_pState->m_hash_index, sizeof(mz_uint32));
   return MZ_TRUE;
 }
 
@@ -4113,6 +5053,11 @@ mz_bool mz_zip_writer_init_from_reader(mz_zip_archive *pZip, const char *pFilena
     }
 #endif // #ifdef MINIZ_NO_STDIO
   }
+  else if (pState->m_mem_mapped)
+  {
+    // Read only file mapping - reopen the archive with mz_zip_reader_init_file() to append to it.
+    return MZ_FALSE;
+  }
   else if (pState->m_pMem)
   {
     // Archive lives in a memory block. Assume it's from the heap that we can resize using the realloc callback.
@@ -4138,6 +5083,129 @@ mz_bool mz_zip_writer_add_mem(mz_zip_archive *pZip, const char *pArchive_name, c
   return mz_zip_writer_add_mem_ex(pZip, pArchive_name, pBuf, buf_size, NULL, 0, level_and_flags, 0, 0);
 }
 
+typedef struct
+{
+  mz_zip_archive *m_pZip;
+  mz_uint8 *m_pBuf;
+  size_t m_size, m_capacity;
+} mz_zip_writer_batch_output;
+
+// Like tdefl_output_buffer_putter(), but grows the buffer with the archive's realloc callback.
+static mz_bool mz_zip_writer_batch_put_buf_func(const void *pBuf, int len, void *pUser)
+{
+  mz_zip_writer_batch_output *p = (mz_zip_writer_batch_output *)pUser;
+  size_t new_size = p->m_size + len;
+  if (new_size > p->m_capacity)
+  {
+    size_t new_capacity = p->m_capacity; void *pNew_buf;
+    do { new_capacity = MZ_MAX(128U, new_capacity << 1U); } while (new_size > new_capacity);
+    if (NULL == (pNew_buf = p->m_pZip->m_pRealloc(p->m_pZip->m_pAlloc_opaque, p->m_pBuf, 1, new_capacity))) return MZ_FALSE;
+    p->m_pBuf = (mz_uint8 *)pNew_buf; p->m_capacity = new_capacity;
+  }
+  memcpy(p->m_pBuf + p->m_size, pBuf, len); p->m_size = new_size;
+  return MZ_TRUE;
+}
+
+typedef struct
+{
+  mz_zip_archive *m_pZip;
+  const void * const *m_ppBufs;
+  const size_t *m_pBuf_sizes;
+  const mz_uint *m_pJobs;
+  mz_zip_writer_batch_output *m_pOut;
+  mz_uint32 *m_pCrc32;
+  int m_comp_flags;
+} mz_zip_writer_batch;
+
+static void mz_zip_writer_batch_free_output(mz_zip_writer_batch_output *pOut)
+{
+  if (pOut->m_pBuf) pOut->m_pZip->m_pFree(pOut->m_pZip->m_pAlloc_opaque, pOut->m_pBuf);
+  pOut->m_pBuf = NULL; pOut->m_size = pOut->m_capacity = 0;
+}
+
+static void mz_zip_writer_batch_compress(void *pUser, mz_uint job_index)
+{
+  mz_zip_writer_batch *pBatch = (mz_zip_writer_batch *)pUser;
+  mz_zip_archive *pZip = pBatch->m_pZip;
+  mz_uint file_index = pBatch->m_pJobs[job_index];
+  mz_zip_writer_batch_output *pOut = &pBatch->m_pOut[file_index];
+  tdefl_compressor *pComp;
+
+  pBatch->m_pCrc32[file_index] = (mz_uint32)mz_crc32(MZ_CRC32_INIT, (const mz_uint8 *)pBatch->m_ppBufs[file_index], pBatch->m_pBuf_sizes[file_index]);
+  // A NULL output buffer marks the entry as failed.
+  if (NULL == (pComp = (tdefl_compressor *)pZip->m_pAlloc(pZip->m_pAlloc_opaque, 1, sizeof(tdefl_compressor))))
+    return;
+  if ((tdefl_init(pComp, mz_zip_writer_batch_put_buf_func, pOut, pBatch->m_comp_flags) != TDEFL_STATUS_OKAY) ||
+      (tdefl_compress_buffer(pComp, pBatch->m_ppBufs[file_index], pBatch->m_pBuf_sizes[file_index], TDEFL_FINISH) != TDEFL_STATUS_DONE))
+    mz_zip_writer_batch_free_output(pOut);
+  pZip->m_pFree(pZip->m_pAlloc_opaque, pComp);
+}
+
+mz_bool mz_zip_writer_add_mem_batch(mz_zip_archive *pZip, mz_uint num_files, const char * const *ppArchive_names, const void * const *ppBufs, const size_t *pBuf_sizes, mz_uint level_and_flags, mz_uint num_threads)
+{
+  mz_zip_writer_batch batch;
+  mz_uint i, level, num_jobs = 0, *pJobs;
+  mz_bool status = MZ_TRUE;
+
+  if ((!pZip) || (!pZip->m_pState) || (pZip->m_zip_mode != MZ_ZIP_MODE_WRITING) || ((num_files) && ((!ppArchive_names) || (!ppBufs) || (!pBuf_sizes))))
+    return MZ_FALSE;
+  if ((int)level_and_flags < 0)
+    level_and_flags = MZ_DEFAULT_LEVEL;
+  level = level_and_flags & 0xF;
+  if ((!level) || (level_and_flags & MZ_ZIP_FLAG_COMPRESSED_DATA) || (level > MZ_UBER_COMPRESSION) || (num_threads <= 1))
+  {
+    for (i = 0; (status) && (i < num_files); i++)
+      status = mz_zip_writer_add_mem(pZip, ppArchive_names[i], ppBufs[i], pBuf_sizes[i], level_and_flags);
+    return status;
+  }
+
+  MZ_CLEAR_OBJ(batch);
+  batch.m_pZip = pZip; batch.m_ppBufs = ppBufs; batch.m_pBuf_sizes = pBuf_sizes;
+  batch.m_comp_flags = (int)tdefl_create_comp_flags_from_zip_params(level, -15, MZ_DEFAULT_STRATEGY);
+  batch.m_pJobs = pJobs = (mz_uint *)pZip->m_pAlloc(pZip->m_pAlloc_opaque, num_files, sizeof(mz_uint));
+  batch.m_pOut = (mz_zip_writer_batch_output *)pZip->m_pAlloc(pZip->m_pAlloc_opaque, num_files, sizeof(mz_zip_writer_batch_output));
+  batch.m_pCrc32 = (mz_uint32 *)pZip->m_pAlloc(pZip->m_pAlloc_opaque, num_files, sizeof(mz_uint32));
+  if ((!pJobs) || (!batch.m_pOut) || (!batch.m_pCrc32))
+    status = MZ_FALSE;
+  else
+  {
+    memset(batch.m_pOut, 0, num_files * sizeof(mz_zip_writer_batch_output));
+    for (i = 0; i < num_files; i++) batch.m_pOut[i].m_pZip = pZip;
+
+    // Large entries are compressed one after the other, each split across all threads.
+    for (i = 0; (status) && (i < num_files); i++)
+    {
+      if (pBuf_sizes[i] <= 3) continue; // stored by mz_zip_writer_add_mem_ex()
+      if (pBuf_sizes[i] < (size_t)TDEFL_PARALLEL_DEFAULT_BLOCK_SIZE * 2) { pJobs[num_jobs++] = i; continue; }
+      batch.m_pCrc32[i] = (mz_uint32)mz_crc32(MZ_CRC32_INIT, (const mz_uint8 *)ppBufs[i], pBuf_sizes[i]);
+      if (!tdefl_compress_mem_to_output_parallel(ppBufs[i], pBuf_sizes[i], mz_zip_writer_batch_put_buf_func, &batch.m_pOut[i], batch.m_comp_flags, num_threads, 0))
+      {
+        mz_zip_writer_batch_free_output(&batch.m_pOut[i]);
+        status = MZ_FALSE;
+      }
+    }
+
+    // The rest are compressed concurrently, one entry per thread at a time.
+    if (status)
+      mz_parallel_for(num_jobs, num_threads, mz_zip_writer_batch_compress, &batch);
+
+    for (i = 0; (status) && (i < num_files); i++)
+    {
+      if (pBuf_sizes[i] <= 3)
+        status = mz_zip_writer_add_mem(pZip, ppArchive_names[i], ppBufs[i], pBuf_sizes[i], level_and_flags);
+      else
+        status = (batch.m_pOut[i].m_pBuf != NULL) && mz_zip_writer_add_mem_ex(pZip, ppArchive_names[i], batch.m_pOut[i].m_pBuf, batch.m_pOut[i].m_size, NULL, 0, level_and_flags | MZ_ZIP_FLAG_COMPRESSED_DATA, pBuf_sizes[i], batch.m_pCrc32[i]);
+    }
+  }
+
+  if (batch.m_pOut)
+    for (i = 0; i < num_files; i++) mz_zip_writer_batch_free_output(&batch.m_pOut[i]);
+  if (pJobs) pZip->m_pFree(pZip->m_pAlloc_opaque, pJobs);
+  if (batch.m_pOut) pZip->m_pFree(pZip->m_pAlloc_opaque, batch.m_pOut);
+  if (batch.m_pCrc32) pZip->m_pFree(pZip->m_pAlloc_opaque, batch.m_pCrc32);
+  return status;
+}
+
 typedef struct
 {
   mz_zip_archive *m_pZip;
@@ -4795,6 +5863,7 @@ mz_bool mz_zip_writer_end(mz_zip_archive *pZip)
   mz_zip_array_clear(pZip, &pState->m_central_dir);
   mz_zip_array_clear(pZip, &pState->m_central_dir_offsets);
   mz_zip_array_clear(pZip, &pState->m_sorted_central_dir_offsets);
+  mz_zip_array_clear(pZip, &pState->m_hash_index);
 
 #ifndef MINIZ_NO_STDIO
   if (pState->m_pFile)
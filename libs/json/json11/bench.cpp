@@ -0,0 +1,166 @@
+// Streaming vs DOM throughput on newline-delimited JSON.
+//
+//   bench [file.ndjson] [--no-dom]
+//
+// Without a file, a synthetic 64 MB input is generated in a temporary file. Pass --no-dom for
+// inputs too large to hold in memory twice (text + DOM).
+
+#define _FILE_OFFSET_BITS 64
+
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <vector>
+#include "json11.hpp"
+
+using namespace json11;
+using std::string;
+
+static double now() {
+    using namespace std::chrono;
+    return duration_cast<duration<double>>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Size of a file that may be larger than 2 GB, or -1 on failure.
+static int64_t file_size(FILE *fp) {
+#ifdef _WIN32
+    if (_fseeki64(fp, 0, SEEK_END) != 0)
+        return -1;
+    return _ftelli64(fp);
+#else
+    if (fseeko(fp, 0, SEEK_END) != 0)
+        return -1;
+    return ftello(fp);
+#endif
+}
+
+static void report(const char *name, double secs, int64_t bytes, size_t records) {
+    printf("%-24s %8.3f s %10.1f MB/s %12zu records\n",
+           name, secs, bytes / (1024.0 * 1024.0) / secs, records);
+}
+
+struct CountingHandler : public JsonHandler {
+    size_t records = 0;
+    size_t values = 0;
+    bool null_value()                   { values++; return true; }
+    bool bool_value(bool)               { values++; return true; }
+    bool number_value(double)           { values++; return true; }
+    bool string_value(const string &)   { values++; return true; }
+    bool end_document()                 { records++; return true; }
+};
+
+static string generate(size_t megabytes) {
+    string name = "json11-bench.ndjson";
+    FILE *fp = fopen(name.c_str(), "wb");
+    if (!fp)
+        return string();
+
+    size_t target = megabytes * 1024 * 1024, written = 0;
+    JsonWriter writer([&](const char *data, size_t len) { written += fwrite(data, 1, len, fp); });
+    for (int id = 0; written < target; id++) {
+        Json record = Json::object {
+            { "id", id },
+            { "time", 1441234567.0 + id * 0.25 },
+            { "level", (id % 7) ? "info" : "warning" },
+            { "message", "request served \"/index.html\" in \\u00b5s" },
+            { "tags", Json::array { "http", "frontend", id % 3 == 0 } },
+            { "extra", Json::object { { "bytes", id * 13 }, { "cached", nullptr } } },
+        };
+        writer.write(record).end_document();
+    }
+    writer.flush();
+    fclose(fp);
+    return name;
+}
+
+int main(int argc, char **argv) {
+    string path;
+    bool dom = true, temporary = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--no-dom"))
+            dom = false;
+        else
+            path = argv[i];
+    }
+    if (path.empty()) {
+        path = generate(64);
+        temporary = true;
+    }
+
+    FILE *fp = fopen(path.c_str(), "rb");
+    if (!fp) {
+        fprintf(stderr, "cannot open %s\n", path.c_str());
+        return 1;
+    }
+    const int64_t size = file_size(fp);
+    if (size < 0) {
+        fprintf(stderr, "cannot determine the size of %s\n", path.c_str());
+        fclose(fp);
+        return 1;
+    }
+    if (dom && (uint64_t)size > SIZE_MAX) {
+        fprintf(stderr, "%s is too large to hold in memory, skipping DOM\n", path.c_str());
+        dom = false;
+    }
+
+    std::vector<char> chunk(64 * 1024);
+    auto stream = [&](JsonHandler &handler) {
+        fseek(fp, 0, SEEK_SET);
+        JsonReader reader(handler, true);
+        size_t n;
+        while ((n = fread(chunk.data(), 1, chunk.size(), fp)) > 0)
+            if (!reader.feed(chunk.data(), n))
+                break;
+        if (!reader.finish())
+            fprintf(stderr, "parse error at %zu: %s\n", reader.offset(), reader.error().c_str());
+    };
+
+    // SAX events only
+    {
+        CountingHandler handler;
+        double t0 = now();
+        stream(handler);
+        report("stream (events)", now() - t0, size, handler.records);
+    }
+
+    // One Json per record, re-serialized through a reusable writer buffer
+    {
+        size_t records = 0, out_bytes = 0;
+        JsonWriter writer([&](const char *, size_t len) { out_bytes += len; });
+        JsonBuilder builder([&](Json &&value) {
+            records++;
+            writer.write(value).end_document();
+            return true;
+        });
+        double t0 = now();
+        stream(builder);
+        writer.flush();
+        report("stream (DOM per record)", now() - t0, size, records);
+    }
+
+    // Whole file as text, then one DOM for everything, then dump() into one string
+    if (dom) {
+        double t0 = now();
+        string text((size_t)size, '\0');
+        fseek(fp, 0, SEEK_SET);
+        if (fread(&text[0], 1, (size_t)size, fp) != (size_t)size)
+            fprintf(stderr, "short read\n");
+        string err;
+        std::vector<Json> values = Json::parse_multi(text, err);
+        if (!err.empty())
+            fprintf(stderr, "parse error: %s\n", err.c_str());
+        string out;
+        for (auto &value : values) {
+            value.dump(out);
+            out += "\n";
+        }
+        report("DOM (parse_multi)", now() - t0, size, values.size());
+    }
+
+    fclose(fp);
+    if (temporary)
+        remove(path.c_str());
+    return 0;
+}
@@ -325,6 +325,31 @@ static inline bool in_range(long x, long lower, long upper) {
     return (x >= lower && x <= upper);
 }
 
+/* encode_utf8(pt, out)
+ *
+ * Encode pt as UTF-8 and add it to out.
+ */
+static void encode_utf8(long pt, string & out) {
+    if (pt < 0)
+        return;
+
+    if (pt < 0x80) {
+        out += pt;
+    } else if (pt < 0x800) {
+        out += (pt >> 6) | 0xC0;
+        out += (pt & 0x3F) | 0x80;
+    } else if (pt < 0x10000) {
+        out += (pt >> 12) | 0xE0;
+        out += ((pt >> 6) & 0x3F) | 0x80;
+        out += (pt & 0x3F) | 0x80;
+    } else {
+        out += (pt >> 18) | 0xF0;
+        out += ((pt >> 12) & 0x3F) | 0x80;
+        out += ((pt >> 6) & 0x3F) | 0x80;
+        out += (pt & 0x3F) | 0x80;
+    }
+}
+
 /* JsonParser
  *
  * Object that tracks all state of an in-progress parse.
@@ -376,31 +401,6 @@ struct JsonParser {
         return str[i++];
     }
 
-    /* encode_utf8(pt, out)
-     *
-     * Encode pt as UTF-8 and add it to out.
-     */
-    void encode_utf8(long pt, string & out) {
-        if (pt < 0)
-            return;
-
-        if (pt < 0x80) {
-            out += pt;
-        } else if (pt < 0x800) {
-            out += (pt >> 6) | 0xC0;
-            out += (pt & 0x3F) | 0x80;
-        } else if (pt < 0x10000) {
-            out += (pt >> 12) | 0xE0;
-            out += ((pt >> 6) & 0x3F) | 0x80;
-            out += (pt & 0x3F) | 0x80;
-        } else {
-            out += (pt >> 18) | 0xF0;
-            out += ((pt >> 12) & 0x3F) | 0x80;
-            out += ((pt >> 6) & 0x3F) | 0x80;
-            out += (pt & 0x3F) | 0x80;
-        }
-    }
-
     /* parse_string()
      *
      * Parse a string, starting at the current position.
@@ -676,6 +676,596 @@ vector<Json> Json::parse_multi(const string &in, string &err) {
     return json_vec;
 }
 
+/* * * * * * * * * * * * * * * * * * * *
+ * Streaming reader
+ */
+
+/* check_number(num, err)
+ *
+ * Validate a complete number token with the same rules as JsonParser::parse_number().
+ */
+static bool check_number(const string &num, string &err) {
+    const char *p = num.c_str();
+
+    if (*p == '-')
+        p++;
+
+    if (*p == '0') {
+        p++;
+        if (in_range(*p, '0', '9')) {
+            err = "leading 0s not permitted in numbers";
+            return false;
+        }
+    } else if (in_range(*p, '1', '9')) {
+        while (in_range(*p, '0', '9'))
+            p++;
+    } else {
+        err = "invalid " + esc(*p) + " in number";
+        return false;
+    }
+
+    if (*p == '.') {
+        p++;
+        if (!in_range(*p, '0', '9')) {
+            err = "at least one digit required in fractional part";
+            return false;
+        }
+        while (in_range(*p, '0', '9'))
+            p++;
+    }
+
+    if (*p == 'e' || *p == 'E') {
+        p++;
+        if (*p == '+' || *p == '-')
+            p++;
+        if (!in_range(*p, '0', '9')) {
+            err = "at least one digit required in exponent";
+            return false;
+        }
+        while (in_range(*p, '0', '9'))
+            p++;
+    }
+
+    if (*p) {
+        err = "invalid " + esc(*p) + " in number";
+        return false;
+    }
+    return true;
+}
+
+/* continues_number(prev, ch)
+ *
+ * Whether ch can follow prev in a number token. Signs are only allowed after an exponent
+ * marker, so "1-0" is read as two values, as JsonParser::parse_number() does.
+ */
+static inline bool continues_number(char prev, char ch) {
+    if (ch == '-' || ch == '+')
+        return prev == 'e' || prev == 'E';
+    return in_range(ch, '0', '9') || ch == '.' || ch == 'e' || ch == 'E';
+}
+
+JsonReader::JsonReader(JsonHandler &handler, bool multi)
+    : m_handler(handler), m_multi(multi) {
+    reset();
+}
+
+void JsonReader::reset() {
+    m_state = m_multi ? DONE : VALUE;
+    m_documents = 0;
+    m_lex = LEX_NONE;
+    m_key = false;
+    m_failed = false;
+    m_stack.clear();
+    m_token.clear();
+    m_err.clear();
+    m_literal = nullptr;
+    m_literal_pos = 0;
+    m_last_codepoint = -1;
+    m_hex_digits = 0;
+    m_offset = 0;
+}
+
+bool JsonReader::fail(string &&msg) {
+    if (!m_failed)
+        m_err = move(msg);
+    m_failed = true;
+    return false;
+}
+
+void JsonReader::flush_codepoint() {
+    encode_utf8(m_last_codepoint, m_token);
+    m_last_codepoint = -1;
+}
+
+/* begin_value(ch)
+ *
+ * Start reading the value whose first character is ch.
+ */
+bool JsonReader::begin_value(char ch) {
+    switch (ch) {
+    case '{':
+    case '[':
+        if (m_stack.size() > (size_t)max_depth)
+            return fail("exceeded maximum nesting depth");
+        m_stack.push_back(ch);
+        m_state = (ch == '{') ? OBJECT_FIRST : ARRAY_FIRST;
+        if (!((ch == '{') ? m_handler.start_object() : m_handler.start_array()))
+            return fail("parse aborted by handler");
+        return true;
+    case '"':
+        m_lex = LEX_STRING;
+        m_key = false;
+        m_token.clear();
+        return true;
+    case 't':
+        m_literal = "true";
+        break;
+    case 'f':
+        m_literal = "false";
+        break;
+    case 'n':
+        m_literal = "null";
+        break;
+    default:
+        if (ch == '-' || in_range(ch, '0', '9')) {
+            m_lex = LEX_NUMBER;
+            m_token.assign(1, ch);
+            return true;
+        }
+        return fail("expected value, got " + esc(ch));
+    }
+
+    m_lex = LEX_LITERAL;
+    m_literal_pos = 1;
+    return true;
+}
+
+/* end_value()
+ *
+ * A value has been completed; decide what may follow it.
+ */
+bool JsonReader::end_value() {
+    if (!m_stack.empty()) {
+        m_state = AFTER_VALUE;
+        return true;
+    }
+    m_state = DONE;
+    m_documents++;
+    if (!m_handler.end_document())
+        return fail("parse aborted by handler");
+    return true;
+}
+
+bool JsonReader::end_string() {
+    m_lex = LEX_NONE;
+    if (m_key) {
+        m_state = COLON;
+        if (!m_handler.object_key(m_token))
+            return fail("parse aborted by handler");
+        return true;
+    }
+    if (!m_handler.string_value(m_token))
+        return fail("parse aborted by handler");
+    return end_value();
+}
+
+bool JsonReader::end_number() {
+    m_lex = LEX_NONE;
+    string err;
+    if (!check_number(m_token, err))
+        return fail(move(err));
+
+    double value;
+    if (m_token.find_first_of(".eE") == string::npos
+            && m_token.size() <= (size_t)std::numeric_limits<int>::digits10) {
+        value = std::atoi(m_token.c_str());
+    } else {
+        value = std::atof(m_token.c_str());
+    }
+
+    if (!m_handler.number_value(value))
+        return fail("parse aborted by handler");
+    return end_value();
+}
+
+bool JsonReader::end_container(char open) {
+    m_stack.pop_back();
+    if (!((open == '{') ? m_handler.end_object() : m_handler.end_array()))
+        return fail("parse aborted by handler");
+    return end_value();
+}
+
+bool JsonReader::feed(const char *data, size_t len) {
+    size_t i = 0;
+
+    while (i < len && !m_failed) {
+        switch (m_lex) {
+        case LEX_STRING: {
+            // The usual case: copy a run of non-escaped characters in one go
+            const size_t start = i;
+            while (i < len && data[i] != '"' && data[i] != '\\' && !in_range(data[i], 0, 0x1f))
+                i++;
+            if (i != start) {
+                flush_codepoint();
+                m_token.append(data + start, i - start);
+            }
+            if (i == len)
+                break;
+
+            const char ch = data[i++];
+            if (ch == '"') {
+                flush_codepoint();
+                end_string();
+            } else if (ch == '\\') {
+                m_lex = LEX_ESCAPE;
+            } else {
+                fail("unescaped " + esc(ch) + " in string");
+            }
+            break;
+        }
+
+        case LEX_ESCAPE: {
+            const char ch = data[i++];
+            if (ch == 'u') {
+                m_lex = LEX_UNICODE;
+                m_hex_digits = 0;
+                break;
+            }
+
+            flush_codepoint();
+            m_lex = LEX_STRING;
+
+            if (ch == 'b') {
+                m_token += '\b';
+            } else if (ch == 'f') {
+                m_token += '\f';
+            } else if (ch == 'n') {
+                m_token += '\n';
+            } else if (ch == 'r') {
+                m_token += '\r';
+            } else if (ch == 't') {
+                m_token += '\t';
+            } else if (ch == '"' || ch == '\\' || ch == '/') {
+                m_token += ch;
+            } else {
+                fail("invalid escape character " + esc(ch));
+            }
+            break;
+        }
+
+        case LEX_UNICODE: {
+            const char ch = data[i++];
+            m_hex[m_hex_digits] = ch;
+            m_hex[m_hex_digits + 1] = 0;
+            if (!in_range(ch, 'a', 'f') && !in_range(ch, 'A', 'F') && !in_range(ch, '0', '9')) {
+                fail("bad \\u escape: " + string(m_hex));
+                break;
+            }
+            if (++m_hex_digits < 4)
+                break;
+
+            long codepoint = strtol(m_hex, nullptr, 16);
+
+            // Surrogate pairs are reassembled exactly as in JsonParser::parse_string().
+            if (in_range(m_last_codepoint, 0xD800, 0xDBFF)
+                    && in_range(codepoint, 0xDC00, 0xDFFF)) {
+                encode_utf8((((m_last_codepoint - 0xD800) << 10)
+                             | (codepoint - 0xDC00)) + 0x10000, m_token);
+                m_last_codepoint = -1;
+            } else {
+                flush_codepoint();
+                m_last_codepoint = codepoint;
+            }
+            m_lex = LEX_STRING;
+            break;
+        }
+
+        case LEX_NUMBER: {
+            const size_t start = i;
+            char prev = m_token.back();
+            while (i < len && continues_number(prev, data[i]))
+                prev = data[i++];
+            m_token.append(data + start, i - start);
+            // The number ends at the first other character, which is left for the next round
+            if (i != len)
+                end_number();
+            break;
+        }
+
+        case LEX_LITERAL: {
+            const char ch = data[i++];
+            if (ch != m_literal[m_literal_pos]) {
+                fail("parse error: expected " + string(m_literal) + ", got "
+                     + string(m_literal, m_literal_pos) + ch);
+                break;
+            }
+            if (m_literal[++m_literal_pos])
+                break;
+
+            m_lex = LEX_NONE;
+            bool ok;
+            if (m_literal[0] == 'n')
+                ok = m_handler.null_value();
+            else
+                ok = m_handler.bool_value(m_literal[0] == 't');
+            if (!ok)
+                fail("parse aborted by handler");
+            else
+                end_value();
+            break;
+        }
+
+        case LEX_NONE: {
+            const char ch = data[i++];
+            if (ch == ' ' || ch == '\r' || ch == '\n' || ch == '\t')
+                break;
+
+            switch (m_state) {
+            case DONE:
+                if (!m_multi) {
+                    fail("unexpected trailing " + esc(ch));
+                    break;
+                }
+                begin_value(ch);
+                break;
+
+            case ARRAY_FIRST:
+                if (ch == ']') {
+                    end_container('[');
+                    break;
+                }
+                begin_value(ch);
+                break;
+
+            case VALUE:
+                begin_value(ch);
+                break;
+
+            case OBJECT_FIRST:
+            case OBJECT_KEY:
+                if (ch == '}' && m_state == OBJECT_FIRST) {
+                    end_container('{');
+                } else if (ch == '"') {
+                    m_lex = LEX_STRING;
+                    m_key = true;
+                    m_token.clear();
+                } else {
+                    fail("expected '\"' in object, got " + esc(ch));
+                }
+                break;
+
+            case COLON:
+                if (ch == ':')
+                    m_state = VALUE;
+                else
+                    fail("expected ':' in object, got " + esc(ch));
+                break;
+
+            case AFTER_VALUE:
+                if (m_stack.back() == '[') {
+                    if (ch == ']')
+                        end_container('[');
+                    else if (ch == ',')
+                        m_state = VALUE;
+                    else
+                        fail("expected ',' in list, got " + esc(ch));
+                } else {
+                    if (ch == '}')
+                        end_container('{');
+                    else if (ch == ',')
+                        m_state = OBJECT_KEY;
+                    else
+                        fail("expected ',' in object, got " + esc(ch));
+                }
+                break;
+            }
+            break;
+        }
+        }
+    }
+
+    m_offset += i;
+    return !m_failed;
+}
+
+bool JsonReader::finish() {
+    if (m_failed)
+        return false;
+
+    // A top-level number can only be told complete at the end of the input
+    if (m_lex == LEX_NUMBER && m_stack.empty())
+        end_number();
+    else if (m_lex == LEX_STRING || m_lex == LEX_ESCAPE || m_lex == LEX_UNICODE)
+        fail("unexpected end of input in string");
+    else if (m_lex != LEX_NONE || m_state != DONE)
+        fail("unexpected end of input");
+    // Like Json::parse_multi, only completely empty input may hold no document at all
+    else if (m_documents == 0 && m_offset != 0)
+        fail("unexpected end of input");
+
+    return !m_failed;
+}
+
+/* * * * * * * * * * * * * * * * * * * *
+ * DOM builder
+ */
+
+bool JsonBuilder::add(Json &&value) {
+    if (m_frames.empty())
+        return m_cb(move(value));
+
+    Frame &top = m_frames.back();
+    if (top.is_object)
+        top.object[move(top.key)] = move(value);
+    else
+        top.array.push_back(move(value));
+    return true;
+}
+
+bool JsonBuilder::null_value()                    { return add(Json()); }
+bool JsonBuilder::bool_value(bool value)          { return add(Json(value)); }
+bool JsonBuilder::number_value(double value)      { return add(Json(value)); }
+bool JsonBuilder::string_value(const string &str) { return add(Json(str)); }
+
+bool JsonBuilder::object_key(const string &key) {
+    m_frames.back().key = key;
+    return true;
+}
+
+bool JsonBuilder::start_object() {
+    m_frames.push_back(Frame { true, {}, {}, {} });
+    return true;
+}
+
+bool JsonBuilder::start_array() {
+    m_frames.push_back(Frame { false, {}, {}, {} });
+    return true;
+}
+
+bool JsonBuilder::end_object() {
+    Json value(move(m_frames.back().object));
+    m_frames.pop_back();
+    return add(move(value));
+}
+
+bool JsonBuilder::end_array() {
+    Json value(move(m_frames.back().array));
+    m_frames.pop_back();
+    return add(move(value));
+}
+
+/* * * * * * * * * * * * * * * * * * * *
+ * Streaming writer
+ */
+
+JsonWriter::JsonWriter(sink out, size_t buffer_size)
+    : m_sink(move(out)), m_capacity(buffer_size), m_after_key(false) {
+    m_buf.reserve(buffer_size + 64);
+}
+
+void JsonWriter::flush() {
+    if (!m_buf.empty()) {
+        m_sink(m_buf.data(), m_buf.size());
+        m_buf.clear();
+    }
+}
+
+/* separate()
+ *
+ * Emit the separator due before the next value.
+ */
+void JsonWriter::separate() {
+    if (m_after_key) {
+        m_after_key = false;
+    } else if (!m_first.empty()) {
+        if (!m_first.back())
+            m_buf += ", ";
+        m_first.back() = false;
+    }
+}
+
+JsonWriter & JsonWriter::write_null() {
+    separate();
+    json11::dump(nullptr, m_buf);
+    maybe_flush();
+    return *this;
+}
+
+JsonWriter & JsonWriter::write(double value) {
+    separate();
+    json11::dump(value, m_buf);
+    maybe_flush();
+    return *this;
+}
+
+JsonWriter & JsonWriter::write(int value) {
+    separate();
+    json11::dump(value, m_buf);
+    maybe_flush();
+    return *this;
+}
+
+JsonWriter & JsonWriter::write(bool value) {
+    separate();
+    json11::dump(value, m_buf);
+    maybe_flush();
+    return *this;
+}
+
+JsonWriter & JsonWriter::write(const string &value) {
+    separate();
+    json11::dump(value, m_buf);
+    maybe_flush();
+    return *this;
+}
+
+JsonWriter & JsonWriter::write(const Json &value) {
+    // Containers are walked here rather than dumped whole, so the buffer can be flushed
+    // between their elements.
+    if (value.is_array()) {
+        start_array();
+        for (auto &item : value.array_items())
+            write(item);
+        return end_array();
+    }
+
+    if (value.is_object()) {
+        start_object();
+        for (auto &kv : value.object_items()) {
+            key(kv.first);
+            write(kv.second);
+        }
+        return end_object();
+    }
+
+    separate();
+    value.dump(m_buf);
+    maybe_flush();
+    return *this;
+}
+
+JsonWriter & JsonWriter::key(const string &key) {
+    separate();
+    json11::dump(key, m_buf);
+    m_buf += ": ";
+    m_after_key = true;
+    return *this;
+}
+
+JsonWriter & JsonWriter::start_object() {
+    separate();
+    m_buf += "{";
+    m_first.push_back(true);
+    return *this;
+}
+
+JsonWriter & JsonWriter::end_object() {
+    m_buf += "}";
+    m_first.pop_back();
+    maybe_flush();
+    return *this;
+}
+
+JsonWriter & JsonWriter::start_array() {
+    separate();
+    m_buf += "[";
+    m_first.push_back(true);
+    return *this;
+}
+
+JsonWriter & JsonWriter::end_array() {
+    m_buf += "]";
+    m_first.pop_back();
+    maybe_flush();
+    return *this;
+}
+
+JsonWriter & JsonWriter::end_document() {
+    m_buf += "\n";
+    maybe_flush();
+    return *this;
+}
+
 /* * * * * * * * * * * * * * * * * * * *
  * Shape-checking
  */
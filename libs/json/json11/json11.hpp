@@ -54,6 +54,7 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <functional>
 #include <initializer_list>
 
 #ifdef _MSC_VER
@@ -203,4 +204,171 @@ protected:
     virtual ~JsonValue() {}
 };
 
+/* * * * * * * * * * * * * * * * * * * *
+ * Streaming
+ *
+ * JsonReader is an event-driven (SAX-style) parser. Input is handed over in chunks of any
+ * size, split at any byte, as it arrives from a file or socket; only the token currently being
+ * read (a string or a number) and the stack of open containers are buffered. Each value is
+ * reported to a JsonHandler as soon as it is complete.
+ *
+ * JsonWriter is the streaming counterpart of Json::dump. It appends into a reusable buffer and
+ * hands it to a sink callback whenever it fills up, producing the same text as dump() would.
+ */
+
+/* JsonHandler
+ *
+ * Receives parse events from a JsonReader. Every callback returns true to continue parsing or
+ * false to abort it. The default implementations ignore the event.
+ */
+class JsonHandler {
+public:
+    virtual ~JsonHandler() {}
+    virtual bool null_value()                         { return true; }
+    virtual bool bool_value(bool)                     { return true; }
+    virtual bool number_value(double)                 { return true; }
+    virtual bool string_value(const std::string &)    { return true; }
+    virtual bool object_key(const std::string &)      { return true; }
+    virtual bool start_object()                       { return true; }
+    virtual bool end_object()                         { return true; }
+    virtual bool start_array()                        { return true; }
+    virtual bool end_array()                          { return true; }
+    // Called after each complete top-level value.
+    virtual bool end_document()                       { return true; }
+};
+
+/* JsonBuilder
+ *
+ * JsonHandler that materializes every top-level value as a Json and passes it to a callback,
+ * so multi-document input (e.g. newline-delimited JSON) can be processed one record at a time.
+ */
+class JsonBuilder : public JsonHandler {
+public:
+    typedef std::function<bool (Json && value)> callback;
+    explicit JsonBuilder(callback cb) : m_cb(std::move(cb)) {}
+
+    bool null_value();
+    bool bool_value(bool value);
+    bool number_value(double value);
+    bool string_value(const std::string &value);
+    bool object_key(const std::string &key);
+    bool start_object();
+    bool end_object();
+    bool start_array();
+    bool end_array();
+
+private:
+    struct Frame {
+        bool is_object;
+        Json::array array;
+        Json::object object;
+        std::string key;
+    };
+    bool add(Json && value);
+
+    callback m_cb;
+    std::vector<Frame> m_frames;
+};
+
+/* JsonReader
+ *
+ * Incremental parser. Call feed() for every chunk of input and finish() once the input is
+ * exhausted. Both return false once the parse has failed; error() then describes why. With
+ * multi set, any number of whitespace-separated top-level values is accepted, as in
+ * Json::parse_multi.
+ */
+class JsonReader final {
+public:
+    explicit JsonReader(JsonHandler &handler, bool multi = false);
+
+    bool feed(const char * data, size_t len);
+    bool feed(const std::string & chunk) { return feed(chunk.data(), chunk.size()); }
+    bool finish();
+
+    // Forget all parse state so the reader can be used on a new input.
+    void reset();
+
+    bool failed() const { return m_failed; }
+    const std::string & error() const { return m_err; }
+    // Number of input bytes consumed so far.
+    size_t offset() const { return m_offset; }
+
+private:
+    enum State { VALUE, ARRAY_FIRST, OBJECT_FIRST, OBJECT_KEY, COLON, AFTER_VALUE, DONE };
+    enum Lex { LEX_NONE, LEX_STRING, LEX_ESCAPE, LEX_UNICODE, LEX_NUMBER, LEX_LITERAL };
+
+    bool fail(std::string && msg);
+    bool begin_value(char ch);
+    bool end_value();
+    bool end_string();
+    bool end_number();
+    bool end_container(char open);
+    void flush_codepoint();
+
+    JsonHandler &m_handler;
+    bool m_multi;
+    State m_state;
+    size_t m_documents;
+    Lex m_lex;
+    bool m_key;
+    bool m_failed;
+    std::vector<char> m_stack;
+    std::string m_token;
+    std::string m_err;
+    const char * m_literal;
+    size_t m_literal_pos;
+    long m_last_codepoint;
+    int m_hex_digits;
+    char m_hex[5];
+    size_t m_offset;
+};
+
+/* JsonWriter
+ *
+ * Streaming serializer. Values are written with the same formatting as Json::dump; commas and
+ * colons are inserted automatically. Buffered output reaches the sink when the buffer grows past
+ * buffer_size, on flush(), and on destruction.
+ */
+class JsonWriter final {
+public:
+    typedef std::function<void (const char * data, size_t len)> sink;
+    explicit JsonWriter(sink out, size_t buffer_size = 64 * 1024);
+    ~JsonWriter() { flush(); }
+
+    JsonWriter(const JsonWriter &) = delete;
+    JsonWriter & operator= (const JsonWriter &) = delete;
+
+    JsonWriter & write_null();
+    JsonWriter & write(double value);
+    JsonWriter & write(int value);
+    JsonWriter & write(bool value);
+    JsonWriter & write(const std::string & value);
+    JsonWriter & write(const char * value) { return write(std::string(value)); }
+    JsonWriter & write(const Json & value);
+
+    JsonWriter & key(const std::string & key);
+    JsonWriter & start_object();
+    JsonWriter & end_object();
+    JsonWriter & start_array();
+    JsonWriter & end_array();
+
+    // Terminate a top-level value with a newline (newline-delimited JSON).
+    JsonWriter & end_document();
+
+    void flush();
+
+private:
+    void separate();
+    void maybe_flush() {
+        if (m_buf.size() >= m_capacity)
+            flush();
+    }
+
+    sink m_sink;
+    size_t m_capacity;
+    std::string m_buf;
+    std::vector<bool> m_first;
+    bool m_after_key;
+};
+
 } // namespace json11
@@ -112,4 +112,63 @@ int main(int argc, char **argv) {
     std::vector<Point> points = { { 1, 2 }, { 10, 20 }, { 100, 200 } };
     std::string points_json = Json(points).dump();
     printf("%s\n", points_json.c_str());
+
+    // Streaming reader: feeding one byte at a time must give the same values as the DOM parser
+    auto stream_parse = [](const string &in, size_t chunk, bool multi, string &err) {
+        std::vector<Json> values;
+        JsonBuilder builder([&](Json &&value) { values.push_back(std::move(value)); return true; });
+        JsonReader reader(builder, multi);
+        for (size_t i = 0; i < in.size(); i += chunk)
+            reader.feed(in.data() + i, std::min(chunk, in.size() - i));
+        reader.finish();
+        err = reader.error();
+        return values;
+    };
+
+    for (size_t chunk : { 1, 3, 64 }) {
+        auto streamed = stream_parse(simple_test, chunk, false, err);
+        assert(err.empty() && streamed.size() == 1 && streamed[0] == json);
+
+        streamed = stream_parse(unicode_escape_test, chunk, false, err);
+        assert(err.empty() && streamed.size() == 1 && streamed[0] == uni);
+
+        const string multi_test = "{\"a\": 1}\n[2, 3.5e2]\n-4 \"five\" null\n";
+        streamed = stream_parse(multi_test, chunk, true, err);
+        assert(err.empty() && streamed == Json::parse_multi(multi_test, err));
+    }
+
+    stream_parse("[1, 2", 1, false, err);
+    assert(!err.empty());
+    stream_parse("{\"k\" 1}", 1, false, err);
+    assert(!err.empty());
+    stream_parse("01", 1, false, err);
+    assert(!err.empty());
+    stream_parse("[] []", 1, false, err);
+    assert(!err.empty());
+
+    // Multi-document mode follows Json::parse_multi on whitespace-only input and adjacent numbers
+    for (const string in : { " \n", "1-0", "1e-5-3", "1+0" }) {
+        string dom_err;
+        const auto dom = Json::parse_multi(in, dom_err);
+        const auto streamed = stream_parse(in, 1, true, err);
+        assert(err.empty() == dom_err.empty());
+        assert(!err.empty() || streamed == dom);
+    }
+    assert(stream_parse("1-0", 1, true, err).size() == 2 && err.empty());
+    stream_parse(" \n", 1, true, err);
+    assert(!err.empty());
+
+    // Streaming writer: output matches dump() regardless of buffer size
+    for (size_t buffer_size : { 1, 16, 4096 }) {
+        string streamed;
+        {
+            JsonWriter writer([&](const char *data, size_t len) { streamed.append(data, len); },
+                              buffer_size);
+            writer.write(obj);
+            writer.end_document();
+            writer.start_object().key("k1").write("v1").key("k2").write(42)
+                  .key("k3").start_array().write(true).write_null().end_array().end_object();
+        }
+        assert(streamed == obj.dump() + "\n" + R"({"k1": "v1", "k2": 42, "k3": [true, null]})");
+    }
 }
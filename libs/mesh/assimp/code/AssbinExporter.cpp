@@ -0,0 +1,555 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2012, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms, 
+with or without modification, are permitted provided that the 
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  AssbinExporter.cpp
+ *  Assimp Binary (assbin) exporter. See assbin_chunks.h for the file format.
+ */
+
+#include "AssimpPCH.h"
+
+#if !defined(ASSIMP_BUILD_NO_EXPORT) && !defined(ASSIMP_BUILD_NO_ASSBIN_EXPORTER)
+
+#include <ctime>
+
+#include "AssbinExporter.h"
+#include "assbin_chunks.h"
+#include "ByteSwap.h"
+#include "../include/assimp/version.h"
+
+using namespace Assimp;
+namespace Assimp	{
+
+// ------------------------------------------------------------------------------------------------
+// Worker function for exporting a scene to assbin. Prototyped and registered in Exporter.cpp
+void ExportSceneAssbin(const char* pFile,IOSystem* pIOSystem, const aiScene* pScene)
+{
+	// invoke the exporter 
+	AssbinExporter exporter(pScene);
+
+	// we're still here - export successfully completed. Write the file.
+	boost::scoped_ptr<IOStream> outfile (pIOSystem->Open(pFile,"wb"));
+	if(outfile == NULL) {
+		throw DeadlyExportError("could not open output .assbin file: " + std::string(pFile));
+	}
+
+	if (outfile->Write(&exporter.mOutput[0], exporter.mOutput.size(), 1) != 1) {
+		throw DeadlyExportError("could not write output .assbin file: " + std::string(pFile));
+	}
+}
+
+} // end of namespace Assimp
+
+// ------------------------------------------------------------------------------------------------
+AssbinExporter :: AssbinExporter(const aiScene* pScene)
+{
+	// header, see WriteBinaryDump() in assimp_cmd
+	char buff[256] = {0};
+	const time_t tt = ::time(NULL);
+	::strcpy(buff,"ASSIMP.binary-dump.");
+	::strncpy(buff+19,::asctime(::gmtime(&tt)),25);
+	WriteBytes(buff,44);
+	// == 44 bytes
+
+	WriteU4(ASSBIN_VERSION_MAJOR);
+	WriteU4(ASSBIN_VERSION_MINOR);
+	WriteU4(aiGetVersionRevision());
+	WriteU4(aiGetCompileFlags());
+	WriteU2(0); // shortened
+	WriteU2(0); // compressed
+	// ==  20 bytes
+
+	// no source file name and command line
+	::memset(buff,0,256);
+	WriteBytes(buff,256);
+	WriteBytes(buff,128);
+
+	// leave 64 bytes free for future extensions
+	::memset(buff,0xcd,64);
+	WriteBytes(buff,64);
+
+	// ==== total header size: 512 bytes
+	ai_assert(mOutput.size()==ASSBIN_HEADER_LENGTH);
+
+	const size_t scene = BeginChunk(ASSBIN_CHUNK_AISCENE);
+
+	// basic scene information
+	WriteU4(pScene->mFlags);
+	WriteU4(pScene->mNumMeshes);
+	WriteU4(pScene->mNumMaterials);
+	WriteU4(pScene->mNumAnimations);
+	WriteU4(pScene->mNumTextures);
+	WriteU4(pScene->mNumLights);
+	WriteU4(pScene->mNumCameras);
+
+	WriteNode(pScene->mRootNode);
+	for (unsigned int i = 0; i < pScene->mNumMeshes;++i) {
+		WriteMesh(pScene->mMeshes[i]);
+	}
+	for (unsigned int i = 0; i < pScene->mNumMaterials;++i) {
+		WriteMaterial(pScene->mMaterials[i]);
+	}
+	for (unsigned int i = 0; i < pScene->mNumAnimations;++i) {
+		WriteAnimation(pScene->mAnimations[i]);
+	}
+	for (unsigned int i = 0; i < pScene->mNumTextures;++i) {
+		WriteTexture(pScene->mTextures[i]);
+	}
+	for (unsigned int i = 0; i < pScene->mNumLights;++i) {
+		WriteLight(pScene->mLights[i]);
+	}
+	for (unsigned int i = 0; i < pScene->mNumCameras;++i) {
+		WriteCamera(pScene->mCameras[i]);
+	}
+
+	EndChunk(scene);
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinExporter :: WriteNode(const aiNode* node)
+{
+	const size_t chunk = BeginChunk(ASSBIN_CHUNK_AINODE);
+
+	WriteString(node->mName);
+	WriteMatrix(node->mTransformation);
+	WriteU4(node->mNumChildren);
+	WriteU4(node->mNumMeshes);
+	WriteArray4(node->mMeshes,node->mNumMeshes);
+
+	for (unsigned int i = 0; i < node->mNumChildren;++i) {
+		WriteNode(node->mChildren[i]);
+	}
+
+	const aiMetadata* md = node->mMetaData;
+	if (md && md->mNumProperties) {
+		const size_t extra = BeginChunk(ASSBIN_CHUNK_AIEXTRA);
+		WriteU4(md->mNumProperties);
+
+		for (unsigned int i = 0; i < md->mNumProperties;++i) {
+			const aiMetadataEntry& e = md->mValues[i];
+			WriteString(md->mKeys[i]);
+			WriteU2(static_cast<uint16_t>(e.mType));
+
+			// entries without a value are written as zero
+			switch (e.mType)
+			{
+			case AI_BOOL:
+				{
+					const uint8_t b = e.mData && *static_cast<const bool*>(e.mData);
+					WriteBytes(&b,1);
+				}
+				break;
+			case AI_INT:
+				WriteU4(e.mData ? *static_cast<const int*>(e.mData) : 0);
+				break;
+			case AI_UINT64:
+				{
+					uint64_t u = e.mData ? *static_cast<const uint64_t*>(e.mData) : 0;
+					AI_SWAP8(u);
+					WriteBytes(&u,8);
+				}
+				break;
+			case AI_FLOAT:
+				WriteF4(e.mData ? *static_cast<const float*>(e.mData) : 0.f);
+				break;
+			case AI_AISTRING:
+				WriteString(e.mData ? *static_cast<const aiString*>(e.mData) : aiString());
+				break;
+			case AI_AIVECTOR3D:
+				WriteVector(e.mData ? *static_cast<const aiVector3D*>(e.mData) : aiVector3D());
+				break;
+			default:
+				throw DeadlyExportError("assbin: unknown metadata type");
+			}
+		}
+		EndChunk(extra);
+	}
+
+	EndChunk(chunk);
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinExporter :: WriteMesh(const aiMesh* mesh)
+{
+	const size_t chunk = BeginChunk(ASSBIN_CHUNK_AIMESH);
+
+	WriteU4(mesh->mPrimitiveTypes);
+	WriteU4(mesh->mNumVertices);
+	WriteU4(mesh->mNumFaces);
+	WriteU4(mesh->mNumBones);
+	WriteU4(mesh->mMaterialIndex);
+
+	// first of all, write bits for all existent vertex components
+	unsigned int c = 0;
+	if (mesh->mVertices) {
+		c |= ASSBIN_MESH_HAS_POSITIONS;
+	}
+	if (mesh->mNormals) {
+		c |= ASSBIN_MESH_HAS_NORMALS;
+	}
+	if (mesh->mTangents && mesh->mBitangents) {
+		c |= ASSBIN_MESH_HAS_TANGENTS_AND_BITANGENTS;
+	}
+	for (unsigned int n = 0; n < AI_MAX_NUMBER_OF_TEXTURECOORDS && mesh->mTextureCoords[n];++n) {
+		c |= ASSBIN_MESH_HAS_TEXCOORD(n);
+	}
+	for (unsigned int n = 0; n < AI_MAX_NUMBER_OF_COLOR_SETS && mesh->mColors[n];++n) {
+		c |= ASSBIN_MESH_HAS_COLOR(n);
+	}
+	WriteU4(c);
+
+	const size_t nv = mesh->mNumVertices;
+	if (mesh->mVertices) {
+		WriteArray4(mesh->mVertices,nv*3);
+	}
+	if (mesh->mNormals) {
+		WriteArray4(mesh->mNormals,nv*3);
+	}
+	if (mesh->mTangents && mesh->mBitangents) {
+		WriteArray4(mesh->mTangents,nv*3);
+		WriteArray4(mesh->mBitangents,nv*3);
+	}
+	for (unsigned int n = 0; n < AI_MAX_NUMBER_OF_COLOR_SETS && mesh->mColors[n];++n) {
+		WriteArray4(mesh->mColors[n],nv*4);
+	}
+	for (unsigned int n = 0; n < AI_MAX_NUMBER_OF_TEXTURECOORDS && mesh->mTextureCoords[n];++n) {
+		WriteU4(mesh->mNumUVComponents[n]);
+		WriteArray4(mesh->mTextureCoords[n],nv*3);
+	}
+
+	// if there are less than 2^16 vertices, we can simply use 16 bit integers ...
+	BOOST_STATIC_ASSERT(AI_MAX_FACE_INDICES <= 0xffff);
+	const bool small = mesh->mNumVertices < (1u<<16);
+	for (unsigned int i = 0; i < mesh->mNumFaces;++i) {
+		const aiFace& f = mesh->mFaces[i];
+
+		WriteU2(static_cast<uint16_t>(f.mNumIndices));
+		if (small) {
+			for (unsigned int a = 0; a < f.mNumIndices;++a) {
+				WriteU2(static_cast<uint16_t>(f.mIndices[a]));
+			}
+		}
+		else WriteArray4(f.mIndices,f.mNumIndices);
+	}
+
+	for (unsigned int i = 0; i < mesh->mNumBones;++i) {
+		WriteBone(mesh->mBones[i]);
+	}
+
+	if (mesh->mName.length) {
+		const size_t extra = BeginChunk(ASSBIN_CHUNK_AIEXTRA);
+		WriteString(mesh->mName);
+		EndChunk(extra);
+	}
+
+	EndChunk(chunk);
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinExporter :: WriteBone(const aiBone* bone)
+{
+	const size_t chunk = BeginChunk(ASSBIN_CHUNK_AIBONE);
+
+	WriteString(bone->mName);
+	WriteU4(bone->mNumWeights);
+	WriteMatrix(bone->mOffsetMatrix);
+
+	// aiVertexWeight is an unsigned int and a float
+	BOOST_STATIC_ASSERT(sizeof(aiVertexWeight) == 8);
+	WriteArray4(bone->mWeights,bone->mNumWeights*2);
+
+	EndChunk(chunk);
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinExporter :: WriteMaterial(const aiMaterial* mat)
+{
+	const size_t chunk = BeginChunk(ASSBIN_CHUNK_AIMATERIAL);
+
+	WriteU4(mat->mNumProperties);
+	for (unsigned int i = 0; i < mat->mNumProperties;++i) {
+		WriteMaterialProperty(mat->mProperties[i]);
+	}
+
+	EndChunk(chunk);
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinExporter :: WriteMaterialProperty(const aiMaterialProperty* prop)
+{
+	const size_t chunk = BeginChunk(ASSBIN_CHUNK_AIMATERIALPROPERTY);
+
+	WriteString(prop->mKey);
+	WriteU4(prop->mSemantic);
+	WriteU4(prop->mIndex);
+	WriteU4(prop->mDataLength);
+	WriteU4(prop->mType);
+
+	switch (prop->mType)
+	{
+	case aiPTI_Float:
+	case aiPTI_Integer:
+		WriteArray4(prop->mData,prop->mDataLength/4);
+		WriteBytes(prop->mData + (prop->mDataLength & ~3u),prop->mDataLength & 3u);
+		break;
+	case aiPTI_String:
+		// 32 bit length, followed by the characters
+		if (prop->mDataLength >= 4) {
+			WriteArray4(prop->mData,1);
+			WriteBytes(prop->mData+4,prop->mDataLength-4);
+			break;
+		}
+		// fallthrough
+	default:
+		WriteBytes(prop->mData,prop->mDataLength);
+	}
+
+	EndChunk(chunk);
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinExporter :: WriteAnimation(const aiAnimation* anim)
+{
+	const size_t chunk = BeginChunk(ASSBIN_CHUNK_AIANIMATION);
+
+	WriteString(anim->mName);
+	WriteF8(anim->mDuration);
+	WriteF8(anim->mTicksPerSecond);
+	WriteU4(anim->mNumChannels);
+
+	for (unsigned int i = 0; i < anim->mNumChannels;++i) {
+		WriteNodeAnim(anim->mChannels[i]);
+	}
+
+	EndChunk(chunk);
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinExporter :: WriteNodeAnim(const aiNodeAnim* nd)
+{
+	const size_t chunk = BeginChunk(ASSBIN_CHUNK_AINODEANIM);
+
+	WriteString(nd->mNodeName);
+	WriteU4(nd->mNumPositionKeys);
+	WriteU4(nd->mNumRotationKeys);
+	WriteU4(nd->mNumScalingKeys);
+	WriteU4(nd->mPreState);
+	WriteU4(nd->mPostState);
+
+	// keys are written like WriteDumb writes them from memory, but with zeroed padding
+	static const uint32_t pad = 0;
+	for (unsigned int i = 0; i < nd->mNumPositionKeys;++i) {
+		WriteF8(nd->mPositionKeys[i].mTime);
+		WriteVector(nd->mPositionKeys[i].mValue);
+		WriteBytes(&pad,4);
+	}
+	for (unsigned int i = 0; i < nd->mNumRotationKeys;++i) {
+		const aiQuaternion& q = nd->mRotationKeys[i].mValue;
+		WriteF8(nd->mRotationKeys[i].mTime);
+		WriteF4(q.w);
+		WriteF4(q.x);
+		WriteF4(q.y);
+		WriteF4(q.z);
+	}
+	for (unsigned int i = 0; i < nd->mNumScalingKeys;++i) {
+		WriteF8(nd->mScalingKeys[i].mTime);
+		WriteVector(nd->mScalingKeys[i].mValue);
+		WriteBytes(&pad,4);
+	}
+
+	EndChunk(chunk);
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinExporter :: WriteTexture(const aiTexture* tex)
+{
+	const size_t chunk = BeginChunk(ASSBIN_CHUNK_AITEXTURE);
+
+	WriteU4(tex->mWidth);
+	WriteU4(tex->mHeight);
+	WriteBytes(tex->achFormatHint,4);
+
+	if (!tex->mHeight) {
+		WriteBytes(tex->pcData,tex->mWidth);
+	}
+	else WriteBytes(tex->pcData,tex->mWidth*tex->mHeight*4);
+
+	EndChunk(chunk);
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinExporter :: WriteLight(const aiLight* l)
+{
+	const size_t chunk = BeginChunk(ASSBIN_CHUNK_AILIGHT);
+
+	WriteString(l->mName);
+	WriteU4(l->mType);
+
+	if (l->mType != aiLightSource_DIRECTIONAL) { 
+		WriteF4(l->mAttenuationConstant);
+		WriteF4(l->mAttenuationLinear);
+		WriteF4(l->mAttenuationQuadratic);
+	}
+
+	WriteArray4(&l->mColorDiffuse,3);
+	WriteArray4(&l->mColorSpecular,3);
+	WriteArray4(&l->mColorAmbient,3);
+
+	if (l->mType == aiLightSource_SPOT) {
+		WriteF4(l->mAngleInnerCone);
+		WriteF4(l->mAngleOuterCone);
+	}
+
+	const size_t extra = BeginChunk(ASSBIN_CHUNK_AIEXTRA);
+	WriteVector(l->mPosition);
+	WriteVector(l->mDirection);
+	EndChunk(extra);
+
+	EndChunk(chunk);
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinExporter :: WriteCamera(const aiCamera* cam)
+{
+	const size_t chunk = BeginChunk(ASSBIN_CHUNK_AICAMERA);
+
+	WriteString(cam->mName);
+	WriteVector(cam->mPosition);
+	WriteVector(cam->mLookAt);
+	WriteVector(cam->mUp);
+	WriteF4(cam->mHorizontalFOV);
+	WriteF4(cam->mClipPlaneNear);
+	WriteF4(cam->mClipPlaneFar);
+	WriteF4(cam->mAspect);
+
+	EndChunk(chunk);
+}
+
+// ------------------------------------------------------------------------------------------------
+size_t AssbinExporter :: BeginChunk(uint32_t magic)
+{
+	const size_t ofs = mOutput.size();
+	WriteU4(magic);
+	WriteU4(0);
+	return ofs;
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinExporter :: EndChunk(size_t ofs)
+{
+	uint32_t len = static_cast<uint32_t>(mOutput.size() - ofs - 8);
+	if (len != mOutput.size() - ofs - 8) {
+		throw DeadlyExportError("assbin: chunk exceeds 4 GB");
+	}
+	AI_SWAP4(len);
+	::memcpy(&mOutput[ofs+4],&len,4);
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinExporter :: WriteBytes(const void* data, size_t size)
+{
+	const uint8_t* p = static_cast<const uint8_t*>(data);
+	mOutput.insert(mOutput.end(),p,p+size);
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinExporter :: WriteU2(uint16_t w)
+{
+	AI_SWAP2(w);
+	WriteBytes(&w,2);
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinExporter :: WriteU4(uint32_t w)
+{
+	AI_SWAP4(w);
+	WriteBytes(&w,4);
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinExporter :: WriteF4(float f)
+{
+	BOOST_STATIC_ASSERT(sizeof(float)==4);
+	AI_SWAP4(f);
+	WriteBytes(&f,4);
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinExporter :: WriteF8(double f)
+{
+	BOOST_STATIC_ASSERT(sizeof(double)==8);
+	AI_SWAP8(f);
+	WriteBytes(&f,8);
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinExporter :: WriteString(const aiString& s)
+{
+	WriteU4(static_cast<uint32_t>(s.length));
+	WriteBytes(s.data,s.length);
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinExporter :: WriteVector(const aiVector3D& v)
+{
+	WriteF4(v.x);
+	WriteF4(v.y);
+	WriteF4(v.z);
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinExporter :: WriteMatrix(const aiMatrix4x4& m)
+{
+	WriteArray4(&m.a1,16);
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinExporter :: WriteArray4(const void* data, size_t count)
+{
+#ifdef AI_BUILD_BIG_ENDIAN
+	const uint32_t* p = static_cast<const uint32_t*>(data);
+	for (size_t i = 0; i < count; ++i) {
+		WriteU4(p[i]);
+	}
+#else
+	WriteBytes(data,count*4);
+#endif
+}
+
+#endif // !ASSIMP_BUILD_NO_EXPORT && !ASSIMP_BUILD_NO_ASSBIN_EXPORTER
@@ -0,0 +1,116 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2012, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms, 
+with or without modification, are permitted provided that the 
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file AssbinExporter.h
+ * Declares the exporter class to write a scene to an Assimp Binary (assbin) file
+ */
+#ifndef AI_ASSBINEXPORTER_H_INC
+#define AI_ASSBINEXPORTER_H_INC
+
+#include <vector>
+
+#include "../include/assimp/types.h"
+
+struct aiScene;
+struct aiNode;
+struct aiMesh;
+struct aiBone;
+struct aiMaterial;
+struct aiMaterialProperty;
+struct aiAnimation;
+struct aiNodeAnim;
+struct aiTexture;
+struct aiLight;
+struct aiCamera;
+
+namespace Assimp	
+{
+
+// ------------------------------------------------------------------------------------------------
+/** Helper class to export a given scene to an assbin file. See assbin_chunks.h
+ *  for a description of the file format. The file is written uncompressed and 
+ *  contains all data of the scene, so it can be loaded again without any loss. */
+// ------------------------------------------------------------------------------------------------
+class AssbinExporter
+{
+public:
+	/// Constructor for a specific scene to export
+	AssbinExporter(const aiScene* pScene);
+
+public:
+
+	/// public buffer to write all output into
+	std::vector<uint8_t> mOutput;
+
+private:
+
+	void WriteNode(const aiNode* node);
+	void WriteMesh(const aiMesh* mesh);
+	void WriteBone(const aiBone* bone);
+	void WriteMaterial(const aiMaterial* mat);
+	void WriteMaterialProperty(const aiMaterialProperty* prop);
+	void WriteAnimation(const aiAnimation* anim);
+	void WriteNodeAnim(const aiNodeAnim* nd);
+	void WriteTexture(const aiTexture* tex);
+	void WriteLight(const aiLight* l);
+	void WriteCamera(const aiCamera* cam);
+
+	// start a chunk, returns the offset of its header
+	size_t BeginChunk(uint32_t magic);
+
+	// write the length of the chunk starting at the given offset
+	void EndChunk(size_t ofs);
+
+	void WriteBytes(const void* data, size_t size);
+	void WriteU2(uint16_t w);
+	void WriteU4(uint32_t w);
+	void WriteF4(float f);
+	void WriteF8(double f);
+	void WriteString(const aiString& s);
+	void WriteVector(const aiVector3D& v);
+	void WriteMatrix(const aiMatrix4x4& m);
+
+	// write an array of floats or 32 bit integers
+	void WriteArray4(const void* data, size_t count);
+};
+
+}
+
+#endif
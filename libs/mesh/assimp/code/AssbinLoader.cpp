@@ -0,0 +1,811 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2012, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms, 
+with or without modification, are permitted provided that the 
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file Implementation of the Assimp Binary (assbin) importer class */
+
+#include "AssimpPCH.h"
+#ifndef ASSIMP_BUILD_NO_ASSBIN_IMPORTER
+
+// internal headers
+#include "AssbinLoader.h"
+#include "assbin_chunks.h"
+#include "MemoryIOWrapper.h"
+#include "TinyFormatter.h"
+
+#ifndef ASSIMP_BUILD_NO_COMPRESSED_ASSBIN
+#	ifdef ASSIMP_BUILD_NO_OWN_ZLIB
+#		include <zlib.h>
+#	else
+#		include "../contrib/zlib/zlib.h"
+#	endif
+#endif
+
+using namespace Assimp;
+using namespace Assimp::Formatter;
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Zeroed array of pointers for a scene, skipped if count is 0
+template <typename T>
+void AllocArray(T**& out, unsigned int& num, unsigned int count)
+{
+	num = count;
+	if (count) {
+		out = new T*[count]();
+	}
+}
+
+static const aiImporterDesc desc = {
+	"Assimp Binary Importer",
+	"",
+	"",
+	"",
+	aiImporterFlags_SupportBinaryFlavour | aiImporterFlags_SupportCompressedFlavour,
+	ASSBIN_VERSION_MAJOR,
+	ASSBIN_VERSION_MINOR,
+	ASSBIN_VERSION_MAJOR,
+	ASSBIN_VERSION_MINOR,
+	"assbin" 
+};
+
+// beginning of the header, followed by the time the file was written
+static const char* const magic = "ASSIMP.binary-dump.";
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+// Constructor to be privately used by Importer
+AssbinImporter::AssbinImporter()
+: stream()
+{}
+
+// ------------------------------------------------------------------------------------------------
+// Destructor, private as well 
+AssbinImporter::~AssbinImporter()
+{}
+
+// ------------------------------------------------------------------------------------------------
+// Returns whether the class can handle the format of the given file. 
+bool AssbinImporter::CanRead( const std::string& pFile, IOSystem* pIOHandler, bool checkSig) const
+{
+	const std::string extension = GetExtension(pFile);
+
+	if (extension == "assbin")
+		return true;
+	else if (!extension.length() || checkSig)	{
+		if (!pIOHandler)
+			return true;
+		const char* tokens[] = {"assimp.binary-dump."};
+		return SearchFileHeaderForToken(pIOHandler,pFile,tokens,1,19);
+	}
+	return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+const aiImporterDesc* AssbinImporter::GetInfo () const
+{
+	return &desc;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Imports the given file into the given scene structure. 
+void AssbinImporter::InternReadFile( const std::string& pFile, 
+	aiScene* pScene, IOSystem* pIOHandler)
+{
+	StreamReaderLE file(pIOHandler->Open(pFile,"rb"));
+
+	// check the header, see WriteBinaryDump() in assimp_cmd
+	if (file.GetRemainingSize() < ASSBIN_HEADER_LENGTH || ::strncmp((const char*)file.GetPtr(),magic,19)) {
+		throw DeadlyImportError("assbin: not an assbin file: " + pFile);
+	}
+	file.IncPtr(44);
+
+	const unsigned int major = file.GetU4();
+	const unsigned int minor = file.GetU4();
+	if (major != ASSBIN_VERSION_MAJOR) {
+		throw DeadlyImportError((format(),"assbin: unsupported file version ",major,".",minor));
+	}
+	file.IncPtr(8); // revision and compile flags of the writer
+
+	const bool shortened = file.GetU2() != 0;
+	const bool compressed = file.GetU2() != 0;
+	if (shortened) {
+		throw DeadlyImportError("assbin: shortened dumps can't be loaded, they lack most of the data");
+	}
+	file.SetCurrentPos(ASSBIN_HEADER_LENGTH);
+
+	if (!compressed) {
+		stream = &file;
+		ReadScene(pScene);
+		return;
+	}
+
+#ifdef ASSIMP_BUILD_NO_COMPRESSED_ASSBIN
+	throw DeadlyImportError("assbin: Assimp was built without compressed assbin support");
+#else
+	// the rest of the file is compressed with DEFLATE, prefixed with its uncompressed size
+	uLongf size = file.GetU4();
+	const uLong compressedSize = file.GetRemainingSize();
+	if (!size || !compressedSize) {
+		throw DeadlyImportError("assbin: empty compressed file");
+	}
+	// DEFLATE expands data at most 1032:1, a larger size comes from a damaged file
+	if (size / 1032 > compressedSize) {
+		throw DeadlyImportError((format(),"assbin: uncompressed size ",size," doesn't fit the file size"));
+	}
+
+	uint8_t* uncompressed = new uint8_t[size];
+	if (::uncompress(uncompressed,&size,(const Bytef*)file.GetPtr(),compressedSize) != Z_OK) {
+		delete[] uncompressed;
+		throw DeadlyImportError("assbin: failed to decompress file");
+	}
+
+	StreamReaderLE data(new MemoryIOStream(uncompressed,size,true));
+	stream = &data;
+	ReadScene(pScene);
+#endif
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinImporter::ReadScene(aiScene* scene)
+{
+	const unsigned int limit = EnterChunk(ASSBIN_CHUNK_AISCENE);
+
+	// basic scene information, the arrays are zeroed so the scene can be deleted at any time
+	scene->mFlags = stream->GetU4();
+	AllocArray(scene->mMeshes,scene->mNumMeshes,CheckCount(stream->GetU4(),8));
+	AllocArray(scene->mMaterials,scene->mNumMaterials,CheckCount(stream->GetU4(),8));
+	AllocArray(scene->mAnimations,scene->mNumAnimations,CheckCount(stream->GetU4(),8));
+	AllocArray(scene->mTextures,scene->mNumTextures,CheckCount(stream->GetU4(),8));
+	AllocArray(scene->mLights,scene->mNumLights,CheckCount(stream->GetU4(),8));
+	AllocArray(scene->mCameras,scene->mNumCameras,CheckCount(stream->GetU4(),8));
+
+	scene->mRootNode = ReadNode(NULL);
+	for (unsigned int i = 0; i < scene->mNumMeshes;++i) {
+		scene->mMeshes[i] = ReadMesh();
+	}
+	for (unsigned int i = 0; i < scene->mNumMaterials;++i) {
+		scene->mMaterials[i] = ReadMaterial();
+	}
+	for (unsigned int i = 0; i < scene->mNumAnimations;++i) {
+		scene->mAnimations[i] = ReadAnimation();
+	}
+	for (unsigned int i = 0; i < scene->mNumTextures;++i) {
+		scene->mTextures[i] = ReadTexture();
+	}
+	for (unsigned int i = 0; i < scene->mNumLights;++i) {
+		scene->mLights[i] = ReadLight();
+	}
+	for (unsigned int i = 0; i < scene->mNumCameras;++i) {
+		scene->mCameras[i] = ReadCamera();
+	}
+
+	LeaveChunk(limit);
+
+	// ValidateDS is optional, so at least catch indices that would crash the application
+	for (unsigned int i = 0; i < scene->mNumMeshes;++i) {
+		if (scene->mMeshes[i]->mMaterialIndex >= scene->mNumMaterials) {
+			throw DeadlyImportError("assbin: material index out of range");
+		}
+	}
+	std::vector<const aiNode*> nodes(1,scene->mRootNode);
+	while (!nodes.empty()) {
+		const aiNode* nd = nodes.back();
+		nodes.pop_back();
+		for (unsigned int i = 0; i < nd->mNumMeshes;++i) {
+			if (nd->mMeshes[i] >= scene->mNumMeshes) {
+				throw DeadlyImportError("assbin: mesh index out of range");
+			}
+		}
+		nodes.insert(nodes.end(),nd->mChildren,nd->mChildren+nd->mNumChildren);
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+aiNode* AssbinImporter::ReadNode(aiNode* parent)
+{
+	const unsigned int limit = EnterChunk(ASSBIN_CHUNK_AINODE);
+
+	aiNode* nd = new aiNode();
+	nd->mParent = parent;
+	try {
+		ReadString(nd->mName);
+		ReadArray4(&nd->mTransformation.a1,16);
+
+		const unsigned int numChildren = CheckCount(stream->GetU4(),8);
+		const unsigned int numMeshes = CheckCount(stream->GetU4(),4);
+		if (numMeshes) {
+			nd->mMeshes = new unsigned int[numMeshes];
+			ReadArray4(nd->mMeshes,numMeshes);
+			nd->mNumMeshes = numMeshes;
+		}
+
+		if (numChildren) {
+			nd->mChildren = new aiNode*[numChildren]();
+			nd->mNumChildren = numChildren;
+			for (unsigned int i = 0; i < numChildren;++i) {
+				nd->mChildren[i] = ReadNode(nd);
+			}
+		}
+
+		unsigned int extra;
+		if (EnterExtraChunk(&extra)) {
+			const unsigned int num = CheckCount(stream->GetU4(),6);
+			if (num) {
+				aiMetadata* md = nd->mMetaData = new aiMetadata();
+				md->mKeys = new aiString[num];
+				md->mValues = new aiMetadataEntry[num];
+
+				// keep mNumProperties in sync with the entries that have a value, for the destructor
+				for (unsigned int i = 0; i < num;++i) {
+					ReadString(md->mKeys[i]);
+					aiMetadataEntry& e = md->mValues[i];
+
+					switch (e.mType = static_cast<aiMetadataType>(stream->GetU2()))
+					{
+					case AI_BOOL:
+						e.mData = new bool(stream->GetU1() != 0);
+						break;
+					case AI_INT:
+						e.mData = new int(stream->GetI4());
+						break;
+					case AI_UINT64:
+						e.mData = new uint64_t(stream->GetU8());
+						break;
+					case AI_FLOAT:
+						e.mData = new float(stream->GetF4());
+						break;
+					case AI_AISTRING:
+						{
+							aiString s;
+							ReadString(s);
+							e.mData = new aiString(s);
+						}
+						break;
+					case AI_AIVECTOR3D:
+						e.mData = new aiVector3D(ReadVector());
+						break;
+					default:
+						throw DeadlyImportError("assbin: unknown metadata type");
+					}
+					md->mNumProperties = i+1;
+				}
+			}
+			LeaveChunk(extra);
+		}
+	}
+	catch (...) {
+		delete nd;
+		throw;
+	}
+
+	LeaveChunk(limit);
+	return nd;
+}
+
+// ------------------------------------------------------------------------------------------------
+aiMesh* AssbinImporter::ReadMesh()
+{
+	const unsigned int limit = EnterChunk(ASSBIN_CHUNK_AIMESH);
+
+	aiMesh* mesh = new aiMesh();
+	try {
+		mesh->mPrimitiveTypes = stream->GetU4();
+		const unsigned int nv = mesh->mNumVertices = stream->GetU4();
+		const unsigned int numFaces = CheckCount(stream->GetU4(),2);
+		const unsigned int numBones = CheckCount(stream->GetU4(),8);
+		mesh->mMaterialIndex = stream->GetU4();
+
+		const unsigned int c = stream->GetU4();
+		if (nv > AI_MAX_VERTICES) {
+			throw DeadlyImportError("assbin: too many vertices");
+		}
+		if (c) {
+			CheckCount(nv,12);
+		}
+
+		if (c & ASSBIN_MESH_HAS_POSITIONS) {
+			mesh->mVertices = new aiVector3D[nv];
+			ReadArray4(mesh->mVertices,nv*3);
+		}
+		if (c & ASSBIN_MESH_HAS_NORMALS) {
+			mesh->mNormals = new aiVector3D[nv];
+			ReadArray4(mesh->mNormals,nv*3);
+		}
+		if (c & ASSBIN_MESH_HAS_TANGENTS_AND_BITANGENTS) {
+			mesh->mTangents = new aiVector3D[nv];
+			ReadArray4(mesh->mTangents,nv*3);
+			mesh->mBitangents = new aiVector3D[nv];
+			ReadArray4(mesh->mBitangents,nv*3);
+		}
+
+		// files written with greater AI_MAX_NUMBER_OF_xxx settings may contain more sets than we can take
+		for (unsigned int n = 0; c & ASSBIN_MESH_HAS_COLOR(n);++n) {
+			if (n >= AI_MAX_NUMBER_OF_COLOR_SETS) {
+				stream->IncPtr(CheckCount(nv,16)*16);
+				continue;
+			}
+			mesh->mColors[n] = new aiColor4D[nv];
+			ReadArray4(mesh->mColors[n],nv*4);
+		}
+		for (unsigned int n = 0; c & ASSBIN_MESH_HAS_TEXCOORD(n);++n) {
+			const unsigned int numComponents = stream->GetU4();
+			if (n >= AI_MAX_NUMBER_OF_TEXTURECOORDS) {
+				stream->IncPtr(CheckCount(nv,12)*12);
+				continue;
+			}
+			mesh->mNumUVComponents[n] = numComponents;
+			mesh->mTextureCoords[n] = new aiVector3D[nv];
+			ReadArray4(mesh->mTextureCoords[n],nv*3);
+		}
+
+		if (numFaces) {
+			mesh->mFaces = new aiFace[numFaces];
+			mesh->mNumFaces = numFaces;
+
+			const bool small = nv < (1u<<16);
+			for (unsigned int i = 0; i < numFaces;++i) {
+				aiFace& f = mesh->mFaces[i];
+
+				f.mNumIndices = CheckCount(stream->GetU2(),small ? 2 : 4);
+				if (!f.mNumIndices) {
+					continue;
+				}
+				f.mIndices = new unsigned int[f.mNumIndices];
+				if (small) {
+					for (unsigned int a = 0; a < f.mNumIndices;++a) {
+						f.mIndices[a] = stream->GetU2();
+					}
+				}
+				else ReadArray4(f.mIndices,f.mNumIndices);
+
+				for (unsigned int a = 0; a < f.mNumIndices;++a) {
+					if (f.mIndices[a] >= nv) {
+						throw DeadlyImportError("assbin: vertex index out of range");
+					}
+				}
+			}
+		}
+
+		if (numBones) {
+			mesh->mBones = new aiBone*[numBones]();
+			mesh->mNumBones = numBones;
+			for (unsigned int i = 0; i < numBones;++i) {
+				mesh->mBones[i] = ReadBone(nv);
+			}
+		}
+
+		unsigned int extra;
+		if (EnterExtraChunk(&extra)) {
+			ReadString(mesh->mName);
+			LeaveChunk(extra);
+		}
+	}
+	catch (...) {
+		delete mesh;
+		throw;
+	}
+
+	LeaveChunk(limit);
+	return mesh;
+}
+
+// ------------------------------------------------------------------------------------------------
+aiBone* AssbinImporter::ReadBone(unsigned int numVertices)
+{
+	const unsigned int limit = EnterChunk(ASSBIN_CHUNK_AIBONE);
+
+	aiBone* b = new aiBone();
+	try {
+		ReadString(b->mName);
+		const unsigned int numWeights = stream->GetU4();
+		ReadArray4(&b->mOffsetMatrix.a1,16);
+
+		if (numWeights) {
+			b->mWeights = new aiVertexWeight[CheckCount(numWeights,8)];
+			b->mNumWeights = numWeights;
+			ReadArray4(b->mWeights,numWeights*2);
+
+			for (unsigned int i = 0; i < numWeights;++i) {
+				if (b->mWeights[i].mVertexId >= numVertices) {
+					throw DeadlyImportError("assbin: bone weight index out of range");
+				}
+			}
+		}
+	}
+	catch (...) {
+		delete b;
+		throw;
+	}
+
+	LeaveChunk(limit);
+	return b;
+}
+
+// ------------------------------------------------------------------------------------------------
+aiMaterial* AssbinImporter::ReadMaterial()
+{
+	const unsigned int limit = EnterChunk(ASSBIN_CHUNK_AIMATERIAL);
+
+	aiMaterial* mat = new aiMaterial();
+	try {
+		const unsigned int num = CheckCount(stream->GetU4(),8);
+		if (num > mat->mNumAllocated) {
+			delete[] mat->mProperties;
+			mat->mProperties = new aiMaterialProperty*[num];
+			mat->mNumAllocated = num;
+		}
+		for (unsigned int i = 0; i < num;++i) {
+			mat->mProperties[i] = ReadMaterialProperty();
+			mat->mNumProperties = i+1;
+		}
+	}
+	catch (...) {
+		delete mat;
+		throw;
+	}
+
+	LeaveChunk(limit);
+	return mat;
+}
+
+// ------------------------------------------------------------------------------------------------
+aiMaterialProperty* AssbinImporter::ReadMaterialProperty()
+{
+	const unsigned int limit = EnterChunk(ASSBIN_CHUNK_AIMATERIALPROPERTY);
+
+	aiMaterialProperty* prop = new aiMaterialProperty();
+	try {
+		ReadString(prop->mKey);
+		prop->mSemantic = stream->GetU4();
+		prop->mIndex = stream->GetU4();
+		const unsigned int len = CheckCount(stream->GetU4(),1);
+		prop->mType = static_cast<aiPropertyTypeInfo>(stream->GetU4());
+
+		prop->mData = new char[len];
+		prop->mDataLength = len;
+		stream->CopyAndAdvance(prop->mData,len);
+
+#ifdef AI_BUILD_BIG_ENDIAN
+		switch (prop->mType)
+		{
+		case aiPTI_Float:
+		case aiPTI_Integer:
+			for (unsigned int i = 0; i+4 <= len; i += 4) {
+				ByteSwap::Swap4(prop->mData+i);
+			}
+			break;
+		case aiPTI_String:
+			if (len >= 4) {
+				ByteSwap::Swap4(prop->mData);
+			}
+			break;
+		default:
+			break;
+		}
+#endif
+	}
+	catch (...) {
+		delete prop;
+		throw;
+	}
+
+	LeaveChunk(limit);
+	return prop;
+}
+
+// ------------------------------------------------------------------------------------------------
+aiAnimation* AssbinImporter::ReadAnimation()
+{
+	const unsigned int limit = EnterChunk(ASSBIN_CHUNK_AIANIMATION);
+
+	aiAnimation* anim = new aiAnimation();
+	try {
+		ReadString(anim->mName);
+		anim->mDuration = stream->GetF8();
+		anim->mTicksPerSecond = stream->GetF8();
+
+		const unsigned int num = CheckCount(stream->GetU4(),8);
+		if (num) {
+			anim->mChannels = new aiNodeAnim*[num]();
+			anim->mNumChannels = num;
+			for (unsigned int i = 0; i < num;++i) {
+				anim->mChannels[i] = ReadNodeAnim();
+			}
+		}
+	}
+	catch (...) {
+		delete anim;
+		throw;
+	}
+
+	LeaveChunk(limit);
+	return anim;
+}
+
+// ------------------------------------------------------------------------------------------------
+aiNodeAnim* AssbinImporter::ReadNodeAnim()
+{
+	const unsigned int limit = EnterChunk(ASSBIN_CHUNK_AINODEANIM);
+
+	aiNodeAnim* nd = new aiNodeAnim();
+	try {
+		ReadString(nd->mNodeName);
+		const unsigned int numPositionKeys = stream->GetU4();
+		const unsigned int numRotationKeys = stream->GetU4();
+		const unsigned int numScalingKeys = stream->GetU4();
+		nd->mPreState = static_cast<aiAnimBehaviour>(stream->GetU4());
+		nd->mPostState = static_cast<aiAnimBehaviour>(stream->GetU4());
+
+		// each key takes 24 bytes, see WriteBinaryNodeAnim() in assimp_cmd
+		if (numPositionKeys) {
+			nd->mPositionKeys = new aiVectorKey[CheckCount(numPositionKeys,24)];
+			nd->mNumPositionKeys = numPositionKeys;
+			for (unsigned int i = 0; i < numPositionKeys;++i) {
+				nd->mPositionKeys[i].mTime = stream->GetF8();
+				nd->mPositionKeys[i].mValue = ReadVector();
+				stream->IncPtr(4);
+			}
+		}
+		if (numRotationKeys) {
+			nd->mRotationKeys = new aiQuatKey[CheckCount(numRotationKeys,24)];
+			nd->mNumRotationKeys = numRotationKeys;
+			for (unsigned int i = 0; i < numRotationKeys;++i) {
+				aiQuaternion& q = nd->mRotationKeys[i].mValue;
+				nd->mRotationKeys[i].mTime = stream->GetF8();
+				q.w = stream->GetF4();
+				q.x = stream->GetF4();
+				q.y = stream->GetF4();
+				q.z = stream->GetF4();
+			}
+		}
+		if (numScalingKeys) {
+			nd->mScalingKeys = new aiVectorKey[CheckCount(numScalingKeys,24)];
+			nd->mNumScalingKeys = numScalingKeys;
+			for (unsigned int i = 0; i < numScalingKeys;++i) {
+				nd->mScalingKeys[i].mTime = stream->GetF8();
+				nd->mScalingKeys[i].mValue = ReadVector();
+				stream->IncPtr(4);
+			}
+		}
+	}
+	catch (...) {
+		delete nd;
+		throw;
+	}
+
+	LeaveChunk(limit);
+	return nd;
+}
+
+// ------------------------------------------------------------------------------------------------
+aiTexture* AssbinImporter::ReadTexture()
+{
+	const unsigned int limit = EnterChunk(ASSBIN_CHUNK_AITEXTURE);
+
+	aiTexture* tex = new aiTexture();
+	try {
+		const unsigned int width = stream->GetU4();
+		const unsigned int height = stream->GetU4();
+		stream->CopyAndAdvance(tex->achFormatHint,4);
+
+		if (!height) {
+			// compressed texture, mWidth is the size in bytes
+			tex->pcData = reinterpret_cast<aiTexel*>(new char[CheckCount(width,1)]);
+			stream->CopyAndAdvance(tex->pcData,width);
+		}
+		else {
+			if (width > stream->GetRemainingSizeToLimit() / 4 / height) {
+				throw DeadlyImportError("assbin: texture exceeds chunk");
+			}
+			tex->pcData = new aiTexel[width*height];
+			stream->CopyAndAdvance(tex->pcData,width*height*4);
+		}
+		tex->mWidth = width;
+		tex->mHeight = height;
+	}
+	catch (...) {
+		delete tex;
+		throw;
+	}
+
+	LeaveChunk(limit);
+	return tex;
+}
+
+// ------------------------------------------------------------------------------------------------
+aiLight* AssbinImporter::ReadLight()
+{
+	const unsigned int limit = EnterChunk(ASSBIN_CHUNK_AILIGHT);
+
+	aiLight* l = new aiLight();
+	try {
+		ReadString(l->mName);
+		l->mType = static_cast<aiLightSourceType>(stream->GetU4());
+
+		if (l->mType != aiLightSource_DIRECTIONAL) { 
+			l->mAttenuationConstant = stream->GetF4();
+			l->mAttenuationLinear = stream->GetF4();
+			l->mAttenuationQuadratic = stream->GetF4();
+		}
+
+		ReadArray4(&l->mColorDiffuse,3);
+		ReadArray4(&l->mColorSpecular,3);
+		ReadArray4(&l->mColorAmbient,3);
+
+		if (l->mType == aiLightSource_SPOT) {
+			l->mAngleInnerCone = stream->GetF4();
+			l->mAngleOuterCone = stream->GetF4();
+		}
+
+		unsigned int extra;
+		if (EnterExtraChunk(&extra)) {
+			l->mPosition = ReadVector();
+			l->mDirection = ReadVector();
+			LeaveChunk(extra);
+		}
+	}
+	catch (...) {
+		delete l;
+		throw;
+	}
+
+	LeaveChunk(limit);
+	return l;
+}
+
+// ------------------------------------------------------------------------------------------------
+aiCamera* AssbinImporter::ReadCamera()
+{
+	const unsigned int limit = EnterChunk(ASSBIN_CHUNK_AICAMERA);
+
+	aiCamera* cam = new aiCamera();
+	try {
+		ReadString(cam->mName);
+		cam->mPosition = ReadVector();
+		cam->mLookAt = ReadVector();
+		cam->mUp = ReadVector();
+		cam->mHorizontalFOV = stream->GetF4();
+		cam->mClipPlaneNear = stream->GetF4();
+		cam->mClipPlaneFar = stream->GetF4();
+		cam->mAspect = stream->GetF4();
+	}
+	catch (...) {
+		delete cam;
+		throw;
+	}
+
+	LeaveChunk(limit);
+	return cam;
+}
+
+// ------------------------------------------------------------------------------------------------
+unsigned int AssbinImporter::EnterChunk(uint32_t chunk)
+{
+	if (stream->GetU4() != chunk) {
+		throw DeadlyImportError("assbin: unexpected chunk");
+	}
+
+	const unsigned int len = stream->GetU4();
+	if (len > stream->GetRemainingSizeToLimit()) {
+		throw DeadlyImportError("assbin: chunk exceeds its parent");
+	}
+
+	const unsigned int oldLimit = stream->GetReadLimit();
+	stream->SetReadLimit(stream->GetCurrentPos() + len);
+	return oldLimit;
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinImporter::LeaveChunk(unsigned int oldLimit)
+{
+	// skip data and subchunks added by newer versions
+	stream->SkipToReadLimit();
+	stream->SetReadLimit(oldLimit);
+}
+
+// ------------------------------------------------------------------------------------------------
+bool AssbinImporter::EnterExtraChunk(unsigned int* oldLimit)
+{
+	while (stream->GetRemainingSizeToLimit() >= 8) {
+		const uint32_t chunk = stream->GetU4();
+		const unsigned int len = stream->GetU4();
+		if (len > stream->GetRemainingSizeToLimit()) {
+			throw DeadlyImportError("assbin: chunk exceeds its parent");
+		}
+
+		if (chunk == ASSBIN_CHUNK_AIEXTRA) {
+			*oldLimit = stream->GetReadLimit();
+			stream->SetReadLimit(stream->GetCurrentPos() + len);
+			return true;
+		}
+		stream->IncPtr(len);
+	}
+	return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinImporter::ReadArray4(void* out, size_t count)
+{
+	if (count > stream->GetRemainingSizeToLimit() / 4) {
+		throw DeadlyImportError("assbin: array exceeds chunk");
+	}
+	stream->CopyAndAdvance(out,count*4);
+
+#ifdef AI_BUILD_BIG_ENDIAN
+	for (size_t i = 0; i < count; ++i) {
+		ByteSwap::Swap4(static_cast<uint32_t*>(out)+i);
+	}
+#endif
+}
+
+// ------------------------------------------------------------------------------------------------
+unsigned int AssbinImporter::CheckCount(unsigned int count, unsigned int size) const
+{
+	// allocations are bounded by the file size this way
+	if (size && count > stream->GetRemainingSizeToLimit() / size) {
+		throw DeadlyImportError("assbin: element count exceeds chunk");
+	}
+	return count;
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinImporter::ReadString(aiString& out)
+{
+	const unsigned int len = stream->GetU4();
+	if (len >= MAXLEN) {
+		throw DeadlyImportError("assbin: string too long");
+	}
+	stream->CopyAndAdvance(out.data,len);
+	out.data[len] = '\0';
+	out.length = len;
+}
+
+// ------------------------------------------------------------------------------------------------
+aiVector3D AssbinImporter::ReadVector()
+{
+	aiVector3D v;
+	v.x = stream->GetF4();
+	v.y = stream->GetF4();
+	v.z = stream->GetF4();
+	return v;
+}
+
+#endif // !! ASSIMP_BUILD_NO_ASSBIN_IMPORTER
@@ -0,0 +1,151 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2012, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms, 
+with or without modification, are permitted provided that the 
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file AssbinLoader.h
+ *  Declaration of the Assimp Binary (assbin) importer class. 
+ */
+#ifndef AI_ASSBINLOADER_H_INCLUDED
+#define AI_ASSBINLOADER_H_INCLUDED
+
+#include "BaseImporter.h"
+#include "../include/assimp/types.h"
+
+struct aiNode;
+struct aiMesh;
+struct aiBone;
+struct aiMaterial;
+struct aiMaterialProperty;
+struct aiAnimation;
+struct aiNodeAnim;
+struct aiTexture;
+struct aiLight;
+struct aiCamera;
+
+namespace Assimp	{
+
+// ---------------------------------------------------------------------------
+/** Importer class for Assimp's own binary scene dumps, as written by 
+ *  'assimp dump -b' and the assbin exporter. Shortened dumps can't be
+ *  loaded since they lack most of the data. See assbin_chunks.h for
+ *  a description of the file format.
+*/
+class AssbinImporter : public BaseImporter
+{
+public:
+	AssbinImporter();
+	~AssbinImporter();
+
+
+public:
+
+	// -------------------------------------------------------------------
+	/** Returns whether the class can handle the format of the given file. 
+	 * See BaseImporter::CanRead() for details.	
+	 */
+	bool CanRead( const std::string& pFile, IOSystem* pIOHandler,
+		bool checkSig) const;
+
+protected:
+
+	// -------------------------------------------------------------------
+	/** Return importer meta information.
+	 * See #BaseImporter::GetInfo for the details
+	 */
+	const aiImporterDesc* GetInfo () const;
+
+	// -------------------------------------------------------------------
+	/** Imports the given file into the given scene structure. 
+	* See BaseImporter::InternReadFile() for details
+	*/
+	void InternReadFile( const std::string& pFile, aiScene* pScene, 
+		IOSystem* pIOHandler);
+
+private:
+
+	void ReadScene(aiScene* scene);
+	aiNode* ReadNode(aiNode* parent);
+	aiMesh* ReadMesh();
+	aiBone* ReadBone(unsigned int numVertices);
+	aiMaterial* ReadMaterial();
+	aiMaterialProperty* ReadMaterialProperty();
+	aiAnimation* ReadAnimation();
+	aiNodeAnim* ReadNodeAnim();
+	aiTexture* ReadTexture();
+	aiLight* ReadLight();
+	aiCamera* ReadCamera();
+
+	// -------------------------------------------------------------------
+	/** Enters the chunk at the current position, which must be of the
+	 *  given type. Returns the read limit to restore in LeaveChunk().
+	 */
+	unsigned int EnterChunk(uint32_t magic);
+
+	// -------------------------------------------------------------------
+	/** Skips the rest of the current chunk and restores the read limit.
+	 */
+	void LeaveChunk(unsigned int oldLimit);
+
+	// -------------------------------------------------------------------
+	/** Enters the ASSBIN_CHUNK_AIEXTRA subchunk of the current chunk, if
+	 *  there is one. Other subchunks left in the current chunk are skipped.
+	 * @return true if the subchunk was found. The caller must leave it
+	 *   with LeaveChunk(*oldLimit) then.
+	 */
+	bool EnterExtraChunk(unsigned int* oldLimit);
+
+	// -------------------------------------------------------------------
+	/** Reads an array of floats or 32 bit integers */
+	void ReadArray4(void* out, size_t count);
+
+	/** Returns count if at least count*size bytes are left in the current chunk */
+	unsigned int CheckCount(unsigned int count, unsigned int size) const;
+
+	void ReadString(aiString& out);
+	aiVector3D ReadVector();
+
+private:
+
+	/** Stream to read from */
+	StreamReaderLE* stream;
+};
+
+} // end of namespace Assimp
+
+#endif // AI_ASSBINLOADER_H_INCLUDED
@@ -46,8 +46,16 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "BaseProcess.h"
 
 #include "Importer.h"
+#include "DeferredLog.h"
+#include "Profiler.h"
+
+#ifndef ASSIMP_BUILD_NO_THREADING
+#	include <atomic>
+#	include <thread>
+#endif
 
 using namespace Assimp;
+using namespace Assimp::Profiling;
 
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
@@ -103,3 +111,220 @@ bool BaseProcess::RequireVerboseFormat() const
 	return true;
 }
 
+// ------------------------------------------------------------------------------------------------
+MeshProcess::MeshProcess()
+{
+}
+
+// ------------------------------------------------------------------------------------------------
+MeshProcess::~MeshProcess()
+{
+	// nothing to do here
+}
+
+// ------------------------------------------------------------------------------------------------
+void MeshProcess::Execute( aiScene* pScene)
+{
+	SetupMeshes(pScene);
+	for (unsigned int a = 0; a < pScene->mNumMeshes; ++a) {
+		ExecuteOnMesh(pScene->mMeshes[a],a);
+	}
+	FinishMeshes(pScene);
+}
+
+// ------------------------------------------------------------------------------------------------
+void MeshProcess::SetupMeshes( aiScene* /*pScene*/)
+{
+	// the default implementation does nothing
+}
+
+// ------------------------------------------------------------------------------------------------
+void MeshProcess::FinishMeshes( aiScene* /*pScene*/)
+{
+	// the default implementation does nothing
+}
+
+namespace {
+
+	// ------------------------------------------------------------------------------------------------
+	// The work of MeshProcess::ExecuteFused(), shared by all threads
+	struct FusedJob
+	{
+		aiScene* scene;
+		MeshProcess* const* steps;
+		unsigned int numSteps;
+
+		// meshes by decreasing size, so no thread ends up with a big one last
+		std::vector<unsigned int> order;
+
+		// per mesh: the messages logged for it and the index of the step that failed on it
+		std::vector<DeferredLog> logs;
+		std::vector<unsigned int> failedStep;
+		std::vector<std::string> errors;
+
+#ifndef ASSIMP_BUILD_NO_THREADING
+		std::atomic<unsigned int> next;
+		std::atomic<bool> failed;
+#else
+		unsigned int next;
+		bool failed;
+#endif
+	};
+
+	// ------------------------------------------------------------------------------------------------
+	// Sorts mesh indices by decreasing size
+	struct MeshSizeGreater
+	{
+		explicit MeshSizeGreater(const aiScene* scene)
+			: scene(scene)
+		{}
+
+		bool operator() (unsigned int a, unsigned int b) const {
+			const aiMesh* ma = scene->mMeshes[a], *mb = scene->mMeshes[b];
+			return ma->mNumVertices + ma->mNumFaces > mb->mNumVertices + mb->mNumFaces;
+		}
+
+		const aiScene* scene;
+	};
+
+	// ------------------------------------------------------------------------------------------------
+	// Passes meshes through all steps until none are left, adding the time of each step to stepTimes
+	void RunFusedJob(FusedJob* job, double* stepTimes)
+	{
+		for (unsigned int n = job->next++; n < job->order.size() && !job->failed; n = job->next++) {
+			const unsigned int meshIndex = job->order[n];
+			aiMesh* mesh = job->scene->mMeshes[meshIndex];
+
+			DeferredLog::SetForThisThread(&job->logs[meshIndex]);
+			for (unsigned int s = 0; s < job->numSteps; ++s) {
+				const double start = Profiler::GetTime();
+				try {
+					job->steps[s]->ExecuteOnMesh(mesh,meshIndex);
+				}
+				catch( const std::exception& err )	{
+					job->errors[meshIndex] = err.what();
+					job->failedStep[meshIndex] = s;
+				}
+				catch( ... )	{
+					job->errors[meshIndex] = "Unknown exception";
+					job->failedStep[meshIndex] = s;
+				}
+				stepTimes[s] += Profiler::GetTime() - start;
+
+				if (job->failedStep[meshIndex] != UINT_MAX) {
+					job->failed = true;
+					break;
+				}
+			}
+			DeferredLog::SetForThisThread(NULL);
+		}
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+void MeshProcess::ExecuteFused( Importer* pImp, MeshProcess* const* steps, unsigned int numSteps, 
+	int numThreads, double* stepTimes)
+{
+	ai_assert(NULL != pImp && NULL != pImp->Pimpl()->mScene);
+	aiScene* pScene = pImp->Pimpl()->mScene;
+
+	// per thread, the time spent in each step
+	std::vector<double> times(numSteps);
+
+	try
+	{
+		for (unsigned int s = 0; s < numSteps; ++s) {
+			steps[s]->progress = pImp->GetProgressHandler();
+			ai_assert(steps[s]->progress);
+
+			steps[s]->SetupProperties(pImp);
+
+			const double start = Profiler::GetTime();
+			steps[s]->SetupMeshes(pScene);
+			times[s] += Profiler::GetTime() - start;
+		}
+
+		FusedJob job;
+		job.scene = pScene;
+		job.steps = steps;
+		job.numSteps = numSteps;
+		job.order.resize(pScene->mNumMeshes);
+		for (unsigned int a = 0; a < pScene->mNumMeshes; ++a) {
+			job.order[a] = a;
+		}
+		std::stable_sort(job.order.begin(),job.order.end(),MeshSizeGreater(pScene));
+		job.logs.resize(pScene->mNumMeshes);
+		job.failedStep.resize(pScene->mNumMeshes,UINT_MAX);
+		job.errors.resize(pScene->mNumMeshes);
+		job.next = 0;
+		job.failed = false;
+
+#ifndef ASSIMP_BUILD_NO_THREADING
+		if (numThreads < 0) {
+			numThreads = std::max(1u,std::thread::hardware_concurrency());
+		}
+		numThreads = std::max(1,std::min(numThreads,(int)pScene->mNumMeshes));
+		times.resize(numSteps * numThreads);
+
+		// the calling thread is the first worker
+		std::vector<std::thread> threads;
+		threads.reserve(numThreads - 1);
+		for (int t = 1; t < numThreads; ++t) {
+			try {
+				threads.push_back(std::thread(RunFusedJob,&job,&times[numSteps * t]));
+			}
+			catch( const std::system_error& )	{
+				// go on with the threads we have
+				break;
+			}
+		}
+		RunFusedJob(&job,&times[0]);
+		for (unsigned int t = 0; t < threads.size(); ++t) {
+			threads[t].join();
+		}
+		for (unsigned int t = 1; t < (unsigned int)numThreads; ++t) {
+			for (unsigned int s = 0; s < numSteps; ++s) {
+				times[s] += times[numSteps * t + s];
+			}
+		}
+#else
+		(void)numThreads;
+		RunFusedJob(&job,&times[0]);
+#endif
+
+		for (unsigned int a = 0; a < pScene->mNumMeshes; ++a) {
+			job.logs[a].Flush();
+		}
+
+		// report the failure of the first step, as if the steps had been executed one by one
+		if (job.failed) {
+			unsigned int first = 0;
+			for (unsigned int a = 1; a < pScene->mNumMeshes; ++a) {
+				if (job.failedStep[a] < job.failedStep[first]) {
+					first = a;
+				}
+			}
+			throw DeadlyImportError(job.errors[first]);
+		}
+
+		for (unsigned int s = 0; s < numSteps; ++s) {
+			const double start = Profiler::GetTime();
+			steps[s]->FinishMeshes(pScene);
+			times[s] += Profiler::GetTime() - start;
+		}
+
+	} catch( const std::exception& err )	{
+
+		// extract error description
+		pImp->Pimpl()->mErrorString = err.what();
+		DefaultLogger::get()->error(pImp->Pimpl()->mErrorString);
+
+		// and kill the partially imported data
+		delete pImp->Pimpl()->mScene;
+		pImp->Pimpl()->mScene = NULL;
+	}
+
+	if (stepTimes) {
+		std::copy(times.begin(),times.begin() + numSteps,stepTimes);
+	}
+}
@@ -48,6 +48,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "GenericProperty.h"
 
 struct aiScene;
+struct aiMesh;
 
 namespace Assimp	{
 
@@ -288,6 +289,75 @@ protected:
 	ProgressHandler* progress;
 };
 
+// ---------------------------------------------------------------------------
+/** Base class for the post processing steps that work on each mesh on its
+ *  own, e.g. JoinVerticesProcess or CalcTangentsProcess.
+ *
+ *  Execute() calls SetupMeshes(), ExecuteOnMesh() for each mesh in turn and
+ *  FinishMeshes(). The Importer runs adjacent active steps of this kind with
+ *  ExecuteFused() instead: each mesh passes through all of them at once and
+ *  several meshes are processed concurrently. So ExecuteOnMesh() may only
+ *  change the given mesh and the step's data for it, and SetupMeshes() may
+ *  only rely on scene data that the fused steps before it don't change.
+ */
+class ASSIMP_API_WINONLY MeshProcess : public BaseProcess
+{
+public:
+
+	MeshProcess();
+	virtual ~MeshProcess();
+
+public:
+
+	// -------------------------------------------------------------------
+	/** Executes the post processing step on each mesh of the scene,
+	 *  on the calling thread.
+	 * @param pScene The imported data to work at.
+	 */
+	void Execute( aiScene* pScene);
+
+	// -------------------------------------------------------------------
+	/** Returns the name of the step, used to report its timings. */
+	virtual const char* GetName() const = 0;
+
+	// -------------------------------------------------------------------
+	/** Called on the calling thread before the meshes are processed.
+	 *  Throws a DeadlyImportError if the step can't be executed.
+	 * @param pScene The imported data to work at.
+	 */
+	virtual void SetupMeshes( aiScene* pScene);
+
+	// -------------------------------------------------------------------
+	/** Executes the post processing step on one mesh. May be called on
+	 *  any thread, concurrently for different meshes.
+	 * @param pMesh The mesh to process.
+	 * @param meshIndex Index of the mesh in the scene.
+	 */
+	virtual void ExecuteOnMesh( aiMesh* pMesh, unsigned int meshIndex) = 0;
+
+	// -------------------------------------------------------------------
+	/** Called on the calling thread after all meshes have been processed.
+	 * @param pScene The imported data to work at.
+	 */
+	virtual void FinishMeshes( aiScene* pScene);
+
+	// -------------------------------------------------------------------
+	/** Executes several steps on the imported data of an Importer as one,
+	 *  in the given order for each mesh. The messages the steps log for a
+	 *  mesh are written in mesh order. Like BaseProcess::ExecuteOnScene(),
+	 *  the scene is deleted if a step fails.
+	 * @param pImp Importer instance (pImp->mScene must be valid)
+	 * @param steps The steps to execute
+	 * @param numSteps Number of steps
+	 * @param numThreads Number of threads to use, see
+	 *   #AI_CONFIG_GLOB_MULTITHREADING. -1 uses one per CPU.
+	 * @param stepTimes Receives the time in seconds each step took, added
+	 *   up over all threads. May be NULL.
+	 */
+	static void ExecuteFused( Importer* pImp, MeshProcess* const* steps,
+		unsigned int numSteps, int numThreads, double* stepTimes);
+};
+
 
 } // end of namespace Assimp
 
@@ -89,19 +89,34 @@ void CalcTangentsProcess::SetupProperties(const Importer* pImp)
 }
 
 // ------------------------------------------------------------------------------------------------
-// Executes the post processing step on the given imported data.
-void CalcTangentsProcess::Execute( aiScene* pScene)
+const char* CalcTangentsProcess::GetName() const
+{
+	return "CalcTangentsProcess";
+}
+
+// ------------------------------------------------------------------------------------------------
+// Prepares the post processing step for the given imported data.
+void CalcTangentsProcess::SetupMeshes( aiScene* pScene)
 {
     ai_assert( NULL != pScene );
 
     DefaultLogger::get()->debug("CalcTangentsProcess begin");
 
-	bool bHas = false;
-	for ( unsigned int a = 0; a < pScene->mNumMeshes; a++ ) {
-		if(ProcessMesh( pScene->mMeshes[a],a))bHas = true;
-    }
+	meshComputed.assign(pScene->mNumMeshes,0);
+}
 
-	if ( bHas ) {
+// ------------------------------------------------------------------------------------------------
+// Executes the post processing step on the given mesh.
+void CalcTangentsProcess::ExecuteOnMesh( aiMesh* pMesh, unsigned int meshIndex)
+{
+	meshComputed[meshIndex] = ProcessMesh(pMesh,meshIndex);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Finishes the post processing step on the given imported data.
+void CalcTangentsProcess::FinishMeshes( aiScene* /*pScene*/)
+{
+	if ( std::find(meshComputed.begin(),meshComputed.end(),1) != meshComputed.end() ) {
         DefaultLogger::get()->info("CalcTangentsProcess finished. Tangents have been calculated");
     } else {
         DefaultLogger::get()->debug("CalcTangentsProcess finished");
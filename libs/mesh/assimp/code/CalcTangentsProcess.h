@@ -57,7 +57,7 @@ namespace Assimp
  * because the joining of vertices also considers tangents and bitangents for 
  * uniqueness.
  */
-class ASSIMP_API_WINONLY CalcTangentsProcess : public BaseProcess
+class ASSIMP_API_WINONLY CalcTangentsProcess : public MeshProcess
 {
 public:
 
@@ -98,16 +98,36 @@ protected:
 	bool ProcessMesh( aiMesh* pMesh, unsigned int meshIndex);
 
 	// -------------------------------------------------------------------
-	/** Executes the post processing step on the given imported data.
+	/** Returns the name of the step, used to report its timings. */
+	const char* GetName() const;
+
+	// -------------------------------------------------------------------
+	/** Prepares the post processing step for the given imported data.
+	* @param pScene The imported data to work at.
+	*/
+	void SetupMeshes( aiScene* pScene);
+
+	// -------------------------------------------------------------------
+	/** Calculates tangents and bitangents for one mesh.
+	* @param pMesh The mesh to process.
+	* @param meshIndex Index of the mesh
+	*/
+	void ExecuteOnMesh( aiMesh* pMesh, unsigned int meshIndex);
+
+	// -------------------------------------------------------------------
+	/** Logs whether tangents have been calculated.
 	* @param pScene The imported data to work at.
 	*/
-	void Execute( aiScene* pScene);
+	void FinishMeshes( aiScene* pScene);
 
 private:
 
 	/** Configuration option: maximum smoothing angle, in radians*/
 	float configMaxAngle;
 	unsigned int configSourceUV;
+
+	/** For each mesh, whether tangents have been calculated */
+	std::vector<unsigned char> meshComputed;
 };
 
 } // end of namespace Assimp
@@ -51,6 +51,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "StdOStreamLogStream.h"
 #include "FileLogStream.h"
 
+#include "DeferredLog.h"
+
 #ifndef ASSIMP_BUILD_SINGLETHREADED
 #	include <boost/thread/thread.hpp>
 #	include <boost/thread/mutex.hpp>
@@ -168,6 +170,10 @@ void Logger::debug(const char* message)	{
 		ai_assert(false);
 		return;
 	}
+	// worker threads of the post processing pipeline keep their messages for later
+	if (DeferredLog::Defer(Logger::Debugging, message)) {
+		return;
+	}
 	return OnDebug(message);
 }
 
@@ -179,6 +185,9 @@ void Logger::info(const char* message)	{
 		ai_assert(false);
 		return;
 	}
+	if (DeferredLog::Defer(Logger::Info, message)) {
+		return;
+	}
 	return OnInfo(message);
 }
 	
@@ -190,6 +199,9 @@ void Logger::warn(const char* message)	{
 		ai_assert(false);
 		return;
 	}
+	if (DeferredLog::Defer(Logger::Warn, message)) {
+		return;
+	}
 	return OnWarn(message);
 }
 
@@ -201,6 +213,9 @@ void Logger::error(const char* message)	{
 		ai_assert(false);
 		return;
 	}
+	if (DeferredLog::Defer(Logger::Err, message)) {
+		return;
+	}
 	return OnError(message);
 }
 
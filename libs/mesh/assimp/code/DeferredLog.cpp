@@ -0,0 +1,103 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2012, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms, 
+with or without modification, are permitted provided that the 
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+
+/** @file  DeferredLog.cpp
+ *  @brief Implementation of DeferredLog
+ */
+
+#include "AssimpPCH.h"
+#include "DeferredLog.h"
+
+using namespace Assimp;
+
+namespace {
+
+	// The log of the calling thread, if any
+#ifndef ASSIMP_BUILD_NO_THREADING
+	thread_local DeferredLog* threadLog = NULL;
+#else
+	DeferredLog* threadLog = NULL;
+#endif
+}
+
+// ------------------------------------------------------------------------------------------------
+void DeferredLog::SetForThisThread(DeferredLog* log)
+{
+	threadLog = log;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool DeferredLog::Defer(Logger::ErrorSeverity severity, const char* message)
+{
+	if (!threadLog) {
+		return false;
+	}
+	if (!DefaultLogger::isNullLogger()) {
+		threadLog->messages.push_back(std::make_pair(severity, std::string(message)));
+	}
+	return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void DeferredLog::Flush()
+{
+	ai_assert(threadLog != this);
+
+	Logger* logger = DefaultLogger::get();
+	for (std::vector< std::pair<Logger::ErrorSeverity, std::string> >::const_iterator it = messages.begin(); 
+		it != messages.end(); ++it) {
+		switch ((*it).first)
+		{
+		case Logger::Debugging:
+			logger->debug((*it).second);
+			break;
+		case Logger::Info:
+			logger->info((*it).second);
+			break;
+		case Logger::Warn:
+			logger->warn((*it).second);
+			break;
+		default:
+			logger->error((*it).second);
+		}
+	}
+	messages.clear();
+}
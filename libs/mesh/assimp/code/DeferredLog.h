@@ -0,0 +1,87 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2012, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms, 
+with or without modification, are permitted provided that the 
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+
+/** @file DeferredLog.h
+ *  @brief Collects log messages of a worker thread to write them later
+ */
+#ifndef INCLUDED_AI_DEFERRED_LOG_H
+#define INCLUDED_AI_DEFERRED_LOG_H
+
+#include <string>
+#include <vector>
+
+#include "../include/assimp/Logger.hpp"
+
+namespace Assimp	{
+
+// ---------------------------------------------------------------------------
+/** Stores the messages a thread sends to the DefaultLogger while the log is
+ *  set for that thread, so that another thread can write them to the logger
+ *  afterwards. This keeps the output of the worker threads of the post
+ *  processing pipeline in a fixed order, and loggers need not be thread-safe.
+ */
+class DeferredLog
+{
+public:
+
+	// -------------------------------------------------------------------
+	/** Stores all messages of the calling thread in the given log from now
+	 *  on. NULL sends them to the DefaultLogger again. */
+	static void SetForThisThread(DeferredLog* log);
+
+	// -------------------------------------------------------------------
+	/** Called by the Logger for each message. Returns false if the calling
+	 *  thread has no deferred log and the message should be written. */
+	static bool Defer(Logger::ErrorSeverity severity, const char* message);
+
+	// -------------------------------------------------------------------
+	/** Writes all stored messages to the DefaultLogger and clears the log.
+	 *  Must not be called while the log is set for a thread. */
+	void Flush();
+
+private:
+
+	std::vector< std::pair<Logger::ErrorSeverity, std::string> > messages;
+};
+
+} // end of namespace Assimp
+
+#endif // INCLUDED_AI_DEFERRED_LOG_H
@@ -82,22 +82,35 @@ void GenVertexNormalsProcess::SetupProperties(const Importer* pImp)
 }
 
 // ------------------------------------------------------------------------------------------------
-// Executes the post processing step on the given imported data.
-void GenVertexNormalsProcess::Execute( aiScene* pScene)
+const char* GenVertexNormalsProcess::GetName() const
+{
+	return "GenVertexNormalsProcess";
+}
+
+// ------------------------------------------------------------------------------------------------
+// Prepares the post processing step for the given imported data.
+void GenVertexNormalsProcess::SetupMeshes( aiScene* pScene)
 {
 	DefaultLogger::get()->debug("GenVertexNormalsProcess begin");
 
 	if (pScene->mFlags & AI_SCENE_FLAGS_NON_VERBOSE_FORMAT)
 		throw DeadlyImportError("Post-processing order mismatch: expecting pseudo-indexed (\"verbose\") vertices here");
 
-	bool bHas = false;
-	for( unsigned int a = 0; a < pScene->mNumMeshes; a++)
-	{
-		if(GenMeshVertexNormals( pScene->mMeshes[a],a))
-			bHas = true;
-	}
+	meshComputed.assign(pScene->mNumMeshes,0);
+}
 
-	if (bHas)	{
+// ------------------------------------------------------------------------------------------------
+// Executes the post processing step on the given mesh.
+void GenVertexNormalsProcess::ExecuteOnMesh( aiMesh* pMesh, unsigned int meshIndex)
+{
+	meshComputed[meshIndex] = GenMeshVertexNormals(pMesh,meshIndex);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Finishes the post processing step on the given imported data.
+void GenVertexNormalsProcess::FinishMeshes( aiScene* /*pScene*/)
+{
+	if (std::find(meshComputed.begin(),meshComputed.end(),1) != meshComputed.end())	{
 		DefaultLogger::get()->info("GenVertexNormalsProcess finished. "
 			"Vertex normals have been calculated");
 	}
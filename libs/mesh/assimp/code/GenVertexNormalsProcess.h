@@ -53,7 +53,7 @@ namespace Assimp {
 // ---------------------------------------------------------------------------
 /** The GenFaceNormalsProcess computes vertex normals for all vertizes
 */
-class ASSIMP_API_WINONLY GenVertexNormalsProcess : public BaseProcess
+class ASSIMP_API_WINONLY GenVertexNormalsProcess : public MeshProcess
 {
 public:
 
@@ -78,11 +78,27 @@ public:
 	void SetupProperties(const Importer* pImp);
 
 	// -------------------------------------------------------------------
-	/** Executes the post processing step on the given imported data.
-	* At the moment a process is not supposed to fail.
+	/** Returns the name of the step, used to report its timings. */
+	const char* GetName() const;
+
+	// -------------------------------------------------------------------
+	/** Checks that the vertices are still in verbose format.
+	* @param pScene The imported data to work at.
+	*/
+	void SetupMeshes( aiScene* pScene);
+
+	// -------------------------------------------------------------------
+	/** Computes normals for one mesh if it has none yet.
+	* @param pMesh The mesh to process.
+	* @param meshIndex Index of the mesh
+	*/
+	void ExecuteOnMesh( aiMesh* pMesh, unsigned int meshIndex);
+
+	// -------------------------------------------------------------------
+	/** Logs whether normals have been computed.
 	* @param pScene The imported data to work at.
 	*/
-	void Execute( aiScene* pScene);
+	void FinishMeshes( aiScene* pScene);
 
 
 	// setter for configMaxAngle
@@ -105,6 +121,9 @@ private:
 
 	/** Configuration option: maximum smoothing angle, in radians*/
 	float configMaxAngle;
+
+	/** For each mesh, whether normals have been computed */
+	std::vector<unsigned char> meshComputed;
 };
 
 } // end of namespace Assimp
@@ -78,6 +78,25 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #	include "ValidateDataStructure.h"
 #endif
 
+// the scene cache writes and reads assbin files
+#if !defined(ASSIMP_BUILD_NO_EXPORT) && !defined(ASSIMP_BUILD_NO_ASSBIN_EXPORTER) && !defined(ASSIMP_BUILD_NO_ASSBIN_IMPORTER)
+#	define AI_SCENE_CACHE_AVAILABLE
+#	include "AssbinLoader.h"
+#	include "Hash.h"
+#	if defined( _WIN32 )
+#		ifndef WIN32_LEAN_AND_MEAN
+#			define WIN32_LEAN_AND_MEAN
+#		endif
+#		ifndef NOMINMAX
+#			define NOMINMAX
+#		endif
+#		include <windows.h>
+#		include <process.h>
+#	else
+#		include <unistd.h>
+#	endif
+#endif
+
 using namespace Assimp::Profiling;
 using namespace Assimp::Formatter;
 
@@ -86,6 +105,10 @@ namespace Assimp {
 	void GetImporterInstanceList(std::vector< BaseImporter* >& out);
 	// PostStepRegistry.cpp
 	void GetPostProcessingStepInstanceList(std::vector< BaseProcess* >& out);
+#ifdef AI_SCENE_CACHE_AVAILABLE
+	// AssbinExporter.cpp
+	void ExportSceneAssbin(const char*,IOSystem*, const aiScene*);
+#endif
 }
 
 using namespace Assimp;
@@ -569,6 +592,127 @@ void WriteLogOpening(const std::string& file)
 		);
 }
 
+#ifdef AI_SCENE_CACHE_AVAILABLE
+
+// ------------------------------------------------------------------------------------------------
+// Hash a property map, skipping the given keys
+template <typename T>
+static uint32_t HashProperties(const std::map<unsigned int,T>& props, const unsigned int* skip, unsigned int numSkip, uint32_t hash)
+{
+	for (typename std::map<unsigned int,T>::const_iterator it = props.begin(); it != props.end(); ++it) {
+		if (std::find(skip,skip+numSkip,(*it).first) != skip+numSkip) {
+			continue;
+		}
+		hash = SuperFastHash(reinterpret_cast<const char*>(&(*it).first),sizeof(unsigned int),hash);
+		hash = SuperFastHash(reinterpret_cast<const char*>(&(*it).second),sizeof(T),hash);
+	}
+	return hash;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Get the name of the scene cache file for a file to be imported with the given flags.
+// Returns an empty string if the file can't be read.
+static std::string GetSceneCacheFile(const ImporterPimpl* pimpl, const std::string& dir, 
+	const std::string& pFile, unsigned int pFlags)
+{
+	boost::scoped_ptr<IOStream> file(pimpl->mIOHandler->Open(pFile,"rb"));
+	if (!file) {
+		return "";
+	}
+
+	// hash the contents of the file
+	const size_t size = file->FileSize();
+	std::vector<char> buffer(std::min(size,(size_t)0x10000));
+	uint32_t contents = 0;
+	for (size_t done = 0; done < size;) {
+		const size_t read = file->Read(&buffer[0],1,std::min(size-done,buffer.size()));
+		if (!read) {
+			return "";
+		}
+		contents = SuperFastHash(&buffer[0],static_cast<uint32_t>(read),contents);
+		done += read;
+	}
+
+	// and the settings which may change the scene, including the library version
+	const unsigned int skip[] = {
+		SuperFastHash(AI_CONFIG_GLOB_SCENE_CACHE),
+		SuperFastHash(AI_CONFIG_GLOB_MEASURE_TIME),
+		SuperFastHash(AI_CONFIG_GLOB_MULTITHREADING)
+	};
+	const unsigned int numSkip = sizeof(skip)/sizeof(skip[0]);
+
+	const unsigned int version[] = {aiGetVersionRevision(),aiGetCompileFlags()};
+	uint32_t settings = SuperFastHash(reinterpret_cast<const char*>(version),sizeof(version));
+	settings = HashProperties(pimpl->mIntProperties,skip,numSkip,settings);
+	settings = HashProperties(pimpl->mFloatProperties,skip,numSkip,settings);
+	settings = HashProperties(pimpl->mMatrixProperties,skip,numSkip,settings);
+	for (ImporterPimpl::StringPropertyMap::const_iterator it = pimpl->mStringProperties.begin(); 
+		it != pimpl->mStringProperties.end(); ++it) {
+		if (std::find(skip,skip+numSkip,(*it).first) != skip+numSkip) {
+			continue;
+		}
+		settings = SuperFastHash(reinterpret_cast<const char*>(&(*it).first),sizeof(unsigned int),settings);
+		settings = SuperFastHash((*it).second.c_str(),static_cast<uint32_t>((*it).second.length()+1),settings);
+	}
+
+	char name[64];
+	::sprintf(name,"%08x%08x-%08x-%08x.assbin",contents,static_cast<uint32_t>(size),pFlags,settings);
+
+	const char last = dir[dir.length()-1];
+	return last == '/' || last == '\\' ? dir + name : dir + '/' + name;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Write a scene to the scene cache. Failures are not fatal, the cache is just not updated.
+static void WriteSceneCache(const aiScene* scene, const std::string& cacheFile)
+{
+	// mesh animations are not stored in assbin files
+	for (unsigned int i = 0; i < scene->mNumMeshes;++i) {
+		if (scene->mMeshes[i]->mNumAnimMeshes) {
+			DefaultLogger::get()->debug("Scene has mesh animations, not writing it to the scene cache");
+			return;
+		}
+	}
+	for (unsigned int i = 0; i < scene->mNumAnimations;++i) {
+		if (scene->mAnimations[i]->mNumMeshChannels) {
+			DefaultLogger::get()->debug("Scene has mesh animations, not writing it to the scene cache");
+			return;
+		}
+	}
+
+	// write to a temporary file first, so that concurrent readers never see partial files.
+	// The name is unique per process and scene, so concurrent writers never share it.
+#if defined( _WIN32 )
+	const int pid = _getpid();
+#else
+	const int pid = static_cast<int>(getpid());
+#endif
+	const std::string tmp = format() << cacheFile << "." << pid << "." << static_cast<const void*>(scene) << ".tmp";
+	try {
+		DefaultIOSystem io;
+		ExportSceneAssbin(tmp.c_str(),&io,scene);
+	}
+	catch (const std::exception& e) {
+		DefaultLogger::get()->warn("Failed to write scene cache " + tmp + ": " + e.what());
+		::remove(tmp.c_str());
+		return;
+	}
+
+	// replace the cache file in one step, readers see either the old or the new file
+#if defined( _WIN32 )
+	if (!::MoveFileExA(tmp.c_str(),cacheFile.c_str(),MOVEFILE_REPLACE_EXISTING)) {
+#else
+	if (::rename(tmp.c_str(),cacheFile.c_str())) {
+#endif
+		DefaultLogger::get()->warn("Failed to rename scene cache file " + tmp);
+		::remove(tmp.c_str());
+		return;
+	}
+	DefaultLogger::get()->info("Wrote scene to cache " + cacheFile);
+}
+
+#endif // AI_SCENE_CACHE_AVAILABLE
+
 // ------------------------------------------------------------------------------------------------
 // Reads the given file and returns its contents if successful.
 const aiScene* Importer::ReadFile( const char* _pFile, unsigned int pFlags)
@@ -609,6 +753,41 @@ const aiScene* Importer::ReadFile( const char* _pFile, unsigned int pFlags)
 			profiler->BeginRegion("total");
 		}
 
+#ifdef AI_SCENE_CACHE_AVAILABLE
+		// Look for the post-processed scene in the scene cache, if enabled
+		std::string cacheFile;
+		const std::string cacheDir = GetPropertyString(AI_CONFIG_GLOB_SCENE_CACHE,"");
+		if (cacheDir.length()) {
+			cacheFile = GetSceneCacheFile(pimpl,cacheDir,pFile,pFlags);
+
+			DefaultIOSystem io;
+			if (cacheFile.length() && io.Exists(cacheFile.c_str())) {
+				if (profiler) {
+					profiler->BeginRegion("import");
+				}
+
+				AssbinImporter cache;
+				pimpl->mScene = cache.ReadFile(this,cacheFile,&io);
+				pimpl->mProgressHandler->Update();
+
+				if (profiler) {
+					profiler->EndRegion("import");
+				}
+
+				if (pimpl->mScene) {
+					ScenePriv(pimpl->mScene)->mPPStepsApplied = pFlags;
+					DefaultLogger::get()->info("Loaded scene from cache " + cacheFile);
+
+					if (profiler) {
+						profiler->EndRegion("total");
+					}
+					return pimpl->mScene;
+				}
+				DefaultLogger::get()->warn("Scene cache " + cacheFile + " is invalid, importing the file");
+			}
+		}
+#endif // AI_SCENE_CACHE_AVAILABLE
+
 		// Find an worker class which can handle the file
 		BaseImporter* imp = NULL;
 		for( unsigned int a = 0; a < pimpl->mImporter.size(); a++)	{
@@ -694,6 +873,12 @@ const aiScene* Importer::ReadFile( const char* _pFile, unsigned int pFlags)
 		// clear any data allocated by post-process steps
 		pimpl->mPPShared->Clean();
 
+#ifdef AI_SCENE_CACHE_AVAILABLE
+		if (pimpl->mScene && cacheFile.length()) {
+			WriteSceneCache(pimpl->mScene,cacheFile);
+		}
+#endif // AI_SCENE_CACHE_AVAILABLE
+
 		if (profiler) {
 			profiler->EndRegion("total");
 		}
@@ -765,6 +950,7 @@ const aiScene* Importer::ApplyPostProcessing(unsigned int pFlags)
 #endif // ! DEBUG
 
 	boost::scoped_ptr<Profiler> profiler(GetPropertyInteger(AI_CONFIG_GLOB_MEASURE_TIME,0)?new Profiler():NULL);
+	const int numThreads = GetPropertyInteger(AI_CONFIG_GLOB_MULTITHREADING,-1);
 	for( unsigned int a = 0; a < pimpl->mPostProcessingSteps.size(); a++)	{
 
 		BaseProcess* process = pimpl->mPostProcessingSteps[a];
@@ -774,8 +960,38 @@ const aiScene* Importer::ApplyPostProcessing(unsigned int pFlags)
 				profiler->BeginRegion("postprocess");
 			}
 
-			process->ExecuteOnScene	( this );
-			pimpl->mProgressHandler->Update();
+			MeshProcess* meshProcess = dynamic_cast<MeshProcess*>(process);
+			if (meshProcess) {
+
+				// Execute the following active steps that work on each mesh along with this one,
+				// so each mesh passes through all of them at once. In extra verbose mode the
+				// data structures are validated after each step, so they run one by one.
+				std::vector<MeshProcess*> fused(1,meshProcess);
+				for( unsigned int b = a+1; b < pimpl->mPostProcessingSteps.size() && !pimpl->bExtraVerbose; b++)	{
+					BaseProcess* next = pimpl->mPostProcessingSteps[b];
+					if( !next->IsActive( pFlags))	{
+						continue;
+					}
+					if( !dynamic_cast<MeshProcess*>(next))	{
+						break;
+					}
+					fused.push_back(static_cast<MeshProcess*>(next));
+					a = b;
+				}
+
+				std::vector<double> times(fused.size());
+				MeshProcess::ExecuteFused(this,&fused[0],(unsigned int)fused.size(),numThreads,&times[0]);
+				for( unsigned int b = 0; b < fused.size(); b++)	{
+					pimpl->mProgressHandler->Update();
+					if (profiler) {
+						profiler->ReportRegion(fused[b]->GetName(),times[b]);
+					}
+				}
+			}
+			else {
+				process->ExecuteOnScene	( this );
+				pimpl->mProgressHandler->Update();
+			}
 
 			if (profiler) {
 				profiler->EndRegion("postprocess");
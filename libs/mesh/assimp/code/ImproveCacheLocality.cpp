@@ -83,8 +83,14 @@ void ImproveCacheLocalityProcess::SetupProperties(const Importer* pImp)
 }
 
 // ------------------------------------------------------------------------------------------------
-// Executes the post processing step on the given imported data.
-void ImproveCacheLocalityProcess::Execute( aiScene* pScene)
+const char* ImproveCacheLocalityProcess::GetName() const
+{
+	return "ImproveCacheLocalityProcess";
+}
+
+// ------------------------------------------------------------------------------------------------
+// Prepares the post processing step for the given imported data.
+void ImproveCacheLocalityProcess::SetupMeshes( aiScene* pScene)
 {
 	if (!pScene->mNumMeshes) {
 		DefaultLogger::get()->debug("ImproveCacheLocalityProcess skipped; there are no meshes");
@@ -93,10 +99,28 @@ void ImproveCacheLocalityProcess::Execute( aiScene* pScene)
 
 	DefaultLogger::get()->debug("ImproveCacheLocalityProcess begin");
 
+	meshACMR.assign(pScene->mNumMeshes,0.f);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Executes the post processing step on the given mesh.
+void ImproveCacheLocalityProcess::ExecuteOnMesh( aiMesh* pMesh, unsigned int meshIndex)
+{
+	meshACMR[meshIndex] = ProcessMesh(pMesh,meshIndex);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Prints statistics for the given imported data.
+void ImproveCacheLocalityProcess::FinishMeshes( aiScene* pScene)
+{
+	if (!pScene->mNumMeshes) {
+		return;
+	}
+
 	float out = 0.f;
 	unsigned int numf = 0, numm = 0;
 	for( unsigned int a = 0; a < pScene->mNumMeshes; a++){
-		const float res = ProcessMesh( pScene->mMeshes[a],a);
+		const float res = meshACMR[a];
 		if (res) {
 			numf += pScene->mMeshes[a]->mNumFaces;
 			out  += res;
@@ -58,7 +58,7 @@ namespace Assimp
  *
  *  @note This step expects triagulated input data.
  */
-class ImproveCacheLocalityProcess : public BaseProcess
+class ImproveCacheLocalityProcess : public MeshProcess
 {
 public:
 
@@ -72,8 +72,20 @@ public:
 	bool IsActive( unsigned int pFlags) const;
 
 	// -------------------------------------------------------------------
-	// Executes the pp step on a given scene
-	void Execute( aiScene* pScene);
+	// Returns the name of the pp step
+	const char* GetName() const;
+
+	// -------------------------------------------------------------------
+	// Prepares the pp step for a given scene
+	void SetupMeshes( aiScene* pScene);
+
+	// -------------------------------------------------------------------
+	// Executes the pp step on a given mesh
+	void ExecuteOnMesh( aiMesh* pMesh, unsigned int meshIndex);
+
+	// -------------------------------------------------------------------
+	// Prints statistics for a given scene
+	void FinishMeshes( aiScene* pScene);
 
 	// -------------------------------------------------------------------
 	// Configures the pp step
@@ -91,6 +103,9 @@ private:
 	//! Configuration parameter: specifies the size of the cache to
 	//! optimize the vertex data for.
 	unsigned int configCacheDepth;
+
+	//! Output ACMR of each mesh, 0 if it was not processed
+	std::vector<float> meshACMR;
 };
 
 } // end of namespace Assimp
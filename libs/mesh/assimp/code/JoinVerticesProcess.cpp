@@ -73,27 +73,39 @@ bool JoinVerticesProcess::IsActive( unsigned int pFlags) const
 	return (pFlags & aiProcess_JoinIdenticalVertices) != 0;
 }
 // ------------------------------------------------------------------------------------------------
-// Executes the post processing step on the given imported data.
-void JoinVerticesProcess::Execute( aiScene* pScene)
+const char* JoinVerticesProcess::GetName() const
+{
+	return "JoinVerticesProcess";
+}
+
+// ------------------------------------------------------------------------------------------------
+// Prepares the post processing step for the given imported data.
+void JoinVerticesProcess::SetupMeshes( aiScene* pScene)
 {
 	DefaultLogger::get()->debug("JoinVerticesProcess begin");
 
-	// get the total number of vertices BEFORE the step is executed
-	int iNumOldVertices = 0;
-	if (!DefaultLogger::isNullLogger()) {
-		for( unsigned int a = 0; a < pScene->mNumMeshes; a++)	{
-			iNumOldVertices +=	pScene->mMeshes[a]->mNumVertices;
-		}
-	}
+	meshVerticesIn.assign(pScene->mNumMeshes,0);
+	meshVerticesOut.assign(pScene->mNumMeshes,0);
+}
 
-	// execute the step
-	int iNumVertices = 0;
-	for( unsigned int a = 0; a < pScene->mNumMeshes; a++)
-		iNumVertices +=	ProcessMesh( pScene->mMeshes[a],a);
+// ------------------------------------------------------------------------------------------------
+// Executes the post processing step on the given mesh.
+void JoinVerticesProcess::ExecuteOnMesh( aiMesh* pMesh, unsigned int meshIndex)
+{
+	// get the number of vertices BEFORE the step is executed
+	meshVerticesIn[meshIndex] = pMesh->mNumVertices;
+	meshVerticesOut[meshIndex] = ProcessMesh(pMesh,meshIndex);
+}
 
+// ------------------------------------------------------------------------------------------------
+// Finishes the post processing step on the given imported data.
+void JoinVerticesProcess::FinishMeshes( aiScene* pScene)
+{
 	// if logging is active, print detailed statistics
 	if (!DefaultLogger::isNullLogger())
 	{
+		const int iNumOldVertices = std::accumulate(meshVerticesIn.begin(),meshVerticesIn.end(),0);
+		const int iNumVertices = std::accumulate(meshVerticesOut.begin(),meshVerticesOut.end(),0);
 		if (iNumOldVertices == iNumVertices)
 		{
 			DefaultLogger::get()->debug("JoinVerticesProcess finished ");
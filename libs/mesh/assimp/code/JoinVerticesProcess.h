@@ -59,7 +59,7 @@ class JoinVerticesTest;
  * erases all but one of the copies. This usually reduces the number of vertices
  * in a mesh by a serious amount and is the standard form to render a mesh.
  */
-class ASSIMP_API_WINONLY JoinVerticesProcess : public BaseProcess
+class ASSIMP_API_WINONLY JoinVerticesProcess : public MeshProcess
 {
 public:
 
@@ -76,11 +76,27 @@ public:
 	bool IsActive( unsigned int pFlags) const;
 
 	// -------------------------------------------------------------------
-	/** Executes the post processing step on the given imported data.
-	* At the moment a process is not supposed to fail.
+	/** Returns the name of the step, used to report its timings. */
+	const char* GetName() const;
+
+	// -------------------------------------------------------------------
+	/** Prepares the post processing step for the given imported data.
+	* @param pScene The imported data to work at.
+	*/
+	void SetupMeshes( aiScene* pScene);
+
+	// -------------------------------------------------------------------
+	/** Unites identical vertices in one mesh.
+	* @param pMesh The mesh to process.
+	* @param meshIndex Index of the mesh to process
+	*/
+	void ExecuteOnMesh( aiMesh* pMesh, unsigned int meshIndex);
+
+	// -------------------------------------------------------------------
+	/** Prints statistics and marks the scene as non-verbose.
 	* @param pScene The imported data to work at.
 	*/
-	void Execute( aiScene* pScene);
+	void FinishMeshes( aiScene* pScene);
 
 public:
 	// -------------------------------------------------------------------
@@ -91,6 +107,9 @@ public:
 	int ProcessMesh( aiMesh* pMesh, unsigned int meshIndex);
 
 private:
+
+	/** Number of vertices of each mesh before and after the step */
+	std::vector<unsigned int> meshVerticesIn, meshVerticesOut;
 };
 
 } // end of namespace Assimp
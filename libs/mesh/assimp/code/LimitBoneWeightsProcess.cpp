@@ -69,13 +69,29 @@ bool LimitBoneWeightsProcess::IsActive( unsigned int pFlags) const
 }
 
 // ------------------------------------------------------------------------------------------------
-// Executes the post processing step on the given imported data.
-void LimitBoneWeightsProcess::Execute( aiScene* pScene)
+const char* LimitBoneWeightsProcess::GetName() const
+{
+	return "LimitBoneWeightsProcess";
+}
+
+// ------------------------------------------------------------------------------------------------
+// Prepares the post processing step for the given imported data.
+void LimitBoneWeightsProcess::SetupMeshes( aiScene* /*pScene*/)
 {
 	DefaultLogger::get()->debug("LimitBoneWeightsProcess begin");
-	for( unsigned int a = 0; a < pScene->mNumMeshes; a++)
-		ProcessMesh( pScene->mMeshes[a]);
+}
 
+// ------------------------------------------------------------------------------------------------
+// Executes the post processing step on the given mesh.
+void LimitBoneWeightsProcess::ExecuteOnMesh( aiMesh* pMesh, unsigned int /*meshIndex*/)
+{
+	ProcessMesh( pMesh);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Finishes the post processing step on the given imported data.
+void LimitBoneWeightsProcess::FinishMeshes( aiScene* /*pScene*/)
+{
 	DefaultLogger::get()->debug("LimitBoneWeightsProcess end");
 }
 
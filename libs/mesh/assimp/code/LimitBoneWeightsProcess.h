@@ -70,7 +70,7 @@ namespace Assimp
 * The other weights on this bone are then renormalized to assure the sum weight
 * to be 1.
 */
-class ASSIMP_API LimitBoneWeightsProcess : public BaseProcess
+class ASSIMP_API LimitBoneWeightsProcess : public MeshProcess
 {
 public:
 
@@ -103,11 +103,27 @@ public:
 	void ProcessMesh( aiMesh* pMesh);
 
 	// -------------------------------------------------------------------
-	/** Executes the post processing step on the given imported data.
-	* At the moment a process is not supposed to fail.
+	/** Returns the name of the step, used to report its timings. */
+	const char* GetName() const;
+
+	// -------------------------------------------------------------------
+	/** Prepares the post processing step for the given imported data.
+	* @param pScene The imported data to work at.
+	*/
+	void SetupMeshes( aiScene* pScene);
+
+	// -------------------------------------------------------------------
+	/** Executes the post processing step on the given mesh.
+	* @param pMesh The mesh to process.
+	* @param meshIndex Index of the mesh
+	*/
+	void ExecuteOnMesh( aiMesh* pMesh, unsigned int meshIndex);
+
+	// -------------------------------------------------------------------
+	/** Finishes the post processing step on the given imported data.
 	* @param pScene The imported data to work at.
 	*/
-	void Execute( aiScene* pScene);
+	void FinishMeshes( aiScene* pScene);
 
 
 public:
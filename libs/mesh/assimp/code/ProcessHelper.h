@@ -318,31 +318,46 @@ aiMesh* MakeSubmesh(const aiMesh *superMesh, const std::vector<unsigned int> &su
 // -------------------------------------------------------------------------------
 // Utility postprocess step to share the spatial sort tree between
 // all steps which use it to speedup its computations.
-class ComputeSpatialSortProcess : public BaseProcess
+class ComputeSpatialSortProcess : public MeshProcess
 {
+	typedef std::pair<SpatialSort, float> _Type; 
+
+public:
+
+	ComputeSpatialSortProcess()
+		: sorts()
+	{}
+
+private:
+
 	bool IsActive( unsigned int pFlags) const
 	{
 		return NULL != shared && 0 != (pFlags & (aiProcess_CalcTangentSpace | 
 			aiProcess_GenNormals | aiProcess_JoinIdenticalVertices));
 	}
 
-	void Execute( aiScene* pScene)
+	const char* GetName() const
 	{
-		typedef std::pair<SpatialSort, float> _Type; 
-		DefaultLogger::get()->debug("Generate spatially-sorted vertex cache");
+		return "ComputeSpatialSortProcess";
+	}
 
-		std::vector<_Type>* p = new std::vector<_Type>(pScene->mNumMeshes); 
-		std::vector<_Type>::iterator it = p->begin();
+	void SetupMeshes( aiScene* pScene)
+	{
+		DefaultLogger::get()->debug("Generate spatially-sorted vertex cache");
 
-		for (unsigned int i = 0; i < pScene->mNumMeshes; ++i, ++it)	{
-			aiMesh* mesh = pScene->mMeshes[i];
-			_Type& blubb = *it;
-			blubb.first.Fill(mesh->mVertices,mesh->mNumVertices,sizeof(aiVector3D));
-			blubb.second = ComputePositionEpsilon(mesh);
-		}
+		sorts = new std::vector<_Type>(pScene->mNumMeshes); 
+		shared->AddProperty(AI_SPP_SPATIAL_SORT,sorts);
+	}
 
-		shared->AddProperty(AI_SPP_SPATIAL_SORT,p);
+	void ExecuteOnMesh( aiMesh* mesh, unsigned int meshIndex)
+	{
+		_Type& blubb = (*sorts)[meshIndex];
+		blubb.first.Fill(mesh->mVertices,mesh->mNumVertices,sizeof(aiVector3D));
+		blubb.second = ComputePositionEpsilon(mesh);
 	}
+
+	// owned by the shared data
+	std::vector<_Type>* sorts;
 };
 
 // -------------------------------------------------------------------------------
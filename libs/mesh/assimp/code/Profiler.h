@@ -44,7 +44,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef INCLUDED_PROFILER_H
 #define INCLUDED_PROFILER_H
 
-#include "boost/timer.hpp"
+#ifndef ASSIMP_BUILD_NO_THREADING
+#	include <chrono>
+#else
+#	include <ctime>
+#endif
 
 #include "../include/assimp/DefaultLogger.hpp"
 #include "TinyFormatter.h"
@@ -56,8 +60,8 @@ namespace Assimp {
 
 
 // ------------------------------------------------------------------------------------------------
-/** Simple wrapper around boost::timer to simplify reporting. Timings are automatically
- *  dumped to the log file.
+/** Simple named timers to simplify reporting. Timings are automatically dumped to the log
+ *  file. They measure wall time, since post processing steps may run on several threads.
  */
 class Profiler
 {
@@ -70,7 +74,7 @@ public:
 	
 	/** Start a named timer */
 	void BeginRegion(const std::string& region) {
-		regions[region] = boost::timer();
+		regions[region] = GetTime();
 		DefaultLogger::get()->debug((format("START `"),region,"`"));
 	}
 	
@@ -82,12 +86,29 @@ public:
 			return;
 		}
 
-		DefaultLogger::get()->debug((format("END   `"),region,"`, dt= ",(*it).second.elapsed()," s"));
+		DefaultLogger::get()->debug((format("END   `"),region,"`, dt= ",GetTime() - (*it).second," s"));
+	}
+
+
+	/** Write the time of a region that was measured elsewhere to the log, e.g. the
+	 *  time a post processing step took on several threads, added up */
+	void ReportRegion(const std::string& region, double seconds) {
+		DefaultLogger::get()->debug((format("TIME  `"),region,"`, dt= ",seconds," s"));
+	}
+
+
+	/** Current time in seconds, from an arbitrary start */
+	static double GetTime() {
+#ifndef ASSIMP_BUILD_NO_THREADING
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+		return std::clock() / (double)CLOCKS_PER_SEC;
+#endif
 	}
 
 private:
 
-	typedef std::map<std::string,boost::timer> RegionMap;
+	typedef std::map<std::string,double> RegionMap;
 	RegionMap regions;
 };
 
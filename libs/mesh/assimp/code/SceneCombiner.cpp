@@ -1197,6 +1197,65 @@ void SceneCombiner::Copy     (aiNode** _dest, const aiNode* src)
 	// and reallocate all arrays
 	GetArrayCopy( dest->mMeshes, dest->mNumMeshes );
 	CopyPtrArray( dest->mChildren, src->mChildren,dest->mNumChildren);
+
+	// the metadata is owned by the node, too
+	if (src->mMetaData) {
+		Copy( &dest->mMetaData, src->mMetaData );
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+template <typename Type>
+inline void* GetMetadataValueCopy (const void* src)
+{
+	return src ? new Type(*static_cast<const Type*>(src)) : NULL;
+}
+
+// ------------------------------------------------------------------------------------------------
+void SceneCombiner::Copy     (aiMetadata** _dest, const aiMetadata* src)
+{
+	ai_assert(NULL != _dest && NULL != src);
+
+	aiMetadata* dest = *_dest = new aiMetadata();
+	dest->mNumProperties = src->mNumProperties;
+	if (!src->mNumProperties) {
+		return;
+	}
+
+	dest->mKeys = new aiString[src->mNumProperties];
+	std::copy(src->mKeys,src->mKeys + src->mNumProperties,dest->mKeys);
+
+	dest->mValues = new aiMetadataEntry[src->mNumProperties];
+	for (unsigned int i = 0; i < src->mNumProperties;++i) {
+		const aiMetadataEntry& in = src->mValues[i];
+		aiMetadataEntry& out = dest->mValues[i];
+
+		out.mType = in.mType;
+		switch (in.mType)
+		{
+		case AI_BOOL:
+			out.mData = GetMetadataValueCopy<bool>(in.mData);
+			break;
+		case AI_INT:
+			out.mData = GetMetadataValueCopy<int>(in.mData);
+			break;
+		case AI_UINT64:
+			out.mData = GetMetadataValueCopy<uint64_t>(in.mData);
+			break;
+		case AI_FLOAT:
+			out.mData = GetMetadataValueCopy<float>(in.mData);
+			break;
+		case AI_AISTRING:
+			out.mData = GetMetadataValueCopy<aiString>(in.mData);
+			break;
+		case AI_AIVECTOR3D:
+			out.mData = GetMetadataValueCopy<aiVector3D>(in.mData);
+			break;
+		default:
+			ai_assert(false);
+			out.mData = NULL;
+		}
+	}
 }
 
 
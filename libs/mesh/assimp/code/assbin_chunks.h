@@ -3,7 +3,7 @@
 #define INCLUDED_ASSBIN_CHUNKS_H
 
 #define ASSBIN_VERSION_MAJOR 1
-#define ASSBIN_VERSION_MINOR 0
+#define ASSBIN_VERSION_MINOR 1
 
 /** 
 @page assfile .ASS File formats
@@ -22,7 +22,8 @@ the 'aiScene' data structure returned by the APIs. The focus for the binary form
 flavour, <tt>.assxml</tt> or simply .xml, is just a plain-to-xml conversion of aiScene.
 
 ASSBIN is Assimp's binary interchange format. assimp_cmd (<tt>&lt;root&gt;/tools/assimp_cmd</tt>) is able to 
-write it and the core library provides a loader for it.
+write it and the core library provides a loader and an exporter for it. The Importer's scene cache
+(#AI_CONFIG_GLOB_SCENE_CACHE) uses it to store post-processed scenes.
 
 @section assxml XML File format
 
@@ -37,8 +38,9 @@ at the output files generated by assimp_cmd.
 The ASSBIN file format is composed of chunks to represent the hierarchical aiScene data structure.
 This makes the format extensible and allows backward-compatibility with future data structure
 versions. The <tt>&lt;root&gt;/code/assbin_chunks.h</tt> header contains some magic constants
-for use by stand-alone ASSBIN loaders. Also, Assimp's own file writer can be found
-in <tt>&lt;root&gt;/tools/assimp_cmd/WriteDumb.cpp</tt> (yes, the 'b' is no typo ...).
+for use by stand-alone ASSBIN loaders. Also, Assimp's own file writers can be found
+in <tt>&lt;root&gt;/code/AssbinExporter.cpp</tt> and <tt>&lt;root&gt;/tools/assimp_cmd/WriteDumb.cpp</tt> 
+(yes, the 'b' is no typo ...), the loader in <tt>&lt;root&gt;/code/AssbinLoader.cpp</tt>.
 
 @verbatim
 
@@ -133,14 +135,12 @@ The general 'rule' to get from Assimp headers to the serialized layout is:
 
    [number of used uv channels times]
        integer mNumUVComponents[n]
-       float mTextureCoords[n][mNumUVComponents[n]]
+       float mTextureCoords[n][3]
 
        -> more than AI_MAX_TEXCOORD_CHANNELS can be stored. This allows Assimp 
 	   builds with different settings for AI_MAX_TEXCOORD_CHANNELS to exchange
-	   data. Unlike the in-memory format, only the used components of the 
-	   UV coordinates are written to disk. If mNumUVComponents[0] is 1, the
-	   corresponding mTextureCoords array consists of mNumTextureCoords*1 
-	   single floats.
+	   data. Like in the in-memory format, all three components of the 
+	   UV coordinates are written to disk, regardless of mNumUVComponents.
 
    - The array member block of aiMesh is prefixed with an integer that specifies 
      the kinds of vertex components actually present in the mesh. This is a 
@@ -154,6 +154,13 @@ The general 'rule' to get from Assimp headers to the serialized layout is:
 [[aiNode]]
 
    - mParent is omitted
+   - since 1.1: mMetaData is stored in a ASSBIN_CHUNK_AIEXTRA subchunk (see below)
+
+[[aiNodeAnim]]
+
+   - the keys are stored like in memory on common platforms:
+       aiVectorKey is double mTime, float mValue[3], 4 bytes of padding 
+       aiQuatKey is double mTime, float mValue[4] (w,x,y,z)
 
 [[aiLight]]
 
@@ -164,6 +171,27 @@ The general 'rule' to get from Assimp headers to the serialized layout is:
 
    - mNumAllocated is omitted, for obvious reasons :-)
 
+[[ASSBIN_CHUNK_AIEXTRA]]
+
+   Since 1.1, members that 1.0 did not store are written to a ASSBIN_CHUNK_AIEXTRA
+   subchunk following all other subchunks of their owner. Readers of older versions 
+   skip it, readers of newer versions must not rely on it being present.
+   Its contents depend on the type of the owner:
+
+   aiNode:	integer mMetaData->mNumProperties, only written if the node has metadata
+            [mNumProperties times]
+                string mKeys[n]
+                short  mValues[n].mType
+                value, as byte (AI_BOOL), integer (AI_INT), 8 byte integer (AI_UINT64),
+                float (AI_FLOAT), string (AI_AISTRING) or float[3] (AI_AIVECTOR3D)
+
+   aiMesh:	string mName
+
+   aiLight:	float[3] mPosition
+            float[3] mDirection
+
+   aiMesh::mAnimMeshes and aiAnimation::mMeshChannels are not stored at all.
+
 
  @endverbatim*/
 
@@ -182,6 +210,7 @@ The general 'rule' to get from Assimp headers to the serialized layout is:
 #define ASSBIN_CHUNK_AINODE						0x123c
 #define ASSBIN_CHUNK_AIMATERIAL					0x123d
 #define ASSBIN_CHUNK_AIMATERIALPROPERTY			0x123e
+#define ASSBIN_CHUNK_AIEXTRA					0x123f
 
 #define ASSBIN_MESH_HAS_POSITIONS					0x1
 #define ASSBIN_MESH_HAS_NORMALS						0x2
@@ -1319,6 +1319,35 @@ time got consumed by the #aiProcess_Triangulate, #aiProcess_JoinIdenticalVertice
 postprocessing steps. A wise selection of postprocessing steps is therefore essential to getting good performance. 
 Of course this depends on the individual requirements of your application, in many of the typical use cases of assimp performance won't 
 matter (i.e. in an offline content pipeline).
+
+Post processing steps that are executed together (see @link threading the Threading page @endlink) share a single
+<tt>postprocess</tt> region. The time spent in each of them, added up over all threads, is reported separately: 
+
+@verbatim
+Debug, T5488: TIME  `JoinVerticesProcess`, dt= 2.052 s
+@endverbatim
+
+@section perf_cache Scene cache
+
+Applications that load the same files over and over again can skip importing and post processing entirely by 
+enabling the scene cache. Set the <tt>GLOB_SCENE_CACHE</tt> configuration property (#AI_CONFIG_GLOB_SCENE_CACHE)
+to an existing directory:
+
+@code
+Assimp::Importer importer;
+importer.SetPropertyString(AI_CONFIG_GLOB_SCENE_CACHE,"cache");
+const aiScene* scene = importer.ReadFile("model.dae",aiProcessPreset_TargetRealtime_Quality);
+@endcode
+
+The first import of a file stores the post-processed scene as an assbin file in this directory. The next time
+the same file is imported with the same post processing flags and configuration properties, the scene is loaded from 
+there, which is usually a matter of milliseconds. The cache is keyed on a hash of the file's contents, so it notices
+changes of the file itself, but not of other files it refers to (i.e. material libraries). Delete the cache 
+directory in that case. The log tells whether a scene was loaded from the cache:
+
+@verbatim
+Info,  T5488: Loaded scene from cache cache/2c01e55f0005a3f2-0008b0ab-7a1c2e3d.assbin
+@endverbatim
 */
 
 /** 
@@ -1351,7 +1380,16 @@ with 'slow' file formats like X or Collada might scale well with multiple concur
 
 @section automt Internal threading
 
-Internal multi-threading is not currently implemented.
+The post processing steps that work on each mesh on its own (i.e. #aiProcess_CalcTangentSpace, 
+#aiProcess_JoinIdenticalVertices, #aiProcess_GenNormals, #aiProcess_GenSmoothNormals, #aiProcess_LimitBoneWeights
+and #aiProcess_ImproveCacheLocality) are executed in parallel on all meshes of the scene. Adjacent steps
+of this kind are fused, so each mesh passes through all of them at once while its data is still in the cache.
+Log messages are still written in the same order as in a single-threaded run.
+
+The number of worker threads is set with the <tt>GLOB_MULTITHREADING</tt> configuration switch: -1 (the default) 
+uses one thread per CPU, 0 processes the meshes on the calling thread only. Scenes with a single mesh
+don't profit from this. No threads are used if assimp is built with <tt>ASSIMP_BUILD_NO_THREADING</tt>, which
+is implied by compilers without C++11 support.
 */
 
 /**
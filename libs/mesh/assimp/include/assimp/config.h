@@ -91,12 +91,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 
 
-# if 0 // not implemented yet
 // ---------------------------------------------------------------------------
 /** @brief Set Assimp's multithreading policy.
  *
- * This setting is ignored if Assimp was built without boost.thread
- * support (ASSIMP_BUILD_NO_THREADING, which is implied by ASSIMP_BUILD_BOOST_WORKAROUND).
+ * This setting is ignored if Assimp was built without threading support
+ * (ASSIMP_BUILD_NO_THREADING, which is implied by compilers without C++11).
  * Possible values are: -1 to let Assimp decide what to do, 0 to disable
  * multithreading entirely and any number larger than 0 to force a specific
  * number of threads. Assimp is always free to ignore this settings, which is
@@ -109,7 +108,26 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 #define AI_CONFIG_GLOB_MULTITHREADING  \
 	"GLOB_MULTITHREADING"
-#endif
+
+// ---------------------------------------------------------------------------
+/** @brief Enables the scene cache and specifies its directory.
+ *
+ * If set, Importer::ReadFile() stores each scene it imports, including
+ * all post processing, as an assbin file in this directory. When the same
+ * file is imported again with the same post processing flags and settings,
+ * the scene is loaded from there instead, which is much faster. Cache files 
+ * are named after a hash of the contents of the file to be imported, so
+ * changed files are recognized - but not changes to other files it refers
+ * to, such as material libraries. The directory must exist, obsolete cache
+ * files are never removed. Scenes with mesh animations are not cached.
+ * This setting is ignored if Assimp was built without the assbin importer
+ * and exporter. See the @link perf Performance Page@endlink for more 
+ * information on this topic.
+ *
+ * Property type: String. Default value: "" (no caching).
+ */
+#define AI_CONFIG_GLOB_SCENE_CACHE  \
+	"GLOB_SCENE_CACHE"
 
 // ###########################################################################
 // POST PROCESSING SETTINGS
@@ -236,6 +236,15 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 	//////////////////////////////////////////////////////////////////////////
 #ifndef ASSIMP_BUILD_SINGLETHREADED
 #	define ASSIMP_BUILD_SINGLETHREADED
+#endif
+
+	//////////////////////////////////////////////////////////////////////////
+	/* Define ASSIMP_BUILD_NO_THREADING to run the post processing steps
+	 * on the calling thread only. Otherwise they use std::thread, which
+	 * needs a C++11 compiler, so the flag is implied for older ones. */
+	//////////////////////////////////////////////////////////////////////////
+#if !defined(ASSIMP_BUILD_NO_THREADING) && defined(__cplusplus) && __cplusplus < 201103L && !(defined(_MSC_VER) && _MSC_VER >= 1900)
+#	define ASSIMP_BUILD_NO_THREADING
 #endif
 
 #if defined(_DEBUG) || ! defined(NDEBUG)
@@ -0,0 +1,192 @@
+ 
+#include "UnitTestPCH.h"
+#include "utAssbin.h"
+#include "assbin_chunks.h"
+
+#if defined( _WIN32 )
+#	include <direct.h>
+#	include <process.h>
+#else
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+#ifndef ASSIMP_BUILD_NO_EXPORT
+
+CPPUNIT_TEST_SUITE_REGISTRATION (AssbinTest);
+
+// ------------------------------------------------------------------------------------------------
+// Remembers whether a scene was loaded from the scene cache, and which cache file was written
+class CacheHitStream : public LogStream
+{
+public:
+	CacheHitStream()
+		: hit()
+	{}
+
+	void write(const char* message) {
+		static const char written[] = "Wrote scene to cache ";
+		if (strstr(message,"Loaded scene from cache")) {
+			hit = true;
+		}
+		if (const char* s = strstr(message,written)) {
+			file = s + sizeof(written) - 1;
+			file.erase(file.find_last_not_of("\r\n ") + 1);
+		}
+	}
+
+	bool hit;
+	std::string file;
+};
+
+// ------------------------------------------------------------------------------------------------
+// Creates an empty directory in the system's temporary directory, returns "" on failure
+static std::string MakeTempDir()
+{
+#if defined( _WIN32 )
+	const char* tmp = ::getenv("TEMP");
+	std::ostringstream dir;
+	dir << (tmp ? tmp : ".") << "\\assimp_cache_" << _getpid();
+	return ::_mkdir(dir.str().c_str()) == 0 ? dir.str() : std::string();
+#else
+	const char* tmp = ::getenv("TMPDIR");
+	std::string name = std::string(tmp && *tmp ? tmp : "/tmp") + "/assimp_cache_XXXXXX";
+	std::vector<char> buff(name.begin(),name.end());
+	buff.push_back('\0');
+	return ::mkdtemp(&buff[0]) ? std::string(&buff[0]) : std::string();
+#endif
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinTest :: setUp (void)
+{
+	ex = new Assimp::Exporter();
+	im = new Assimp::Importer();
+
+	im->ReadFile("../../test/models/X/test.x",aiProcess_Triangulate | aiProcess_GenNormals);
+	pTest = im->GetOrphanedScene();
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinTest :: tearDown (void)
+{
+	delete pTest;
+	delete ex;
+	delete im;
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinTest :: CheckSameMeshes(const aiScene* a, const aiScene* b)
+{
+	CPPUNIT_ASSERT_EQUAL(a->mNumMeshes,b->mNumMeshes);
+	for (unsigned int i = 0; i < a->mNumMeshes; ++i) {
+		const aiMesh* ma = a->mMeshes[i], *mb = b->mMeshes[i];
+		CPPUNIT_ASSERT_EQUAL(ma->mNumVertices,mb->mNumVertices);
+		CPPUNIT_ASSERT_EQUAL(ma->mNumFaces,mb->mNumFaces);
+		CPPUNIT_ASSERT(!memcmp(ma->mVertices,mb->mVertices,ma->mNumVertices*sizeof(aiVector3D)));
+		CPPUNIT_ASSERT(mb->mNormals && !memcmp(ma->mNormals,mb->mNormals,ma->mNumVertices*sizeof(aiVector3D)));
+
+		for (unsigned int f = 0; f < ma->mNumFaces; ++f) {
+			CPPUNIT_ASSERT_EQUAL(ma->mFaces[f].mNumIndices,mb->mFaces[f].mNumIndices);
+			CPPUNIT_ASSERT(!memcmp(ma->mFaces[f].mIndices,mb->mFaces[f].mIndices,
+				ma->mFaces[f].mNumIndices*sizeof(unsigned int)));
+		}
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinTest :: testRoundtrip (void)
+{
+	CPPUNIT_ASSERT(pTest && pTest->mNumMeshes);
+
+	// add what assbin 1.0 files can't store
+	pTest->mMeshes[0]->mName.Set("mesh");
+
+	aiMetadata* md = pTest->mRootNode->mMetaData = new aiMetadata();
+	md->mNumProperties = 2;
+	md->mKeys = new aiString[2];
+	md->mValues = new aiMetadataEntry[2];
+	md->Set(0,"int",42);
+	md->Set(1,"vector",aiVector3D(1.f,2.f,3.f));
+
+	pTest->mLights = new aiLight*[1];
+	pTest->mLights[0] = new aiLight();
+	pTest->mLights[0]->mType = aiLightSource_SPOT;
+	pTest->mLights[0]->mPosition = aiVector3D(4.f,5.f,6.f);
+	pTest->mNumLights = 1;
+
+	const aiExportDataBlob* blob = ex->ExportToBlob(pTest,"assbin");
+	CPPUNIT_ASSERT(blob);
+
+	const aiScene* scene = im->ReadFileFromMemory(blob->data,blob->size,0,"assbin");
+	CPPUNIT_ASSERT(scene);
+	CheckSameMeshes(pTest,scene);
+	CPPUNIT_ASSERT_EQUAL(std::string("mesh"),std::string(scene->mMeshes[0]->mName.data));
+
+	CPPUNIT_ASSERT_EQUAL(pTest->mRootNode->mNumChildren,scene->mRootNode->mNumChildren);
+	for (unsigned int c = 0; c < scene->mRootNode->mNumChildren; ++c) {
+		CPPUNIT_ASSERT(scene->mRootNode->mChildren[c]->mParent == scene->mRootNode);
+	}
+
+	int i = 0;
+	aiVector3D v;
+	CPPUNIT_ASSERT(scene->mRootNode->mMetaData);
+	CPPUNIT_ASSERT(scene->mRootNode->mMetaData->Get("int",i) && i == 42);
+	CPPUNIT_ASSERT(scene->mRootNode->mMetaData->Get("vector",v) && v == aiVector3D(1.f,2.f,3.f));
+
+	CPPUNIT_ASSERT_EQUAL(1u,scene->mNumLights);
+	CPPUNIT_ASSERT_EQUAL(aiLightSource_SPOT,scene->mLights[0]->mType);
+	CPPUNIT_ASSERT(scene->mLights[0]->mPosition == aiVector3D(4.f,5.f,6.f));
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinTest :: testInvalidFile (void)
+{
+	const aiExportDataBlob* blob = ex->ExportToBlob(pTest,"assbin");
+	CPPUNIT_ASSERT(blob);
+
+	// truncated files must be rejected
+	for (size_t size = blob->size - 1; size > 512; size -= 97) {
+		CPPUNIT_ASSERT(!im->ReadFileFromMemory(blob->data,size,0,"assbin"));
+	}
+
+	// a compressed file claiming more data than its size can hold is rejected before allocating it
+	std::vector<uint8_t> bad(static_cast<const uint8_t*>(blob->data),static_cast<const uint8_t*>(blob->data) + ASSBIN_HEADER_LENGTH);
+	bad[62] = 1; // compressed flag, after the magic, the version, the revision and the shortened flag
+	bad.resize(ASSBIN_HEADER_LENGTH + 4 + 16,0xff);
+	CPPUNIT_ASSERT(!im->ReadFileFromMemory(&bad[0],bad.size(),0,"assbin"));
+}
+
+// ------------------------------------------------------------------------------------------------
+void AssbinTest :: testSceneCache (void)
+{
+	CacheHitStream* stream = new CacheHitStream();
+	DefaultLogger::get()->attachStream(stream,Logger::Info);
+
+	const std::string dir = MakeTempDir();
+	CPPUNIT_ASSERT(dir.length());
+
+	const unsigned int flags = aiProcess_Triangulate | aiProcess_GenNormals;
+	im->SetPropertyString(AI_CONFIG_GLOB_SCENE_CACHE,dir);
+
+	// the first import fills the cache
+	CPPUNIT_ASSERT(im->ReadFile("../../test/models/X/test.x",flags));
+	CPPUNIT_ASSERT(!stream->hit);
+	CPPUNIT_ASSERT(stream->file.length());
+
+	const aiScene* scene = im->ReadFile("../../test/models/X/test.x",flags);
+	CPPUNIT_ASSERT(scene);
+	CPPUNIT_ASSERT(stream->hit);
+	CheckSameMeshes(pTest,scene);
+
+	DefaultLogger::get()->detatchStream(stream,Logger::Info);
+	::remove(stream->file.c_str());
+#if defined( _WIN32 )
+	::_rmdir(dir.c_str());
+#else
+	::rmdir(dir.c_str());
+#endif
+	delete stream;
+}
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef INCLUDED_UT_ASSBIN_H
+#define INCLUDED_UT_ASSBIN_H
+
+#ifndef ASSIMP_BUILD_NO_EXPORT
+
+#include <assimp/Exporter.hpp>
+
+using namespace Assimp;
+
+class AssbinTest : public CPPUNIT_NS :: TestFixture
+{
+    CPPUNIT_TEST_SUITE (AssbinTest);
+	CPPUNIT_TEST (testRoundtrip);
+	CPPUNIT_TEST (testInvalidFile);
+	CPPUNIT_TEST (testSceneCache);
+    CPPUNIT_TEST_SUITE_END ();
+
+    public:
+        void setUp (void);
+        void tearDown (void);
+
+    protected:
+
+        void  testRoundtrip (void);
+		void  testInvalidFile (void);
+		void  testSceneCache (void);
+   
+	private:
+
+		void CheckSameMeshes(const aiScene* a, const aiScene* b);
+
+		aiScene* pTest;
+		Assimp::Exporter* ex;
+		Assimp::Importer* im;
+};
+
+#endif
+
+#endif 
@@ -0,0 +1,132 @@
+
+#include "UnitTestPCH.h"
+#include "utMeshProcess.h"
+
+#include <Importer.h>
+#include <GenVertexNormalsProcess.h>
+#include <JoinVerticesProcess.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION (MeshProcessTest);
+
+// ------------------------------------------------------------------------------------------------
+// Fails on the fourth mesh
+class FailingProcess : public MeshProcess
+{
+public:
+	bool IsActive( unsigned int /*pFlags*/) const {
+		return true;
+	}
+
+	const char* GetName() const {
+		return "FailingProcess";
+	}
+
+	void ExecuteOnMesh( aiMesh* /*pMesh*/, unsigned int meshIndex) {
+		if (meshIndex == 3) {
+			throw DeadlyImportError("FailingProcess failed");
+		}
+	}
+};
+
+// ------------------------------------------------------------------------------------------------
+void MeshProcessTest :: setUp (void)
+{
+	pImp = new Importer();
+}
+
+// ------------------------------------------------------------------------------------------------
+void MeshProcessTest :: tearDown (void)
+{
+	delete pImp;
+}
+
+// ------------------------------------------------------------------------------------------------
+aiScene* MeshProcessTest :: CreateScene()
+{
+	// a couple of meshes of different size, each vertex is referenced by three faces
+	aiScene* pcScene = new aiScene();
+	pcScene->mRootNode = new aiNode();
+	pcScene->mNumMeshes = 10;
+	pcScene->mMeshes = new aiMesh*[10];
+	for (unsigned int m = 0; m < 10;++m)
+	{
+		aiMesh* pcMesh = pcScene->mMeshes[m] = new aiMesh();
+		const unsigned int num = (m+1)*30;
+
+		pcMesh->mNumVertices = num*9;
+		pcMesh->mVertices = new aiVector3D[num*9];
+		pcMesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+		pcMesh->mNumFaces = num*3;
+		pcMesh->mFaces = new aiFace[num*3];
+		for (unsigned int i = 0,p = 0; i < num*3;++i)
+		{
+			aiFace& face = pcMesh->mFaces[i];
+			face.mIndices = new unsigned int[ face.mNumIndices = 3 ];
+			for (unsigned int a = 0; a < 3;++a,++p)
+			{
+				const unsigned int n = (i%num)*3 + a;
+				pcMesh->mVertices[p] = aiVector3D((float)(n%7),(float)(n/7),(float)(n%5 + m));
+				face.mIndices[a] = p;
+			}
+		}
+	}
+	return pcScene;
+}
+
+// ------------------------------------------------------------------------------------------------
+void MeshProcessTest :: testFused(void)
+{
+	// execute the steps one after another
+	aiScene* pcScene = CreateScene();
+
+	GenVertexNormalsProcess normals;
+	JoinVerticesProcess join;
+	normals.SetupProperties(pImp);
+	join.SetupProperties(pImp);
+
+	normals.Execute(pcScene);
+	join.Execute(pcScene);
+
+	// and fused, on four threads
+	pImp->Pimpl()->mScene = CreateScene();
+
+	MeshProcess* steps[] = {&normals,&join};
+	MeshProcess::ExecuteFused(pImp,steps,2,4,NULL);
+
+	const aiScene* pcFused = pImp->GetScene();
+	CPPUNIT_ASSERT(NULL != pcFused);
+	CPPUNIT_ASSERT(pcFused->mFlags & AI_SCENE_FLAGS_NON_VERBOSE_FORMAT);
+
+	// the results must be identical
+	for (unsigned int m = 0; m < 10;++m)
+	{
+		const aiMesh* a = pcScene->mMeshes[m], *b = pcFused->mMeshes[m];
+		CPPUNIT_ASSERT(a->mNumVertices == b->mNumVertices);
+		CPPUNIT_ASSERT(a->mNumVertices < a->mNumFaces*3);
+		CPPUNIT_ASSERT(NULL != b->mNormals);
+		CPPUNIT_ASSERT(!memcmp(a->mVertices,b->mVertices,a->mNumVertices*sizeof(aiVector3D)));
+		CPPUNIT_ASSERT(!memcmp(a->mNormals,b->mNormals,a->mNumVertices*sizeof(aiVector3D)));
+
+		CPPUNIT_ASSERT(a->mNumFaces == b->mNumFaces);
+		for (unsigned int i = 0; i < a->mNumFaces;++i)
+		{
+			CPPUNIT_ASSERT(!memcmp(a->mFaces[i].mIndices,b->mFaces[i].mIndices,3*sizeof(unsigned int)));
+		}
+	}
+	delete pcScene;
+}
+
+// ------------------------------------------------------------------------------------------------
+void MeshProcessTest :: testFusedFailure(void)
+{
+	pImp->Pimpl()->mScene = CreateScene();
+
+	JoinVerticesProcess join;
+	FailingProcess fail;
+	MeshProcess* steps[] = {&join,&fail};
+	MeshProcess::ExecuteFused(pImp,steps,2,4,NULL);
+
+	// the scene is deleted as if a single step had failed
+	CPPUNIT_ASSERT(NULL == pImp->GetScene());
+	CPPUNIT_ASSERT(!strcmp(pImp->GetErrorString(),"FailingProcess failed"));
+}
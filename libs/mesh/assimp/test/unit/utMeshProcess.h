@@ -0,0 +1,37 @@
+#ifndef TESTMESHPROCESS_H
+#define TESTMESHPROCESS_H
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <assimp/scene.h>
+#include <BaseProcess.h>
+
+
+using namespace std;
+using namespace Assimp;
+
+class MeshProcessTest : public CPPUNIT_NS :: TestFixture
+{
+    CPPUNIT_TEST_SUITE (MeshProcessTest);
+    CPPUNIT_TEST (testFused);
+	CPPUNIT_TEST (testFusedFailure);
+    CPPUNIT_TEST_SUITE_END ();
+
+    public:
+        void setUp (void);
+        void tearDown (void);
+
+    protected:
+
+        void  testFused (void);
+		void  testFusedFailure (void);
+   
+	private:
+
+		aiScene* CreateScene();
+
+		Importer* pImp;
+};
+
+#endif 
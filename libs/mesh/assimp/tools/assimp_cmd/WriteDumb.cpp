@@ -67,7 +67,7 @@ bool shortened = false;
 void CompressBinaryDump(const char* file, unsigned int head_size)
 {
 	// for simplicity ... copy the file into memory again and compress it there
-	FILE* p = fopen(file,"r");
+	FILE* p = fopen(file,"rb");
 	fseek(p,0,SEEK_END);
 	const uint32_t size = ftell(p);
 	fseek(p,0,SEEK_SET);
@@ -80,15 +80,16 @@ void CompressBinaryDump(const char* file, unsigned int head_size)
 	uint8_t* data = new uint8_t[size];
 	fread(data,1,size,p);
 
-	uLongf out_size = (uLongf)((size-head_size) * 1.001 + 12.);
+	const uint32_t in_size = size-head_size;
+	uLongf out_size = (uLongf)(in_size * 1.001 + 12.);
 	uint8_t* out = new uint8_t[out_size];
 
-	compress2(out,&out_size,data+head_size,size-head_size,9);
+	compress2(out,&out_size,data+head_size,in_size,9);
 	fclose(p);
-	p = fopen(file,"w");
+	p = fopen(file,"wb");
 
 	fwrite(data,head_size,1,p);
-	fwrite(&out_size,4,1,p); // write size of uncompressed data
+	fwrite(&in_size,4,1,p); // write size of uncompressed data
 	fwrite(out,out_size,1,p);
 
 	fclose(p);
@@ -393,7 +394,7 @@ uint32_t WriteBinaryMesh(const aiMesh* mesh)
 		if (shortened) {
 			len += WriteBounds(mesh->mColors[n],mesh->mNumVertices);
 		} // else write as usual
-		else len += fwrite(mesh->mColors[n],16*mesh->mNumVertices,1,out);
+		else len += fwrite(mesh->mColors[n],1,16*mesh->mNumVertices,out);
 	}
 	for (unsigned int n = 0; n < AI_MAX_NUMBER_OF_TEXTURECOORDS;++n) {
 		if (!mesh->mTextureCoords[n])
@@ -405,7 +406,7 @@ uint32_t WriteBinaryMesh(const aiMesh* mesh)
 		if (shortened) {
 			len += WriteBounds(mesh->mTextureCoords[n],mesh->mNumVertices);
 		} // else write as usual
-		else len += fwrite(mesh->mTextureCoords[n],12*mesh->mNumVertices,1,out);
+		else len += fwrite(mesh->mTextureCoords[n],1,12*mesh->mNumVertices,out);
 	}
 
 	// write faces. There are no floating-point calculations involved
@@ -156,6 +156,9 @@ enet_host_destroy (ENetHost * host)
     if (host -> compressor.context != NULL && host -> compressor.destroy)
       (* host -> compressor.destroy) (host -> compressor.context);
 
+    enet_host_batch_limit (host, 0);
+    enet_host_packet_pool_limit (host, 0);
+
     enet_free (host -> peers);
     enet_free (host);
 }
@@ -308,6 +311,71 @@ enet_host_channel_limit (ENetHost * host, size_t channelLimit)
 }
 
 
+/** Enables batched socket I/O for a host.  Incoming datagrams are then received up to datagramLimit
+    per call, and the outgoing datagrams of all peers are gathered and sent together.  On Linux this uses
+    recvmmsg/sendmmsg and enet_host_service() waits with epoll; elsewhere the datagrams still go through one
+    call each.  Hosts serving many peers save a system call per datagram.
+    @param host host to adjust
+    @param datagramLimit maximum datagrams per socket call, at most ENET_HOST_BATCH_MAXIMUM; 0 disables batching
+    @retval 0 on success
+    @retval < 0 on failure, batching is then disabled
+    @remarks datagrams already received but not yet processed are discarded when the limit is changed.
+*/
+int
+enet_host_batch_limit (ENetHost * host, size_t datagramLimit)
+{
+    ENetHostBatch * batch;
+    ENetBuffer * buffers;
+    enet_uint8 * data;
+    size_t i;
+
+    if (host -> batch != NULL)
+    {
+       if (host -> batch -> poller != ENET_SOCKET_NULL)
+         enet_socket_destroy (host -> batch -> poller);
+
+       enet_free (host -> batch);
+       host -> batch = NULL;
+    }
+
+    if (datagramLimit == 0)
+      return 0;
+
+    if (datagramLimit > ENET_HOST_BATCH_MAXIMUM)
+      datagramLimit = ENET_HOST_BATCH_MAXIMUM;
+
+    /* one allocation: the batch, a message and a buffer per receive and send slot, then the slots' data */
+    batch = (ENetHostBatch *) enet_malloc (sizeof (ENetHostBatch) +
+                                           2 * datagramLimit * (sizeof (ENetSocketMessage) + sizeof (ENetBuffer) + ENET_PROTOCOL_MAXIMUM_MTU));
+    if (batch == NULL)
+      return -1;
+    memset (batch, 0, sizeof (ENetHostBatch));
+
+    batch -> datagramLimit = datagramLimit;
+    batch -> receivedMessages = (ENetSocketMessage *) (batch + 1);
+    batch -> sendMessages = & batch -> receivedMessages [datagramLimit];
+    buffers = (ENetBuffer *) & batch -> sendMessages [datagramLimit];
+    data = (enet_uint8 *) & buffers [2 * datagramLimit];
+
+    for (i = 0; i < 2 * datagramLimit; ++ i)
+    {
+       ENetSocketMessage * message = & batch -> receivedMessages [i];
+
+       buffers [i].data = & data [i * ENET_PROTOCOL_MAXIMUM_MTU];
+       buffers [i].dataLength = ENET_PROTOCOL_MAXIMUM_MTU;
+
+       message -> buffers = & buffers [i];
+       message -> bufferCount = 1;
+       message -> dataLength = 0;
+    }
+
+    batch -> poller = enet_socket_poller_create (host -> socket);
+
+    host -> batch = batch;
+
+    return 0;
+}
+
 /** Adjusts the bandwidth limits of a host.
     @param host host to adjust
     @param incomingBandwidth new incoming bandwidth
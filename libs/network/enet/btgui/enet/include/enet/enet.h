@@ -44,8 +44,9 @@ typedef enum _ENetSocketType
 typedef enum _ENetSocketWait
 {
    ENET_SOCKET_WAIT_NONE    = 0,
-   ENET_SOCKET_WAIT_SEND    = (1 << 0),
-   ENET_SOCKET_WAIT_RECEIVE = (1 << 1)
+   ENET_SOCKET_WAIT_SEND      = (1 << 0),
+   ENET_SOCKET_WAIT_RECEIVE   = (1 << 1),
+   ENET_SOCKET_WAIT_INTERRUPT = (1 << 2)
 } ENetSocketWait;
 
 typedef enum _ENetSocketOption
@@ -66,6 +67,11 @@ typedef enum _ENetSocketShutdown
     ENET_SOCKET_SHUTDOWN_READ_WRITE = 2
 } ENetSocketShutdown;
 
+enum
+{
+   ENET_SOCKET_MESSAGE_MAXIMUM = 64   /**< most datagrams handed to the kernel in one batched socket call */
+};
+
 enum
 {
    ENET_HOST_ANY       = 0,            /**< specifies the default server host */
@@ -90,6 +96,21 @@ typedef struct _ENetAddress
    enet_uint16 port;
 } ENetAddress;
 
+/**
+ * One datagram of a batched socket send or receive.
+ *
+ * For enet_socket_send_messages() the buffers hold the datagram and address its destination.
+ * For enet_socket_receive_messages() the buffers provide the storage; address and dataLength
+ * are filled in with the sender and the received length.
+ */
+typedef struct _ENetSocketMessage
+{
+   ENetAddress  address;
+   ENetBuffer * buffers;
+   size_t       bufferCount;
+   size_t       dataLength;
+} ENetSocketMessage;
+
 /**
  * Packet flag bit constants.
  *
@@ -115,7 +136,9 @@ typedef enum _ENetPacketFlag
    ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT = (1 << 3),
 
    /** whether the packet has been sent from all queues it has been entered into */
-   ENET_PACKET_FLAG_SENT = (1<<8)
+   ENET_PACKET_FLAG_SENT = (1<<8),
+   /** packet and its data live in a host packet pool, internal use only */
+   ENET_PACKET_FLAG_POOLED = (1<<9)
 } ENetPacketFlag;
 
 typedef void (ENET_CALLBACK * ENetPacketFreeCallback) (struct _ENetPacket *);
@@ -227,7 +250,9 @@ enum
    ENET_PEER_FREE_UNSEQUENCED_WINDOWS     = 32,
    ENET_PEER_RELIABLE_WINDOWS             = 16,
    ENET_PEER_RELIABLE_WINDOW_SIZE         = 0x1000,
-   ENET_PEER_FREE_RELIABLE_WINDOWS        = 8
+   ENET_PEER_FREE_RELIABLE_WINDOWS        = 8,
+
+   ENET_HOST_BATCH_MAXIMUM                = ENET_SOCKET_MESSAGE_MAXIMUM
 };
 
 typedef struct _ENetChannel
@@ -310,6 +335,46 @@ typedef struct _ENetPeer
    enet_uint32   eventData;
 } ENetPeer;
 
+/** Datagram staging for a host with batched socket I/O enabled.
+
+    @sa enet_host_batch_limit()
+*/
+typedef struct _ENetHostBatch
+{
+   size_t              datagramLimit;
+   ENetSocket          poller;            /**< epoll descriptor waited on by enet_host_service(), or ENET_SOCKET_NULL */
+   ENetSocketMessage * receivedMessages;
+   size_t              receivedCount;
+   size_t              receivedIndex;     /**< next received datagram to process, datagrams are left here when an event interrupts the batch */
+   ENetSocketMessage * sendMessages;
+   size_t              sendCount;
+} ENetHostBatch;
+
+enum
+{
+   ENET_PACKET_POOL_CLASSES           = 4,
+   ENET_PACKET_POOL_SLAB_SIZE         = 64 * 1024,
+   ENET_PACKET_POOL_COMMAND_MAXIMUM   = 4096
+};
+
+/** Size-classed slabs of packets, plus recycled command and acknowledgement blocks, for a host
+    with pooling enabled.  The pool outlives its host while pooled packets are still held by the user.
+
+    @sa enet_host_packet_pool_limit()
+    @sa enet_host_packet_create()
+*/
+typedef struct _ENetPacketPool
+{
+   struct _ENetHost * host;                                        /**< owning host, NULL once the host has released the pool */
+   size_t             slabLimit;                                   /**< maximum slabs per size class */
+   size_t             slabCount [ENET_PACKET_POOL_CLASSES];
+   void *             slabs;                                       /**< singly linked list of every slab allocated */
+   void *             freePackets [ENET_PACKET_POOL_CLASSES];
+   size_t             outstandingPackets;                          /**< pooled packets created and not yet destroyed */
+   void *             freeCommands;
+   size_t             freeCommandCount;
+} ENetPacketPool;
+
 /** An ENet packet compressor for compressing UDP packets before socket sends or receives.
  */
 typedef struct _ENetCompressor
@@ -379,6 +444,8 @@ typedef struct _ENetHost
    enet_uint32          totalReceivedData;           /**< total data received, user should reset to 0 as needed to prevent overflow */
    enet_uint32          totalReceivedPackets;        /**< total UDP packets received, user should reset to 0 as needed to prevent overflow */
    ENetInterceptCallback intercept;                  /**< callback the user can set to intercept received raw UDP packets */
+   ENetHostBatch *      batch;                       /**< batched socket I/O state, NULL unless enabled with enet_host_batch_limit() */
+   ENetPacketPool *     packetPool;                  /**< packet and command pool, NULL unless enabled with enet_host_packet_pool_limit() */
 } ENetHost;
 
 /**
@@ -482,6 +549,20 @@ ENET_API int        enet_socket_shutdown (ENetSocket, ENetSocketShutdown);
 ENET_API void       enet_socket_destroy (ENetSocket);
 ENET_API int        enet_socketset_select (ENetSocket, ENetSocketSet *, ENetSocketSet *, enet_uint32);
 
+/** Sends or receives up to messageCount datagrams (at most ENET_SOCKET_MESSAGE_MAXIMUM per system call).
+    Uses sendmmsg/recvmmsg on Linux and one call per datagram elsewhere.
+    @returns the number of datagrams sent or received, 0 if the socket would block, < 0 on failure
+*/
+ENET_API int        enet_socket_send_messages (ENetSocket, ENetSocketMessage *, size_t);
+ENET_API int        enet_socket_receive_messages (ENetSocket, ENetSocketMessage *, size_t);
+
+/** Creates an epoll descriptor watching the socket for incoming data, where supported.
+    @returns the poller, or ENET_SOCKET_NULL if the platform has none; destroy it with enet_socket_destroy()
+*/
+ENET_API ENetSocket enet_socket_poller_create (ENetSocket);
+/** Same contract as enet_socket_wait(), for a socket watched by a poller.  Only ENET_SOCKET_WAIT_RECEIVE and ENET_SOCKET_WAIT_INTERRUPT are reported. */
+ENET_API int        enet_socket_poller_wait (ENetSocket, enet_uint32 *, enet_uint32);
+
 /** @} */
 
 /** @defgroup Address ENet address functions
@@ -535,9 +616,15 @@ ENET_API void       enet_host_compress (ENetHost *, const ENetCompressor *);
 ENET_API int        enet_host_compress_with_range_coder (ENetHost * host);
 ENET_API void       enet_host_channel_limit (ENetHost *, size_t);
 ENET_API void       enet_host_bandwidth_limit (ENetHost *, enet_uint32, enet_uint32);
+ENET_API int        enet_host_batch_limit (ENetHost *, size_t);
+ENET_API int        enet_host_packet_pool_limit (ENetHost *, size_t);
+ENET_API ENetPacket * enet_host_packet_create (ENetHost *, const void *, size_t, enet_uint32);
+extern   void *     enet_host_command_allocate (ENetHost *);
+extern   void       enet_host_command_free (ENetHost *, void *);
 extern   void       enet_host_bandwidth_throttle (ENetHost *);
 
 ENET_API int                 enet_peer_send (ENetPeer *, enet_uint8, ENetPacket *);
+ENET_API int                 enet_peer_send_batch (ENetPeer *, enet_uint8, ENetPacket * const *, size_t);
 ENET_API ENetPacket *        enet_peer_receive (ENetPeer *, enet_uint8 * channelID);
 ENET_API void                enet_peer_ping (ENetPeer *);
 ENET_API void                enet_peer_ping_interval (ENetPeer *, enet_uint32);
@@ -10,6 +10,98 @@
     @{ 
 */
 
+static const size_t packetPoolClassSizes [ENET_PACKET_POOL_CLASSES] = { 64, 256, 1024, ENET_PROTOCOL_MAXIMUM_MTU };
+
+typedef struct _ENetPooledPacket
+{
+    ENetPacket packet;
+    ENetPacketPool * pool;
+    struct _ENetPooledPacket * next;
+    size_t sizeClass;
+} ENetPooledPacket;
+
+/** Commands and acknowledgements share one block size so any of them can be recycled as another. */
+typedef union _ENetCommandBlock
+{
+    ENetOutgoingCommand outgoingCommand;
+    ENetIncomingCommand incomingCommand;
+    ENetAcknowledgement acknowledgement;
+    union _ENetCommandBlock * next;
+} ENetCommandBlock;
+
+#define ENET_PACKET_POOL_SLAB_HEADER 16
+#define ENET_POOLED_PACKET_DATA(pooledPacket) ((enet_uint8 *) ((pooledPacket) + 1))
+#define ENET_POOLED_PACKET_STRIDE(sizeClass) ((sizeof (ENetPooledPacket) + packetPoolClassSizes [sizeClass] + 15) & ~ (size_t) 15)
+
+static void
+enet_packet_pool_destroy (ENetPacketPool * pool)
+{
+    while (pool -> slabs != NULL)
+    {
+       void * slab = pool -> slabs;
+
+       pool -> slabs = * (void **) slab;
+
+       enet_free (slab);
+    }
+
+    enet_free (pool);
+}
+
+static int
+enet_packet_pool_grow (ENetPacketPool * pool, size_t sizeClass)
+{
+    size_t stride = ENET_POOLED_PACKET_STRIDE (sizeClass),
+           packetCount = (ENET_PACKET_POOL_SLAB_SIZE - ENET_PACKET_POOL_SLAB_HEADER) / stride,
+           packetIndex;
+    enet_uint8 * slab;
+
+    if (pool -> slabCount [sizeClass] >= pool -> slabLimit)
+      return 0;
+
+    slab = (enet_uint8 *) enet_malloc (ENET_PACKET_POOL_SLAB_HEADER + packetCount * stride);
+    if (slab == NULL)
+      return 0;
+
+    * (void **) slab = pool -> slabs;
+    pool -> slabs = slab;
+    ++ pool -> slabCount [sizeClass];
+
+    for (packetIndex = 0; packetIndex < packetCount; ++ packetIndex)
+    {
+       ENetPooledPacket * pooledPacket = (ENetPooledPacket *) & slab [ENET_PACKET_POOL_SLAB_HEADER + packetIndex * stride];
+
+       pooledPacket -> pool = pool;
+       pooledPacket -> sizeClass = sizeClass;
+       pooledPacket -> next = (ENetPooledPacket *) pool -> freePackets [sizeClass];
+       pool -> freePackets [sizeClass] = pooledPacket;
+    }
+
+    return 1;
+}
+
+static void
+enet_packet_pool_recycle (ENetPooledPacket * pooledPacket)
+{
+    ENetPacketPool * pool = pooledPacket -> pool;
+
+    if (pooledPacket -> packet.data != ENET_POOLED_PACKET_DATA (pooledPacket))
+      enet_free (pooledPacket -> packet.data);
+
+    -- pool -> outstandingPackets;
+
+    if (pool -> host == NULL)
+    {
+       if (pool -> outstandingPackets == 0)
+         enet_packet_pool_destroy (pool);
+
+       return;
+    }
+
+    pooledPacket -> next = (ENetPooledPacket *) pool -> freePackets [pooledPacket -> sizeClass];
+    pool -> freePackets [pooledPacket -> sizeClass] = pooledPacket;
+}
+
 /** Creates a packet that may be sent to a peer.
     @param dataContents initial contents of the packet's data; the packet's data will remain uninitialized if dataContents is NULL.
     @param dataLength   size of the data allocated for this packet
@@ -61,6 +153,11 @@ enet_packet_destroy (ENetPacket * packet)
 
     if (packet -> freeCallback != NULL)
       (* packet -> freeCallback) (packet);
+    if (packet -> flags & ENET_PACKET_FLAG_POOLED)
+    {
+       enet_packet_pool_recycle ((ENetPooledPacket *) packet);
+       return;
+    }
     if (! (packet -> flags & ENET_PACKET_FLAG_NO_ALLOCATE) &&
         packet -> data != NULL)
       enet_free (packet -> data);
@@ -77,6 +174,7 @@ int
 enet_packet_resize (ENetPacket * packet, size_t dataLength)
 {
     enet_uint8 * newData;
+    int pooledData = 0;
    
     if (dataLength <= packet -> dataLength || (packet -> flags & ENET_PACKET_FLAG_NO_ALLOCATE))
     {
@@ -85,12 +183,26 @@ enet_packet_resize (ENetPacket * packet, size_t dataLength)
        return 0;
     }
 
+    if (packet -> flags & ENET_PACKET_FLAG_POOLED)
+    {
+       ENetPooledPacket * pooledPacket = (ENetPooledPacket *) packet;
+
+       pooledData = packet -> data == ENET_POOLED_PACKET_DATA (pooledPacket);
+       if (pooledData && dataLength <= packetPoolClassSizes [pooledPacket -> sizeClass])
+       {
+          packet -> dataLength = dataLength;
+
+          return 0;
+       }
+    }
+
     newData = (enet_uint8 *) enet_malloc (dataLength);
     if (newData == NULL)
       return -1;
 
     memcpy (newData, packet -> data, packet -> dataLength);
-    enet_free (packet -> data);
+    if (! pooledData)
+      enet_free (packet -> data);
     
     packet -> data = newData;
     packet -> dataLength = dataLength;
@@ -98,6 +210,147 @@ enet_packet_resize (ENetPacket * packet, size_t dataLength)
     return 0;
 }
 
+/** Enables or resizes the packet pool of a host.  Packets created with enet_host_packet_create(), including
+    every packet the host receives, then come from size-classed slabs instead of two heap allocations each,
+    and the host recycles its command and acknowledgement blocks.  Packets larger than the biggest size class,
+    or beyond the slab limit, fall back to enet_packet_create().
+    @param host host to adjust
+    @param slabLimit maximum number of ENET_PACKET_POOL_SLAB_SIZE slabs per size class; 0 releases the pool
+    @retval 0 on success
+    @retval < 0 on failure
+    @remarks pooled packets still held by the application stay valid after the pool is released or the host
+    destroyed, but must be destroyed on the thread that services the host.
+*/
+int
+enet_host_packet_pool_limit (ENetHost * host, size_t slabLimit)
+{
+    ENetPacketPool * pool = host -> packetPool;
+
+    if (slabLimit == 0)
+    {
+       if (pool == NULL)
+         return 0;
+
+       while (pool -> freeCommands != NULL)
+       {
+          ENetCommandBlock * block = (ENetCommandBlock *) pool -> freeCommands;
+
+          pool -> freeCommands = block -> next;
+
+          enet_free (block);
+       }
+
+       pool -> freeCommandCount = 0;
+       pool -> host = NULL;
+       host -> packetPool = NULL;
+
+       if (pool -> outstandingPackets == 0)
+         enet_packet_pool_destroy (pool);
+
+       return 0;
+    }
+
+    if (pool == NULL)
+    {
+       pool = (ENetPacketPool *) enet_malloc (sizeof (ENetPacketPool));
+       if (pool == NULL)
+         return -1;
+
+       memset (pool, 0, sizeof (ENetPacketPool));
+
+       pool -> host = host;
+       host -> packetPool = pool;
+    }
+
+    pool -> slabLimit = slabLimit;
+
+    return 0;
+}
+
+/** Creates a packet from the packet pool of a host, or with enet_packet_create() if the host has no pool.
+    Passing NULL data leaves the packet uninitialized so the application can serialize directly into packet -> data.
+    A packet broadcast with enet_host_broadcast() is shared by every peer and returns to the pool once the last
+    peer is done with it.
+    @param host host whose pool to allocate from
+    @param data initial contents of the packet's data, or NULL
+    @param dataLength size of the data allocated for this packet
+    @param flags flags for this packet as described for the ENetPacket structure.
+    @returns the packet on success, NULL on failure
+*/
+ENetPacket *
+enet_host_packet_create (ENetHost * host, const void * data, size_t dataLength, enet_uint32 flags)
+{
+    ENetPacketPool * pool = host -> packetPool;
+    ENetPooledPacket * pooledPacket;
+    size_t sizeClass;
+
+    if (pool == NULL || (flags & ENET_PACKET_FLAG_NO_ALLOCATE))
+      return enet_packet_create (data, dataLength, flags);
+
+    for (sizeClass = 0; sizeClass < ENET_PACKET_POOL_CLASSES; ++ sizeClass)
+    {
+       if (dataLength <= packetPoolClassSizes [sizeClass])
+         break;
+    }
+
+    if (sizeClass >= ENET_PACKET_POOL_CLASSES ||
+        (pool -> freePackets [sizeClass] == NULL && ! enet_packet_pool_grow (pool, sizeClass)))
+      return enet_packet_create (data, dataLength, flags);
+
+    pooledPacket = (ENetPooledPacket *) pool -> freePackets [sizeClass];
+    pool -> freePackets [sizeClass] = pooledPacket -> next;
+    ++ pool -> outstandingPackets;
+
+    pooledPacket -> packet.referenceCount = 0;
+    pooledPacket -> packet.flags = flags | ENET_PACKET_FLAG_POOLED;
+    pooledPacket -> packet.data = ENET_POOLED_PACKET_DATA (pooledPacket);
+    pooledPacket -> packet.dataLength = dataLength;
+    pooledPacket -> packet.freeCallback = NULL;
+    pooledPacket -> packet.userData = NULL;
+
+    if (data != NULL && dataLength > 0)
+      memcpy (pooledPacket -> packet.data, data, dataLength);
+
+    return & pooledPacket -> packet;
+}
+
+void *
+enet_host_command_allocate (ENetHost * host)
+{
+    ENetPacketPool * pool = host -> packetPool;
+
+    if (pool != NULL && pool -> freeCommands != NULL)
+    {
+       ENetCommandBlock * block = (ENetCommandBlock *) pool -> freeCommands;
+
+       pool -> freeCommands = block -> next;
+       -- pool -> freeCommandCount;
+
+       return block;
+    }
+
+    return enet_malloc (sizeof (ENetCommandBlock));
+}
+
+void
+enet_host_command_free (ENetHost * host, void * command)
+{
+    ENetPacketPool * pool = host -> packetPool;
+
+    if (pool != NULL && pool -> freeCommandCount < ENET_PACKET_POOL_COMMAND_MAXIMUM)
+    {
+       ENetCommandBlock * block = (ENetCommandBlock *) command;
+
+       block -> next = (ENetCommandBlock *) pool -> freeCommands;
+       pool -> freeCommands = block;
+       ++ pool -> freeCommandCount;
+
+       return;
+    }
+
+    enet_free (command);
+}
+
 static int initializedCRC32 = 0;
 static enet_uint32 crcTable [256];
 
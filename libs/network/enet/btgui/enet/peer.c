@@ -89,29 +89,65 @@ enet_peer_throttle (ENetPeer * peer, enet_uint32 rtt)
     return 0;
 }
 
-/** Queues a packet to be sent.
-    @param peer destination for the packet
-    @param channelID channel on which to send
-    @param packet packet to send
-    @retval 0 on success
-    @retval < 0 on failure
-*/
-int
-enet_peer_send (ENetPeer * peer, enet_uint8 channelID, ENetPacket * packet)
+static size_t
+enet_peer_fragment_length (ENetPeer * peer)
 {
-   ENetChannel * channel = & peer -> channels [channelID];
-   ENetProtocol command;
-   size_t fragmentLength;
-
-   if (peer -> state != ENET_PEER_STATE_CONNECTED ||
-       channelID >= peer -> channelCount ||
-       packet -> dataLength > ENET_PROTOCOL_MAXIMUM_PACKET_SIZE)
-     return -1;
-
-   fragmentLength = peer -> mtu - sizeof (ENetProtocolHeader) - sizeof (ENetProtocolSendFragment);
+   size_t fragmentLength = peer -> mtu - sizeof (ENetProtocolHeader) - sizeof (ENetProtocolSendFragment);
    if (peer -> host -> checksum != NULL)
      fragmentLength -= sizeof(enet_uint32);
 
+   return fragmentLength;
+}
+
+/** Number of outgoing commands needed to send a packet, or 0 if it is too large to send. */
+static enet_uint32
+enet_peer_packet_command_count (const ENetPacket * packet, size_t fragmentLength)
+{
+   enet_uint32 fragmentCount;
+
+   if (packet -> dataLength > ENET_PROTOCOL_MAXIMUM_PACKET_SIZE)
+     return 0;
+
+   if (packet -> dataLength <= fragmentLength)
+     return 1;
+
+   fragmentCount = (packet -> dataLength + fragmentLength - 1) / fragmentLength;
+   if (fragmentCount > ENET_PROTOCOL_MAXIMUM_FRAGMENT_COUNT)
+     return 0;
+
+   return fragmentCount;
+}
+
+/** Takes commandCount outgoing commands from the host's command pool, all or none. */
+static int
+enet_peer_allocate_commands (ENetPeer * peer, size_t commandCount, ENetList * commands)
+{
+   enet_list_clear (commands);
+
+   for (; commandCount > 0; -- commandCount)
+   {
+      ENetOutgoingCommand * outgoingCommand = (ENetOutgoingCommand *) enet_host_command_allocate (peer -> host);
+      if (outgoingCommand == NULL)
+      {
+         while (! enet_list_empty (commands))
+           enet_host_command_free (peer -> host, enet_list_remove (enet_list_begin (commands)));
+
+         return -1;
+      }
+
+      enet_list_insert (enet_list_end (commands), outgoingCommand);
+   }
+
+   return 0;
+}
+
+/** Queues a packet whose size was checked with enet_peer_packet_command_count(), using commands taken from the front of the given list. */
+static void
+enet_peer_queue_packet (ENetPeer * peer, enet_uint8 channelID, ENetPacket * packet, size_t fragmentLength, ENetList * commands)
+{
+   ENetChannel * channel = & peer -> channels [channelID];
+   ENetOutgoingCommand * outgoingCommand;
+
    if (packet -> dataLength > fragmentLength)
    {
       enet_uint32 fragmentCount = (packet -> dataLength + fragmentLength - 1) / fragmentLength,
@@ -119,11 +155,6 @@ enet_peer_send (ENetPeer * peer, enet_uint8 channelID, ENetPacket * packet)
              fragmentOffset;
       enet_uint8 commandNumber;
       enet_uint16 startSequenceNumber; 
-      ENetList fragments;
-      ENetOutgoingCommand * fragment;
-
-      if (fragmentCount > ENET_PROTOCOL_MAXIMUM_FRAGMENT_COUNT)
-        return -1;
 
       if ((packet -> flags & (ENET_PACKET_FLAG_RELIABLE | ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT)) == ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT &&
           channel -> outgoingUnreliableSequenceNumber < 0xFFFF)
@@ -136,8 +167,6 @@ enet_peer_send (ENetPeer * peer, enet_uint8 channelID, ENetPacket * packet)
          commandNumber = ENET_PROTOCOL_COMMAND_SEND_FRAGMENT | ENET_PROTOCOL_COMMAND_FLAG_ACKNOWLEDGE;
          startSequenceNumber = ENET_HOST_TO_NET_16 (channel -> outgoingReliableSequenceNumber + 1);
       }
-        
-      enet_list_clear (& fragments);
 
       for (fragmentNumber = 0,
              fragmentOffset = 0;
@@ -148,68 +177,105 @@ enet_peer_send (ENetPeer * peer, enet_uint8 channelID, ENetPacket * packet)
          if (packet -> dataLength - fragmentOffset < fragmentLength)
            fragmentLength = packet -> dataLength - fragmentOffset;
 
-         fragment = (ENetOutgoingCommand *) enet_malloc (sizeof (ENetOutgoingCommand));
-         if (fragment == NULL)
-         {
-            while (! enet_list_empty (& fragments))
-            {
-               fragment = (ENetOutgoingCommand *) enet_list_remove (enet_list_begin (& fragments));
-               
-               enet_free (fragment);
-            }
-            
-            return -1;
-         }
-         
-         fragment -> fragmentOffset = fragmentOffset;
-         fragment -> fragmentLength = fragmentLength;
-         fragment -> packet = packet;
-         fragment -> command.header.command = commandNumber;
-         fragment -> command.header.channelID = channelID;
-         fragment -> command.sendFragment.startSequenceNumber = startSequenceNumber;
-         fragment -> command.sendFragment.dataLength = ENET_HOST_TO_NET_16 (fragmentLength);
-         fragment -> command.sendFragment.fragmentCount = ENET_HOST_TO_NET_32 (fragmentCount);
-         fragment -> command.sendFragment.fragmentNumber = ENET_HOST_TO_NET_32 (fragmentNumber);
-         fragment -> command.sendFragment.totalLength = ENET_HOST_TO_NET_32 (packet -> dataLength);
-         fragment -> command.sendFragment.fragmentOffset = ENET_NET_TO_HOST_32 (fragmentOffset);
-        
-         enet_list_insert (enet_list_end (& fragments), fragment);
+         outgoingCommand = (ENetOutgoingCommand *) enet_list_remove (enet_list_begin (commands));
+         outgoingCommand -> fragmentOffset = fragmentOffset;
+         outgoingCommand -> fragmentLength = fragmentLength;
+         outgoingCommand -> packet = packet;
+         outgoingCommand -> command.header.command = commandNumber;
+         outgoingCommand -> command.header.channelID = channelID;
+         outgoingCommand -> command.sendFragment.startSequenceNumber = startSequenceNumber;
+         outgoingCommand -> command.sendFragment.dataLength = ENET_HOST_TO_NET_16 (fragmentLength);
+         outgoingCommand -> command.sendFragment.fragmentCount = ENET_HOST_TO_NET_32 (fragmentCount);
+         outgoingCommand -> command.sendFragment.fragmentNumber = ENET_HOST_TO_NET_32 (fragmentNumber);
+         outgoingCommand -> command.sendFragment.totalLength = ENET_HOST_TO_NET_32 (packet -> dataLength);
+         outgoingCommand -> command.sendFragment.fragmentOffset = ENET_NET_TO_HOST_32 (fragmentOffset);
+
+         enet_peer_setup_outgoing_command (peer, outgoingCommand);
       }
 
       packet -> referenceCount += fragmentNumber;
 
-      while (! enet_list_empty (& fragments))
-      {
-         fragment = (ENetOutgoingCommand *) enet_list_remove (enet_list_begin (& fragments));
- 
-         enet_peer_setup_outgoing_command (peer, fragment);
-      }
-
-      return 0;
+      return;
    }
 
-   command.header.channelID = channelID;
+   outgoingCommand = (ENetOutgoingCommand *) enet_list_remove (enet_list_begin (commands));
+   outgoingCommand -> command.header.channelID = channelID;
 
    if ((packet -> flags & (ENET_PACKET_FLAG_RELIABLE | ENET_PACKET_FLAG_UNSEQUENCED)) == ENET_PACKET_FLAG_UNSEQUENCED)
    {
-      command.header.command = ENET_PROTOCOL_COMMAND_SEND_UNSEQUENCED | ENET_PROTOCOL_COMMAND_FLAG_UNSEQUENCED;
-      command.sendUnsequenced.dataLength = ENET_HOST_TO_NET_16 (packet -> dataLength);
+      outgoingCommand -> command.header.command = ENET_PROTOCOL_COMMAND_SEND_UNSEQUENCED | ENET_PROTOCOL_COMMAND_FLAG_UNSEQUENCED;
+      outgoingCommand -> command.sendUnsequenced.dataLength = ENET_HOST_TO_NET_16 (packet -> dataLength);
    }
    else 
    if (packet -> flags & ENET_PACKET_FLAG_RELIABLE || channel -> outgoingUnreliableSequenceNumber >= 0xFFFF)
    {
-      command.header.command = ENET_PROTOCOL_COMMAND_SEND_RELIABLE | ENET_PROTOCOL_COMMAND_FLAG_ACKNOWLEDGE;
-      command.sendReliable.dataLength = ENET_HOST_TO_NET_16 (packet -> dataLength);
+      outgoingCommand -> command.header.command = ENET_PROTOCOL_COMMAND_SEND_RELIABLE | ENET_PROTOCOL_COMMAND_FLAG_ACKNOWLEDGE;
+      outgoingCommand -> command.sendReliable.dataLength = ENET_HOST_TO_NET_16 (packet -> dataLength);
    }
    else
    {
-      command.header.command = ENET_PROTOCOL_COMMAND_SEND_UNRELIABLE;
-      command.sendUnreliable.dataLength = ENET_HOST_TO_NET_16 (packet -> dataLength);
+      outgoingCommand -> command.header.command = ENET_PROTOCOL_COMMAND_SEND_UNRELIABLE;
+      outgoingCommand -> command.sendUnreliable.dataLength = ENET_HOST_TO_NET_16 (packet -> dataLength);
+   }
+
+   outgoingCommand -> fragmentOffset = 0;
+   outgoingCommand -> fragmentLength = packet -> dataLength;
+   outgoingCommand -> packet = packet;
+   ++ packet -> referenceCount;
+
+   enet_peer_setup_outgoing_command (peer, outgoingCommand);
+}
+
+/** Queues a packet to be sent.
+    @param peer destination for the packet
+    @param channelID channel on which to send
+    @param packet packet to send
+    @retval 0 on success
+    @retval < 0 on failure
+*/
+int
+enet_peer_send (ENetPeer * peer, enet_uint8 channelID, ENetPacket * packet)
+{
+   return enet_peer_send_batch (peer, channelID, & packet, 1);
+}
+
+/** Queues several packets to be sent in order on one channel.
+    The peer and channel are checked once and the commands for all packets are taken
+    from the host's command pool together, so either every packet is queued or none is.
+    @param peer destination for the packets
+    @param channelID channel on which to send
+    @param packets packets to send
+    @param packetCount number of packets
+    @retval 0 on success
+    @retval < 0 on failure
+*/
+int
+enet_peer_send_batch (ENetPeer * peer, enet_uint8 channelID, ENetPacket * const * packets, size_t packetCount)
+{
+   ENetList commands;
+   size_t fragmentLength, commandCount = 0, i;
+
+   if (peer -> state != ENET_PEER_STATE_CONNECTED ||
+       channelID >= peer -> channelCount)
+     return -1;
+
+   fragmentLength = enet_peer_fragment_length (peer);
+
+   for (i = 0; i < packetCount; ++ i)
+   {
+      enet_uint32 packetCommands = enet_peer_packet_command_count (packets [i], fragmentLength);
+      if (packetCommands == 0)
+        return -1;
+
+      commandCount += packetCommands;
    }
 
-   if (enet_peer_queue_outgoing_command (peer, & command, packet, 0, packet -> dataLength) == NULL)
+   if (enet_peer_allocate_commands (peer, commandCount, & commands) != 0)
      return -1;
 
+   for (i = 0; i < packetCount; ++ i)
+     enet_peer_queue_packet (peer, channelID, packets [i], fragmentLength, & commands);
+
    return 0;
 }
 
@@ -239,13 +305,13 @@ enet_peer_receive (ENetPeer * peer, enet_uint8 * channelID)
    if (incomingCommand -> fragments != NULL)
      enet_free (incomingCommand -> fragments);
 
-   enet_free (incomingCommand);
+   enet_host_command_free (peer -> host, incomingCommand);
 
    return packet;
 }
 
 static void
-enet_peer_reset_outgoing_commands (ENetList * queue)
+enet_peer_reset_outgoing_commands (ENetHost * host, ENetList * queue)
 {
     ENetOutgoingCommand * outgoingCommand;
 
@@ -261,12 +327,12 @@ enet_peer_reset_outgoing_commands (ENetList * queue)
             enet_packet_destroy (outgoingCommand -> packet);
        }
 
-       enet_free (outgoingCommand);
+       enet_host_command_free (host, outgoingCommand);
     }
 }
 
 static void
-enet_peer_remove_incoming_commands (ENetList * queue, ENetListIterator startCommand, ENetListIterator endCommand)
+enet_peer_remove_incoming_commands (ENetHost * host, ENetList * queue, ENetListIterator startCommand, ENetListIterator endCommand)
 {
     ENetListIterator currentCommand;    
     
@@ -289,14 +355,14 @@ enet_peer_remove_incoming_commands (ENetList * queue, ENetListIterator startComm
        if (incomingCommand -> fragments != NULL)
          enet_free (incomingCommand -> fragments);
 
-       enet_free (incomingCommand);
+       enet_host_command_free (host, incomingCommand);
     }
 }
 
 static void
-enet_peer_reset_incoming_commands (ENetList * queue)
+enet_peer_reset_incoming_commands (ENetHost * host, ENetList * queue)
 {
-    enet_peer_remove_incoming_commands(queue, enet_list_begin (queue), enet_list_end (queue));
+    enet_peer_remove_incoming_commands(host, queue, enet_list_begin (queue), enet_list_end (queue));
 }
  
 void
@@ -312,13 +378,13 @@ enet_peer_reset_queues (ENetPeer * peer)
     }
 
     while (! enet_list_empty (& peer -> acknowledgements))
-      enet_free (enet_list_remove (enet_list_begin (& peer -> acknowledgements)));
+      enet_host_command_free (peer -> host, enet_list_remove (enet_list_begin (& peer -> acknowledgements)));
 
-    enet_peer_reset_outgoing_commands (& peer -> sentReliableCommands);
-    enet_peer_reset_outgoing_commands (& peer -> sentUnreliableCommands);
-    enet_peer_reset_outgoing_commands (& peer -> outgoingReliableCommands);
-    enet_peer_reset_outgoing_commands (& peer -> outgoingUnreliableCommands);
-    enet_peer_reset_incoming_commands (& peer -> dispatchedCommands);
+    enet_peer_reset_outgoing_commands (peer -> host, & peer -> sentReliableCommands);
+    enet_peer_reset_outgoing_commands (peer -> host, & peer -> sentUnreliableCommands);
+    enet_peer_reset_outgoing_commands (peer -> host, & peer -> outgoingReliableCommands);
+    enet_peer_reset_outgoing_commands (peer -> host, & peer -> outgoingUnreliableCommands);
+    enet_peer_reset_incoming_commands (peer -> host, & peer -> dispatchedCommands);
 
     if (peer -> channels != NULL && peer -> channelCount > 0)
     {
@@ -326,8 +392,8 @@ enet_peer_reset_queues (ENetPeer * peer)
              channel < & peer -> channels [peer -> channelCount];
              ++ channel)
         {
-            enet_peer_reset_incoming_commands (& channel -> incomingReliableCommands);
-            enet_peer_reset_incoming_commands (& channel -> incomingUnreliableCommands);
+            enet_peer_reset_incoming_commands (peer -> host, & channel -> incomingReliableCommands);
+            enet_peer_reset_incoming_commands (peer -> host, & channel -> incomingUnreliableCommands);
         }
 
         enet_free (peer -> channels);
@@ -566,7 +632,7 @@ enet_peer_queue_acknowledgement (ENetPeer * peer, const ENetProtocol * command,
           return NULL;
     }
 
-    acknowledgement = (ENetAcknowledgement *) enet_malloc (sizeof (ENetAcknowledgement));
+    acknowledgement = (ENetAcknowledgement *) enet_host_command_allocate (peer -> host);
     if (acknowledgement == NULL)
       return NULL;
 
@@ -649,7 +715,7 @@ enet_peer_setup_outgoing_command (ENetPeer * peer, ENetOutgoingCommand * outgoin
 ENetOutgoingCommand *
 enet_peer_queue_outgoing_command (ENetPeer * peer, const ENetProtocol * command, ENetPacket * packet, enet_uint32 offset, enet_uint16 length)
 {
-    ENetOutgoingCommand * outgoingCommand = (ENetOutgoingCommand *) enet_malloc (sizeof (ENetOutgoingCommand));
+    ENetOutgoingCommand * outgoingCommand = (ENetOutgoingCommand *) enet_host_command_allocate (peer -> host);
     if (outgoingCommand == NULL)
       return NULL;
 
@@ -745,7 +811,7 @@ enet_peer_dispatch_incoming_unreliable_commands (ENetPeer * peer, ENetChannel *
        droppedCommand = currentCommand;
     }
 
-    enet_peer_remove_incoming_commands (& channel -> incomingUnreliableCommands, enet_list_begin (& channel -> incomingUnreliableCommands), droppedCommand);
+    enet_peer_remove_incoming_commands (peer -> host, & channel -> incomingUnreliableCommands, enet_list_begin (& channel -> incomingUnreliableCommands), droppedCommand);
 }
 
 void
@@ -896,7 +962,7 @@ enet_peer_queue_incoming_command (ENetPeer * peer, const ENetProtocol * command,
        goto freePacket;
     }
 
-    incomingCommand = (ENetIncomingCommand *) enet_malloc (sizeof (ENetIncomingCommand));
+    incomingCommand = (ENetIncomingCommand *) enet_host_command_allocate (peer -> host);
     if (incomingCommand == NULL)
       goto notifyError;
 
@@ -914,7 +980,7 @@ enet_peer_queue_incoming_command (ENetPeer * peer, const ENetProtocol * command,
          incomingCommand -> fragments = (enet_uint32 *) enet_malloc ((fragmentCount + 31) / 32 * sizeof (enet_uint32));
        if (incomingCommand -> fragments == NULL)
        {
-          enet_free (incomingCommand);
+          enet_host_command_free (peer -> host, incomingCommand);
 
           goto notifyError;
        }
@@ -170,7 +170,7 @@ enet_protocol_remove_sent_unreliable_commands (ENetPeer * peer)
            }
         }
 
-        enet_free (outgoingCommand);
+        enet_host_command_free (peer -> host, outgoingCommand);
     }
 }
 
@@ -248,7 +248,7 @@ enet_protocol_remove_sent_reliable_command (ENetPeer * peer, enet_uint16 reliabl
        }
     }
 
-    enet_free (outgoingCommand);
+    enet_host_command_free (peer -> host, outgoingCommand);
 
     if (enet_list_empty (& peer -> sentReliableCommands))
       return commandNumber;
@@ -425,9 +425,9 @@ enet_protocol_handle_send_reliable (ENetHost * host, ENetPeer * peer, const ENet
         * currentData > & host -> receivedData [host -> receivedDataLength])
       return -1;
 
-    packet = enet_packet_create ((const enet_uint8 *) command + sizeof (ENetProtocolSendReliable),
-                                 dataLength,
-                                 ENET_PACKET_FLAG_RELIABLE);
+    packet = enet_host_packet_create (host, (const enet_uint8 *) command + sizeof (ENetProtocolSendReliable),
+                                      dataLength,
+                                      ENET_PACKET_FLAG_RELIABLE);
     if (packet == NULL ||
         enet_peer_queue_incoming_command (peer, command, packet, 0) == NULL)
       return -1;
@@ -474,9 +474,9 @@ enet_protocol_handle_send_unsequenced (ENetHost * host, ENetPeer * peer, const E
     if (peer -> unsequencedWindow [index / 32] & (1 << (index % 32)))
       return 0;
       
-    packet = enet_packet_create ((const enet_uint8 *) command + sizeof (ENetProtocolSendUnsequenced),
-                                 dataLength,
-                                 ENET_PACKET_FLAG_UNSEQUENCED);
+    packet = enet_host_packet_create (host, (const enet_uint8 *) command + sizeof (ENetProtocolSendUnsequenced),
+                                      dataLength,
+                                      ENET_PACKET_FLAG_UNSEQUENCED);
     if (packet == NULL ||
         enet_peer_queue_incoming_command (peer, command, packet, 0) == NULL)
       return -1;
@@ -503,9 +503,9 @@ enet_protocol_handle_send_unreliable (ENetHost * host, ENetPeer * peer, const EN
         * currentData > & host -> receivedData [host -> receivedDataLength])
       return -1;
 
-    packet = enet_packet_create ((const enet_uint8 *) command + sizeof (ENetProtocolSendUnreliable),
-                                 dataLength,
-                                 0);
+    packet = enet_host_packet_create (host, (const enet_uint8 *) command + sizeof (ENetProtocolSendUnreliable),
+                                      dataLength,
+                                      0);
     if (packet == NULL ||
         enet_peer_queue_incoming_command (peer, command, packet, 0) == NULL)
       return -1;
@@ -594,7 +594,7 @@ enet_protocol_handle_send_fragment (ENetHost * host, ENetPeer * peer, const ENet
     if (startCommand == NULL)
     {
        ENetProtocol hostCommand = * command;
-       ENetPacket * packet = enet_packet_create (NULL, totalLength, ENET_PACKET_FLAG_RELIABLE);
+       ENetPacket * packet = enet_host_packet_create (host, NULL, totalLength, ENET_PACKET_FLAG_RELIABLE);
        if (packet == NULL)
          return -1;
 
@@ -718,7 +718,7 @@ enet_protocol_handle_send_unreliable_fragment (ENetHost * host, ENetPeer * peer,
 
     if (startCommand == NULL)
     {
-       ENetPacket * packet = enet_packet_create (NULL, totalLength, ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT);
+       ENetPacket * packet = enet_host_packet_create (host, NULL, totalLength, ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT);
        if (packet == NULL)
          return -1;
 
@@ -1191,6 +1191,46 @@ commandError:
     return 0;
 }
  
+static int
+enet_protocol_receive_batched_datagram (ENetHost * host)
+{
+    ENetHostBatch * batch = host -> batch;
+    ENetSocketMessage * message;
+
+    if (batch -> receivedIndex >= batch -> receivedCount)
+    {
+       int receivedCount;
+
+       /* A short batch means the socket was drained, so don't spend a system call to find that out again. */
+       if (batch -> receivedCount > 0 && batch -> receivedCount < batch -> datagramLimit)
+       {
+          batch -> receivedCount = batch -> receivedIndex = 0;
+
+          return 0;
+       }
+
+       receivedCount = enet_socket_receive_messages (host -> socket, batch -> receivedMessages, batch -> datagramLimit);
+
+       if (receivedCount < 0)
+         return -1;
+
+       batch -> receivedCount = receivedCount;
+       batch -> receivedIndex = 0;
+
+       if (receivedCount == 0)
+         return 0;
+    }
+
+    message = & batch -> receivedMessages [batch -> receivedIndex ++];
+
+    host -> receivedAddress = message -> address;
+    host -> receivedData = (enet_uint8 *) message -> buffers -> data;
+    host -> receivedDataLength = message -> dataLength;
+
+    /* an empty datagram still has to be consumed, report it with the smallest length the caller treats as data */
+    return message -> dataLength > 0 ? (int) message -> dataLength : 1;
+}
+
 static int
 enet_protocol_receive_incoming_commands (ENetHost * host, ENetEvent * event)
 {
@@ -1199,22 +1239,37 @@ enet_protocol_receive_incoming_commands (ENetHost * host, ENetEvent * event)
        int receivedLength;
        ENetBuffer buffer;
 
-       buffer.data = host -> packetData [0];
-       buffer.dataLength = sizeof (host -> packetData [0]);
+       if (host -> batch != NULL)
+       {
+          receivedLength = enet_protocol_receive_batched_datagram (host);
 
-       receivedLength = enet_socket_receive (host -> socket,
-                                             & host -> receivedAddress,
-                                             & buffer,
-                                             1);
+          if (receivedLength < 0)
+            return -1;
 
-       if (receivedLength < 0)
-         return -1;
+          if (receivedLength == 0)
+            return 0;
 
-       if (receivedLength == 0)
-         return 0;
+          receivedLength = (int) host -> receivedDataLength;
+       }
+       else
+       {
+          buffer.data = host -> packetData [0];
+          buffer.dataLength = sizeof (host -> packetData [0]);
+
+          receivedLength = enet_socket_receive (host -> socket,
+                                                & host -> receivedAddress,
+                                                & buffer,
+                                                1);
+
+          if (receivedLength < 0)
+            return -1;
+
+          if (receivedLength == 0)
+            return 0;
 
-       host -> receivedData = host -> packetData [0];
-       host -> receivedDataLength = receivedLength;
+          host -> receivedData = host -> packetData [0];
+          host -> receivedDataLength = receivedLength;
+       }
       
        host -> totalReceivedData += receivedLength;
        host -> totalReceivedPackets ++;
@@ -1292,7 +1347,7 @@ enet_protocol_send_acknowledgements (ENetHost * host, ENetPeer * peer)
          enet_protocol_dispatch_state (host, peer, ENET_PEER_STATE_ZOMBIE);
 
        enet_list_remove (& acknowledgement -> acknowledgementList);
-       enet_free (acknowledgement);
+       enet_host_command_free (host, acknowledgement);
 
        ++ command;
        ++ buffer;
@@ -1349,7 +1404,7 @@ enet_protocol_send_unreliable_outgoing_commands (ENetHost * host, ENetPeer * pee
                   enet_packet_destroy (outgoingCommand -> packet);
          
                 enet_list_remove (& outgoingCommand -> outgoingCommandList);
-                enet_free (outgoingCommand);
+                enet_host_command_free (host, outgoingCommand);
 
                 if (currentCommand == enet_list_end (& peer -> outgoingUnreliableCommands))
                   break;
@@ -1387,7 +1442,7 @@ enet_protocol_send_unreliable_outgoing_commands (ENetHost * host, ENetPeer * pee
           enet_list_insert (enet_list_end (& peer -> sentUnreliableCommands), outgoingCommand);
        }
        else
-         enet_free (outgoingCommand);
+         enet_host_command_free (host, outgoingCommand);
 
        ++ command;
        ++ buffer;
@@ -1580,6 +1635,58 @@ enet_protocol_send_reliable_outgoing_commands (ENetHost * host, ENetPeer * peer)
     return canPing;
 }
 
+static int
+enet_protocol_flush_batched_datagrams (ENetHost * host)
+{
+    ENetHostBatch * batch = host -> batch;
+    int sentCount;
+
+    if (batch == NULL || batch -> sendCount == 0)
+      return 0;
+
+    sentCount = enet_socket_send_messages (host -> socket, batch -> sendMessages, batch -> sendCount);
+
+    batch -> sendCount = 0;
+
+    return sentCount < 0 ? -1 : 0;
+}
+
+/** Copies the datagram assembled in host -> buffers into the next send slot, since the packets it
+    references may be released before the batch goes out. */
+static int
+enet_protocol_queue_batched_datagram (ENetHost * host, const ENetAddress * address)
+{
+    ENetHostBatch * batch = host -> batch;
+    ENetSocketMessage * message;
+    enet_uint8 * data;
+    size_t length = 0, i;
+
+    if (batch -> sendCount >= batch -> datagramLimit &&
+        enet_protocol_flush_batched_datagrams (host) < 0)
+      return -1;
+
+    message = & batch -> sendMessages [batch -> sendCount];
+    data = (enet_uint8 *) message -> buffers -> data;
+
+    for (i = 0; i < host -> bufferCount; ++ i)
+    {
+        const ENetBuffer * buffer = & host -> buffers [i];
+
+        if (length + buffer -> dataLength > ENET_PROTOCOL_MAXIMUM_MTU)
+          return -1;
+
+        memcpy (& data [length], buffer -> data, buffer -> dataLength);
+        length += buffer -> dataLength;
+    }
+
+    message -> buffers -> dataLength = length;
+    message -> address = * address;
+
+    ++ batch -> sendCount;
+
+    return (int) length;
+}
+
 static int
 enet_protocol_send_outgoing_commands (ENetHost * host, ENetEvent * event, int checkForTimeouts)
 {
@@ -1615,7 +1722,7 @@ enet_protocol_send_outgoing_commands (ENetHost * host, ENetEvent * event, int ch
             enet_protocol_check_timeouts (host, currentPeer, event) == 1)
         {
             if (event != NULL && event -> type != ENET_EVENT_TYPE_NONE)
-              return 1;
+              return enet_protocol_flush_batched_datagrams (host) < 0 ? -1 : 1;
             else
               continue;
         }
@@ -1725,7 +1832,10 @@ enet_protocol_send_outgoing_commands (ENetHost * host, ENetEvent * event, int ch
 
         currentPeer -> lastSendTime = host -> serviceTime;
 
-        sentLength = enet_socket_send (host -> socket, & currentPeer -> address, host -> buffers, host -> bufferCount);
+        if (host -> batch != NULL)
+          sentLength = enet_protocol_queue_batched_datagram (host, & currentPeer -> address);
+        else
+          sentLength = enet_socket_send (host -> socket, & currentPeer -> address, host -> buffers, host -> bufferCount);
 
         enet_protocol_remove_sent_unreliable_commands (currentPeer);
 
@@ -1736,7 +1846,7 @@ enet_protocol_send_outgoing_commands (ENetHost * host, ENetEvent * event, int ch
         host -> totalSentPackets ++;
     }
    
-    return 0;
+    return enet_protocol_flush_batched_datagrams (host);
 }
 
 /** Sends any queued packets on the host specified to its designated peers.
@@ -1881,18 +1991,28 @@ enet_host_service (ENetHost * host, ENetEvent * event, enet_uint32 timeout)
           }
        }
 
-       host -> serviceTime = enet_time_get ();
+       do
+       {
+          host -> serviceTime = enet_time_get ();
 
-       if (ENET_TIME_GREATER_EQUAL (host -> serviceTime, timeout))
-         return 0;
+          if (ENET_TIME_GREATER_EQUAL (host -> serviceTime, timeout))
+            return 0;
 
-       waitCondition = ENET_SOCKET_WAIT_RECEIVE;
+          waitCondition = ENET_SOCKET_WAIT_RECEIVE | ENET_SOCKET_WAIT_INTERRUPT;
 
-       if (enet_socket_wait (host -> socket, & waitCondition, ENET_TIME_DIFFERENCE (timeout, host -> serviceTime)) != 0)
-         return -1;
+          if (host -> batch != NULL && host -> batch -> poller != ENET_SOCKET_NULL)
+          {
+             if (enet_socket_poller_wait (host -> batch -> poller, & waitCondition, ENET_TIME_DIFFERENCE (timeout, host -> serviceTime)) != 0)
+               return -1;
+          }
+          else
+          if (enet_socket_wait (host -> socket, & waitCondition, ENET_TIME_DIFFERENCE (timeout, host -> serviceTime)) != 0)
+            return -1;
+       }
+       while (waitCondition & ENET_SOCKET_WAIT_INTERRUPT);
        
        host -> serviceTime = enet_time_get ();
-    } while (waitCondition == ENET_SOCKET_WAIT_RECEIVE);
+    } while (waitCondition & ENET_SOCKET_WAIT_RECEIVE);
 
     return 0; 
 }
@@ -4,6 +4,14 @@
 */
 #ifndef WIN32
 
+#if (defined(linux) || defined(__linux) || defined(__linux__)) && ! defined(ENET_NO_MMSG)
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#define HAS_MMSG 1
+#define HAS_EPOLL 1
+#endif
+
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/ioctl.h>
@@ -47,6 +55,10 @@
 #include <sys/poll.h>
 #endif
 
+#ifdef HAS_EPOLL
+#include <sys/epoll.h>
+#endif
+
 #ifndef HAS_SOCKLEN_T
 typedef int socklen_t;
 #endif
@@ -390,6 +402,202 @@ enet_socket_receive (ENetSocket socket,
     return recvLength;
 }
 
+int
+enet_socket_send_messages (ENetSocket socket, ENetSocketMessage * messages, size_t messageCount)
+{
+#ifdef HAS_MMSG
+    struct mmsghdr msgHdrs [ENET_SOCKET_MESSAGE_MAXIMUM];
+    struct sockaddr_in sins [ENET_SOCKET_MESSAGE_MAXIMUM];
+    size_t sentCount = 0;
+
+    while (sentCount < messageCount)
+    {
+        size_t batchCount = messageCount - sentCount, i;
+        int result;
+
+        if (batchCount > ENET_SOCKET_MESSAGE_MAXIMUM)
+          batchCount = ENET_SOCKET_MESSAGE_MAXIMUM;
+
+        memset (msgHdrs, 0, batchCount * sizeof (struct mmsghdr));
+        memset (sins, 0, batchCount * sizeof (struct sockaddr_in));
+
+        for (i = 0; i < batchCount; ++ i)
+        {
+            const ENetSocketMessage * message = & messages [sentCount + i];
+
+            sins [i].sin_family = AF_INET;
+            sins [i].sin_port = ENET_HOST_TO_NET_16 (message -> address.port);
+            sins [i].sin_addr.s_addr = message -> address.host;
+
+            msgHdrs [i].msg_hdr.msg_name = & sins [i];
+            msgHdrs [i].msg_hdr.msg_namelen = sizeof (struct sockaddr_in);
+            msgHdrs [i].msg_hdr.msg_iov = (struct iovec *) message -> buffers;
+            msgHdrs [i].msg_hdr.msg_iovlen = message -> bufferCount;
+        }
+
+        result = sendmmsg (socket, msgHdrs, batchCount, MSG_NOSIGNAL);
+
+        if (result == -1)
+        {
+           /* Like enet_socket_send, datagrams that don't fit in the socket buffer are dropped. */
+           if (errno == EWOULDBLOCK)
+             break;
+
+           return -1;
+        }
+
+        for (i = 0; i < (size_t) result; ++ i)
+          messages [sentCount + i].dataLength = msgHdrs [i].msg_len;
+
+        sentCount += result;
+    }
+
+    return (int) sentCount;
+#else
+    size_t i;
+
+    for (i = 0; i < messageCount; ++ i)
+    {
+        int sentLength = enet_socket_send (socket, & messages [i].address, messages [i].buffers, messages [i].bufferCount);
+
+        if (sentLength < 0)
+          return -1;
+
+        if (sentLength == 0)
+          break;
+
+        messages [i].dataLength = sentLength;
+    }
+
+    return (int) i;
+#endif
+}
+
+int
+enet_socket_receive_messages (ENetSocket socket, ENetSocketMessage * messages, size_t messageCount)
+{
+#ifdef HAS_MMSG
+    struct mmsghdr msgHdrs [ENET_SOCKET_MESSAGE_MAXIMUM];
+    struct sockaddr_in sins [ENET_SOCKET_MESSAGE_MAXIMUM];
+    int receivedCount, i;
+
+    if (messageCount > ENET_SOCKET_MESSAGE_MAXIMUM)
+      messageCount = ENET_SOCKET_MESSAGE_MAXIMUM;
+
+    memset (msgHdrs, 0, messageCount * sizeof (struct mmsghdr));
+
+    for (i = 0; i < (int) messageCount; ++ i)
+    {
+        msgHdrs [i].msg_hdr.msg_name = & sins [i];
+        msgHdrs [i].msg_hdr.msg_namelen = sizeof (struct sockaddr_in);
+        msgHdrs [i].msg_hdr.msg_iov = (struct iovec *) messages [i].buffers;
+        msgHdrs [i].msg_hdr.msg_iovlen = messages [i].bufferCount;
+    }
+
+    receivedCount = recvmmsg (socket, msgHdrs, messageCount, MSG_DONTWAIT, NULL);
+
+    if (receivedCount == -1)
+    {
+       if (errno == EWOULDBLOCK)
+         return 0;
+
+       return -1;
+    }
+
+    for (i = 0; i < receivedCount; ++ i)
+    {
+#ifdef HAS_MSGHDR_FLAGS
+        if (msgHdrs [i].msg_hdr.msg_flags & MSG_TRUNC)
+          return -1;
+#endif
+
+        messages [i].address.host = (enet_uint32) sins [i].sin_addr.s_addr;
+        messages [i].address.port = ENET_NET_TO_HOST_16 (sins [i].sin_port);
+        messages [i].dataLength = msgHdrs [i].msg_len;
+    }
+
+    return receivedCount;
+#else
+    size_t i;
+
+    for (i = 0; i < messageCount; ++ i)
+    {
+        int receivedLength = enet_socket_receive (socket, & messages [i].address, messages [i].buffers, messages [i].bufferCount);
+
+        if (receivedLength < 0)
+          return -1;
+
+        if (receivedLength == 0)
+          break;
+
+        messages [i].dataLength = receivedLength;
+    }
+
+    return (int) i;
+#endif
+}
+
+ENetSocket
+enet_socket_poller_create (ENetSocket socket)
+{
+#ifdef HAS_EPOLL
+    struct epoll_event pollEvent;
+    int poller = epoll_create (1);
+
+    if (poller == -1)
+      return ENET_SOCKET_NULL;
+
+    memset (& pollEvent, 0, sizeof (struct epoll_event));
+    pollEvent.events = EPOLLIN;
+    pollEvent.data.fd = socket;
+
+    if (epoll_ctl (poller, EPOLL_CTL_ADD, socket, & pollEvent) == -1)
+    {
+       close (poller);
+
+       return ENET_SOCKET_NULL;
+    }
+
+    return poller;
+#else
+    (void) socket;
+
+    return ENET_SOCKET_NULL;
+#endif
+}
+
+int
+enet_socket_poller_wait (ENetSocket poller, enet_uint32 * condition, enet_uint32 timeout)
+{
+#ifdef HAS_EPOLL
+    struct epoll_event pollEvent;
+    int pollCount = epoll_wait (poller, & pollEvent, 1, (int) timeout);
+
+    if (pollCount < 0)
+    {
+        if (errno == EINTR && * condition & ENET_SOCKET_WAIT_INTERRUPT)
+        {
+            * condition = ENET_SOCKET_WAIT_INTERRUPT;
+
+            return 0;
+        }
+
+        return -1;
+    }
+
+    * condition = ENET_SOCKET_WAIT_NONE;
+
+    if (pollCount > 0 && (pollEvent.events & (EPOLLIN | EPOLLERR)))
+      * condition |= ENET_SOCKET_WAIT_RECEIVE;
+
+    return 0;
+#else
+    (void) poller; (void) condition; (void) timeout;
+
+    return -1;
+#endif
+}
+
 int
 enet_socketset_select (ENetSocket maxSocket, ENetSocketSet * readSet, ENetSocketSet * writeSet, enet_uint32 timeout)
 {
@@ -420,7 +628,16 @@ enet_socket_wait (ENetSocket socket, enet_uint32 * condition, enet_uint32 timeou
     pollCount = poll (& pollSocket, 1, timeout);
 
     if (pollCount < 0)
-      return -1;
+    {
+        if (errno == EINTR && * condition & ENET_SOCKET_WAIT_INTERRUPT)
+        {
+            * condition = ENET_SOCKET_WAIT_INTERRUPT;
+
+            return 0;
+        }
+
+        return -1;
+    }
 
     * condition = ENET_SOCKET_WAIT_NONE;
 
@@ -454,7 +671,16 @@ enet_socket_wait (ENetSocket socket, enet_uint32 * condition, enet_uint32 timeou
     selectCount = select (socket + 1, & readSet, & writeSet, NULL, & timeVal);
 
     if (selectCount < 0)
-      return -1;
+    {
+        if (errno == EINTR && * condition & ENET_SOCKET_WAIT_INTERRUPT)
+        {
+            * condition = ENET_SOCKET_WAIT_INTERRUPT;
+
+            return 0;
+        }
+
+        return -1;
+    }
 
     * condition = ENET_SOCKET_WAIT_NONE;
 
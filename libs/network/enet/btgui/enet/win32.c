@@ -315,6 +315,64 @@ enet_socket_receive (ENetSocket socket,
     return (int) recvLength;
 }
 
+int
+enet_socket_send_messages (ENetSocket socket, ENetSocketMessage * messages, size_t messageCount)
+{
+    size_t i;
+
+    for (i = 0; i < messageCount; ++ i)
+    {
+        int sentLength = enet_socket_send (socket, & messages [i].address, messages [i].buffers, messages [i].bufferCount);
+
+        if (sentLength < 0)
+          return -1;
+
+        if (sentLength == 0)
+          break;
+
+        messages [i].dataLength = sentLength;
+    }
+
+    return (int) i;
+}
+
+int
+enet_socket_receive_messages (ENetSocket socket, ENetSocketMessage * messages, size_t messageCount)
+{
+    size_t i;
+
+    for (i = 0; i < messageCount; ++ i)
+    {
+        int receivedLength = enet_socket_receive (socket, & messages [i].address, messages [i].buffers, messages [i].bufferCount);
+
+        if (receivedLength < 0)
+          return -1;
+
+        if (receivedLength == 0)
+          break;
+
+        messages [i].dataLength = receivedLength;
+    }
+
+    return (int) i;
+}
+
+ENetSocket
+enet_socket_poller_create (ENetSocket socket)
+{
+    (void) socket;
+
+    return ENET_SOCKET_NULL;
+}
+
+int
+enet_socket_poller_wait (ENetSocket poller, enet_uint32 * condition, enet_uint32 timeout)
+{
+    (void) poller; (void) condition; (void) timeout;
+
+    return -1;
+}
+
 int
 enet_socketset_select (ENetSocket maxSocket, ENetSocketSet * readSet, ENetSocketSet * writeSet, enet_uint32 timeout)
 {
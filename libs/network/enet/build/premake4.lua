@@ -102,3 +102,4 @@
 		include "../btgui/enet"
 		include "../test/enet/server"
 		include "../test/enet/client"
+		include "../test/enet/bench"
@@ -0,0 +1,194 @@
+
+// Loopback throughput benchmark: one server host echoing unreliable packets back to a few thousand
+// peers spread over several client hosts, with and without enet_host_batch_limit() and enet_host_packet_pool_limit().
+// The server also broadcasts a fragmented reliable packet every 250 ms, which every client checks.
+//
+//   Test_enet_bench [peers] [client hosts] [seconds] [batch limit, 0 = off] [pool slab limit, 0 = off]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <enet/enet.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+static const enet_uint16 benchPort = 1235;
+static const size_t broadcastLength = 3000;
+
+static unsigned long long nowMicroseconds()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct BenchMessage
+{
+	unsigned long long sentTime;
+	enet_uint32 peerIndex;
+	char padding[52];
+};
+
+static void serverLoop(ENetHost* server, std::atomic<bool>* running, std::atomic<unsigned long long>* echoed)
+{
+	ENetEvent event;
+	unsigned long long nextBroadcast = nowMicroseconds();
+	enet_uint8 broadcastCounter = 0;
+	while (running->load())
+	{
+		if (nowMicroseconds() >= nextBroadcast)
+		{
+			// one fragmented payload shared by every peer
+			ENetPacket* broadcast = enet_host_packet_create(server, NULL, broadcastLength, ENET_PACKET_FLAG_RELIABLE);
+			memset(broadcast->data, ++broadcastCounter, broadcastLength);
+			enet_host_broadcast(server, 0, broadcast);
+			nextBroadcast = nowMicroseconds() + 250000;
+		}
+		if (enet_host_service(server, &event, 1) <= 0)
+			continue;
+		do
+		{
+			if (event.type == ENET_EVENT_TYPE_RECEIVE)
+			{
+				// echo straight back, sent on the next service call
+				ENetPacket* reply = enet_host_packet_create(server, event.packet->data, event.packet->dataLength, 0);
+				enet_peer_send(event.peer, 0, reply);
+				enet_packet_destroy(event.packet);
+				echoed->fetch_add(1, std::memory_order_relaxed);
+			}
+		} while (enet_host_check_events(server, &event) > 0);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int numPeers = argc > 1 ? atoi(argv[1]) : 2000;
+	int numClients = argc > 2 ? atoi(argv[2]) : 16;
+	int seconds = argc > 3 ? atoi(argv[3]) : 5;
+	int batchLimit = argc > 4 ? atoi(argv[4]) : ENET_HOST_BATCH_MAXIMUM;
+	int poolLimit = argc > 5 ? atoi(argv[5]) : 64;
+	int peersPerClient = (numPeers + numClients - 1) / numClients;
+
+	if (enet_initialize() != 0)
+	{
+		fprintf(stderr, "An error occurred while initializing ENet.\n");
+		return EXIT_FAILURE;
+	}
+	atexit(enet_deinitialize);
+
+	ENetAddress address;
+	address.host = ENET_HOST_ANY;
+	address.port = benchPort;
+	ENetHost* server = enet_host_create(&address, numPeers, 1, 0, 0);
+	if (server == NULL)
+	{
+		fprintf(stderr, "An error occurred while trying to create an ENet server host.\n");
+		return EXIT_FAILURE;
+	}
+
+	std::vector<ENetHost*> clients;
+	std::vector<ENetPeer*> peers;
+	enet_address_set_host(&address, "127.0.0.1");
+	for (int i = 0; i < numClients; i++)
+	{
+		ENetHost* client = enet_host_create(NULL, peersPerClient, 1, 0, 0);
+		if (client == NULL)
+		{
+			fprintf(stderr, "An error occurred while trying to create an ENet client host.\n");
+			return EXIT_FAILURE;
+		}
+		if (batchLimit > 0)
+			enet_host_batch_limit(client, batchLimit);
+		if (poolLimit > 0)
+			enet_host_packet_pool_limit(client, poolLimit);
+		clients.push_back(client);
+		for (int j = 0; j < peersPerClient && (int)peers.size() < numPeers; j++)
+			peers.push_back(enet_host_connect(client, &address, 1, 0));
+	}
+	if (batchLimit > 0)
+		enet_host_batch_limit(server, batchLimit);
+	if (poolLimit > 0)
+		enet_host_packet_pool_limit(server, poolLimit);
+
+	std::atomic<bool> running(true);
+	std::atomic<unsigned long long> echoed(0);
+	std::thread serverThread(serverLoop, server, &running, &echoed);
+
+	// wait until every peer is connected
+	ENetEvent event;
+	int connected = 0;
+	unsigned long long deadline = nowMicroseconds() + 10 * 1000000;
+	while (connected < numPeers && nowMicroseconds() < deadline)
+	{
+		for (size_t i = 0; i < clients.size(); i++)
+			while (enet_host_service(clients[i], &event, 0) > 0)
+				if (event.type == ENET_EVENT_TYPE_CONNECT)
+					connected++;
+	}
+	printf("%d/%d peers connected, batch limit %d, pool slab limit %d\n", connected, numPeers, batchLimit, poolLimit);
+
+	std::vector<enet_uint32> rtts;
+	unsigned long long sent = 0, received = 0, broadcasts = 0, corrupt = 0;
+	unsigned long long start = nowMicroseconds(), end = start + (unsigned long long)seconds * 1000000;
+	while (nowMicroseconds() < end)
+	{
+		// one packet per peer per round, then drain the replies
+		for (size_t i = 0; i < peers.size(); i++)
+		{
+			if (peers[i]->state != ENET_PEER_STATE_CONNECTED)
+				continue;
+			// serialized in place into the pooled packet
+			ENetPacket* packet = enet_host_packet_create(peers[i]->host, NULL, sizeof(BenchMessage), 0);
+			BenchMessage* message = (BenchMessage*)packet->data;
+			memset(message, 0, sizeof(BenchMessage));
+			message->sentTime = nowMicroseconds();
+			message->peerIndex = (enet_uint32)i;
+			enet_peer_send(peers[i], 0, packet);
+			sent++;
+		}
+		for (size_t i = 0; i < clients.size(); i++)
+		{
+			enet_host_flush(clients[i]);
+		}
+		for (size_t i = 0; i < clients.size(); i++)
+		{
+			while (enet_host_service(clients[i], &event, 0) > 0)
+			{
+				if (event.type != ENET_EVENT_TYPE_RECEIVE)
+					continue;
+				if (event.packet->dataLength == broadcastLength)
+				{
+					for (size_t j = 1; j < broadcastLength; j++)
+						corrupt += event.packet->data[j] != event.packet->data[0];
+					broadcasts++;
+					enet_packet_destroy(event.packet);
+					continue;
+				}
+				BenchMessage message;
+				memcpy(&message, event.packet->data, sizeof(message));
+				rtts.push_back((enet_uint32)(nowMicroseconds() - message.sentTime));
+				received++;
+				enet_packet_destroy(event.packet);
+			}
+		}
+	}
+	double elapsed = (nowMicroseconds() - start) * 1e-6;
+
+	running.store(false);
+	serverThread.join();
+
+	std::sort(rtts.begin(), rtts.end());
+	printf("sent %llu, echoed %llu, received %llu in %.2f s\n", sent, echoed.load(), received, elapsed);
+	printf("%.0f packets/s round trip, %llu broadcasts received%s\n", received / elapsed, broadcasts, corrupt ? ", CORRUPT" : "");
+	if (!rtts.empty())
+	{
+		printf("rtt p50 %u us, p99 %u us, max %u us\n", rtts[rtts.size() / 2], rtts[rtts.size() * 99 / 100], rtts.back());
+	}
+
+	for (size_t i = 0; i < clients.size(); i++)
+		enet_host_destroy(clients[i]);
+	enet_host_destroy(server);
+	return received > 0 && broadcasts > 0 && !corrupt ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,27 @@
+
+
+project ("Test_enet_bench")
+
+	language "C++"
+			
+	kind "ConsoleApp"
+	targetdir "../../../bin"
+	includedirs {"../../../btgui/enet/include"}
+	
+	if os.is("Windows") then 
+			defines { "WIN32" }
+
+		links {"Ws2_32","Winmm"}
+	end
+	if os.is("Linux") then
+		links {"pthread"}
+	end
+	if os.is("MacOSX") then
+	end		
+		
+	links {"enet"}		
+	
+	files {
+		"main.cpp",
+	}
+
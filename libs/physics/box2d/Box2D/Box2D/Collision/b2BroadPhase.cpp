@@ -29,10 +29,19 @@ b2BroadPhase::b2BroadPhase()
 	m_moveCapacity = 16;
 	m_moveCount = 0;
 	m_moveBuffer = (int32*)b2Alloc(m_moveCapacity * sizeof(int32));
+
+	m_pairCacheCapacity = 16;
+	m_pairCacheCount = 0;
+	m_pairCache = (b2Pair*)b2Alloc(m_pairCacheCapacity * sizeof(b2Pair));
+	for (int32 i = 0; i < m_pairCacheCapacity; ++i)
+	{
+		m_pairCache[i].proxyIdA = e_nullProxy;
+	}
 }
 
 b2BroadPhase::~b2BroadPhase()
 {
+	b2Free(m_pairCache);
 	b2Free(m_moveBuffer);
 	b2Free(m_pairBuffer);
 }
@@ -101,6 +110,12 @@ bool b2BroadPhase::QueryCallback(int32 proxyId)
 		return true;
 	}
 
+	// The client already has this pair.
+	if (m_pairCacheCount > 0 && IsPairCached(proxyId, m_queryProxyId))
+	{
+		return true;
+	}
+
 	// Grow the pair buffer as needed.
 	if (m_pairCount == m_pairCapacity)
 	{
@@ -117,3 +132,118 @@ bool b2BroadPhase::QueryCallback(int32 proxyId)
 
 	return true;
 }
+
+static inline uint32 b2HashPair(int32 proxyIdA, int32 proxyIdB)
+{
+	uint32 h = uint32(proxyIdA) * 0x9E3779B1u;
+	h ^= uint32(proxyIdB) + 0x7F4A7C15u + (h << 6) + (h >> 2);
+	return h ^ (h >> 15);
+}
+
+bool b2BroadPhase::IsPairCached(int32 proxyIdA, int32 proxyIdB) const
+{
+	int32 idA = b2Min(proxyIdA, proxyIdB);
+	int32 idB = b2Max(proxyIdA, proxyIdB);
+
+	int32 mask = m_pairCacheCapacity - 1;
+	for (int32 i = b2HashPair(idA, idB) & mask; m_pairCache[i].proxyIdA != e_nullProxy; i = (i + 1) & mask)
+	{
+		if (m_pairCache[i].proxyIdA == idA && m_pairCache[i].proxyIdB == idB)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void b2BroadPhase::CachePair(int32 proxyIdA, int32 proxyIdB)
+{
+	b2Assert(proxyIdA != e_nullProxy && proxyIdB != e_nullProxy);
+
+	// Keep the load factor at or below one half.
+	if (2 * (m_pairCacheCount + 1) > m_pairCacheCapacity)
+	{
+		b2Pair* oldCache = m_pairCache;
+		int32 oldCapacity = m_pairCacheCapacity;
+		m_pairCacheCapacity *= 2;
+		m_pairCache = (b2Pair*)b2Alloc(m_pairCacheCapacity * sizeof(b2Pair));
+		for (int32 i = 0; i < m_pairCacheCapacity; ++i)
+		{
+			m_pairCache[i].proxyIdA = e_nullProxy;
+		}
+
+		int32 mask = m_pairCacheCapacity - 1;
+		for (int32 i = 0; i < oldCapacity; ++i)
+		{
+			if (oldCache[i].proxyIdA == e_nullProxy)
+			{
+				continue;
+			}
+
+			int32 j = b2HashPair(oldCache[i].proxyIdA, oldCache[i].proxyIdB) & mask;
+			while (m_pairCache[j].proxyIdA != e_nullProxy)
+			{
+				j = (j + 1) & mask;
+			}
+			m_pairCache[j] = oldCache[i];
+		}
+
+		b2Free(oldCache);
+	}
+
+	int32 idA = b2Min(proxyIdA, proxyIdB);
+	int32 idB = b2Max(proxyIdA, proxyIdB);
+
+	int32 mask = m_pairCacheCapacity - 1;
+	int32 i = b2HashPair(idA, idB) & mask;
+	while (m_pairCache[i].proxyIdA != e_nullProxy)
+	{
+		if (m_pairCache[i].proxyIdA == idA && m_pairCache[i].proxyIdB == idB)
+		{
+			return;
+		}
+		i = (i + 1) & mask;
+	}
+
+	m_pairCache[i].proxyIdA = idA;
+	m_pairCache[i].proxyIdB = idB;
+	++m_pairCacheCount;
+}
+
+void b2BroadPhase::ReleasePair(int32 proxyIdA, int32 proxyIdB)
+{
+	int32 idA = b2Min(proxyIdA, proxyIdB);
+	int32 idB = b2Max(proxyIdA, proxyIdB);
+
+	int32 mask = m_pairCacheCapacity - 1;
+	int32 i = b2HashPair(idA, idB) & mask;
+	while (m_pairCache[i].proxyIdA != idA || m_pairCache[i].proxyIdB != idB)
+	{
+		if (m_pairCache[i].proxyIdA == e_nullProxy)
+		{
+			// Not cached.
+			return;
+		}
+		i = (i + 1) & mask;
+	}
+
+	// Remove by shifting later entries of the probe run back into the hole.
+	m_pairCache[i].proxyIdA = e_nullProxy;
+	--m_pairCacheCount;
+
+	int32 hole = i;
+	for (int32 j = (i + 1) & mask; m_pairCache[j].proxyIdA != e_nullProxy; j = (j + 1) & mask)
+	{
+		int32 home = b2HashPair(m_pairCache[j].proxyIdA, m_pairCache[j].proxyIdB) & mask;
+
+		// Move the entry if its home slot is not between the hole and its current slot.
+		bool between = hole <= j ? (hole < home && home <= j) : (hole < home || home <= j);
+		if (between == false)
+		{
+			m_pairCache[hole] = m_pairCache[j];
+			m_pairCache[j].proxyIdA = e_nullProxy;
+			hole = j;
+		}
+	}
+}
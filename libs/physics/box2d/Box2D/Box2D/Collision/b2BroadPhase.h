@@ -31,8 +31,9 @@ struct b2Pair
 };
 
 /// The broad-phase is used for computing pairs and performing volume queries and ray casts.
-/// This broad-phase does not persist pairs. Instead, this reports potentially new pairs.
-/// It is up to the client to consume the new pairs and to track subsequent overlap.
+/// This broad-phase reports potentially new pairs. It is up to the client to consume the
+/// new pairs and to track subsequent overlap. A client that keeps a pair alive can record
+/// it with CachePair; cached pairs are not reported again until ReleasePair.
 class b2BroadPhase
 {
 public:
@@ -75,6 +76,16 @@ public:
 	template <typename T>
 	void UpdatePairs(T* callback);
 
+	/// Remember a pair the client is tracking so UpdatePairs skips it. The pair
+	/// must be released before either proxy is destroyed.
+	void CachePair(int32 proxyIdA, int32 proxyIdB);
+
+	/// Forget a pair recorded with CachePair.
+	void ReleasePair(int32 proxyIdA, int32 proxyIdB);
+
+	/// Is this pair recorded with CachePair?
+	bool IsPairCached(int32 proxyIdA, int32 proxyIdB) const;
+
 	/// Query an AABB for overlapping proxies. The callback class
 	/// is called for each proxy that overlaps the supplied AABB.
 	template <typename T>
@@ -90,6 +101,17 @@ public:
 	template <typename T>
 	void RayCast(T* callback, const b2RayCastInput& input) const;
 
+	/// Query many AABBs at once. See b2DynamicTree::QueryBatch.
+	template <typename T>
+	void QueryBatch(T* callback, const b2AABB* aabbs, int32 count) const;
+
+	/// Ray-cast many rays at once. See b2DynamicTree::RayCastBatch.
+	template <typename T>
+	void RayCastBatch(T* callback, const b2RayCastInput* inputs, int32 count) const;
+
+	/// Rebuild the embedded tree for query speed. See b2DynamicTree::RebuildTopDown.
+	void RebuildTree();
+
 	/// Get the height of the embedded tree.
 	int32 GetTreeHeight() const;
 
@@ -125,6 +147,12 @@ private:
 	int32 m_pairCapacity;
 	int32 m_pairCount;
 
+	// Open addressing hash set of cached pairs, proxyIdA < proxyIdB.
+	// Empty slots have proxyIdA == e_nullProxy.
+	b2Pair* m_pairCache;
+	int32 m_pairCacheCapacity;
+	int32 m_pairCacheCount;
+
 	int32 m_queryProxyId;
 };
 
@@ -249,6 +277,23 @@ inline void b2BroadPhase::RayCast(T* callback, const b2RayCastInput& input) cons
 	m_tree.RayCast(callback, input);
 }
 
+template <typename T>
+inline void b2BroadPhase::QueryBatch(T* callback, const b2AABB* aabbs, int32 count) const
+{
+	m_tree.QueryBatch(callback, aabbs, count);
+}
+
+template <typename T>
+inline void b2BroadPhase::RayCastBatch(T* callback, const b2RayCastInput* inputs, int32 count) const
+{
+	m_tree.RayCastBatch(callback, inputs, count);
+}
+
+inline void b2BroadPhase::RebuildTree()
+{
+	m_tree.RebuildTopDown();
+}
+
 inline void b2BroadPhase::ShiftOrigin(const b2Vec2& newOrigin)
 {
 	m_tree.ShiftOrigin(newOrigin);
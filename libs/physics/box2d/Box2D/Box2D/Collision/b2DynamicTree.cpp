@@ -18,6 +18,7 @@
 
 #include <Box2D/Collision/b2DynamicTree.h>
 #include <string.h>
+#include <algorithm>
 
 b2DynamicTree::b2DynamicTree()
 {
@@ -767,6 +768,281 @@ void b2DynamicTree::RebuildBottomUp()
 	Validate();
 }
 
+void b2DynamicTree::RebuildTopDown()
+{
+	if (m_root == b2_nullNode)
+	{
+		return;
+	}
+
+	int32* leaves = (int32*)b2Alloc(m_nodeCount * sizeof(int32));
+	int32 leafCount = 0;
+
+	// Build array of leaves. Free the rest.
+	for (int32 i = 0; i < m_nodeCapacity; ++i)
+	{
+		if (m_nodes[i].height < 0)
+		{
+			// free node in pool
+			continue;
+		}
+
+		if (m_nodes[i].IsLeaf())
+		{
+			leaves[leafCount++] = i;
+		}
+		else
+		{
+			FreeNode(i);
+		}
+	}
+
+	// A range of leaves waiting for a subtree, and where to attach it.
+	struct Range
+	{
+		int32 start;
+		int32 count;
+		int32 parent;
+		bool isChild1;
+	};
+
+	const int32 binCount = 16;
+
+	int32* internals = (int32*)b2Alloc(b2Max(leafCount - 1, 1) * sizeof(int32));
+	int32 internalCount = 0;
+
+	b2GrowableStack<Range, 64> stack;
+	Range all = { 0, leafCount, b2_nullNode, false };
+	stack.Push(all);
+
+	while (stack.GetCount() > 0)
+	{
+		Range range = stack.Pop();
+		int32* first = leaves + range.start;
+
+		int32 nodeId;
+		int32 split = 0;
+		if (range.count == 1)
+		{
+			nodeId = first[0];
+		}
+		else
+		{
+			nodeId = AllocateNode();
+			internals[internalCount++] = nodeId;
+
+			// Bound the centroids and split along the longer axis.
+			b2Vec2 lower = m_nodes[first[0]].aabb.GetCenter();
+			b2Vec2 upper = lower;
+			for (int32 i = 1; i < range.count; ++i)
+			{
+				b2Vec2 c = m_nodes[first[i]].aabb.GetCenter();
+				lower = b2Min(lower, c);
+				upper = b2Max(upper, c);
+			}
+
+			int32 axis = (upper.x - lower.x) >= (upper.y - lower.y) ? 0 : 1;
+			float32 axisLower = axis == 0 ? lower.x : lower.y;
+			float32 extent = axis == 0 ? upper.x - lower.x : upper.y - lower.y;
+
+			if (extent > 0.0f)
+			{
+				// Bin the centroids and pick the cheapest plane by perimeter * count.
+				int32 counts[binCount];
+				b2AABB bounds[binCount];
+				for (int32 i = 0; i < binCount; ++i)
+				{
+					counts[i] = 0;
+				}
+
+				float32 scale = binCount / extent;
+				for (int32 i = 0; i < range.count; ++i)
+				{
+					const b2AABB& aabb = m_nodes[first[i]].aabb;
+					b2Vec2 c = aabb.GetCenter();
+					int32 bin = b2Min(int32(((axis == 0 ? c.x : c.y) - axisLower) * scale), binCount - 1);
+					if (counts[bin] == 0)
+					{
+						bounds[bin] = aabb;
+					}
+					else
+					{
+						bounds[bin].Combine(aabb);
+					}
+					++counts[bin];
+				}
+
+				float32 rightCost[binCount];
+				b2AABB box;
+				int32 n = 0;
+				for (int32 i = binCount - 1; i > 0; --i)
+				{
+					if (counts[i] > 0)
+					{
+						if (n == 0)
+						{
+							box = bounds[i];
+						}
+						else
+						{
+							box.Combine(bounds[i]);
+						}
+						n += counts[i];
+					}
+					rightCost[i] = n > 0 ? n * box.GetPerimeter() : 0.0f;
+				}
+
+				float32 bestCost = b2_maxFloat;
+				int32 bestBin = 0;
+				n = 0;
+				for (int32 i = 1; i < binCount; ++i)
+				{
+					if (counts[i - 1] > 0)
+					{
+						if (n == 0)
+						{
+							box = bounds[i - 1];
+						}
+						else
+						{
+							box.Combine(bounds[i - 1]);
+						}
+						n += counts[i - 1];
+					}
+
+					if (n == 0 || n == range.count)
+					{
+						continue;
+					}
+
+					float32 cost = n * box.GetPerimeter() + rightCost[i];
+					if (cost < bestCost)
+					{
+						bestCost = cost;
+						bestBin = i;
+					}
+				}
+
+				// Partition the leaves around the plane.
+				int32 i = 0, j = range.count - 1;
+				while (i <= j)
+				{
+					b2Vec2 c = m_nodes[first[i]].aabb.GetCenter();
+					int32 bin = b2Min(int32(((axis == 0 ? c.x : c.y) - axisLower) * scale), binCount - 1);
+					if (bin < bestBin)
+					{
+						++i;
+					}
+					else
+					{
+						b2Swap(first[i], first[j]);
+						--j;
+					}
+				}
+				split = i;
+			}
+
+			// All centroids in one spot: split the range in half.
+			if (split <= 0 || split >= range.count)
+			{
+				split = range.count / 2;
+			}
+		}
+
+		m_nodes[nodeId].parent = range.parent;
+		if (range.parent != b2_nullNode)
+		{
+			if (range.isChild1)
+			{
+				m_nodes[range.parent].child1 = nodeId;
+			}
+			else
+			{
+				m_nodes[range.parent].child2 = nodeId;
+			}
+		}
+		else
+		{
+			m_root = nodeId;
+		}
+
+		if (range.count > 1)
+		{
+			Range left = { range.start, split, nodeId, true };
+			Range right = { range.start + split, range.count - split, nodeId, false };
+			stack.Push(right);
+			stack.Push(left);
+		}
+	}
+
+	// Parents were allocated before their children, so a reverse pass sees children first.
+	for (int32 i = internalCount - 1; i >= 0; --i)
+	{
+		b2TreeNode* node = m_nodes + internals[i];
+		const b2TreeNode* child1 = m_nodes + node->child1;
+		const b2TreeNode* child2 = m_nodes + node->child2;
+		node->aabb.Combine(child1->aabb, child2->aabb);
+		node->height = 1 + b2Max(child1->height, child2->height);
+	}
+
+	b2Free(internals);
+	b2Free(leaves);
+
+	Validate();
+}
+
+struct b2MortonKey
+{
+	uint32 code;
+	int32 index;
+};
+
+static bool b2MortonLessThan(const b2MortonKey& key1, const b2MortonKey& key2)
+{
+	if (key1.code != key2.code)
+	{
+		return key1.code < key2.code;
+	}
+	return key1.index < key2.index;
+}
+
+void b2DynamicTree::SortBatch(const b2AABB* aabbs, int32 count, int32* order) const
+{
+	// Quantize the centers to 16 bits per axis over the tree bounds.
+	b2AABB bounds = m_nodes[m_root].aabb;
+	b2Vec2 extent = bounds.upperBound - bounds.lowerBound;
+	float32 scaleX = extent.x > 0.0f ? 65535.0f / extent.x : 0.0f;
+	float32 scaleY = extent.y > 0.0f ? 65535.0f / extent.y : 0.0f;
+
+	b2MortonKey* keys = (b2MortonKey*)b2Alloc(count * sizeof(b2MortonKey));
+	for (int32 i = 0; i < count; ++i)
+	{
+		b2Vec2 c = aabbs[i].GetCenter();
+		uint32 x = uint32(b2Clamp((c.x - bounds.lowerBound.x) * scaleX, 0.0f, 65535.0f));
+		uint32 y = uint32(b2Clamp((c.y - bounds.lowerBound.y) * scaleY, 0.0f, 65535.0f));
+
+		// Interleave the bits of x and y.
+		uint32 code = 0;
+		for (int32 bit = 0; bit < 16; ++bit)
+		{
+			code |= ((x >> bit) & 1) << (2 * bit);
+			code |= ((y >> bit) & 1) << (2 * bit + 1);
+		}
+
+		keys[i].code = code;
+		keys[i].index = i;
+	}
+
+	std::sort(keys, keys + count, b2MortonLessThan);
+
+	for (int32 i = 0; i < count; ++i)
+	{
+		order[i] = keys[i].index;
+	}
+
+	b2Free(keys);
+}
+
 void b2DynamicTree::ShiftOrigin(const b2Vec2& newOrigin)
 {
 	// Build array of leaves. Free the rest.
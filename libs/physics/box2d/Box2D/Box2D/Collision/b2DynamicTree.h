@@ -22,6 +22,11 @@
 #include <Box2D/Collision/b2Collision.h>
 #include <Box2D/Common/b2GrowableStack.h>
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define B2_SSE
+#include <xmmintrin.h>
+#endif
+
 #define b2_nullNode (-1)
 
 /// A node in the dynamic tree. The client does not interact with this directly.
@@ -50,6 +55,53 @@ struct b2TreeNode
 	int32 height;
 };
 
+/// Four query boxes in SoA layout, for testing a tree node against four queries at once.
+struct b2AABB4
+{
+	/// Set lane i to a box that overlaps nothing.
+	void SetEmpty(int32 i)
+	{
+		lowerX[i] = lowerY[i] = b2_maxFloat;
+		upperX[i] = upperY[i] = -b2_maxFloat;
+	}
+
+	void Set(int32 i, const b2AABB& aabb)
+	{
+		lowerX[i] = aabb.lowerBound.x;
+		lowerY[i] = aabb.lowerBound.y;
+		upperX[i] = aabb.upperBound.x;
+		upperY[i] = aabb.upperBound.y;
+	}
+
+	float32 lowerX[4];
+	float32 lowerY[4];
+	float32 upperX[4];
+	float32 upperY[4];
+};
+
+/// Test one AABB against four. Bit i of the result is set if lane i overlaps.
+inline int32 b2TestOverlap4(const b2AABB& a, const b2AABB4& b)
+{
+#ifdef B2_SSE
+	__m128 sep = _mm_cmpgt_ps(_mm_loadu_ps(b.lowerX), _mm_set1_ps(a.upperBound.x));
+	sep = _mm_or_ps(sep, _mm_cmpgt_ps(_mm_loadu_ps(b.lowerY), _mm_set1_ps(a.upperBound.y)));
+	sep = _mm_or_ps(sep, _mm_cmplt_ps(_mm_loadu_ps(b.upperX), _mm_set1_ps(a.lowerBound.x)));
+	sep = _mm_or_ps(sep, _mm_cmplt_ps(_mm_loadu_ps(b.upperY), _mm_set1_ps(a.lowerBound.y)));
+	return ~_mm_movemask_ps(sep) & 0xF;
+#else
+	int32 mask = 0;
+	for (int32 i = 0; i < 4; ++i)
+	{
+		if (b.lowerX[i] <= a.upperBound.x && b.lowerY[i] <= a.upperBound.y &&
+			a.lowerBound.x <= b.upperX[i] && a.lowerBound.y <= b.upperY[i])
+		{
+			mask |= 1 << i;
+		}
+	}
+	return mask;
+#endif
+}
+
 /// A dynamic AABB tree broad-phase, inspired by Nathanael Presson's btDbvt.
 /// A dynamic tree arranges data in a binary tree to accelerate
 /// queries such as volume queries and ray casts. Leafs are proxies
@@ -101,6 +153,19 @@ public:
 	template <typename T>
 	void RayCast(T* callback, const b2RayCastInput& input) const;
 
+	/// Query many AABBs in one pass. The queries are reordered so that nearby ones
+	/// share a traversal, and each node is tested against four of them at once.
+	/// The callback is called as QueryCallback(queryIndex, proxyId). Returning false
+	/// ends that query only.
+	template <typename T>
+	void QueryBatch(T* callback, const b2AABB* aabbs, int32 count) const;
+
+	/// Ray-cast many rays in one pass, grouped like QueryBatch. The callback is called
+	/// as RayCastCallback(rayIndex, input, proxyId) and its return value works as in
+	/// RayCast, for that ray only.
+	template <typename T>
+	void RayCastBatch(T* callback, const b2RayCastInput* inputs, int32 count) const;
+
 	/// Validate this tree. For testing.
 	void Validate() const;
 
@@ -118,6 +183,11 @@ public:
 	/// Build an optimal tree. Very expensive. For testing.
 	void RebuildBottomUp();
 
+	/// Rebuild the tree top-down, splitting by a binned surface area heuristic.
+	/// This is O(n log n) and gives much better query performance than incremental
+	/// insertion. Proxy ids are kept. Call it after creating a lot of static proxies.
+	void RebuildTopDown();
+
 	/// Shift the world origin. Useful for large worlds.
 	/// The shift formula is: position -= newOrigin
 	/// @param newOrigin the new origin with respect to the old origin
@@ -139,6 +209,15 @@ private:
 	void ValidateStructure(int32 index) const;
 	void ValidateMetrics(int32 index) const;
 
+	// Order batch queries along a Morton curve so that a group of four covers a small area.
+	void SortBatch(const b2AABB* aabbs, int32 count, int32* order) const;
+
+	struct b2BatchEntry
+	{
+		int32 nodeId;
+		int32 mask;
+	};
+
 	int32 m_root;
 
 	b2TreeNode* m_nodes;
@@ -286,4 +365,222 @@ inline void b2DynamicTree::RayCast(T* callback, const b2RayCastInput& input) con
 	}
 }
 
+template <typename T>
+inline void b2DynamicTree::QueryBatch(T* callback, const b2AABB* aabbs, int32 count) const
+{
+	if (count <= 0 || m_root == b2_nullNode)
+	{
+		return;
+	}
+
+	int32* order = (int32*)b2Alloc(count * sizeof(int32));
+	SortBatch(aabbs, count, order);
+
+	b2GrowableStack<b2BatchEntry, 256> stack;
+	for (int32 base = 0; base < count; base += 4)
+	{
+		int32 lanes = b2Min(count - base, 4);
+		b2AABB4 boxes;
+		for (int32 i = 0; i < 4; ++i)
+		{
+			if (i < lanes)
+			{
+				boxes.Set(i, aabbs[order[base + i]]);
+			}
+			else
+			{
+				boxes.SetEmpty(i);
+			}
+		}
+
+		int32 active = (1 << lanes) - 1;
+		b2BatchEntry root = { m_root, active };
+		stack.Push(root);
+
+		while (stack.GetCount() > 0)
+		{
+			b2BatchEntry entry = stack.Pop();
+			const b2TreeNode* node = m_nodes + entry.nodeId;
+
+			int32 mask = entry.mask & active;
+			if (mask != 0)
+			{
+				mask &= b2TestOverlap4(node->aabb, boxes);
+			}
+
+			if (mask == 0)
+			{
+				continue;
+			}
+
+			if (node->IsLeaf())
+			{
+				for (int32 i = 0; i < lanes; ++i)
+				{
+					if ((mask & (1 << i)) && callback->QueryCallback(order[base + i], entry.nodeId) == false)
+					{
+						active &= ~(1 << i);
+					}
+				}
+			}
+			else
+			{
+				b2BatchEntry child1 = { node->child1, mask };
+				b2BatchEntry child2 = { node->child2, mask };
+				stack.Push(child1);
+				stack.Push(child2);
+			}
+		}
+	}
+
+	b2Free(order);
+}
+
+template <typename T>
+inline void b2DynamicTree::RayCastBatch(T* callback, const b2RayCastInput* inputs, int32 count) const
+{
+	if (count <= 0 || m_root == b2_nullNode)
+	{
+		return;
+	}
+
+	// Group the rays by their segment bounds.
+	b2AABB* segments = (b2AABB*)b2Alloc(count * sizeof(b2AABB));
+	int32* order = (int32*)b2Alloc(count * sizeof(int32));
+	for (int32 i = 0; i < count; ++i)
+	{
+		b2Vec2 p1 = inputs[i].p1;
+		b2Vec2 t = p1 + inputs[i].maxFraction * (inputs[i].p2 - p1);
+		segments[i].lowerBound = b2Min(p1, t);
+		segments[i].upperBound = b2Max(p1, t);
+	}
+	SortBatch(segments, count, order);
+
+	b2GrowableStack<b2BatchEntry, 256> stack;
+	for (int32 base = 0; base < count; base += 4)
+	{
+		int32 lanes = b2Min(count - base, 4);
+
+		// Per lane: segment bounds, start point, |v| and v perpendicular to the ray.
+		b2AABB4 boxes;
+		float32 maxFraction[4];
+		float32 p1x[4], p1y[4], vx[4], vy[4], absVx[4], absVy[4];
+		for (int32 i = 0; i < 4; ++i)
+		{
+			if (i >= lanes)
+			{
+				boxes.SetEmpty(i);
+				maxFraction[i] = 0.0f;
+				p1x[i] = p1y[i] = vx[i] = vy[i] = absVx[i] = absVy[i] = 0.0f;
+				continue;
+			}
+
+			const b2RayCastInput& input = inputs[order[base + i]];
+			b2Vec2 r = input.p2 - input.p1;
+			b2Assert(r.LengthSquared() > 0.0f);
+			r.Normalize();
+			b2Vec2 v = b2Cross(1.0f, r);
+
+			boxes.Set(i, segments[order[base + i]]);
+			maxFraction[i] = input.maxFraction;
+			p1x[i] = input.p1.x;
+			p1y[i] = input.p1.y;
+			vx[i] = v.x;
+			vy[i] = v.y;
+			absVx[i] = b2Abs(v.x);
+			absVy[i] = b2Abs(v.y);
+		}
+
+		int32 active = (1 << lanes) - 1;
+		b2BatchEntry root = { m_root, active };
+		stack.Push(root);
+
+		while (stack.GetCount() > 0)
+		{
+			b2BatchEntry entry = stack.Pop();
+			const b2TreeNode* node = m_nodes + entry.nodeId;
+
+			int32 mask = entry.mask & active;
+			if (mask != 0)
+			{
+				mask &= b2TestOverlap4(node->aabb, boxes);
+			}
+
+			if (mask == 0)
+			{
+				continue;
+			}
+
+			// Separating axis for segment (Gino, p80).
+			// |dot(v, p1 - c)| > dot(|v|, h)
+			b2Vec2 c = node->aabb.GetCenter();
+			b2Vec2 h = node->aabb.GetExtents();
+#ifdef B2_SSE
+			__m128 d = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vx), _mm_sub_ps(_mm_loadu_ps(p1x), _mm_set1_ps(c.x))),
+								  _mm_mul_ps(_mm_loadu_ps(vy), _mm_sub_ps(_mm_loadu_ps(p1y), _mm_set1_ps(c.y))));
+			d = _mm_andnot_ps(_mm_set1_ps(-0.0f), d);
+			__m128 r = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(absVx), _mm_set1_ps(h.x)), _mm_mul_ps(_mm_loadu_ps(absVy), _mm_set1_ps(h.y)));
+			mask &= ~_mm_movemask_ps(_mm_cmpgt_ps(_mm_sub_ps(d, r), _mm_setzero_ps()));
+#else
+			for (int32 i = 0; i < lanes; ++i)
+			{
+				float32 separation = b2Abs(vx[i] * (p1x[i] - c.x) + vy[i] * (p1y[i] - c.y)) - (absVx[i] * h.x + absVy[i] * h.y);
+				if (separation > 0.0f)
+				{
+					mask &= ~(1 << i);
+				}
+			}
+#endif
+			if (mask == 0)
+			{
+				continue;
+			}
+
+			if (node->IsLeaf() == false)
+			{
+				b2BatchEntry child1 = { node->child1, mask };
+				b2BatchEntry child2 = { node->child2, mask };
+				stack.Push(child1);
+				stack.Push(child2);
+				continue;
+			}
+
+			for (int32 i = 0; i < lanes; ++i)
+			{
+				if ((mask & (1 << i)) == 0)
+				{
+					continue;
+				}
+
+				const b2RayCastInput& input = inputs[order[base + i]];
+				b2RayCastInput subInput;
+				subInput.p1 = input.p1;
+				subInput.p2 = input.p2;
+				subInput.maxFraction = maxFraction[i];
+
+				float32 value = callback->RayCastCallback(order[base + i], subInput, entry.nodeId);
+
+				if (value == 0.0f)
+				{
+					// The client has terminated this ray cast.
+					active &= ~(1 << i);
+				}
+				else if (value > 0.0f)
+				{
+					// Update segment bounding box.
+					maxFraction[i] = value;
+					b2Vec2 t = input.p1 + value * (input.p2 - input.p1);
+					b2AABB segment;
+					segment.lowerBound = b2Min(input.p1, t);
+					segment.upperBound = b2Max(input.p1, t);
+					boxes.Set(i, segment);
+				}
+			}
+		}
+	}
+
+	b2Free(order);
+	b2Free(segments);
+}
+
 #endif
@@ -0,0 +1,164 @@
+/*
+* Copyright (c) 2011 Erin Catto http://box2d.org
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Box2D/Common/b2WorkerPool.h>
+#include <Box2D/Common/b2Math.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+
+struct b2WorkerPoolState
+{
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+	std::thread* threads;
+
+	b2ParallelTask* task;
+	int32 count;
+	std::atomic<int32> next;
+	int32 generation;
+	int32 active;
+	bool quit;
+};
+
+static void b2RunTask(b2WorkerPoolState* s, b2ParallelTask* task, int32 count, int32 workerIndex)
+{
+	for (;;)
+	{
+		int32 index = s->next.fetch_add(1, std::memory_order_relaxed);
+		if (index >= count)
+		{
+			break;
+		}
+		task->Execute(index, workerIndex);
+	}
+}
+
+static void b2WorkerMain(b2WorkerPoolState* s, int32 workerIndex)
+{
+	int32 seen = 0;
+	for (;;)
+	{
+		b2ParallelTask* task;
+		int32 count;
+		{
+			std::unique_lock<std::mutex> lock(s->mutex);
+			while (s->quit == false && s->generation == seen)
+			{
+				s->wake.wait(lock);
+			}
+			if (s->quit)
+			{
+				return;
+			}
+			seen = s->generation;
+			task = s->task;
+			count = s->count;
+		}
+
+		b2RunTask(s, task, count, workerIndex);
+
+		std::lock_guard<std::mutex> lock(s->mutex);
+		if (--s->active == 0)
+		{
+			s->done.notify_one();
+		}
+	}
+}
+
+b2WorkerPool::b2WorkerPool(int32 workerCount)
+{
+	b2Assert(workerCount >= 0);
+	m_workerCount = workerCount;
+
+	void* mem = b2Alloc(sizeof(b2WorkerPoolState));
+	m_state = new (mem) b2WorkerPoolState;
+	m_state->task = NULL;
+	m_state->count = 0;
+	m_state->next = 0;
+	m_state->generation = 0;
+	m_state->active = 0;
+	m_state->quit = false;
+
+	m_state->threads = (std::thread*)b2Alloc(b2Max(workerCount, 1) * sizeof(std::thread));
+	for (int32 i = 0; i < workerCount; ++i)
+	{
+		new (m_state->threads + i) std::thread(b2WorkerMain, m_state, i + 1);
+	}
+}
+
+b2WorkerPool::~b2WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_state->mutex);
+		m_state->quit = true;
+	}
+	m_state->wake.notify_all();
+
+	for (int32 i = 0; i < m_workerCount; ++i)
+	{
+		m_state->threads[i].join();
+		m_state->threads[i].~thread();
+	}
+	b2Free(m_state->threads);
+
+	m_state->~b2WorkerPoolState();
+	b2Free(m_state);
+}
+
+void b2WorkerPool::ParallelFor(int32 count, b2ParallelTask* task)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	// Not worth waking anyone for a single item.
+	if (m_workerCount == 0 || count == 1)
+	{
+		for (int32 i = 0; i < count; ++i)
+		{
+			task->Execute(i, 0);
+		}
+		return;
+	}
+
+	b2WorkerPoolState* s = m_state;
+	{
+		std::lock_guard<std::mutex> lock(s->mutex);
+		s->task = task;
+		s->count = count;
+		s->next.store(0, std::memory_order_relaxed);
+		s->active = m_workerCount;
+		++s->generation;
+	}
+	s->wake.notify_all();
+
+	b2RunTask(s, task, count, 0);
+
+	// The mutex hand-off makes every worker's writes visible to the caller.
+	std::unique_lock<std::mutex> lock(s->mutex);
+	while (s->active > 0)
+	{
+		s->done.wait(lock);
+	}
+}
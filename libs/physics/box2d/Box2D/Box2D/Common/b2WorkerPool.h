@@ -0,0 +1,61 @@
+/*
+* Copyright (c) 2011 Erin Catto http://box2d.org
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef B2_WORKER_POOL_H
+#define B2_WORKER_POOL_H
+
+#include <Box2D/Common/b2Settings.h>
+
+/// A unit of work for b2WorkerPool::ParallelFor.
+class b2ParallelTask
+{
+public:
+	virtual ~b2ParallelTask() {}
+
+	/// Called once for every index. workerIndex is 0 for the calling thread and
+	/// 1..GetWorkerCount() for the pool threads, so per-thread scratch can be indexed by it.
+	virtual void Execute(int32 index, int32 workerIndex) = 0;
+};
+
+struct b2WorkerPoolState;
+
+/// A fixed set of threads that help the calling thread run b2ParallelTask
+/// batches. Indices are handed out dynamically, so the order they run in is
+/// not defined; tasks must write results to per-index storage.
+class b2WorkerPool
+{
+public:
+	/// Start workerCount threads.
+	b2WorkerPool(int32 workerCount);
+
+	/// Stop and join the threads.
+	~b2WorkerPool();
+
+	/// Run task->Execute for every index in [0, count) and return when all are done.
+	/// The calling thread takes part. Not reentrant.
+	void ParallelFor(int32 count, b2ParallelTask* task);
+
+	/// Get the number of threads besides the calling thread.
+	int32 GetWorkerCount() const { return m_workerCount; }
+
+private:
+	int32 m_workerCount;
+	b2WorkerPoolState* m_state;
+};
+
+#endif
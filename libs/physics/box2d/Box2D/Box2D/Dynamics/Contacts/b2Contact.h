@@ -146,6 +146,7 @@ public:
 
 protected:
 	friend class b2ContactManager;
+	friend class b2CollideTask;
 	friend class b2World;
 	friend class b2ContactSolver;
 	friend class b2Body;
@@ -189,6 +190,11 @@ protected:
 
 	void Update(b2ContactListener* listener);
 
+	// Update split in two so the narrow phase can run on worker threads. ComputeManifold
+	// only reads the contact and returns whether it is touching. Update applies the result.
+	bool ComputeManifold(b2Manifold* manifold);
+	void Update(b2ContactListener* listener, const b2Manifold& manifold, bool touching);
+
 	static b2ContactRegister s_registers[b2Shape::e_typeCount][b2Shape::e_typeCount];
 	static bool s_initialized;
 
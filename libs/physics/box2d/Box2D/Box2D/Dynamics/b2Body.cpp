@@ -477,14 +477,8 @@ void b2Body::SetActive(bool flag)
 	{
 		m_flags &= ~e_activeFlag;
 
-		// Destroy all proxies.
-		b2BroadPhase* broadPhase = &m_world->m_contactManager.m_broadPhase;
-		for (b2Fixture* f = m_fixtureList; f; f = f->m_next)
-		{
-			f->DestroyProxies(broadPhase);
-		}
-
-		// Destroy the attached contacts.
+		// Destroy the attached contacts. This comes first so their
+		// broad-phase pairs are released while the proxies exist.
 		b2ContactEdge* ce = m_contactList;
 		while (ce)
 		{
@@ -493,6 +487,13 @@ void b2Body::SetActive(bool flag)
 			m_world->m_contactManager.Destroy(ce0->contact);
 		}
 		m_contactList = NULL;
+
+		// Destroy all proxies.
+		b2BroadPhase* broadPhase = &m_world->m_contactManager.m_broadPhase;
+		for (b2Fixture* f = m_fixtureList; f; f = f->m_next)
+		{
+			f->DestroyProxies(broadPhase);
+		}
 	}
 }
 
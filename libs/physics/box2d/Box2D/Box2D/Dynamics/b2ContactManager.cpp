@@ -21,6 +21,7 @@
 #include <Box2D/Dynamics/b2Fixture.h>
 #include <Box2D/Dynamics/b2WorldCallbacks.h>
 #include <Box2D/Dynamics/Contacts/b2Contact.h>
+#include <Box2D/Common/b2WorkerPool.h>
 
 b2ContactFilter b2_defaultFilter;
 b2ContactListener b2_defaultListener;
@@ -32,6 +33,7 @@ b2ContactManager::b2ContactManager()
 	m_contactFilter = &b2_defaultFilter;
 	m_contactListener = &b2_defaultListener;
 	m_allocator = NULL;
+	m_workerPool = NULL;
 }
 
 void b2ContactManager::Destroy(b2Contact* c)
@@ -46,6 +48,11 @@ void b2ContactManager::Destroy(b2Contact* c)
 		m_contactListener->EndContact(c);
 	}
 
+	// Let the broad-phase report this pair again.
+	int32 proxyIdA = fixtureA->m_proxies[c->GetChildIndexA()].proxyId;
+	int32 proxyIdB = fixtureB->m_proxies[c->GetChildIndexB()].proxyId;
+	m_broadPhase.ReleasePair(proxyIdA, proxyIdB);
+
 	// Remove from the world.
 	if (c->m_prev)
 	{
@@ -99,15 +106,102 @@ void b2ContactManager::Destroy(b2Contact* c)
 	--m_contactCount;
 }
 
+// Number of contacts a worker narrow-phases at a time.
+const int32 b2_collideChunkSize = 64;
+
+struct b2CollideResult
+{
+	b2Manifold manifold;
+	bool touching;
+};
+
+// Computes contact manifolds on the worker pool.
+class b2CollideTask : public b2ParallelTask
+{
+public:
+	void Execute(int32 index, int32 workerIndex)
+	{
+		B2_NOT_USED(workerIndex);
+		int32 begin = index * b2_collideChunkSize;
+		int32 end = b2Min(begin + b2_collideChunkSize, count);
+		for (int32 i = begin; i < end; ++i)
+		{
+			results[i].touching = contacts[i]->ComputeManifold(&results[i].manifold);
+		}
+	}
+
+	b2Contact** contacts;
+	b2CollideResult* results;
+	int32 count;
+};
+
 // This is the top level collision call for the time step. Here
 // all the narrow phase collision is processed for the world
 // contact list.
 void b2ContactManager::Collide()
 {
+	// With workers, the contacts that are already known to reach Update have their
+	// manifolds computed up front. The loop below still applies them one by one, so
+	// the listener sees the same calls in the same order.
+	b2Contact** candidates = NULL;
+	b2CollideResult* results = NULL;
+	int32 candidateCount = 0;
+	if (m_workerPool && m_contactCount > b2_collideChunkSize)
+	{
+		candidates = (b2Contact**)b2Alloc(m_contactCount * sizeof(b2Contact*));
+		for (b2Contact* c = m_contactList; c; c = c->GetNext())
+		{
+			if (c->m_flags & b2Contact::e_filterFlag)
+			{
+				continue;
+			}
+
+			// Sensor overlap tests update the global GJK counters, so they stay on this thread.
+			b2Fixture* fixtureA = c->GetFixtureA();
+			b2Fixture* fixtureB = c->GetFixtureB();
+			if (fixtureA->IsSensor() || fixtureB->IsSensor())
+			{
+				continue;
+			}
+
+			b2Body* bodyA = fixtureA->GetBody();
+			b2Body* bodyB = fixtureB->GetBody();
+			bool activeA = bodyA->IsAwake() && bodyA->m_type != b2_staticBody;
+			bool activeB = bodyB->IsAwake() && bodyB->m_type != b2_staticBody;
+			if (activeA == false && activeB == false)
+			{
+				continue;
+			}
+
+			int32 proxyIdA = fixtureA->m_proxies[c->GetChildIndexA()].proxyId;
+			int32 proxyIdB = fixtureB->m_proxies[c->GetChildIndexB()].proxyId;
+			if (m_broadPhase.TestOverlap(proxyIdA, proxyIdB))
+			{
+				candidates[candidateCount++] = c;
+			}
+		}
+
+		results = (b2CollideResult*)b2Alloc(b2Max(candidateCount, 1) * sizeof(b2CollideResult));
+
+		b2CollideTask task;
+		task.contacts = candidates;
+		task.results = results;
+		task.count = candidateCount;
+		m_workerPool->ParallelFor((candidateCount + b2_collideChunkSize - 1) / b2_collideChunkSize, &task);
+	}
+
 	// Update awake contacts.
+	int32 candidateIndex = 0;
 	b2Contact* c = m_contactList;
 	while (c)
 	{
+		// Contacts can only be skipped or destroyed below, so the candidates stay in step with the list.
+		b2CollideResult* result = NULL;
+		if (candidateIndex < candidateCount && candidates[candidateIndex] == c)
+		{
+			result = results + candidateIndex++;
+		}
+
 		b2Fixture* fixtureA = c->GetFixtureA();
 		b2Fixture* fixtureB = c->GetFixtureB();
 		int32 indexA = c->GetChildIndexA();
@@ -164,9 +258,22 @@ void b2ContactManager::Collide()
 		}
 
 		// The contact persists.
-		c->Update(m_contactListener);
+		if (result)
+		{
+			c->Update(m_contactListener, result->manifold, result->touching);
+		}
+		else
+		{
+			c->Update(m_contactListener);
+		}
 		c = c->GetNext();
 	}
+
+	if (candidates)
+	{
+		b2Free(results);
+		b2Free(candidates);
+	}
 }
 
 void b2ContactManager::FindNewContacts()
@@ -194,33 +301,10 @@ void b2ContactManager::AddPair(void* proxyUserDataA, void* proxyUserDataB)
 		return;
 	}
 
-	// TODO_ERIN use a hash table to remove a potential bottleneck when both
-	// bodies have a lot of contacts.
 	// Does a contact already exist?
-	b2ContactEdge* edge = bodyB->GetContactList();
-	while (edge)
+	if (m_broadPhase.IsPairCached(proxyA->proxyId, proxyB->proxyId))
 	{
-		if (edge->other == bodyA)
-		{
-			b2Fixture* fA = edge->contact->GetFixtureA();
-			b2Fixture* fB = edge->contact->GetFixtureB();
-			int32 iA = edge->contact->GetChildIndexA();
-			int32 iB = edge->contact->GetChildIndexB();
-
-			if (fA == fixtureA && fB == fixtureB && iA == indexA && iB == indexB)
-			{
-				// A contact already exists.
-				return;
-			}
-
-			if (fA == fixtureB && fB == fixtureA && iA == indexB && iB == indexA)
-			{
-				// A contact already exists.
-				return;
-			}
-		}
-
-		edge = edge->next;
+		return;
 	}
 
 	// Does a joint override collision? Is at least one body dynamic?
@@ -242,6 +326,8 @@ void b2ContactManager::AddPair(void* proxyUserDataA, void* proxyUserDataB)
 		return;
 	}
 
+	m_broadPhase.CachePair(proxyA->proxyId, proxyB->proxyId);
+
 	// Contact creation may swap fixtures.
 	fixtureA = c->GetFixtureA();
 	fixtureB = c->GetFixtureB();
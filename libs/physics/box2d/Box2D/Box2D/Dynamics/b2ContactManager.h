@@ -25,6 +25,7 @@ class b2Contact;
 class b2ContactFilter;
 class b2ContactListener;
 class b2BlockAllocator;
+class b2WorkerPool;
 
 // Delegate of b2World.
 class b2ContactManager
@@ -47,6 +48,7 @@ public:
 	b2ContactFilter* m_contactFilter;
 	b2ContactListener* m_contactListener;
 	b2BlockAllocator* m_allocator;
+	b2WorkerPool* m_workerPool;
 };
 
 #endif
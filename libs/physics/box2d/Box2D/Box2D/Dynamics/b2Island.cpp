@@ -162,6 +162,12 @@ b2Island::b2Island(
 	m_allocator = allocator;
 	m_listener = listener;
 
+	m_staticLock = NULL;
+	m_staticSlots = NULL;
+	m_staticCount = 0;
+	m_impulses = NULL;
+	m_sleeping = false;
+
 	m_bodies = (b2Body**)m_allocator->Allocate(bodyCapacity * sizeof(b2Body*));
 	m_contacts = (b2Contact**)m_allocator->Allocate(contactCapacity	 * sizeof(b2Contact*));
 	m_joints = (b2Joint**)m_allocator->Allocate(jointCapacity * sizeof(b2Joint*));
@@ -185,6 +191,8 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	b2Timer timer;
 
 	float32 h = step.dt;
+	bool concurrent = m_staticLock != NULL;
+	m_sleeping = false;
 
 	// Integrate velocities and apply damping. Initialize the body state.
 	for (int32 i = 0; i < m_bodyCount; ++i)
@@ -196,9 +204,12 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 		b2Vec2 v = b->m_linearVelocity;
 		float32 w = b->m_angularVelocity;
 
-		// Store positions for continuous collision.
-		b->m_sweep.c0 = b->m_sweep.c;
-		b->m_sweep.a0 = b->m_sweep.a;
+		// Store positions for continuous collision. Static bodies already have c0 == c.
+		if (concurrent == false || b->m_type != b2_staticBody)
+		{
+			b->m_sweep.c0 = b->m_sweep.c;
+			b->m_sweep.a0 = b->m_sweep.a;
+		}
 
 		if (b->m_type == b2_dynamicBody)
 		{
@@ -240,7 +251,21 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	contactSolverDef.velocities = m_velocities;
 	contactSolverDef.allocator = m_allocator;
 
+	// The contact solver and the joints capture body island indices here.
+	bool lockStatics = concurrent && m_staticCount > 0;
+	if (lockStatics)
+	{
+		m_staticLock->lock();
+		CaptureStaticIndices();
+	}
+
 	b2ContactSolver contactSolver(&contactSolverDef);
+
+	if (lockStatics)
+	{
+		m_staticLock->unlock();
+	}
+
 	contactSolver.InitializeVelocityConstraints();
 
 	if (step.warmStarting)
@@ -248,11 +273,22 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 		contactSolver.WarmStart();
 	}
 	
+	if (lockStatics && m_jointCount > 0)
+	{
+		m_staticLock->lock();
+		CaptureStaticIndices();
+	}
+
 	for (int32 i = 0; i < m_jointCount; ++i)
 	{
 		m_joints[i]->InitVelocityConstraints(solverData);
 	}
 
+	if (lockStatics && m_jointCount > 0)
+	{
+		m_staticLock->unlock();
+	}
+
 	profile->solveInit = timer.GetMilliseconds();
 
 	// Solve velocity constraints
@@ -330,6 +366,12 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	for (int32 i = 0; i < m_bodyCount; ++i)
 	{
 		b2Body* body = m_bodies[i];
+		if (concurrent && body->m_type == b2_staticBody)
+		{
+			// The solver never moves a static body.
+			continue;
+		}
+
 		body->m_sweep.c = m_positions[i].c;
 		body->m_sweep.a = m_positions[i].a;
 		body->m_linearVelocity = m_velocities[i].v;
@@ -372,9 +414,15 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 
 		if (minSleepTime >= b2_timeToSleep && positionSolved)
 		{
+			// The world puts shared static bodies to sleep after a concurrent solve.
+			m_sleeping = true;
 			for (int32 i = 0; i < m_bodyCount; ++i)
 			{
 				b2Body* b = m_bodies[i];
+				if (concurrent && b->m_type == b2_staticBody)
+				{
+					continue;
+				}
 				b->SetAwake(false);
 			}
 		}
@@ -534,6 +582,22 @@ void b2Island::Report(const b2ContactVelocityConstraint* constraints)
 			impulse.tangentImpulses[j] = vc->points[j].tangentImpulse;
 		}
 
-		m_listener->PostSolve(c, &impulse);
+		if (m_impulses)
+		{
+			m_impulses[i] = impulse;
+		}
+		else
+		{
+			m_listener->PostSolve(c, &impulse);
+		}
+	}
+}
+
+void b2Island::CaptureStaticIndices()
+{
+	for (int32 i = 0; i < m_staticCount; ++i)
+	{
+		int32 slot = m_staticSlots[i];
+		m_bodies[slot]->m_islandIndex = slot;
 	}
 }
@@ -22,11 +22,13 @@
 #include <Box2D/Common/b2Math.h>
 #include <Box2D/Dynamics/b2Body.h>
 #include <Box2D/Dynamics/b2TimeStep.h>
+#include <mutex>
 
 class b2Contact;
 class b2Joint;
 class b2StackAllocator;
 class b2ContactListener;
+struct b2ContactImpulse;
 struct b2ContactVelocityConstraint;
 struct b2Profile;
 
@@ -71,9 +73,22 @@ public:
 
 	void Report(const b2ContactVelocityConstraint* constraints);
 
+	/// Point the static bodies of this island at their local slots. Static bodies
+	/// are shared between islands that are solved at the same time.
+	void CaptureStaticIndices();
+
 	b2StackAllocator* m_allocator;
 	b2ContactListener* m_listener;
 
+	// Set when this island is solved concurrently with others. Static bodies are
+	// then left untouched, m_islandIndex is only read under m_staticLock, and
+	// PostSolve impulses are stored in m_impulses for the world to report.
+	std::mutex* m_staticLock;
+	const int32* m_staticSlots;
+	int32 m_staticCount;
+	b2ContactImpulse* m_impulses;
+	bool m_sleeping;
+
 	b2Body** m_bodies;
 	b2Contact** m_contacts;
 	b2Joint** m_joints;
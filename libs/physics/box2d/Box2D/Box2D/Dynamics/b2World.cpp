@@ -32,6 +32,7 @@
 #include <Box2D/Collision/b2TimeOfImpact.h>
 #include <Box2D/Common/b2Draw.h>
 #include <Box2D/Common/b2Timer.h>
+#include <Box2D/Common/b2WorkerPool.h>
 #include <new>
 
 b2World::b2World(const b2Vec2& gravity)
@@ -60,11 +61,16 @@ b2World::b2World(const b2Vec2& gravity)
 
 	m_contactManager.m_allocator = &m_blockAllocator;
 
+	m_workerPool = NULL;
+	m_workerStacks = NULL;
+
 	memset(&m_profile, 0, sizeof(b2Profile));
 }
 
 b2World::~b2World()
 {
+	SetWorkerCount(0);
+
 	// Some shapes allocate using b2Alloc.
 	b2Body* b = m_bodyList;
 	while (b)
@@ -84,6 +90,54 @@ b2World::~b2World()
 	}
 }
 
+void b2World::SetWorkerCount(int32 count)
+{
+	b2Assert(IsLocked() == false);
+	b2Assert(count >= 0);
+	if (count == GetWorkerCount())
+	{
+		return;
+	}
+
+	if (m_workerPool)
+	{
+		int32 oldCount = m_workerPool->GetWorkerCount();
+		m_workerPool->~b2WorkerPool();
+		b2Free(m_workerPool);
+
+		for (int32 i = 1; i <= oldCount; ++i)
+		{
+			m_workerStacks[i]->~b2StackAllocator();
+			b2Free(m_workerStacks[i]);
+		}
+		b2Free(m_workerStacks);
+
+		m_workerPool = NULL;
+		m_workerStacks = NULL;
+	}
+
+	if (count > 0)
+	{
+		m_workerStacks = (b2StackAllocator**)b2Alloc((count + 1) * sizeof(b2StackAllocator*));
+		m_workerStacks[0] = &m_stackAllocator;
+		for (int32 i = 1; i <= count; ++i)
+		{
+			void* mem = b2Alloc(sizeof(b2StackAllocator));
+			m_workerStacks[i] = new (mem) b2StackAllocator;
+		}
+
+		void* mem = b2Alloc(sizeof(b2WorkerPool));
+		m_workerPool = new (mem) b2WorkerPool(count);
+	}
+
+	m_contactManager.m_workerPool = m_workerPool;
+}
+
+int32 b2World::GetWorkerCount() const
+{
+	return m_workerPool ? m_workerPool->GetWorkerCount() : 0;
+}
+
 void b2World::SetDestructionListener(b2DestructionListener* listener)
 {
 	m_destructionListener = listener;
@@ -382,6 +436,54 @@ void b2World::SetAllowSleeping(bool flag)
 	}
 }
 
+// An island found by b2World::Solve, as ranges of the island that collects them all.
+struct b2IslandRange
+{
+	int32 bodyStart, bodyCount;
+	int32 contactStart, contactCount;
+	int32 jointStart, jointCount;
+	int32 staticStart, staticCount;
+};
+
+// Solves the collected islands on the worker pool.
+class b2SolveIslandsTask : public b2ParallelTask
+{
+public:
+	void Execute(int32 index, int32 workerIndex)
+	{
+		const b2IslandRange* r = ranges + index;
+		b2Island island(r->bodyCount, r->contactCount, r->jointCount, stacks[workerIndex], listener);
+
+		memcpy(island.m_bodies, all->m_bodies + r->bodyStart, r->bodyCount * sizeof(b2Body*));
+		memcpy(island.m_contacts, all->m_contacts + r->contactStart, r->contactCount * sizeof(b2Contact*));
+		memcpy(island.m_joints, all->m_joints + r->jointStart, r->jointCount * sizeof(b2Joint*));
+		island.m_bodyCount = r->bodyCount;
+		island.m_contactCount = r->contactCount;
+		island.m_jointCount = r->jointCount;
+
+		island.m_staticLock = &staticLock;
+		island.m_staticSlots = staticSlots + r->staticStart;
+		island.m_staticCount = r->staticCount;
+		island.m_impulses = listener ? impulses + r->contactStart : NULL;
+
+		island.Solve(profiles + index, *step, gravity, allowSleep);
+		sleeping[index] = island.m_sleeping;
+	}
+
+	const b2TimeStep* step;
+	b2Vec2 gravity;
+	bool allowSleep;
+	b2ContactListener* listener;
+	b2StackAllocator** stacks;
+	const b2Island* all;
+	const b2IslandRange* ranges;
+	const int32* staticSlots;
+	b2ContactImpulse* impulses;
+	b2Profile* profiles;
+	bool* sleeping;
+	std::mutex staticLock;
+};
+
 // Find islands, integrate and solve constraints, solve position constraints
 void b2World::Solve(const b2TimeStep& step)
 {
@@ -389,8 +491,17 @@ void b2World::Solve(const b2TimeStep& step)
 	m_profile.solveVelocity = 0.0f;
 	m_profile.solvePosition = 0.0f;
 
+	// With workers every island is collected first and solved afterwards. A static
+	// body is collected once for each island it touches.
+	bool parallel = m_workerPool != NULL;
+	int32 bodyCapacity = m_bodyCount;
+	if (parallel)
+	{
+		bodyCapacity += m_contactManager.m_contactCount + m_jointCount;
+	}
+
 	// Size the island for the worst case.
-	b2Island island(m_bodyCount,
+	b2Island island(bodyCapacity,
 					m_contactManager.m_contactCount,
 					m_jointCount,
 					&m_stackAllocator,
@@ -413,6 +524,17 @@ void b2World::Solve(const b2TimeStep& step)
 	// Build and simulate all awake islands.
 	int32 stackSize = m_bodyCount;
 	b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
+
+	b2IslandRange* ranges = NULL;
+	int32* staticSlots = NULL;
+	int32 islandCount = 0;
+	int32 staticCount = 0;
+	if (parallel)
+	{
+		ranges = (b2IslandRange*)m_stackAllocator.Allocate(m_bodyCount * sizeof(b2IslandRange));
+		staticSlots = (int32*)m_stackAllocator.Allocate(bodyCapacity * sizeof(int32));
+	}
+
 	for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
 	{
 		if (seed->m_flags & b2Body::e_islandFlag)
@@ -432,7 +554,18 @@ void b2World::Solve(const b2TimeStep& step)
 		}
 
 		// Reset island and stack.
-		island.Clear();
+		if (parallel)
+		{
+			b2IslandRange* r = ranges + islandCount;
+			r->bodyStart = island.m_bodyCount;
+			r->contactStart = island.m_contactCount;
+			r->jointStart = island.m_jointCount;
+			r->staticStart = staticCount;
+		}
+		else
+		{
+			island.Clear();
+		}
 		int32 stackCount = 0;
 		stack[stackCount++] = seed;
 		seed->m_flags |= b2Body::e_islandFlag;
@@ -527,6 +660,32 @@ void b2World::Solve(const b2TimeStep& step)
 			}
 		}
 
+		if (parallel)
+		{
+			b2IslandRange* r = ranges + islandCount;
+			r->bodyCount = island.m_bodyCount - r->bodyStart;
+			r->contactCount = island.m_contactCount - r->contactStart;
+			r->jointCount = island.m_jointCount - r->jointStart;
+
+			for (int32 i = 0; i < r->bodyCount; ++i)
+			{
+				// Island indices are local to the island.
+				b2Body* b = island.m_bodies[r->bodyStart + i];
+				b->m_islandIndex = i;
+
+				// Allow static bodies to participate in other islands.
+				if (b->GetType() == b2_staticBody)
+				{
+					b->m_flags &= ~b2Body::e_islandFlag;
+					staticSlots[staticCount++] = i;
+				}
+			}
+
+			r->staticCount = staticCount - r->staticStart;
+			++islandCount;
+			continue;
+		}
+
 		b2Profile profile;
 		island.Solve(&profile, step, m_gravity, m_allowSleep);
 		m_profile.solveInit += profile.solveInit;
@@ -545,6 +704,13 @@ void b2World::Solve(const b2TimeStep& step)
 		}
 	}
 
+	if (parallel)
+	{
+		SolveIslands(step, island, ranges, islandCount, staticSlots);
+		m_stackAllocator.Free(staticSlots);
+		m_stackAllocator.Free(ranges);
+	}
+
 	m_stackAllocator.Free(stack);
 
 	{
@@ -573,6 +739,67 @@ void b2World::Solve(const b2TimeStep& step)
 	}
 }
 
+// Solve the islands collected by Solve on the worker pool, then make the listener
+// calls and the static body updates in the order a serial solve would have.
+void b2World::SolveIslands(const b2TimeStep& step, const b2Island& all, const b2IslandRange* ranges, int32 islandCount, const int32* staticSlots)
+{
+	b2ContactListener* listener = m_contactManager.m_contactListener;
+
+	b2ContactImpulse* impulses = NULL;
+	if (listener)
+	{
+		impulses = (b2ContactImpulse*)m_stackAllocator.Allocate(all.m_contactCount * sizeof(b2ContactImpulse));
+	}
+	b2Profile* profiles = (b2Profile*)m_stackAllocator.Allocate(islandCount * sizeof(b2Profile));
+	bool* sleeping = (bool*)m_stackAllocator.Allocate(islandCount * sizeof(bool));
+
+	b2SolveIslandsTask task;
+	task.step = &step;
+	task.gravity = m_gravity;
+	task.allowSleep = m_allowSleep;
+	task.listener = listener;
+	task.stacks = m_workerStacks;
+	task.all = &all;
+	task.ranges = ranges;
+	task.staticSlots = staticSlots;
+	task.impulses = impulses;
+	task.profiles = profiles;
+	task.sleeping = sleeping;
+	m_workerPool->ParallelFor(islandCount, &task);
+
+	for (int32 i = 0; i < islandCount; ++i)
+	{
+		const b2IslandRange* r = ranges + i;
+
+		m_profile.solveInit += profiles[i].solveInit;
+		m_profile.solveVelocity += profiles[i].solveVelocity;
+		m_profile.solvePosition += profiles[i].solvePosition;
+
+		if (listener)
+		{
+			for (int32 j = r->contactStart; j < r->contactStart + r->contactCount; ++j)
+			{
+				listener->PostSolve(all.m_contacts[j], impulses + j);
+			}
+		}
+
+		// A static body is left as the last island touching it would have left it.
+		for (int32 j = r->staticStart; j < r->staticStart + r->staticCount; ++j)
+		{
+			b2Body* b = all.m_bodies[r->bodyStart + staticSlots[j]];
+			b->m_islandIndex = staticSlots[j];
+			b->SetAwake(sleeping[i] == false);
+		}
+	}
+
+	m_stackAllocator.Free(sleeping);
+	m_stackAllocator.Free(profiles);
+	if (impulses)
+	{
+		m_stackAllocator.Free(impulses);
+	}
+}
+
 // Find TOI contacts and solve them.
 void b2World::SolveTOI(const b2TimeStep& step)
 {
@@ -1028,6 +1255,85 @@ void b2World::RayCast(b2RayCastCallback* callback, const b2Vec2& point1, const b
 	m_contactManager.m_broadPhase.RayCast(&wrapper, input);
 }
 
+struct b2WorldQueryBatchWrapper
+{
+	bool QueryCallback(int32 queryIndex, int32 proxyId)
+	{
+		b2FixtureProxy* proxy = (b2FixtureProxy*)broadPhase->GetUserData(proxyId);
+		return callback->ReportFixture(queryIndex, proxy->fixture);
+	}
+
+	const b2BroadPhase* broadPhase;
+	b2QueryBatchCallback* callback;
+};
+
+void b2World::QueryAABBBatch(b2QueryBatchCallback* callback, const b2AABB* aabbs, int32 count) const
+{
+	b2WorldQueryBatchWrapper wrapper;
+	wrapper.broadPhase = &m_contactManager.m_broadPhase;
+	wrapper.callback = callback;
+	m_contactManager.m_broadPhase.QueryBatch(&wrapper, aabbs, count);
+}
+
+struct b2WorldRayCastBatchWrapper
+{
+	float32 RayCastCallback(int32 rayIndex, const b2RayCastInput& input, int32 proxyId)
+	{
+		void* userData = broadPhase->GetUserData(proxyId);
+		b2FixtureProxy* proxy = (b2FixtureProxy*)userData;
+		b2Fixture* fixture = proxy->fixture;
+		int32 index = proxy->childIndex;
+		b2RayCastOutput output;
+		bool hit = fixture->RayCast(&output, input, index);
+
+		if (hit)
+		{
+			float32 fraction = output.fraction;
+			b2Vec2 point = (1.0f - fraction) * input.p1 + fraction * input.p2;
+			return callback->ReportFixture(rayIndex, fixture, point, output.normal, fraction);
+		}
+
+		return input.maxFraction;
+	}
+
+	const b2BroadPhase* broadPhase;
+	b2RayCastBatchCallback* callback;
+};
+
+void b2World::RayCastBatch(b2RayCastBatchCallback* callback, const b2Vec2* points1, const b2Vec2* points2, int32 count) const
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	b2RayCastInput* inputs = (b2RayCastInput*)b2Alloc(count * sizeof(b2RayCastInput));
+	for (int32 i = 0; i < count; ++i)
+	{
+		inputs[i].p1 = points1[i];
+		inputs[i].p2 = points2[i];
+		inputs[i].maxFraction = 1.0f;
+	}
+
+	b2WorldRayCastBatchWrapper wrapper;
+	wrapper.broadPhase = &m_contactManager.m_broadPhase;
+	wrapper.callback = callback;
+	m_contactManager.m_broadPhase.RayCastBatch(&wrapper, inputs, count);
+
+	b2Free(inputs);
+}
+
+void b2World::OptimizeBroadPhase()
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return;
+	}
+
+	m_contactManager.m_broadPhase.RebuildTree();
+}
+
 void b2World::DrawShape(b2Fixture* fixture, const b2Transform& xf, const b2Color& color)
 {
 	switch (fixture->GetType())
@@ -34,6 +34,9 @@ class b2Body;
 class b2Draw;
 class b2Fixture;
 class b2Joint;
+class b2Island;
+class b2WorkerPool;
+struct b2IslandRange;
 
 /// The world class manages all physics entities, dynamic simulation,
 /// and asynchronous queries. The world also contains efficient memory
@@ -121,6 +124,27 @@ public:
 	/// @param point2 the ray ending point
 	void RayCast(b2RayCastCallback* callback, const b2Vec2& point1, const b2Vec2& point2) const;
 
+	/// Query the world with many AABBs at once. This is much faster than calling
+	/// QueryAABB for each box when there are many. The order of the reports
+	/// between different queries is not defined.
+	/// @param callback a user implemented callback class.
+	/// @param aabbs the query boxes.
+	/// @param count the number of query boxes.
+	void QueryAABBBatch(b2QueryBatchCallback* callback, const b2AABB* aabbs, int32 count) const;
+
+	/// Ray-cast the world with many rays at once, e.g. line of sight checks for
+	/// a crowd. Each ray behaves like a separate RayCast.
+	/// @param callback a user implemented callback class.
+	/// @param points1 the ray starting points
+	/// @param points2 the ray ending points
+	/// @param count the number of rays
+	void RayCastBatch(b2RayCastBatchCallback* callback, const b2Vec2* points1, const b2Vec2* points2, int32 count) const;
+
+	/// Rebuild the broad-phase tree for faster queries. This is worth doing after
+	/// creating a large amount of static geometry, such as when a level is loaded.
+	/// @warning this should be called outside of a time step.
+	void OptimizeBroadPhase();
+
 	/// Get the world body list. With the returned body, use b2Body::GetNext to get
 	/// the next body in the world list. A NULL body indicates the end of the list.
 	/// @return the head of the world body list.
@@ -157,6 +181,14 @@ public:
 	void SetSubStepping(bool flag) { m_subStepping = flag; }
 	bool GetSubStepping() const { return m_subStepping; }
 
+	/// Solve islands and narrow-phase collision on this many extra threads. Zero, the
+	/// default, keeps everything on the thread calling Step. The simulation result does
+	/// not depend on the worker count. Listener callbacks are still made from the calling
+	/// thread in the same order, but PostSolve is reported after all islands are solved.
+	/// @warning this should be called outside of a time step.
+	void SetWorkerCount(int32 count);
+	int32 GetWorkerCount() const;
+
 	/// Get the number of broad-phase proxies.
 	int32 GetProxyCount() const;
 
@@ -225,6 +257,7 @@ private:
 	friend class b2Controller;
 
 	void Solve(const b2TimeStep& step);
+	void SolveIslands(const b2TimeStep& step, const b2Island& all, const b2IslandRange* ranges, int32 islandCount, const int32* staticSlots);
 	void SolveTOI(const b2TimeStep& step);
 
 	void DrawJoint(b2Joint* joint);
@@ -233,6 +266,10 @@ private:
 	b2BlockAllocator m_blockAllocator;
 	b2StackAllocator m_stackAllocator;
 
+	// Optional solver threads. Worker 0 is the calling thread and uses m_stackAllocator.
+	b2WorkerPool* m_workerPool;
+	b2StackAllocator** m_workerStacks;
+
 	int32 m_flags;
 
 	b2ContactManager m_contactManager;
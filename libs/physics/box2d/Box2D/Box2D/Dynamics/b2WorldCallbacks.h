@@ -152,4 +152,29 @@ public:
 									const b2Vec2& normal, float32 fraction) = 0;
 };
 
+/// Callback class for batched AABB queries.
+/// See b2World::QueryAABBBatch
+class b2QueryBatchCallback
+{
+public:
+	virtual ~b2QueryBatchCallback() {}
+
+	/// Called for each fixture found in the query AABB with index queryIndex.
+	/// @return false to terminate this query.
+	virtual bool ReportFixture(int32 queryIndex, b2Fixture* fixture) = 0;
+};
+
+/// Callback class for batched ray casts.
+/// See b2World::RayCastBatch
+class b2RayCastBatchCallback
+{
+public:
+	virtual ~b2RayCastBatchCallback() {}
+
+	/// Called for each fixture hit by the ray with index rayIndex. The return
+	/// value controls that ray only, as in b2RayCastCallback::ReportFixture.
+	virtual float32 ReportFixture(	int32 rayIndex, b2Fixture* fixture, const b2Vec2& point,
+									const b2Vec2& normal, float32 fraction) = 0;
+};
+
 #endif
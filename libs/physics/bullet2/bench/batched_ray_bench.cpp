@@ -0,0 +1,243 @@
+// Bullet batched query benchmark: a terrain btBvhTriangleMeshShape with boxes, spheres and compounds scattered over it.
+// Casts a grid of camera rays plus random rays with btCollisionWorld::rayTest and ClosestRayResultCallback one at a time,
+// then with rayTestBatch on one thread and on the task scheduler, and does the same for sphere sweeps with convexSweepTestBatch.
+// The batched closest hits have to match the one-at-a-time ones.
+//
+//   cmake -S .. -B build -DCMAKE_BUILD_TYPE=Release && cmake --build build
+//   c++ -O2 -pthread -I.. batched_ray_bench.cpp build/libbullet.a -o batched_ray_bench && ./batched_ray_bench [rays] [threads]
+//   (build the library and the benchmark with -mavx for 8 ray packets)
+
+#include "btBulletCollisionCommon.h"
+#include "btRayPacket.h"
+#include "btThreads.h"
+
+#include <chrono>
+#include <thread>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static double now()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static unsigned int randomState = 12345;
+
+static btScalar	randomRange(btScalar lo,btScalar hi)
+{
+	randomState = randomState*1664525u+1013904223u;
+	return lo+(hi-lo)*btScalar(randomState>>8)/btScalar(1<<24);
+}
+
+struct Scene
+{
+	btAlignedObjectArray<btScalar>	m_vertices;
+	btAlignedObjectArray<int>		m_indices;
+	btTriangleIndexVertexArray*		m_mesh;
+	btAlignedObjectArray<btCollisionShape*>	m_shapes;
+	btAlignedObjectArray<btCollisionObject*>	m_objects;
+	btDefaultCollisionConfiguration	m_configuration;
+	btCollisionDispatcher	m_dispatcher;
+	btDbvtBroadphase		m_broadphase;
+	btCollisionWorld		m_world;
+	btScalar				m_size;
+
+	Scene(int gridSize)
+		:m_dispatcher(&m_configuration),
+		m_world(&m_dispatcher,&m_broadphase,&m_configuration),
+		m_size(btScalar(gridSize-1))
+	{
+		for (int z=0;z<gridSize;z++)
+			for (int x=0;x<gridSize;x++)
+			{
+				m_vertices.push_back(btScalar(x));
+				m_vertices.push_back(btScalar(4.*sin(x*0.05)*cos(z*0.07)+0.5*sin(x*0.9+z*1.3)));
+				m_vertices.push_back(btScalar(z));
+			}
+		for (int z=0;z<gridSize-1;z++)
+			for (int x=0;x<gridSize-1;x++)
+			{
+				int i = z*gridSize+x;
+				m_indices.push_back(i); m_indices.push_back(i+gridSize); m_indices.push_back(i+1);
+				m_indices.push_back(i+1); m_indices.push_back(i+gridSize); m_indices.push_back(i+gridSize+1);
+			}
+		m_mesh = new btTriangleIndexVertexArray(m_indices.size()/3,&m_indices[0],3*sizeof(int),m_vertices.size()/3,&m_vertices[0],3*sizeof(btScalar));
+		btCollisionShape* terrain = new btBvhTriangleMeshShape(m_mesh,true);
+		m_shapes.push_back(terrain);
+		addObject(terrain,btVector3(0,0,0));
+
+		btCollisionShape* box = new btBoxShape(btVector3(1,btScalar(0.5),btScalar(1.5)));
+		btCollisionShape* sphere = new btSphereShape(btScalar(1.2));
+		btCompoundShape* compound = new btCompoundShape();
+		compound->addChildShape(btTransform(btQuaternion::getIdentity(),btVector3(-1,0,0)),box);
+		compound->addChildShape(btTransform(btQuaternion(btVector3(0,1,0),btScalar(0.7)),btVector3(1,1,0)),sphere);
+		btCollisionShape* shapes[3] = {box,sphere,compound};
+		for (int k=0;k<3;k++)
+			m_shapes.push_back(shapes[k]);
+		for (int i=0;i<600;i++)
+		{
+			btVector3 position(randomRange(2,m_size-2),randomRange(5,12),randomRange(2,m_size-2));
+			addObject(shapes[i%3],position,btQuaternion(btVector3(randomRange(-1,1),1,randomRange(-1,1)).normalized(),randomRange(0,3)));
+		}
+		m_world.updateAabbs();
+	}
+
+	void	addObject(btCollisionShape* shape,const btVector3& position,const btQuaternion& rotation=btQuaternion::getIdentity())
+	{
+		btCollisionObject* object = new btCollisionObject();
+		object->setCollisionShape(shape);
+		object->setWorldTransform(btTransform(rotation,position));
+		m_world.addCollisionObject(object);
+		m_objects.push_back(object);
+	}
+
+	~Scene()
+	{
+		for (int i=0;i<m_objects.size();i++)
+		{
+			m_world.removeCollisionObject(m_objects[i]);
+			delete m_objects[i];
+		}
+		for (int i=0;i<m_shapes.size();i++)
+			delete m_shapes[i];
+		delete m_mesh;
+	}
+};
+
+static bool	sameHit(const btCollisionWorld::BatchedQueryResult& result,btCollisionObject* object,btScalar fraction)
+{
+	//two objects may be hit at the same fraction, the one reported then depends on the traversal order
+	btScalar tolerance = btScalar(1e-4);
+	if (result.m_collisionObject == object)
+		return btFabs(result.m_hitFraction-fraction) <= tolerance;
+	return object && result.m_collisionObject && btFabs(result.m_hitFraction-fraction) <= tolerance;
+}
+
+int main(int argc,char** argv)
+{
+	int numRays = argc > 1 ? atoi(argv[1]) : 200000;
+	int numThreads = argc > 2 ? atoi(argv[2]) : int(std::thread::hardware_concurrency());
+	numThreads = btMax(btMin(numThreads,BT_MAX_THREAD_COUNT),2);
+
+	Scene scene(400);
+	printf("%d triangles, %d objects, %d ray packets\n",scene.m_indices.size()/3,scene.m_objects.size(),BT_RAY_PACKET_SIZE);
+	bool ok = true;
+
+	//half a camera grid looking down at the terrain, half random rays
+	btAlignedObjectArray<btVector3> rayFrom;
+	btAlignedObjectArray<btVector3> rayTo;
+	int gridSize = int(sqrt(double(numRays/2)));
+	btVector3 eye(scene.m_size*btScalar(0.5),60,-20);
+	for (int y=0;y<gridSize;y++)
+		for (int x=0;x<gridSize;x++)
+		{
+			btVector3 target(scene.m_size*btScalar(x)/btScalar(gridSize),0,scene.m_size*btScalar(y)/btScalar(gridSize));
+			rayFrom.push_back(eye);
+			rayTo.push_back(eye+(target-eye)*btScalar(1.5));
+		}
+	while (rayFrom.size() < numRays)
+	{
+		btVector3 from(randomRange(0,scene.m_size),randomRange(0,30),randomRange(0,scene.m_size));
+		btVector3 direction(randomRange(-1,1),randomRange(-1,btScalar(0.2)),randomRange(-1,1));
+		rayFrom.push_back(from);
+		rayTo.push_back(from+direction*btScalar(80.));
+	}
+
+	btAlignedObjectArray<btCollisionObject*> referenceObjects;
+	btAlignedObjectArray<btScalar> referenceFractions;
+	referenceObjects.resize(numRays);
+	referenceFractions.resize(numRays);
+	int numHits = 0;
+	{
+		double t0 = now();
+		for (int i=0;i<numRays;i++)
+		{
+			btCollisionWorld::ClosestRayResultCallback callback(rayFrom[i],rayTo[i]);
+			scene.m_world.rayTest(rayFrom[i],rayTo[i],callback);
+			referenceObjects[i] = callback.m_collisionObject;
+			referenceFractions[i] = callback.m_closestHitFraction;
+			numHits += callback.hasHit() ? 1 : 0;
+		}
+		double t1 = now();
+		printf("%-32s %8.1f ms  (%d hits)\n","rayTest, one at a time",(t1-t0)*1000.0,numHits);
+	}
+
+	btAlignedObjectArray<btCollisionWorld::BatchedQueryResult> results;
+	results.resize(numRays);
+	btTaskScheduler scheduler(numThreads);
+	for (int pass=0;pass<2;pass++)
+	{
+		btSetTaskScheduler(pass ? &scheduler : 0);
+		double t0 = now();
+		scene.m_world.rayTestBatch(&rayFrom[0],&rayTo[0],numRays,&results[0]);
+		double t1 = now();
+		char name[64];
+		sprintf(name,"rayTestBatch, %d thread%s",pass ? numThreads : 1,pass ? "s" : "");
+		printf("%-32s %8.1f ms\n",name,(t1-t0)*1000.0);
+		int mismatches = 0;
+		for (int i=0;i<numRays;i++)
+		{
+			if (!sameHit(results[i],referenceObjects[i],referenceFractions[i]))
+				mismatches++;
+		}
+		if (mismatches)
+		{
+			printf("%d of %d batched rays differ from rayTest\n",mismatches,numRays);
+			ok = false;
+		}
+	}
+
+	//sphere sweeps over the terrain, fewer of them: every sweep is a convex cast per object
+	int numSweeps = numRays/20;
+	btSphereShape castShape(btScalar(0.4));
+	btAlignedObjectArray<btTransform> sweepFrom;
+	btAlignedObjectArray<btTransform> sweepTo;
+	for (int i=0;i<numSweeps;i++)
+	{
+		sweepFrom.push_back(btTransform(btQuaternion::getIdentity(),rayFrom[i*20+7]));
+		sweepTo.push_back(btTransform(btQuaternion::getIdentity(),rayFrom[i*20+7]+(rayTo[i*20+7]-rayFrom[i*20+7])*btScalar(0.5)));
+	}
+	referenceObjects.resize(numSweeps);
+	referenceFractions.resize(numSweeps);
+	numHits = 0;
+	{
+		btSetTaskScheduler(0);
+		double t0 = now();
+		for (int i=0;i<numSweeps;i++)
+		{
+			btCollisionWorld::ClosestConvexResultCallback callback(sweepFrom[i].getOrigin(),sweepTo[i].getOrigin());
+			scene.m_world.convexSweepTest(&castShape,sweepFrom[i],sweepTo[i],callback);
+			referenceObjects[i] = callback.m_hitCollisionObject;
+			referenceFractions[i] = callback.m_closestHitFraction;
+			numHits += callback.hasHit() ? 1 : 0;
+		}
+		double t1 = now();
+		printf("%-32s %8.1f ms  (%d of %d hit)\n","convexSweepTest, one at a time",(t1-t0)*1000.0,numHits,numSweeps);
+	}
+	for (int pass=0;pass<2;pass++)
+	{
+		btSetTaskScheduler(pass ? &scheduler : 0);
+		double t0 = now();
+		scene.m_world.convexSweepTestBatch(&castShape,&sweepFrom[0],&sweepTo[0],numSweeps,&results[0]);
+		double t1 = now();
+		char name[64];
+		sprintf(name,"convexSweepTestBatch, %d thread%s",pass ? numThreads : 1,pass ? "s" : "");
+		printf("%-32s %8.1f ms\n",name,(t1-t0)*1000.0);
+		int mismatches = 0;
+		for (int i=0;i<numSweeps;i++)
+		{
+			if (!sameHit(results[i],referenceObjects[i],referenceFractions[i]))
+				mismatches++;
+		}
+		if (mismatches)
+		{
+			printf("%d of %d batched sweeps differ from convexSweepTest\n",mismatches,numSweeps);
+			ok = false;
+		}
+	}
+	btSetTaskScheduler(0);
+
+	printf(ok ? "ok\n" : "FAILED\n");
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,184 @@
+// Bullet BVH cache benchmark: a terrain of 2M triangles (by default) as btBvhTriangleMeshShape. Times building the quantized
+// tree on one thread and on the task scheduler, then loading it through a cold and a warm btBvhCache.
+// Every tree has to serialize to exactly the same bytes, and changing one vertex has to miss the cache.
+//
+//   cmake -S .. -B build -DCMAKE_BUILD_TYPE=Release && cmake --build build
+//   c++ -O2 -pthread -I.. bvh_cache_bench.cpp build/libbullet.a -o bvh_cache_bench && ./bvh_cache_bench [triangles] [threads]
+
+#include "btBulletCollisionCommon.h"
+#include "btBvhCache.h"
+#include "btThreads.h"
+
+#include <chrono>
+#include <thread>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <unistd.h>
+
+static double now()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct Terrain
+{
+	btAlignedObjectArray<btScalar>	m_vertices;
+	btAlignedObjectArray<int>		m_indices;
+	btTriangleIndexVertexArray*		m_mesh;
+
+	Terrain(int numTriangles)
+	{
+		int size = int(sqrt(double(numTriangles/2)))+1;
+		for (int z=0;z<size;z++)
+			for (int x=0;x<size;x++)
+			{
+				m_vertices.push_back(btScalar(x));
+				m_vertices.push_back(btScalar(4.*sin(x*0.05)*cos(z*0.07)+0.5*sin(x*0.9+z*1.3)));
+				m_vertices.push_back(btScalar(z));
+			}
+		for (int z=0;z<size-1;z++)
+			for (int x=0;x<size-1;x++)
+			{
+				int i = z*size+x;
+				m_indices.push_back(i); m_indices.push_back(i+size); m_indices.push_back(i+1);
+				m_indices.push_back(i+1); m_indices.push_back(i+size); m_indices.push_back(i+size+1);
+			}
+		m_mesh = new btTriangleIndexVertexArray(m_indices.size()/3,&m_indices[0],3*sizeof(int),m_vertices.size()/3,&m_vertices[0],3*sizeof(btScalar));
+	}
+
+	~Terrain()
+	{
+		delete m_mesh;
+	}
+};
+
+static void	serializeBvh(btOptimizedBvh* bvh,btAlignedObjectArray<char>& bytes)
+{
+	bytes.resize(bvh->calculateSerializeBufferSize());
+	memset(&bytes[0],0,bytes.size());
+	//mapped trees are plain btQuantizedBvh objects, see btOptimizedBvh::deSerializeInPlace
+	static_cast<btQuantizedBvh*>(bvh)->serialize(&bytes[0],bytes.size(),false);
+}
+
+static bool	sameBytes(const btAlignedObjectArray<char>& a,const btAlignedObjectArray<char>& b)
+{
+	return a.size() == b.size() && memcmp(&a[0],&b[0],a.size()) == 0;
+}
+
+int main(int argc,char** argv)
+{
+	int numTriangles = argc > 1 ? atoi(argv[1]) : 2000000;
+	int numThreads = argc > 2 ? atoi(argv[2]) : int(std::thread::hardware_concurrency());
+	numThreads = btMax(btMin(numThreads,BT_MAX_THREAD_COUNT),2);
+
+	Terrain terrain(numTriangles);
+	printf("%d triangles\n",terrain.m_indices.size()/3);
+	bool ok = true;
+
+	//reference: built on the calling thread like btBvhTriangleMeshShape always did
+	btAlignedObjectArray<char> reference;
+	{
+		double t0 = now();
+		btBvhTriangleMeshShape shape(terrain.m_mesh,true);
+		double t1 = now();
+		serializeBvh(shape.getOptimizedBvh(),reference);
+		printf("%-28s %8.1f ms\n","build, 1 thread",(t1-t0)*1000.0);
+	}
+
+	btTaskScheduler scheduler(numThreads);
+	btSetTaskScheduler(&scheduler);
+	{
+		double t0 = now();
+		btBvhTriangleMeshShape shape(terrain.m_mesh,true);
+		double t1 = now();
+		btAlignedObjectArray<char> bytes;
+		serializeBvh(shape.getOptimizedBvh(),bytes);
+		char name[64];
+		sprintf(name,"build, %d threads",numThreads);
+		printf("%-28s %8.1f ms\n",name,(t1-t0)*1000.0);
+		if (!sameBytes(bytes,reference))
+		{
+			printf("parallel build differs from the serial one\n");
+			ok = false;
+		}
+	}
+
+	char directory[] = "/tmp/bvh_cache_benchXXXXXX";
+	if (!mkdtemp(directory))
+	{
+		printf("can't create a cache directory\n");
+		return EXIT_FAILURE;
+	}
+
+	{
+		double t0 = now();
+		unsigned long long hash = btBvhCache::calculateMeshHash(terrain.m_mesh);
+		double t1 = now();
+		printf("%-28s %8.1f ms  (%016llx)\n","hash mesh",(t1-t0)*1000.0,hash);
+	}
+
+	for (int pass=0;pass<2;pass++)
+	{
+		btBvhCache cache(directory);
+		double t0 = now();
+		btBvhTriangleMeshShape shape(terrain.m_mesh,true,false);
+		bool hit = cache.setupShape(&shape);
+		double t1 = now();
+		btAlignedObjectArray<char> bytes;
+		serializeBvh(shape.getOptimizedBvh(),bytes);
+		printf("%-28s %8.1f ms\n",pass ? "warm cache, mapped" : "cold cache, built and saved",(t1-t0)*1000.0);
+		if (hit != (pass == 1) || !sameBytes(bytes,reference))
+		{
+			printf("cache pass %d: unexpected %s or different tree\n",pass,hit ? "hit" : "miss");
+			ok = false;
+		}
+
+		//the mapped tree has to be usable, a ray straight down has to hit the terrain
+		btVector3 rayFrom(btScalar(10.3),100,btScalar(20.7));
+		btVector3 rayTo(btScalar(10.3),-100,btScalar(20.7));
+		btCollisionWorld::ClosestRayResultCallback callback(rayFrom,rayTo);
+		btCollisionObject object;
+		object.setCollisionShape(&shape);
+		btCollisionWorld::rayTestSingle(btTransform(btQuaternion::getIdentity(),rayFrom),btTransform(btQuaternion::getIdentity(),rayTo),&object,&shape,object.getWorldTransform(),callback);
+		if (!callback.hasHit())
+		{
+			printf("cache pass %d: ray missed the terrain\n",pass);
+			ok = false;
+		}
+	}
+
+	{
+		//a changed mesh must not pick up the old tree
+		terrain.m_vertices[1] += btScalar(0.25);
+		btBvhCache cache(directory);
+		btBvhTriangleMeshShape shape(terrain.m_mesh,true,false);
+		if (cache.setupShape(&shape))
+		{
+			printf("changed mesh loaded a stale tree\n");
+			ok = false;
+		}
+	}
+
+	btSetTaskScheduler(0);
+
+	DIR* dir = opendir(directory);
+	if (dir)
+	{
+		while (struct dirent* entry = readdir(dir))
+		{
+			if (entry->d_name[0] == '.')
+				continue;
+			char fileName[1024];
+			snprintf(fileName,sizeof(fileName),"%s/%s",directory,entry->d_name);
+			unlink(fileName);
+		}
+		closedir(dir);
+	}
+	rmdir(directory);
+
+	printf(ok ? "ok\n" : "FAILED\n");
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
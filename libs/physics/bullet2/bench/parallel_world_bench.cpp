@@ -0,0 +1,149 @@
+// Bullet threaded world benchmark: 100 towers of 20 stacked boxes (2000 active bodies) stepped with the serial
+// btDiscreteDynamicsWorld, then with btDiscreteDynamicsWorldMt + btCollisionDispatcherMt for 1..N threads.
+// Every threaded run has to end in exactly the same state as the serial one.
+//
+//   cmake -S .. -B build -DCMAKE_BUILD_TYPE=Release && cmake --build build
+//   c++ -O2 -pthread -I.. parallel_world_bench.cpp build/libbullet.a -o parallel_world_bench && ./parallel_world_bench [max_threads] [steps]
+
+#include "btBulletDynamicsCommon.h"
+#include "btCollisionDispatcherMt.h"
+#include "btDiscreteDynamicsWorldMt.h"
+#include "btThreads.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static double now()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct Scene
+{
+	btDefaultCollisionConfiguration*	m_config;
+	btCollisionDispatcher*				m_dispatcher;
+	btDbvtBroadphase*					m_broadphase;
+	btSequentialImpulseConstraintSolver*	m_solver;
+	btDiscreteDynamicsWorld*			m_world;
+	btBoxShape*							m_groundShape;
+	btBoxShape*							m_boxShape;
+	btAlignedObjectArray<btRigidBody*>	m_bodies;
+
+	Scene(bool threaded)
+	{
+		m_config = new btDefaultCollisionConfiguration();
+		m_dispatcher = threaded ? new btCollisionDispatcherMt(m_config) : new btCollisionDispatcher(m_config);
+		m_broadphase = new btDbvtBroadphase();
+		m_solver = new btSequentialImpulseConstraintSolver();
+		if (threaded)
+			m_world = new btDiscreteDynamicsWorldMt(m_dispatcher,m_broadphase,m_solver,m_config);
+		else
+			m_world = new btDiscreteDynamicsWorld(m_dispatcher,m_broadphase,m_solver,m_config);
+		m_world->setGravity(btVector3(0,-10,0));
+
+		m_groundShape = new btBoxShape(btVector3(50,1,50));
+		m_boxShape = new btBoxShape(btVector3(0.5,0.5,0.5));
+		addBody(m_groundShape,0,btVector3(0,-1,0));
+
+		for (int x=0;x<10;x++)
+			for (int z=0;z<10;z++)
+				for (int y=0;y<20;y++)
+				{
+					//slightly offset boxes so the towers sway and the contacts keep changing
+					btVector3 pos(btScalar(x*3-15)+btScalar(0.02)*(y&1),btScalar(0.5)+y,btScalar(z*3-15)+btScalar(0.01)*(y%3));
+					btRigidBody* body = addBody(m_boxShape,1,pos);
+					body->setActivationState(DISABLE_DEACTIVATION);
+				}
+	}
+
+	btRigidBody* addBody(btCollisionShape* shape,btScalar mass,const btVector3& pos)
+	{
+		btVector3 inertia(0,0,0);
+		if (mass)
+			shape->calculateLocalInertia(mass,inertia);
+		btRigidBody::btRigidBodyConstructionInfo info(mass,0,shape,inertia);
+		info.m_startWorldTransform.setOrigin(pos);
+		btRigidBody* body = new btRigidBody(info);
+		m_world->addRigidBody(body);
+		m_bodies.push_back(body);
+		return body;
+	}
+
+	~Scene()
+	{
+		for (int i=0;i<m_bodies.size();i++)
+		{
+			m_world->removeRigidBody(m_bodies[i]);
+			delete m_bodies[i];
+		}
+		delete m_world;
+		delete m_solver;
+		delete m_broadphase;
+		delete m_dispatcher;
+		delete m_config;
+		delete m_boxShape;
+		delete m_groundShape;
+	}
+
+	unsigned int hash() const
+	{
+		unsigned int h = 2166136261u;
+		for (int i=0;i<m_bodies.size();i++)
+		{
+			const btTransform& t = m_bodies[i]->getWorldTransform();
+			btScalar v[12];
+			for (int r=0;r<3;r++)
+			{
+				v[r*3+0] = t.getBasis()[r].x();
+				v[r*3+1] = t.getBasis()[r].y();
+				v[r*3+2] = t.getBasis()[r].z();
+			}
+			v[9] = t.getOrigin().x();
+			v[10] = t.getOrigin().y();
+			v[11] = t.getOrigin().z();
+			const unsigned char* p = (const unsigned char*)v;
+			for (size_t j=0;j<sizeof(v);j++)
+				h = (h^p[j])*16777619u;
+		}
+		return h;
+	}
+};
+
+static double run(bool threaded,int steps,unsigned int* hash)
+{
+	Scene scene(threaded);
+	double t0 = now();
+	for (int i=0;i<steps;i++)
+		scene.m_world->stepSimulation(btScalar(1.)/btScalar(60.),0);
+	double t1 = now();
+	*hash = scene.hash();
+	return (t1-t0)*1000.0/steps;
+}
+
+int main(int argc,char** argv)
+{
+	int maxThreads = argc > 1 ? atoi(argv[1]) : 8;
+	int steps = argc > 2 ? atoi(argv[2]) : 300;
+	int ok = 1;
+
+	unsigned int reference;
+	double serial = run(false,steps,&reference);
+	printf("%-22s %8.2f ms/step\n","serial world",serial);
+
+	for (int threads=1;threads<=maxThreads;threads*=2)
+	{
+		btTaskScheduler scheduler(threads);
+		btSetTaskScheduler(&scheduler);
+		unsigned int hash;
+		double ms = run(true,steps,&hash);
+		btSetTaskScheduler(0);
+
+		char name[32];
+		sprintf(name,"threaded world x%d",threads);
+		printf("%-22s %8.2f ms/step  speedup %.2f%s\n",name,ms,serial/ms,hash == reference ? "" : "  STATE DIFFERS");
+		ok &= hash == reference;
+	}
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
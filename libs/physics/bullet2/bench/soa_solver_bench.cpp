@@ -0,0 +1,162 @@
+// Bullet SoA solver benchmark: 25 box pyramids (1375 bodies) settling on the ground, stepped once with the
+// one-row-at-a-time btSequentialImpulseConstraintSolver and once with SOLVER_SIMD_SOA (BT_SOA_WIDTH rows per kernel).
+// Reports the time spent in the constraint solver and how far the final body positions drift apart. The scene is chaotic,
+// so a third run with SOLVER_RANDMIZE_ORDER shows how far a mere change of the row order moves the bodies.
+//
+//   cmake -S .. -B build -DCMAKE_BUILD_TYPE=Release && cmake --build build
+//   c++ -O2 -I.. soa_solver_bench.cpp build/libbullet.a -pthread -o soa_solver_bench && ./soa_solver_bench [steps]
+//   (build the library and the benchmark with -mavx for the 8-wide kernel)
+
+#include "btBulletDynamicsCommon.h"
+#include "btBatchedConstraints.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+static double now()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+class TimedSolver : public btSequentialImpulseConstraintSolver
+{
+public:
+	double	m_seconds;
+
+	TimedSolver()
+		:m_seconds(0)
+	{
+	}
+
+	virtual btScalar solveGroup(btCollisionObject** bodies,int numBodies,btPersistentManifold** manifold,int numManifolds,btTypedConstraint** constraints,int numConstraints,const btContactSolverInfo& info,btIDebugDraw* debugDrawer,btStackAlloc* stackAlloc,btDispatcher* dispatcher)
+	{
+		double t0 = now();
+		btScalar result = btSequentialImpulseConstraintSolver::solveGroup(bodies,numBodies,manifold,numManifolds,constraints,numConstraints,info,debugDrawer,stackAlloc,dispatcher);
+		m_seconds += now()-t0;
+		return result;
+	}
+};
+
+struct Scene
+{
+	btDefaultCollisionConfiguration*	m_config;
+	btCollisionDispatcher*				m_dispatcher;
+	btDbvtBroadphase*					m_broadphase;
+	TimedSolver*						m_solver;
+	btDiscreteDynamicsWorld*			m_world;
+	btBoxShape*							m_groundShape;
+	btBoxShape*							m_boxShape;
+	btAlignedObjectArray<btRigidBody*>	m_bodies;
+
+	Scene(int solverMode)
+	{
+		m_config = new btDefaultCollisionConfiguration();
+		m_dispatcher = new btCollisionDispatcher(m_config);
+		m_broadphase = new btDbvtBroadphase();
+		m_solver = new TimedSolver();
+		m_world = new btDiscreteDynamicsWorld(m_dispatcher,m_broadphase,m_solver,m_config);
+		m_world->setGravity(btVector3(0,-10,0));
+		m_world->getSolverInfo().m_solverMode = solverMode;
+
+		m_groundShape = new btBoxShape(btVector3(60,1,60));
+		m_boxShape = new btBoxShape(btVector3(0.5,0.5,0.5));
+		addBody(m_groundShape,0,btVector3(0,-1,0));
+
+		for (int px=0;px<5;px++)
+			for (int pz=0;pz<5;pz++)
+				for (int level=0;level<10;level++)
+					for (int i=0;i<10-level;i++)
+					{
+						btVector3 pos(btScalar(px*14-28)+btScalar(0.5)*level+i*btScalar(1.02),btScalar(0.5)+level,btScalar(pz*14-28));
+						btRigidBody* body = addBody(m_boxShape,1,pos);
+						body->setActivationState(DISABLE_DEACTIVATION);
+					}
+	}
+
+	btRigidBody* addBody(btCollisionShape* shape,btScalar mass,const btVector3& pos)
+	{
+		btVector3 inertia(0,0,0);
+		if (mass)
+			shape->calculateLocalInertia(mass,inertia);
+		btRigidBody::btRigidBodyConstructionInfo info(mass,0,shape,inertia);
+		info.m_startWorldTransform.setOrigin(pos);
+		btRigidBody* body = new btRigidBody(info);
+		m_world->addRigidBody(body);
+		m_bodies.push_back(body);
+		return body;
+	}
+
+	~Scene()
+	{
+		for (int i=0;i<m_bodies.size();i++)
+		{
+			m_world->removeRigidBody(m_bodies[i]);
+			delete m_bodies[i];
+		}
+		delete m_world;
+		delete m_solver;
+		delete m_broadphase;
+		delete m_dispatcher;
+		delete m_config;
+		delete m_boxShape;
+		delete m_groundShape;
+	}
+};
+
+static void	compare(const Scene& reference,const Scene& scene,btScalar& meanDrift,btScalar& maxDrift,btScalar& meanHeight)
+{
+	meanDrift = 0;
+	maxDrift = 0;
+	meanHeight = 0;
+	int numBodies = reference.m_bodies.size()-1;
+	for (int i=1;i<=numBodies;i++)
+	{
+		const btVector3& a = reference.m_bodies[i]->getWorldTransform().getOrigin();
+		const btVector3& b = scene.m_bodies[i]->getWorldTransform().getOrigin();
+		meanDrift += a.distance(b);
+		maxDrift = btMax(maxDrift,a.distance(b));
+		meanHeight += b.getY();
+	}
+	meanDrift /= numBodies;
+	meanHeight /= numBodies;
+}
+
+int main(int argc,char** argv)
+{
+	int steps = argc > 1 ? atoi(argv[1]) : 300;
+	int baseMode = SOLVER_USE_WARMSTARTING | SOLVER_SIMD;
+
+	Scene scalar(baseMode);
+	Scene soa(baseMode | SOLVER_SIMD_SOA);
+	Scene randomized(baseMode | SOLVER_RANDMIZE_ORDER);
+
+	double scalarStep = 0,soaStep = 0;
+	for (int i=0;i<steps;i++)
+	{
+		double t0 = now();
+		scalar.m_world->stepSimulation(btScalar(1.)/btScalar(60.),0);
+		double t1 = now();
+		soa.m_world->stepSimulation(btScalar(1.)/btScalar(60.),0);
+		double t2 = now();
+		randomized.m_world->stepSimulation(btScalar(1.)/btScalar(60.),0);
+		scalarStep += t1-t0;
+		soaStep += t2-t1;
+	}
+
+	btScalar soaMean,soaMax,soaHeight,randomMean,randomMax,randomHeight,scalarMean,scalarMax,scalarHeight;
+	compare(scalar,soa,soaMean,soaMax,soaHeight);
+	compare(scalar,randomized,randomMean,randomMax,randomHeight);
+	compare(scalar,scalar,scalarMean,scalarMax,scalarHeight);
+
+	printf("%-26s %8.2f ms/step  solver %8.2f ms/step\n","one row at a time",scalarStep*1000.0/steps,scalar.m_solver->m_seconds*1000.0/steps);
+	char name[32];
+	sprintf(name,"SOLVER_SIMD_SOA, width %d",BT_SOA_WIDTH);
+	printf("%-26s %8.2f ms/step  solver %8.2f ms/step  speedup %.2f\n",name,soaStep*1000.0/steps,soa.m_solver->m_seconds*1000.0/steps,scalar.m_solver->m_seconds/soa.m_solver->m_seconds);
+	printf("position difference to one row at a time: SOLVER_SIMD_SOA mean %.4f max %.4f, SOLVER_RANDMIZE_ORDER mean %.4f max %.4f\n",soaMean,soaMax,randomMean,randomMax);
+	printf("mean body height: one row at a time %.4f, SOLVER_SIMD_SOA %.4f\n",scalarHeight,soaHeight);
+
+	//only the row order differs, the batched solver has to stay as close as a shuffled one and settle the pyramids as high
+	bool ok = soaMean <= btScalar(1.5)*randomMean + btScalar(0.01) && btFabs(soaHeight-scalarHeight) < btScalar(0.05);
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,460 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2012 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include "btBatchedConstraints.h"
+#include "btRigidBody.h"
+
+#define BT_SOA_MAX_COLORS 32
+
+#if BT_SOA_WIDTH == 8
+#include <immintrin.h>
+
+typedef __m256	btSoaReal;
+
+static SIMD_FORCE_INLINE btSoaReal	btSoaLoad(const btScalar* p)				{ return _mm256_loadu_ps(p); }
+static SIMD_FORCE_INLINE void		btSoaStore(btScalar* p,btSoaReal a)			{ _mm256_storeu_ps(p,a); }
+static SIMD_FORCE_INLINE btSoaReal	btSoaAdd(btSoaReal a,btSoaReal b)			{ return _mm256_add_ps(a,b); }
+static SIMD_FORCE_INLINE btSoaReal	btSoaSub(btSoaReal a,btSoaReal b)			{ return _mm256_sub_ps(a,b); }
+static SIMD_FORCE_INLINE btSoaReal	btSoaMul(btSoaReal a,btSoaReal b)			{ return _mm256_mul_ps(a,b); }
+static SIMD_FORCE_INLINE btSoaReal	btSoaMax(btSoaReal a,btSoaReal b)			{ return _mm256_max_ps(a,b); }
+static SIMD_FORCE_INLINE btSoaReal	btSoaMin(btSoaReal a,btSoaReal b)			{ return _mm256_min_ps(a,b); }
+static SIMD_FORCE_INLINE btSoaReal	btSoaZero()									{ return _mm256_setzero_ps(); }
+///t > 0 ? a : b per lane
+static SIMD_FORCE_INLINE btSoaReal	btSoaSelectPositive(btSoaReal t,btSoaReal a,btSoaReal b)	{ return _mm256_blendv_ps(b,a,_mm256_cmp_ps(t,_mm256_setzero_ps(),_CMP_GT_OQ)); }
+
+///loads x,y,z,w of 8 vectors into 4 registers, two 4x4 transposes
+static SIMD_FORCE_INLINE void	btSoaGather(btVector3* const* v,btSoaReal out[4])
+{
+	__m128 a0 = _mm_loadu_ps(*v[0]),a1 = _mm_loadu_ps(*v[1]),a2 = _mm_loadu_ps(*v[2]),a3 = _mm_loadu_ps(*v[3]);
+	__m128 b0 = _mm_loadu_ps(*v[4]),b1 = _mm_loadu_ps(*v[5]),b2 = _mm_loadu_ps(*v[6]),b3 = _mm_loadu_ps(*v[7]);
+	_MM_TRANSPOSE4_PS(a0,a1,a2,a3);
+	_MM_TRANSPOSE4_PS(b0,b1,b2,b3);
+	out[0] = _mm256_insertf128_ps(_mm256_castps128_ps256(a0),b0,1);
+	out[1] = _mm256_insertf128_ps(_mm256_castps128_ps256(a1),b1,1);
+	out[2] = _mm256_insertf128_ps(_mm256_castps128_ps256(a2),b2,1);
+	out[3] = _mm256_insertf128_ps(_mm256_castps128_ps256(a3),b3,1);
+}
+
+static SIMD_FORCE_INLINE void	btSoaScatter(btVector3* const* v,const btSoaReal in[4],int writeMask)
+{
+	__m128 a0 = _mm256_castps256_ps128(in[0]),a1 = _mm256_castps256_ps128(in[1]),a2 = _mm256_castps256_ps128(in[2]),a3 = _mm256_castps256_ps128(in[3]);
+	__m128 b0 = _mm256_extractf128_ps(in[0],1),b1 = _mm256_extractf128_ps(in[1],1),b2 = _mm256_extractf128_ps(in[2],1),b3 = _mm256_extractf128_ps(in[3],1);
+	_MM_TRANSPOSE4_PS(a0,a1,a2,a3);
+	_MM_TRANSPOSE4_PS(b0,b1,b2,b3);
+	if (writeMask & 1) _mm_storeu_ps(*v[0],a0);
+	if (writeMask & 2) _mm_storeu_ps(*v[1],a1);
+	if (writeMask & 4) _mm_storeu_ps(*v[2],a2);
+	if (writeMask & 8) _mm_storeu_ps(*v[3],a3);
+	if (writeMask & 16) _mm_storeu_ps(*v[4],b0);
+	if (writeMask & 32) _mm_storeu_ps(*v[5],b1);
+	if (writeMask & 64) _mm_storeu_ps(*v[6],b2);
+	if (writeMask & 128) _mm_storeu_ps(*v[7],b3);
+}
+
+#elif !defined(BT_USE_DOUBLE_PRECISION) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#include <xmmintrin.h>
+
+typedef __m128	btSoaReal;
+
+static SIMD_FORCE_INLINE btSoaReal	btSoaLoad(const btScalar* p)				{ return _mm_loadu_ps(p); }
+static SIMD_FORCE_INLINE void		btSoaStore(btScalar* p,btSoaReal a)			{ _mm_storeu_ps(p,a); }
+static SIMD_FORCE_INLINE btSoaReal	btSoaAdd(btSoaReal a,btSoaReal b)			{ return _mm_add_ps(a,b); }
+static SIMD_FORCE_INLINE btSoaReal	btSoaSub(btSoaReal a,btSoaReal b)			{ return _mm_sub_ps(a,b); }
+static SIMD_FORCE_INLINE btSoaReal	btSoaMul(btSoaReal a,btSoaReal b)			{ return _mm_mul_ps(a,b); }
+static SIMD_FORCE_INLINE btSoaReal	btSoaMax(btSoaReal a,btSoaReal b)			{ return _mm_max_ps(a,b); }
+static SIMD_FORCE_INLINE btSoaReal	btSoaMin(btSoaReal a,btSoaReal b)			{ return _mm_min_ps(a,b); }
+static SIMD_FORCE_INLINE btSoaReal	btSoaZero()									{ return _mm_setzero_ps(); }
+///t > 0 ? a : b per lane
+static SIMD_FORCE_INLINE btSoaReal	btSoaSelectPositive(btSoaReal t,btSoaReal a,btSoaReal b)
+{
+	__m128 mask = _mm_cmpgt_ps(t,_mm_setzero_ps());
+	return _mm_or_ps(_mm_and_ps(mask,a),_mm_andnot_ps(mask,b));
+}
+
+///loads x,y,z,w of 4 vectors into 4 registers
+static SIMD_FORCE_INLINE void	btSoaGather(btVector3* const* v,btSoaReal out[4])
+{
+	out[0] = _mm_loadu_ps(*v[0]);
+	out[1] = _mm_loadu_ps(*v[1]);
+	out[2] = _mm_loadu_ps(*v[2]);
+	out[3] = _mm_loadu_ps(*v[3]);
+	_MM_TRANSPOSE4_PS(out[0],out[1],out[2],out[3]);
+}
+
+static SIMD_FORCE_INLINE void	btSoaScatter(btVector3* const* v,const btSoaReal in[4],int writeMask)
+{
+	__m128 a0 = in[0],a1 = in[1],a2 = in[2],a3 = in[3];
+	_MM_TRANSPOSE4_PS(a0,a1,a2,a3);
+	if (writeMask & 1) _mm_storeu_ps(*v[0],a0);
+	if (writeMask & 2) _mm_storeu_ps(*v[1],a1);
+	if (writeMask & 4) _mm_storeu_ps(*v[2],a2);
+	if (writeMask & 8) _mm_storeu_ps(*v[3],a3);
+}
+
+#else
+//portable fallback, simple enough for the compiler to vectorize
+
+struct btSoaReal
+{
+	btScalar	m[BT_SOA_WIDTH];
+};
+
+static SIMD_FORCE_INLINE btSoaReal	btSoaLoad(const btScalar* p)				{ btSoaReal r; for (int l=0;l<BT_SOA_WIDTH;l++) r.m[l] = p[l]; return r; }
+static SIMD_FORCE_INLINE void		btSoaStore(btScalar* p,btSoaReal a)			{ for (int l=0;l<BT_SOA_WIDTH;l++) p[l] = a.m[l]; }
+static SIMD_FORCE_INLINE btSoaReal	btSoaAdd(btSoaReal a,btSoaReal b)			{ for (int l=0;l<BT_SOA_WIDTH;l++) a.m[l] += b.m[l]; return a; }
+static SIMD_FORCE_INLINE btSoaReal	btSoaSub(btSoaReal a,btSoaReal b)			{ for (int l=0;l<BT_SOA_WIDTH;l++) a.m[l] -= b.m[l]; return a; }
+static SIMD_FORCE_INLINE btSoaReal	btSoaMul(btSoaReal a,btSoaReal b)			{ for (int l=0;l<BT_SOA_WIDTH;l++) a.m[l] *= b.m[l]; return a; }
+static SIMD_FORCE_INLINE btSoaReal	btSoaMax(btSoaReal a,btSoaReal b)			{ for (int l=0;l<BT_SOA_WIDTH;l++) a.m[l] = a.m[l] < b.m[l] ? b.m[l] : a.m[l]; return a; }
+static SIMD_FORCE_INLINE btSoaReal	btSoaMin(btSoaReal a,btSoaReal b)			{ for (int l=0;l<BT_SOA_WIDTH;l++) a.m[l] = b.m[l] < a.m[l] ? b.m[l] : a.m[l]; return a; }
+static SIMD_FORCE_INLINE btSoaReal	btSoaZero()									{ btSoaReal r; for (int l=0;l<BT_SOA_WIDTH;l++) r.m[l] = btScalar(0.); return r; }
+static SIMD_FORCE_INLINE btSoaReal	btSoaSelectPositive(btSoaReal t,btSoaReal a,btSoaReal b)	{ for (int l=0;l<BT_SOA_WIDTH;l++) a.m[l] = t.m[l] > btScalar(0.) ? a.m[l] : b.m[l]; return a; }
+
+static SIMD_FORCE_INLINE void	btSoaGather(btVector3* const* v,btSoaReal out[4])
+{
+	for (int l=0;l<BT_SOA_WIDTH;l++)
+		for (int k=0;k<4;k++)
+			out[k].m[l] = (*v[l])[k];
+}
+
+static SIMD_FORCE_INLINE void	btSoaScatter(btVector3* const* v,const btSoaReal in[4],int writeMask)
+{
+	for (int l=0;l<BT_SOA_WIDTH;l++)
+		if (writeMask & (1<<l))
+			for (int k=0;k<4;k++)
+				(*v[l])[k] = in[k].m[l];
+}
+
+#endif
+
+static SIMD_FORCE_INLINE btSoaReal	btSoaDot3(const btScalar a[3][BT_SOA_WIDTH],const btSoaReal b[4])
+{
+	btSoaReal r = btSoaMul(btSoaLoad(a[0]),b[0]);
+	r = btSoaAdd(r,btSoaMul(btSoaLoad(a[1]),b[1]));
+	return btSoaAdd(r,btSoaMul(btSoaLoad(a[2]),b[2]));
+}
+
+static SIMD_FORCE_INLINE void	btSoaMulAdd3(btSoaReal a[4],const btScalar b[3][BT_SOA_WIDTH],btSoaReal s)
+{
+	for (int k=0;k<3;k++)
+		a[k] = btSoaAdd(a[k],btSoaMul(btSoaLoad(b[k]),s));
+}
+
+static SIMD_FORCE_INLINE void	btSoaMulSub3(btSoaReal a[4],const btScalar b[3][BT_SOA_WIDTH],btSoaReal s)
+{
+	for (int k=0;k<3;k++)
+		a[k] = btSoaSub(a[k],btSoaMul(btSoaLoad(b[k]),s));
+}
+
+///resolveSingleConstraintRowGeneric for BT_SOA_WIDTH independent rows, see btSequentialImpulseConstraintSolver.cpp
+static SIMD_FORCE_INLINE void	btSolveSoaBlock(btSoaConstraintBlock& b,btSoaReal lowerLimit,btSoaReal upperLimit,bool hasUpperLimit)
+{
+	//the w components are carried along so the scatter writes back whole vectors
+	btSoaReal linVelA[4],angVelA[4],linVelB[4],angVelB[4];
+	btSoaGather(b.m_deltaLinearVelocityA,linVelA);
+	btSoaGather(b.m_deltaAngularVelocityA,angVelA);
+	btSoaGather(b.m_deltaLinearVelocityB,linVelB);
+	btSoaGather(b.m_deltaAngularVelocityB,angVelB);
+
+	btSoaReal appliedImpulse = btSoaLoad(b.m_appliedImpulse);
+	btSoaReal jacDiagABInv = btSoaLoad(b.m_jacDiagABInv);
+	btSoaReal deltaImpulse = btSoaSub(btSoaLoad(b.m_rhs),btSoaMul(appliedImpulse,btSoaLoad(b.m_cfm)));
+	btSoaReal deltaVel1Dotn = btSoaAdd(btSoaDot3(b.m_contactNormal,linVelA),btSoaDot3(b.m_relpos1CrossNormal,angVelA));
+	btSoaReal deltaVel2Dotn = btSoaSub(btSoaDot3(b.m_relpos2CrossNormal,angVelB),btSoaDot3(b.m_contactNormal,linVelB));
+	deltaImpulse = btSoaSub(deltaImpulse,btSoaMul(deltaVel1Dotn,jacDiagABInv));
+	deltaImpulse = btSoaSub(deltaImpulse,btSoaMul(deltaVel2Dotn,jacDiagABInv));
+
+	btSoaReal sum = btSoaMax(btSoaAdd(appliedImpulse,deltaImpulse),lowerLimit);
+	if (hasUpperLimit)
+		sum = btSoaMin(sum,upperLimit);
+	deltaImpulse = btSoaSub(sum,appliedImpulse);
+	btSoaStore(b.m_appliedImpulse,sum);
+
+	btSoaMulAdd3(linVelA,b.m_linearComponentA,deltaImpulse);
+	btSoaMulAdd3(angVelA,b.m_angularComponentA,deltaImpulse);
+	btSoaMulSub3(linVelB,b.m_linearComponentB,deltaImpulse);
+	btSoaMulAdd3(angVelB,b.m_angularComponentB,deltaImpulse);
+
+	btSoaScatter(b.m_deltaLinearVelocityA,linVelA,b.m_writeMaskA);
+	btSoaScatter(b.m_deltaAngularVelocityA,angVelA,b.m_writeMaskA);
+	btSoaScatter(b.m_deltaLinearVelocityB,linVelB,b.m_writeMaskB);
+	btSoaScatter(b.m_deltaAngularVelocityB,angVelB,b.m_writeMaskB);
+}
+
+static void	btInitBlockLane(btSoaConstraintBlock& b,int l,btSolverConstraint* row)
+{
+	if (!row)
+	{
+		//padding: reads the velocities of lane 0, zero impulse, never written back
+		for (int k=0;k<3;k++)
+		{
+			b.m_contactNormal[k][l] = 0.f;
+			b.m_relpos1CrossNormal[k][l] = 0.f;
+			b.m_relpos2CrossNormal[k][l] = 0.f;
+			b.m_linearComponentA[k][l] = 0.f;
+			b.m_linearComponentB[k][l] = 0.f;
+			b.m_angularComponentA[k][l] = 0.f;
+			b.m_angularComponentB[k][l] = 0.f;
+		}
+		b.m_rhs[l] = 0.f;
+		b.m_cfm[l] = 0.f;
+		b.m_jacDiagABInv[l] = 0.f;
+		b.m_lowerLimit[l] = 0.f;
+		b.m_friction[l] = 0.f;
+		b.m_appliedImpulse[l] = 0.f;
+		b.m_rows[l] = 0;
+		b.m_deltaLinearVelocityA[l] = b.m_deltaLinearVelocityA[0];
+		b.m_deltaAngularVelocityA[l] = b.m_deltaAngularVelocityA[0];
+		b.m_deltaLinearVelocityB[l] = b.m_deltaLinearVelocityB[0];
+		b.m_deltaAngularVelocityB[l] = b.m_deltaAngularVelocityB[0];
+		return;
+	}
+
+	btRigidBody* bodyA = row->m_solverBodyA;
+	btRigidBody* bodyB = row->m_solverBodyB;
+	btVector3 linearComponentA = row->m_contactNormal*bodyA->internalGetInvMass();
+	btVector3 linearComponentB = row->m_contactNormal*bodyB->internalGetInvMass();
+	btVector3 angularComponentA = row->m_angularComponentA*bodyA->internalGetAngularFactor();
+	btVector3 angularComponentB = row->m_angularComponentB*bodyB->internalGetAngularFactor();
+	for (int k=0;k<3;k++)
+	{
+		b.m_contactNormal[k][l] = row->m_contactNormal[k];
+		b.m_relpos1CrossNormal[k][l] = row->m_relpos1CrossNormal[k];
+		b.m_relpos2CrossNormal[k][l] = row->m_relpos2CrossNormal[k];
+		b.m_linearComponentA[k][l] = linearComponentA[k];
+		b.m_linearComponentB[k][l] = linearComponentB[k];
+		b.m_angularComponentA[k][l] = angularComponentA[k];
+		b.m_angularComponentB[k][l] = angularComponentB[k];
+	}
+	b.m_rhs[l] = row->m_rhs;
+	b.m_cfm[l] = row->m_cfm;
+	b.m_jacDiagABInv[l] = row->m_jacDiagABInv;
+	b.m_lowerLimit[l] = row->m_lowerLimit;
+	b.m_friction[l] = row->m_friction;
+	b.m_appliedImpulse[l] = btScalar(row->m_appliedImpulse);
+	b.m_rows[l] = row;
+	b.m_deltaLinearVelocityA[l] = &bodyA->internalGetDeltaLinearVelocity();
+	b.m_deltaAngularVelocityA[l] = &bodyA->internalGetDeltaAngularVelocity();
+	b.m_deltaLinearVelocityB[l] = &bodyB->internalGetDeltaLinearVelocity();
+	b.m_deltaAngularVelocityB[l] = &bodyB->internalGetDeltaAngularVelocity();
+	//like internalApplyImpulse, static and kinematic bodies are never written, several lanes may read them
+	if (bodyA->getInvMass())
+		b.m_writeMaskA |= 1<<l;
+	if (bodyB->getInvMass())
+		b.m_writeMaskB |= 1<<l;
+}
+
+static SIMD_FORCE_INLINE btSoaConstraintBlock&	btExpandBlock(btAlignedObjectArray<btSoaConstraintBlock>& blocks)
+{
+	btSoaConstraintBlock& block = blocks.expandNonInitializing();
+	block.m_contactImpulses = 0;
+	block.m_writeMaskA = 0;
+	block.m_writeMaskB = 0;
+	return block;
+}
+
+int		btBatchedConstraints::getBodySlot(btRigidBody* body)
+{
+	if (!body->getInvMass())
+		return -1;
+
+	//the companion id is free while the solver runs, it used to hold the solver body index
+	int slot = body->getCompanionId();
+	if (slot >= 0 && slot < m_taggedBodies.size() && m_taggedBodies[slot] == body)
+		return slot;
+
+	slot = m_taggedBodies.size();
+	m_taggedBodies.push_back(body);
+	m_savedCompanionIds.push_back(body->getCompanionId());
+	m_bodyColorMasks.push_back(0);
+	body->setCompanionId(slot);
+	return slot;
+}
+
+void	btBatchedConstraints::setupContactBlocks(btConstraintArray& contactRows,const btAlignedObjectArray<int>& order)
+{
+	int numRows = contactRows.size();
+	int i;
+
+	m_blocks.resize(0);
+	m_unbatchedRows.resize(0);
+
+	if (numRows < BT_MIN_BATCHED_ROWS)
+	{
+		for (i=0;i<numRows;i++)
+			m_unbatchedRows.push_back(order[i]);
+		return;
+	}
+
+	//greedy coloring, each dynamic body remembers the colors of its rows
+	m_rowColors.resize(numRows);
+	m_colorOffsets.resize(0);
+	m_colorOffsets.resize(BT_SOA_MAX_COLORS+1,0);
+	for (i=0;i<numRows;i++)
+	{
+		btSolverConstraint& row = contactRows[order[i]];
+		int slotA = getBodySlot(row.m_solverBodyA);
+		int slotB = getBodySlot(row.m_solverBodyB);
+		unsigned int used = (slotA >= 0 ? m_bodyColorMasks[slotA] : 0) | (slotB >= 0 ? m_bodyColorMasks[slotB] : 0);
+		if (used == 0xffffffff)
+		{
+			m_rowColors[i] = -1;
+			m_unbatchedRows.push_back(order[i]);
+			continue;
+		}
+		int color = 0;
+		while (used & (1u<<color))
+			color++;
+		if (slotA >= 0)
+			m_bodyColorMasks[slotA] |= 1u<<color;
+		if (slotB >= 0)
+			m_bodyColorMasks[slotB] |= 1u<<color;
+		m_rowColors[i] = color;
+		m_colorOffsets[color+1]++;
+	}
+
+	for (i=0;i<m_taggedBodies.size();i++)
+		m_taggedBodies[i]->setCompanionId(m_savedCompanionIds[i]);
+	m_taggedBodies.resize(0);
+	m_savedCompanionIds.resize(0);
+	m_bodyColorMasks.resize(0);
+
+	//bucket the rows by color, keeping their order within a color
+	for (i=0;i<BT_SOA_MAX_COLORS;i++)
+		m_colorOffsets[i+1] += m_colorOffsets[i];
+	m_sortedRows.resize(m_colorOffsets[BT_SOA_MAX_COLORS]);
+	for (i=0;i<numRows;i++)
+	{
+		int color = m_rowColors[i];
+		if (color >= 0)
+			m_sortedRows[m_colorOffsets[color]++] = order[i];
+	}
+
+	//m_colorOffsets[c] now is the end of color c
+	int begin = 0;
+	for (int color=0;color<BT_SOA_MAX_COLORS;color++)
+	{
+		int end = m_colorOffsets[color];
+		for (i=begin;i<end;i+=BT_SOA_WIDTH)
+		{
+			btSoaConstraintBlock& block = btExpandBlock(m_blocks);
+			for (int l=0;l<BT_SOA_WIDTH;l++)
+			{
+				btInitBlockLane(block,l,i+l < end ? &contactRows[m_sortedRows[i+l]] : 0);
+			}
+		}
+		begin = end;
+	}
+}
+
+void	btBatchedConstraints::setupFrictionBlocks(btConstraintArray& frictionRows,const btConstraintArray& contactRows,const btBatchedConstraints& contactBlocks)
+{
+	int numContacts = contactRows.size();
+	int numRows = frictionRows.size();
+	int i,j,l;
+
+	m_blocks.resize(0);
+	m_unbatchedRows.resize(0);
+
+	//every contact row owns the friction rows [m_frictionIndex,m_frictionIndex+numDirections), see convertContact
+	int numDirections = numContacts ? numRows/numContacts : 0;
+	bool sameLayout = numDirections > 0 && numDirections*numContacts == numRows;
+
+	//the friction rows of a contact block share its bodies, so they form blocks too and read the contact impulses lane by lane
+	for (j=0;sameLayout && j<numDirections;j++)
+	{
+		for (i=0;sameLayout && i<contactBlocks.getNumBlocks();i++)
+		{
+			const btSoaConstraintBlock& contactBlock = contactBlocks.m_blocks[i];
+			btSoaConstraintBlock& block = btExpandBlock(m_blocks);
+			block.m_contactImpulses = contactBlock.m_appliedImpulse;
+			for (l=0;l<BT_SOA_WIDTH;l++)
+			{
+				btSolverConstraint* frictionRow = 0;
+				if (contactBlock.m_rows[l])
+				{
+					int contactIndex = int(contactBlock.m_rows[l]-&contactRows[0]);
+					int frictionIndex = contactBlock.m_rows[l]->m_frictionIndex+j;
+					if (frictionIndex < 0 || frictionIndex >= numRows || frictionRows[frictionIndex].m_frictionIndex != contactIndex)
+					{
+						sameLayout = false;
+						break;
+					}
+					frictionRow = &frictionRows[frictionIndex];
+				}
+				btInitBlockLane(block,l,frictionRow);
+			}
+		}
+	}
+	if (!sameLayout)
+	{
+		m_blocks.resize(0);
+		for (i=0;i<numRows;i++)
+			m_unbatchedRows.push_back(i);
+		return;
+	}
+
+	for (i=0;i<contactBlocks.getUnbatchedRows().size();i++)
+	{
+		const btSolverConstraint& contactRow = contactRows[contactBlocks.getUnbatchedRows()[i]];
+		for (j=0;j<numDirections;j++)
+			m_unbatchedRows.push_back(contactRow.m_frictionIndex+j);
+	}
+}
+
+void	btBatchedConstraints::clear()
+{
+	m_blocks.resize(0);
+	m_unbatchedRows.resize(0);
+}
+
+void	btBatchedConstraints::solveContactBlocks()
+{
+	int numBlocks = m_blocks.size();
+	for (int i=0;i<numBlocks;i++)
+	{
+		btSoaConstraintBlock& b = m_blocks[i];
+		btSolveSoaBlock(b,btSoaLoad(b.m_lowerLimit),btSoaZero(),false);
+	}
+}
+
+void	btBatchedConstraints::solveFrictionBlocks()
+{
+	int numBlocks = m_blocks.size();
+	for (int i=0;i<numBlocks;i++)
+	{
+		btSoaConstraintBlock& b = m_blocks[i];
+		//like the scalar solver the limits follow the contact impulse, rows without one are pinned to their impulse
+		btSoaReal totalImpulse = btSoaLoad(b.m_contactImpulses);
+		btSoaReal appliedImpulse = btSoaLoad(b.m_appliedImpulse);
+		btSoaReal upperLimit = btSoaMul(btSoaLoad(b.m_friction),totalImpulse);
+		btSoaReal lowerLimit = btSoaSub(btSoaZero(),upperLimit);
+		btSolveSoaBlock(b,btSoaSelectPositive(totalImpulse,lowerLimit,appliedImpulse),btSoaSelectPositive(totalImpulse,upperLimit,appliedImpulse),true);
+	}
+}
+
+void	btBatchedConstraints::writeBackAppliedImpulses()
+{
+	int numBlocks = m_blocks.size();
+	for (int i=0;i<numBlocks;i++)
+	{
+		const btSoaConstraintBlock& b = m_blocks[i];
+		for (int l=0;l<BT_SOA_WIDTH;l++)
+		{
+			if (b.m_rows[l])
+				b.m_rows[l]->m_appliedImpulse = b.m_appliedImpulse[l];
+		}
+	}
+}
@@ -0,0 +1,120 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2012 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef BT_BATCHED_CONSTRAINTS_H
+#define BT_BATCHED_CONSTRAINTS_H
+
+#include "btSolverConstraint.h"
+#include "btAlignedObjectArray.h"
+
+///number of solver rows resolved by one SIMD kernel invocation, 8 with AVX, 4 with SSE and for the portable fallback
+#if defined(__AVX__) && !defined(BT_USE_DOUBLE_PRECISION)
+#define BT_SOA_WIDTH 8
+#else
+#define BT_SOA_WIDTH 4
+#endif
+
+///BT_SOA_WIDTH solver rows that share no dynamic body, stored as structure of arrays.
+///Unused lanes have zero coefficients and no row, they read the velocities of lane 0 and are never written back.
+ATTRIBUTE_ALIGNED64 (struct)	btSoaConstraintBlock
+{
+	BT_DECLARE_ALIGNED_ALLOCATOR();
+
+	btScalar	m_contactNormal[3][BT_SOA_WIDTH];
+	btScalar	m_relpos1CrossNormal[3][BT_SOA_WIDTH];
+	btScalar	m_relpos2CrossNormal[3][BT_SOA_WIDTH];
+	btScalar	m_linearComponentA[3][BT_SOA_WIDTH];
+	btScalar	m_linearComponentB[3][BT_SOA_WIDTH];
+	btScalar	m_angularComponentA[3][BT_SOA_WIDTH];
+	btScalar	m_angularComponentB[3][BT_SOA_WIDTH];
+
+	btScalar	m_rhs[BT_SOA_WIDTH];
+	btScalar	m_cfm[BT_SOA_WIDTH];
+	btScalar	m_jacDiagABInv[BT_SOA_WIDTH];
+	btScalar	m_lowerLimit[BT_SOA_WIDTH];
+	btScalar	m_friction[BT_SOA_WIDTH];
+	btScalar	m_appliedImpulse[BT_SOA_WIDTH];
+
+	btSolverConstraint*	m_rows[BT_SOA_WIDTH];
+	///friction blocks: the applied impulses of the contact block with the same lanes
+	const btScalar*	m_contactImpulses;
+	btVector3*	m_deltaLinearVelocityA[BT_SOA_WIDTH];
+	btVector3*	m_deltaAngularVelocityA[BT_SOA_WIDTH];
+	btVector3*	m_deltaLinearVelocityB[BT_SOA_WIDTH];
+	btVector3*	m_deltaAngularVelocityB[BT_SOA_WIDTH];
+
+	///lanes whose body A/B is dynamic and gets the solved velocity written back
+	int		m_writeMaskA;
+	int		m_writeMaskB;
+};
+
+///btBatchedConstraints greedily colors the contact rows so that rows of one color share no dynamic body, and packs
+///each color into btSoaConstraintBlock's that are resolved BT_SOA_WIDTH rows at a time (see SOLVER_SIMD_SOA).
+///The friction rows of a contact block share its bodies, so friction blocks mirror the contact blocks.
+///Rows of a block are independent, solving a block equals solving its rows one after the other; only the order
+///of the rows differs from the one-row-at-a-time solver. Rows that don't fit into any of the 32 colors are left to the caller.
+class btBatchedConstraints
+{
+	btAlignedObjectArray<btSoaConstraintBlock>	m_blocks;
+	btAlignedObjectArray<int>	m_unbatchedRows;
+
+	btAlignedObjectArray<int>	m_rowColors;
+	btAlignedObjectArray<int>	m_colorOffsets;
+	btAlignedObjectArray<int>	m_sortedRows;
+	btAlignedObjectArray<unsigned int>	m_bodyColorMasks;
+	btAlignedObjectArray<btRigidBody*>	m_taggedBodies;
+	btAlignedObjectArray<int>	m_savedCompanionIds;
+
+	int		getBodySlot(btRigidBody* body);
+
+public:
+
+	///pools smaller than this are not worth batching, all their rows are returned by getUnbatchedRows
+	enum
+	{
+		BT_MIN_BATCHED_ROWS = BT_SOA_WIDTH*2
+	};
+
+	///builds the contact blocks, visiting the rows in the given order. The row array must not be resized until the next setup.
+	void	setupContactBlocks(btConstraintArray& contactRows,const btAlignedObjectArray<int>& order);
+
+	///builds friction blocks with the lanes of contactBlocks. If the friction rows are not laid out like convertContact does, none are batched.
+	void	setupFrictionBlocks(btConstraintArray& frictionRows,const btConstraintArray& contactRows,const btBatchedConstraints& contactBlocks);
+
+	void	clear();
+
+	///one projected Gauss-Seidel pass over all blocks, contact rows only have a lower limit
+	void	solveContactBlocks();
+
+	///one pass over all friction blocks, the limits follow the applied impulse of the contact rows like in btSequentialImpulseConstraintSolver
+	void	solveFrictionBlocks();
+
+	///the blocks keep their own applied impulses while iterating, this copies them into the rows
+	void	writeBackAppliedImpulses();
+
+	int		getNumBlocks() const
+	{
+		return m_blocks.size();
+	}
+
+	///indices of the rows that were not batched, in solving order
+	const btAlignedObjectArray<int>&	getUnbatchedRows() const
+	{
+		return m_unbatchedRows;
+	}
+};
+
+#endif //BT_BATCHED_CONSTRAINTS_H
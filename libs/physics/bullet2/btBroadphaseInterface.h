@@ -44,6 +44,15 @@ struct	btBroadphaseRayCallback : public btBroadphaseAabbCallback
 };
 
 #include "btVector3.h"
+#include "btRayPacket.h"
+
+///btBroadphaseRayPacketCallback gets the proxies whose aabb is hit by rays of a btRayPacket
+struct	btBroadphaseRayPacketCallback
+{
+	virtual ~btBroadphaseRayPacketCallback() {}
+	///rayMask has a bit for each lane that hits the aabb of the proxy, process may lower m_lambdaMax of those lanes
+	virtual void	process(const btBroadphaseProxy* proxy,int rayMask) = 0;
+};
 
 ///The btBroadphaseInterface class provides an interface to detect aabb-overlapping object pairs.
 ///Some implementations for this broadphase interface include btAxisSweep3, bt32BitAxisSweep3 and btDbvtBroadphase.
@@ -62,6 +71,36 @@ public:
 
 	virtual void	aabbTest(const btVector3& aabbMin, const btVector3& aabbMax, btBroadphaseAabbCallback& callback) = 0;
 
+	///rayTestPacket reports the proxies hit by the rays of the packet, culled against the m_lambdaMax of each lane.
+	///Unlike rayTest it may be called from several threads at the same time. The default tests the proxies that aabbTest reports for the bounds of the packet.
+	virtual void	rayTestPacket(btRayPacket& packet,btBroadphaseRayPacketCallback& callback)
+	{
+		struct	PacketAabbTester : public btBroadphaseAabbCallback
+		{
+			btRayPacket&	m_packet;
+			btBroadphaseRayPacketCallback&	m_packetCallback;
+
+			PacketAabbTester(btRayPacket& packet,btBroadphaseRayPacketCallback& packetCallback)
+				:m_packet(packet),
+				m_packetCallback(packetCallback)
+			{
+			}
+
+			virtual bool	process(const btBroadphaseProxy* proxy)
+			{
+				int rayMask = m_packet.testAabb(proxy->m_aabbMin,proxy->m_aabbMax,m_packet.m_activeMask);
+				if (rayMask)
+					m_packetCallback.process(proxy,rayMask);
+				return true;
+			}
+		};
+
+		if (!packet.m_activeMask)
+			return;
+		PacketAabbTester tester(packet,callback);
+		aabbTest(packet.m_aabbMin,packet.m_aabbMax,tester);
+	}
+
 	///calculateOverlappingPairs is optional: incremental algorithms (sweep and prune) might do it during the set aabb
 	virtual void	calculateOverlappingPairs(btDispatcher* dispatcher)=0;
 
@@ -0,0 +1,305 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2012 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include "btBvhCache.h"
+#include "btStridingMeshInterface.h"
+#include "btBvhTriangleMeshShape.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <process.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+#define BT_BVH_CACHE_FILE_VERSION 1
+
+///64 bytes, so the serialized tree that follows stays 16 byte aligned in the mapping
+struct btBvhCacheFileHeader
+{
+	char	m_magic[8];
+	int		m_fileVersion;
+	int		m_bulletVersion;
+	int		m_pointerSize;
+	int		m_scalarSize;
+	unsigned long long	m_cacheKey;
+	unsigned long long	m_dataSize;
+	char	m_padding[24];
+};
+
+static const char	btBvhCacheMagic[8] = {'B','T','B','V','H','C','H','E'};
+
+static void	btInitCacheFileHeader(btBvhCacheFileHeader& header,unsigned long long cacheKey,unsigned long long dataSize)
+{
+	memset(&header,0,sizeof(header));
+	memcpy(header.m_magic,btBvhCacheMagic,sizeof(header.m_magic));
+	header.m_fileVersion = BT_BVH_CACHE_FILE_VERSION;
+	header.m_bulletVersion = BT_BULLET_VERSION;
+	header.m_pointerSize = int(sizeof(void*));
+	header.m_scalarSize = int(sizeof(btScalar));
+	header.m_cacheKey = cacheKey;
+	header.m_dataSize = dataSize;
+}
+
+///64 bit FNV-1a over 8 byte words with an extra shift, good enough to tell meshes apart
+static SIMD_FORCE_INLINE unsigned long long	btHashWord(unsigned long long hash,unsigned long long word)
+{
+	hash = (hash ^ word) * 1099511628211ULL;
+	return hash ^ (hash >> 29);
+}
+
+static unsigned long long	btHashBytes(unsigned long long hash,const void* data,size_t size)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	unsigned long long word;
+	while (size >= sizeof(word))
+	{
+		memcpy(&word,bytes,sizeof(word));
+		hash = btHashWord(hash,word);
+		bytes += sizeof(word);
+		size -= sizeof(word);
+	}
+	word = 0;
+	memcpy(&word,bytes,size);
+	return btHashWord(hash,word ^ ((unsigned long long)size << 56));
+}
+
+static void	btUnmapFile(void* mapping,size_t size)
+{
+#ifdef _WIN32
+	(void)size;
+	UnmapViewOfFile(mapping);
+#else
+	munmap(mapping,size);
+#endif
+}
+
+
+btBvhCache::btBvhCache(const char* directory)
+:m_numHits(0),
+m_numMisses(0)
+{
+	int length = int(strlen(directory));
+	m_directory.resize(length+1);
+	memcpy(&m_directory[0],directory,length+1);
+}
+
+btBvhCache::~btBvhCache()
+{
+	for (int i=0;i<m_entries.size();i++)
+	{
+		btCacheEntry& entry = m_entries[i];
+		entry.m_bvh->~btOptimizedBvh();
+		if (entry.m_mapping)
+		{
+			btUnmapFile(entry.m_mapping,entry.m_mappingSize);
+		} else
+		{
+			btAlignedFree(entry.m_bvh);
+		}
+	}
+}
+
+unsigned long long	btBvhCache::calculateMeshHash(const btStridingMeshInterface* meshInterface)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+
+	const btVector3& scaling = meshInterface->getScaling();
+	btScalar scale[3] = {scaling.getX(),scaling.getY(),scaling.getZ()};
+	hash = btHashBytes(hash,scale,sizeof(scale));
+
+	int numSubParts = meshInterface->getNumSubParts();
+	for (int part=0;part<numSubParts;part++)
+	{
+		const unsigned char *vertexbase = 0;
+		int numverts = 0;
+		PHY_ScalarType type = PHY_INTEGER;
+		int stride = 0;
+		const unsigned char *indexbase = 0;
+		int indexstride = 0;
+		int numfaces = 0;
+		PHY_ScalarType indicestype = PHY_INTEGER;
+
+		meshInterface->getLockedReadOnlyVertexIndexBase(&vertexbase,numverts,type,stride,&indexbase,indexstride,numfaces,indicestype,part);
+
+		int layout[6] = {numverts,int(type),stride,numfaces,int(indicestype),indexstride};
+		hash = btHashBytes(hash,layout,sizeof(layout));
+
+		//only the bytes the triangles are read from, the last vertex and triangle may not span a whole stride
+		if (numverts > 0)
+		{
+			size_t vertexSize = 3*(type == PHY_DOUBLE ? sizeof(double) : sizeof(float));
+			hash = btHashBytes(hash,vertexbase,size_t(numverts-1)*size_t(stride)+vertexSize);
+		}
+		if (numfaces > 0)
+		{
+			size_t indexSize = 3*(indicestype == PHY_SHORT ? sizeof(short) : (indicestype == PHY_UCHAR ? sizeof(unsigned char) : sizeof(int)));
+			hash = btHashBytes(hash,indexbase,size_t(numfaces-1)*size_t(indexstride)+indexSize);
+		}
+
+		meshInterface->unLockReadOnlyVertexBase(part);
+	}
+	return hash;
+}
+
+void	btBvhCache::getFileName(unsigned long long cacheKey,char* fileName,int maxLength) const
+{
+	snprintf(fileName,maxLength,"%s/%016llx.bvh",&m_directory[0],cacheKey);
+}
+
+btOptimizedBvh*	btBvhCache::mapFile(const char* fileName,unsigned long long cacheKey)
+{
+	//private writable mapping: deSerializeInPlace patches the object header and a refit may change nodes, neither reaches the file
+	void* mapping = 0;
+	size_t size = 0;
+#ifdef _WIN32
+	HANDLE file = CreateFileA(fileName,GENERIC_READ,FILE_SHARE_READ,0,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,0);
+	if (file == INVALID_HANDLE_VALUE)
+		return 0;
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file,&fileSize) || fileSize.QuadPart < LONGLONG(sizeof(btBvhCacheFileHeader)))
+	{
+		CloseHandle(file);
+		return 0;
+	}
+	size = size_t(fileSize.QuadPart);
+	HANDLE fileMapping = CreateFileMappingA(file,0,PAGE_WRITECOPY,0,0,0);
+	CloseHandle(file);
+	if (!fileMapping)
+		return 0;
+	//the view keeps the mapping object alive
+	mapping = MapViewOfFile(fileMapping,FILE_MAP_COPY,0,0,0);
+	CloseHandle(fileMapping);
+	if (!mapping)
+		return 0;
+#else
+	int file = open(fileName,O_RDONLY);
+	if (file < 0)
+		return 0;
+	struct stat fileStat;
+	if (fstat(file,&fileStat) != 0 || fileStat.st_size < off_t(sizeof(btBvhCacheFileHeader)))
+	{
+		close(file);
+		return 0;
+	}
+	size = size_t(fileStat.st_size);
+	mapping = mmap(0,size,PROT_READ|PROT_WRITE,MAP_PRIVATE,file,0);
+	close(file);
+	if (mapping == MAP_FAILED)
+		return 0;
+#endif
+
+	btBvhCacheFileHeader expected;
+	btInitCacheFileHeader(expected,cacheKey,size-sizeof(btBvhCacheFileHeader));
+	btOptimizedBvh* bvh = 0;
+	if (memcmp(mapping,&expected,sizeof(expected)) == 0)
+	{
+		bvh = btOptimizedBvh::deSerializeInPlace((char*)mapping+sizeof(btBvhCacheFileHeader),(unsigned int)(size-sizeof(btBvhCacheFileHeader)),false);
+	}
+	if (!bvh)
+	{
+		btUnmapFile(mapping,size);
+		return 0;
+	}
+
+	btCacheEntry& entry = m_entries.expandNonInitializing();
+	entry.m_bvh = bvh;
+	entry.m_mapping = mapping;
+	entry.m_mappingSize = size;
+	return bvh;
+}
+
+void	btBvhCache::writeFile(const char* fileName,unsigned long long cacheKey,const btOptimizedBvh* bvh)
+{
+	unsigned int dataSize = bvh->calculateSerializeBufferSize();
+	void* buffer = btAlignedAlloc(dataSize,16);
+	//zero the padding, the same tree always gives the same file
+	memset(buffer,0,dataSize);
+	bvh->serializeInPlace(buffer,dataSize,false);
+
+	btBvhCacheFileHeader header;
+	btInitCacheFileHeader(header,cacheKey,dataSize);
+
+	//write to a temporary file and rename it, so other processes never map a partial file
+	char tmpFileName[1024];
+#ifdef _WIN32
+	snprintf(tmpFileName,sizeof(tmpFileName),"%s.%d.tmp",fileName,_getpid());
+#else
+	snprintf(tmpFileName,sizeof(tmpFileName),"%s.%d.tmp",fileName,int(getpid()));
+#endif
+	FILE* file = fopen(tmpFileName,"wb");
+	if (file)
+	{
+		bool written = fwrite(&header,sizeof(header),1,file) == 1 && fwrite(buffer,dataSize,1,file) == 1;
+		written = (fclose(file) == 0) && written;
+#ifdef _WIN32
+		if (!written || !MoveFileExA(tmpFileName,fileName,MOVEFILE_REPLACE_EXISTING))
+#else
+		if (!written || rename(tmpFileName,fileName) != 0)
+#endif
+		{
+			remove(tmpFileName);
+		}
+	}
+	btAlignedFree(buffer);
+}
+
+btOptimizedBvh*	btBvhCache::getOptimizedBvh(btStridingMeshInterface* meshInterface,bool useQuantizedAabbCompression,const btVector3& bvhAabbMin,const btVector3& bvhAabbMax)
+{
+	unsigned long long cacheKey = calculateMeshHash(meshInterface);
+	btScalar aabb[6] = {bvhAabbMin.getX(),bvhAabbMin.getY(),bvhAabbMin.getZ(),bvhAabbMax.getX(),bvhAabbMax.getY(),bvhAabbMax.getZ()};
+	cacheKey = btHashBytes(cacheKey,aabb,sizeof(aabb));
+	cacheKey = btHashWord(cacheKey,useQuantizedAabbCompression ? 1 : 0);
+
+	char fileName[1024];
+	getFileName(cacheKey,fileName,sizeof(fileName));
+
+	btOptimizedBvh* bvh = mapFile(fileName,cacheKey);
+	if (bvh)
+	{
+		m_numHits++;
+		return bvh;
+	}
+	m_numMisses++;
+
+	void* mem = btAlignedAlloc(sizeof(btOptimizedBvh),16);
+	bvh = new(mem) btOptimizedBvh();
+	bvh->build(meshInterface,useQuantizedAabbCompression,bvhAabbMin,bvhAabbMax);
+
+	btCacheEntry& entry = m_entries.expandNonInitializing();
+	entry.m_bvh = bvh;
+	entry.m_mapping = 0;
+	entry.m_mappingSize = 0;
+
+	writeFile(fileName,cacheKey,bvh);
+	return bvh;
+}
+
+bool	btBvhCache::setupShape(btBvhTriangleMeshShape* shape)
+{
+	int numHits = m_numHits;
+	btOptimizedBvh* bvh = getOptimizedBvh(shape->getMeshInterface(),shape->usesQuantizedAabbCompression(),shape->getLocalAabbMin(),shape->getLocalAabbMax());
+	shape->setOptimizedBvh(bvh,shape->getLocalScaling());
+	return m_numHits != numHits;
+}
@@ -0,0 +1,82 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2012 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef BT_BVH_CACHE_H
+#define BT_BVH_CACHE_H
+
+#include "btOptimizedBvh.h"
+#include "btAlignedObjectArray.h"
+
+class btStridingMeshInterface;
+class btBvhTriangleMeshShape;
+
+///btBvhCache keeps the btOptimizedBvh of static triangle meshes in a directory on disk, one file per mesh named after a hash
+///of the triangle data, the mesh scaling, the bvh aabb and the quantization flag. A mesh that changes hashes to a different file,
+///so a stale tree is never loaded. Cached trees are memory mapped copy-on-write and deserialized in place (see btQuantizedBvh::deSerializeInPlace),
+///on a miss the tree is built, using the btTaskScheduler if there is one, and written to the directory.
+///The cache files depend on the platform (pointer size, btScalar precision, endianness) and the Bullet version, files of another layout are rebuilt.
+///The cache owns the trees it returns: it has to outlive the shapes using them. It is not thread-safe.
+///Like with btOptimizedBvh::deSerializeInPlace, mapped trees are btQuantizedBvh objects, use btQuantizedBvh::serialize instead of serializeInPlace on them.
+class btBvhCache
+{
+	struct btCacheEntry
+	{
+		btOptimizedBvh*	m_bvh;
+		///mapped file or 0 if the tree was built
+		void*			m_mapping;
+		size_t			m_mappingSize;
+	};
+
+	btAlignedObjectArray<btCacheEntry>	m_entries;
+	btAlignedObjectArray<char>	m_directory;
+
+	int		m_numHits;
+	int		m_numMisses;
+
+	void	getFileName(unsigned long long cacheKey,char* fileName,int maxLength) const;
+
+	btOptimizedBvh*	mapFile(const char* fileName,unsigned long long cacheKey);
+
+	void	writeFile(const char* fileName,unsigned long long cacheKey,const btOptimizedBvh* bvh);
+
+public:
+
+	///directory has to exist, trees that can't be written are only kept in memory
+	btBvhCache(const char* directory);
+
+	~btBvhCache();
+
+	///returns the tree of the mesh, mapped from the cache directory or built and stored there
+	btOptimizedBvh*	getOptimizedBvh(btStridingMeshInterface* meshInterface,bool useQuantizedAabbCompression,const btVector3& bvhAabbMin,const btVector3& bvhAabbMax);
+
+	///sets the tree of a shape that was created with buildBvh = false, returns true if the tree came from the cache
+	bool	setupShape(btBvhTriangleMeshShape* shape);
+
+	///hash of the triangle data and the scaling of the mesh, combined with the bvh settings it names the cache file
+	static unsigned long long	calculateMeshHash(const btStridingMeshInterface* meshInterface);
+
+	int		getNumHits() const
+	{
+		return m_numHits;
+	}
+
+	int		getNumMisses() const
+	{
+		return m_numMisses;
+	}
+};
+
+#endif //BT_BVH_CACHE_H
@@ -18,6 +18,7 @@ subject to the following restrictions:
 #include "btBvhTriangleMeshShape.h"
 #include "btOptimizedBvh.h"
 #include "btSerializer.h"
+#include "btRaycastCallback.h"
 
 ///Bvh Concave triangle mesh is a static-triangle mesh shape with Bounding Volume Hierarchy optimization.
 ///Uses an interface to access the triangles to allow for sharing graphics/physics triangles.
@@ -159,6 +160,84 @@ void	btBvhTriangleMeshShape::performRaycast (btTriangleCallback* callback, const
 	m_bvh->reportRayOverlappingNodex(&myNodeCallback,raySource,rayTarget);
 }
 
+void	btBvhTriangleMeshShape::performRaycastPacket (btTriangleRaycastCallback* const* callbacks, btRayPacket& packet) const
+{
+	struct	MyNodeRayPacketCallback : public btNodeRayPacketCallback
+	{
+		const btStridingMeshInterface*	m_meshInterface;
+		btTriangleRaycastCallback* const* m_callbacks;
+		btRayPacket& m_packet;
+
+		MyNodeRayPacketCallback(btTriangleRaycastCallback* const* callbacks,const btStridingMeshInterface* meshInterface,btRayPacket& packet)
+			:m_meshInterface(meshInterface),
+			m_callbacks(callbacks),
+			m_packet(packet)
+		{
+		}
+
+		virtual void processNode(int nodeSubPart, int nodeTriangleIndex, int rayMask)
+		{
+			btVector3 m_triangle[3];
+			const unsigned char *vertexbase;
+			int numverts;
+			PHY_ScalarType type;
+			int stride;
+			const unsigned char *indexbase;
+			int indexstride;
+			int numfaces;
+			PHY_ScalarType indicestype;
+
+			m_meshInterface->getLockedReadOnlyVertexIndexBase(
+				&vertexbase,
+				numverts,
+				type,
+				stride,
+				&indexbase,
+				indexstride,
+				numfaces,
+				indicestype,
+				nodeSubPart);
+
+			unsigned int* gfxbase = (unsigned int*)(indexbase+nodeTriangleIndex*indexstride);
+			btAssert(indicestype==PHY_INTEGER||indicestype==PHY_SHORT);
+
+			const btVector3& meshScaling = m_meshInterface->getScaling();
+			for (int j=2;j>=0;j--)
+			{
+				int graphicsindex = indicestype==PHY_SHORT?((unsigned short*)gfxbase)[j]:gfxbase[j];
+
+				if (type == PHY_FLOAT)
+				{
+					float* graphicsbase = (float*)(vertexbase+graphicsindex*stride);
+
+					m_triangle[j] = btVector3(graphicsbase[0]*meshScaling.getX(),graphicsbase[1]*meshScaling.getY(),graphicsbase[2]*meshScaling.getZ());
+				}
+				else
+				{
+					double* graphicsbase = (double*)(vertexbase+graphicsindex*stride);
+
+					m_triangle[j] = btVector3(btScalar(graphicsbase[0])*meshScaling.getX(),btScalar(graphicsbase[1])*meshScaling.getY(),btScalar(graphicsbase[2])*meshScaling.getZ());
+				}
+			}
+
+			/* Perform ray vs. triangle collision for each lane, a hit shortens the lane */
+			for (int lane=0;lane<BT_RAY_PACKET_SIZE;lane++)
+			{
+				if (rayMask & (1<<lane))
+				{
+					m_callbacks[lane]->processTriangle(m_triangle,nodeSubPart,nodeTriangleIndex);
+					m_packet.m_lambdaMax[lane] = m_callbacks[lane]->m_hitFraction;
+				}
+			}
+			m_meshInterface->unLockReadOnlyVertexBase(nodeSubPart);
+		}
+	};
+
+	MyNodeRayPacketCallback	myNodeCallback(callbacks,m_meshInterface,packet);
+
+	m_bvh->reportRayPacketOverlappingNodes(&myNodeCallback,packet);
+}
+
 void	btBvhTriangleMeshShape::performConvexcast (btTriangleCallback* callback, const btVector3& raySource, const btVector3& rayTarget, const btVector3& aabbMin, const btVector3& aabbMax)
 {
 	struct	MyNodeOverlapCallback : public btNodeOverlapCallback
@@ -21,6 +21,8 @@ subject to the following restrictions:
 #include "btAlignedAllocator.h"
 #include "btTriangleInfoMap.h"
 
+class btTriangleRaycastCallback;
+
 ///The btBvhTriangleMeshShape is a static-triangle mesh shape with several optimizations, such as bounding volume hierarchy and cache friendly traversal for PlayStation 3 Cell SPU. It is recommended to enable useQuantizedAabbCompression for better memory usage.
 ///It takes a triangle mesh as input, for example a btTriangleMesh or btTriangleIndexVertexArray. The btBvhTriangleMeshShape class allows for triangle mesh deformations by a refit or partialRefit method.
 ///Instead of building the bounding volume hierarchy acceleration structure, it is also possible to serialize (save) and deserialize (load) the structure from disk.
@@ -57,6 +59,10 @@ public:
 	void performRaycast (btTriangleCallback* callback, const btVector3& raySource, const btVector3& rayTarget);
 	void performConvexcast (btTriangleCallback* callback, const btVector3& boxSource, const btVector3& boxTarget, const btVector3& boxMin, const btVector3& boxMax);
 
+	///performRaycast for a packet of rays in the local space of the shape, lane i is tested with callbacks[i] while the tree is walked once.
+	///m_lambdaMax of a lane follows m_hitFraction of its callback, so the walk only visits triangles closer than the closest hit so far.
+	void performRaycastPacket (btTriangleRaycastCallback* const* callbacks, btRayPacket& packet) const;
+
 	virtual void	processAllTriangles(btTriangleCallback* callback,const btVector3& aabbMin,const btVector3& aabbMax) const;
 
 	void	refitTree(const btVector3& aabbMin,const btVector3& aabbMax);
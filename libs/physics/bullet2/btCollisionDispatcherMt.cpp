@@ -0,0 +1,321 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2012 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include "btCollisionDispatcherMt.h"
+
+#include "btCollisionShape.h"
+#include "btCollisionObject.h"
+#include "btOverlappingPairCache.h"
+#include "btPoolAllocator.h"
+#include "btCollisionConfiguration.h"
+
+
+class btManifoldEventSortPredicate
+{
+	public:
+
+		SIMD_FORCE_INLINE bool operator() ( const btCollisionDispatcherMt::btManifoldEvent& lhs, const btCollisionDispatcherMt::btManifoldEvent& rhs ) const
+		{
+			if (lhs.m_pairIndex != rhs.m_pairIndex)
+				return lhs.m_pairIndex < rhs.m_pairIndex;
+			return lhs.m_sequence < rhs.m_sequence;
+		}
+};
+
+
+struct btDispatchPairsLoop : public btIParallelForBody
+{
+	btCollisionDispatcherMt*	m_dispatcher;
+	btBroadphasePair*			m_pairs;
+	const btDispatcherInfo&		m_dispatchInfo;
+
+	btDispatchPairsLoop(btCollisionDispatcherMt* dispatcher,btBroadphasePair* pairs,const btDispatcherInfo& dispatchInfo)
+		:m_dispatcher(dispatcher),
+		m_pairs(pairs),
+		m_dispatchInfo(dispatchInfo)
+	{
+	}
+
+	void	forLoop(int iBegin,int iEnd) const
+	{
+		for (int i=iBegin;i<iEnd;i++)
+		{
+			btBroadphasePair& pair = m_pairs[i];
+			btCollisionObject* colObj0 = (btCollisionObject*)pair.m_pProxy0->m_clientObject;
+			btCollisionObject* colObj1 = (btCollisionObject*)pair.m_pProxy1->m_clientObject;
+			if (m_dispatcher->canProcessConcurrently(colObj0,colObj1))
+			{
+				m_dispatcher->processPair(pair,i,m_dispatchInfo);
+			}
+		}
+	}
+
+private:
+	btDispatchPairsLoop& operator=(const btDispatchPairsLoop&);
+};
+
+
+btCollisionDispatcherMt::btCollisionDispatcherMt(btCollisionConfiguration* collisionConfiguration, int grainSize)
+:btCollisionDispatcher(collisionConfiguration),
+m_grainSize(grainSize),
+m_batchUpdating(false)
+{
+	//the main thread keeps using the pool of the collision configuration
+	m_threadStates[0].m_manifoldPool = m_persistentManifoldPoolAllocator;
+	m_threadManifoldPoolSize = btMax(64,m_persistentManifoldPoolAllocator->getMaxCount()/4);
+}
+
+btCollisionDispatcherMt::~btCollisionDispatcherMt()
+{
+	for (int i=1;i<BT_MAX_THREAD_COUNT;i++)
+	{
+		if (m_threadStates[i].m_manifoldPool)
+		{
+			m_threadStates[i].m_manifoldPool->~btPoolAllocator();
+			btAlignedFree(m_threadStates[i].m_manifoldPool);
+		}
+	}
+}
+
+btPersistentManifold*	btCollisionDispatcherMt::getNewManifold(void* b0,void* b1)
+{
+	btCollisionObject* body0 = (btCollisionObject*)b0;
+	btCollisionObject* body1 = (btCollisionObject*)b1;
+
+	btScalar contactBreakingThreshold =  (m_dispatcherFlags & btCollisionDispatcher::CD_USE_RELATIVE_CONTACT_BREAKING_THRESHOLD) ?
+		btMin(body0->getCollisionShape()->getContactBreakingThreshold(gContactBreakingThreshold) , body1->getCollisionShape()->getContactBreakingThreshold(gContactBreakingThreshold))
+		: gContactBreakingThreshold ;
+
+	btScalar contactProcessingThreshold = btMin(body0->getContactProcessingThreshold(),body1->getContactProcessingThreshold());
+
+	btThreadState& threadState = m_threadStates[btGetCurrentThreadIndex()];
+	void* mem = 0;
+	if (threadState.m_manifoldPool)
+	{
+		threadState.m_poolMutex.lock();
+		if (threadState.m_manifoldPool->getFreeCount())
+		{
+			mem = threadState.m_manifoldPool->allocate(sizeof(btPersistentManifold));
+		}
+		threadState.m_poolMutex.unlock();
+	}
+	if (!mem)
+	{
+		if ((m_dispatcherFlags&CD_DISABLE_CONTACTPOOL_DYNAMIC_ALLOCATION)==0)
+		{
+			mem = btAlignedAlloc(sizeof(btPersistentManifold),16);
+		} else
+		{
+			btAssert(0);
+			return 0;
+		}
+	}
+	btPersistentManifold* manifold = new(mem) btPersistentManifold (body0,body1,0,contactBreakingThreshold,contactProcessingThreshold);
+
+	if (m_batchUpdating)
+	{
+		//other threads may be using the manifold array, finishBatch adds it in pair order
+		manifold->m_index1a = -1;
+		addManifoldEvent(manifold,false);
+	} else
+	{
+		manifold->m_index1a = m_manifoldsPtr.size();
+		m_manifoldsPtr.push_back(manifold);
+	}
+	return manifold;
+}
+
+void	btCollisionDispatcherMt::releaseManifold(btPersistentManifold* manifold)
+{
+	clearManifold(manifold);
+
+	if (m_batchUpdating)
+	{
+		addManifoldEvent(manifold,true);
+		return;
+	}
+
+	int findIndex = manifold->m_index1a;
+	btAssert(findIndex < m_manifoldsPtr.size());
+	m_manifoldsPtr.swap(findIndex,m_manifoldsPtr.size()-1);
+	m_manifoldsPtr[findIndex]->m_index1a = findIndex;
+	m_manifoldsPtr.pop_back();
+
+	destroyManifold(manifold);
+}
+
+void	btCollisionDispatcherMt::addManifoldEvent(btPersistentManifold* manifold,bool release)
+{
+	btThreadState& threadState = m_threadStates[btGetCurrentThreadIndex()];
+	btManifoldEvent& manifoldEvent = threadState.m_manifoldEvents.expandNonInitializing();
+	manifoldEvent.m_manifold = manifold;
+	manifoldEvent.m_pairIndex = threadState.m_pairIndex;
+	manifoldEvent.m_sequence = threadState.m_sequence++;
+	manifoldEvent.m_release = release;
+}
+
+void	btCollisionDispatcherMt::destroyManifold(btPersistentManifold* manifold)
+{
+	manifold->~btPersistentManifold();
+
+	for (int i=0;i<BT_MAX_THREAD_COUNT;i++)
+	{
+		btThreadState& threadState = m_threadStates[i];
+		if (threadState.m_manifoldPool && threadState.m_manifoldPool->validPtr(manifold))
+		{
+			threadState.m_poolMutex.lock();
+			threadState.m_manifoldPool->freeMemory(manifold);
+			threadState.m_poolMutex.unlock();
+			return;
+		}
+	}
+	btAlignedFree(manifold);
+}
+
+void*	btCollisionDispatcherMt::allocateCollisionAlgorithm(int size)
+{
+	void* mem = 0;
+	m_algorithmPoolMutex.lock();
+	if (m_collisionAlgorithmPoolAllocator->getFreeCount())
+	{
+		mem = m_collisionAlgorithmPoolAllocator->allocate(size);
+	}
+	m_algorithmPoolMutex.unlock();
+
+	if (!mem)
+	{
+		mem = btAlignedAlloc(static_cast<size_t>(size), 16);
+	}
+	return mem;
+}
+
+void	btCollisionDispatcherMt::freeCollisionAlgorithm(void* ptr)
+{
+	if (m_collisionAlgorithmPoolAllocator->validPtr(ptr))
+	{
+		m_algorithmPoolMutex.lock();
+		m_collisionAlgorithmPoolAllocator->freeMemory(ptr);
+		m_algorithmPoolMutex.unlock();
+	} else
+	{
+		btAlignedFree(ptr);
+	}
+}
+
+bool	btCollisionDispatcherMt::canProcessConcurrently(btCollisionObject* body0,btCollisionObject* body1)
+{
+	int type0 = body0->getCollisionShape()->getShapeType();
+	int type1 = body1->getCollisionShape()->getShapeType();
+	return (btBroadphaseProxy::isConvex(type0) || btBroadphaseProxy::isInfinite(type0)) &&
+		(btBroadphaseProxy::isConvex(type1) || btBroadphaseProxy::isInfinite(type1));
+}
+
+void	btCollisionDispatcherMt::processPair(btBroadphasePair& pair,int pairIndex,const btDispatcherInfo& dispatchInfo)
+{
+	m_threadStates[btGetCurrentThreadIndex()].m_pairIndex = pairIndex;
+	(*getNearCallback())(pair,*this,dispatchInfo);
+}
+
+void	btCollisionDispatcherMt::dispatchAllCollisionPairs(btOverlappingPairCache* pairCache,const btDispatcherInfo& dispatchInfo,btDispatcher* dispatcher)
+{
+	if (dispatchInfo.m_dispatchFunc != btDispatcherInfo::DISPATCH_DISCRETE)
+	{
+		//time of impact queries reduce into the dispatch info, keep those serial
+		btCollisionDispatcher::dispatchAllCollisionPairs(pairCache,dispatchInfo,dispatcher);
+		return;
+	}
+
+	int numPairs = pairCache->getNumOverlappingPairs();
+	if (!numPairs)
+		return;
+	btBroadphasePair* pairs = pairCache->getOverlappingPairArrayPtr();
+
+	int numThreads = btGetTaskSchedulerThreadCount();
+	for (int i=1;i<numThreads;i++)
+	{
+		if (!m_threadStates[i].m_manifoldPool)
+		{
+			void* mem = btAlignedAlloc(sizeof(btPoolAllocator),16);
+			m_threadStates[i].m_manifoldPool = new (mem) btPoolAllocator(sizeof(btPersistentManifold),m_threadManifoldPoolSize);
+		}
+	}
+
+	m_batchUpdating = true;
+
+	btDispatchPairsLoop loop(this,pairs,dispatchInfo);
+	btParallelFor(0,numPairs,m_grainSize,loop);
+
+	for (int i=0;i<numPairs;i++)
+	{
+		btCollisionObject* colObj0 = (btCollisionObject*)pairs[i].m_pProxy0->m_clientObject;
+		btCollisionObject* colObj1 = (btCollisionObject*)pairs[i].m_pProxy1->m_clientObject;
+		if (!canProcessConcurrently(colObj0,colObj1))
+		{
+			processPair(pairs[i],i,dispatchInfo);
+		}
+	}
+
+	m_batchUpdating = false;
+
+	finishBatch();
+}
+
+void	btCollisionDispatcherMt::finishBatch()
+{
+	int i,j;
+
+	m_sortedManifoldEvents.resize(0);
+	for (i=0;i<BT_MAX_THREAD_COUNT;i++)
+	{
+		btThreadState& threadState = m_threadStates[i];
+		for (j=0;j<threadState.m_manifoldEvents.size();j++)
+		{
+			m_sortedManifoldEvents.push_back(threadState.m_manifoldEvents[j]);
+		}
+		threadState.m_manifoldEvents.resize(0);
+		threadState.m_sequence = 0;
+	}
+	if (!m_sortedManifoldEvents.size())
+		return;
+
+	//replay in the order btCollisionDispatcher would have seen them, a pair is always processed by a single thread
+	m_sortedManifoldEvents.quickSort(btManifoldEventSortPredicate());
+	for (i=0;i<m_sortedManifoldEvents.size();i++)
+	{
+		btPersistentManifold* manifold = m_sortedManifoldEvents[i].m_manifold;
+		if (m_sortedManifoldEvents[i].m_release)
+		{
+			releaseManifold(manifold);
+		} else
+		{
+			manifold->m_index1a = m_manifoldsPtr.size();
+			m_manifoldsPtr.push_back(manifold);
+		}
+	}
+}
+
+btSimplexSolverInterface*	btGetThreadSimplexSolver(btSimplexSolverInterface* simplexSolver)
+{
+	static btSimplexSolverInterface sThreadSimplexSolvers[BT_MAX_THREAD_COUNT];
+
+	int threadIndex = btGetCurrentThreadIndex();
+	if (threadIndex == 0 || !btThreadsAreRunning())
+		return simplexSolver;
+
+	btSimplexSolverInterface* threadSolver = &sThreadSimplexSolvers[threadIndex];
+	threadSolver->setEqualVertexThreshold(simplexSolver->getEqualVertexThreshold());
+	return threadSolver;
+}
@@ -0,0 +1,116 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2012 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef BT_COLLISION_DISPATCHER_MT_H
+#define BT_COLLISION_DISPATCHER_MT_H
+
+#include "btCollisionDispatcher.h"
+#include "btThreads.h"
+#include "btSimplexSolverInterface.h"
+
+///btCollisionDispatcherMt processes the overlapping pair array in chunks on the btTaskScheduler (see btThreads.h).
+///Each thread allocates new manifolds from its own pool. Manifolds created and released while the pairs are processed are
+///added to and removed from the manifold array afterwards, in pair order, so the result is the same as with btCollisionDispatcher for any number of threads.
+///Compound and concave pairs temporarily swap the collision shape of a shared object, they run on the calling thread after the parallel loop.
+///A custom near callback and the global contact added/processed/destroyed callbacks have to be thread-safe.
+class btCollisionDispatcherMt : public btCollisionDispatcher
+{
+	struct btManifoldEvent
+	{
+		btPersistentManifold*	m_manifold;
+		int						m_pairIndex;
+		int						m_sequence;
+		bool					m_release;
+	};
+
+	struct btThreadState
+	{
+		btSpinMutex		m_poolMutex;
+		btPoolAllocator*	m_manifoldPool;
+		int				m_pairIndex;
+		int				m_sequence;
+		btAlignedObjectArray<btManifoldEvent>	m_manifoldEvents;
+		char			m_padding[64];
+
+		btThreadState()
+			:m_manifoldPool(0),
+			m_pairIndex(0),
+			m_sequence(0)
+		{
+		}
+	};
+
+	btThreadState	m_threadStates[BT_MAX_THREAD_COUNT];
+
+	btAlignedObjectArray<btManifoldEvent>	m_sortedManifoldEvents;
+
+	btSpinMutex		m_algorithmPoolMutex;
+
+	int				m_grainSize;
+
+	int				m_threadManifoldPoolSize;
+
+	bool			m_batchUpdating;
+
+	void	addManifoldEvent(btPersistentManifold* manifold,bool release);
+
+	void	destroyManifold(btPersistentManifold* manifold);
+
+	void	finishBatch();
+
+	friend struct btDispatchPairsLoop;
+	friend class btManifoldEventSortPredicate;
+
+protected:
+
+	///runs the near callback for the pair at pairIndex, new manifolds are ordered by that index
+	void	processPair(btBroadphasePair& pair,int pairIndex,const btDispatcherInfo& dispatchInfo);
+
+public:
+
+	btCollisionDispatcherMt(btCollisionConfiguration* collisionConfiguration, int grainSize = 40);
+
+	virtual ~btCollisionDispatcherMt();
+
+	virtual btPersistentManifold*	getNewManifold(void* b0,void* b1);
+
+	virtual void	releaseManifold(btPersistentManifold* manifold);
+
+	virtual	void*	allocateCollisionAlgorithm(int size);
+
+	virtual	void	freeCollisionAlgorithm(void* ptr);
+
+	virtual void	dispatchAllCollisionPairs(btOverlappingPairCache* pairCache,const btDispatcherInfo& dispatchInfo,btDispatcher* dispatcher);
+
+	///convex-convex and convex-plane pairs run on the worker threads, everything else modifies one of the objects while processing and runs serially
+	virtual bool	canProcessConcurrently(btCollisionObject* body0,btCollisionObject* body1);
+
+	int		getGrainSize() const
+	{
+		return m_grainSize;
+	}
+
+	void	setGrainSize(int grainSize)
+	{
+		m_grainSize = grainSize;
+	}
+};
+
+///returns the simplex solver a collision algorithm should use on the calling thread.
+///That is simplexSolver itself outside of a parallel loop and on thread 0, worker threads get their own instance with the same settings.
+btSimplexSolverInterface*	btGetThreadSimplexSolver(btSimplexSolverInterface* simplexSolver);
+
+#endif //BT_COLLISION_DISPATCHER_MT_H
@@ -34,9 +34,13 @@ subject to the following restrictions:
 #include "btStackAlloc.h"
 #include "btSerializer.h"
 #include "btConvexPolyhedron.h"
+#include "btThreads.h"
 
 //#define DISABLE_DBVT_COMPOUNDSHAPE_RAYCAST_ACCELERATION
 
+///packets of rayTestBatch and convexSweepTestBatch handed to a thread at a time
+#define BT_BATCHED_QUERY_GRAIN_SIZE 4
+
 
 //#define USE_BRUTEFORCE_RAYBROADPHASE 1
 //RECALCULATE_AABB is slower, but benefit is that you don't need to call 'stepSimulation'  or 'updateAabbs' before using a rayTest
@@ -1039,6 +1043,599 @@ void	btCollisionWorld::convexSweepTest(const btConvexShape* castShape, const btT
 
 
 
+///rayTestSingle without the temporary collision shape it sets on the object for compound children, batches query an object from several threads
+static void	btBatchedRayTestSingle(const btTransform& rayFromTrans,const btTransform& rayToTrans,
+										btCollisionObject* collisionObject,
+										const btCollisionShape* collisionShape,
+										const btTransform& colObjWorldTransform,
+										btCollisionWorld::RayResultCallback& resultCallback)
+{
+	if (!collisionShape->isCompound())
+	{
+		btCollisionWorld::rayTestSingle(rayFromTrans,rayToTrans,collisionObject,collisionShape,colObjWorldTransform,resultCallback);
+		return;
+	}
+
+	struct LocalInfoAdder : public btCollisionWorld::RayResultCallback
+	{
+		btCollisionWorld::RayResultCallback* m_userCallback;
+		int m_i;
+
+		LocalInfoAdder (int i, btCollisionWorld::RayResultCallback *user)
+			: m_userCallback(user), m_i(i)
+		{
+			m_closestHitFraction = m_userCallback->m_closestHitFraction;
+		}
+		virtual bool needsCollision(btBroadphaseProxy* p) const
+		{
+			return m_userCallback->needsCollision(p);
+		}
+
+		virtual btScalar addSingleResult (btCollisionWorld::LocalRayResult &r, bool b)
+		{
+			btCollisionWorld::LocalShapeInfo shapeInfo;
+			shapeInfo.m_shapePart = -1;
+			shapeInfo.m_triangleIndex = m_i;
+			if (r.m_localShapeInfo == NULL)
+				r.m_localShapeInfo = &shapeInfo;
+
+			const btScalar result = m_userCallback->addSingleResult(r, b);
+			m_closestHitFraction = m_userCallback->m_closestHitFraction;
+			return result;
+		}
+	};
+
+	struct ChildRayTester : btDbvt::ICollide
+	{
+		btCollisionObject* m_collisionObject;
+		const btCompoundShape* m_compoundShape;
+		const btTransform& m_colObjWorldTransform;
+		const btTransform& m_rayFromTrans;
+		const btTransform& m_rayToTrans;
+		btCollisionWorld::RayResultCallback& m_resultCallback;
+
+		ChildRayTester(btCollisionObject* collisionObject,
+				const btCompoundShape* compoundShape,
+				const btTransform& colObjWorldTransform,
+				const btTransform& rayFromTrans,
+				const btTransform& rayToTrans,
+				btCollisionWorld::RayResultCallback& resultCallback):
+			m_collisionObject(collisionObject),
+			m_compoundShape(compoundShape),
+			m_colObjWorldTransform(colObjWorldTransform),
+			m_rayFromTrans(rayFromTrans),
+			m_rayToTrans(rayToTrans),
+			m_resultCallback(resultCallback)
+		{
+		}
+
+		void Process(int i)
+		{
+			btTransform childWorldTrans = m_colObjWorldTransform * m_compoundShape->getChildTransform(i);
+			LocalInfoAdder my_cb(i, &m_resultCallback);
+			btBatchedRayTestSingle(m_rayFromTrans,m_rayToTrans,m_collisionObject,m_compoundShape->getChildShape(i),childWorldTrans,my_cb);
+		}
+
+		void Process(const btDbvtNode* leaf)
+		{
+			Process(leaf->dataAsInt);
+		}
+	};
+
+	const btCompoundShape* compoundShape = static_cast<const btCompoundShape*>(collisionShape);
+	const btDbvt* dbvt = compoundShape->getDynamicAabbTree();
+	ChildRayTester rayCB(collisionObject,compoundShape,colObjWorldTransform,rayFromTrans,rayToTrans,resultCallback);
+#ifndef	DISABLE_DBVT_COMPOUNDSHAPE_RAYCAST_ACCELERATION
+	if (dbvt)
+	{
+		btVector3 localRayFrom = colObjWorldTransform.inverseTimes(rayFromTrans).getOrigin();
+		btVector3 localRayTo = colObjWorldTransform.inverseTimes(rayToTrans).getOrigin();
+		btDbvt::rayTest(dbvt->m_root, localRayFrom , localRayTo, rayCB);
+	}
+	else
+#endif //DISABLE_DBVT_COMPOUNDSHAPE_RAYCAST_ACCELERATION
+	{
+		for (int i = 0, n = compoundShape->getNumChildShapes(); i < n; ++i)
+		{
+			rayCB.Process(i);
+		}
+	}
+}
+
+///objectQuerySingle without the temporary collision shape for compound children, see btBatchedRayTestSingle
+static void	btBatchedObjectQuerySingle(const btConvexShape* castShape,const btTransform& convexFromTrans,const btTransform& convexToTrans,
+											btCollisionObject* collisionObject,
+											const btCollisionShape* collisionShape,
+											const btTransform& colObjWorldTransform,
+											btCollisionWorld::ConvexResultCallback& resultCallback, btScalar allowedPenetration)
+{
+	if (!collisionShape->isCompound())
+	{
+		btCollisionWorld::objectQuerySingle(castShape,convexFromTrans,convexToTrans,collisionObject,collisionShape,colObjWorldTransform,resultCallback,allowedPenetration);
+		return;
+	}
+
+	struct	LocalInfoAdder : public btCollisionWorld::ConvexResultCallback
+	{
+		btCollisionWorld::ConvexResultCallback* m_userCallback;
+		int m_i;
+
+		LocalInfoAdder (int i, btCollisionWorld::ConvexResultCallback *user)
+			: m_userCallback(user), m_i(i)
+		{
+			m_closestHitFraction = m_userCallback->m_closestHitFraction;
+		}
+		virtual bool needsCollision(btBroadphaseProxy* p) const
+		{
+			return m_userCallback->needsCollision(p);
+		}
+		virtual btScalar addSingleResult (btCollisionWorld::LocalConvexResult&	r,	bool b)
+		{
+			btCollisionWorld::LocalShapeInfo	shapeInfo;
+			shapeInfo.m_shapePart = -1;
+			shapeInfo.m_triangleIndex = m_i;
+			if (r.m_localShapeInfo == NULL)
+				r.m_localShapeInfo = &shapeInfo;
+			const btScalar result = m_userCallback->addSingleResult(r, b);
+			m_closestHitFraction = m_userCallback->m_closestHitFraction;
+			return result;
+		}
+	};
+
+	const btCompoundShape* compoundShape = static_cast<const btCompoundShape*>(collisionShape);
+	for (int i=0;i<compoundShape->getNumChildShapes();i++)
+	{
+		btTransform childWorldTrans = colObjWorldTransform * compoundShape->getChildTransform(i);
+		LocalInfoAdder my_cb(i, &resultCallback);
+		btBatchedObjectQuerySingle(castShape,convexFromTrans,convexToTrans,collisionObject,compoundShape->getChildShape(i),childWorldTrans,my_cb,allowedPenetration);
+	}
+}
+
+///closest hit of one ray of rayTestBatch, including the part and triangle of the hit
+struct btBatchedClosestRayCallback : public btCollisionWorld::ClosestRayResultCallback
+{
+	int	m_shapePart;
+	int	m_triangleIndex;
+
+	btBatchedClosestRayCallback()
+		:ClosestRayResultCallback(btVector3(0,0,0),btVector3(0,0,0)),
+		m_shapePart(-1),
+		m_triangleIndex(-1)
+	{
+	}
+
+	virtual	btScalar	addSingleResult(btCollisionWorld::LocalRayResult& rayResult,bool normalInWorldSpace)
+	{
+		m_shapePart = rayResult.m_localShapeInfo ? rayResult.m_localShapeInfo->m_shapePart : -1;
+		m_triangleIndex = rayResult.m_localShapeInfo ? rayResult.m_localShapeInfo->m_triangleIndex : -1;
+		return ClosestRayResultCallback::addSingleResult(rayResult,normalInWorldSpace);
+	}
+};
+
+///closest hit of one sweep of convexSweepTestBatch
+struct btBatchedClosestConvexCallback : public btCollisionWorld::ClosestConvexResultCallback
+{
+	int	m_shapePart;
+	int	m_triangleIndex;
+
+	btBatchedClosestConvexCallback()
+		:ClosestConvexResultCallback(btVector3(0,0,0),btVector3(0,0,0)),
+		m_shapePart(-1),
+		m_triangleIndex(-1)
+	{
+	}
+
+	virtual	btScalar	addSingleResult(btCollisionWorld::LocalConvexResult& convexResult,bool normalInWorldSpace)
+	{
+		m_shapePart = convexResult.m_localShapeInfo ? convexResult.m_localShapeInfo->m_shapePart : -1;
+		m_triangleIndex = convexResult.m_localShapeInfo ? convexResult.m_localShapeInfo->m_triangleIndex : -1;
+		return ClosestConvexResultCallback::addSingleResult(convexResult,normalInWorldSpace);
+	}
+};
+
+///lane of a btBvhTriangleMeshShape packet walk, reports like the BridgeTriangleRaycastCallback of rayTestSingle
+struct btBatchedTriangleRaycastCallback : public btTriangleRaycastCallback
+{
+	btCollisionWorld::RayResultCallback*	m_resultCallback;
+	btCollisionObject*	m_collisionObject;
+	const btTransform*	m_colObjWorldTransform;
+
+	btBatchedTriangleRaycastCallback()
+		:btTriangleRaycastCallback(btVector3(0,0,0),btVector3(0,0,0)),
+		m_resultCallback(0),
+		m_collisionObject(0),
+		m_colObjWorldTransform(0)
+	{
+	}
+
+	virtual btScalar reportHit(const btVector3& hitNormalLocal, btScalar hitFraction, int partId, int triangleIndex )
+	{
+		btCollisionWorld::LocalShapeInfo	shapeInfo;
+		shapeInfo.m_shapePart = partId;
+		shapeInfo.m_triangleIndex = triangleIndex;
+
+		btVector3 hitNormalWorld = m_colObjWorldTransform->getBasis() * hitNormalLocal;
+
+		btCollisionWorld::LocalRayResult rayResult
+			(m_collisionObject,
+			&shapeInfo,
+			hitNormalWorld,
+			hitFraction);
+
+		bool	normalInWorldSpace = true;
+		return m_resultCallback->addSingleResult(rayResult,normalInWorldSpace);
+	}
+};
+
+struct btBatchedQueryKey
+{
+	unsigned int	m_key;
+	int				m_query;
+};
+
+struct btBatchedQueryKeySortPredicate
+{
+	bool operator() ( const btBatchedQueryKey& a, const btBatchedQueryKey& b ) const
+	{
+		return a.m_key < b.m_key || (a.m_key == b.m_key && a.m_query < b.m_query);
+	}
+};
+
+///spreads the low 10 bits so that there are two zero bits between them
+static SIMD_FORCE_INLINE unsigned int	btSpreadMortonBits(unsigned int v)
+{
+	v = (v | (v << 16)) & 0x030000FF;
+	v = (v | (v << 8)) & 0x0300F00F;
+	v = (v | (v << 4)) & 0x030C30C3;
+	v = (v | (v << 2)) & 0x09249249;
+	return v;
+}
+
+///sorts the queries by direction octant and then along a Morton curve through their origins, so that the
+///queries of a packet start close to each other and walk the trees in the same direction
+static void	btSortBatchedQueries(const btVector3* from,const btVector3* to,int numQueries,btAlignedObjectArray<int>& order)
+{
+	btVector3 originMin = from[0];
+	btVector3 originMax = from[0];
+	for (int i=1;i<numQueries;i++)
+	{
+		originMin.setMin(from[i]);
+		originMax.setMax(from[i]);
+	}
+	btVector3 extent = originMax-originMin;
+	btVector3 scale;
+	for (int k=0;k<3;k++)
+		scale[k] = extent[k] > SIMD_EPSILON ? btScalar(1023.)/extent[k] : btScalar(0.);
+
+	btAlignedObjectArray<btBatchedQueryKey> keys;
+	keys.resize(numQueries);
+	for (int i=0;i<numQueries;i++)
+	{
+		btVector3 cell = (from[i]-originMin)*scale;
+		btVector3 direction = to[i]-from[i];
+		unsigned int octant = (direction.getX() < btScalar(0.) ? 1 : 0) | (direction.getY() < btScalar(0.) ? 2 : 0) | (direction.getZ() < btScalar(0.) ? 4 : 0);
+		keys[i].m_key = (octant << 30) |
+			btSpreadMortonBits((unsigned int)cell.getX()) |
+			(btSpreadMortonBits((unsigned int)cell.getY()) << 1) |
+			(btSpreadMortonBits((unsigned int)cell.getZ()) << 2);
+		keys[i].m_query = i;
+	}
+	keys.quickSort(btBatchedQueryKeySortPredicate());
+
+	order.resize(numQueries);
+	for (int i=0;i<numQueries;i++)
+		order[i] = keys[i].m_query;
+}
+
+///narrowphase for the objects a packet of rayTestBatch hits in the broadphase
+struct btBatchedRayPacketCallback : public btBroadphaseRayPacketCallback
+{
+	btRayPacket&	m_packet;
+	btBatchedClosestRayCallback*	m_callbacks;
+
+	btBatchedRayPacketCallback(btRayPacket& packet,btBatchedClosestRayCallback* callbacks)
+		:m_packet(packet),
+		m_callbacks(callbacks)
+	{
+	}
+
+	virtual void	process(const btBroadphaseProxy* proxy,int rayMask)
+	{
+		btCollisionObject*	collisionObject = (btCollisionObject*)proxy->m_clientObject;
+		const btCollisionShape* collisionShape = collisionObject->getCollisionShape();
+		const btTransform& colObjWorldTransform = collisionObject->getWorldTransform();
+
+		//lanes with a hit at zero are done, like in btSingleRayCallback
+		int laneMask = 0;
+		for (int lane=0;lane<BT_RAY_PACKET_SIZE;lane++)
+		{
+			if ((rayMask & (1<<lane)) &&
+				m_callbacks[lane].m_closestHitFraction > btScalar(0.) &&
+				m_callbacks[lane].needsCollision(collisionObject->getBroadphaseHandle()))
+			{
+				laneMask |= 1<<lane;
+			}
+		}
+		if (!laneMask)
+			return;
+
+		if (collisionShape->getShapeType()==TRIANGLE_MESH_SHAPE_PROXYTYPE && (laneMask & (laneMask-1)))
+		{
+			//several lanes hit the mesh, walk its tree once for all of them
+			const btBvhTriangleMeshShape* triangleMesh = (const btBvhTriangleMeshShape*)collisionShape;
+			btTransform worldTocollisionObject = colObjWorldTransform.inverse();
+			btRayPacket localPacket;
+			btBatchedTriangleRaycastCallback bridges[BT_RAY_PACKET_SIZE];
+			btTriangleRaycastCallback* triangleCallbacks[BT_RAY_PACKET_SIZE];
+			for (int lane=0;lane<BT_RAY_PACKET_SIZE;lane++)
+			{
+				triangleCallbacks[lane] = &bridges[lane];
+				if (!(laneMask & (1<<lane)))
+					continue;
+				btBatchedClosestRayCallback& resultCallback = m_callbacks[lane];
+				btBatchedTriangleRaycastCallback& bridge = bridges[lane];
+				bridge.m_from = worldTocollisionObject * resultCallback.m_rayFromWorld;
+				bridge.m_to = worldTocollisionObject * resultCallback.m_rayToWorld;
+				bridge.m_flags = resultCallback.m_flags;
+				bridge.m_hitFraction = resultCallback.m_closestHitFraction;
+				bridge.m_resultCallback = &resultCallback;
+				bridge.m_collisionObject = collisionObject;
+				bridge.m_colObjWorldTransform = &colObjWorldTransform;
+				localPacket.setRay(lane,bridge.m_from,bridge.m_to);
+				localPacket.m_lambdaMax[lane] = resultCallback.m_closestHitFraction;
+			}
+			triangleMesh->performRaycastPacket(triangleCallbacks,localPacket);
+		} else
+		{
+			for (int lane=0;lane<BT_RAY_PACKET_SIZE;lane++)
+			{
+				if (!(laneMask & (1<<lane)))
+					continue;
+				btBatchedClosestRayCallback& resultCallback = m_callbacks[lane];
+				btTransform rayFromTrans(btMatrix3x3::getIdentity(),resultCallback.m_rayFromWorld);
+				btTransform rayToTrans(btMatrix3x3::getIdentity(),resultCallback.m_rayToWorld);
+				btBatchedRayTestSingle(rayFromTrans,rayToTrans,collisionObject,collisionShape,colObjWorldTransform,resultCallback);
+			}
+		}
+
+		for (int lane=0;lane<BT_RAY_PACKET_SIZE;lane++)
+		{
+			if (laneMask & (1<<lane))
+				m_packet.m_lambdaMax[lane] = m_callbacks[lane].m_closestHitFraction;
+		}
+	}
+};
+
+struct btRayTestBatchLoop : public btIParallelForBody
+{
+	btBroadphaseInterface*	m_broadphase;
+	const btVector3*	m_rayFromWorld;
+	const btVector3*	m_rayToWorld;
+	const int*	m_order;
+	int			m_numRays;
+	btCollisionWorld::BatchedQueryResult*	m_results;
+	short int	m_collisionFilterGroup;
+	short int	m_collisionFilterMask;
+
+	void	forLoop(int iBegin,int iEnd) const
+	{
+		for (int packetIndex=iBegin;packetIndex<iEnd;packetIndex++)
+		{
+			btRayPacket packet;
+			btBatchedClosestRayCallback callbacks[BT_RAY_PACKET_SIZE];
+			int firstRay = packetIndex*BT_RAY_PACKET_SIZE;
+			int numLanes = btMin(m_numRays-firstRay,int(BT_RAY_PACKET_SIZE));
+			for (int lane=0;lane<numLanes;lane++)
+			{
+				int ray = m_order[firstRay+lane];
+				btBatchedClosestRayCallback& resultCallback = callbacks[lane];
+				resultCallback.m_rayFromWorld = m_rayFromWorld[ray];
+				resultCallback.m_rayToWorld = m_rayToWorld[ray];
+				resultCallback.m_collisionFilterGroup = m_collisionFilterGroup;
+				resultCallback.m_collisionFilterMask = m_collisionFilterMask;
+				packet.setRay(lane,m_rayFromWorld[ray],m_rayToWorld[ray]);
+			}
+
+			btBatchedRayPacketCallback packetCallback(packet,callbacks);
+			m_broadphase->rayTestPacket(packet,packetCallback);
+
+			for (int lane=0;lane<numLanes;lane++)
+			{
+				const btBatchedClosestRayCallback& resultCallback = callbacks[lane];
+				btCollisionWorld::BatchedQueryResult& result = m_results[m_order[firstRay+lane]];
+				result.m_collisionObject = resultCallback.m_collisionObject;
+				result.m_hitFraction = resultCallback.m_closestHitFraction;
+				result.m_shapePart = resultCallback.m_shapePart;
+				result.m_triangleIndex = resultCallback.m_triangleIndex;
+				if (resultCallback.hasHit())
+				{
+					result.m_hitPointWorld = resultCallback.m_hitPointWorld;
+					result.m_hitNormalWorld = resultCallback.m_hitNormalWorld;
+				} else
+				{
+					result.m_hitPointWorld = resultCallback.m_rayToWorld;
+					result.m_hitNormalWorld.setValue(0,0,0);
+				}
+			}
+		}
+	}
+};
+
+void	btCollisionWorld::rayTestBatch(const btVector3* rayFromWorld, const btVector3* rayToWorld, int numRays, BatchedQueryResult* results, short int collisionFilterGroup, short int collisionFilterMask) const
+{
+	BT_PROFILE("rayTestBatch");
+	if (numRays <= 0)
+		return;
+
+	btAlignedObjectArray<int> order;
+	btSortBatchedQueries(rayFromWorld,rayToWorld,numRays,order);
+
+	btRayTestBatchLoop loop;
+	loop.m_broadphase = m_broadphasePairCache;
+	loop.m_rayFromWorld = rayFromWorld;
+	loop.m_rayToWorld = rayToWorld;
+	loop.m_order = &order[0];
+	loop.m_numRays = numRays;
+	loop.m_results = results;
+	loop.m_collisionFilterGroup = collisionFilterGroup;
+	loop.m_collisionFilterMask = collisionFilterMask;
+	int numPackets = (numRays+BT_RAY_PACKET_SIZE-1)/BT_RAY_PACKET_SIZE;
+	btParallelFor(0,numPackets,BT_BATCHED_QUERY_GRAIN_SIZE,loop);
+}
+
+///narrowphase for the objects a packet of convexSweepTestBatch hits in the broadphase
+struct btBatchedSweepPacketCallback : public btBroadphaseRayPacketCallback
+{
+	btRayPacket&	m_packet;
+	btBatchedClosestConvexCallback*	m_callbacks;
+	const btTransform*	m_convexFromTrans;
+	const btTransform*	m_convexToTrans;
+	const btConvexShape*	m_castShape;
+	btScalar	m_allowedCcdPenetration;
+
+	btBatchedSweepPacketCallback(btRayPacket& packet,btBatchedClosestConvexCallback* callbacks,const btTransform* convexFromTrans,const btTransform* convexToTrans,const btConvexShape* castShape,btScalar allowedPenetration)
+		:m_packet(packet),
+		m_callbacks(callbacks),
+		m_convexFromTrans(convexFromTrans),
+		m_convexToTrans(convexToTrans),
+		m_castShape(castShape),
+		m_allowedCcdPenetration(allowedPenetration)
+	{
+	}
+
+	virtual void	process(const btBroadphaseProxy* proxy,int rayMask)
+	{
+		btCollisionObject*	collisionObject = (btCollisionObject*)proxy->m_clientObject;
+		for (int lane=0;lane<BT_RAY_PACKET_SIZE;lane++)
+		{
+			btBatchedClosestConvexCallback& resultCallback = m_callbacks[lane];
+			if (!(rayMask & (1<<lane)) ||
+				resultCallback.m_closestHitFraction == btScalar(0.) ||
+				!resultCallback.needsCollision(collisionObject->getBroadphaseHandle()))
+			{
+				continue;
+			}
+			btBatchedObjectQuerySingle(m_castShape,m_convexFromTrans[lane],m_convexToTrans[lane],
+				collisionObject,
+				collisionObject->getCollisionShape(),
+				collisionObject->getWorldTransform(),
+				resultCallback,
+				m_allowedCcdPenetration);
+			m_packet.m_lambdaMax[lane] = resultCallback.m_closestHitFraction;
+		}
+	}
+};
+
+struct btConvexSweepTestBatchLoop : public btIParallelForBody
+{
+	btBroadphaseInterface*	m_broadphase;
+	const btConvexShape*	m_castShape;
+	const btTransform*	m_convexFromWorld;
+	const btTransform*	m_convexToWorld;
+	const int*	m_order;
+	int			m_numSweeps;
+	btCollisionWorld::BatchedQueryResult*	m_results;
+	btScalar	m_allowedCcdPenetration;
+	short int	m_collisionFilterGroup;
+	short int	m_collisionFilterMask;
+
+	void	forLoop(int iBegin,int iEnd) const
+	{
+		for (int packetIndex=iBegin;packetIndex<iEnd;packetIndex++)
+		{
+			btRayPacket packet;
+			btBatchedClosestConvexCallback callbacks[BT_RAY_PACKET_SIZE];
+			btTransform convexFromTrans[BT_RAY_PACKET_SIZE];
+			btTransform convexToTrans[BT_RAY_PACKET_SIZE];
+			int firstSweep = packetIndex*BT_RAY_PACKET_SIZE;
+			int numLanes = btMin(m_numSweeps-firstSweep,int(BT_RAY_PACKET_SIZE));
+			for (int lane=0;lane<numLanes;lane++)
+			{
+				int sweep = m_order[firstSweep+lane];
+				convexFromTrans[lane] = m_convexFromWorld[sweep];
+				convexToTrans[lane] = m_convexToWorld[sweep];
+
+				/* Compute AABB that encompasses angular movement, like convexSweepTest */
+				btVector3 castShapeAabbMin, castShapeAabbMax;
+				{
+					btVector3 linVel, angVel;
+					btTransformUtil::calculateVelocity (convexFromTrans[lane], convexToTrans[lane], 1.0, linVel, angVel);
+					btVector3 zeroLinVel;
+					zeroLinVel.setValue(0,0,0);
+					btTransform R;
+					R.setIdentity ();
+					R.setRotation (convexFromTrans[lane].getRotation());
+					m_castShape->calculateTemporalAabb (R, zeroLinVel, angVel, 1.0, castShapeAabbMin, castShapeAabbMax);
+				}
+
+				btBatchedClosestConvexCallback& resultCallback = callbacks[lane];
+				resultCallback.m_convexFromWorld = convexFromTrans[lane].getOrigin();
+				resultCallback.m_convexToWorld = convexToTrans[lane].getOrigin();
+				resultCallback.m_collisionFilterGroup = m_collisionFilterGroup;
+				resultCallback.m_collisionFilterMask = m_collisionFilterMask;
+				packet.setRay(lane,convexFromTrans[lane].getOrigin(),convexToTrans[lane].getOrigin(),castShapeAabbMin,castShapeAabbMax);
+			}
+
+			btBatchedSweepPacketCallback packetCallback(packet,callbacks,convexFromTrans,convexToTrans,m_castShape,m_allowedCcdPenetration);
+			m_broadphase->rayTestPacket(packet,packetCallback);
+
+			for (int lane=0;lane<numLanes;lane++)
+			{
+				const btBatchedClosestConvexCallback& resultCallback = callbacks[lane];
+				btCollisionWorld::BatchedQueryResult& result = m_results[m_order[firstSweep+lane]];
+				result.m_collisionObject = resultCallback.m_hitCollisionObject;
+				result.m_hitFraction = resultCallback.m_closestHitFraction;
+				result.m_shapePart = resultCallback.m_shapePart;
+				result.m_triangleIndex = resultCallback.m_triangleIndex;
+				if (resultCallback.m_hitCollisionObject)
+				{
+					result.m_hitPointWorld = resultCallback.m_hitPointWorld;
+					result.m_hitNormalWorld = resultCallback.m_hitNormalWorld;
+				} else
+				{
+					result.m_hitPointWorld = resultCallback.m_convexToWorld;
+					result.m_hitNormalWorld.setValue(0,0,0);
+				}
+			}
+		}
+	}
+};
+
+void	btCollisionWorld::convexSweepTestBatch(const btConvexShape* castShape, const btTransform* convexFromWorld, const btTransform* convexToWorld, int numSweeps, BatchedQueryResult* results, btScalar allowedCcdPenetration, short int collisionFilterGroup, short int collisionFilterMask) const
+{
+	BT_PROFILE("convexSweepTestBatch");
+	if (numSweeps <= 0)
+		return;
+
+	btAlignedObjectArray<btVector3> origins;
+	btAlignedObjectArray<btVector3> targets;
+	origins.resize(numSweeps);
+	targets.resize(numSweeps);
+	for (int i=0;i<numSweeps;i++)
+	{
+		origins[i] = convexFromWorld[i].getOrigin();
+		targets[i] = convexToWorld[i].getOrigin();
+	}
+	btAlignedObjectArray<int> order;
+	btSortBatchedQueries(&origins[0],&targets[0],numSweeps,order);
+
+	btConvexSweepTestBatchLoop loop;
+	loop.m_broadphase = m_broadphasePairCache;
+	loop.m_castShape = castShape;
+	loop.m_convexFromWorld = convexFromWorld;
+	loop.m_convexToWorld = convexToWorld;
+	loop.m_order = &order[0];
+	loop.m_numSweeps = numSweeps;
+	loop.m_results = results;
+	loop.m_allowedCcdPenetration = allowedCcdPenetration;
+	loop.m_collisionFilterGroup = collisionFilterGroup;
+	loop.m_collisionFilterMask = collisionFilterMask;
+	int numPackets = (numSweeps+BT_RAY_PACKET_SIZE-1)/BT_RAY_PACKET_SIZE;
+	btParallelFor(0,numPackets,BT_BATCHED_QUERY_GRAIN_SIZE,loop);
+}
+
+
+
 struct btBridgedManifoldResult : public btManifoldResult
 {
 
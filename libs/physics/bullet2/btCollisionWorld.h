@@ -439,6 +439,29 @@ public:
 	/// This allows for several queries: first hit, all hits, any hit, dependent on the value return by the callback.
 	void    convexSweepTest (const btConvexShape* castShape, const btTransform& from, const btTransform& to, ConvexResultCallback& resultCallback,  btScalar allowedCcdPenetration = btScalar(0.)) const;
 
+	///BatchedQueryResult is the closest hit of one ray or sweep of rayTestBatch and convexSweepTestBatch.
+	///Without a hit m_collisionObject is 0, m_hitFraction is 1, m_hitPointWorld is the end of the ray and m_hitNormalWorld is zero.
+	///m_shapePart and m_triangleIndex are -1 unless the hit shape reports them, like LocalShapeInfo.
+	struct	BatchedQueryResult
+	{
+		btCollisionObject*	m_collisionObject;
+		btVector3	m_hitPointWorld;
+		btVector3	m_hitNormalWorld;
+		btScalar	m_hitFraction;
+		int		m_shapePart;
+		int		m_triangleIndex;
+	};
+
+	/// rayTestBatch finds the closest hit of each of numRays rays, like rayTest with a ClosestRayResultCallback per ray, and writes it to results[i].
+	/// The rays are sorted by direction and origin, the broadphase and btBvhTriangleMeshShape trees are walked by packets of BT_RAY_PACKET_SIZE
+	/// neighbouring rays (see btRayPacket), and the packets are spread over the btTaskScheduler if one is set. Shapes are then queried by several
+	/// threads at the same time, which all Bullet shapes support except btGImpactMeshShape.
+	void	rayTestBatch(const btVector3* rayFromWorld, const btVector3* rayToWorld, int numRays, BatchedQueryResult* results, short int collisionFilterGroup=btBroadphaseProxy::DefaultFilter, short int collisionFilterMask=btBroadphaseProxy::AllFilter) const;
+
+	/// convexSweepTestBatch finds the closest hit of each of numSweeps sweeps of castShape, like convexSweepTest with a ClosestConvexResultCallback per sweep.
+	/// The broadphase is walked by packets like in rayTestBatch, the narrowphase tests one sweep at a time.
+	void	convexSweepTestBatch(const btConvexShape* castShape, const btTransform* convexFromWorld, const btTransform* convexToWorld, int numSweeps, BatchedQueryResult* results, btScalar allowedCcdPenetration = btScalar(0.), short int collisionFilterGroup=btBroadphaseProxy::DefaultFilter, short int collisionFilterMask=btBroadphaseProxy::AllFilter) const;
+
 	///contactTest performs a discrete collision test between colObj against all objects in the btCollisionWorld, and calls the resultCallback.
 	///it reports one or more contact points for every overlapping object (including the one with deepest penetration)
 	void	contactTest(btCollisionObject* colObj, ContactResultCallback& resultCallback);
@@ -27,7 +27,8 @@ enum	btSolverMode
 	SOLVER_DISABLE_VELOCITY_DEPENDENT_FRICTION_DIRECTION = 64,
 	SOLVER_CACHE_FRIENDLY = 128,
 	SOLVER_SIMD = 256,	//enabled for Windows, the solver innerloop is branchless SIMD, 40% faster than FPU/scalar version
-	SOLVER_CUDA = 512	//will be open sourced during Game Developers Conference 2009. Much faster.
+	SOLVER_CUDA = 512,	//will be open sourced during Game Developers Conference 2009. Much faster.
+	SOLVER_SIMD_SOA = 1024	//contact and friction rows are graph-colored into SIMD-wide blocks and solved several rows at a time, see btBatchedConstraints.h
 };
 
 struct btContactSolverInfoData
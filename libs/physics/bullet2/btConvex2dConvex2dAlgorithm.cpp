@@ -26,6 +26,7 @@ subject to the following restrictions:
 #include "btGjkPairDetector.h"
 #include "btBroadphaseProxy.h"
 #include "btCollisionDispatcher.h"
+#include "btCollisionDispatcherMt.h"
 #include "btBoxShape.h"
 #include "btManifoldResult.h"
 
@@ -122,7 +123,7 @@ void btConvex2dConvex2dAlgorithm ::processCollision (btCollisionObject* body0,bt
 
 		btGjkPairDetector::ClosestPointInput input;
 
-		btGjkPairDetector	gjkPairDetector(min0,min1,m_simplexSolver,m_pdSolver);
+		btGjkPairDetector	gjkPairDetector(min0,min1,btGetThreadSimplexSolver(m_simplexSolver),m_pdSolver);
 		//TODO: if (dispatchInfo.m_useContinuous)
 		gjkPairDetector.setMinkowskiA(min0);
 		gjkPairDetector.setMinkowskiB(min1);
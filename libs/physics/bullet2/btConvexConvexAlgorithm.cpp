@@ -34,6 +34,7 @@ subject to the following restrictions:
 #include "btGjkPairDetector.h"
 #include "btBroadphaseProxy.h"
 #include "btCollisionDispatcher.h"
+#include "btCollisionDispatcherMt.h"
 #include "btBoxShape.h"
 #include "btManifoldResult.h"
 
@@ -350,7 +351,7 @@ void btConvexConvexAlgorithm ::processCollision (btCollisionObject* body0,btColl
 	
 	btGjkPairDetector::ClosestPointInput input;
 
-	btGjkPairDetector	gjkPairDetector(min0,min1,m_simplexSolver,m_pdSolver);
+	btGjkPairDetector	gjkPairDetector(min0,min1,btGetThreadSimplexSolver(m_simplexSolver),m_pdSolver);
 	//TODO: if (dispatchInfo.m_useContinuous)
 	gjkPairDetector.setMinkowskiA(min0);
 	gjkPairDetector.setMinkowskiB(min1);
@@ -277,6 +277,64 @@ void	btDbvtBroadphase::aabbTest(const btVector3& aabbMin,const btVector3& aabbMa
 }
 
 
+struct	btDbvtPacketStackEntry
+{
+	const btDbvtNode*	m_node;
+	int					m_rayMask;
+};
+
+//one walk for all lanes, a child is only tested against the lanes that hit its parent
+static void	rayTestPacketInternal(const btDbvtNode* root,btRayPacket& packet,btBroadphaseRayPacketCallback& callback,btAlignedObjectArray<btDbvtPacketStackEntry>& stack)
+{
+	if (!root)
+		return;
+
+	//visit the near child first, so the closest hits shrink the lanes early
+	int firstLane = 0;
+	while (!(packet.m_activeMask & (1<<firstLane)))
+		firstLane++;
+	btVector3 directionSign(packet.m_invDirection[0][firstLane],packet.m_invDirection[1][firstLane],packet.m_invDirection[2][firstLane]);
+
+	stack.resize(0);
+	btDbvtPacketStackEntry& rootEntry = stack.expandNonInitializing();
+	rootEntry.m_node = root;
+	rootEntry.m_rayMask = packet.m_activeMask;
+	while (stack.size())
+	{
+		btDbvtPacketStackEntry entry = stack[stack.size()-1];
+		stack.pop_back();
+		int rayMask = packet.testAabb(entry.m_node->volume.Mins(),entry.m_node->volume.Maxs(),entry.m_rayMask);
+		if (!rayMask)
+			continue;
+		if (entry.m_node->isinternal())
+		{
+			const btDbvtNode* child0 = entry.m_node->childs[0];
+			const btDbvtNode* child1 = entry.m_node->childs[1];
+			if ((child1->volume.Center()-child0->volume.Center()).dot(directionSign) < btScalar(0.))
+				btSwap(child0,child1);
+			btDbvtPacketStackEntry& farEntry = stack.expandNonInitializing();
+			farEntry.m_node = child1;
+			farEntry.m_rayMask = rayMask;
+			btDbvtPacketStackEntry& nearEntry = stack.expandNonInitializing();
+			nearEntry.m_node = child0;
+			nearEntry.m_rayMask = rayMask;
+		} else
+		{
+			callback.process((btDbvtProxy*)entry.m_node->data,rayMask);
+		}
+	}
+}
+
+void	btDbvtBroadphase::rayTestPacket(btRayPacket& packet,btBroadphaseRayPacketCallback& callback)
+{
+	if (!packet.m_activeMask)
+		return;
+	//a stack of its own, m_rayTestStack of the trees is shared by all callers
+	btAlignedObjectArray<btDbvtPacketStackEntry> stack;
+	stack.reserve(btDbvt::DOUBLE_STACKSIZE);
+	rayTestPacketInternal(m_sets[0].m_root,packet,callback,stack);
+	rayTestPacketInternal(m_sets[1].m_root,packet,callback,stack);
+}
 
 //
 void							btDbvtBroadphase::setAabb(		btBroadphaseProxy* absproxy,
@@ -0,0 +1,335 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2012 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include "btDiscreteDynamicsWorldMt.h"
+#include "btSimulationIslandManager.h"
+#include "btSequentialImpulseConstraintSolver.h"
+#include "btContactSolverInfo.h"
+#include "btTypedConstraint.h"
+#include "btRigidBody.h"
+#include "btQuickprof.h"
+
+
+static SIMD_FORCE_INLINE int	btGetIslandIdOfConstraint(const btTypedConstraint* constraint)
+{
+	const btCollisionObject& rcolObj0 = constraint->getRigidBodyA();
+	const btCollisionObject& rcolObj1 = constraint->getRigidBodyB();
+	return rcolObj0.getIslandTag()>=0?rcolObj0.getIslandTag():rcolObj1.getIslandTag();
+}
+
+///same order as btDiscreteDynamicsWorld::solveConstraints, so the solver batches match
+class btSortConstraintsOnIslandMt
+{
+	public:
+
+		bool operator() ( const btTypedConstraint* lhs, const btTypedConstraint* rhs ) const
+		{
+			return btGetIslandIdOfConstraint(lhs) < btGetIslandIdOfConstraint(rhs);
+		}
+};
+
+struct btIslandBatch
+{
+	int	m_firstBody;
+	int	m_numBodies;
+	int	m_firstManifold;
+	int	m_numManifolds;
+	int	m_firstConstraint;
+	int	m_numConstraints;
+};
+
+class btSortIslandBatchesOnSize
+{
+	const btIslandBatch*	m_batches;
+
+	public:
+
+		btSortIslandBatchesOnSize(const btIslandBatch* batches)
+			:m_batches(batches)
+		{
+		}
+
+		bool operator() ( int lhs, int rhs ) const
+		{
+			int lhsSize = m_batches[lhs].m_numManifolds + m_batches[lhs].m_numConstraints;
+			int rhsSize = m_batches[rhs].m_numManifolds + m_batches[rhs].m_numConstraints;
+			if (lhsSize != rhsSize)
+				return lhsSize > rhsSize;
+			return lhs < rhs;
+		}
+};
+
+///records the islands in solver batches instead of solving them, following the batching rules of InplaceSolverIslandCallback
+struct btIslandBatchCallback : public btSimulationIslandManager::IslandCallback
+{
+	const btContactSolverInfo*	m_solverInfo;
+	btTypedConstraint**			m_sortedConstraints;
+	int							m_numConstraints;
+
+	btAlignedObjectArray<btCollisionObject*>	m_bodies;
+	btAlignedObjectArray<btPersistentManifold*>	m_manifolds;
+	btAlignedObjectArray<btTypedConstraint*>	m_constraints;
+	btAlignedObjectArray<btIslandBatch>			m_batches;
+	btAlignedObjectArray<int>					m_batchOrder;
+	btIslandBatch								m_openBatch;
+
+	btIslandBatchCallback()
+		:m_solverInfo(0),
+		m_sortedConstraints(0),
+		m_numConstraints(0)
+	{
+		openBatch();
+	}
+
+	void	setup(const btContactSolverInfo* solverInfo,btTypedConstraint** sortedConstraints,int numConstraints)
+	{
+		m_solverInfo = solverInfo;
+		m_sortedConstraints = sortedConstraints;
+		m_numConstraints = numConstraints;
+		m_bodies.resize(0);
+		m_manifolds.resize(0);
+		m_constraints.resize(0);
+		m_batches.resize(0);
+		openBatch();
+	}
+
+	void	openBatch()
+	{
+		m_openBatch.m_firstBody = m_bodies.size();
+		m_openBatch.m_firstManifold = m_manifolds.size();
+		m_openBatch.m_firstConstraint = m_constraints.size();
+		m_openBatch.m_numBodies = 0;
+		m_openBatch.m_numManifolds = 0;
+		m_openBatch.m_numConstraints = 0;
+	}
+
+	void	closeBatch()
+	{
+		m_openBatch.m_numBodies = m_bodies.size() - m_openBatch.m_firstBody;
+		m_openBatch.m_numManifolds = m_manifolds.size() - m_openBatch.m_firstManifold;
+		m_openBatch.m_numConstraints = m_constraints.size() - m_openBatch.m_firstConstraint;
+		if (m_openBatch.m_numManifolds + m_openBatch.m_numConstraints)
+		{
+			m_batches.push_back(m_openBatch);
+		}
+		openBatch();
+	}
+
+	virtual	void	processIsland(btCollisionObject** bodies,int numBodies,btPersistentManifold** manifolds,int numManifolds, int islandId)
+	{
+		btAssert(islandId >= 0);
+
+		btTypedConstraint** startConstraint = 0;
+		int numCurConstraints = 0;
+		int i;
+
+		for (i=0;i<m_numConstraints;i++)
+		{
+			if (btGetIslandIdOfConstraint(m_sortedConstraints[i]) == islandId)
+			{
+				startConstraint = &m_sortedConstraints[i];
+				break;
+			}
+		}
+		for (;i<m_numConstraints;i++)
+		{
+			if (btGetIslandIdOfConstraint(m_sortedConstraints[i]) == islandId)
+			{
+				numCurConstraints++;
+			}
+		}
+
+		bool ownBatch = m_solverInfo->m_minimumSolverBatchSize<=1;
+		if (ownBatch && !(numManifolds + numCurConstraints))
+			return;
+
+		for (i=0;i<numBodies;i++)
+			m_bodies.push_back(bodies[i]);
+		for (i=0;i<numManifolds;i++)
+			m_manifolds.push_back(manifolds[i]);
+		for (i=0;i<numCurConstraints;i++)
+			m_constraints.push_back(startConstraint[i]);
+
+		int batchSize = (m_manifolds.size() - m_openBatch.m_firstManifold) + (m_constraints.size() - m_openBatch.m_firstConstraint);
+		if (ownBatch || batchSize > m_solverInfo->m_minimumSolverBatchSize)
+		{
+			closeBatch();
+		}
+	}
+};
+
+struct btSolveIslandBatchesLoop : public btIParallelForBody
+{
+	btIslandBatchCallback*					m_islands;
+	btConstraintSolver*						m_mainSolver;
+	btSequentialImpulseConstraintSolver**	m_threadSolvers;
+	const btContactSolverInfo&				m_solverInfo;
+	btIDebugDraw*							m_debugDrawer;
+	btStackAlloc*							m_stackAlloc;
+	btDispatcher*							m_dispatcher;
+
+	btSolveIslandBatchesLoop(btIslandBatchCallback* islands,btConstraintSolver* mainSolver,btSequentialImpulseConstraintSolver** threadSolvers,
+		const btContactSolverInfo& solverInfo,btIDebugDraw* debugDrawer,btStackAlloc* stackAlloc,btDispatcher* dispatcher)
+		:m_islands(islands),
+		m_mainSolver(mainSolver),
+		m_threadSolvers(threadSolvers),
+		m_solverInfo(solverInfo),
+		m_debugDrawer(debugDrawer),
+		m_stackAlloc(stackAlloc),
+		m_dispatcher(dispatcher)
+	{
+	}
+
+	void	forLoop(int iBegin,int iEnd) const
+	{
+		int threadIndex = btGetCurrentThreadIndex();
+		btConstraintSolver* solver = threadIndex ? m_threadSolvers[threadIndex] : m_mainSolver;
+		//btStackAlloc isn't thread-safe, only the main thread gets it
+		btStackAlloc* stackAlloc = threadIndex ? 0 : m_stackAlloc;
+
+		for (int i=iBegin;i<iEnd;i++)
+		{
+			const btIslandBatch& batch = m_islands->m_batches[m_islands->m_batchOrder[i]];
+			btCollisionObject** bodies = &m_islands->m_bodies[batch.m_firstBody];
+			btPersistentManifold** manifolds = batch.m_numManifolds ? &m_islands->m_manifolds[batch.m_firstManifold] : 0;
+			btTypedConstraint** constraints = batch.m_numConstraints ? &m_islands->m_constraints[batch.m_firstConstraint] : 0;
+			solver->solveGroup(bodies,batch.m_numBodies,manifolds,batch.m_numManifolds,constraints,batch.m_numConstraints,m_solverInfo,m_debugDrawer,stackAlloc,m_dispatcher);
+		}
+	}
+
+private:
+	btSolveIslandBatchesLoop& operator=(const btSolveIslandBatchesLoop&);
+};
+
+struct btPredictMotionLoop : public btIParallelForBody
+{
+	btRigidBody**	m_bodies;
+	btScalar		m_timeStep;
+
+	btPredictMotionLoop(btRigidBody** bodies,btScalar timeStep)
+		:m_bodies(bodies),
+		m_timeStep(timeStep)
+	{
+	}
+
+	void	forLoop(int iBegin,int iEnd) const
+	{
+		for (int i=iBegin;i<iEnd;i++)
+		{
+			btRigidBody* body = m_bodies[i];
+			if (!body->isStaticOrKinematicObject())
+			{
+				body->integrateVelocities( m_timeStep);
+				//damping
+				body->applyDamping(m_timeStep);
+
+				body->predictIntegratedTransform(m_timeStep,body->getInterpolationWorldTransform());
+			}
+		}
+	}
+};
+
+
+btDiscreteDynamicsWorldMt::btDiscreteDynamicsWorldMt(btDispatcher* dispatcher,btBroadphaseInterface* pairCache,btConstraintSolver* constraintSolver,btCollisionConfiguration* collisionConfiguration)
+:btDiscreteDynamicsWorld(dispatcher,pairCache,constraintSolver,collisionConfiguration)
+{
+	void* mem = btAlignedAlloc(sizeof(btIslandBatchCallback),16);
+	m_islandBatchCallback = new (mem) btIslandBatchCallback();
+
+	for (int i=0;i<BT_MAX_THREAD_COUNT;i++)
+	{
+		m_threadSolvers[i] = 0;
+	}
+}
+
+btDiscreteDynamicsWorldMt::~btDiscreteDynamicsWorldMt()
+{
+	for (int i=0;i<BT_MAX_THREAD_COUNT;i++)
+	{
+		if (m_threadSolvers[i])
+		{
+			m_threadSolvers[i]->~btSequentialImpulseConstraintSolver();
+			btAlignedFree(m_threadSolvers[i]);
+		}
+	}
+	m_islandBatchCallback->~btIslandBatchCallback();
+	btAlignedFree(m_islandBatchCallback);
+}
+
+void	btDiscreteDynamicsWorldMt::predictUnconstraintMotion(btScalar timeStep)
+{
+	BT_PROFILE("predictUnconstraintMotion");
+	if (m_nonStaticRigidBodies.size())
+	{
+		btPredictMotionLoop loop(&m_nonStaticRigidBodies[0],timeStep);
+		btParallelFor(0,m_nonStaticRigidBodies.size(),64,loop);
+	}
+}
+
+void	btDiscreteDynamicsWorldMt::solveConstraints(btContactSolverInfo& solverInfo)
+{
+	int numThreads = btGetTaskSchedulerThreadCount();
+	if (numThreads <= 1 || !m_islandManager->getSplitIslands())
+	{
+		btDiscreteDynamicsWorld::solveConstraints(solverInfo);
+		return;
+	}
+
+	BT_PROFILE("solveConstraints");
+
+	int i;
+	m_sortedConstraints.resize( m_constraints.size());
+	for (i=0;i<getNumConstraints();i++)
+	{
+		m_sortedConstraints[i] = m_constraints[i];
+	}
+	m_sortedConstraints.quickSort(btSortConstraintsOnIslandMt());
+
+	btTypedConstraint** constraintsPtr = getNumConstraints() ? &m_sortedConstraints[0] : 0;
+
+	m_islandBatchCallback->setup(&solverInfo,constraintsPtr,m_sortedConstraints.size());
+	m_constraintSolver->prepareSolve(getCollisionWorld()->getNumCollisionObjects(), getCollisionWorld()->getDispatcher()->getNumManifolds());
+
+	m_islandManager->buildAndProcessIslands(getCollisionWorld()->getDispatcher(),getCollisionWorld(),m_islandBatchCallback);
+	m_islandBatchCallback->closeBatch();
+
+	int numBatches = m_islandBatchCallback->m_batches.size();
+	if (numBatches)
+	{
+		for (i=1;i<numThreads;i++)
+		{
+			if (!m_threadSolvers[i])
+			{
+				void* mem = btAlignedAlloc(sizeof(btSequentialImpulseConstraintSolver),16);
+				m_threadSolvers[i] = new (mem) btSequentialImpulseConstraintSolver;
+			}
+		}
+
+		//largest batches first, the small ones fill the gaps at the end
+		btAlignedObjectArray<int>& batchOrder = m_islandBatchCallback->m_batchOrder;
+		batchOrder.resize(numBatches);
+		for (i=0;i<numBatches;i++)
+		{
+			batchOrder[i] = i;
+		}
+		batchOrder.quickSort(btSortIslandBatchesOnSize(&m_islandBatchCallback->m_batches[0]));
+
+		btSolveIslandBatchesLoop loop(m_islandBatchCallback,m_constraintSolver,m_threadSolvers,solverInfo,getDebugDrawer(),m_stackAlloc,getCollisionWorld()->getDispatcher());
+		btParallelFor(0,numBatches,1,loop);
+	}
+
+	m_constraintSolver->allSolved(solverInfo, m_debugDrawer, m_stackAlloc);
+}
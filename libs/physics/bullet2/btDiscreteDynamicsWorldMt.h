@@ -0,0 +1,50 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2012 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef BT_DISCRETE_DYNAMICS_WORLD_MT_H
+#define BT_DISCRETE_DYNAMICS_WORLD_MT_H
+
+#include "btDiscreteDynamicsWorld.h"
+#include "btThreads.h"
+
+class btSequentialImpulseConstraintSolver;
+struct btIslandBatchCallback;
+
+///btDiscreteDynamicsWorldMt solves independent simulation islands concurrently on the btTaskScheduler (see btThreads.h).
+///Islands are grouped into solver batches exactly like btDiscreteDynamicsWorld does (see btContactSolverInfo::m_minimumSolverBatchSize).
+///The main thread solves its batches with the world's constraint solver, each worker thread with a btSequentialImpulseConstraintSolver of its own,
+///so a custom constraint solver is only supported when islands are not split. Batches share no dynamic body, the result doesn't depend on the number of threads.
+///Unconstrained motion is predicted in parallel as well. Use a btCollisionDispatcherMt to also run the narrowphase on the worker threads.
+class btDiscreteDynamicsWorldMt : public btDiscreteDynamicsWorld
+{
+	btIslandBatchCallback*	m_islandBatchCallback;
+
+	btSequentialImpulseConstraintSolver*	m_threadSolvers[BT_MAX_THREAD_COUNT];
+
+protected:
+
+	virtual void	predictUnconstraintMotion(btScalar timeStep);
+
+	virtual void	solveConstraints(btContactSolverInfo& solverInfo);
+
+public:
+
+	btDiscreteDynamicsWorldMt(btDispatcher* dispatcher,btBroadphaseInterface* pairCache,btConstraintSolver* constraintSolver,btCollisionConfiguration* collisionConfiguration);
+
+	virtual ~btDiscreteDynamicsWorldMt();
+};
+
+#endif //BT_DISCRETE_DYNAMICS_WORLD_MT_H
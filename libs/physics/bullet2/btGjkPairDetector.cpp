@@ -17,6 +17,7 @@ subject to the following restrictions:
 #include "btConvexShape.h"
 #include "btSimplexSolverInterface.h"
 #include "btConvexPenetrationDepthSolver.h"
+#include "btThreads.h"
 
 
 
@@ -33,7 +34,7 @@ subject to the following restrictions:
 //must be above the machine epsilon
 #define REL_ERROR2 btScalar(1.0e-6)
 
-//temp globals, to improve GJK/EPA/penetration calculations
+//temp globals, to improve GJK/EPA/penetration calculations. Only counted outside of btParallelFor loops, the pairs may be processed on several threads
 int gNumDeepPenetrationChecks = 0;
 int gNumGjkChecks = 0;
 
@@ -98,7 +99,8 @@ void btGjkPairDetector::getClosestPointsNonVirtual(const ClosestPointInput& inpu
 	btScalar marginA = m_marginA;
 	btScalar marginB = m_marginB;
 
-	gNumGjkChecks++;
+	if (!btThreadsAreRunning())
+		gNumGjkChecks++;
 
 #ifdef DEBUG_SPU_COLLISION_DETECTION
 	spu_printf("inside gjk\n");
@@ -345,7 +347,8 @@ void btGjkPairDetector::getClosestPointsNonVirtual(const ClosestPointInput& inpu
 				// Penetration depth case.
 				btVector3 tmpPointOnA,tmpPointOnB;
 				
-				gNumDeepPenetrationChecks++;
+				if (!btThreadsAreRunning())
+					gNumDeepPenetrationChecks++;
 				m_cachedSeparatingAxis.setZero();
 
 				bool isValid2 = m_penetrationDepthSolver->calcPenDepth( 
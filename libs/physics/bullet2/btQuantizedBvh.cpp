@@ -18,6 +18,7 @@ subject to the following restrictions:
 #include "btAabbUtil2.h"
 #include "btIDebugDraw.h"
 #include "btSerializer.h"
+#include "btThreads.h"
 
 #define RAYAABB2
 
@@ -106,12 +107,153 @@ btQuantizedBvh::~btQuantizedBvh()
 {
 }
 
+///trees with fewer leaves are built on the calling thread
+#define BT_BVH_PARALLEL_MIN_LEAVES 4096
+
+///btBvhParallelBuilder splits the top of the tree on the calling thread until the subtrees are small enough, builds those
+///subtrees in parallel and then adds the subtree headers of the top nodes in the order buildSubtree would have added them.
+///The size of a subtree only depends on its number of leaves, so every subtree knows its first node before it is built.
+struct btBvhParallelBuilder : public btIParallelForBody
+{
+	struct btSubtreeTask
+	{
+		int		m_startIndex;
+		int		m_endIndex;
+		int		m_nodeIndex;
+		BvhSubtreeInfoArray	m_subtreeHeaders;
+	};
+
+	///post-order list of the top nodes, either a subtree task or an internal node that may need subtree headers
+	struct btTopNode
+	{
+		int		m_task;
+		int		m_leftChildNodeIndex;
+		int		m_rightChildNodeIndex;
+		int		m_escapeIndex;
+	};
+
+	btQuantizedBvh*	m_bvh;
+	int				m_maxTaskLeaves;
+	btAlignedObjectArray<btSubtreeTask*>	m_tasks;
+	btAlignedObjectArray<btTopNode>	m_topNodes;
+
+	btBvhParallelBuilder(btQuantizedBvh* bvh,int maxTaskLeaves)
+		:m_bvh(bvh),
+		m_maxTaskLeaves(maxTaskLeaves)
+	{
+	}
+
+	~btBvhParallelBuilder()
+	{
+		for (int i=0;i<m_tasks.size();i++)
+		{
+			m_tasks[i]->~btSubtreeTask();
+			btAlignedFree(m_tasks[i]);
+		}
+	}
+
+	void	splitTopNodes(int startIndex,int endIndex,int nodeIndex)
+	{
+		int numIndices = endIndex-startIndex;
+		if (numIndices <= m_maxTaskLeaves)
+		{
+			void* mem = btAlignedAlloc(sizeof(btSubtreeTask),16);
+			btSubtreeTask* task = new(mem) btSubtreeTask;
+			task->m_startIndex = startIndex;
+			task->m_endIndex = endIndex;
+			task->m_nodeIndex = nodeIndex;
+			btTopNode& topNode = m_topNodes.expandNonInitializing();
+			topNode.m_task = m_tasks.size();
+			m_tasks.push_back(task);
+			return;
+		}
+
+		//same as buildSubtree
+		int splitAxis = m_bvh->calcSplittingAxis(startIndex,endIndex);
+		int splitIndex = m_bvh->sortAndCalcSplittingIndex(startIndex,endIndex,splitAxis);
+
+		m_bvh->setInternalNodeAabbMin(nodeIndex,m_bvh->m_bvhAabbMax);
+		m_bvh->setInternalNodeAabbMax(nodeIndex,m_bvh->m_bvhAabbMin);
+		for (int i=startIndex;i<endIndex;i++)
+		{
+			m_bvh->mergeInternalNodeAabb(nodeIndex,m_bvh->getAabbMin(i),m_bvh->getAabbMax(i));
+		}
+
+		//a subtree of n leaves has 2n-1 nodes
+		int leftChildNodeIndex = nodeIndex+1;
+		int rightChildNodeIndex = leftChildNodeIndex+2*(splitIndex-startIndex)-1;
+		int escapeIndex = 2*numIndices-1;
+
+		splitTopNodes(startIndex,splitIndex,leftChildNodeIndex);
+		splitTopNodes(splitIndex,endIndex,rightChildNodeIndex);
+
+		btTopNode& topNode = m_topNodes.expandNonInitializing();
+		topNode.m_task = -1;
+		topNode.m_leftChildNodeIndex = leftChildNodeIndex;
+		topNode.m_rightChildNodeIndex = rightChildNodeIndex;
+		topNode.m_escapeIndex = escapeIndex;
+
+		m_bvh->setInternalNodeEscapeIndex(nodeIndex,escapeIndex);
+	}
+
+	void	forLoop(int iBegin,int iEnd) const
+	{
+		for (int i=iBegin;i<iEnd;i++)
+		{
+			btSubtreeTask& task = *m_tasks[i];
+			int curNodeIndex = task.m_nodeIndex;
+			m_bvh->buildSubtree(task.m_startIndex,task.m_endIndex,curNodeIndex,task.m_subtreeHeaders);
+		}
+	}
+
+	void	addSubtreeHeaders()
+	{
+		for (int i=0;i<m_topNodes.size();i++)
+		{
+			const btTopNode& topNode = m_topNodes[i];
+			if (topNode.m_task >= 0)
+			{
+				const BvhSubtreeInfoArray& headers = m_tasks[topNode.m_task]->m_subtreeHeaders;
+				for (int j=0;j<headers.size();j++)
+				{
+					m_bvh->m_SubtreeHeaders.push_back(headers[j]);
+				}
+			} else if (m_bvh->m_useQuantization && topNode.m_escapeIndex*int(sizeof(btQuantizedBvhNode)) > MAX_SUBTREE_SIZE_IN_BYTES)
+			{
+				m_bvh->updateSubtreeHeaders(topNode.m_leftChildNodeIndex,topNode.m_rightChildNodeIndex,m_bvh->m_SubtreeHeaders);
+			}
+		}
+	}
+};
+
+void	btQuantizedBvh::buildTree	(int startIndex,int endIndex)
+{
+	int numIndices = endIndex-startIndex;
+	int numThreads = btGetTaskSchedulerThreadCount();
+	if (numThreads > 1 && numIndices >= BT_BVH_PARALLEL_MIN_LEAVES && !btThreadsAreRunning())
+	{
+		//a few subtrees per thread to balance the load, the top nodes are split serially
+		int maxTaskLeaves = btMax(numIndices/(numThreads*4),BT_BVH_PARALLEL_MIN_LEAVES/4);
+		btBvhParallelBuilder builder(this,maxTaskLeaves);
+		builder.splitTopNodes(startIndex,endIndex,m_curNodeIndex);
+		btParallelFor(0,builder.m_tasks.size(),1,builder);
+		builder.addSubtreeHeaders();
+		m_curNodeIndex += 2*numIndices-1;
+	} else
+	{
+		buildSubtree(startIndex,endIndex,m_curNodeIndex,m_SubtreeHeaders);
+	}
+
+	//PCK: update the copy of the size
+	m_subtreeHeaderCount = m_SubtreeHeaders.size();
+}
+
 #ifdef DEBUG_TREE_BUILDING
 int gStackDepth = 0;
 int gMaxStackDepth = 0;
 #endif //DEBUG_TREE_BUILDING
 
-void	btQuantizedBvh::buildTree	(int startIndex,int endIndex)
+void	btQuantizedBvh::buildSubtree(int startIndex,int endIndex,int& curNodeIndex,BvhSubtreeInfoArray& subtreeHeaders)
 {
 #ifdef DEBUG_TREE_BUILDING
 	gStackDepth++;
@@ -122,7 +264,7 @@ void	btQuantizedBvh::buildTree	(int startIndex,int endIndex)
 
 	int splitAxis, splitIndex, i;
 	int numIndices =endIndex-startIndex;
-	int curIndex = m_curNodeIndex;
+	int curIndex = curNodeIndex;
 
 	btAssert(numIndices>0);
 
@@ -132,9 +274,9 @@ void	btQuantizedBvh::buildTree	(int startIndex,int endIndex)
 		gStackDepth--;
 #endif //DEBUG_TREE_BUILDING
 		
-		assignInternalNodeFromLeafNode(m_curNodeIndex,startIndex);
+		assignInternalNodeFromLeafNode(curNodeIndex,startIndex);
 
-		m_curNodeIndex++;
+		curNodeIndex++;
 		return;	
 	}
 	//calculate Best Splitting Axis and where to split it. Sort the incoming 'leafNodes' array within range 'startIndex/endIndex'.
@@ -143,38 +285,38 @@ void	btQuantizedBvh::buildTree	(int startIndex,int endIndex)
 
 	splitIndex = sortAndCalcSplittingIndex(startIndex,endIndex,splitAxis);
 
-	int internalNodeIndex = m_curNodeIndex;
+	int internalNodeIndex = curNodeIndex;
 	
 	//set the min aabb to 'inf' or a max value, and set the max aabb to a -inf/minimum value.
 	//the aabb will be expanded during buildTree/mergeInternalNodeAabb with actual node values
-	setInternalNodeAabbMin(m_curNodeIndex,m_bvhAabbMax);//can't use btVector3(SIMD_INFINITY,SIMD_INFINITY,SIMD_INFINITY)) because of quantization
-	setInternalNodeAabbMax(m_curNodeIndex,m_bvhAabbMin);//can't use btVector3(-SIMD_INFINITY,-SIMD_INFINITY,-SIMD_INFINITY)) because of quantization
+	setInternalNodeAabbMin(curNodeIndex,m_bvhAabbMax);//can't use btVector3(SIMD_INFINITY,SIMD_INFINITY,SIMD_INFINITY)) because of quantization
+	setInternalNodeAabbMax(curNodeIndex,m_bvhAabbMin);//can't use btVector3(-SIMD_INFINITY,-SIMD_INFINITY,-SIMD_INFINITY)) because of quantization
 	
 	
 	for (i=startIndex;i<endIndex;i++)
 	{
-		mergeInternalNodeAabb(m_curNodeIndex,getAabbMin(i),getAabbMax(i));
+		mergeInternalNodeAabb(curNodeIndex,getAabbMin(i),getAabbMax(i));
 	}
 
-	m_curNodeIndex++;
+	curNodeIndex++;
 	
 
 	//internalNode->m_escapeIndex;
 	
-	int leftChildNodexIndex = m_curNodeIndex;
+	int leftChildNodexIndex = curNodeIndex;
 
 	//build left child tree
-	buildTree(startIndex,splitIndex);
+	buildSubtree(startIndex,splitIndex,curNodeIndex,subtreeHeaders);
 
-	int rightChildNodexIndex = m_curNodeIndex;
+	int rightChildNodexIndex = curNodeIndex;
 	//build right child tree
-	buildTree(splitIndex,endIndex);
+	buildSubtree(splitIndex,endIndex,curNodeIndex,subtreeHeaders);
 
 #ifdef DEBUG_TREE_BUILDING
 	gStackDepth--;
 #endif //DEBUG_TREE_BUILDING
 
-	int escapeIndex = m_curNodeIndex - curIndex;
+	int escapeIndex = curNodeIndex - curIndex;
 
 	if (m_useQuantization)
 	{
@@ -183,7 +325,7 @@ void	btQuantizedBvh::buildTree	(int startIndex,int endIndex)
 		const int treeSizeInBytes = escapeIndex * sizeQuantizedNode;
 		if (treeSizeInBytes > MAX_SUBTREE_SIZE_IN_BYTES)
 		{
-			updateSubtreeHeaders(leftChildNodexIndex,rightChildNodexIndex);
+			updateSubtreeHeaders(leftChildNodexIndex,rightChildNodexIndex,subtreeHeaders);
 		}
 	} else
 	{
@@ -195,6 +337,14 @@ void	btQuantizedBvh::buildTree	(int startIndex,int endIndex)
 }
 
 void	btQuantizedBvh::updateSubtreeHeaders(int leftChildNodexIndex,int rightChildNodexIndex)
+{
+	updateSubtreeHeaders(leftChildNodexIndex,rightChildNodexIndex,m_SubtreeHeaders);
+
+	//PCK: update the copy of the size
+	m_subtreeHeaderCount = m_SubtreeHeaders.size();
+}
+
+void	btQuantizedBvh::updateSubtreeHeaders(int leftChildNodexIndex,int rightChildNodexIndex,BvhSubtreeInfoArray& subtreeHeaders)
 {
 	btAssert(m_useQuantization);
 
@@ -208,7 +358,7 @@ void	btQuantizedBvh::updateSubtreeHeaders(int leftChildNodexIndex,int rightChild
 
 	if(leftSubTreeSizeInBytes <= MAX_SUBTREE_SIZE_IN_BYTES)
 	{
-		btBvhSubtreeInfo& subtree = m_SubtreeHeaders.expand();
+		btBvhSubtreeInfo& subtree = subtreeHeaders.expand();
 		subtree.setAabbFromQuantizeNode(leftChildNode);
 		subtree.m_rootNodeIndex = leftChildNodexIndex;
 		subtree.m_subtreeSize = leftSubTreeSize;
@@ -216,14 +366,11 @@ void	btQuantizedBvh::updateSubtreeHeaders(int leftChildNodexIndex,int rightChild
 
 	if(rightSubTreeSizeInBytes <= MAX_SUBTREE_SIZE_IN_BYTES)
 	{
-		btBvhSubtreeInfo& subtree = m_SubtreeHeaders.expand();
+		btBvhSubtreeInfo& subtree = subtreeHeaders.expand();
 		subtree.setAabbFromQuantizeNode(rightChildNode);
 		subtree.m_rootNodeIndex = rightChildNodexIndex;
 		subtree.m_subtreeSize = rightSubTreeSize;
 	}
-
-	//PCK: update the copy of the size
-	m_subtreeHeaderCount = m_SubtreeHeaders.size();
 }
 
 
@@ -759,6 +906,58 @@ void	btQuantizedBvh::reportRayOverlappingNodex (btNodeOverlapCallback* nodeCallb
 }
 
 
+void	btQuantizedBvh::reportRayPacketOverlappingNodes(btNodeRayPacketCallback* nodeCallback,btRayPacket& packet) const
+{
+	//stackless like walkStacklessQuantizedTreeAgainstRay, a subtree is skipped once no lane hits its root
+	int curIndex = 0;
+	if (m_useQuantization)
+	{
+		const btQuantizedBvhNode* rootNode = &m_quantizedContiguousNodes[0];
+		while (curIndex < m_curNodeIndex)
+		{
+			int rayMask = packet.testAabb(unQuantize(rootNode->m_quantizedAabbMin),unQuantize(rootNode->m_quantizedAabbMax),packet.m_activeMask);
+			bool isLeafNode = rootNode->isLeafNode();
+			if (isLeafNode && rayMask)
+			{
+				nodeCallback->processNode(rootNode->getPartId(),rootNode->getTriangleIndex(),rayMask);
+			}
+			if (rayMask || isLeafNode)
+			{
+				rootNode++;
+				curIndex++;
+			} else
+			{
+				int escapeIndex = rootNode->getEscapeIndex();
+				rootNode += escapeIndex;
+				curIndex += escapeIndex;
+			}
+		}
+	} else
+	{
+		const btOptimizedBvhNode* rootNode = &m_contiguousNodes[0];
+		while (curIndex < m_curNodeIndex)
+		{
+			int rayMask = packet.testAabb(rootNode->m_aabbMinOrg,rootNode->m_aabbMaxOrg,packet.m_activeMask);
+			bool isLeafNode = rootNode->m_escapeIndex == -1;
+			if (isLeafNode && rayMask)
+			{
+				nodeCallback->processNode(rootNode->m_subPart,rootNode->m_triangleIndex,rayMask);
+			}
+			if (rayMask || isLeafNode)
+			{
+				rootNode++;
+				curIndex++;
+			} else
+			{
+				int escapeIndex = rootNode->m_escapeIndex;
+				rootNode += escapeIndex;
+				curIndex += escapeIndex;
+			}
+		}
+	}
+}
+
+
 void	btQuantizedBvh::reportBoxCastOverlappingNodex(btNodeOverlapCallback* nodeCallback, const btVector3& raySource, const btVector3& rayTarget, const btVector3& aabbMin,const btVector3& aabbMax) const
 {
 	//always use stackless
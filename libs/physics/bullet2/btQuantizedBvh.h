@@ -30,6 +30,7 @@ class btSerializer;
 
 #include "btVector3.h"
 #include "btAlignedAllocator.h"
+#include "btRayPacket.h"
 
 #ifdef BT_USE_DOUBLE_PRECISION
 #define btQuantizedBvhData btQuantizedBvhDoubleData
@@ -155,6 +156,16 @@ public:
 	virtual void processNode(int subPart, int triangleIndex) = 0;
 };
 
+///btNodeRayPacketCallback gets the leaves of a btQuantizedBvh hit by the rays of a btRayPacket
+class btNodeRayPacketCallback
+{
+public:
+	virtual ~btNodeRayPacketCallback() {};
+
+	///rayMask has a bit for each lane that hits the leaf, processNode may lower m_lambdaMax of those lanes
+	virtual void processNode(int subPart, int triangleIndex, int rayMask) = 0;
+};
+
 #include "btAlignedAllocator.h"
 #include "btAlignedObjectArray.h"
 
@@ -301,8 +312,12 @@ protected:
 
 	
 
+	///builds the tree of the leaf nodes [startIndex,endIndex) at m_curNodeIndex. Large trees are split into subtrees that are
+	///built on the btTaskScheduler (see btThreads.h), the nodes come out the same as with a single thread.
 	void	buildTree	(int startIndex,int endIndex);
 
+	void	buildSubtree(int startIndex,int endIndex,int& curNodeIndex,BvhSubtreeInfoArray& subtreeHeaders);
+
 	int	calcSplittingAxis(int startIndex,int endIndex);
 
 	int	sortAndCalcSplittingIndex(int startIndex,int endIndex,int splitAxis);
@@ -327,6 +342,10 @@ protected:
 
 	void	updateSubtreeHeaders(int leftChildNodexIndex,int rightChildNodexIndex);
 
+	void	updateSubtreeHeaders(int leftChildNodexIndex,int rightChildNodexIndex,BvhSubtreeInfoArray& subtreeHeaders);
+
+	friend struct btBvhParallelBuilder;
+
 public:
 	
 	BT_DECLARE_ALIGNED_ALLOCATOR();
@@ -346,6 +365,8 @@ public:
 	void	reportAabbOverlappingNodex(btNodeOverlapCallback* nodeCallback,const btVector3& aabbMin,const btVector3& aabbMax) const;
 	void	reportRayOverlappingNodex (btNodeOverlapCallback* nodeCallback, const btVector3& raySource, const btVector3& rayTarget) const;
 	void	reportBoxCastOverlappingNodex(btNodeOverlapCallback* nodeCallback, const btVector3& raySource, const btVector3& rayTarget, const btVector3& aabbMin,const btVector3& aabbMax) const;
+	///walks the tree once for all rays of the packet, which are in the space of the tree. Read-only, several threads may walk a tree at the same time.
+	void	reportRayPacketOverlappingNodes(btNodeRayPacketCallback* nodeCallback,btRayPacket& packet) const;
 
 		SIMD_FORCE_INLINE void quantize(unsigned short* out, const btVector3& point,int isMax) const
 	{
@@ -14,6 +14,7 @@
 // Ogre (www.ogre3d.org).
 
 #include "btQuickprof.h"
+#include "btThreads.h"
 
 #ifndef BT_NO_PROFILE
 
@@ -443,6 +444,10 @@ unsigned long int			CProfileManager::ResetTime = 0;
  *=============================================================================================*/
 void	CProfileManager::Start_Profile( const char * name )
 {
+	//the profile tree isn't thread-safe, only the main thread records
+	if (btGetCurrentThreadIndex() != 0)
+		return;
+
 	if (name != CurrentNode->Get_Name()) {
 		CurrentNode = CurrentNode->Get_Sub_Node( name );
 	} 
@@ -456,6 +461,9 @@ void	CProfileManager::Start_Profile( const char * name )
  *=============================================================================================*/
 void	CProfileManager::Stop_Profile( void )
 {
+	if (btGetCurrentThreadIndex() != 0)
+		return;
+
 	// Return will indicate whether we should back up to our parent (we may
 	// be profiling a recursive function)
 	if (CurrentNode->Return()) {
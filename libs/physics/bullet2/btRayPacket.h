@@ -0,0 +1,153 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2012 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef BT_RAY_PACKET_H
+#define BT_RAY_PACKET_H
+
+#include "btVector3.h"
+
+///number of rays traversed together, 8 with AVX, 4 with SSE and for the portable fallback
+#if defined(__AVX__) && !defined(BT_USE_DOUBLE_PRECISION)
+#define BT_RAY_PACKET_SIZE 8
+#define BT_RAY_PACKET_AVX
+#include <immintrin.h>
+#elif !defined(BT_USE_DOUBLE_PRECISION) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define BT_RAY_PACKET_SIZE 4
+#define BT_RAY_PACKET_SSE
+#include <xmmintrin.h>
+#else
+#define BT_RAY_PACKET_SIZE 4
+#endif
+
+///btRayPacket holds up to BT_RAY_PACKET_SIZE ray segments as structure of arrays, so one node of a tree is tested against all of them at once.
+///Lane i covers from + t*(to-from) for t in [0,m_lambdaMax[i]], swept by the box [m_boxMin[i],m_boxMax[i]] for convex casts.
+///Traversals lower m_lambdaMax as closer hits are found, the remaining nodes are then culled against the closest hit so far.
+ATTRIBUTE_ALIGNED64 (struct)	btRayPacket
+{
+	BT_DECLARE_ALIGNED_ALLOCATOR();
+
+	btScalar	m_from[3][BT_RAY_PACKET_SIZE];
+	///1/(to-from), BT_LARGE_FLOAT for axis parallel rays like btBroadphaseRayCallback::m_rayDirectionInverse
+	btScalar	m_invDirection[3][BT_RAY_PACKET_SIZE];
+	btScalar	m_boxMin[3][BT_RAY_PACKET_SIZE];
+	btScalar	m_boxMax[3][BT_RAY_PACKET_SIZE];
+	btScalar	m_lambdaMax[BT_RAY_PACKET_SIZE];
+
+	///bounds of all segments including their boxes
+	btVector3	m_aabbMin;
+	btVector3	m_aabbMax;
+
+	///lanes that hold a ray
+	int		m_activeMask;
+
+	btRayPacket()
+	{
+		clear();
+	}
+
+	///empty lanes never hit anything
+	void	clear()
+	{
+		for (int k=0;k<3;k++)
+		{
+			for (int l=0;l<BT_RAY_PACKET_SIZE;l++)
+			{
+				m_from[k][l] = btScalar(0.);
+				m_invDirection[k][l] = btScalar(0.);
+				m_boxMin[k][l] = btScalar(0.);
+				m_boxMax[k][l] = btScalar(0.);
+			}
+		}
+		for (int l=0;l<BT_RAY_PACKET_SIZE;l++)
+			m_lambdaMax[l] = btScalar(-1.);
+		m_aabbMin.setValue(btScalar(BT_LARGE_FLOAT),btScalar(BT_LARGE_FLOAT),btScalar(BT_LARGE_FLOAT));
+		m_aabbMax.setValue(btScalar(-BT_LARGE_FLOAT),btScalar(-BT_LARGE_FLOAT),btScalar(-BT_LARGE_FLOAT));
+		m_activeMask = 0;
+	}
+
+	void	setRay(int lane,const btVector3& from,const btVector3& to,const btVector3& boxMin=btVector3(0,0,0),const btVector3& boxMax=btVector3(0,0,0))
+	{
+		btVector3 direction = to-from;
+		for (int k=0;k<3;k++)
+		{
+			m_from[k][lane] = from[k];
+			m_invDirection[k][lane] = direction[k] == btScalar(0.) ? btScalar(BT_LARGE_FLOAT) : btScalar(1.)/direction[k];
+			m_boxMin[k][lane] = boxMin[k];
+			m_boxMax[k][lane] = boxMax[k];
+		}
+		m_lambdaMax[lane] = btScalar(1.);
+		btVector3 segmentMin = from;
+		btVector3 segmentMax = from;
+		segmentMin.setMin(to);
+		segmentMax.setMax(to);
+		m_aabbMin.setMin(segmentMin+boxMin);
+		m_aabbMax.setMax(segmentMax+boxMax);
+		m_activeMask |= 1<<lane;
+	}
+
+	///the lanes of rayMask whose segment hits the aabb, widened by the box of the lane
+	SIMD_FORCE_INLINE int	testAabb(const btVector3& aabbMin,const btVector3& aabbMax,int rayMask) const
+	{
+#if defined(BT_RAY_PACKET_AVX)
+		__m256 tmin = _mm256_setzero_ps();
+		__m256 tmax = _mm256_loadu_ps(m_lambdaMax);
+		for (int k=0;k<3;k++)
+		{
+			__m256 from = _mm256_loadu_ps(m_from[k]);
+			__m256 invDirection = _mm256_loadu_ps(m_invDirection[k]);
+			__m256 t0 = _mm256_mul_ps(_mm256_sub_ps(_mm256_sub_ps(_mm256_set1_ps(aabbMin[k]),_mm256_loadu_ps(m_boxMax[k])),from),invDirection);
+			__m256 t1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_sub_ps(_mm256_set1_ps(aabbMax[k]),_mm256_loadu_ps(m_boxMin[k])),from),invDirection);
+			tmin = _mm256_max_ps(tmin,_mm256_min_ps(t0,t1));
+			tmax = _mm256_min_ps(tmax,_mm256_max_ps(t0,t1));
+		}
+		return _mm256_movemask_ps(_mm256_cmp_ps(tmin,tmax,_CMP_LE_OQ)) & rayMask;
+#elif defined(BT_RAY_PACKET_SSE)
+		__m128 tmin = _mm_setzero_ps();
+		__m128 tmax = _mm_loadu_ps(m_lambdaMax);
+		for (int k=0;k<3;k++)
+		{
+			__m128 from = _mm_loadu_ps(m_from[k]);
+			__m128 invDirection = _mm_loadu_ps(m_invDirection[k]);
+			__m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(_mm_set1_ps(aabbMin[k]),_mm_loadu_ps(m_boxMax[k])),from),invDirection);
+			__m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(_mm_set1_ps(aabbMax[k]),_mm_loadu_ps(m_boxMin[k])),from),invDirection);
+			tmin = _mm_max_ps(tmin,_mm_min_ps(t0,t1));
+			tmax = _mm_min_ps(tmax,_mm_max_ps(t0,t1));
+		}
+		return _mm_movemask_ps(_mm_cmple_ps(tmin,tmax)) & rayMask;
+#else
+		int hitMask = 0;
+		for (int l=0;l<BT_RAY_PACKET_SIZE;l++)
+		{
+			if (!(rayMask & (1<<l)))
+				continue;
+			btScalar tmin = btScalar(0.);
+			btScalar tmax = m_lambdaMax[l];
+			for (int k=0;k<3;k++)
+			{
+				btScalar t0 = (aabbMin[k]-m_boxMax[k][l]-m_from[k][l])*m_invDirection[k][l];
+				btScalar t1 = (aabbMax[k]-m_boxMin[k][l]-m_from[k][l])*m_invDirection[k][l];
+				tmin = btMax(tmin,btMin(t0,t1));
+				tmax = btMin(tmax,btMax(t0,t1));
+			}
+			if (tmin <= tmax)
+				hitMask |= 1<<l;
+		}
+		return hitMask;
+#endif
+	}
+};
+
+#endif //BT_RAY_PACKET_H
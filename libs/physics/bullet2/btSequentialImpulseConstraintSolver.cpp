@@ -32,8 +32,10 @@ subject to the following restrictions:
 #include "btSolverBody.h"
 #include "btSolverConstraint.h"
 #include "btAlignedObjectArray.h"
+#include "btThreads.h"
 #include <string.h> //for memset
 
+//only counted outside of btParallelFor loops, islands may be solved on several threads
 int		gNumSplitImpulseRecoveries = 0;
 
 btSequentialImpulseConstraintSolver::btSequentialImpulseConstraintSolver()
@@ -181,7 +183,8 @@ void	btSequentialImpulseConstraintSolver::resolveSplitPenetrationImpulseCacheFri
 {
 		if (c.m_rhsPenetration)
         {
-			gNumSplitImpulseRecoveries++;
+			if (!btThreadsAreRunning())
+				gNumSplitImpulseRecoveries++;
 			btScalar deltaImpulse = c.m_rhsPenetration-btScalar(c.m_appliedPushImpulse)*c.m_cfm;
 			const btScalar deltaVel1Dotn	=	c.m_contactNormal.dot(body1.internalGetPushVelocity()) 	+ c.m_relpos1CrossNormal.dot(body1.internalGetTurnVelocity());
 			const btScalar deltaVel2Dotn	=	-c.m_contactNormal.dot(body2.internalGetPushVelocity()) + c.m_relpos2CrossNormal.dot(body2.internalGetTurnVelocity());
@@ -209,7 +212,8 @@ void	btSequentialImpulseConstraintSolver::resolveSplitPenetrationImpulseCacheFri
 	if (!c.m_rhsPenetration)
 		return;
 
-	gNumSplitImpulseRecoveries++;
+	if (!btThreadsAreRunning())
+		gNumSplitImpulseRecoveries++;
 
 	__m128 cpAppliedImp = _mm_set1_ps(c.m_appliedPushImpulse);
 	__m128	lowerLimit1 = _mm_set1_ps(c.m_lowerLimit);
@@ -985,6 +989,13 @@ btScalar btSequentialImpulseConstraintSolver::solveGroupCacheFriendlySetup(btCol
 		}
 	}
 
+	if (infoGlobal.m_solverMode & SOLVER_SIMD_SOA)
+	{
+		BT_PROFILE("batchConstraints");
+		m_batchedContactConstraints.setupContactBlocks(m_tmpSolverContactConstraintPool,m_orderTmpConstraintPool);
+		m_batchedFrictionConstraints.setupFrictionBlocks(m_tmpSolverContactFrictionConstraintPool,m_tmpSolverContactConstraintPool,m_batchedContactConstraints);
+	}
+
 	return 0.f;
 
 }
@@ -1028,7 +1039,54 @@ btScalar btSequentialImpulseConstraintSolver::solveSingleIteration(int iteration
 		}
 	}
 
-	if (infoGlobal.m_solverMode & SOLVER_SIMD)
+	if (infoGlobal.m_solverMode & SOLVER_SIMD_SOA)
+	{
+		///solve all joint constraints, one row at a time
+		for (j=0;j<m_tmpSolverNonContactConstraintPool.size();j++)
+		{
+			btSolverConstraint& constraint = m_tmpSolverNonContactConstraintPool[m_orderNonContactConstraintPool[j]];
+			if (iteration < constraint.m_overrideNumSolverIterations)
+				resolveSingleConstraintRowGenericSIMD(*constraint.m_solverBodyA,*constraint.m_solverBodyB,constraint);
+		}
+
+		if (iteration< infoGlobal.m_numIterations)
+		{
+			for (j=0;j<numConstraints;j++)
+			{
+				constraints[j]->solveConstraintObsolete(constraints[j]->getRigidBodyA(),constraints[j]->getRigidBodyB(),infoGlobal.m_timeStep);
+			}
+
+			///solve the contact and friction constraints in blocks of BT_SOA_WIDTH rows, the batched order stays fixed for all iterations
+			m_batchedContactConstraints.solveContactBlocks();
+			const btAlignedObjectArray<int>& unbatchedContacts = m_batchedContactConstraints.getUnbatchedRows();
+			for (j=0;j<unbatchedContacts.size();j++)
+			{
+				const btSolverConstraint& solveManifold = m_tmpSolverContactConstraintPool[unbatchedContacts[j]];
+				resolveSingleConstraintRowLowerLimitSIMD(*solveManifold.m_solverBodyA,*solveManifold.m_solverBodyB,solveManifold);
+			}
+
+			m_batchedFrictionConstraints.solveFrictionBlocks();
+			const btAlignedObjectArray<int>& unbatchedFriction = m_batchedFrictionConstraints.getUnbatchedRows();
+			if (unbatchedFriction.size())
+			{
+				//these rows read the contact impulses from the rows
+				m_batchedContactConstraints.writeBackAppliedImpulses();
+			}
+			for (j=0;j<unbatchedFriction.size();j++)
+			{
+				btSolverConstraint& solveManifold = m_tmpSolverContactFrictionConstraintPool[unbatchedFriction[j]];
+				btScalar totalImpulse = m_tmpSolverContactConstraintPool[solveManifold.m_frictionIndex].m_appliedImpulse;
+
+				if (totalImpulse>btScalar(0))
+				{
+					solveManifold.m_lowerLimit = -(solveManifold.m_friction*totalImpulse);
+					solveManifold.m_upperLimit = solveManifold.m_friction*totalImpulse;
+
+					resolveSingleConstraintRowGenericSIMD(*solveManifold.m_solverBodyA,*solveManifold.m_solverBodyB,solveManifold);
+				}
+			}
+		}
+	} else if (infoGlobal.m_solverMode & SOLVER_SIMD)
 	{
 		///solve all joint constraints, using SIMD, if available
 		for (j=0;j<m_tmpSolverNonContactConstraintPool.size();j++)
@@ -1180,6 +1238,12 @@ btScalar btSequentialImpulseConstraintSolver::solveGroupCacheFriendlyFinish(btCo
 	int numPoolConstraints = m_tmpSolverContactConstraintPool.size();
 	int i,j;
 
+	if (infoGlobal.m_solverMode & SOLVER_SIMD_SOA)
+	{
+		m_batchedContactConstraints.writeBackAppliedImpulses();
+		m_batchedFrictionConstraints.writeBackAppliedImpulses();
+	}
+
 	for (j=0;j<numPoolConstraints;j++)
 	{
 
@@ -1231,6 +1295,8 @@ btScalar btSequentialImpulseConstraintSolver::solveGroupCacheFriendlyFinish(btCo
 	m_tmpSolverContactConstraintPool.resize(0);
 	m_tmpSolverNonContactConstraintPool.resize(0);
 	m_tmpSolverContactFrictionConstraintPool.resize(0);
+	m_batchedContactConstraints.clear();
+	m_batchedFrictionConstraints.clear();
 
 	return 0.f;
 }
@@ -1262,8 +1328,8 @@ void	btSequentialImpulseConstraintSolver::reset()
 
 btRigidBody& btSequentialImpulseConstraintSolver::getFixedBody()
 {
+	//constructed massless, no need to reset it on every call: islands solved on other threads read it concurrently
 	static btRigidBody s_fixed(0, 0,0);
-	s_fixed.setMassProps(btScalar(0.),btVector3(btScalar(0.),btScalar(0.),btScalar(0.)));
 	return s_fixed;
 }
 
@@ -23,6 +23,7 @@ class btIDebugDraw;
 #include "btSolverConstraint.h"
 #include "btTypedConstraint.h"
 #include "btManifoldPoint.h"
+#include "btBatchedConstraints.h"
 
 ///The btSequentialImpulseConstraintSolver is a fast SIMD implementation of the Projected Gauss Seidel (iterative LCP) method.
 class btSequentialImpulseConstraintSolver : public btConstraintSolver
@@ -37,6 +38,8 @@ protected:
 	btAlignedObjectArray<int>	m_orderFrictionConstraintPool;
 	btAlignedObjectArray<btTypedConstraint::btConstraintInfo1> m_tmpConstraintSizesPool;
 	int							m_maxOverrideNumSolverIterations;
+	btBatchedConstraints		m_batchedContactConstraints;
+	btBatchedConstraints		m_batchedFrictionConstraints;
 
 	void setupFrictionConstraint(	btSolverConstraint& solverConstraint, const btVector3& normalAxis,btRigidBody* solverBodyA,btRigidBody* solverBodyIdB,
 									btManifoldPoint& cp,const btVector3& rel_pos1,const btVector3& rel_pos2,
@@ -0,0 +1,254 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2012 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include "btThreads.h"
+#include "btAlignedAllocator.h"
+#include "btMinMax.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+
+static btTaskScheduler*		gTaskScheduler = 0;
+static std::atomic<int>		gThreadsRunning(0);
+static thread_local int		gThreadIndex = 0;
+
+void	btSpinMutex::lock()
+{
+	while (!tryLock())
+	{
+		//the owner may be waiting for our core, don't burn the time slice
+		while (m_lock.load(std::memory_order_relaxed))
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+struct btTaskSchedulerState
+{
+	std::mutex					m_mutex;
+	std::condition_variable		m_wake;
+	std::condition_variable		m_done;
+	std::thread*				m_threads;
+
+	const btIParallelForBody*	m_body;
+	int							m_begin;
+	int							m_end;
+	int							m_grainSize;
+	int							m_numChunks;
+	std::atomic<int>			m_nextChunk;
+	int							m_generation;
+	int							m_active;
+	bool						m_quit;
+};
+
+static void	btRunChunks(btTaskSchedulerState* s,const btIParallelForBody* body,int begin,int end,int grainSize,int numChunks)
+{
+	for (;;)
+	{
+		int chunk = s->m_nextChunk.fetch_add(1,std::memory_order_relaxed);
+		if (chunk >= numChunks)
+			break;
+		int iBegin = begin + chunk*grainSize;
+		body->forLoop(iBegin,btMin(iBegin+grainSize,end));
+	}
+}
+
+static void	btWorkerThreadMain(btTaskSchedulerState* s,int threadIndex)
+{
+	gThreadIndex = threadIndex;
+	int seen = 0;
+	for (;;)
+	{
+		const btIParallelForBody* body;
+		int begin,end,grainSize,numChunks;
+		{
+			std::unique_lock<std::mutex> lock(s->m_mutex);
+			while (!s->m_quit && s->m_generation == seen)
+			{
+				s->m_wake.wait(lock);
+			}
+			if (s->m_quit)
+				return;
+			seen = s->m_generation;
+			body = s->m_body;
+			begin = s->m_begin;
+			end = s->m_end;
+			grainSize = s->m_grainSize;
+			numChunks = s->m_numChunks;
+		}
+
+		btRunChunks(s,body,begin,end,grainSize,numChunks);
+
+		std::lock_guard<std::mutex> lock(s->m_mutex);
+		if (--s->m_active == 0)
+		{
+			s->m_done.notify_one();
+		}
+	}
+}
+
+btTaskScheduler::btTaskScheduler(int numThreads)
+:m_state(0),
+m_numThreads(1)
+{
+	void* mem = btAlignedAlloc(sizeof(btTaskSchedulerState),16);
+	m_state = new (mem) btTaskSchedulerState;
+	m_state->m_threads = 0;
+	m_state->m_body = 0;
+	m_state->m_begin = 0;
+	m_state->m_end = 0;
+	m_state->m_grainSize = 1;
+	m_state->m_numChunks = 0;
+	m_state->m_nextChunk = 0;
+	m_state->m_generation = 0;
+	m_state->m_active = 0;
+	m_state->m_quit = false;
+
+	startThreads(numThreads);
+}
+
+btTaskScheduler::~btTaskScheduler()
+{
+	stopThreads();
+	m_state->~btTaskSchedulerState();
+	btAlignedFree(m_state);
+}
+
+void	btTaskScheduler::startThreads(int numThreads)
+{
+	m_numThreads = btMax(1,btMin(numThreads,int(BT_MAX_THREAD_COUNT)));
+	m_state->m_quit = false;
+	m_state->m_generation = 0;
+	if (m_numThreads > 1)
+	{
+		m_state->m_threads = (std::thread*)btAlignedAlloc(sizeof(std::thread)*(m_numThreads-1),16);
+		for (int i=1;i<m_numThreads;i++)
+		{
+			new (&m_state->m_threads[i-1]) std::thread(btWorkerThreadMain,m_state,i);
+		}
+	}
+}
+
+void	btTaskScheduler::stopThreads()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_state->m_mutex);
+		m_state->m_quit = true;
+	}
+	m_state->m_wake.notify_all();
+
+	if (m_state->m_threads)
+	{
+		for (int i=1;i<m_numThreads;i++)
+		{
+			m_state->m_threads[i-1].join();
+			m_state->m_threads[i-1].~thread();
+		}
+		btAlignedFree(m_state->m_threads);
+		m_state->m_threads = 0;
+	}
+	m_numThreads = 1;
+}
+
+void	btTaskScheduler::setNumThreads(int numThreads)
+{
+	btAssert(!btThreadsAreRunning());
+	stopThreads();
+	startThreads(numThreads);
+}
+
+void	btTaskScheduler::parallelFor(int iBegin,int iEnd,int grainSize,const btIParallelForBody& body)
+{
+	int count = iEnd-iBegin;
+	if (count <= 0)
+		return;
+	grainSize = btMax(grainSize,1);
+	int numChunks = (count+grainSize-1)/grainSize;
+
+	//not worth waking anyone for a single chunk
+	if (m_numThreads <= 1 || numChunks == 1)
+	{
+		body.forLoop(iBegin,iEnd);
+		return;
+	}
+
+	btTaskSchedulerState* s = m_state;
+	gThreadsRunning.store(1,std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> lock(s->m_mutex);
+		s->m_body = &body;
+		s->m_begin = iBegin;
+		s->m_end = iEnd;
+		s->m_grainSize = grainSize;
+		s->m_numChunks = numChunks;
+		s->m_nextChunk.store(0,std::memory_order_relaxed);
+		s->m_active = m_numThreads-1;
+		++s->m_generation;
+	}
+	s->m_wake.notify_all();
+
+	btRunChunks(s,&body,iBegin,iEnd,grainSize,numChunks);
+
+	//the mutex hand-off makes the writes of every worker visible to the caller
+	{
+		std::unique_lock<std::mutex> lock(s->m_mutex);
+		while (s->m_active > 0)
+		{
+			s->m_done.wait(lock);
+		}
+	}
+	gThreadsRunning.store(0,std::memory_order_relaxed);
+}
+
+void	btSetTaskScheduler(btTaskScheduler* scheduler)
+{
+	btAssert(!btThreadsAreRunning());
+	gTaskScheduler = scheduler;
+}
+
+btTaskScheduler*	btGetTaskScheduler()
+{
+	return gTaskScheduler;
+}
+
+void	btParallelFor(int iBegin,int iEnd,int grainSize,const btIParallelForBody& body)
+{
+	if (gTaskScheduler && !btThreadsAreRunning())
+	{
+		gTaskScheduler->parallelFor(iBegin,iEnd,grainSize,body);
+	} else if (iBegin < iEnd)
+	{
+		body.forLoop(iBegin,iEnd);
+	}
+}
+
+int		btGetCurrentThreadIndex()
+{
+	return gThreadIndex;
+}
+
+int		btGetTaskSchedulerThreadCount()
+{
+	return gTaskScheduler ? gTaskScheduler->getNumThreads() : 1;
+}
+
+bool	btThreadsAreRunning()
+{
+	return gThreadsRunning.load(std::memory_order_relaxed) != 0;
+}
@@ -0,0 +1,113 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2012 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef BT_THREADS_H
+#define BT_THREADS_H
+
+#include "btScalar.h"
+
+#include <atomic>
+
+///maximum number of threads a btTaskScheduler can run, per-thread state in the collision dispatcher and dynamics world is sized by it
+#define BT_MAX_THREAD_COUNT 64
+
+///btSpinMutex guards very short critical sections, such as a pool allocator shared by the worker threads
+class btSpinMutex
+{
+	std::atomic<int>	m_lock;
+
+	btSpinMutex(const btSpinMutex&);
+	btSpinMutex& operator=(const btSpinMutex&);
+
+public:
+
+	btSpinMutex()
+		:m_lock(0)
+	{
+	}
+
+	void	lock();
+
+	void	unlock()
+	{
+		m_lock.store(0,std::memory_order_release);
+	}
+
+	bool	tryLock()
+	{
+		return m_lock.exchange(1,std::memory_order_acquire) == 0;
+	}
+};
+
+///btIParallelForBody is the body of a btParallelFor loop.
+///forLoop is called with disjoint [iBegin,iEnd) ranges, possibly on several threads at the same time.
+class btIParallelForBody
+{
+public:
+
+	virtual ~btIParallelForBody() {}
+
+	virtual void	forLoop(int iBegin,int iEnd) const = 0;
+};
+
+struct btTaskSchedulerState;
+
+///btTaskScheduler runs btParallelFor loops on a fixed set of worker threads. The calling thread works on the loop as thread 0.
+///Install one with btSetTaskScheduler, btCollisionDispatcherMt and btDiscreteDynamicsWorldMt then use it for every simulation step.
+class btTaskScheduler
+{
+	btTaskSchedulerState*	m_state;
+	int						m_numThreads;
+
+	void	startThreads(int numThreads);
+	void	stopThreads();
+
+public:
+
+	///numThreads includes the calling thread, 1 runs every loop inline
+	btTaskScheduler(int numThreads);
+
+	~btTaskScheduler();
+
+	int		getNumThreads() const
+	{
+		return m_numThreads;
+	}
+
+	///restarts the worker threads, must not be called while a loop is running
+	void	setNumThreads(int numThreads);
+
+	void	parallelFor(int iBegin,int iEnd,int grainSize,const btIParallelForBody& body);
+};
+
+void				btSetTaskScheduler(btTaskScheduler* scheduler);
+
+btTaskScheduler*	btGetTaskScheduler();
+
+///btParallelFor splits [iBegin,iEnd) in chunks of grainSize and runs them on the current task scheduler.
+///Without a scheduler, or when called from inside another parallel loop, the whole range runs on the calling thread.
+void	btParallelFor(int iBegin,int iEnd,int grainSize,const btIParallelForBody& body);
+
+///index of the calling thread within the task scheduler, in [0,BT_MAX_THREAD_COUNT). Threads not owned by the scheduler report 0.
+int		btGetCurrentThreadIndex();
+
+///number of threads btParallelFor may use, 1 without a task scheduler
+int		btGetTaskSchedulerThreadCount();
+
+///true while a btParallelFor loop is being processed by the worker threads
+bool	btThreadsAreRunning();
+
+#endif //BT_THREADS_H
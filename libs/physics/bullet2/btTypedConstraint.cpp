@@ -145,8 +145,8 @@ const char*	btTypedConstraint::serialize(void* dataBuffer, btSerializer* seriali
 
 btRigidBody& btTypedConstraint::getFixedBody()
 {
+	//constructed massless, no need to reset it on every call: islands solved on other threads read it concurrently
 	static btRigidBody s_fixed(0, 0,0);
-	s_fixed.setMassProps(btScalar(0.),btVector3(btScalar(0.),btScalar(0.),btScalar(0.)));
 	return s_fixed;
 }
 
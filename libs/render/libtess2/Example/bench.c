@@ -0,0 +1,266 @@
+//
+// Tesselates classes of building footprints with the full sweep and with the simple polygon
+// fast path. Then tesselates a city block worth of footprints, some with courtyards, with a new
+// tesselator per polygon, with one reused tesselator and with the batch API on one thread
+// and on all CPUs. Prints the time per batch and checks that every way gives the same output.
+//   bench [polygons iterations]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "tesselator.h"
+
+#ifdef _WIN32
+#include <windows.h>
+static double getTime()
+{
+	LARGE_INTEGER freq, t;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&t);
+	return (double)t.QuadPart / (double)freq.QuadPart;
+}
+#else
+static double getTime()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+#endif
+
+static unsigned int randomState = 12345;
+
+static float randomRange(float lo, float hi)
+{
+	randomState = randomState*1664525u + 1013904223u;
+	return lo + (hi-lo) * (float)(randomState >> 8) / (float)(1 << 24);
+}
+
+// Walks around a rectangle with notched edges, the kind of outline building footprints have.
+static int addFootprint(float* pts, float cx, float cy, float w, float h, int notches, int reverse)
+{
+	float corners[4][2] = { {cx-w, cy-h}, {cx+w, cy-h}, {cx+w, cy+h}, {cx-w, cy+h} };
+	int n = 0, i, j;
+	for (i = 0; i < 4; i++) {
+		const float* a = corners[reverse ? 3-i : i];
+		const float* b = corners[reverse ? (6-i)%4 : (i+1)%4];
+		float nx = (b[1]-a[1]) * 0.05f, ny = (a[0]-b[0]) * 0.05f;
+		pts[n*2] = a[0]; pts[n*2+1] = a[1]; n++;
+		for (j = 0; j < notches; j++) {
+			float t0 = (j*2+1) / (float)(notches*2+1), t1 = (j*2+2) / (float)(notches*2+1);
+			float d = randomRange(-1.0f, 1.0f);
+			pts[n*2] = a[0] + (b[0]-a[0])*t0; pts[n*2+1] = a[1] + (b[1]-a[1])*t0; n++;
+			pts[n*2] = pts[n*2-2] + nx*d; pts[n*2+1] = pts[n*2-1] + ny*d; n++;
+			pts[n*2] = a[0] + (b[0]-a[0])*t1 + nx*d; pts[n*2+1] = a[1] + (b[1]-a[1])*t1 + ny*d; n++;
+			pts[n*2] = a[0] + (b[0]-a[0])*t1; pts[n*2+1] = a[1] + (b[1]-a[1])*t1; n++;
+		}
+	}
+	return n;
+}
+
+// Footprints with minNotches to maxNotches notches per edge, every courtyardEvery'th with a courtyard.
+static void makeCity(TESSpolygon* polygons, int count, int minNotches, int maxNotches, int courtyardEvery,
+					 float** vertices, int** contourSizes)
+{
+	int maxPoints = 2 * 4 * (1 + 4*maxNotches);
+	float* pts = (float*)malloc(sizeof(float) * 2 * maxPoints * count);
+	int* sizes = (int*)malloc(sizeof(int) * 2 * count);
+	int i, n = 0;
+	for (i = 0; i < count; i++) {
+		float cx = (i % 100) * 30.0f, cy = (i / 100) * 30.0f;
+		float w = randomRange(5.0f, 12.0f), h = randomRange(5.0f, 12.0f);
+		polygons[i].vertices = &pts[n*2];
+		polygons[i].stride = sizeof(float) * 2;
+		polygons[i].contourSizes = &sizes[i*2];
+		polygons[i].contourCount = 1;
+		sizes[i*2] = addFootprint(&pts[n*2], cx, cy, w, h, minNotches + (int)randomRange(0, (float)(maxNotches - minNotches + 1)), 0);
+		n += sizes[i*2];
+		if (courtyardEvery > 0 && i % courtyardEvery == 0) {
+			// Courtyard
+			sizes[i*2+1] = addFootprint(&pts[n*2], cx, cy, w*0.4f, h*0.4f, (int)randomRange(0, 2), 1);
+			n += sizes[i*2+1];
+			polygons[i].contourCount = 2;
+		}
+	}
+	*vertices = pts;
+	*contourSizes = sizes;
+}
+
+static void addPolygon(TESStesselator* tess, const TESSpolygon* polygon)
+{
+	const char* src = (const char*)polygon->vertices;
+	int i;
+	for (i = 0; i < polygon->contourCount; i++) {
+		tessAddContour(tess, 2, src, polygon->stride, polygon->contourSizes[i]);
+		src += polygon->stride * polygon->contourSizes[i];
+	}
+}
+
+// Total area of the triangles.
+static double triangleArea(TESStesselator* tess)
+{
+	const TESSreal* verts = tessGetVertices(tess);
+	const TESSindex* tris = tessGetElements(tess);
+	double area = 0;
+	int i;
+	for (i = 0; i < tessGetElementCount(tess); i++) {
+		const TESSreal* a = &verts[tris[i*3]*2];
+		const TESSreal* b = &verts[tris[i*3+1]*2];
+		const TESSreal* c = &verts[tris[i*3+2]*2];
+		area += ((b[0]-a[0])*(c[1]-a[1]) - (b[1]-a[1])*(c[0]-a[0])) * 0.5;
+	}
+	return area;
+}
+
+// Tesselates one class of polygons with and without the fast path and compares the covered area.
+static int benchClass(const char* name, int count, int iterations, int minNotches, int maxNotches, int courtyardEvery)
+{
+	TESSpolygon* polygons = (TESSpolygon*)malloc(sizeof(TESSpolygon) * count);
+	TESStesselator* tess = tessNewTess(NULL);
+	float* vertices;
+	int* contourSizes;
+	double times[2], areas[2], t0;
+	int i, j, k, triangles[2];
+
+	makeCity(polygons, count, minNotches, maxNotches, courtyardEvery, &vertices, &contourSizes);
+	for (j = 0; j < 2; j++) {
+		tessSetOption(tess, TESS_SIMPLE_POLYGON_FAST_PATH, j);
+		areas[j] = 0;
+		triangles[j] = 0;
+		for (i = 0; i < count; i++) {
+			addPolygon(tess, &polygons[i]);
+			tessTesselate(tess, TESS_WINDING_ODD, TESS_POLYGONS, 3, 2, 0);
+			areas[j] += triangleArea(tess);
+			triangles[j] += tessGetElementCount(tess);
+		}
+		t0 = getTime();
+		for (k = 0; k < iterations; k++) {
+			for (i = 0; i < count; i++) {
+				addPolygon(tess, &polygons[i]);
+				tessTesselate(tess, TESS_WINDING_ODD, TESS_POLYGONS, 3, 2, 0);
+			}
+		}
+		times[j] = (getTime() - t0) / iterations;
+	}
+	printf("%-18s %8.2f ms %8.2f ms %7.2fx %9d %9d\n", name, times[0]*1000.0, times[1]*1000.0,
+		   times[0] / times[1], triangles[0], triangles[1]);
+
+	tessDeleteTess(tess);
+	free(polygons);
+	free(vertices);
+	free(contourSizes);
+	if (fabs(areas[0] - areas[1]) > 1e-6 * fabs(areas[0])) {
+		printf("  fast path covers a different area!\n");
+		return 0;
+	}
+	return 1;
+}
+
+// Compares the output of one polygon to its range in the batch output.
+static int sameOutput(TESStesselator* tess, TESSbatch* batch, int index, int polySize)
+{
+	const TESSbatchRange* range = &tessGetBatchRanges(batch)[index];
+	const TESSindex* elements = tessGetElements(tess);
+	const TESSindex* batchElements = tessGetBatchElements(batch) + range->baseElement * polySize;
+	int i;
+	if (!range->status || range->vertexCount != tessGetVertexCount(tess) || range->elementCount != tessGetElementCount(tess))
+		return 0;
+	if (memcmp(tessGetVertices(tess), tessGetBatchVertices(batch) + range->baseVertex*2, sizeof(TESSreal) * range->vertexCount*2) != 0)
+		return 0;
+	if (memcmp(tessGetVertexIndices(tess), tessGetBatchVertexIndices(batch) + range->baseVertex, sizeof(TESSindex) * range->vertexCount) != 0)
+		return 0;
+	for (i = 0; i < range->elementCount * polySize; i++) {
+		if (elements[i] == TESS_UNDEF ? batchElements[i] != TESS_UNDEF : batchElements[i] != elements[i] + range->baseVertex)
+			return 0;
+	}
+	return 1;
+}
+
+int main(int argc, char** argv)
+{
+	int count = argc > 2 ? atoi(argv[1]) : 20000;
+	int iterations = argc > 2 ? atoi(argv[2]) : 5;
+	const int polySize = 3;
+	TESSpolygon* polygons;
+	float* vertices;
+	int* contourSizes;
+	TESStesselator* tess;
+	TESSbatch* batches[2];
+	double t0, time;
+	int i, j, k, triangles = 0, ok = 1;
+
+	if (count < 1) count = 1;
+	if (iterations < 1) iterations = 1;
+
+	printf("%-18s %11s %11s %8s %9s %9s\n", "class", "sweep", "fast path", "speedup", "triangles", "fast");
+	ok &= benchClass("rectangles", count, iterations, 0, 0, 0);
+	ok &= benchClass("notched", count, iterations, 1, 3, 0);
+	ok &= benchClass("notched, large", count, iterations, 4, 6, 0);
+	ok &= benchClass("with courtyards", count, iterations, 1, 3, 1);
+	printf("\n");
+
+	polygons = (TESSpolygon*)malloc(sizeof(TESSpolygon) * count);
+	makeCity(polygons, count, 1, 4, 3, &vertices, &contourSizes);
+
+	// A new tesselator per polygon
+	t0 = getTime();
+	for (k = 0; k < iterations; k++) {
+		for (i = 0; i < count; i++) {
+			tess = tessNewTess(NULL);
+			addPolygon(tess, &polygons[i]);
+			tessTesselate(tess, TESS_WINDING_ODD, TESS_POLYGONS, polySize, 2, 0);
+			if (k == 0) triangles += tessGetElementCount(tess);
+			tessDeleteTess(tess);
+		}
+	}
+	time = (getTime() - t0) / iterations;
+	printf("%d polygons, %d triangles\n", count, triangles);
+	printf("%-28s %8.2f ms\n", "new tesselator per polygon", time*1000.0);
+
+	// One tesselator for all polygons
+	tess = tessNewTess(NULL);
+	t0 = getTime();
+	for (k = 0; k < iterations; k++) {
+		for (i = 0; i < count; i++) {
+			addPolygon(tess, &polygons[i]);
+			tessTesselate(tess, TESS_WINDING_ODD, TESS_POLYGONS, polySize, 2, 0);
+		}
+	}
+	time = (getTime() - t0) / iterations;
+	printf("%-28s %8.2f ms\n", "reused tesselator", time*1000.0);
+
+	batches[0] = tessNewBatch(NULL, 1);
+	batches[1] = tessNewBatch(NULL, 0);
+	for (j = 0; j < 2; j++) {
+		if (batches[j] == NULL) {
+			printf("Could not create batch.\n");
+			return 1;
+		}
+		t0 = getTime();
+		for (k = 0; k < iterations; k++)
+			tessBatchTesselate(batches[j], polygons, count, 2, TESS_WINDING_ODD, TESS_POLYGONS, polySize, 2, 0);
+		time = (getTime() - t0) / iterations;
+		printf("%-28s %8.2f ms\n", j == 0 ? "batch, 1 thread" : "batch, all threads", time*1000.0);
+
+		for (i = 0; i < count; i++) {
+			addPolygon(tess, &polygons[i]);
+			tessTesselate(tess, TESS_WINDING_ODD, TESS_POLYGONS, polySize, 2, 0);
+			if (!sameOutput(tess, batches[j], i, polySize)) {
+				printf("  polygon %d differs from tessTesselate()!\n", i);
+				ok = 0;
+				break;
+			}
+		}
+	}
+
+	tessDeleteBatch(batches[0]);
+	tessDeleteBatch(batches[1]);
+	tessDeleteTess(tess);
+	free(polygons);
+	free(vertices);
+	free(contourSizes);
+	printf(ok ? "ok\n" : "FAILED\n");
+	return ok ? 0 : 1;
+}
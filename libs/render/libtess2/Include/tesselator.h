@@ -114,6 +114,16 @@ enum TessElementType
 	TESS_BOUNDARY_CONTOURS,
 };
 
+// Options for tessSetOption().
+// TESS_SIMPLE_POLYGON_FAST_PATH
+//   When the input is a single contour which is convex, or simple (not self-intersecting) with at most 64 vertices,
+//   it is triangulated directly with a fan or by ear clipping, instead of the full sweep. The output follows the
+//   same winding rules, but the polygons may be split differently. Enabled by default.
+enum TessOption
+{
+	TESS_SIMPLE_POLYGON_FAST_PATH,
+};
+
 typedef float TESSreal;
 typedef int TESSindex;
 typedef struct TESStesselator TESStesselator;
@@ -184,6 +194,13 @@ void tessDeleteTess( TESStesselator *tess );
 //   count - number of vertices in contour.
 void tessAddContour( TESStesselator *tess, int size, const void* pointer, int stride, int count );
 
+// tessSetOption() - Toggles optional tessellation parameters
+// Parameters:
+//   tess - pointer to tesselator object.
+//   option - one of TessOption.
+//   value - 1 if enabled, 0 if disabled.
+void tessSetOption( TESStesselator *tess, int option, int value );
+
 // tessTesselate() - tesselate contours.
 // Parameters:
 //   tess - pointer to tesselator object.
@@ -214,6 +231,80 @@ int tessGetElementCount( TESStesselator *tess );
 // tessGetElements() - Returns pointer to the first element.
 const TESSindex* tessGetElements( TESStesselator *tess );
 
+
+// Batch tesselation
+// A batch tesselates many independent polygons with a pool of worker threads. Each worker reuses one
+// tesselator, and the results of all polygons are packed into one vertex array and one element array.
+// The polygons are placed in the arrays in input order, the output does not depend on the number of threads.
+// The allocator passed to tessNewBatch() is called from all worker threads and has to be thread safe.
+
+typedef struct TESSbatch TESSbatch;
+
+// Polygon of a batch, made of one or more contours whose vertices follow each other.
+typedef struct TESSpolygon
+{
+	const void* vertices;		// Pointer to the first coordinate of the first vertex of the first contour.
+	int stride;					// Offset in bytes between consecutive vertices.
+	const int* contourSizes;	// Number of vertices in each contour.
+	int contourCount;			// Number of contours.
+} TESSpolygon;
+
+// Where the result of a polygon is in the batch output.
+typedef struct TESSbatchRange
+{
+	int baseVertex;				// Index of the first vertex of the polygon in tessGetBatchVertices().
+	int vertexCount;			// Number of vertices of the polygon.
+	int baseElement;			// Index of the first element of the polygon in tessGetBatchElements().
+	int elementCount;			// Number of elements of the polygon.
+	int status;					// 1 if the polygon was tesselated, 0 if it failed and has no output.
+} TESSbatchRange;
+
+// tessNewBatch() - Creates a new batch tesselator.
+// Use tessDeleteBatch() to delete it.
+// Parameters:
+//   alloc - pointer to a filled TESSalloc struct or NULL to use default malloc based allocator.
+//   threadCount - number of threads tesselating the polygons, including the calling thread. 0 uses one thread per CPU.
+// Returns:
+//   new batch object.
+TESSbatch* tessNewBatch( TESSalloc* alloc, int threadCount );
+
+// tessDeleteBatch() - Deletes a batch tesselator and stops its threads.
+void tessDeleteBatch( TESSbatch* batch );
+
+// tessBatchTesselate() - tesselates each polygon separately, like adding its contours to a tesselator
+// with tessAddContour() and calling tessTesselate().
+// Parameters:
+//   batch - pointer to batch object.
+//   polygons - array of polygons to be tesselated.
+//   polygonCount - number of polygons.
+//   size - number of coordinates per input vertex. Must be 2 or 3.
+//   windingRule, elementType, polySize, vertexSize, normal - see tessTesselate().
+// Returns:
+//   1 if all polygons succeeded, 0 if some failed, see TESSbatchRange.
+int tessBatchTesselate( TESSbatch* batch, const TESSpolygon* polygons, int polygonCount, int size,
+						int windingRule, int elementType, int polySize, int vertexSize, const TESSreal* normal );
+
+// tessGetBatchVertexCount() - Returns number of vertices of all polygons.
+int tessGetBatchVertexCount( TESSbatch* batch );
+
+// tessGetBatchVertices() - Returns pointer to first coordinate of first vertex.
+const TESSreal* tessGetBatchVertices( TESSbatch* batch );
+
+// tessGetBatchVertexIndices() - Returns pointer to first vertex index.
+// The indices map the generated vertices to the vertices of their own polygon, see tessGetVertexIndices().
+const TESSindex* tessGetBatchVertexIndices( TESSbatch* batch );
+
+// tessGetBatchElementCount() - Returns number of elements of all polygons.
+int tessGetBatchElementCount( TESSbatch* batch );
+
+// tessGetBatchElements() - Returns pointer to the first element.
+// The elements are the same as from tessGetElements(), but the vertex indices point into the vertices
+// of the whole batch, and neighbour indices of TESS_CONNECTED_POLYGONS into the elements of the batch.
+const TESSindex* tessGetBatchElements( TESSbatch* batch );
+
+// tessGetBatchRanges() - Returns the output range and status of each polygon, in input order.
+const TESSbatchRange* tessGetBatchRanges( TESSbatch* batch );
+
 #ifdef __cplusplus
 };
 #endif
@@ -0,0 +1,633 @@
+/*
+** SGI FREE SOFTWARE LICENSE B (Version 2.0, Sept. 18, 2008) 
+** Copyright (C) [dates of first publication] Silicon Graphics, Inc.
+** All Rights Reserved.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+** of the Software, and to permit persons to whom the Software is furnished to do so,
+** subject to the following conditions:
+** 
+** The above copyright notice including the dates of first publication and either this
+** permission notice or a reference to http://oss.sgi.com/projects/FreeB/ shall be
+** included in all copies or substantial portions of the Software. 
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+** INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+** PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL SILICON GRAPHICS, INC.
+** BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+** TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+** OR OTHER DEALINGS IN THE SOFTWARE.
+** 
+** Except as contained in this notice, the name of Silicon Graphics, Inc. shall not
+** be used in advertising or otherwise to promote the sale, use or other dealings in
+** this Software without prior written authorization from Silicon Graphics, Inc.
+*/
+
+#include <stddef.h>
+#include <string.h>
+#include "../Include/tesselator.h"
+#include "tess.h"
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#define TESS_BATCH_MAX_THREADS 64
+#define TESS_BATCH_CHUNK 32		/* polygons taken by a worker at a time */
+
+typedef struct TESSbatchWorker TESSbatchWorker;
+
+struct TESSbatchWorker
+{
+	TESSbatch* batch;
+	TESStesselator* tess;
+
+	/* Results of the polygons tesselated by this worker, copied to the batch output at the end. */
+	TESSreal* vertices;
+	TESSindex* vertexIndices;
+	int vertexCount;
+	int vertexCapacity;
+	TESSindex* elements;
+	int elementIndexCount;
+	int elementIndexCapacity;
+
+	int generation;
+#ifdef _WIN32
+	HANDLE thread;
+#else
+	pthread_t thread;
+#endif
+};
+
+struct TESSbatch
+{
+	TESSalloc alloc;
+
+	TESSbatchWorker* workers;	/* workers[0] is the thread calling tessBatchTesselate() */
+	int workerCount;
+	int threadCount;			/* number of running threads besides the calling thread */
+
+	/* Current job */
+	const TESSpolygon* polygons;
+	int polygonCount;
+	int size;
+	int windingRule;
+	int elementType;
+	int polySize;
+	int vertexSize;
+	const TESSreal* normal;
+	int elementSize;			/* indices per element */
+	int nextPolygon;
+
+	/* Per polygon output, points into the worker arrays until the output is packed. */
+	TESSbatchRange* ranges;
+	int* owners;
+	int rangeCapacity;
+
+	TESSreal* vertices;
+	TESSindex* vertexIndices;
+	int vertexCount;
+	int vertexCapacity;
+	TESSindex* elements;
+	int elementCount;
+	int elementIndexCapacity;
+
+#ifdef _WIN32
+	CRITICAL_SECTION lock;
+	CONDITION_VARIABLE start;
+	CONDITION_VARIABLE done;
+#else
+	pthread_mutex_t lock;
+	pthread_cond_t start;
+	pthread_cond_t done;
+#endif
+	int locked;					/* lock, start and done are initialized */
+	int generation;
+	int busy;
+	int quit;
+};
+
+static void BatchLock( TESSbatch* batch )
+{
+#ifdef _WIN32
+	EnterCriticalSection( &batch->lock );
+#else
+	pthread_mutex_lock( &batch->lock );
+#endif
+}
+
+static void BatchUnlock( TESSbatch* batch )
+{
+#ifdef _WIN32
+	LeaveCriticalSection( &batch->lock );
+#else
+	pthread_mutex_unlock( &batch->lock );
+#endif
+}
+
+/* Grows an array to hold at least 'count' items, keeping the first 'used' items. */
+static void* GrowArray( TESSalloc* alloc, void* ptr, int used, int count, int* capacity, int itemSize )
+{
+	void* newPtr;
+	int newCapacity = *capacity > 0 ? *capacity : 64;
+	while (newCapacity < count)
+		newCapacity *= 2;
+	newPtr = alloc->memalloc( alloc->userData, (unsigned int)(newCapacity * itemSize) );
+	if (newPtr == NULL)
+		return NULL;
+	if (ptr != NULL)
+	{
+		memcpy( newPtr, ptr, (size_t)used * itemSize );
+		alloc->memfree( alloc->userData, ptr );
+	}
+	*capacity = newCapacity;
+	return newPtr;
+}
+
+/* Vertices have room for 3 coordinates, the vertex size can change between batches. */
+static int ReserveVertices( TESSalloc* alloc, TESSreal** vertices, TESSindex** vertexIndices,
+						   int used, int count, int* capacity )
+{
+	int vertexCapacity, indexCapacity;
+	TESSreal* newVertices;
+	TESSindex* newIndices;
+	if (count <= *capacity)
+		return 1;
+	vertexCapacity = *capacity * 3;
+	newVertices = (TESSreal*)GrowArray( alloc, *vertices, used * 3, count * 3, &vertexCapacity, sizeof(TESSreal) );
+	if (newVertices == NULL)
+		return 0;
+	*vertices = newVertices;
+	indexCapacity = *capacity;
+	newIndices = (TESSindex*)GrowArray( alloc, *vertexIndices, used, vertexCapacity / 3, &indexCapacity, sizeof(TESSindex) );
+	if (newIndices == NULL)
+		return 0;
+	*vertexIndices = newIndices;
+	*capacity = vertexCapacity / 3;
+	return 1;
+}
+
+static int ReserveElements( TESSalloc* alloc, TESSindex** elements, int used, int count, int* capacity )
+{
+	TESSindex* newElements;
+	if (count <= *capacity)
+		return 1;
+	newElements = (TESSindex*)GrowArray( alloc, *elements, used, count, capacity, sizeof(TESSindex) );
+	if (newElements == NULL)
+		return 0;
+	*elements = newElements;
+	return 1;
+}
+
+static void TesselatePolygon( TESSbatchWorker* worker, int index )
+{
+	TESSbatch* batch = worker->batch;
+	TESStesselator* tess = worker->tess;
+	const TESSpolygon* polygon = &batch->polygons[index];
+	TESSbatchRange* range = &batch->ranges[index];
+	const unsigned char* src = (const unsigned char*)polygon->vertices;
+	int i, vertexCount, elementIndexCount;
+
+	batch->owners[index] = (int)(worker - batch->workers);
+	range->baseVertex = worker->vertexCount;
+	range->baseElement = worker->elementIndexCount;
+	range->vertexCount = 0;
+	range->elementCount = 0;
+	range->status = 0;
+
+	for (i = 0; i < polygon->contourCount; i++)
+	{
+		tessAddContour( tess, batch->size, src, polygon->stride, polygon->contourSizes[i] );
+		src += polygon->stride * polygon->contourSizes[i];
+	}
+	if (!tessTesselate( tess, batch->windingRule, batch->elementType, batch->polySize, batch->vertexSize, batch->normal ))
+		return;
+
+	vertexCount = tessGetVertexCount( tess );
+	elementIndexCount = tessGetElementCount( tess ) * batch->elementSize;
+	if (!ReserveVertices( &batch->alloc, &worker->vertices, &worker->vertexIndices, worker->vertexCount,
+						  worker->vertexCount + vertexCount, &worker->vertexCapacity ))
+		return;
+	if (!ReserveElements( &batch->alloc, &worker->elements, worker->elementIndexCount,
+						  worker->elementIndexCount + elementIndexCount, &worker->elementIndexCapacity ))
+		return;
+
+	memcpy( &worker->vertices[worker->vertexCount * batch->vertexSize], tessGetVertices( tess ),
+			sizeof(TESSreal) * vertexCount * batch->vertexSize );
+	memcpy( &worker->vertexIndices[worker->vertexCount], tessGetVertexIndices( tess ),
+			sizeof(TESSindex) * vertexCount );
+	memcpy( &worker->elements[worker->elementIndexCount], tessGetElements( tess ),
+			sizeof(TESSindex) * elementIndexCount );
+	worker->vertexCount += vertexCount;
+	worker->elementIndexCount += elementIndexCount;
+
+	range->vertexCount = vertexCount;
+	range->elementCount = tessGetElementCount( tess );
+	range->status = 1;
+}
+
+/* Tesselates polygons until there are none left, called by all threads. */
+static void TesselatePolygons( TESSbatchWorker* worker )
+{
+	TESSbatch* batch = worker->batch;
+	int first, last, i;
+	for (;;)
+	{
+		BatchLock( batch );
+		first = batch->nextPolygon;
+		batch->nextPolygon += TESS_BATCH_CHUNK;
+		BatchUnlock( batch );
+		if (first >= batch->polygonCount)
+			break;
+		last = first + TESS_BATCH_CHUNK < batch->polygonCount ? first + TESS_BATCH_CHUNK : batch->polygonCount;
+		for (i = first; i < last; i++)
+			TesselatePolygon( worker, i );
+	}
+}
+
+#ifdef _WIN32
+static DWORD WINAPI WorkerMain( LPVOID arg )
+#else
+static void* WorkerMain( void* arg )
+#endif
+{
+	TESSbatchWorker* worker = (TESSbatchWorker*)arg;
+	TESSbatch* batch = worker->batch;
+
+	BatchLock( batch );
+	for (;;)
+	{
+		while (worker->generation == batch->generation && !batch->quit)
+		{
+#ifdef _WIN32
+			SleepConditionVariableCS( &batch->start, &batch->lock, INFINITE );
+#else
+			pthread_cond_wait( &batch->start, &batch->lock );
+#endif
+		}
+		if (batch->quit)
+			break;
+		worker->generation = batch->generation;
+		BatchUnlock( batch );
+
+		TesselatePolygons( worker );
+
+		BatchLock( batch );
+		if (--batch->busy == 0)
+		{
+#ifdef _WIN32
+			WakeConditionVariable( &batch->done );
+#else
+			pthread_cond_signal( &batch->done );
+#endif
+		}
+	}
+	BatchUnlock( batch );
+	return 0;
+}
+
+static int CpuCount( void )
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo( &info );
+	return (int)info.dwNumberOfProcessors;
+#else
+	long n = sysconf( _SC_NPROCESSORS_ONLN );
+	return n > 0 ? (int)n : 1;
+#endif
+}
+
+TESSbatch* tessNewBatch( TESSalloc* alloc, int threadCount )
+{
+	TESSbatch* batch;
+	int i;
+
+	if (threadCount <= 0)
+		threadCount = CpuCount();
+	if (threadCount > TESS_BATCH_MAX_THREADS)
+		threadCount = TESS_BATCH_MAX_THREADS;
+
+	if (alloc == NULL)
+	{
+		TESSalloc heap;
+		memset( &heap, 0, sizeof(heap) );
+		heap.memalloc = heapAlloc;
+		heap.memrealloc = heapRealloc;
+		heap.memfree = heapFree;
+		batch = (TESSbatch*)heap.memalloc( heap.userData, sizeof(TESSbatch) );
+		if (batch == NULL)
+			return NULL;
+		memset( batch, 0, sizeof(TESSbatch) );
+		batch->alloc = heap;
+	}
+	else
+	{
+		batch = (TESSbatch*)alloc->memalloc( alloc->userData, sizeof(TESSbatch) );
+		if (batch == NULL)
+			return NULL;
+		memset( batch, 0, sizeof(TESSbatch) );
+		batch->alloc = *alloc;
+	}
+
+	/* Initialized before anything can fail, tessDeleteBatch() destroys them on the error path. */
+	if (threadCount > 1)
+	{
+#ifdef _WIN32
+		InitializeCriticalSection( &batch->lock );
+		InitializeConditionVariable( &batch->start );
+		InitializeConditionVariable( &batch->done );
+#else
+		pthread_mutex_init( &batch->lock, NULL );
+		pthread_cond_init( &batch->start, NULL );
+		pthread_cond_init( &batch->done, NULL );
+#endif
+		batch->locked = 1;
+	}
+
+	batch->workers = (TESSbatchWorker*)batch->alloc.memalloc( batch->alloc.userData, sizeof(TESSbatchWorker) * threadCount );
+	if (batch->workers == NULL)
+		goto error;
+	memset( batch->workers, 0, sizeof(TESSbatchWorker) * threadCount );
+	batch->workerCount = threadCount;
+	for (i = 0; i < threadCount; i++)
+	{
+		batch->workers[i].batch = batch;
+		batch->workers[i].tess = tessNewTess( &batch->alloc );
+		if (batch->workers[i].tess == NULL)
+			goto error;
+	}
+
+	if (threadCount > 1)
+	{
+		for (i = 1; i < threadCount; i++)
+		{
+#ifdef _WIN32
+			batch->workers[i].thread = CreateThread( NULL, 0, WorkerMain, &batch->workers[i], 0, NULL );
+			if (batch->workers[i].thread == NULL) break;
+#else
+			if (pthread_create( &batch->workers[i].thread, NULL, WorkerMain, &batch->workers[i] ) != 0) break;
+#endif
+		}
+		/* Workers which could not be started are not used. */
+		batch->threadCount = i - 1;
+	}
+
+	return batch;
+
+error:
+	tessDeleteBatch( batch );
+	return NULL;
+}
+
+void tessDeleteBatch( TESSbatch* batch )
+{
+	TESSalloc alloc;
+	int i;
+
+	if (batch == NULL)
+		return;
+	alloc = batch->alloc;
+
+	if (batch->locked)
+	{
+		BatchLock( batch );
+		batch->quit = 1;
+#ifdef _WIN32
+		WakeAllConditionVariable( &batch->start );
+#else
+		pthread_cond_broadcast( &batch->start );
+#endif
+		BatchUnlock( batch );
+		for (i = 1; i <= batch->threadCount; i++)
+		{
+#ifdef _WIN32
+			WaitForSingleObject( batch->workers[i].thread, INFINITE );
+			CloseHandle( batch->workers[i].thread );
+#else
+			pthread_join( batch->workers[i].thread, NULL );
+#endif
+		}
+#ifdef _WIN32
+		DeleteCriticalSection( &batch->lock );
+#else
+		pthread_cond_destroy( &batch->start );
+		pthread_cond_destroy( &batch->done );
+		pthread_mutex_destroy( &batch->lock );
+#endif
+	}
+
+	if (batch->workers != NULL)
+	{
+		for (i = 0; i < batch->workerCount; i++)
+		{
+			TESSbatchWorker* worker = &batch->workers[i];
+			if (worker->tess != NULL) tessDeleteTess( worker->tess );
+			if (worker->vertices != NULL) alloc.memfree( alloc.userData, worker->vertices );
+			if (worker->vertexIndices != NULL) alloc.memfree( alloc.userData, worker->vertexIndices );
+			if (worker->elements != NULL) alloc.memfree( alloc.userData, worker->elements );
+		}
+		alloc.memfree( alloc.userData, batch->workers );
+	}
+	if (batch->ranges != NULL) alloc.memfree( alloc.userData, batch->ranges );
+	if (batch->owners != NULL) alloc.memfree( alloc.userData, batch->owners );
+	if (batch->vertices != NULL) alloc.memfree( alloc.userData, batch->vertices );
+	if (batch->vertexIndices != NULL) alloc.memfree( alloc.userData, batch->vertexIndices );
+	if (batch->elements != NULL) alloc.memfree( alloc.userData, batch->elements );
+	alloc.memfree( alloc.userData, batch );
+}
+
+/* Copies the results of the workers to the batch output in polygon order,
+* moving the vertex and neighbour indices to the batch arrays.
+*/
+static int PackOutput( TESSbatch* batch )
+{
+	int i, j, k, vertexCount = 0, elementCount = 0, ok = 1;
+	int vertexSize = batch->vertexSize, elementSize = batch->elementSize;
+
+	for (i = 0; i < batch->polygonCount; i++)
+	{
+		vertexCount += batch->ranges[i].vertexCount;
+		elementCount += batch->ranges[i].elementCount;
+	}
+	batch->vertexCount = 0;
+	batch->elementCount = 0;
+	if (!ReserveVertices( &batch->alloc, &batch->vertices, &batch->vertexIndices, 0, vertexCount, &batch->vertexCapacity ))
+		return 0;
+	if (!ReserveElements( &batch->alloc, &batch->elements, 0, elementCount * elementSize, &batch->elementIndexCapacity ))
+		return 0;
+
+	vertexCount = 0;
+	elementCount = 0;
+	for (i = 0; i < batch->polygonCount; i++)
+	{
+		TESSbatchRange* range = &batch->ranges[i];
+		const TESSbatchWorker* worker = &batch->workers[batch->owners[i]];
+		const TESSindex* src = &worker->elements[range->baseElement];
+		TESSindex* dst = &batch->elements[elementCount * elementSize];
+
+		memcpy( &batch->vertices[vertexCount * vertexSize], &worker->vertices[range->baseVertex * vertexSize],
+				sizeof(TESSreal) * range->vertexCount * vertexSize );
+		memcpy( &batch->vertexIndices[vertexCount], &worker->vertexIndices[range->baseVertex],
+				sizeof(TESSindex) * range->vertexCount );
+
+		for (j = 0; j < range->elementCount; j++)
+		{
+			if (batch->elementType == TESS_BOUNDARY_CONTOURS)
+			{
+				dst[0] = src[0] + vertexCount;
+				dst[1] = src[1];
+			}
+			else
+			{
+				for (k = 0; k < batch->polySize; k++)
+					dst[k] = src[k] != TESS_UNDEF ? src[k] + vertexCount : TESS_UNDEF;
+				if (batch->elementType == TESS_CONNECTED_POLYGONS)
+				{
+					for (k = batch->polySize; k < elementSize; k++)
+						dst[k] = src[k] != TESS_UNDEF ? src[k] + elementCount : TESS_UNDEF;
+				}
+			}
+			src += elementSize;
+			dst += elementSize;
+		}
+
+		range->baseVertex = vertexCount;
+		range->baseElement = elementCount;
+		vertexCount += range->vertexCount;
+		elementCount += range->elementCount;
+		ok &= range->status;
+	}
+	batch->vertexCount = vertexCount;
+	batch->elementCount = elementCount;
+
+	return ok;
+}
+
+int tessBatchTesselate( TESSbatch* batch, const TESSpolygon* polygons, int polygonCount, int size,
+						int windingRule, int elementType, int polySize, int vertexSize, const TESSreal* normal )
+{
+	int i;
+
+	if (vertexSize < 2)
+		vertexSize = 2;
+	if (vertexSize > 3)
+		vertexSize = 3;
+
+	batch->polygons = polygons;
+	batch->polygonCount = polygonCount;
+	batch->size = size;
+	batch->windingRule = windingRule;
+	batch->elementType = elementType;
+	batch->polySize = polySize;
+	batch->vertexSize = vertexSize;
+	batch->normal = normal;
+	if (elementType == TESS_BOUNDARY_CONTOURS)
+		batch->elementSize = 2;
+	else if (elementType == TESS_CONNECTED_POLYGONS)
+		batch->elementSize = polySize * 2;
+	else
+		batch->elementSize = polySize;
+	batch->nextPolygon = 0;
+	batch->vertexCount = 0;
+	batch->elementCount = 0;
+
+	if (polygonCount > batch->rangeCapacity)
+	{
+		int capacity = batch->rangeCapacity;
+		TESSbatchRange* ranges = (TESSbatchRange*)GrowArray( &batch->alloc, NULL, 0, polygonCount, &capacity, sizeof(TESSbatchRange) );
+		int* owners;
+		if (ranges == NULL)
+			return 0;
+		capacity = batch->rangeCapacity;
+		owners = (int*)GrowArray( &batch->alloc, NULL, 0, polygonCount, &capacity, sizeof(int) );
+		if (owners == NULL)
+		{
+			batch->alloc.memfree( batch->alloc.userData, ranges );
+			return 0;
+		}
+		if (batch->ranges != NULL) batch->alloc.memfree( batch->alloc.userData, batch->ranges );
+		if (batch->owners != NULL) batch->alloc.memfree( batch->alloc.userData, batch->owners );
+		batch->ranges = ranges;
+		batch->owners = owners;
+		batch->rangeCapacity = capacity;
+	}
+
+	for (i = 0; i < batch->workerCount; i++)
+	{
+		batch->workers[i].vertexCount = 0;
+		batch->workers[i].elementIndexCount = 0;
+	}
+
+	/* Small batches are not worth waking up the threads. */
+	if (batch->threadCount > 0 && polygonCount > TESS_BATCH_CHUNK)
+	{
+		BatchLock( batch );
+		batch->generation++;
+		batch->busy = batch->threadCount;
+#ifdef _WIN32
+		WakeAllConditionVariable( &batch->start );
+#else
+		pthread_cond_broadcast( &batch->start );
+#endif
+		BatchUnlock( batch );
+
+		TesselatePolygons( &batch->workers[0] );
+
+		BatchLock( batch );
+		while (batch->busy > 0)
+		{
+#ifdef _WIN32
+			SleepConditionVariableCS( &batch->done, &batch->lock, INFINITE );
+#else
+			pthread_cond_wait( &batch->done, &batch->lock );
+#endif
+		}
+		BatchUnlock( batch );
+	}
+	else
+	{
+		for (i = 0; i < polygonCount; i++)
+			TesselatePolygon( &batch->workers[0], i );
+	}
+
+	return PackOutput( batch );
+}
+
+int tessGetBatchVertexCount( TESSbatch* batch )
+{
+	return batch->vertexCount;
+}
+
+const TESSreal* tessGetBatchVertices( TESSbatch* batch )
+{
+	return batch->vertices;
+}
+
+const TESSindex* tessGetBatchVertexIndices( TESSbatch* batch )
+{
+	return batch->vertexIndices;
+}
+
+int tessGetBatchElementCount( TESSbatch* batch )
+{
+	return batch->elementCount;
+}
+
+const TESSindex* tessGetBatchElements( TESSbatch* batch )
+{
+	return batch->elements;
+}
+
+const TESSbatchRange* tessGetBatchRanges( TESSbatch* batch )
+{
+	return batch->ranges;
+}
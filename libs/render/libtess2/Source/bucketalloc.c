@@ -43,23 +43,33 @@ struct Bucket
 	Bucket *next;
 };
 
+// Freed items go to the freelist, new items are taken from the current bucket.
+// Buckets are kept in allocation order, so that after a reset they are reused
+// one after the other before new buckets are allocated.
 struct BucketAlloc
 {
 	void *freelist;
 	Bucket *buckets;
+	Bucket *current;
+	unsigned char *next;
+	unsigned char *end;
 	unsigned int itemSize;
 	unsigned int bucketSize;
 	const char *name;
 	TESSalloc* alloc;
 };
 
+static void UseBucket( struct BucketAlloc* ba, Bucket* bucket )
+{
+	ba->current = bucket;
+	ba->next = (unsigned char*)bucket + sizeof(Bucket);
+	ba->end = ba->next + ba->itemSize * ba->bucketSize;
+}
+
 static int CreateBucket( struct BucketAlloc* ba )
 {
 	size_t size;
 	Bucket* bucket;
-	void* freelist;
-	unsigned char* head;
-	unsigned char* it;
 
 	// Allocate memory for the bucket
 	size = sizeof(Bucket) + ba->itemSize * ba->bucketSize;
@@ -68,34 +78,16 @@ static int CreateBucket( struct BucketAlloc* ba )
 		return 0;
 	bucket->next = 0;
 
-	// Add the bucket into the list of buckets.
-	bucket->next = ba->buckets;
-	ba->buckets = bucket;
-
-	// Add new items to the free list.
-	freelist = ba->freelist;
-	head = (unsigned char*)bucket + sizeof(Bucket);
-	it = head + ba->itemSize * ba->bucketSize;
-	do
-	{
-		it -= ba->itemSize;
-		// Store pointer to next free item.
-		*((void**)it) = freelist;
-		// Pointer to next location containing a free item.
-		freelist = (void*)it;
-	}
-	while ( it != head );
-	// Update pointer to next location containing a free item.
-	ba->freelist = (void*)it;
+	// Add the bucket at the end of the list of buckets.
+	if ( ba->current )
+		ba->current->next = bucket;
+	else
+		ba->buckets = bucket;
+	UseBucket( ba, bucket );
 
 	return 1;
 }
 
-static void *NextFreeItem( struct BucketAlloc *ba )
-{
-	return *(void**)ba->freelist;
-}
-
 struct BucketAlloc* createBucketAlloc( TESSalloc* alloc, const char* name,
 									  unsigned int itemSize, unsigned int bucketSize )
 {
@@ -109,6 +101,7 @@ struct BucketAlloc* createBucketAlloc( TESSalloc* alloc, const char* name,
 	ba->bucketSize = bucketSize;
 	ba->freelist = 0;
 	ba->buckets = 0;
+	ba->current = 0;
 
 	if ( !CreateBucket( ba ) )
 	{
@@ -123,20 +116,35 @@ void* bucketAlloc( struct BucketAlloc *ba )
 {
 	void *it;
 
-	// If running out of memory, allocate new bucket and update the freelist.
-	if ( !ba->freelist || !NextFreeItem( ba ) )
+	// Pop item from in front of the free list.
+	if ( ba->freelist )
 	{
-		if ( !CreateBucket( ba ) )
+		it = ba->freelist;
+		ba->freelist = *(void**)it;
+		return it;
+	}
+
+	// If the current bucket is full, continue in the next one or allocate a new bucket.
+	if ( ba->next == ba->end )
+	{
+		if ( ba->current->next )
+			UseBucket( ba, ba->current->next );
+		else if ( !CreateBucket( ba ) )
 			return 0;
 	}
 
-	// Pop item from in front of the free list.
-	it = ba->freelist;
-	ba->freelist = NextFreeItem( ba );
+	it = ba->next;
+	ba->next += ba->itemSize;
 
 	return it;
 }
 
+void resetBucketAlloc( struct BucketAlloc *ba )
+{
+	ba->freelist = 0;
+	UseBucket( ba, ba->buckets );
+}
+
 void bucketFree( struct BucketAlloc *ba, void *ptr )
 {
 #ifdef CHECK_BOUNDS
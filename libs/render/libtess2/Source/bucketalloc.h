@@ -42,6 +42,8 @@ struct BucketAlloc *createBucketAlloc( TESSalloc* alloc, const char *name,
 									  unsigned int itemSize, unsigned int bucketSize );
 void *bucketAlloc( struct BucketAlloc *ba);
 void bucketFree( struct BucketAlloc *ba, void *ptr );
+// Frees all items at once, the buckets are kept for the following allocations.
+void resetBucketAlloc( struct BucketAlloc *ba );
 void deleteBucketAlloc( struct BucketAlloc *ba );
 
 #ifdef __cplusplus
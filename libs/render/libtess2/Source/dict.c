@@ -60,6 +60,18 @@ Dict *dictNewDict( TESSalloc* alloc, void *frame, int (*leq)(void *frame, DictKe
 	return dict;
 }
 
+/* really tessDictListReset */
+void dictReset( Dict *dict )
+{
+	DictNode *head = &dict->head;
+
+	head->key = NULL;
+	head->next = head;
+	head->prev = head;
+
+	resetBucketAlloc( dict->nodePool );
+}
+
 /* really tessDictListDeleteDict */
 void dictDeleteDict( TESSalloc* alloc, Dict *dict )
 {
@@ -40,6 +40,9 @@ Dict *dictNewDict( TESSalloc* alloc, void *frame, int (*leq)(void *frame, DictKe
 
 void dictDeleteDict( TESSalloc* alloc, Dict *dict );
 
+/* Removes all keys, the memory is kept for the keys inserted next. */
+void dictReset( Dict *dict );
+
 /* Search returns the node with the smallest key greater than or equal
 * to the given key.  If there is no such key, returns a node whose
 * key is NULL.  Similarly, Succ(Max(d)) has a NULL key, etc.
@@ -234,6 +234,8 @@ struct TESSmesh {
 *
 * tessMeshDeleteMesh( mesh ) will free all storage for any valid mesh.
 *
+* tessMeshReset( mesh ) empties the mesh, keeping its storage for reuse.
+*
 * tessMeshZapFace( fZap ) destroys a face and removes it from the
 * global face list.  All edges of fZap will have a NULL pointer as their
 * left face.  Any edges which also have a NULL pointer as their right face
@@ -256,6 +258,7 @@ TESSmesh *tessMeshNewMesh( TESSalloc* alloc );
 TESSmesh *tessMeshUnion( TESSalloc* alloc, TESSmesh *mesh1, TESSmesh *mesh2 );
 int tessMeshMergeConvexFaces( TESSmesh *mesh, int maxVertsPerFace );
 void tessMeshDeleteMesh( TESSalloc* alloc, TESSmesh *mesh );
+void tessMeshReset( TESSmesh *mesh );
 void tessMeshZapFace( TESSmesh *mesh, TESSface *fZap );
 
 #ifdef NDEBUG
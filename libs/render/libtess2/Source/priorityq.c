@@ -313,6 +313,7 @@ PriorityQ *pqNewPriorityQ( TESSalloc* alloc, int size, int (*leq)(PQkey key1, PQ
 		return NULL;
 	}
 
+	pq->order = NULL;
 	pq->size = 0;
 	pq->max = size; //INIT_SIZE;
 	pq->initialized = FALSE;
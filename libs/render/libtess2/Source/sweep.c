@@ -1115,8 +1115,16 @@ static void InitEdgeDict( TESStesselator *tess )
 	TESSreal w, h;
 	TESSreal smin, smax, tmin, tmax;
 
-	tess->dict = dictNewDict( &tess->alloc, tess, (int (*)(void *, DictKey, DictKey)) EdgeLeq );
-	if (tess->dict == NULL) longjmp(tess->env,1);
+	/* The dictionary and the regions are kept by the tesselator and
+	* reused, anything left from a failed sweep is freed here.
+	*/
+	if (tess->dict == NULL) {
+		tess->dict = dictNewDict( &tess->alloc, tess, (int (*)(void *, DictKey, DictKey)) EdgeLeq );
+		if (tess->dict == NULL) longjmp(tess->env,1);
+	} else {
+		dictReset( tess->dict );
+	}
+	resetBucketAlloc( tess->regionPool );
 
 	w = (tess->bmax[0] - tess->bmin[0]);
 	h = (tess->bmax[1] - tess->bmin[1]);
@@ -1152,7 +1160,6 @@ static void DoneEdgeDict( TESStesselator *tess )
 		DeleteRegion( tess, reg );
 		/*    tessMeshDelete( reg->eUp );*/
 	}
-	dictDeleteDict( &tess->alloc, tess->dict );
 }
 
 
@@ -1229,6 +1236,7 @@ static int InitPriorityQ( TESStesselator *tess )
 static void DonePriorityQ( TESStesselator *tess )
 {
 	pqDeletePriorityQ( &tess->alloc, tess->pq );
+	tess->pq = NULL;
 }
 
 
@@ -40,6 +40,7 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define TRUE 1
 #define FALSE 0
@@ -60,6 +61,11 @@ static void Normalize( TESSreal v[3] )
 #endif
 
 #define ABS(x)	((x) < 0 ? -(x) : (x))
+#define MIN(a,b)	((a) < (b) ? (a) : (b))
+#define MAX(a,b)	((a) > (b) ? (a) : (b))
+
+/* Largest non-convex contour tesselated without the sweep. */
+#define TESS_SIMPLE_MAX_VERTICES 64
 
 static int LongAxis( TESSreal v[3] )
 {
@@ -525,8 +531,13 @@ TESStesselator* tessNewTess( TESSalloc* alloc )
 	tess->regionPool = createBucketAlloc( &tess->alloc, "Regions",
 										 sizeof(ActiveRegion), tess->alloc.regionBucketSize );
 
+	tess->simpleFastPath = 1;
+
 	// Initialize to begin polygon.
 	tess->mesh = NULL;
+	tess->spareMesh = NULL;
+	tess->dict = NULL;
+	tess->pq = NULL;
 
 	tess->outOfMemory = 0;
 	tess->vertexIndexCounter = 0;
@@ -534,8 +545,10 @@ TESStesselator* tessNewTess( TESSalloc* alloc )
 	tess->vertices = 0;
 	tess->vertexIndices = 0;
 	tess->vertexCount = 0;
+	tess->vertexCapacity = 0;
 	tess->elements = 0;
 	tess->elementCount = 0;
+	tess->elementCapacity = 0;
 
 	return tess;
 }
@@ -551,6 +564,18 @@ void tessDeleteTess( TESStesselator *tess )
 		tessMeshDeleteMesh( &alloc, tess->mesh );
 		tess->mesh = NULL;
 	}
+	if( tess->spareMesh != NULL ) {
+		tessMeshDeleteMesh( &alloc, tess->spareMesh );
+		tess->spareMesh = NULL;
+	}
+	if( tess->dict != NULL ) {
+		dictDeleteDict( &alloc, tess->dict );
+		tess->dict = NULL;
+	}
+	if( tess->pq != NULL ) {
+		pqDeletePriorityQ( &alloc, tess->pq );
+		tess->pq = NULL;
+	}
 	if (tess->vertices != NULL) {
 		alloc.memfree( alloc.userData, tess->vertices );
 		tess->vertices = 0;
@@ -568,6 +593,45 @@ void tessDeleteTess( TESStesselator *tess )
 }
 
 
+// Makes room for the output, the arrays are kept between tesselations and only grow.
+// Vertices always have room for 3 coordinates, so that the vertex size can change between calls.
+static int AllocOutput( TESStesselator *tess, int vertexCount, int elementIndexCount )
+{
+	if (tess->elementCapacity < elementIndexCount || tess->elements == NULL)
+	{
+		if (tess->elements != NULL)
+			tess->alloc.memfree( tess->alloc.userData, tess->elements );
+		tess->elementCapacity = elementIndexCount;
+		tess->elements = (TESSindex*)tess->alloc.memalloc( tess->alloc.userData,
+														  sizeof(TESSindex) * elementIndexCount );
+		if (!tess->elements)
+		{
+			tess->elementCapacity = 0;
+			return 0;
+		}
+	}
+
+	if (tess->vertexCapacity < vertexCount || tess->vertices == NULL)
+	{
+		if (tess->vertices != NULL)
+			tess->alloc.memfree( tess->alloc.userData, tess->vertices );
+		if (tess->vertexIndices != NULL)
+			tess->alloc.memfree( tess->alloc.userData, tess->vertexIndices );
+		tess->vertexCapacity = vertexCount;
+		tess->vertices = (TESSreal*)tess->alloc.memalloc( tess->alloc.userData,
+														 sizeof(TESSreal) * vertexCount * 3 );
+		tess->vertexIndices = (TESSindex*)tess->alloc.memalloc( tess->alloc.userData,
+																sizeof(TESSindex) * vertexCount );
+		if (!tess->vertices || !tess->vertexIndices)
+		{
+			tess->vertexCapacity = 0;
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
 static TESSindex GetNeighbourFace(TESShalfEdge* edge)
 {
 	if (!edge->Rface)
@@ -633,26 +697,8 @@ void OutputPolymesh( TESStesselator *tess, TESSmesh *mesh, int elementType, int
 	tess->elementCount = maxFaceCount;
 	if (elementType == TESS_CONNECTED_POLYGONS)
 		maxFaceCount *= 2;
-	tess->elements = (TESSindex*)tess->alloc.memalloc( tess->alloc.userData,
-													  sizeof(TESSindex) * maxFaceCount * polySize );
-	if (!tess->elements)
-	{
-		tess->outOfMemory = 1;
-		return;
-	}
-	
 	tess->vertexCount = maxVertexCount;
-	tess->vertices = (TESSreal*)tess->alloc.memalloc( tess->alloc.userData,
-													 sizeof(TESSreal) * tess->vertexCount * vertexSize );
-	if (!tess->vertices)
-	{
-		tess->outOfMemory = 1;
-		return;
-	}
-
-	tess->vertexIndices = (TESSindex*)tess->alloc.memalloc( tess->alloc.userData,
-														    sizeof(TESSindex) * tess->vertexCount );
-	if (!tess->vertexIndices)
+	if (!AllocOutput( tess, tess->vertexCount, maxFaceCount * polySize ))
 	{
 		tess->outOfMemory = 1;
 		return;
@@ -741,25 +787,7 @@ void OutputContours( TESStesselator *tess, TESSmesh *mesh, int vertexSize )
 		++tess->elementCount;
 	}
 
-	tess->elements = (TESSindex*)tess->alloc.memalloc( tess->alloc.userData,
-													  sizeof(TESSindex) * tess->elementCount * 2 );
-	if (!tess->elements)
-	{
-		tess->outOfMemory = 1;
-		return;
-	}
-	
-	tess->vertices = (TESSreal*)tess->alloc.memalloc( tess->alloc.userData,
-													  sizeof(TESSreal) * tess->vertexCount * vertexSize );
-	if (!tess->vertices)
-	{
-		tess->outOfMemory = 1;
-		return;
-	}
-
-	tess->vertexIndices = (TESSindex*)tess->alloc.memalloc( tess->alloc.userData,
-														    sizeof(TESSindex) * tess->vertexCount );
-	if (!tess->vertexIndices)
+	if (!AllocOutput( tess, tess->vertexCount, tess->elementCount * 2 ))
 	{
 		tess->outOfMemory = 1;
 		return;
@@ -797,6 +825,261 @@ void OutputContours( TESStesselator *tess, TESSmesh *mesh, int vertexSize )
 	}
 }
 
+/* Twice the signed area of the triangle a,b,c in the sweep plane, positive if CCW. */
+static double TriangleArea( const TESSvertex *a, const TESSvertex *b, const TESSvertex *c )
+{
+	return ((double)b->s - a->s) * ((double)c->t - a->t) - ((double)b->t - a->t) * ((double)c->s - a->s);
+}
+
+/* Returns TRUE if segments ab and cd have any point in common.
+* Collinear segments are only checked for overlapping bounds, which errs
+* on the side of reporting a touch.
+*/
+static int SegmentsTouch( const TESSvertex *a, const TESSvertex *b, const TESSvertex *c, const TESSvertex *d )
+{
+	double d1 = TriangleArea( a, b, c );
+	double d2 = TriangleArea( a, b, d );
+	double d3 = TriangleArea( c, d, a );
+	double d4 = TriangleArea( c, d, b );
+
+	if( d1 == 0 || d2 == 0 || d3 == 0 || d4 == 0 ) {
+		return MAX(a->s, b->s) >= MIN(c->s, d->s) && MAX(c->s, d->s) >= MIN(a->s, b->s)
+			&& MAX(a->t, b->t) >= MIN(c->t, d->t) && MAX(c->t, d->t) >= MIN(a->t, b->t);
+	}
+	return ((d1 > 0) != (d2 > 0)) && ((d3 > 0) != (d4 > 0));
+}
+
+/* Returns TRUE if no two edges of the contour 'verts' touch, other than
+* adjacent edges at their shared vertex. The edges are sorted by their
+* smallest s, so that each edge is only tested against the edges which
+* overlap it in s.
+*/
+static int IsSimple( TESSvertex **verts, int n )
+{
+	TESSreal smin[TESS_SIMPLE_MAX_VERTICES], smax[TESS_SIMPLE_MAX_VERTICES];
+	TESSreal tmin[TESS_SIMPLE_MAX_VERTICES], tmax[TESS_SIMPLE_MAX_VERTICES];
+	int order[TESS_SIMPLE_MAX_VERTICES];
+	int i, j, k, a, b;
+
+	for( i = 0; i < n; ++i ) {
+		TESSvertex *u = verts[i], *v = verts[i < n-1 ? i+1 : 0];
+		smin[i] = MIN(u->s, v->s);
+		smax[i] = MAX(u->s, v->s);
+		tmin[i] = MIN(u->t, v->t);
+		tmax[i] = MAX(u->t, v->t);
+		for( k = i; k > 0 && smin[order[k-1]] > smin[i]; --k )
+			order[k] = order[k-1];
+		order[k] = i;
+	}
+	for( i = 0; i < n; ++i ) {
+		a = order[i];
+		for( j = i+1; j < n && smin[order[j]] <= smax[a]; ++j ) {
+			b = order[j];
+			if( tmin[b] > tmax[a] || tmax[b] < tmin[a] ) continue;
+			if( b == a+1 || a == b+1 || (a == 0 && b == n-1) || (b == 0 && a == n-1) ) continue;	/* adjacent */
+			if( SegmentsTouch( verts[a], verts[a < n-1 ? a+1 : 0], verts[b], verts[b < n-1 ? b+1 : 0] ) ) return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/* Ear clips the simple polygon 'verts' given in CCW order into 'tris'.
+* Only reflex vertices can be inside an ear, so only those are tested.
+* Returns the number of triangles, or 0 if no ear was found, which can
+* only happen because of round-off.
+*/
+static int EarClip( TESSvertex **verts, int n, TESSindex *tris )
+{
+	int prev[TESS_SIMPLE_MAX_VERTICES], next[TESS_SIMPLE_MAX_VERTICES];
+	unsigned char reflex[TESS_SIMPLE_MAX_VERTICES];
+	int i, j, p, q, ear, remaining = n, tried = 0, count = 0;
+
+	for( i = 0; i < n; ++i ) {
+		prev[i] = i > 0 ? i-1 : n-1;
+		next[i] = i < n-1 ? i+1 : 0;
+	}
+	for( i = 0; i < n; ++i )
+		reflex[i] = TriangleArea( verts[prev[i]], verts[i], verts[next[i]] ) <= 0;
+
+	i = 0;
+	while( remaining > 3 ) {
+		p = prev[i];
+		q = next[i];
+		ear = !reflex[i];
+		if( ear ) {
+			TESSvertex *a = verts[p], *b = verts[i], *c = verts[q];
+			TESSreal smin = MIN(a->s, MIN(b->s, c->s)), smax = MAX(a->s, MAX(b->s, c->s));
+			TESSreal tmin = MIN(a->t, MIN(b->t, c->t)), tmax = MAX(a->t, MAX(b->t, c->t));
+			for( j = next[q]; j != p; j = next[j] ) {
+				TESSvertex *v = verts[j];
+				if( !reflex[j] || v->s < smin || v->s > smax || v->t < tmin || v->t > tmax ) continue;
+				/* No other vertex may be inside or on the ear. */
+				if( TriangleArea( a, b, v ) >= 0 && TriangleArea( b, c, v ) >= 0 && TriangleArea( c, a, v ) >= 0 ) {
+					ear = FALSE;
+					break;
+				}
+			}
+		}
+		if( ear ) {
+			tris[count*3+0] = p;
+			tris[count*3+1] = i;
+			tris[count*3+2] = q;
+			++count;
+			next[p] = q;
+			prev[q] = p;
+			reflex[p] = TriangleArea( verts[prev[p]], verts[p], verts[q] ) <= 0;
+			reflex[q] = TriangleArea( verts[p], verts[q], verts[next[q]] ) <= 0;
+			--remaining;
+			tried = 0;
+			i = p;
+		} else {
+			if( ++tried > remaining ) return 0;
+			i = q;
+		}
+	}
+	if( reflex[i] ) return 0;
+	tris[count*3+0] = prev[i];
+	tris[count*3+1] = i;
+	tris[count*3+2] = next[i];
+	return count+1;
+}
+
+/* Tesselates the input without the sweep when it is a single simple contour:
+* convex contours are split into fans of convex polygons, other simple contours
+* of up to TESS_SIMPLE_MAX_VERTICES vertices are ear clipped into triangles.
+* A simple contour has winding number 1 inside when it is CCW in the sweep plane
+* and -1 when it is CW, which decides if the winding rule keeps it. The output
+* is CCW like the output of the sweep.
+* Returns TRUE if the output was done, FALSE if the contours need the full sweep.
+*/
+static int TesselateSimpleContour( TESStesselator *tess, int elementType, int polySize, int vertexSize )
+{
+	TESSmesh *mesh = tess->mesh;
+	TESShalfEdge *start, *e;
+	TESSvertex *v, *verts[TESS_SIMPLE_MAX_VERTICES];
+	TESSindex tris[(TESS_SIMPLE_MAX_VERTICES-2)*3];
+	TESSindex *elements;
+	TESSreal *vert;
+	double area = 0, turn;
+	int n = 0, count = 0, convex = TRUE, turnSign = 0, sChanges = 0, tChanges = 0;
+	int sSign = 0, tSign = 0, firstSSign = 0, firstTSign = 0, winding, inside, i, j;
+
+	if( !tess->simpleFastPath || elementType == TESS_CONNECTED_POLYGONS ) return FALSE;
+
+	start = mesh->eHead.next;
+	if( start == &mesh->eHead ) return FALSE;
+	if( start->winding < 0 ) start = start->Sym;
+
+	for( v = mesh->vHead.next; v != &mesh->vHead; v = v->next ) ++n;
+	if( n < 3 ) return FALSE;
+
+	/* The contour has to go through all the vertices. It is convex if it turns
+	* the same way at every vertex and goes around only once.
+	*/
+	e = start;
+	do {
+		TESSreal ds = e->Dst->s - e->Org->s;
+		TESSreal dt = e->Dst->t - e->Org->t;
+		int s = ds > 0 ? 1 : (ds < 0 ? -1 : 0);
+		int t = dt > 0 ? 1 : (dt < 0 ? -1 : 0);
+
+		if( ++count > n ) return FALSE;
+		if( s == 0 && t == 0 ) return FALSE;	/* coincident vertices */
+		if( count <= TESS_SIMPLE_MAX_VERTICES ) verts[count-1] = e->Org;
+
+		turn = TriangleArea( e->Org, e->Dst, e->Lnext->Dst );
+		if( turn == 0 ) return FALSE;	/* collinear vertices */
+		if( turnSign == 0 ) turnSign = turn > 0 ? 1 : -1;
+		else if( (turn > 0) != (turnSign > 0) ) convex = FALSE;
+
+		if( s != 0 ) {
+			if( sSign == 0 ) firstSSign = s;
+			else if( s != sSign ) ++sChanges;
+			sSign = s;
+		}
+		if( t != 0 ) {
+			if( tSign == 0 ) firstTSign = t;
+			else if( t != tSign ) ++tChanges;
+			tSign = t;
+		}
+		area += ((double)e->Org->s - e->Dst->s) * ((double)e->Org->t + e->Dst->t);
+
+		e = e->Lnext;
+	} while( e != start );
+
+	if( count != n ) return FALSE;
+	if( sSign != firstSSign ) ++sChanges;
+	if( tSign != firstTSign ) ++tChanges;
+	if( sChanges > 2 || tChanges > 2 ) convex = FALSE;
+
+	if( !convex ) {
+		if( n > TESS_SIMPLE_MAX_VERTICES ) return FALSE;
+		if( !IsSimple( verts, n ) ) return FALSE;
+	}
+
+	winding = area > 0 ? 1 : -1;
+	switch( tess->windingRule ) {
+		case TESS_WINDING_POSITIVE:		inside = winding > 0; break;
+		case TESS_WINDING_NEGATIVE:		inside = winding < 0; break;
+		case TESS_WINDING_ABS_GEQ_TWO:	inside = FALSE; break;
+		default:						inside = TRUE; break;
+	}
+	if( !inside ) return TRUE;
+
+	/* Only the sweep merges triangles into larger polygons. */
+	if( !convex && elementType == TESS_POLYGONS && polySize > 3 ) return FALSE;
+
+	/* Output the vertices in CCW order. */
+	if( winding < 0 ) {
+		if( convex ) {
+			start = start->Sym;
+		} else {
+			for( i = 0; i < n/2; ++i ) {
+				v = verts[i];
+				verts[i] = verts[n-1-i];
+				verts[n-1-i] = v;
+			}
+		}
+	}
+
+	if( elementType == TESS_BOUNDARY_CONTOURS ) {
+		count = 1;
+		if( !AllocOutput( tess, n, 2 ) ) return FALSE;
+		tess->elements[0] = 0;
+		tess->elements[1] = n;
+	} else if( convex ) {
+		/* Fan of polygons with up to polySize vertices, all sharing the first vertex. */
+		count = (n - 2 + polySize - 3) / (polySize - 2);
+		if( !AllocOutput( tess, n, count * polySize ) ) return FALSE;
+		elements = tess->elements;
+		for( i = 1; i < n-1; i += polySize-2 ) {
+			*elements++ = 0;
+			for( j = 0; j < polySize-1; ++j )
+				*elements++ = i+j < n ? i+j : TESS_UNDEF;
+		}
+	} else {
+		count = EarClip( verts, n, tris );
+		if( count == 0 ) return FALSE;
+		if( !AllocOutput( tess, n, count * 3 ) ) return FALSE;
+		memcpy( tess->elements, tris, sizeof(TESSindex) * count * 3 );
+	}
+
+	e = start;
+	for( i = 0; i < n; ++i ) {
+		v = convex ? e->Org : verts[i];
+		vert = &tess->vertices[i*vertexSize];
+		vert[0] = v->coords[0];
+		vert[1] = v->coords[1];
+		if ( vertexSize > 2 )
+			vert[2] = v->coords[2];
+		tess->vertexIndices[i] = v->idx;
+		e = e->Lnext;
+	}
+	tess->vertexCount = n;
+	tess->elementCount = count;
+	return TRUE;
+}
+
 void tessAddContour( TESStesselator *tess, int size, const void* vertices,
 					int stride, int numVertices )
 {
@@ -804,6 +1087,10 @@ void tessAddContour( TESStesselator *tess, int size, const void* vertices,
 	TESShalfEdge *e;
 	int i;
 
+	if ( tess->mesh == NULL && tess->spareMesh != NULL ) {
+		tess->mesh = tess->spareMesh;
+		tess->spareMesh = NULL;
+	}
 	if ( tess->mesh == NULL )
 	  	tess->mesh = tessMeshNewMesh( &tess->alloc );
  	if ( tess->mesh == NULL ) {
@@ -865,24 +1152,42 @@ void tessAddContour( TESStesselator *tess, int size, const void* vertices,
 	}
 }
 
+// Empties the mesh and keeps it for the contours of the next tesselation.
+static void RecycleMesh( TESStesselator *tess )
+{
+	if (tess->mesh == NULL)
+		return;
+	if (tess->spareMesh != NULL)
+	{
+		tessMeshDeleteMesh( &tess->alloc, tess->mesh );
+	}
+	else
+	{
+		tessMeshReset( tess->mesh );
+		tess->spareMesh = tess->mesh;
+	}
+	tess->mesh = NULL;
+}
+
+void tessSetOption( TESStesselator *tess, int option, int value )
+{
+	switch( option )
+	{
+		case TESS_SIMPLE_POLYGON_FAST_PATH:
+			tess->simpleFastPath = value != 0;
+			break;
+	}
+}
+
 int tessTesselate( TESStesselator *tess, int windingRule, int elementType,
 				  int polySize, int vertexSize, const TESSreal* normal )
 {
 	TESSmesh *mesh;
 	int rc = 1;
 
-	if (tess->vertices != NULL) {
-		tess->alloc.memfree( tess->alloc.userData, tess->vertices );
-		tess->vertices = 0;
-	}
-	if (tess->elements != NULL) {
-		tess->alloc.memfree( tess->alloc.userData, tess->elements );
-		tess->elements = 0;
-	}
-	if (tess->vertexIndices != NULL) {
-		tess->alloc.memfree( tess->alloc.userData, tess->vertexIndices );
-		tess->vertexIndices = 0;
-	}
+	/* The output arrays are kept and reused. */
+	tess->vertexCount = 0;
+	tess->elementCount = 0;
 
 	tess->vertexIndexCounter = 0;
 	
@@ -902,6 +1207,14 @@ int tessTesselate( TESStesselator *tess, int windingRule, int elementType,
 
 	if (setjmp(tess->env) != 0) { 
 		/* come back here if out of memory */
+		if (tess->pq != NULL) {
+			pqDeletePriorityQ( &tess->alloc, tess->pq );
+			tess->pq = NULL;
+		}
+		RecycleMesh( tess );
+		tess->vertexCount = 0;
+		tess->elementCount = 0;
+		tess->outOfMemory = 0;
 		return 0;
 	}
 
@@ -915,6 +1228,12 @@ int tessTesselate( TESStesselator *tess, int windingRule, int elementType,
 	*/
 	tessProjectPolygon( tess );
 
+	/* Single convex or simple contours do not need the sweep. */
+	if ( TesselateSimpleContour( tess, elementType, polySize, vertexSize ) ) {
+		RecycleMesh( tess );
+		return 1;
+	}
+
 	/* tessComputeInterior( tess ) computes the planar arrangement specified
 	* by the given contours, and further subdivides this arrangement
 	* into regions.  Each region is marked "inside" if it belongs
@@ -948,11 +1267,15 @@ int tessTesselate( TESStesselator *tess, int windingRule, int elementType,
 		OutputPolymesh( tess, mesh, elementType, polySize, vertexSize );     /* output polygons */
 	}
 
-	tessMeshDeleteMesh( &tess->alloc, mesh );
-	tess->mesh = NULL;
+	RecycleMesh( tess );
 
 	if (tess->outOfMemory)
+	{
+		tess->vertexCount = 0;
+		tess->elementCount = 0;
+		tess->outOfMemory = 0;
 		return 0;
+	}
 	return 1;
 }
 
@@ -50,6 +50,7 @@ struct TESStesselator {
 	/*** state needed for collecting the input data ***/
 	TESSmesh	*mesh;		/* stores the input contours, and eventually
 						the tessellation itself */
+	TESSmesh	*spareMesh;	/* emptied mesh, reused for the next contours */
 	int outOfMemory;
 
 	/*** state needed for projecting onto the sweep plane ***/
@@ -75,14 +76,23 @@ struct TESStesselator {
 	TESSreal *vertices;
 	TESSindex *vertexIndices;
 	int vertexCount;
+	int vertexCapacity;
 	TESSindex *elements;
 	int elementCount;
+	int elementCapacity;	/* number of indices the elements array can hold */
+
+	int simpleFastPath;		/* tesselate single simple contours without the sweep */
 
 	TESSalloc alloc;
 	
 	jmp_buf env;			/* place to jump to when memAllocs fail */
 };
 
+/* Default malloc based allocator, used when no TESSalloc is given. */
+void* heapAlloc( void* userData, unsigned int size );
+void* heapRealloc( void *userData, void* ptr, unsigned int size );
+void heapFree( void* userData, void* ptr );
+
 #ifdef __cplusplus
 };
 #endif
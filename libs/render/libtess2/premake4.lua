@@ -43,3 +43,15 @@ solution "libtess2"
 		configuration { "macosx" }
 			links { "glfw3" }
 			linkoptions { "-framework OpenGL", "-framework Cocoa", "-framework IOKit", "-framework CoreVideo" }
+
+	-- batch tesselation benchmark, no window needed
+	project "bench"
+		kind "ConsoleApp"
+		language "C"
+		links { "tess2" }
+		files { "Example/bench.c" }
+		includedirs { "Include" }
+		targetdir("Build")
+
+		configuration { "linux" }
+			 links { "m", "pthread" }
@@ -0,0 +1,287 @@
+//
+// Copyright (c) 2013 Mikko Mononen memon@inside.org
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+
+// Benchmarks a static UI of 5000 widgets drawn from immediate paths and from retained shapes.
+// The front-end is timed with a back-end that draws nothing, then both versions are rendered
+// with the software back-end and compared.
+//   example_retained [frames]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "nanovg.h"
+#define NANOVG_SW_IMPLEMENTATION
+#include "nanovg_sw.h"
+
+#define WIDGET_COLS 100
+#define WIDGET_ROWS 50
+#define WIDGET_COUNT (WIDGET_COLS*WIDGET_ROWS)
+#define WIDTH 1920
+#define HEIGHT 1080
+
+#ifdef _WIN32
+#include <windows.h>
+static double getTime()
+{
+	LARGE_INTEGER freq, t;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&t);
+	return (double)t.QuadPart / (double)freq.QuadPart;
+}
+#else
+static double getTime()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+#endif
+
+// Back-end which accepts everything and draws nothing.
+static int nullCreate(void* uptr) { NVG_NOTUSED(uptr); return 1; }
+static int nullCreateTexture(void* uptr, int type, int w, int h, int imageFlags, const unsigned char* data) { NVG_NOTUSED(uptr); NVG_NOTUSED(type); NVG_NOTUSED(w); NVG_NOTUSED(h); NVG_NOTUSED(imageFlags); NVG_NOTUSED(data); return 1; }
+static int nullDeleteTexture(void* uptr, int image) { NVG_NOTUSED(uptr); NVG_NOTUSED(image); return 1; }
+static int nullUpdateTexture(void* uptr, int image, int x, int y, int w, int h, const unsigned char* data) { NVG_NOTUSED(uptr); NVG_NOTUSED(image); NVG_NOTUSED(x); NVG_NOTUSED(y); NVG_NOTUSED(w); NVG_NOTUSED(h); NVG_NOTUSED(data); return 1; }
+static int nullGetTextureSize(void* uptr, int image, int* w, int* h) { NVG_NOTUSED(uptr); NVG_NOTUSED(image); *w = *h = 512; return 1; }
+static void nullViewport(void* uptr, int width, int height) { NVG_NOTUSED(uptr); NVG_NOTUSED(width); NVG_NOTUSED(height); }
+static void nullCancel(void* uptr) { NVG_NOTUSED(uptr); }
+static void nullFlush(void* uptr) { NVG_NOTUSED(uptr); }
+static void nullFill(void* uptr, NVGpaint* paint, NVGscissor* scissor, float fringe, const float* bounds, const NVGpath* paths, int npaths) { NVG_NOTUSED(uptr); NVG_NOTUSED(paint); NVG_NOTUSED(scissor); NVG_NOTUSED(fringe); NVG_NOTUSED(bounds); NVG_NOTUSED(paths); NVG_NOTUSED(npaths); }
+static void nullStroke(void* uptr, NVGpaint* paint, NVGscissor* scissor, float fringe, float strokeWidth, const NVGpath* paths, int npaths) { NVG_NOTUSED(uptr); NVG_NOTUSED(paint); NVG_NOTUSED(scissor); NVG_NOTUSED(fringe); NVG_NOTUSED(strokeWidth); NVG_NOTUSED(paths); NVG_NOTUSED(npaths); }
+static void nullTriangles(void* uptr, NVGpaint* paint, NVGscissor* scissor, const NVGvertex* verts, int nverts) { NVG_NOTUSED(uptr); NVG_NOTUSED(paint); NVG_NOTUSED(scissor); NVG_NOTUSED(verts); NVG_NOTUSED(nverts); }
+static void nullDelete(void* uptr) { NVG_NOTUSED(uptr); }
+
+static NVGcontext* createNull()
+{
+	NVGparams params;
+	memset(&params, 0, sizeof(params));
+	params.edgeAntiAlias = 1;
+	params.renderCreate = nullCreate;
+	params.renderCreateTexture = nullCreateTexture;
+	params.renderDeleteTexture = nullDeleteTexture;
+	params.renderUpdateTexture = nullUpdateTexture;
+	params.renderGetTextureSize = nullGetTextureSize;
+	params.renderViewport = nullViewport;
+	params.renderCancel = nullCancel;
+	params.renderFlush = nullFlush;
+	params.renderFill = nullFill;
+	params.renderStroke = nullStroke;
+	params.renderTriangles = nullTriangles;
+	params.renderDelete = nullDelete;
+	return nvgCreateInternal(&params);
+}
+
+// A widget is a panel with a border and one of four glyphs, in its own local space.
+typedef struct Widget {
+	float x, y, w, h;
+	int kind;
+	NVGshape* background;
+	NVGshape* glyph;
+} Widget;
+
+static void widgetBackgroundPath(NVGcontext* vg, const Widget* wg)
+{
+	nvgBeginPath(vg);
+	nvgRoundedRect(vg, 0.5f, 0.5f, wg->w-1, wg->h-1, 4);
+}
+
+static void widgetGlyphPath(NVGcontext* vg, const Widget* wg)
+{
+	float cx = wg->w*0.5f, cy = wg->h*0.5f, r = (wg->w < wg->h ? wg->w : wg->h)*0.3f;
+	nvgBeginPath(vg);
+	switch (wg->kind) {
+	case 0:	// Check mark
+		nvgMoveTo(vg, cx-r, cy);
+		nvgLineTo(vg, cx-r*0.3f, cy+r*0.7f);
+		nvgLineTo(vg, cx+r, cy-r*0.7f);
+		break;
+	case 1:	// Knob
+		nvgCircle(vg, cx, cy, r);
+		break;
+	case 2:	// Dial, drawn around the origin and rotated in place
+		nvgArc(vg, 0, 0, r, 0, NVG_PI*1.5f, NVG_CW);
+		nvgMoveTo(vg, 0, 0);
+		nvgLineTo(vg, r, 0);
+		break;
+	default:	// Chevron
+		nvgMoveTo(vg, cx-r*0.4f, cy-r);
+		nvgBezierTo(vg, cx+r*0.4f, cy-r*0.5f, cx+r*0.4f, cy+r*0.5f, cx-r*0.4f, cy+r);
+		break;
+	}
+}
+
+static void initWidgets(NVGcontext* vg, Widget* widgets, int retained)
+{
+	float cw = (float)WIDTH / WIDGET_COLS, ch = (float)HEIGHT / WIDGET_ROWS;
+	int i;
+	for (i = 0; i < WIDGET_COUNT; i++) {
+		Widget* wg = &widgets[i];
+		wg->w = cw - 2 - (i % 3);
+		wg->h = ch - 2 - (i % 2);
+		wg->x = (i % WIDGET_COLS) * cw + 1;
+		wg->y = (i / WIDGET_COLS) * ch + 1;
+		wg->kind = (i * 7 + i / WIDGET_COLS) % 4;
+		wg->background = NULL;
+		wg->glyph = NULL;
+		if (retained) {
+			widgetBackgroundPath(vg, wg);
+			wg->background = nvgCreateShape(vg);
+			widgetGlyphPath(vg, wg);
+			wg->glyph = nvgCreateShape(vg);
+		}
+	}
+}
+
+static void deleteWidgets(NVGcontext* vg, Widget* widgets)
+{
+	int i;
+	for (i = 0; i < WIDGET_COUNT; i++) {
+		nvgDeleteShape(vg, widgets[i].background);
+		nvgDeleteShape(vg, widgets[i].glyph);
+	}
+}
+
+static void drawWidgets(NVGcontext* vg, Widget* widgets, int frame)
+{
+	float scroll = (float)(frame % 8);	// The whole UI scrolls, only the translation changes.
+	int i;
+	for (i = 0; i < WIDGET_COUNT; i++) {
+		Widget* wg = &widgets[i];
+		float hue = (float)(i % 37) / 37.0f;
+		nvgSave(vg);
+		nvgTranslate(vg, wg->x, wg->y - scroll);
+
+		nvgFillPaint(vg, nvgLinearGradient(vg, 0, 0, 0, wg->h, nvgHSLA(hue, 0.3f, 0.3f, 255), nvgHSLA(hue, 0.3f, 0.2f, 255)));
+		nvgStrokeColor(vg, nvgRGBA(0,0,0,160));
+		nvgStrokeWidth(vg, 1.0f);
+		if (wg->background != NULL) {
+			nvgFillShape(vg, wg->background);
+			nvgStrokeShape(vg, wg->background);
+		} else {
+			widgetBackgroundPath(vg, wg);
+			nvgFill(vg);
+			nvgStroke(vg);
+		}
+
+		if (wg->kind == 2) {
+			nvgTranslate(vg, wg->w*0.5f, wg->h*0.5f);
+			nvgRotate(vg, i*0.1f + frame*0.05f);
+		}
+		nvgStrokeColor(vg, nvgHSLA(hue, 0.8f, 0.7f, 255));
+		nvgStrokeWidth(vg, 1.5f);
+		nvgLineCap(vg, NVG_ROUND);
+		nvgLineJoin(vg, NVG_ROUND);
+		if (wg->glyph != NULL) {
+			if (wg->kind == 1) {
+				nvgFillColor(vg, nvgRGBA(220,220,220,255));
+				nvgFillShape(vg, wg->glyph);
+			}
+			nvgStrokeShape(vg, wg->glyph);
+		} else {
+			widgetGlyphPath(vg, wg);
+			if (wg->kind == 1) {
+				nvgFillColor(vg, nvgRGBA(220,220,220,255));
+				nvgFill(vg);
+			}
+			nvgStroke(vg);
+		}
+		nvgRestore(vg);
+	}
+}
+
+static double timeFrontEnd(int retained, int frames, int* hits, int* misses)
+{
+	NVGcontext* vg = createNull();
+	Widget* widgets = (Widget*)malloc(sizeof(Widget)*WIDGET_COUNT);
+	double t0;
+	int i;
+
+	if (vg == NULL || widgets == NULL) {
+		printf("Could not init nanovg.\n");
+		exit(1);
+	}
+	initWidgets(vg, widgets, retained);
+
+	t0 = getTime();
+	for (i = 0; i < frames; i++) {
+		nvgBeginFrame(vg, WIDTH, HEIGHT, 1.0f);
+		drawWidgets(vg, widgets, i);
+		nvgEndFrame(vg);
+	}
+	t0 = (getTime() - t0) / frames;
+	nvgShapeCacheStats(vg, hits, misses);
+
+	deleteWidgets(vg, widgets);
+	free(widgets);
+	nvgDeleteInternal(vg);
+	return t0;
+}
+
+static unsigned char* render(int retained, int frame)
+{
+	NVGcontext* vg = nvgCreateSW(NVG_ANTIALIAS | NVG_STENCIL_STROKES, 1);
+	Widget* widgets = (Widget*)malloc(sizeof(Widget)*WIDGET_COUNT);
+	unsigned char* pixels = (unsigned char*)calloc(WIDTH*HEIGHT, 4);
+
+	if (vg == NULL || widgets == NULL || pixels == NULL) {
+		printf("Could not init nanovg.\n");
+		exit(1);
+	}
+	initWidgets(vg, widgets, retained);
+	nvgswSetFramebuffer(vg, pixels, WIDTH, HEIGHT, WIDTH*4);
+	nvgBeginFrame(vg, WIDTH, HEIGHT, 1.0f);
+	drawWidgets(vg, widgets, frame);
+	nvgEndFrame(vg);
+
+	deleteWidgets(vg, widgets);
+	free(widgets);
+	nvgDeleteSW(vg);
+	return pixels;
+}
+
+int main(int argc, char** argv)
+{
+	int frames = argc > 1 ? atoi(argv[1]) : 100;
+	double immediateTime, retainedTime;
+	int hits, misses, maxDiff = 0, i;
+	unsigned char* immediate;
+	unsigned char* retained;
+
+	immediateTime = timeFrontEnd(0, frames, &hits, &misses);
+	retainedTime = timeFrontEnd(1, frames, &hits, &misses);
+
+	printf("%d widgets, front-end only\n", WIDGET_COUNT);
+	printf("  immediate paths:  %.2f ms/frame\n", immediateTime*1000.0);
+	printf("  retained shapes:  %.2f ms/frame (%.1fx)\n", retainedTime*1000.0, immediateTime / retainedTime);
+	printf("  shape cache, last frame: %d hits, %d misses\n", hits, misses);
+
+	immediate = render(0, 3);
+	retained = render(1, 3);
+	for (i = 0; i < WIDTH*HEIGHT*4; i++) {
+		int d = abs((int)immediate[i] - (int)retained[i]);
+		if (d > maxDiff) maxDiff = d;
+	}
+	printf("Largest difference between the rendered frames: %d\n", maxDiff);
+
+	free(immediate);
+	free(retained);
+	return maxDiff <= 2 ? 0 : 1;
+}
@@ -0,0 +1,198 @@
+//
+// Copyright (c) 2013 Mikko Mononen memon@inside.org
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+// Renders a dashboard headless with the software back-end, on one thread and on
+// all CPUs, checks that both give the same pixels and saves the frame to dashboard.png.
+//   example_sw [width height frames]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "nanovg.h"
+#define NANOVG_SW_IMPLEMENTATION
+#include "nanovg_sw.h"
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+
+#ifdef _WIN32
+#include <windows.h>
+static double getTime()
+{
+	LARGE_INTEGER freq, t;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&t);
+	return (double)t.QuadPart / (double)freq.QuadPart;
+}
+#else
+static double getTime()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+#endif
+
+static int createPattern(NVGcontext* vg)
+{
+	unsigned char pixels[16*16*4];
+	int x, y;
+	for (y = 0; y < 16; y++) {
+		for (x = 0; x < 16; x++) {
+			unsigned char c = ((x/4 + y/4) & 1) ? 255 : 200;
+			unsigned char* p = &pixels[(y*16+x)*4];
+			p[0] = c; p[1] = c; p[2] = c; p[3] = 255;
+		}
+	}
+	return nvgCreateImageRGBA(vg, 16, 16, NVG_IMAGE_REPEATX|NVG_IMAGE_REPEATY, pixels);
+}
+
+static void drawPanel(NVGcontext* vg, int font, int pattern, int index, float x, float y, float w, float h)
+{
+	char label[64];
+	float values[24];
+	float dx = (w - 20) / 23.0f;
+	int i;
+	NVGpaint shadow = nvgBoxGradient(vg, x, y+2, w, h, 6, 10, nvgRGBA(0,0,0,128), nvgRGBA(0,0,0,0));
+
+	for (i = 0; i < 24; i++)
+		values[i] = 0.5f + 0.4f * sinf(index*0.7f + i*0.35f) * cosf(index*0.3f + i*0.11f);
+
+	// Drop shadow
+	nvgBeginPath(vg);
+	nvgRect(vg, x-10, y-10, w+20, h+30);
+	nvgRoundedRect(vg, x, y, w, h, 6);
+	nvgPathWinding(vg, NVG_HOLE);
+	nvgFillPaint(vg, shadow);
+	nvgFill(vg);
+
+	// Background and header
+	nvgBeginPath(vg);
+	nvgRoundedRect(vg, x, y, w, h, 6);
+	nvgFillPaint(vg, nvgLinearGradient(vg, x, y, x, y+h, nvgRGBA(48,50,58,255), nvgRGBA(34,36,42,255)));
+	nvgFill(vg);
+
+	nvgBeginPath(vg);
+	nvgRoundedRect(vg, x+10, y+30, w-20, h-40, 3);
+	nvgFillPaint(vg, nvgImagePattern(vg, x, y, 16, 16, 0, pattern, 0.05f));
+	nvgFill(vg);
+
+	nvgFontFaceId(vg, font);
+	nvgFontSize(vg, 15.0f);
+	nvgFillColor(vg, nvgRGBA(220,220,220,200));
+	nvgTextAlign(vg, NVG_ALIGN_LEFT|NVG_ALIGN_MIDDLE);
+	snprintf(label, sizeof(label), "Sensor %d  %.1f%%", index+1, values[23]*100.0f);
+	nvgText(vg, x+10, y+16, label, NULL);
+
+	// Bars
+	for (i = 0; i < 24; i++) {
+		float bh = values[i] * (h-50) * 0.5f;
+		nvgBeginPath(vg);
+		nvgRect(vg, x+10 + i*dx, y+h-10-bh, dx*0.6f, bh);
+		nvgFillColor(vg, nvgHSLA(index*0.07f, 0.6f, 0.45f, 160));
+		nvgFill(vg);
+	}
+
+	// Line graph
+	nvgBeginPath(vg);
+	nvgMoveTo(vg, x+10, y+30 + (1-values[0])*(h-50));
+	for (i = 1; i < 24; i++)
+		nvgBezierTo(vg, x+10 + (i-0.5f)*dx, y+30 + (1-values[i-1])*(h-50), x+10 + (i-0.5f)*dx, y+30 + (1-values[i])*(h-50), x+10 + i*dx, y+30 + (1-values[i])*(h-50));
+	nvgStrokeColor(vg, nvgRGBA(0,160,192,255));
+	nvgStrokeWidth(vg, 2.0f);
+	nvgStroke(vg);
+
+	// Gauge
+	nvgBeginPath(vg);
+	nvgArc(vg, x+w-30, y+16, 9, -NVG_PI*0.5f, -NVG_PI*0.5f + values[23]*NVG_PI*2, NVG_CW);
+	nvgStrokeColor(vg, nvgRGBA(255,192,0,255));
+	nvgStrokeWidth(vg, 3.0f);
+	nvgStroke(vg);
+}
+
+static void renderDashboard(NVGcontext* vg, int font, int pattern, float width, float height)
+{
+	int cols = 6, rows = 5, i;
+	float pw = (width - 20) / cols, ph = (height - 20) / rows;
+
+	nvgBeginPath(vg);
+	nvgRect(vg, 0, 0, width, height);
+	nvgFillColor(vg, nvgRGBA(28,30,34,255));
+	nvgFill(vg);
+
+	for (i = 0; i < cols*rows; i++)
+		drawPanel(vg, font, pattern, i, 10 + (i%cols)*pw + 5, 10 + (i/cols)*ph + 5, pw - 10, ph - 10);
+}
+
+static unsigned char* renderFrames(int nthreads, int width, int height, int frames, double* frameTime)
+{
+	NVGcontext* vg = nvgCreateSW(NVG_ANTIALIAS | NVG_STENCIL_STROKES, nthreads);
+	unsigned char* pixels = (unsigned char*)malloc(width*height*4);
+	int font, pattern, i;
+	double t0;
+
+	if (vg == NULL || pixels == NULL) {
+		printf("Could not init nanovg.\n");
+		exit(1);
+	}
+	font = nvgCreateFont(vg, "sans", "../example/Roboto-Regular.ttf");
+	if (font == -1) {
+		printf("Could not add font.\n");
+		exit(1);
+	}
+	pattern = createPattern(vg);
+
+	nvgswSetFramebuffer(vg, pixels, width, height, width*4);
+	t0 = getTime();
+	for (i = 0; i < frames; i++) {
+		memset(pixels, 0, width*height*4);
+		nvgBeginFrame(vg, width, height, 1.0f);
+		renderDashboard(vg, font, pattern, (float)width, (float)height);
+		nvgEndFrame(vg);
+	}
+	*frameTime = (getTime() - t0) / frames;
+
+	nvgDeleteSW(vg);
+	return pixels;
+}
+
+int main(int argc, char** argv)
+{
+	int width = argc > 3 ? atoi(argv[1]) : 1920;
+	int height = argc > 3 ? atoi(argv[2]) : 1080;
+	int frames = argc > 3 ? atoi(argv[3]) : 20;
+	double serialTime, parallelTime;
+	unsigned char* serial;
+	unsigned char* parallel;
+	int same;
+
+	serial = renderFrames(1, width, height, frames, &serialTime);
+	parallel = renderFrames(0, width, height, frames, &parallelTime);
+	same = memcmp(serial, parallel, width*height*4) == 0;
+
+	printf("%dx%d, 1 thread:     %.2f ms/frame\n", width, height, serialTime*1000.0);
+	printf("%dx%d, all threads:  %.2f ms/frame\n", width, height, parallelTime*1000.0);
+	printf("%s\n", same ? "Frames are identical." : "Frames differ!");
+
+	stbi_write_png("dashboard.png", width, height, 4, serial, width*4);
+
+	free(serial);
+	free(parallel);
+	return same ? 0 : 1;
+}
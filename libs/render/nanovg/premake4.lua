@@ -224,3 +224,47 @@ solution "nanovg"
 		configuration "Release"
 			defines { "NDEBUG" }
 			flags { "Optimize", "ExtraWarnings"}
+
+	project "example_sw"
+		kind "ConsoleApp"
+		language "C"
+		files { "example/example_sw.c" }
+		includedirs { "src", "example" }
+		targetdir("build")
+		links { "nanovg" }
+
+		configuration { "linux" }
+			 links { "m", "pthread" }
+
+		configuration { "windows" }
+			 defines { "_CRT_SECURE_NO_WARNINGS" }
+
+		configuration "Debug"
+			defines { "DEBUG" }
+			flags { "Symbols", "ExtraWarnings"}
+
+		configuration "Release"
+			defines { "NDEBUG" }
+			flags { "Optimize", "ExtraWarnings"}
+
+	project "example_retained"
+		kind "ConsoleApp"
+		language "C"
+		files { "example/example_retained.c" }
+		includedirs { "src", "example" }
+		targetdir("build")
+		links { "nanovg" }
+
+		configuration { "linux" }
+			 links { "m", "pthread" }
+
+		configuration { "windows" }
+			 defines { "_CRT_SECURE_NO_WARNINGS" }
+
+		configuration "Debug"
+			defines { "DEBUG" }
+			flags { "Symbols", "ExtraWarnings"}
+
+		configuration "Release"
+			defines { "NDEBUG" }
+			flags { "Optimize", "ExtraWarnings"}
@@ -104,6 +104,36 @@ struct NVGpathCache {
 };
 typedef struct NVGpathCache NVGpathCache;
 
+// Identifies the expanded geometry of a shape, see nvg__shapeSpace().
+struct NVGshapeKey {
+	float space[4];
+	float tessTol;
+	float fringeWidth;
+	float width;
+	float miterLimit;
+	int lineCap;
+	int lineJoin;
+};
+typedef struct NVGshapeKey NVGshapeKey;
+
+struct NVGshapeGeometry {
+	NVGshapeKey key;
+	int valid;
+	NVGpath* paths;
+	int npaths;
+	NVGvertex* verts;
+	int nverts;
+	float bounds[4];
+};
+typedef struct NVGshapeGeometry NVGshapeGeometry;
+
+struct NVGshape {
+	float* commands;	// In the local space of the transform at creation.
+	int ncommands;
+	NVGshapeGeometry fill;
+	NVGshapeGeometry stroke;
+};
+
 struct NVGcontext {
 	NVGparams params;
 	float* commands;
@@ -124,6 +154,10 @@ struct NVGcontext {
 	int fillTriCount;
 	int strokeTriCount;
 	int textTriCount;
+	float* shapeCommands;
+	int cshapeCommands;
+	int shapeCacheHits;
+	int shapeCacheMisses;
 };
 
 static float nvg__sqrtf(float a) { return sqrtf(a); }
@@ -262,6 +296,7 @@ void nvgDeleteInternal(NVGcontext* ctx)
 	int i;
 	if (ctx == NULL) return;
 	if (ctx->commands != NULL) free(ctx->commands);
+	if (ctx->shapeCommands != NULL) free(ctx->shapeCommands);
 	if (ctx->cache != NULL) nvg__deletePathCache(ctx->cache);
 
 	if (ctx->fs)
@@ -298,6 +333,8 @@ void nvgBeginFrame(NVGcontext* ctx, int windowWidth, int windowHeight, float dev
 	ctx->fillTriCount = 0;
 	ctx->strokeTriCount = 0;
 	ctx->textTriCount = 0;
+	ctx->shapeCacheHits = 0;
+	ctx->shapeCacheMisses = 0;
 }
 
 void nvgCancelFrame(NVGcontext* ctx)
@@ -960,56 +997,60 @@ static float nvg__distPtSeg(float x, float y, float px, float py, float qx, floa
 	return dx*dx + dy*dy;
 }
 
-static void nvg__appendCommands(NVGcontext* ctx, float* vals, int nvals)
+static void nvg__transformCommands(float* dst, const float* src, int nvals, const float* t)
 {
-	NVGstate* state = nvg__getState(ctx);
-	int i;
-
-	if (ctx->ncommands+nvals > ctx->ccommands) {
-		float* commands;
-		int ccommands = ctx->ncommands+nvals + ctx->ccommands/2;
-		commands = (float*)realloc(ctx->commands, sizeof(float)*ccommands);
-		if (commands == NULL) return;
-		ctx->commands = commands;
-		ctx->ccommands = ccommands;
-	}
-
-	if ((int)vals[0] != NVG_CLOSE && (int)vals[0] != NVG_WINDING) {
-		ctx->commandx = vals[nvals-2];
-		ctx->commandy = vals[nvals-1];
-	}
-
-	// transform commands
-	i = 0;
+	int i = 0;
 	while (i < nvals) {
-		int cmd = (int)vals[i];
+		int cmd = (int)src[i];
+		dst[i] = src[i];
 		switch (cmd) {
 		case NVG_MOVETO:
-			nvgTransformPoint(&vals[i+1],&vals[i+2], state->xform, vals[i+1],vals[i+2]);
+			nvgTransformPoint(&dst[i+1],&dst[i+2], t, src[i+1],src[i+2]);
 			i += 3;
 			break;
 		case NVG_LINETO:
-			nvgTransformPoint(&vals[i+1],&vals[i+2], state->xform, vals[i+1],vals[i+2]);
+			nvgTransformPoint(&dst[i+1],&dst[i+2], t, src[i+1],src[i+2]);
 			i += 3;
 			break;
 		case NVG_BEZIERTO:
-			nvgTransformPoint(&vals[i+1],&vals[i+2], state->xform, vals[i+1],vals[i+2]);
-			nvgTransformPoint(&vals[i+3],&vals[i+4], state->xform, vals[i+3],vals[i+4]);
-			nvgTransformPoint(&vals[i+5],&vals[i+6], state->xform, vals[i+5],vals[i+6]);
+			nvgTransformPoint(&dst[i+1],&dst[i+2], t, src[i+1],src[i+2]);
+			nvgTransformPoint(&dst[i+3],&dst[i+4], t, src[i+3],src[i+4]);
+			nvgTransformPoint(&dst[i+5],&dst[i+6], t, src[i+5],src[i+6]);
 			i += 7;
 			break;
 		case NVG_CLOSE:
 			i++;
 			break;
 		case NVG_WINDING:
+			dst[i+1] = src[i+1];
 			i += 2;
 			break;
 		default:
 			i++;
 		}
 	}
+}
+
+static void nvg__appendCommands(NVGcontext* ctx, float* vals, int nvals)
+{
+	NVGstate* state = nvg__getState(ctx);
+
+	if (ctx->ncommands+nvals > ctx->ccommands) {
+		float* commands;
+		int ccommands = ctx->ncommands+nvals + ctx->ccommands/2;
+		commands = (float*)realloc(ctx->commands, sizeof(float)*ccommands);
+		if (commands == NULL) return;
+		ctx->commands = commands;
+		ctx->ccommands = ccommands;
+	}
+
+	if ((int)vals[0] != NVG_CLOSE && (int)vals[0] != NVG_WINDING) {
+		ctx->commandx = vals[nvals-2];
+		ctx->commandy = vals[nvals-1];
+	}
 
-	memcpy(&ctx->commands[ctx->ncommands], vals, nvals*sizeof(float));
+	// transform commands
+	nvg__transformCommands(&ctx->commands[ctx->ncommands], vals, nvals, state->xform);
 
 	ctx->ncommands += nvals;
 }
@@ -2153,6 +2194,301 @@ void nvgStroke(NVGcontext* ctx)
 	}
 }
 
+// Retained shapes
+static void nvg__shapeSpace(const float* t, float* space, float* xform)
+{
+	// Under rotation, uniform scale and translation the geometry is expanded at the scale of
+	// the transform and rotated when replayed, so only a change of scale needs a new expansion.
+	// Other transforms are expanded with their whole linear part and only translated.
+	float sx2 = t[0]*t[0] + t[1]*t[1];
+	float sy2 = t[2]*t[2] + t[3]*t[3];
+	float dot = t[0]*t[2] + t[1]*t[3];
+	float det = t[0]*t[3] - t[1]*t[2];
+	if (det > 0.0f && nvg__absf(sx2 - sy2) <= sx2*1e-4f && nvg__absf(dot) <= sx2*1e-4f) {
+		// Round the scale so that rotations do not miss the cache on last bit differences.
+		int e;
+		float s = frexpf(nvg__sqrtf(det), &e);
+		s = ldexpf(floorf(s*65536.0f + 0.5f) / 65536.0f, e);
+		space[0] = s; space[1] = 0.0f;
+		space[2] = 0.0f; space[3] = s;
+		xform[0] = t[0] / s; xform[1] = t[1] / s;
+		xform[2] = t[2] / s; xform[3] = t[3] / s;
+	} else {
+		space[0] = t[0]; space[1] = t[1];
+		space[2] = t[2]; space[3] = t[3];
+		xform[0] = 1.0f; xform[1] = 0.0f;
+		xform[2] = 0.0f; xform[3] = 1.0f;
+	}
+	xform[4] = t[4];
+	xform[5] = t[5];
+}
+
+static void nvg__shapeKey(NVGcontext* ctx, NVGshapeKey* key, const float* space, float w, int lineCap, int lineJoin, float miterLimit)
+{
+	memset(key, 0, sizeof(*key));
+	memcpy(key->space, space, sizeof(float)*4);
+	key->tessTol = ctx->tessTol;
+	key->fringeWidth = ctx->fringeWidth;
+	key->width = w;
+	key->miterLimit = miterLimit;
+	key->lineCap = lineCap;
+	key->lineJoin = lineJoin;
+}
+
+static int nvg__expandShape(NVGcontext* ctx, NVGshape* shape, NVGshapeGeometry* geom, const NVGshapeKey* key, int stroke)
+{
+	NVGpathCache* cache = ctx->cache;
+	float* commands = ctx->commands;
+	int ncommands = ctx->ncommands;
+	float t[6];
+	int i, nverts, ok = 0;
+
+	if (ctx->cshapeCommands < shape->ncommands) {
+		float* shapeCommands = (float*)realloc(ctx->shapeCommands, sizeof(float)*shape->ncommands);
+		if (shapeCommands == NULL) return 0;
+		ctx->shapeCommands = shapeCommands;
+		ctx->cshapeCommands = shape->ncommands;
+	}
+	t[0] = key->space[0]; t[1] = key->space[1];
+	t[2] = key->space[2]; t[3] = key->space[3];
+	t[4] = 0.0f; t[5] = 0.0f;
+	nvg__transformCommands(ctx->shapeCommands, shape->commands, shape->ncommands, t);
+
+	// Run the shape through the path cache, the current path is flattened again when it is drawn.
+	ctx->commands = ctx->shapeCommands;
+	ctx->ncommands = shape->ncommands;
+	nvg__clearPathCache(ctx);
+	nvg__flattenPaths(ctx);
+	if (stroke)
+		ok = nvg__expandStroke(ctx, key->width, key->lineCap, key->lineJoin, key->miterLimit);
+	else
+		ok = nvg__expandFill(ctx, key->width, key->lineJoin, key->miterLimit);
+	ctx->commands = commands;
+	ctx->ncommands = ncommands;
+
+	geom->valid = 0;
+	if (ok) {
+		nverts = 0;
+		for (i = 0; i < cache->npaths; i++)
+			nverts += cache->paths[i].nfill + cache->paths[i].nstroke;
+		if (geom->npaths < cache->npaths) {
+			NVGpath* paths = (NVGpath*)realloc(geom->paths, sizeof(NVGpath)*cache->npaths);
+			if (paths == NULL) ok = 0;
+			else geom->paths = paths;
+		}
+		if (ok && geom->nverts < nverts) {
+			NVGvertex* verts = (NVGvertex*)realloc(geom->verts, sizeof(NVGvertex)*nverts);
+			if (verts == NULL) ok = 0;
+			else geom->verts = verts;
+		}
+	}
+	if (ok) {
+		// Paths and their vertices are laid out back to back in the cache.
+		memcpy(geom->verts, cache->verts, sizeof(NVGvertex)*nverts);
+		for (i = 0; i < cache->npaths; i++) {
+			NVGpath* path = &geom->paths[i];
+			*path = cache->paths[i];
+			path->fill = path->nfill > 0 ? geom->verts + (cache->paths[i].fill - cache->verts) : NULL;
+			path->stroke = path->nstroke > 0 ? geom->verts + (cache->paths[i].stroke - cache->verts) : NULL;
+		}
+		geom->npaths = cache->npaths;
+		geom->nverts = nverts;
+		memcpy(geom->bounds, cache->bounds, sizeof(float)*4);
+		geom->key = *key;
+		geom->valid = 1;
+	}
+	nvg__clearPathCache(ctx);
+
+	return ok;
+}
+
+static NVGshapeGeometry* nvg__shapeGeometry(NVGcontext* ctx, NVGshape* shape, int stroke, const float* space, float w, int lineCap, int lineJoin, float miterLimit)
+{
+	NVGshapeGeometry* geom = stroke ? &shape->stroke : &shape->fill;
+	NVGshapeKey key;
+
+	nvg__shapeKey(ctx, &key, space, w, lineCap, lineJoin, miterLimit);
+	if (geom->valid && memcmp(&geom->key, &key, sizeof(key)) == 0) {
+		ctx->shapeCacheHits++;
+		return geom;
+	}
+	ctx->shapeCacheMisses++;
+	if (!nvg__expandShape(ctx, shape, geom, &key, stroke))
+		return NULL;
+	return geom;
+}
+
+static int nvg__replayShape(NVGcontext* ctx, const NVGshapeGeometry* geom, const float* t)
+{
+	NVGpathCache* cache = ctx->cache;
+	NVGvertex* verts;
+	int i;
+
+	if (geom->npaths > cache->cpaths) {
+		NVGpath* paths;
+		int cpaths = geom->npaths + cache->cpaths/2;
+		paths = (NVGpath*)realloc(cache->paths, sizeof(NVGpath)*cpaths);
+		if (paths == NULL) return 0;
+		cache->paths = paths;
+		cache->cpaths = cpaths;
+	}
+	verts = nvg__allocTempVerts(ctx, geom->nverts);
+	if (verts == NULL) return 0;
+
+	for (i = 0; i < geom->nverts; i++) {
+		const NVGvertex* src = &geom->verts[i];
+		verts[i].x = src->x*t[0] + src->y*t[2] + t[4];
+		verts[i].y = src->x*t[1] + src->y*t[3] + t[5];
+		verts[i].u = src->u;
+		verts[i].v = src->v;
+	}
+	for (i = 0; i < geom->npaths; i++) {
+		NVGpath* path = &cache->paths[i];
+		*path = geom->paths[i];
+		if (path->fill != NULL) path->fill = verts + (geom->paths[i].fill - geom->verts);
+		if (path->stroke != NULL) path->stroke = verts + (geom->paths[i].stroke - geom->verts);
+	}
+	cache->npaths = geom->npaths;
+	cache->npoints = 0;
+
+	// Bounds of the transformed bounding box.
+	cache->bounds[0] = cache->bounds[1] = 1e6f;
+	cache->bounds[2] = cache->bounds[3] = -1e6f;
+	for (i = 0; i < 4; i++) {
+		float x, y;
+		nvgTransformPoint(&x, &y, t, geom->bounds[(i & 1) ? 2 : 0], geom->bounds[(i & 2) ? 3 : 1]);
+		cache->bounds[0] = nvg__minf(cache->bounds[0], x);
+		cache->bounds[1] = nvg__minf(cache->bounds[1], y);
+		cache->bounds[2] = nvg__maxf(cache->bounds[2], x);
+		cache->bounds[3] = nvg__maxf(cache->bounds[3], y);
+	}
+
+	return 1;
+}
+
+NVGshape* nvgCreateShape(NVGcontext* ctx)
+{
+	NVGstate* state = nvg__getState(ctx);
+	NVGshape* shape;
+	float inv[6];
+
+	if (!nvgTransformInverse(inv, state->xform)) return NULL;
+
+	shape = (NVGshape*)malloc(sizeof(NVGshape));
+	if (shape == NULL) goto error;
+	memset(shape, 0, sizeof(NVGshape));
+
+	shape->commands = (float*)malloc(sizeof(float)*nvg__maxi(ctx->ncommands, 1));
+	if (shape->commands == NULL) goto error;
+	nvg__transformCommands(shape->commands, ctx->commands, ctx->ncommands, inv);
+	shape->ncommands = ctx->ncommands;
+
+	return shape;
+
+error:
+	nvgDeleteShape(ctx, shape);
+	return NULL;
+}
+
+void nvgDeleteShape(NVGcontext* ctx, NVGshape* shape)
+{
+	NVG_NOTUSED(ctx);
+	if (shape == NULL) return;
+	if (shape->commands != NULL) free(shape->commands);
+	if (shape->fill.paths != NULL) free(shape->fill.paths);
+	if (shape->fill.verts != NULL) free(shape->fill.verts);
+	if (shape->stroke.paths != NULL) free(shape->stroke.paths);
+	if (shape->stroke.verts != NULL) free(shape->stroke.verts);
+	free(shape);
+}
+
+void nvgFillShape(NVGcontext* ctx, NVGshape* shape)
+{
+	NVGstate* state = nvg__getState(ctx);
+	NVGshapeGeometry* geom;
+	const NVGpath* path;
+	NVGpaint fillPaint = state->fill;
+	float space[4], xform[6];
+	int i;
+
+	if (shape == NULL) return;
+
+	nvg__shapeSpace(state->xform, space, xform);
+	geom = nvg__shapeGeometry(ctx, shape, 0, space, ctx->params.edgeAntiAlias ? ctx->fringeWidth : 0.0f, NVG_BUTT, NVG_MITER, 2.4f);
+	if (geom == NULL || !nvg__replayShape(ctx, geom, xform)) return;
+
+	// Apply global alpha
+	fillPaint.innerColor.a *= state->alpha;
+	fillPaint.outerColor.a *= state->alpha;
+
+	ctx->params.renderFill(ctx->params.userPtr, &fillPaint, &state->scissor, ctx->fringeWidth,
+						   ctx->cache->bounds, ctx->cache->paths, ctx->cache->npaths);
+
+	// Count triangles
+	for (i = 0; i < ctx->cache->npaths; i++) {
+		path = &ctx->cache->paths[i];
+		ctx->fillTriCount += path->nfill-2;
+		ctx->fillTriCount += path->nstroke-2;
+		ctx->drawCallCount += 2;
+	}
+
+	nvg__clearPathCache(ctx);
+}
+
+void nvgStrokeShape(NVGcontext* ctx, NVGshape* shape)
+{
+	NVGstate* state = nvg__getState(ctx);
+	float scale = nvg__getAverageScale(state->xform);
+	float strokeWidth = nvg__clampf(state->strokeWidth * scale, 0.0f, 200.0f);
+	NVGpaint strokePaint = state->stroke;
+	NVGshapeGeometry* geom;
+	const NVGpath* path;
+	float space[4], xform[6], w;
+	int i;
+
+	if (shape == NULL) return;
+
+	if (strokeWidth < ctx->fringeWidth) {
+		// If the stroke width is less than pixel size, use alpha to emulate coverage.
+		// Since coverage is area, scale by alpha*alpha.
+		float alpha = nvg__clampf(strokeWidth / ctx->fringeWidth, 0.0f, 1.0f);
+		strokePaint.innerColor.a *= alpha*alpha;
+		strokePaint.outerColor.a *= alpha*alpha;
+		strokeWidth = ctx->fringeWidth;
+	}
+
+	// Apply global alpha
+	strokePaint.innerColor.a *= state->alpha;
+	strokePaint.outerColor.a *= state->alpha;
+
+	if (ctx->params.edgeAntiAlias)
+		w = strokeWidth*0.5f + ctx->fringeWidth*0.5f;
+	else
+		w = strokeWidth*0.5f;
+
+	nvg__shapeSpace(state->xform, space, xform);
+	geom = nvg__shapeGeometry(ctx, shape, 1, space, w, state->lineCap, state->lineJoin, state->miterLimit);
+	if (geom == NULL || !nvg__replayShape(ctx, geom, xform)) return;
+
+	ctx->params.renderStroke(ctx->params.userPtr, &strokePaint, &state->scissor, ctx->fringeWidth,
+							 strokeWidth, ctx->cache->paths, ctx->cache->npaths);
+
+	// Count triangles
+	for (i = 0; i < ctx->cache->npaths; i++) {
+		path = &ctx->cache->paths[i];
+		ctx->strokeTriCount += path->nstroke-2;
+		ctx->drawCallCount++;
+	}
+
+	nvg__clearPathCache(ctx);
+}
+
+void nvgShapeCacheStats(NVGcontext* ctx, int* hits, int* misses)
+{
+	if (hits != NULL) *hits = ctx->shapeCacheHits;
+	if (misses != NULL) *misses = ctx->shapeCacheMisses;
+}
+
 // Add fonts
 int nvgCreateFont(NVGcontext* ctx, const char* name, const char* path)
 {
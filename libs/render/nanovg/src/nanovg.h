@@ -31,6 +31,7 @@ extern "C" {
 #endif
 
 typedef struct NVGcontext NVGcontext;
+typedef struct NVGshape NVGshape;
 
 struct NVGcolor {
 	union {
@@ -449,6 +450,41 @@ void nvgFill(NVGcontext* ctx);
 // Fills the current path with current stroke style.
 void nvgStroke(NVGcontext* ctx);
 
+//
+// Retained shapes
+//
+// A shape records the current path once so that static geometry does not need to be
+// flattened and expanded again every frame. The path is stored in the local space of
+// the current transform, and drawn with the transform, paint, stroke style and scissor
+// that are current when it is filled or stroked.
+//
+// The expanded fill and stroke of a shape are cached. Under rotation, uniform scale and
+// translation the cached geometry is reused while the scale, the stroke width, caps, joins
+// and miter limit stay the same, other transforms reuse it while only the translation changes.
+//
+//		nvgBeginPath(vg);
+//		nvgRoundedRect(vg, 0,0, 120,30, 4);
+//		button = nvgCreateShape(vg);
+//		...
+//		nvgTranslate(vg, x,y);
+//		nvgFillShape(vg, button);
+
+// Creates a shape from the current path. Returns NULL if the current transform is not invertible.
+NVGshape* nvgCreateShape(NVGcontext* ctx);
+
+// Deletes a shape.
+void nvgDeleteShape(NVGcontext* ctx, NVGshape* shape);
+
+// Fills the shape with current fill style.
+void nvgFillShape(NVGcontext* ctx, NVGshape* shape);
+
+// Strokes the shape with current stroke style.
+void nvgStrokeShape(NVGcontext* ctx, NVGshape* shape);
+
+// Returns how many shape fills and strokes reused their cached geometry (hits) and how many
+// had to be expanded again (misses) since nvgBeginFrame().
+void nvgShapeCacheStats(NVGcontext* ctx, int* hits, int* misses);
+
 
 //
 // Text
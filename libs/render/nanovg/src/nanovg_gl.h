@@ -26,6 +26,7 @@ extern "C" {
 
 // Create flags
 
+#ifndef NANOVG_SW_H
 enum NVGcreateFlags {
 	// Flag indicating if geometry based anti-aliasing is used (may not be needed when using MSAA).
 	NVG_ANTIALIAS 		= 1<<0,
@@ -35,6 +36,7 @@ enum NVGcreateFlags {
 	// Flag indicating that additional debug checks are done.
 	NVG_DEBUG 			= 1<<2,
 };
+#endif
 
 #if defined NANOVG_GL2_IMPLEMENTATION
 #  define NANOVG_GL2 1
@@ -0,0 +1,1649 @@
+//
+// Copyright (c) 2009-2013 Mikko Mononen memon@inside.org
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+#ifndef NANOVG_SW_H
+#define NANOVG_SW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Create flags, the same as for the GL back-ends.
+
+#ifndef NANOVG_GL_H
+enum NVGcreateFlags {
+	// Flag indicating if geometry based anti-aliasing is used (may not be needed when using MSAA).
+	NVG_ANTIALIAS 		= 1<<0,
+	// Flag indicating if strokes should be drawn using stencil buffer. The rendering will be a little
+	// slower, but path overlaps (i.e. self-intersecting or sharp turns) will be drawn just once.
+	NVG_STENCIL_STROKES	= 1<<1,
+	// Flag indicating that additional debug checks are done.
+	NVG_DEBUG 			= 1<<2,
+};
+#endif
+
+// Creates NanoVG context which renders into a memory buffer on the CPU, no GL context is needed.
+// Flags should be combination of the create flags above. The frame is split into screen tiles
+// which are rendered by 'nthreads' threads, 0 uses one thread per CPU. The rendered pixels do not
+// depend on the number of threads.
+NVGcontext* nvgCreateSW(int flags, int nthreads);
+void nvgDeleteSW(NVGcontext* ctx);
+
+// Sets the buffer the frame is rendered into: 'w' x 'h' pixels of premultiplied RGBA, 'stride' bytes per row.
+// The window size passed to nvgBeginFrame() is scaled to the buffer size, like the GL viewport would.
+// The buffer is not cleared, nvgEndFrame() blends the frame over its contents.
+void nvgswSetFramebuffer(NVGcontext* ctx, unsigned char* pixels, int w, int h, int stride);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NANOVG_SW_H */
+
+#ifdef NANOVG_SW_IMPLEMENTATION
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "nanovg.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define NANOVG_SW_SSE2 1
+#  include <emmintrin.h>
+#endif
+
+#ifdef _WIN32
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#else
+#  include <pthread.h>
+#  include <unistd.h>
+#endif
+
+// Tiles are squares of this many pixels, every tile keeps its own stencil buffer.
+#define SWNVG_TILE_SIZE 64
+#define SWNVG_MAX_THREADS 64
+
+enum SWNVGshaderType {
+	SWNVG_SHADER_FILLGRAD,
+	SWNVG_SHADER_FILLIMG,
+	SWNVG_SHADER_SIMPLE,
+	SWNVG_SHADER_IMG
+};
+
+struct SWNVGtexture {
+	int id;
+	unsigned char* data;
+	int width, height;
+	int type;
+	int flags;
+};
+typedef struct SWNVGtexture SWNVGtexture;
+
+enum SWNVGcallType {
+	SWNVG_NONE = 0,
+	SWNVG_FILL,
+	SWNVG_CONVEXFILL,
+	SWNVG_STROKE,
+	SWNVG_TRIANGLES,
+};
+
+struct SWNVGcall {
+	int type;
+	int image;
+	int pathOffset;
+	int pathCount;
+	int triangleOffset;
+	int triangleCount;
+	int uniformOffset;
+	float scissorBounds[4];	// Window space bounds of the scissor, everything outside is masked out.
+	int bounds[4];			// Pixels the call may touch, x0,y0,x1,y1 exclusive, set at flush.
+};
+typedef struct SWNVGcall SWNVGcall;
+
+struct SWNVGpath {
+	int fillOffset;
+	int fillCount;
+	int strokeOffset;
+	int strokeCount;
+};
+typedef struct SWNVGpath SWNVGpath;
+
+// Same uniforms as the GL fragment shader.
+struct SWNVGfragUniforms {
+	float scissorMat[6];
+	float paintMat[6];
+	struct NVGcolor innerCol;
+	struct NVGcolor outerCol;
+	float scissorExt[2];
+	float scissorScale[2];
+	float extent[2];
+	float radius;
+	float feather;
+	float strokeMult;
+	float strokeThr;
+	int texType;
+	int type;
+	int scissor;	// 0 when the scissor is disabled.
+	int solid;		// Gradient with the same inner and outer color.
+};
+typedef struct SWNVGfragUniforms SWNVGfragUniforms;
+
+// Stencil state of a pass, the reference value is always 0.
+enum SWNVGstencilFunc {
+	SWNVG_ALWAYS,
+	SWNVG_EQUAL,
+	SWNVG_NOTEQUAL,
+};
+
+enum SWNVGstencilOp {
+	SWNVG_KEEP,
+	SWNVG_INCR,
+	SWNVG_WINDING,	// Front faces increment, back faces decrement, no color is written.
+};
+
+struct SWNVGpass {
+	const SWNVGfragUniforms* frag;
+	const SWNVGtexture* tex;
+	int stencilFunc;
+	int stencilOp;
+};
+typedef struct SWNVGpass SWNVGpass;
+
+struct SWNVGcontext;
+
+struct SWNVGworker {
+	struct SWNVGcontext* sw;
+	// Current tile in framebuffer pixels.
+	int x0, y0, x1, y1;
+	// Rows of the tile stencil which are not zero.
+	int stencilRows[2];
+	unsigned char stencil[SWNVG_TILE_SIZE*SWNVG_TILE_SIZE];
+	// Span buffers, stroke alpha, coverage (stroke alpha * scissor) and premultiplied color.
+	float alpha[SWNVG_TILE_SIZE];
+	float cover[SWNVG_TILE_SIZE];
+	float color[SWNVG_TILE_SIZE*4];
+	int generation;
+#ifdef _WIN32
+	HANDLE thread;
+#else
+	pthread_t thread;
+#endif
+};
+typedef struct SWNVGworker SWNVGworker;
+
+struct SWNVGcontext {
+	SWNVGtexture* textures;
+	float view[2];
+	int ntextures;
+	int ctextures;
+	int textureId;
+	int flags;
+
+	// Target buffer.
+	unsigned char* pixels;
+	int width, height, stride;
+	// Window to framebuffer scale.
+	float scale[2];
+	float invScale[2];
+
+	// Per frame buffers
+	SWNVGcall* calls;
+	int ccalls;
+	int ncalls;
+	SWNVGpath* paths;
+	int cpaths;
+	int npaths;
+	struct NVGvertex* verts;
+	int cverts;
+	int nverts;
+	SWNVGfragUniforms* uniforms;
+	int cuniforms;
+	int nuniforms;
+
+	// Calls binned per tile, the calls of tile i are tileCalls[tileStart[i]..tileStart[i+1]).
+	int tilesX, tilesY;
+	int* tileStart;
+	int ctileStart;
+	int* tileCalls;
+	int ctileCalls;
+
+	// Worker threads, workers[0] is the thread calling nvgEndFrame().
+	SWNVGworker* workers;
+	int nthreads;
+#ifdef _WIN32
+	CRITICAL_SECTION lock;
+	CONDITION_VARIABLE start;
+	CONDITION_VARIABLE done;
+#else
+	pthread_mutex_t lock;
+	pthread_cond_t start;
+	pthread_cond_t done;
+#endif
+	int generation;
+	int nextTile;
+	int busy;
+	int quit;
+};
+typedef struct SWNVGcontext SWNVGcontext;
+
+static int swnvg__maxi(int a, int b) { return a > b ? a : b; }
+static int swnvg__mini(int a, int b) { return a < b ? a : b; }
+static int swnvg__clampi(int a, int mn, int mx) { return a < mn ? mn : (a > mx ? mx : a); }
+static float swnvg__minf(float a, float b) { return a < b ? a : b; }
+static float swnvg__maxf(float a, float b) { return a > b ? a : b; }
+static float swnvg__clampf(float a, float mn, float mx) { return a < mn ? mn : (a > mx ? mx : a); }
+
+static void swnvg__mutexLock(SWNVGcontext* sw)
+{
+#ifdef _WIN32
+	EnterCriticalSection(&sw->lock);
+#else
+	pthread_mutex_lock(&sw->lock);
+#endif
+}
+
+static void swnvg__mutexUnlock(SWNVGcontext* sw)
+{
+#ifdef _WIN32
+	LeaveCriticalSection(&sw->lock);
+#else
+	pthread_mutex_unlock(&sw->lock);
+#endif
+}
+
+static SWNVGtexture* swnvg__allocTexture(SWNVGcontext* sw)
+{
+	SWNVGtexture* tex = NULL;
+	int i;
+
+	for (i = 0; i < sw->ntextures; i++) {
+		if (sw->textures[i].id == 0) {
+			tex = &sw->textures[i];
+			break;
+		}
+	}
+	if (tex == NULL) {
+		if (sw->ntextures+1 > sw->ctextures) {
+			SWNVGtexture* textures;
+			int ctextures = swnvg__maxi(sw->ntextures+1, 4) +  sw->ctextures/2; // 1.5x Overallocate
+			textures = (SWNVGtexture*)realloc(sw->textures, sizeof(SWNVGtexture)*ctextures);
+			if (textures == NULL) return NULL;
+			sw->textures = textures;
+			sw->ctextures = ctextures;
+		}
+		tex = &sw->textures[sw->ntextures++];
+	}
+
+	memset(tex, 0, sizeof(*tex));
+	tex->id = ++sw->textureId;
+
+	return tex;
+}
+
+static SWNVGtexture* swnvg__findTexture(SWNVGcontext* sw, int id)
+{
+	int i;
+	for (i = 0; i < sw->ntextures; i++)
+		if (sw->textures[i].id == id)
+			return &sw->textures[i];
+	return NULL;
+}
+
+static int swnvg__deleteTexture(SWNVGcontext* sw, int id)
+{
+	int i;
+	for (i = 0; i < sw->ntextures; i++) {
+		if (sw->textures[i].id == id) {
+			free(sw->textures[i].data);
+			memset(&sw->textures[i], 0, sizeof(sw->textures[i]));
+			return 1;
+		}
+	}
+	return 0;
+}
+
+//
+// Rasterization
+//
+// Calls are drawn exactly like the GL back-end draws them: triangles are point sampled at pixel
+// centers with the top-left fill convention, anti-aliasing comes from the fringe geometry nanovg
+// generates, and fills use the stencil winding passes of glnvg__fill().
+//
+
+// Bilinear sample with clamp to edge or repeat, like GL_LINEAR without mipmaps.
+static void swnvg__sampleTexture(const SWNVGtexture* tex, int texType, float s, float t, float* rgba)
+{
+	float fx = swnvg__clampf(s * tex->width - 0.5f, -1e8f, 1e8f);
+	float fy = swnvg__clampf(t * tex->height - 0.5f, -1e8f, 1e8f);
+	float x0f = floorf(fx), y0f = floorf(fy);
+	float tx = fx - x0f, ty = fy - y0f;
+	int x0 = (int)x0f, y0 = (int)y0f;
+	int x1, y1;
+	float w[4];
+	int idx[4];
+
+	if (tex->flags & NVG_IMAGE_REPEATX) {
+		x0 %= tex->width;
+		if (x0 < 0) x0 += tex->width;
+		x1 = x0+1 < tex->width ? x0+1 : 0;
+	} else {
+		x1 = swnvg__clampi(x0+1, 0, tex->width-1);
+		x0 = swnvg__clampi(x0, 0, tex->width-1);
+	}
+	if (tex->flags & NVG_IMAGE_REPEATY) {
+		y0 %= tex->height;
+		if (y0 < 0) y0 += tex->height;
+		y1 = y0+1 < tex->height ? y0+1 : 0;
+	} else {
+		y1 = swnvg__clampi(y0+1, 0, tex->height-1);
+		y0 = swnvg__clampi(y0, 0, tex->height-1);
+	}
+
+	w[0] = (1.0f-tx)*(1.0f-ty);
+	w[1] = tx*(1.0f-ty);
+	w[2] = (1.0f-tx)*ty;
+	w[3] = tx*ty;
+	idx[0] = y0*tex->width + x0;
+	idx[1] = y0*tex->width + x1;
+	idx[2] = y1*tex->width + x0;
+	idx[3] = y1*tex->width + x1;
+
+	if (tex->type == NVG_TEXTURE_RGBA) {
+#ifdef NANOVG_SW_SSE2
+		__m128i zero = _mm_setzero_si128();
+		__m128 c = _mm_setzero_ps();
+		int i;
+		for (i = 0; i < 4; i++) {
+			int texel;
+			memcpy(&texel, &tex->data[idx[i]*4], 4);
+			c = _mm_add_ps(c, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(texel), zero), zero)), _mm_set1_ps(w[i])));
+		}
+		_mm_storeu_ps(rgba, _mm_mul_ps(c, _mm_set1_ps(1.0f/255.0f)));
+#else
+		int i;
+		rgba[0] = rgba[1] = rgba[2] = rgba[3] = 0.0f;
+		for (i = 0; i < 4; i++) {
+			const unsigned char* p = &tex->data[idx[i]*4];
+			rgba[0] += p[0] * w[i];
+			rgba[1] += p[1] * w[i];
+			rgba[2] += p[2] * w[i];
+			rgba[3] += p[3] * w[i];
+		}
+		rgba[0] *= 1.0f/255.0f;
+		rgba[1] *= 1.0f/255.0f;
+		rgba[2] *= 1.0f/255.0f;
+		rgba[3] *= 1.0f/255.0f;
+#endif
+		if (texType == 1) {
+			rgba[0] *= rgba[3];
+			rgba[1] *= rgba[3];
+			rgba[2] *= rgba[3];
+		}
+	} else {
+		float a = (tex->data[idx[0]]*w[0] + tex->data[idx[1]]*w[1] + tex->data[idx[2]]*w[2] + tex->data[idx[3]]*w[3]) * (1.0f/255.0f);
+		rgba[0] = rgba[1] = rgba[2] = rgba[3] = a;
+	}
+}
+
+// Fills w->alpha with the stroke alpha and w->cover with the stroke alpha times the scissor mask
+// for the pixels [x0,x0+n) of row y. 'uv' is the plane of the texture coordinates over the pixels.
+static void swnvg__coverage(SWNVGworker* w, const SWNVGfragUniforms* frag, const float* uv, int y, int x0, int n)
+{
+	SWNVGcontext* sw = w->sw;
+	float py = y + 0.5f;
+	float fy = py * sw->invScale[1];
+	int aa = (sw->flags & NVG_ANTIALIAS) != 0;
+	int img = frag->type == SWNVG_SHADER_IMG;
+	float u0 = uv[0] + uv[2]*py, v0 = uv[3] + uv[5]*py;
+	float sx0 = frag->scissorMat[2]*fy + frag->scissorMat[4];
+	float sy0 = frag->scissorMat[3]*fy + frag->scissorMat[5];
+	int i;
+#ifdef NANOVG_SW_SSE2
+	__m128 one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps(), half = _mm_set1_ps(0.5f);
+	__m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+	__m128 lane = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+	for (i = 0; i < n; i += 4) {
+		__m128 px = _mm_add_ps(_mm_set1_ps((float)(x0+i)), lane);
+		__m128 a = one, c;
+		if (aa) {
+			__m128 u = _mm_add_ps(_mm_set1_ps(u0), _mm_mul_ps(_mm_set1_ps(uv[1]), px));
+			__m128 v = _mm_add_ps(_mm_set1_ps(v0), _mm_mul_ps(_mm_set1_ps(uv[4]), px));
+			__m128 s = _mm_sub_ps(one, _mm_and_ps(_mm_sub_ps(_mm_add_ps(u, u), one), absMask));
+			a = _mm_mul_ps(_mm_min_ps(one, _mm_mul_ps(s, _mm_set1_ps(frag->strokeMult))), _mm_min_ps(one, v));
+		}
+		_mm_storeu_ps(&w->alpha[i], a);
+		c = img ? one : a;
+		if (frag->scissor) {
+			__m128 fx = _mm_mul_ps(px, _mm_set1_ps(sw->invScale[0]));
+			__m128 sx = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(frag->scissorMat[0]), fx), _mm_set1_ps(sx0));
+			__m128 sy = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(frag->scissorMat[1]), fx), _mm_set1_ps(sy0));
+			sx = _mm_sub_ps(_mm_and_ps(sx, absMask), _mm_set1_ps(frag->scissorExt[0]));
+			sy = _mm_sub_ps(_mm_and_ps(sy, absMask), _mm_set1_ps(frag->scissorExt[1]));
+			sx = _mm_sub_ps(half, _mm_mul_ps(sx, _mm_set1_ps(frag->scissorScale[0])));
+			sy = _mm_sub_ps(half, _mm_mul_ps(sy, _mm_set1_ps(frag->scissorScale[1])));
+			sx = _mm_min_ps(one, _mm_max_ps(zero, sx));
+			sy = _mm_min_ps(one, _mm_max_ps(zero, sy));
+			c = _mm_mul_ps(c, _mm_mul_ps(sx, sy));
+		}
+		_mm_storeu_ps(&w->cover[i], c);
+	}
+#else
+	for (i = 0; i < n; i++) {
+		float px = x0 + i + 0.5f;
+		float a = 1.0f, c;
+		if (aa) {
+			float u = u0 + uv[1]*px, v = v0 + uv[4]*px;
+			a = swnvg__minf(1.0f, (1.0f - fabsf(u*2.0f - 1.0f)) * frag->strokeMult) * swnvg__minf(1.0f, v);
+		}
+		w->alpha[i] = a;
+		c = img ? 1.0f : a;
+		if (frag->scissor) {
+			float fx = px * sw->invScale[0];
+			float sx = fabsf(frag->scissorMat[0]*fx + sx0) - frag->scissorExt[0];
+			float sy = fabsf(frag->scissorMat[1]*fx + sy0) - frag->scissorExt[1];
+			sx = swnvg__clampf(0.5f - sx*frag->scissorScale[0], 0.0f, 1.0f);
+			sy = swnvg__clampf(0.5f - sy*frag->scissorScale[1], 0.0f, 1.0f);
+			c *= sx * sy;
+		}
+		w->cover[i] = c;
+	}
+#endif
+}
+
+// Fills w->color with the premultiplied paint color times the coverage.
+static void swnvg__paint(SWNVGworker* w, const SWNVGpass* pass, const float* uv, int y, int x0, int n)
+{
+	SWNVGcontext* sw = w->sw;
+	const SWNVGfragUniforms* frag = pass->frag;
+	float py = y + 0.5f;
+	float fy = py * sw->invScale[1];
+	float* color = w->color;
+	int i;
+
+	if (frag->type == SWNVG_SHADER_FILLGRAD) {
+		const float* inner = frag->innerCol.rgba;
+		const float* outer = frag->outerCol.rgba;
+		if (frag->solid) {
+#ifdef NANOVG_SW_SSE2
+			__m128 col = _mm_loadu_ps(inner);
+			for (i = 0; i < n; i++)
+				_mm_storeu_ps(&color[i*4], _mm_mul_ps(col, _mm_set1_ps(w->cover[i])));
+#else
+			for (i = 0; i < n; i++) {
+				color[i*4+0] = inner[0] * w->cover[i];
+				color[i*4+1] = inner[1] * w->cover[i];
+				color[i*4+2] = inner[2] * w->cover[i];
+				color[i*4+3] = inner[3] * w->cover[i];
+			}
+#endif
+		} else {
+			const float* m = frag->paintMat;
+			float ex = frag->extent[0] - frag->radius, ey = frag->extent[1] - frag->radius;
+			float feather = frag->feather > 1e-6f ? frag->feather : 1e-6f;
+			float ptx0 = m[2]*fy + m[4], pty0 = m[3]*fy + m[5];
+#ifdef NANOVG_SW_SSE2
+			__m128 one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps();
+			__m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+			__m128 lane = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+			__m128 in = _mm_loadu_ps(inner);
+			__m128 delta = _mm_sub_ps(_mm_loadu_ps(outer), in);
+			for (i = 0; i < n; i += 4) {
+				float t[4];
+				int j;
+				__m128 fx = _mm_mul_ps(_mm_add_ps(_mm_set1_ps((float)(x0+i)), lane), _mm_set1_ps(sw->invScale[0]));
+				__m128 ptx = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[0]), fx), _mm_set1_ps(ptx0));
+				__m128 pty = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[1]), fx), _mm_set1_ps(pty0));
+				__m128 dx = _mm_sub_ps(_mm_and_ps(ptx, absMask), _mm_set1_ps(ex));
+				__m128 dy = _mm_sub_ps(_mm_and_ps(pty, absMask), _mm_set1_ps(ey));
+				__m128 mx = _mm_max_ps(dx, zero), my = _mm_max_ps(dy, zero);
+				__m128 d = _mm_add_ps(_mm_min_ps(_mm_max_ps(dx, dy), zero), _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(mx, mx), _mm_mul_ps(my, my))));
+				d = _mm_sub_ps(d, _mm_set1_ps(frag->radius));
+				d = _mm_mul_ps(_mm_add_ps(d, _mm_set1_ps(feather*0.5f)), _mm_set1_ps(1.0f/feather));
+				_mm_storeu_ps(t, _mm_min_ps(one, _mm_max_ps(zero, d)));
+				for (j = 0; j < 4 && i+j < n; j++) {
+					__m128 col = _mm_add_ps(in, _mm_mul_ps(delta, _mm_set1_ps(t[j])));
+					_mm_storeu_ps(&color[(i+j)*4], _mm_mul_ps(col, _mm_set1_ps(w->cover[i+j])));
+				}
+			}
+#else
+			for (i = 0; i < n; i++) {
+				float fx = (x0 + i + 0.5f) * sw->invScale[0];
+				float ptx = m[0]*fx + ptx0, pty = m[1]*fx + pty0;
+				float dx = fabsf(ptx) - ex, dy = fabsf(pty) - ey;
+				float mx = swnvg__maxf(dx, 0.0f), my = swnvg__maxf(dy, 0.0f);
+				float d = swnvg__minf(swnvg__maxf(dx, dy), 0.0f) + sqrtf(mx*mx + my*my) - frag->radius;
+				float t = swnvg__clampf((d + feather*0.5f) / feather, 0.0f, 1.0f);
+				float c = w->cover[i];
+				color[i*4+0] = (inner[0] + (outer[0] - inner[0])*t) * c;
+				color[i*4+1] = (inner[1] + (outer[1] - inner[1])*t) * c;
+				color[i*4+2] = (inner[2] + (outer[2] - inner[2])*t) * c;
+				color[i*4+3] = (inner[3] + (outer[3] - inner[3])*t) * c;
+			}
+#endif
+		}
+	} else if (frag->type == SWNVG_SHADER_FILLIMG || frag->type == SWNVG_SHADER_IMG) {
+		const float* inner = frag->innerCol.rgba;
+		const float* m = frag->paintMat;
+		float u0 = uv[0] + uv[2]*py, v0 = uv[3] + uv[5]*py;
+		for (i = 0; i < n; i++) {
+			float px = x0 + i + 0.5f;
+			float s, t, c = w->cover[i];
+			float* col = &color[i*4];
+			if (c == 0.0f || pass->tex == NULL || pass->tex->data == NULL) {
+				col[0] = col[1] = col[2] = col[3] = 0.0f;
+				continue;
+			}
+			if (frag->type == SWNVG_SHADER_FILLIMG) {
+				float fx = px * sw->invScale[0];
+				s = (m[0]*fx + m[2]*fy + m[4]) / frag->extent[0];
+				t = (m[1]*fx + m[3]*fy + m[5]) / frag->extent[1];
+			} else {
+				s = u0 + uv[1]*px;
+				t = v0 + uv[4]*px;
+			}
+			swnvg__sampleTexture(pass->tex, frag->texType, s, t, col);
+			col[0] *= inner[0] * c;
+			col[1] *= inner[1] * c;
+			col[2] *= inner[2] * c;
+			col[3] *= inner[3] * c;
+		}
+	} else {
+		for (i = 0; i < n*4; i++)
+			color[i] = w->cover[i/4];
+	}
+}
+
+// Blends w->color over the framebuffer, ONE, ONE_MINUS_SRC_ALPHA, and applies the stencil test,
+// the stroke threshold and the stencil op of the pass.
+static void swnvg__blend(SWNVGworker* w, const SWNVGpass* pass, unsigned char* stencil, int y, int x0, int n)
+{
+	SWNVGcontext* sw = w->sw;
+	unsigned char* dst = &sw->pixels[(size_t)y*sw->stride + (size_t)x0*4];
+	float thr = (sw->flags & NVG_ANTIALIAS) ? pass->frag->strokeThr : -1.0f;
+	int i, touched = 0;
+#ifdef NANOVG_SW_SSE2
+	__m128 scale = _mm_set1_ps(255.0f), one = _mm_set1_ps(1.0f), round = _mm_set1_ps(0.5f);
+	__m128i zero = _mm_setzero_si128();
+#endif
+
+	for (i = 0; i < n; i++, dst += 4) {
+		const float* src = &w->color[i*4];
+		if (pass->stencilFunc == SWNVG_EQUAL && stencil[i] != 0) continue;
+		if (pass->stencilFunc == SWNVG_NOTEQUAL && stencil[i] == 0) continue;
+		if (w->alpha[i] < thr) continue;
+		if (pass->stencilOp == SWNVG_INCR) {
+			if (stencil[i] < 255) stencil[i]++;
+			touched = 1;
+		}
+		if (w->cover[i] == 0.0f) continue;
+#ifdef NANOVG_SW_SSE2
+		{
+			int pixel;
+			__m128 s = _mm_loadu_ps(src);
+			__m128 d;
+			memcpy(&pixel, dst, 4);
+			d = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(pixel), zero), zero));
+			d = _mm_add_ps(_mm_mul_ps(s, scale), _mm_mul_ps(d, _mm_sub_ps(one, _mm_set1_ps(src[3]))));
+			d = _mm_min_ps(d, scale);
+			pixel = _mm_cvtsi128_si32(_mm_packus_epi16(_mm_packs_epi32(_mm_cvttps_epi32(_mm_add_ps(d, round)), zero), zero));
+			memcpy(dst, &pixel, 4);
+		}
+#else
+		{
+			float ia = 1.0f - src[3];
+			int k;
+			for (k = 0; k < 4; k++) {
+				float d = src[k]*255.0f + dst[k]*ia;
+				dst[k] = (unsigned char)(swnvg__clampf(d, 0.0f, 255.0f) + 0.5f);
+			}
+		}
+#endif
+	}
+
+	if (touched) {
+		w->stencilRows[0] = swnvg__mini(w->stencilRows[0], y);
+		w->stencilRows[1] = swnvg__maxi(w->stencilRows[1], y+1);
+	}
+}
+
+// Draws the pixels [x0,x1) of row y.
+static void swnvg__span(SWNVGworker* w, const SWNVGpass* pass, const float* uv, int y, int x0, int x1)
+{
+	unsigned char* stencil = &w->stencil[(y - w->y0)*SWNVG_TILE_SIZE + (x0 - w->x0)];
+	int n = x1 - x0;
+
+	// Skip the pixels at either end which fail the stencil test.
+	if (pass->stencilFunc != SWNVG_ALWAYS) {
+		int eq = pass->stencilFunc == SWNVG_EQUAL;
+		while (n > 0 && (stencil[0] == 0) != eq) {
+			stencil++;
+			x0++;
+			n--;
+		}
+		while (n > 0 && (stencil[n-1] == 0) != eq)
+			n--;
+		if (n == 0) return;
+	}
+
+	swnvg__coverage(w, pass->frag, uv, y, x0, n);
+	swnvg__paint(w, pass, uv, y, x0, n);
+	swnvg__blend(w, pass, stencil, y, x0, n);
+}
+
+// Winding numbers, wrapping like GL_INCR_WRAP and GL_DECR_WRAP.
+static void swnvg__windingSpan(SWNVGworker* w, int y, int x0, int x1, unsigned char delta)
+{
+	unsigned char* stencil = &w->stencil[(y - w->y0)*SWNVG_TILE_SIZE + (x0 - w->x0)];
+	int i, n = x1 - x0;
+	for (i = 0; i < n; i++)
+		stencil[i] = (unsigned char)(stencil[i] + delta);
+	w->stencilRows[0] = swnvg__mini(w->stencilRows[0], y);
+	w->stencilRows[1] = swnvg__maxi(w->stencilRows[1], y+1);
+}
+
+static void swnvg__triangle(SWNVGworker* w, const SWNVGpass* pass, const NVGvertex* v0, const NVGvertex* v1, const NVGvertex* v2)
+{
+	SWNVGcontext* sw = w->sw;
+	float x[3], y[3], uv[6];
+	float area, slopeLong, slopeTop, slopeBottom;
+	int top, mid, bot, tmp, y0, y1, py;
+	unsigned char delta = 0;
+
+	x[0] = v0->x * sw->scale[0]; y[0] = v0->y * sw->scale[1];
+	x[1] = v1->x * sw->scale[0]; y[1] = v1->y * sw->scale[1];
+	x[2] = v2->x * sw->scale[0]; y[2] = v2->y * sw->scale[1];
+
+	// Most triangles of a call miss the tile.
+	if (swnvg__maxf(y[0], swnvg__maxf(y[1], y[2])) < w->y0 || swnvg__minf(y[0], swnvg__minf(y[1], y[2])) > w->y1) return;
+	if (swnvg__maxf(x[0], swnvg__maxf(x[1], x[2])) < w->x0 || swnvg__minf(x[0], swnvg__minf(x[1], x[2])) > w->x1) return;
+
+	// Counter-clockwise in GL window coordinates is clockwise here, y points down.
+	area = (x[1]-x[0])*(y[2]-y[0]) - (y[1]-y[0])*(x[2]-x[0]);
+	if (!(area < 0.0f || area > 0.0f)) return;
+	if (pass->stencilOp == SWNVG_WINDING)
+		delta = area < 0.0f ? 1 : 255;
+	else if (area > 0.0f)
+		return; // Back face culling.
+
+	// Sort by y, then x, so triangles sharing an edge walk it the same way.
+	top = 0; mid = 1; bot = 2;
+	if (y[mid] < y[top] || (y[mid] == y[top] && x[mid] < x[top])) { tmp = top; top = mid; mid = tmp; }
+	if (y[bot] < y[mid] || (y[bot] == y[mid] && x[bot] < x[mid])) { tmp = mid; mid = bot; bot = tmp; }
+	if (y[mid] < y[top] || (y[mid] == y[top] && x[mid] < x[top])) { tmp = top; top = mid; mid = tmp; }
+
+	y0 = (int)ceilf(swnvg__clampf(y[top], (float)w->y0 - 1.0f, (float)w->y1 + 1.0f) - 0.5f);
+	y1 = (int)ceilf(swnvg__clampf(y[bot], (float)w->y0 - 1.0f, (float)w->y1 + 1.0f) - 0.5f);
+	y0 = swnvg__maxi(y0, w->y0);
+	y1 = swnvg__mini(y1, w->y1);
+	if (y0 >= y1) return;
+
+	if (delta == 0) {
+		// Texture coordinate planes over the framebuffer pixels.
+		float dx1 = x[1]-x[0], dy1 = y[1]-y[0], dx2 = x[2]-x[0], dy2 = y[2]-y[0];
+		float du1 = v1->u - v0->u, du2 = v2->u - v0->u;
+		float dv1 = v1->v - v0->v, dv2 = v2->v - v0->v;
+		float inv = 1.0f / area;
+		uv[1] = (du1*dy2 - du2*dy1) * inv;
+		uv[2] = (du2*dx1 - du1*dx2) * inv;
+		uv[0] = v0->u - uv[1]*x[0] - uv[2]*y[0];
+		uv[4] = (dv1*dy2 - dv2*dy1) * inv;
+		uv[5] = (dv2*dx1 - dv1*dx2) * inv;
+		uv[3] = v0->v - uv[4]*x[0] - uv[5]*y[0];
+	}
+
+	slopeLong = (x[bot]-x[top]) / (y[bot]-y[top]);
+	slopeTop = y[mid] > y[top] ? (x[mid]-x[top]) / (y[mid]-y[top]) : 0.0f;
+	slopeBottom = y[bot] > y[mid] ? (x[bot]-x[mid]) / (y[bot]-y[mid]) : 0.0f;
+
+	for (py = y0; py < y1; py++) {
+		float cy = py + 0.5f;
+		float xa = x[top] + (cy - y[top]) * slopeLong;
+		float xb = cy < y[mid] ? x[top] + (cy - y[top]) * slopeTop : x[mid] + (cy - y[mid]) * slopeBottom;
+		float xl = swnvg__clampf(swnvg__minf(xa, xb), (float)w->x0 - 1.0f, (float)w->x1 + 1.0f);
+		float xr = swnvg__clampf(swnvg__maxf(xa, xb), (float)w->x0 - 1.0f, (float)w->x1 + 1.0f);
+		int px0 = swnvg__maxi((int)ceilf(xl - 0.5f), w->x0);
+		int px1 = swnvg__mini((int)ceilf(xr - 0.5f), w->x1);
+		if (px0 >= px1) continue;
+		if (delta != 0)
+			swnvg__windingSpan(w, py, px0, px1, delta);
+		else
+			swnvg__span(w, pass, uv, py, px0, px1);
+	}
+}
+
+static void swnvg__triangleFan(SWNVGworker* w, const SWNVGpass* pass, const NVGvertex* verts, int nverts)
+{
+	int i;
+	for (i = 2; i < nverts; i++)
+		swnvg__triangle(w, pass, &verts[0], &verts[i-1], &verts[i]);
+}
+
+static void swnvg__triangleStrip(SWNVGworker* w, const SWNVGpass* pass, const NVGvertex* verts, int nverts)
+{
+	int i;
+	for (i = 2; i < nverts; i++) {
+		if (i & 1)
+			swnvg__triangle(w, pass, &verts[i-1], &verts[i-2], &verts[i]);
+		else
+			swnvg__triangle(w, pass, &verts[i-2], &verts[i-1], &verts[i]);
+	}
+}
+
+static void swnvg__clearStencil(SWNVGworker* w)
+{
+	if (w->stencilRows[0] < w->stencilRows[1])
+		memset(&w->stencil[(w->stencilRows[0] - w->y0)*SWNVG_TILE_SIZE], 0, (size_t)(w->stencilRows[1] - w->stencilRows[0])*SWNVG_TILE_SIZE);
+	w->stencilRows[0] = w->y1;
+	w->stencilRows[1] = w->y0;
+}
+
+static void swnvg__setPass(SWNVGpass* pass, const SWNVGfragUniforms* frag, const SWNVGtexture* tex, int stencilFunc, int stencilOp)
+{
+	pass->frag = frag;
+	pass->tex = tex;
+	pass->stencilFunc = stencilFunc;
+	pass->stencilOp = stencilOp;
+}
+
+static void swnvg__fill(SWNVGworker* w, SWNVGcall* call)
+{
+	SWNVGcontext* sw = w->sw;
+	SWNVGpath* paths = &sw->paths[call->pathOffset];
+	const SWNVGtexture* tex = swnvg__findTexture(sw, call->image);
+	const NVGvertex* quad = &sw->verts[call->triangleOffset];
+	SWNVGpass pass;
+	float uv[6] = { 0.5f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+	int i, npaths = call->pathCount;
+	int x0, y0, x1, y1, py;
+
+	// Winding numbers of the shapes.
+	swnvg__setPass(&pass, &sw->uniforms[call->uniformOffset], NULL, SWNVG_ALWAYS, SWNVG_WINDING);
+	for (i = 0; i < npaths; i++)
+		swnvg__triangleFan(w, &pass, &sw->verts[paths[i].fillOffset], paths[i].fillCount);
+
+	// Draw anti-aliased pixels.
+	if (sw->flags & NVG_ANTIALIAS) {
+		swnvg__setPass(&pass, &sw->uniforms[call->uniformOffset + 1], tex, SWNVG_EQUAL, SWNVG_KEEP);
+		for (i = 0; i < npaths; i++)
+			swnvg__triangleStrip(w, &pass, &sw->verts[paths[i].strokeOffset], paths[i].strokeCount);
+	}
+
+	// Draw fill, the bounds quad covers the pixels whose centers are inside the bounds.
+	swnvg__setPass(&pass, &sw->uniforms[call->uniformOffset + 1], tex, SWNVG_NOTEQUAL, SWNVG_KEEP);
+	x0 = swnvg__maxi((int)ceilf(swnvg__clampf(quad[0].x * sw->scale[0], (float)w->x0, (float)w->x1) - 0.5f), w->x0);
+	x1 = swnvg__mini((int)ceilf(swnvg__clampf(quad[1].x * sw->scale[0], (float)w->x0, (float)w->x1) - 0.5f), w->x1);
+	y0 = swnvg__maxi((int)ceilf(swnvg__clampf(quad[5].y * sw->scale[1], (float)w->y0, (float)w->y1) - 0.5f), w->y0);
+	y1 = swnvg__mini((int)ceilf(swnvg__clampf(quad[0].y * sw->scale[1], (float)w->y0, (float)w->y1) - 0.5f), w->y1);
+	y0 = swnvg__maxi(y0, w->stencilRows[0]);
+	y1 = swnvg__mini(y1, w->stencilRows[1]);
+	if (x0 < x1) {
+		for (py = y0; py < y1; py++)
+			swnvg__span(w, &pass, uv, py, x0, x1);
+	}
+
+	swnvg__clearStencil(w);
+}
+
+static void swnvg__convexFill(SWNVGworker* w, SWNVGcall* call)
+{
+	SWNVGcontext* sw = w->sw;
+	SWNVGpath* paths = &sw->paths[call->pathOffset];
+	SWNVGpass pass;
+	int i, npaths = call->pathCount;
+
+	swnvg__setPass(&pass, &sw->uniforms[call->uniformOffset], swnvg__findTexture(sw, call->image), SWNVG_ALWAYS, SWNVG_KEEP);
+	for (i = 0; i < npaths; i++)
+		swnvg__triangleFan(w, &pass, &sw->verts[paths[i].fillOffset], paths[i].fillCount);
+	if (sw->flags & NVG_ANTIALIAS) {
+		// Draw fringes
+		for (i = 0; i < npaths; i++)
+			swnvg__triangleStrip(w, &pass, &sw->verts[paths[i].strokeOffset], paths[i].strokeCount);
+	}
+}
+
+static void swnvg__stroke(SWNVGworker* w, SWNVGcall* call)
+{
+	SWNVGcontext* sw = w->sw;
+	SWNVGpath* paths = &sw->paths[call->pathOffset];
+	const SWNVGtexture* tex = swnvg__findTexture(sw, call->image);
+	SWNVGpass pass;
+	int npaths = call->pathCount, i;
+
+	if (sw->flags & NVG_STENCIL_STROKES) {
+		// Fill the stroke base without overlap
+		swnvg__setPass(&pass, &sw->uniforms[call->uniformOffset + 1], tex, SWNVG_EQUAL, SWNVG_INCR);
+		for (i = 0; i < npaths; i++)
+			swnvg__triangleStrip(w, &pass, &sw->verts[paths[i].strokeOffset], paths[i].strokeCount);
+
+		// Draw anti-aliased pixels.
+		swnvg__setPass(&pass, &sw->uniforms[call->uniformOffset], tex, SWNVG_EQUAL, SWNVG_KEEP);
+		for (i = 0; i < npaths; i++)
+			swnvg__triangleStrip(w, &pass, &sw->verts[paths[i].strokeOffset], paths[i].strokeCount);
+
+		swnvg__clearStencil(w);
+	} else {
+		swnvg__setPass(&pass, &sw->uniforms[call->uniformOffset], tex, SWNVG_ALWAYS, SWNVG_KEEP);
+		for (i = 0; i < npaths; i++)
+			swnvg__triangleStrip(w, &pass, &sw->verts[paths[i].strokeOffset], paths[i].strokeCount);
+	}
+}
+
+static void swnvg__triangles(SWNVGworker* w, SWNVGcall* call)
+{
+	SWNVGcontext* sw = w->sw;
+	const NVGvertex* verts = &sw->verts[call->triangleOffset];
+	SWNVGpass pass;
+	int i;
+
+	swnvg__setPass(&pass, &sw->uniforms[call->uniformOffset], swnvg__findTexture(sw, call->image), SWNVG_ALWAYS, SWNVG_KEEP);
+	for (i = 0; i+2 < call->triangleCount; i += 3)
+		swnvg__triangle(w, &pass, &verts[i], &verts[i+1], &verts[i+2]);
+}
+
+static void swnvg__renderTile(SWNVGworker* w, int tile)
+{
+	SWNVGcontext* sw = w->sw;
+	int i;
+
+	w->x0 = (tile % sw->tilesX) * SWNVG_TILE_SIZE;
+	w->y0 = (tile / sw->tilesX) * SWNVG_TILE_SIZE;
+	w->x1 = swnvg__mini(w->x0 + SWNVG_TILE_SIZE, sw->width);
+	w->y1 = swnvg__mini(w->y0 + SWNVG_TILE_SIZE, sw->height);
+	// The stencil is all zeros between calls.
+	w->stencilRows[0] = w->y1;
+	w->stencilRows[1] = w->y0;
+
+	for (i = sw->tileStart[tile]; i < sw->tileStart[tile+1]; i++) {
+		SWNVGcall* call = &sw->calls[sw->tileCalls[i]];
+		if (call->type == SWNVG_FILL)
+			swnvg__fill(w, call);
+		else if (call->type == SWNVG_CONVEXFILL)
+			swnvg__convexFill(w, call);
+		else if (call->type == SWNVG_STROKE)
+			swnvg__stroke(w, call);
+		else if (call->type == SWNVG_TRIANGLES)
+			swnvg__triangles(w, call);
+	}
+}
+
+// Renders tiles until there are none left, called by all threads.
+static void swnvg__renderTiles(SWNVGworker* w)
+{
+	SWNVGcontext* sw = w->sw;
+	int ntiles = sw->tilesX * sw->tilesY;
+	for (;;) {
+		int tile;
+		swnvg__mutexLock(sw);
+		tile = sw->nextTile < ntiles ? sw->nextTile++ : -1;
+		swnvg__mutexUnlock(sw);
+		if (tile < 0) break;
+		if (sw->tileStart[tile] < sw->tileStart[tile+1])
+			swnvg__renderTile(w, tile);
+	}
+}
+
+#ifdef _WIN32
+static DWORD WINAPI swnvg__workerMain(LPVOID arg)
+#else
+static void* swnvg__workerMain(void* arg)
+#endif
+{
+	SWNVGworker* w = (SWNVGworker*)arg;
+	SWNVGcontext* sw = w->sw;
+
+	swnvg__mutexLock(sw);
+	for (;;) {
+		while (w->generation == sw->generation && !sw->quit) {
+#ifdef _WIN32
+			SleepConditionVariableCS(&sw->start, &sw->lock, INFINITE);
+#else
+			pthread_cond_wait(&sw->start, &sw->lock);
+#endif
+		}
+		if (sw->quit) break;
+		w->generation = sw->generation;
+		swnvg__mutexUnlock(sw);
+
+		swnvg__renderTiles(w);
+
+		swnvg__mutexLock(sw);
+		if (--sw->busy == 0) {
+#ifdef _WIN32
+			WakeConditionVariable(&sw->done);
+#else
+			pthread_cond_signal(&sw->done);
+#endif
+		}
+	}
+	swnvg__mutexUnlock(sw);
+	return 0;
+}
+
+static int swnvg__cpuCount(void)
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (int)info.dwNumberOfProcessors;
+#else
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return n > 0 ? (int)n : 1;
+#endif
+}
+
+static int swnvg__renderCreate(void* uptr)
+{
+	SWNVGcontext* sw = (SWNVGcontext*)uptr;
+	int i;
+
+	if (sw->nthreads <= 0)
+		sw->nthreads = swnvg__cpuCount();
+	sw->nthreads = swnvg__clampi(sw->nthreads, 1, SWNVG_MAX_THREADS);
+
+	sw->workers = (SWNVGworker*)malloc(sizeof(SWNVGworker) * sw->nthreads);
+	if (sw->workers == NULL) {
+		sw->nthreads = 0;
+		return 0;
+	}
+	memset(sw->workers, 0, sizeof(SWNVGworker) * sw->nthreads);
+	for (i = 0; i < sw->nthreads; i++)
+		sw->workers[i].sw = sw;
+
+#ifdef _WIN32
+	InitializeCriticalSection(&sw->lock);
+	InitializeConditionVariable(&sw->start);
+	InitializeConditionVariable(&sw->done);
+#else
+	pthread_mutex_init(&sw->lock, NULL);
+	pthread_cond_init(&sw->start, NULL);
+	pthread_cond_init(&sw->done, NULL);
+#endif
+
+	for (i = 1; i < sw->nthreads; i++) {
+#ifdef _WIN32
+		sw->workers[i].thread = CreateThread(NULL, 0, swnvg__workerMain, &sw->workers[i], 0, NULL);
+		if (sw->workers[i].thread == NULL) break;
+#else
+		if (pthread_create(&sw->workers[i].thread, NULL, swnvg__workerMain, &sw->workers[i]) != 0) break;
+#endif
+	}
+	// Render with the threads that could be started.
+	sw->nthreads = i;
+
+	return 1;
+}
+
+static int swnvg__renderCreateTexture(void* uptr, int type, int w, int h, int imageFlags, const unsigned char* data)
+{
+	SWNVGcontext* sw = (SWNVGcontext*)uptr;
+	SWNVGtexture* tex = swnvg__allocTexture(sw);
+	size_t size = (size_t)w * h * (type == NVG_TEXTURE_RGBA ? 4 : 1);
+
+	if (tex == NULL) return 0;
+
+	tex->data = (unsigned char*)malloc(size);
+	if (tex->data == NULL) {
+		swnvg__deleteTexture(sw, tex->id);
+		return 0;
+	}
+	if (data != NULL)
+		memcpy(tex->data, data, size);
+	else
+		memset(tex->data, 0, size);
+	tex->width = w;
+	tex->height = h;
+	tex->type = type;
+	tex->flags = imageFlags;
+
+	return tex->id;
+}
+
+static int swnvg__renderDeleteTexture(void* uptr, int image)
+{
+	SWNVGcontext* sw = (SWNVGcontext*)uptr;
+	return swnvg__deleteTexture(sw, image);
+}
+
+static int swnvg__renderUpdateTexture(void* uptr, int image, int x, int y, int w, int h, const unsigned char* data)
+{
+	SWNVGcontext* sw = (SWNVGcontext*)uptr;
+	SWNVGtexture* tex = swnvg__findTexture(sw, image);
+	int bpp, row;
+
+	if (tex == NULL) return 0;
+
+	// Like GL_UNPACK_ROW_LENGTH = width, 'data' is the whole image and only the rectangle is copied.
+	bpp = tex->type == NVG_TEXTURE_RGBA ? 4 : 1;
+	for (row = y; row < y + h; row++) {
+		size_t offset = ((size_t)row * tex->width + x) * bpp;
+		memcpy(&tex->data[offset], &data[offset], (size_t)w * bpp);
+	}
+
+	return 1;
+}
+
+static int swnvg__renderGetTextureSize(void* uptr, int image, int* w, int* h)
+{
+	SWNVGcontext* sw = (SWNVGcontext*)uptr;
+	SWNVGtexture* tex = swnvg__findTexture(sw, image);
+	if (tex == NULL) return 0;
+	*w = tex->width;
+	*h = tex->height;
+	return 1;
+}
+
+static NVGcolor swnvg__premulColor(NVGcolor c)
+{
+	c.r *= c.a;
+	c.g *= c.a;
+	c.b *= c.a;
+	return c;
+}
+
+static int swnvg__convertPaint(SWNVGcontext* sw, SWNVGfragUniforms* frag, NVGpaint* paint,
+							   NVGscissor* scissor, float width, float fringe, float strokeThr)
+{
+	SWNVGtexture* tex = NULL;
+
+	memset(frag, 0, sizeof(*frag));
+
+	frag->innerCol = swnvg__premulColor(paint->innerColor);
+	frag->outerCol = swnvg__premulColor(paint->outerColor);
+
+	if (scissor->extent[0] < -0.5f || scissor->extent[1] < -0.5f) {
+		frag->scissorExt[0] = 1.0f;
+		frag->scissorExt[1] = 1.0f;
+		frag->scissorScale[0] = 1.0f;
+		frag->scissorScale[1] = 1.0f;
+	} else {
+		nvgTransformInverse(frag->scissorMat, scissor->xform);
+		frag->scissorExt[0] = scissor->extent[0];
+		frag->scissorExt[1] = scissor->extent[1];
+		frag->scissorScale[0] = sqrtf(scissor->xform[0]*scissor->xform[0] + scissor->xform[2]*scissor->xform[2]) / fringe;
+		frag->scissorScale[1] = sqrtf(scissor->xform[1]*scissor->xform[1] + scissor->xform[3]*scissor->xform[3]) / fringe;
+		frag->scissor = 1;
+	}
+
+	memcpy(frag->extent, paint->extent, sizeof(frag->extent));
+	frag->strokeMult = (width*0.5f + fringe*0.5f) / fringe;
+	frag->strokeThr = strokeThr;
+
+	if (paint->image != 0) {
+		tex = swnvg__findTexture(sw, paint->image);
+		if (tex == NULL) return 0;
+		if ((tex->flags & NVG_IMAGE_FLIPY) != 0) {
+			float flipped[6];
+			nvgTransformScale(flipped, 1.0f, -1.0f);
+			nvgTransformMultiply(flipped, paint->xform);
+			nvgTransformInverse(frag->paintMat, flipped);
+		} else {
+			nvgTransformInverse(frag->paintMat, paint->xform);
+		}
+		frag->type = SWNVG_SHADER_FILLIMG;
+
+		if (tex->type == NVG_TEXTURE_RGBA)
+			frag->texType = (tex->flags & NVG_IMAGE_PREMULTIPLIED) ? 0 : 1;
+		else
+			frag->texType = 2;
+	} else {
+		frag->type = SWNVG_SHADER_FILLGRAD;
+		frag->radius = paint->radius;
+		frag->feather = paint->feather;
+		frag->solid = memcmp(&frag->innerCol, &frag->outerCol, sizeof(NVGcolor)) == 0;
+		nvgTransformInverse(frag->paintMat, paint->xform);
+	}
+
+	return 1;
+}
+
+// Window space bounds outside of which the scissor mask is zero.
+static void swnvg__scissorBounds(float* bounds, NVGscissor* scissor, float fringe)
+{
+	float ex, ey, dx, dy;
+	if (scissor->extent[0] < -0.5f || scissor->extent[1] < -0.5f) {
+		bounds[0] = bounds[1] = -1e30f;
+		bounds[2] = bounds[3] = 1e30f;
+		return;
+	}
+	ex = scissor->extent[0];
+	ey = scissor->extent[1];
+	dx = fabsf(scissor->xform[0]*ex) + fabsf(scissor->xform[2]*ey) + fringe;
+	dy = fabsf(scissor->xform[1]*ex) + fabsf(scissor->xform[3]*ey) + fringe;
+	bounds[0] = scissor->xform[4] - dx;
+	bounds[1] = scissor->xform[5] - dy;
+	bounds[2] = scissor->xform[4] + dx;
+	bounds[3] = scissor->xform[5] + dy;
+}
+
+static void swnvg__renderViewport(void* uptr, int width, int height)
+{
+	SWNVGcontext* sw = (SWNVGcontext*)uptr;
+	sw->view[0] = (float)width;
+	sw->view[1] = (float)height;
+}
+
+static void swnvg__renderCancel(void* uptr) {
+	SWNVGcontext* sw = (SWNVGcontext*)uptr;
+	sw->nverts = 0;
+	sw->npaths = 0;
+	sw->ncalls = 0;
+	sw->nuniforms = 0;
+}
+
+static void swnvg__expandBounds(float* b, const NVGvertex* verts, int nverts)
+{
+	int i;
+	for (i = 0; i < nverts; i++) {
+		b[0] = swnvg__minf(b[0], verts[i].x);
+		b[1] = swnvg__minf(b[1], verts[i].y);
+		b[2] = swnvg__maxf(b[2], verts[i].x);
+		b[3] = swnvg__maxf(b[3], verts[i].y);
+	}
+}
+
+// Pixel bounds of a call, empty when the call is outside of the framebuffer or scissor.
+static void swnvg__callBounds(SWNVGcontext* sw, SWNVGcall* call)
+{
+	float b[4] = { 1e30f, 1e30f, -1e30f, -1e30f };
+	int i;
+
+	for (i = 0; i < call->pathCount; i++) {
+		SWNVGpath* path = &sw->paths[call->pathOffset + i];
+		swnvg__expandBounds(b, &sw->verts[path->fillOffset], path->fillCount);
+		swnvg__expandBounds(b, &sw->verts[path->strokeOffset], path->strokeCount);
+	}
+	swnvg__expandBounds(b, &sw->verts[call->triangleOffset], call->triangleCount);
+
+	b[0] = swnvg__maxf(b[0], call->scissorBounds[0]);
+	b[1] = swnvg__maxf(b[1], call->scissorBounds[1]);
+	b[2] = swnvg__minf(b[2], call->scissorBounds[2]);
+	b[3] = swnvg__minf(b[3], call->scissorBounds[3]);
+
+	call->bounds[0] = (int)floorf(swnvg__clampf(b[0] * sw->scale[0], 0.0f, (float)sw->width)) - 1;
+	call->bounds[1] = (int)floorf(swnvg__clampf(b[1] * sw->scale[1], 0.0f, (float)sw->height)) - 1;
+	call->bounds[2] = (int)ceilf(swnvg__clampf(b[2] * sw->scale[0], 0.0f, (float)sw->width)) + 1;
+	call->bounds[3] = (int)ceilf(swnvg__clampf(b[3] * sw->scale[1], 0.0f, (float)sw->height)) + 1;
+	call->bounds[0] = swnvg__maxi(call->bounds[0], 0);
+	call->bounds[1] = swnvg__maxi(call->bounds[1], 0);
+	call->bounds[2] = swnvg__mini(call->bounds[2], sw->width);
+	call->bounds[3] = swnvg__mini(call->bounds[3], sw->height);
+	if (b[0] > b[2] || b[1] > b[3]) {
+		call->bounds[2] = call->bounds[0];
+		call->bounds[3] = call->bounds[1];
+	}
+}
+
+// Sorts the calls into the tiles they overlap, keeping the call order within each tile.
+static int swnvg__binCalls(SWNVGcontext* sw)
+{
+	int ntiles, i, tx, ty, total = 0;
+
+	sw->tilesX = (sw->width + SWNVG_TILE_SIZE-1) / SWNVG_TILE_SIZE;
+	sw->tilesY = (sw->height + SWNVG_TILE_SIZE-1) / SWNVG_TILE_SIZE;
+	ntiles = sw->tilesX * sw->tilesY;
+
+	if (ntiles+1 > sw->ctileStart) {
+		int* tileStart;
+		int ctileStart = ntiles+1;
+		tileStart = (int*)realloc(sw->tileStart, sizeof(int) * ctileStart);
+		if (tileStart == NULL) return 0;
+		sw->tileStart = tileStart;
+		sw->ctileStart = ctileStart;
+	}
+	memset(sw->tileStart, 0, sizeof(int) * (ntiles+1));
+
+	for (i = 0; i < sw->ncalls; i++) {
+		SWNVGcall* call = &sw->calls[i];
+		swnvg__callBounds(sw, call);
+		if (call->bounds[0] >= call->bounds[2] || call->bounds[1] >= call->bounds[3]) continue;
+		for (ty = call->bounds[1] / SWNVG_TILE_SIZE; ty <= (call->bounds[3]-1) / SWNVG_TILE_SIZE; ty++)
+			for (tx = call->bounds[0] / SWNVG_TILE_SIZE; tx <= (call->bounds[2]-1) / SWNVG_TILE_SIZE; tx++)
+				sw->tileStart[ty*sw->tilesX + tx + 1]++;
+	}
+	for (i = 0; i < ntiles; i++)
+		sw->tileStart[i+1] += sw->tileStart[i];
+	total = sw->tileStart[ntiles];
+
+	if (total > sw->ctileCalls) {
+		int* tileCalls;
+		int ctileCalls = swnvg__maxi(total, 1024) + sw->ctileCalls/2; // 1.5x Overallocate
+		tileCalls = (int*)realloc(sw->tileCalls, sizeof(int) * ctileCalls);
+		if (tileCalls == NULL) return 0;
+		sw->tileCalls = tileCalls;
+		sw->ctileCalls = ctileCalls;
+	}
+
+	// Fill in the bins, tileStart[i] is advanced to the end of bin i and shifted back afterwards.
+	for (i = 0; i < sw->ncalls; i++) {
+		SWNVGcall* call = &sw->calls[i];
+		if (call->bounds[0] >= call->bounds[2] || call->bounds[1] >= call->bounds[3]) continue;
+		for (ty = call->bounds[1] / SWNVG_TILE_SIZE; ty <= (call->bounds[3]-1) / SWNVG_TILE_SIZE; ty++)
+			for (tx = call->bounds[0] / SWNVG_TILE_SIZE; tx <= (call->bounds[2]-1) / SWNVG_TILE_SIZE; tx++)
+				sw->tileCalls[sw->tileStart[ty*sw->tilesX + tx]++] = i;
+	}
+	for (i = ntiles; i > 0; i--)
+		sw->tileStart[i] = sw->tileStart[i-1];
+	sw->tileStart[0] = 0;
+
+	return 1;
+}
+
+static void swnvg__renderFlush(void* uptr)
+{
+	SWNVGcontext* sw = (SWNVGcontext*)uptr;
+
+	if (sw->ncalls > 0 && sw->pixels != NULL && sw->width > 0 && sw->height > 0) {
+
+		sw->scale[0] = sw->view[0] > 0.0f ? sw->width / sw->view[0] : 1.0f;
+		sw->scale[1] = sw->view[1] > 0.0f ? sw->height / sw->view[1] : 1.0f;
+		sw->invScale[0] = 1.0f / sw->scale[0];
+		sw->invScale[1] = 1.0f / sw->scale[1];
+
+		if (swnvg__binCalls(sw)) {
+			// Tiles are independent, every tile draws its calls in order on one thread.
+			swnvg__mutexLock(sw);
+			sw->nextTile = 0;
+			sw->busy = sw->nthreads - 1;
+			sw->generation++;
+			if (sw->busy > 0) {
+#ifdef _WIN32
+				WakeAllConditionVariable(&sw->start);
+#else
+				pthread_cond_broadcast(&sw->start);
+#endif
+			}
+			swnvg__mutexUnlock(sw);
+
+			swnvg__renderTiles(&sw->workers[0]);
+
+			swnvg__mutexLock(sw);
+			while (sw->busy > 0) {
+#ifdef _WIN32
+				SleepConditionVariableCS(&sw->done, &sw->lock, INFINITE);
+#else
+				pthread_cond_wait(&sw->done, &sw->lock);
+#endif
+			}
+			swnvg__mutexUnlock(sw);
+		}
+	}
+
+	// Reset calls
+	sw->nverts = 0;
+	sw->npaths = 0;
+	sw->ncalls = 0;
+	sw->nuniforms = 0;
+}
+
+static int swnvg__maxVertCount(const NVGpath* paths, int npaths)
+{
+	int i, count = 0;
+	for (i = 0; i < npaths; i++) {
+		count += paths[i].nfill;
+		count += paths[i].nstroke;
+	}
+	return count;
+}
+
+static SWNVGcall* swnvg__allocCall(SWNVGcontext* sw)
+{
+	SWNVGcall* ret = NULL;
+	if (sw->ncalls+1 > sw->ccalls) {
+		SWNVGcall* calls;
+		int ccalls = swnvg__maxi(sw->ncalls+1, 128) + sw->ccalls/2; // 1.5x Overallocate
+		calls = (SWNVGcall*)realloc(sw->calls, sizeof(SWNVGcall) * ccalls);
+		if (calls == NULL) return NULL;
+		sw->calls = calls;
+		sw->ccalls = ccalls;
+	}
+	ret = &sw->calls[sw->ncalls++];
+	memset(ret, 0, sizeof(SWNVGcall));
+	return ret;
+}
+
+static int swnvg__allocPaths(SWNVGcontext* sw, int n)
+{
+	int ret = 0;
+	if (sw->npaths+n > sw->cpaths) {
+		SWNVGpath* paths;
+		int cpaths = swnvg__maxi(sw->npaths + n, 128) + sw->cpaths/2; // 1.5x Overallocate
+		paths = (SWNVGpath*)realloc(sw->paths, sizeof(SWNVGpath) * cpaths);
+		if (paths == NULL) return -1;
+		sw->paths = paths;
+		sw->cpaths = cpaths;
+	}
+	ret = sw->npaths;
+	sw->npaths += n;
+	return ret;
+}
+
+static int swnvg__allocVerts(SWNVGcontext* sw, int n)
+{
+	int ret = 0;
+	if (sw->nverts+n > sw->cverts) {
+		NVGvertex* verts;
+		int cverts = swnvg__maxi(sw->nverts + n, 4096) + sw->cverts/2; // 1.5x Overallocate
+		verts = (NVGvertex*)realloc(sw->verts, sizeof(NVGvertex) * cverts);
+		if (verts == NULL) return -1;
+		sw->verts = verts;
+		sw->cverts = cverts;
+	}
+	ret = sw->nverts;
+	sw->nverts += n;
+	return ret;
+}
+
+static int swnvg__allocFragUniforms(SWNVGcontext* sw, int n)
+{
+	int ret = 0;
+	if (sw->nuniforms+n > sw->cuniforms) {
+		SWNVGfragUniforms* uniforms;
+		int cuniforms = swnvg__maxi(sw->nuniforms+n, 128) + sw->cuniforms/2; // 1.5x Overallocate
+		uniforms = (SWNVGfragUniforms*)realloc(sw->uniforms, sizeof(SWNVGfragUniforms) * cuniforms);
+		if (uniforms == NULL) return -1;
+		sw->uniforms = uniforms;
+		sw->cuniforms = cuniforms;
+	}
+	ret = sw->nuniforms;
+	sw->nuniforms += n;
+	return ret;
+}
+
+static void swnvg__vset(NVGvertex* vtx, float x, float y, float u, float v)
+{
+	vtx->x = x;
+	vtx->y = y;
+	vtx->u = u;
+	vtx->v = v;
+}
+
+static void swnvg__renderFill(void* uptr, NVGpaint* paint, NVGscissor* scissor, float fringe,
+							  const float* bounds, const NVGpath* paths, int npaths)
+{
+	SWNVGcontext* sw = (SWNVGcontext*)uptr;
+	SWNVGcall* call = swnvg__allocCall(sw);
+	NVGvertex* quad;
+	SWNVGfragUniforms* frag;
+	int i, maxverts, offset;
+
+	if (call == NULL) return;
+
+	call->type = SWNVG_FILL;
+	call->pathOffset = swnvg__allocPaths(sw, npaths);
+	if (call->pathOffset == -1) goto error;
+	call->pathCount = npaths;
+	call->image = paint->image;
+	swnvg__scissorBounds(call->scissorBounds, scissor, fringe);
+
+	if (npaths == 1 && paths[0].convex)
+		call->type = SWNVG_CONVEXFILL;
+
+	// Allocate vertices for all the paths.
+	maxverts = swnvg__maxVertCount(paths, npaths) + 6;
+	offset = swnvg__allocVerts(sw, maxverts);
+	if (offset == -1) goto error;
+
+	for (i = 0; i < npaths; i++) {
+		SWNVGpath* copy = &sw->paths[call->pathOffset + i];
+		const NVGpath* path = &paths[i];
+		memset(copy, 0, sizeof(SWNVGpath));
+		if (path->nfill > 0) {
+			copy->fillOffset = offset;
+			copy->fillCount = path->nfill;
+			memcpy(&sw->verts[offset], path->fill, sizeof(NVGvertex) * path->nfill);
+			offset += path->nfill;
+		}
+		if (path->nstroke > 0) {
+			copy->strokeOffset = offset;
+			copy->strokeCount = path->nstroke;
+			memcpy(&sw->verts[offset], path->stroke, sizeof(NVGvertex) * path->nstroke);
+			offset += path->nstroke;
+		}
+	}
+
+	// Quad
+	call->triangleOffset = offset;
+	call->triangleCount = 6;
+	quad = &sw->verts[call->triangleOffset];
+	swnvg__vset(&quad[0], bounds[0], bounds[3], 0.5f, 1.0f);
+	swnvg__vset(&quad[1], bounds[2], bounds[3], 0.5f, 1.0f);
+	swnvg__vset(&quad[2], bounds[2], bounds[1], 0.5f, 1.0f);
+
+	swnvg__vset(&quad[3], bounds[0], bounds[3], 0.5f, 1.0f);
+	swnvg__vset(&quad[4], bounds[2], bounds[1], 0.5f, 1.0f);
+	swnvg__vset(&quad[5], bounds[0], bounds[1], 0.5f, 1.0f);
+
+	// Setup uniforms for draw calls
+	if (call->type == SWNVG_FILL) {
+		call->uniformOffset = swnvg__allocFragUniforms(sw, 2);
+		if (call->uniformOffset == -1) goto error;
+		// Simple shader for stencil
+		frag = &sw->uniforms[call->uniformOffset];
+		memset(frag, 0, sizeof(*frag));
+		frag->strokeThr = -1.0f;
+		frag->type = SWNVG_SHADER_SIMPLE;
+		// Fill shader
+		swnvg__convertPaint(sw, &sw->uniforms[call->uniformOffset + 1], paint, scissor, fringe, fringe, -1.0f);
+	} else {
+		call->uniformOffset = swnvg__allocFragUniforms(sw, 1);
+		if (call->uniformOffset == -1) goto error;
+		// Fill shader
+		swnvg__convertPaint(sw, &sw->uniforms[call->uniformOffset], paint, scissor, fringe, fringe, -1.0f);
+	}
+
+	return;
+
+error:
+	// We get here if call alloc was ok, but something else is not.
+	// Roll back the last call to prevent drawing it.
+	if (sw->ncalls > 0) sw->ncalls--;
+}
+
+static void swnvg__renderStroke(void* uptr, NVGpaint* paint, NVGscissor* scissor, float fringe,
+								float strokeWidth, const NVGpath* paths, int npaths)
+{
+	SWNVGcontext* sw = (SWNVGcontext*)uptr;
+	SWNVGcall* call = swnvg__allocCall(sw);
+	int i, maxverts, offset;
+
+	if (call == NULL) return;
+
+	call->type = SWNVG_STROKE;
+	call->pathOffset = swnvg__allocPaths(sw, npaths);
+	if (call->pathOffset == -1) goto error;
+	call->pathCount = npaths;
+	call->image = paint->image;
+	swnvg__scissorBounds(call->scissorBounds, scissor, fringe);
+
+	// Allocate vertices for all the paths.
+	maxverts = swnvg__maxVertCount(paths, npaths);
+	offset = swnvg__allocVerts(sw, maxverts);
+	if (offset == -1) goto error;
+
+	for (i = 0; i < npaths; i++) {
+		SWNVGpath* copy = &sw->paths[call->pathOffset + i];
+		const NVGpath* path = &paths[i];
+		memset(copy, 0, sizeof(SWNVGpath));
+		if (path->nstroke) {
+			copy->strokeOffset = offset;
+			copy->strokeCount = path->nstroke;
+			memcpy(&sw->verts[offset], path->stroke, sizeof(NVGvertex) * path->nstroke);
+			offset += path->nstroke;
+		}
+	}
+
+	if (sw->flags & NVG_STENCIL_STROKES) {
+		// Fill shader
+		call->uniformOffset = swnvg__allocFragUniforms(sw, 2);
+		if (call->uniformOffset == -1) goto error;
+
+		swnvg__convertPaint(sw, &sw->uniforms[call->uniformOffset], paint, scissor, strokeWidth, fringe, -1.0f);
+		swnvg__convertPaint(sw, &sw->uniforms[call->uniformOffset + 1], paint, scissor, strokeWidth, fringe, 1.0f - 0.5f/255.0f);
+
+	} else {
+		// Fill shader
+		call->uniformOffset = swnvg__allocFragUniforms(sw, 1);
+		if (call->uniformOffset == -1) goto error;
+		swnvg__convertPaint(sw, &sw->uniforms[call->uniformOffset], paint, scissor, strokeWidth, fringe, -1.0f);
+	}
+
+	return;
+
+error:
+	// We get here if call alloc was ok, but something else is not.
+	// Roll back the last call to prevent drawing it.
+	if (sw->ncalls > 0) sw->ncalls--;
+}
+
+static void swnvg__renderTriangles(void* uptr, NVGpaint* paint, NVGscissor* scissor,
+								   const NVGvertex* verts, int nverts)
+{
+	SWNVGcontext* sw = (SWNVGcontext*)uptr;
+	SWNVGcall* call = swnvg__allocCall(sw);
+	SWNVGfragUniforms* frag;
+
+	if (call == NULL) return;
+
+	call->type = SWNVG_TRIANGLES;
+	call->image = paint->image;
+	swnvg__scissorBounds(call->scissorBounds, scissor, 1.0f);
+
+	// Allocate vertices for all the paths.
+	call->triangleOffset = swnvg__allocVerts(sw, nverts);
+	if (call->triangleOffset == -1) goto error;
+	call->triangleCount = nverts;
+
+	memcpy(&sw->verts[call->triangleOffset], verts, sizeof(NVGvertex) * nverts);
+
+	// Fill shader
+	call->uniformOffset = swnvg__allocFragUniforms(sw, 1);
+	if (call->uniformOffset == -1) goto error;
+	frag = &sw->uniforms[call->uniformOffset];
+	swnvg__convertPaint(sw, frag, paint, scissor, 1.0f, 1.0f, -1.0f);
+	frag->type = SWNVG_SHADER_IMG;
+
+	return;
+
+error:
+	// We get here if call alloc was ok, but something else is not.
+	// Roll back the last call to prevent drawing it.
+	if (sw->ncalls > 0) sw->ncalls--;
+}
+
+static void swnvg__renderDelete(void* uptr)
+{
+	SWNVGcontext* sw = (SWNVGcontext*)uptr;
+	int i;
+	if (sw == NULL) return;
+
+	if (sw->workers != NULL) {
+		swnvg__mutexLock(sw);
+		sw->quit = 1;
+#ifdef _WIN32
+		WakeAllConditionVariable(&sw->start);
+#else
+		pthread_cond_broadcast(&sw->start);
+#endif
+		swnvg__mutexUnlock(sw);
+		for (i = 1; i < sw->nthreads; i++) {
+#ifdef _WIN32
+			WaitForSingleObject(sw->workers[i].thread, INFINITE);
+			CloseHandle(sw->workers[i].thread);
+#else
+			pthread_join(sw->workers[i].thread, NULL);
+#endif
+		}
+#ifdef _WIN32
+		DeleteCriticalSection(&sw->lock);
+#else
+		pthread_cond_destroy(&sw->start);
+		pthread_cond_destroy(&sw->done);
+		pthread_mutex_destroy(&sw->lock);
+#endif
+		free(sw->workers);
+	}
+
+	for (i = 0; i < sw->ntextures; i++)
+		free(sw->textures[i].data);
+	free(sw->textures);
+
+	free(sw->paths);
+	free(sw->verts);
+	free(sw->uniforms);
+	free(sw->calls);
+	free(sw->tileStart);
+	free(sw->tileCalls);
+
+	free(sw);
+}
+
+
+NVGcontext* nvgCreateSW(int flags, int nthreads)
+{
+	NVGparams params;
+	NVGcontext* ctx = NULL;
+	SWNVGcontext* sw = (SWNVGcontext*)malloc(sizeof(SWNVGcontext));
+	if (sw == NULL) goto error;
+	memset(sw, 0, sizeof(SWNVGcontext));
+
+	memset(&params, 0, sizeof(params));
+	params.renderCreate = swnvg__renderCreate;
+	params.renderCreateTexture = swnvg__renderCreateTexture;
+	params.renderDeleteTexture = swnvg__renderDeleteTexture;
+	params.renderUpdateTexture = swnvg__renderUpdateTexture;
+	params.renderGetTextureSize = swnvg__renderGetTextureSize;
+	params.renderViewport = swnvg__renderViewport;
+	params.renderCancel = swnvg__renderCancel;
+	params.renderFlush = swnvg__renderFlush;
+	params.renderFill = swnvg__renderFill;
+	params.renderStroke = swnvg__renderStroke;
+	params.renderTriangles = swnvg__renderTriangles;
+	params.renderDelete = swnvg__renderDelete;
+	params.userPtr = sw;
+	params.edgeAntiAlias = flags & NVG_ANTIALIAS ? 1 : 0;
+
+	sw->flags = flags;
+	sw->nthreads = nthreads;
+
+	ctx = nvgCreateInternal(&params);
+	if (ctx == NULL) goto error;
+
+	return ctx;
+
+error:
+	// 'sw' is freed by nvgDeleteInternal.
+	if (ctx != NULL) nvgDeleteInternal(ctx);
+	return NULL;
+}
+
+void nvgDeleteSW(NVGcontext* ctx)
+{
+	nvgDeleteInternal(ctx);
+}
+
+void nvgswSetFramebuffer(NVGcontext* ctx, unsigned char* pixels, int w, int h, int stride)
+{
+	SWNVGcontext* sw = (SWNVGcontext*)nvgInternalParams(ctx)->userPtr;
+	sw->pixels = pixels;
+	sw->width = w;
+	sw->height = h;
+	sw->stride = stride;
+}
+
+#endif /* NANOVG_SW_IMPLEMENTATION */
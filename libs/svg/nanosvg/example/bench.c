@@ -0,0 +1,130 @@
+//
+// Copyright (c) 2013 Mikko Mononen memon@inside.org
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+// Rasterizes the example SVGs at a few scales with the default supersampling rasterizer,
+// the analytic rasterizer on one thread and on all CPUs. Prints the time per image, the
+// mean difference of the analytic pixels to the supersampled ones and checks that the
+// single and multithreaded analytic images are the same.
+//   bench [iterations]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#define NANOSVG_IMPLEMENTATION
+#include "nanosvg.h"
+#define NANOSVGRAST_IMPLEMENTATION
+#define NANOSVGRAST_THREADS
+#include "nanosvgrast.h"
+
+#ifdef _WIN32
+#include <windows.h>
+static double getTime()
+{
+	LARGE_INTEGER freq, t;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&t);
+	return (double)t.QuadPart / (double)freq.QuadPart;
+}
+#else
+static double getTime()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+#endif
+
+static double rasterizeTime(NSVGrasterizer* rast, NSVGimage* image, float scale, unsigned char* img, int w, int h, int iterations)
+{
+	double t0;
+	int i;
+	nsvgRasterize(rast, image, 0,0,scale, img, w, h, w*4);
+	t0 = getTime();
+	for (i = 0; i < iterations; i++)
+		nsvgRasterize(rast, image, 0,0,scale, img, w, h, w*4);
+	return (getTime() - t0) / iterations;
+}
+
+static double meanDifference(const unsigned char* a, const unsigned char* b, int n)
+{
+	double sum = 0;
+	int i;
+	for (i = 0; i < n; i++)
+		sum += abs((int)a[i] - (int)b[i]);
+	return sum / n;
+}
+
+int main(int argc, char** argv)
+{
+	const char* files[] = { "../example/23.svg", "../example/drawing.svg", "../example/nano.svg" };
+	const float scales[] = { 1.0f, 2.0f, 4.0f };
+	int iterations = argc > 1 ? atoi(argv[1]) : 5;
+	NSVGrasterizer* supersampled = nsvgCreateRasterizer();
+	NSVGrasterizer* serial = nsvgCreateRasterizerEx(NSVG_RAST_ANALYTIC, 1);
+	NSVGrasterizer* parallel = nsvgCreateRasterizerEx(NSVG_RAST_ANALYTIC, 0);
+	int i, j, ok = 1;
+
+	if (supersampled == NULL || serial == NULL || parallel == NULL) {
+		printf("Could not init rasterizer.\n");
+		return 1;
+	}
+	if (iterations < 1) iterations = 1;
+
+	printf("%-24s %6s %11s %11s %11s %8s %6s\n", "image", "scale", "supersample", "analytic", "threaded", "speedup", "diff");
+	for (i = 0; i < (int)(sizeof(files)/sizeof(files[0])); i++) {
+		NSVGimage* image = nsvgParseFromFile(files[i], "px", 96.0f);
+		if (image == NULL) {
+			printf("Could not open %s.\n", files[i]);
+			ok = 0;
+			continue;
+		}
+		for (j = 0; j < (int)(sizeof(scales)/sizeof(scales[0])); j++) {
+			int w = (int)(image->width * scales[j]);
+			int h = (int)(image->height * scales[j]);
+			unsigned char* a = (unsigned char*)malloc(w*h*4);
+			unsigned char* b = (unsigned char*)malloc(w*h*4);
+			unsigned char* c = (unsigned char*)malloc(w*h*4);
+			double ts, ta, tp;
+			if (a == NULL || b == NULL || c == NULL) {
+				printf("Could not alloc image buffer.\n");
+				return 1;
+			}
+			ts = rasterizeTime(supersampled, image, scales[j], a, w, h, iterations);
+			ta = rasterizeTime(serial, image, scales[j], b, w, h, iterations);
+			tp = rasterizeTime(parallel, image, scales[j], c, w, h, iterations);
+			printf("%-24s %6.1f %8.2f ms %8.2f ms %8.2f ms %7.2fx %6.3f\n", files[i], scales[j],
+				   ts*1000.0, ta*1000.0, tp*1000.0, ts / (tp < ta ? tp : ta), meanDifference(a, b, w*h*4));
+			if (memcmp(b, c, w*h*4) != 0) {
+				printf("  single and multithreaded images differ!\n");
+				ok = 0;
+			}
+			free(a);
+			free(b);
+			free(c);
+		}
+		nsvgDelete(image);
+	}
+
+	nsvgDeleteRasterizer(supersampled);
+	nsvgDeleteRasterizer(serial);
+	nsvgDeleteRasterizer(parallel);
+	printf(ok ? "ok\n" : "FAILED\n");
+	return ok ? 0 : 1;
+}
@@ -54,3 +54,21 @@ solution "nanosvg"
 		configuration "Release"
 			defines { "NDEBUG" }
 			flags { "Optimize", "ExtraWarnings"}    
+
+	project "bench"
+		kind "ConsoleApp"
+		language "C++"
+		files { "example/bench.c", "src/*.h" }
+		includedirs { "example", "src" }
+		targetdir("build")
+
+		configuration { "linux" }
+			 links { "rt", "pthread" }
+
+		configuration "Debug"
+			defines { "DEBUG" }
+			flags { "Symbols", "ExtraWarnings"}
+
+		configuration "Release"
+			defines { "NDEBUG" }
+			flags { "Optimize", "ExtraWarnings"}
@@ -149,14 +149,27 @@ typedef struct NSVGimage
 	float width;				// Width of the image.
 	float height;				// Height of the image.
 	NSVGshape* shapes;			// Linked list of shapes in the image.
+	void* storage;				// Memory of an image loaded with nsvgLoadBinary(), NULL for parsed images.
 } NSVGimage;
 
 // Parses SVG file from a file, returns SVG image as paths.
+// The file is read and tokenized in chunks, it is never loaded into memory as a whole.
 NSVGimage* nsvgParseFromFile(const char* filename, const char* units, float dpi);
 
 // Parses SVG file from a null terminated string, returns SVG image as paths.
 NSVGimage* nsvgParse(char* input, const char* units, float dpi);
 
+// Saves parsed image to a file in a compact binary form, returns 1 on success.
+// The shapes, paths and points are stored as arrays in one block. The file can only
+// be loaded on the same platform by the same version of NanoSVG.
+// The binary functions are only compiled if NANOSVG_BINARY_CACHE is defined along with NANOSVG_IMPLEMENTATION.
+int nsvgSaveBinary(NSVGimage* image, const char* filename);
+
+// Loads image saved with nsvgSaveBinary(). The file is memory mapped and used in place
+// without parsing. Returns NULL if the file cannot be read, is damaged or was saved
+// by another platform or version, in which case the SVG should be parsed again.
+NSVGimage* nsvgLoadBinary(const char* filename);
+
 // Deletes list of paths.
 void nsvgDelete(NSVGimage* image);
 
@@ -171,6 +184,19 @@ void nsvgDelete(NSVGimage* image);
 #include <string.h>
 #include <stdlib.h>
 #include <math.h>
+#ifdef NANOSVG_BINARY_CACHE
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#endif
 
 #define NSVG_PI (3.14159265358979323846264338327f)
 #define NSVG_KAPPA90 (0.5522847493f)	// Lenght proportional to radius of a cubic bezier handle for 90deg arcs.
@@ -222,6 +248,9 @@ static NSVG_INLINE float nsvg__maxf(float a, float b) { return a > b ? a : b; }
 #define NSVG_XML_TAG 1
 #define NSVG_XML_CONTENT 2
 #define NSVG_XML_MAX_ATTRIBS 256
+#ifndef NSVG_XML_CHUNK_SIZE
+#define NSVG_XML_CHUNK_SIZE 16384
+#endif
 
 static void nsvg__parseContent(char* s,
 							   void (*contentCb)(void* ud, const char* s),
@@ -302,33 +331,86 @@ static void nsvg__parseElement(char* s,
 		(*endelCb)(ud, name);
 }
 
-int nsvg__parseXML(char* input,
-				   void (*startelCb)(void* ud, const char* el, const char** attr),
-				   void (*endelCb)(void* ud, const char* el),
-				   void (*contentCb)(void* ud, const char* s),
-				   void* ud)
+// Parses the complete tags and contents of the first n characters of input and returns
+// the number of characters used. The rest is the beginning of an unfinished tag or content.
+static int nsvg__parseXMLSpan(char* input, int n, int* state,
+							  void (*startelCb)(void* ud, const char* el, const char** attr),
+							  void (*endelCb)(void* ud, const char* el),
+							  void (*contentCb)(void* ud, const char* s),
+							  void* ud)
 {
 	char* s = input;
+	char* end = input + n;
 	char* mark = s;
-	int state = NSVG_XML_CONTENT;
-	while (*s) {
-		if (*s == '<' && state == NSVG_XML_CONTENT) {
+	while (s < end) {
+		if (*s == '<' && *state == NSVG_XML_CONTENT) {
 			// Start of a tag
 			*s++ = '\0';
 			nsvg__parseContent(mark, contentCb, ud);
 			mark = s;
-			state = NSVG_XML_TAG;
-		} else if (*s == '>' && state == NSVG_XML_TAG) {
+			*state = NSVG_XML_TAG;
+		} else if (*s == '>' && *state == NSVG_XML_TAG) {
 			// Start of a content or new tag.
 			*s++ = '\0';
 			nsvg__parseElement(mark, startelCb, endelCb, ud);
 			mark = s;
-			state = NSVG_XML_CONTENT;
+			*state = NSVG_XML_CONTENT;
 		} else {
 			s++;
 		}
 	}
 
+	return (int)(mark - input);
+}
+
+int nsvg__parseXML(char* input,
+				   void (*startelCb)(void* ud, const char* el, const char** attr),
+				   void (*endelCb)(void* ud, const char* el),
+				   void (*contentCb)(void* ud, const char* s),
+				   void* ud)
+{
+	int state = NSVG_XML_CONTENT;
+	nsvg__parseXMLSpan(input, (int)strlen(input), &state, startelCb, endelCb, contentCb, ud);
+	return 1;
+}
+
+// Like nsvg__parseXML(), but reads the input from a file in chunks. The buffer only grows
+// when a single tag or content does not fit into it.
+static int nsvg__parseXMLStream(FILE* fp,
+								void (*startelCb)(void* ud, const char* el, const char** attr),
+								void (*endelCb)(void* ud, const char* el),
+								void (*contentCb)(void* ud, const char* s),
+								void* ud)
+{
+	int state = NSVG_XML_CONTENT;
+	int cbuf = NSVG_XML_CHUNK_SIZE;
+	int nbuf = 0;
+	int nread, used;
+	char* buf = (char*)malloc(cbuf+1);
+	if (buf == NULL) return 0;
+
+	for (;;) {
+		if (nbuf == cbuf) {
+			char* newbuf = (char*)realloc(buf, cbuf*2+1);
+			if (newbuf == NULL) {
+				free(buf);
+				return 0;
+			}
+			buf = newbuf;
+			cbuf *= 2;
+		}
+		nread = (int)fread(buf + nbuf, 1, cbuf - nbuf, fp);
+		if (nread <= 0)
+			break;
+		nbuf += nread;
+		buf[nbuf] = '\0';	// Tags and contents are parsed as null terminated strings.
+		used = nsvg__parseXMLSpan(buf, nbuf, &state, startelCb, endelCb, contentCb, ud);
+		// Keep the unfinished tag or content for the next chunk.
+		memmove(buf, buf + used, nbuf - used);
+		nbuf -= used;
+	}
+
+	free(buf);
 	return 1;
 }
 
@@ -2612,10 +2694,24 @@ static void nsvg__scaleToViewbox(NSVGparser* p, const char* units)
 	sy *= us;
 }
 
+static NSVGimage* nsvg__finishParse(NSVGparser* p, const char* units)
+{
+	NSVGimage* ret = 0;
+
+	// Scale to viewBox
+	nsvg__scaleToViewbox(p, units);
+
+	ret = p->image;
+	p->image = NULL;
+
+	nsvg__deleteParser(p);
+
+	return ret;
+}
+
 NSVGimage* nsvgParse(char* input, const char* units, float dpi)
 {
 	NSVGparser* p;
-	NSVGimage* ret = 0;
 
 	p = nsvg__createParser();
 	if (p == NULL) {
@@ -2625,50 +2721,360 @@ NSVGimage* nsvgParse(char* input, const char* units, float dpi)
 
 	nsvg__parseXML(input, nsvg__startElement, nsvg__endElement, nsvg__content, p);
 
-	// Scale to viewBox
-	nsvg__scaleToViewbox(p, units);
+	return nsvg__finishParse(p, units);
+}
 
-	ret = p->image;
-	p->image = NULL;
+NSVGimage* nsvgParseFromFile(const char* filename, const char* units, float dpi)
+{
+	FILE* fp = NULL;
+	NSVGparser* p = NULL;
 
-	nsvg__deleteParser(p);
+	fp = fopen(filename, "rb");
+	if (!fp) goto error;
+	p = nsvg__createParser();
+	if (p == NULL) goto error;
+	p->dpi = dpi;
+
+	if (!nsvg__parseXMLStream(fp, nsvg__startElement, nsvg__endElement, nsvg__content, p))
+		goto error;
+	fclose(fp);
+
+	return nsvg__finishParse(p, units);
+
+error:
+	if (fp) fclose(fp);
+	if (p) nsvg__deleteParser(p);
+	return NULL;
+}
+
+/* Binary images. */
+
+#ifdef NANOSVG_BINARY_CACHE
+
+#define NSVG_BINARY_VERSION 1
+#define NSVG_BINARY_ALIGN 16
+
+// The file is the header followed by the image, the shapes, the paths, the gradients and the points.
+// Pointers are stored as offsets from the beginning of the file, NULL as 0.
+typedef struct NSVGbinaryHeader
+{
+	char magic[4];				// "NSVB"
+	unsigned int version;		// NSVG_BINARY_VERSION
+	unsigned int endian;		// 0x01020304 in the byte order of the writer.
+	unsigned short pointerSize;
+	unsigned short shapeSize;
+	unsigned short pathSize;
+	unsigned short gradientSize;
+	unsigned int size;			// Size of the file in bytes.
+	unsigned int mapped;		// Set when loading, 1 if the file is memory mapped, 0 if it was read.
+} NSVGbinaryHeader;
+
+static size_t nsvg__alignBinary(size_t n)
+{
+	return (n + NSVG_BINARY_ALIGN-1) & ~(size_t)(NSVG_BINARY_ALIGN-1);
+}
+
+static size_t nsvg__gradientSize(const NSVGgradient* grad)
+{
+	return sizeof(NSVGgradient) + sizeof(NSVGgradientStop) * (grad->nstops > 1 ? grad->nstops-1 : 0);
+}
 
+static int nsvg__hasGradient(const NSVGpaint* paint)
+{
+	return paint->type == NSVG_PAINT_LINEAR_GRADIENT || paint->type == NSVG_PAINT_RADIAL_GRADIENT;
+}
+
+// The rasterizer switches on these fields, values outside of their enums come from a damaged file.
+static int nsvg__validBinaryShape(const NSVGshape* shape)
+{
+	return shape->fill.type >= NSVG_PAINT_NONE && shape->fill.type <= NSVG_PAINT_RADIAL_GRADIENT &&
+		shape->stroke.type >= NSVG_PAINT_NONE && shape->stroke.type <= NSVG_PAINT_RADIAL_GRADIENT &&
+		shape->fillRule >= NSVG_FILLRULE_NONZERO && shape->fillRule <= NSVG_FILLRULE_EVENODD &&
+		shape->strokeLineJoin >= NSVG_JOIN_MITER && shape->strokeLineJoin <= NSVG_JOIN_BEVEL &&
+		shape->strokeLineCap >= NSVG_CAP_BUTT && shape->strokeLineCap <= NSVG_CAP_SQUARE;
+}
+
+static void nsvg__initBinaryHeader(NSVGbinaryHeader* header)
+{
+	memset(header, 0, sizeof(NSVGbinaryHeader));
+	memcpy(header->magic, "NSVB", 4);
+	header->version = NSVG_BINARY_VERSION;
+	header->endian = 0x01020304;
+	header->pointerSize = (unsigned short)sizeof(void*);
+	header->shapeSize = (unsigned short)sizeof(NSVGshape);
+	header->pathSize = (unsigned short)sizeof(NSVGpath);
+	header->gradientSize = (unsigned short)sizeof(NSVGgradient);
+}
+
+static size_t nsvg__storeGradient(char* data, size_t offset, NSVGpaint* paint)
+{
+	size_t size = nsvg__gradientSize(paint->gradient);
+	memcpy(data + offset, paint->gradient, size);
+	paint->gradient = (NSVGgradient*)offset;
+	return offset + nsvg__alignBinary(size);
+}
+
+int nsvgSaveBinary(NSVGimage* image, const char* filename)
+{
+	NSVGshape* shape;
+	NSVGpath* path;
+	NSVGimage* dimage;
+	NSVGshape* dshapes;
+	NSVGpath* dpaths;
+	size_t imageOffset, shapeOffset, pathOffset, gradOffset, ptsOffset, size, grads = 0, pts = 0;
+	size_t gradPos, ptsPos;
+	int nshapes = 0, npaths = 0, i = 0, j = 0, ret = 0;
+	char* data = NULL;
+	FILE* fp = NULL;
+
+	if (image == NULL) return 0;
+
+	// Layout
+	for (shape = image->shapes; shape != NULL; shape = shape->next) {
+		nshapes++;
+		if (nsvg__hasGradient(&shape->fill))
+			grads += nsvg__alignBinary(nsvg__gradientSize(shape->fill.gradient));
+		if (nsvg__hasGradient(&shape->stroke))
+			grads += nsvg__alignBinary(nsvg__gradientSize(shape->stroke.gradient));
+		for (path = shape->paths; path != NULL; path = path->next) {
+			npaths++;
+			pts += path->npts * 2 * sizeof(float);
+		}
+	}
+	imageOffset = nsvg__alignBinary(sizeof(NSVGbinaryHeader));
+	shapeOffset = imageOffset + nsvg__alignBinary(sizeof(NSVGimage));
+	pathOffset = shapeOffset + nsvg__alignBinary(nshapes * sizeof(NSVGshape));
+	gradOffset = pathOffset + nsvg__alignBinary(npaths * sizeof(NSVGpath));
+	ptsOffset = gradOffset + grads;
+	size = ptsOffset + pts;
+	if (size > 0xffffffffu) goto error;
+
+	data = (char*)malloc(size);
+	if (data == NULL) goto error;
+	memset(data, 0, size);
+
+	nsvg__initBinaryHeader((NSVGbinaryHeader*)data);
+	((NSVGbinaryHeader*)data)->size = (unsigned int)size;
+
+	dimage = (NSVGimage*)(data + imageOffset);
+	dshapes = (NSVGshape*)(data + shapeOffset);
+	dpaths = (NSVGpath*)(data + pathOffset);
+	dimage->width = image->width;
+	dimage->height = image->height;
+	dimage->shapes = nshapes > 0 ? (NSVGshape*)shapeOffset : NULL;
+	dimage->storage = NULL;
+
+	gradPos = gradOffset;
+	ptsPos = ptsOffset;
+	for (shape = image->shapes; shape != NULL; shape = shape->next, i++) {
+		NSVGshape* dshape = &dshapes[i];
+		*dshape = *shape;
+		if (nsvg__hasGradient(&dshape->fill))
+			gradPos = nsvg__storeGradient(data, gradPos, &dshape->fill);
+		if (nsvg__hasGradient(&dshape->stroke))
+			gradPos = nsvg__storeGradient(data, gradPos, &dshape->stroke);
+		dshape->paths = shape->paths != NULL ? (NSVGpath*)(pathOffset + j * sizeof(NSVGpath)) : NULL;
+		dshape->next = shape->next != NULL ? (NSVGshape*)(shapeOffset + (i+1) * sizeof(NSVGshape)) : NULL;
+		for (path = shape->paths; path != NULL; path = path->next, j++) {
+			NSVGpath* dpath = &dpaths[j];
+			*dpath = *path;
+			memcpy(data + ptsPos, path->pts, path->npts * 2 * sizeof(float));
+			dpath->pts = (float*)ptsPos;
+			ptsPos += path->npts * 2 * sizeof(float);
+			dpath->next = path->next != NULL ? (NSVGpath*)(pathOffset + (j+1) * sizeof(NSVGpath)) : NULL;
+		}
+	}
+
+	fp = fopen(filename, "wb");
+	if (fp == NULL) goto error;
+	if (fwrite(data, 1, size, fp) == size)
+		ret = 1;
+
+error:
+	if (fp) {
+		fclose(fp);
+		if (!ret) remove(filename);
+	}
+	free(data);
 	return ret;
 }
 
-NSVGimage* nsvgParseFromFile(const char* filename, const char* units, float dpi)
+static void nsvg__freeBinary(char* data, size_t size, int mapped)
+{
+	if (mapped) {
+#ifdef _WIN32
+		NSVG_NOTUSED(size);
+		UnmapViewOfFile(data);
+#else
+		munmap(data, size);
+#endif
+	} else {
+		free(data);
+	}
+}
+
+// Maps the file copy-on-write so that the offsets can be turned into pointers in place.
+static char* nsvg__mapBinary(const char* filename, size_t* size)
+{
+	char* data = NULL;
+#ifdef _WIN32
+	HANDLE file, mapping;
+	LARGE_INTEGER fileSize;
+	file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) return NULL;
+	if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart >= (LONGLONG)sizeof(NSVGbinaryHeader) && fileSize.QuadPart <= 0xffffffff) {
+		mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+		if (mapping != NULL) {
+			data = (char*)MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+			CloseHandle(mapping);
+			*size = (size_t)fileSize.QuadPart;
+		}
+	}
+	CloseHandle(file);
+#else
+	struct stat st;
+	int fd = open(filename, O_RDONLY);
+	if (fd < 0) return NULL;
+	if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(NSVGbinaryHeader) && (unsigned long long)st.st_size <= 0xffffffffu) {
+		data = (char*)mmap(NULL, (size_t)st.st_size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
+		if (data == (char*)MAP_FAILED)
+			data = NULL;
+		*size = (size_t)st.st_size;
+	}
+	close(fd);
+#endif
+	return data;
+}
+
+static char* nsvg__readBinary(const char* filename, size_t* size)
 {
 	FILE* fp = NULL;
-	size_t size;
 	char* data = NULL;
-	NSVGimage* image = NULL;
+	long n;
 
 	fp = fopen(filename, "rb");
 	if (!fp) goto error;
 	fseek(fp, 0, SEEK_END);
-	size = ftell(fp);
+	n = ftell(fp);
 	fseek(fp, 0, SEEK_SET);
-	data = (char*)malloc(size+1);
+	if (n < (long)sizeof(NSVGbinaryHeader)) goto error;
+	data = (char*)malloc((size_t)n);
 	if (data == NULL) goto error;
-	fread(data, size, 1, fp);
-	data[size] = '\0';	// Must be null terminated.
+	if (fread(data, 1, (size_t)n, fp) != (size_t)n) goto error;
 	fclose(fp);
-	image = nsvgParse(data, units, dpi);
+	*size = (size_t)n;
+	return data;
+
+error:
+	if (fp) fclose(fp);
 	free(data);
+	return NULL;
+}
+
+// Turns an offset into a pointer to n bytes of the file. Offsets have to increase along
+// the lists, so a damaged file cannot make the loader loop or relocate a pointer twice.
+// Only optional pointers may be NULL, a missing required one marks the file as damaged.
+static char* nsvg__relocate(char* data, size_t size, const void* ptr, size_t n, size_t align, int required, size_t* last, int* ok)
+{
+	size_t offset = (size_t)ptr;
+	if (offset == 0) {
+		if (required)
+			*ok = 0;
+		return NULL;
+	}
+	if (offset <= *last || offset > size || n > size - offset || (offset & (align-1)) != 0) {
+		*ok = 0;
+		return NULL;
+	}
+	*last = offset;
+	return data + offset;
+}
+
+static NSVGgradient* nsvg__relocateGradient(char* data, size_t size, NSVGgradient* grad, size_t* last, int* ok)
+{
+	grad = (NSVGgradient*)nsvg__relocate(data, size, grad, sizeof(NSVGgradient), sizeof(void*), 1, last, ok);
+	if (grad == NULL)
+		return NULL;
+	if (grad->nstops < 0 || nsvg__gradientSize(grad) > size - (size_t)((char*)grad - data) ||
+		grad->spread < NSVG_SPREAD_PAD || grad->spread > NSVG_SPREAD_REPEAT)
+		*ok = 0;
+	return grad;
+}
+
+NSVGimage* nsvgLoadBinary(const char* filename)
+{
+	NSVGbinaryHeader ref;
+	NSVGbinaryHeader* header;
+	NSVGimage* image;
+	NSVGshape* shape;
+	NSVGpath* path;
+	char* data;
+	size_t size = 0, lastShape = 0, lastPath = 0, lastGrad = 0, lastPts = 0;
+	int mapped = 1, ok = 1;
+
+	data = nsvg__mapBinary(filename, &size);
+	if (data == NULL) {
+		mapped = 0;
+		data = nsvg__readBinary(filename, &size);
+		if (data == NULL) return NULL;
+	}
+	header = (NSVGbinaryHeader*)data;
+	header->mapped = (unsigned int)mapped;
+
+	nsvg__initBinaryHeader(&ref);
+	if (memcmp(header->magic, ref.magic, 4) != 0 || header->version != ref.version || header->endian != ref.endian ||
+		header->pointerSize != ref.pointerSize || header->shapeSize != ref.shapeSize ||
+		header->pathSize != ref.pathSize || header->gradientSize != ref.gradientSize ||
+		header->size != size || size < nsvg__alignBinary(sizeof(NSVGbinaryHeader)) + sizeof(NSVGimage))
+		goto error;
+
+	image = (NSVGimage*)(data + nsvg__alignBinary(sizeof(NSVGbinaryHeader)));
+	image->storage = header;
+	lastShape = (size_t)((char*)image - data);
+	image->shapes = (NSVGshape*)nsvg__relocate(data, size, image->shapes, sizeof(NSVGshape), sizeof(void*), 0, &lastShape, &ok);
+	for (shape = image->shapes; shape != NULL && ok; shape = shape->next) {
+		if (!nsvg__validBinaryShape(shape)) {
+			ok = 0;
+			break;
+		}
+		if (nsvg__hasGradient(&shape->fill))
+			shape->fill.gradient = nsvg__relocateGradient(data, size, shape->fill.gradient, &lastGrad, &ok);
+		if (nsvg__hasGradient(&shape->stroke))
+			shape->stroke.gradient = nsvg__relocateGradient(data, size, shape->stroke.gradient, &lastGrad, &ok);
+		shape->paths = (NSVGpath*)nsvg__relocate(data, size, shape->paths, sizeof(NSVGpath), sizeof(void*), 0, &lastPath, &ok);
+		for (path = shape->paths; path != NULL && ok; path = path->next) {
+			// The parser only makes paths of a start point and whole cubic segments, the rasterizer relies on it.
+			if (path->npts < 4 || (path->npts-1) % 3 != 0 || (size_t)path->npts > size / (2 * sizeof(float))) {
+				ok = 0;
+				break;
+			}
+			path->pts = (float*)nsvg__relocate(data, size, path->pts, path->npts * 2 * sizeof(float), sizeof(float), 1, &lastPts, &ok);
+			path->next = (NSVGpath*)nsvg__relocate(data, size, path->next, sizeof(NSVGpath), sizeof(void*), 0, &lastPath, &ok);
+		}
+		shape->next = (NSVGshape*)nsvg__relocate(data, size, shape->next, sizeof(NSVGshape), sizeof(void*), 0, &lastShape, &ok);
+	}
+	if (!ok) goto error;
 
 	return image;
 
 error:
-	if (fp) fclose(fp);
-	if (data) free(data);
-	if (image) nsvgDelete(image);
+	nsvg__freeBinary(data, size, mapped);
 	return NULL;
 }
 
+#endif // NANOSVG_BINARY_CACHE
+
 void nsvgDelete(NSVGimage* image)
 {
 	NSVGshape *snext, *shape;
 	if (image == NULL) return;
+#ifdef NANOSVG_BINARY_CACHE
+	if (image->storage != NULL) {
+		NSVGbinaryHeader* header = (NSVGbinaryHeader*)image->storage;
+		nsvg__freeBinary((char*)header, header->size, (int)header->mapped);
+		return;
+	}
+#endif
 	shape = image->shapes;
 	while (shape != NULL) {
 		snext = shape->next;
@@ -46,6 +46,20 @@ typedef struct NSVGrasterizer NSVGrasterizer;
 // Allocated rasterizer context.
 NSVGrasterizer* nsvgCreateRasterizer();
 
+enum NSVGrasterFlags {
+	// Computes the exact area of each pixel covered by a shape, instead of sampling
+	// each pixel row 5 times. Even-odd fills are approximated where edges cross inside a pixel.
+	NSVG_RAST_ANALYTIC = 1 << 0,
+};
+
+// Allocated rasterizer context with flags from NSVGrasterFlags.
+// Analytic rasterizers split larger images into rows of tiles, which are rasterized by
+// 'nthreads' threads, 0 uses one thread per CPU. The pixels do not depend on the number of threads.
+// Threads are only used if NANOSVGRAST_THREADS is defined along with NANOSVGRAST_IMPLEMENTATION,
+// otherwise 'nthreads' is ignored.
+// Icons are faster to rasterize with one single threaded rasterizer per thread.
+NSVGrasterizer* nsvgCreateRasterizerEx(int flags, int nthreads);
+
 // Rasterizes SVG image, returns RGBA image (non-premultiplied alpha)
 //   r - pointer to rasterizer context
 //   image - pointer to image to rasterize
@@ -73,11 +87,44 @@ void nsvgDeleteRasterizer(NSVGrasterizer*);
 
 #include <math.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NSVG__SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef NANOSVGRAST_THREADS
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#define NSVG__UNDEF_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#define NSVG__UNDEF_NOMINMAX
+#endif
+#include <windows.h>
+#ifdef NSVG__UNDEF_LEAN_AND_MEAN
+#undef WIN32_LEAN_AND_MEAN
+#undef NSVG__UNDEF_LEAN_AND_MEAN
+#endif
+#ifdef NSVG__UNDEF_NOMINMAX
+#undef NOMINMAX
+#undef NSVG__UNDEF_NOMINMAX
+#endif
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+#endif
+
 #define NSVG__SUBSAMPLES	5
 #define NSVG__FIXSHIFT		10
 #define NSVG__FIX			(1 << NSVG__FIXSHIFT)
 #define NSVG__FIXMASK		(NSVG__FIX-1)
 #define NSVG__MEMPAGE_SIZE	1024
+#define NSVG__TILE_ROWS		32		// Height of a row of tiles in analytic mode.
+#define NSVG__MIN_THREADED_PIXELS	(256*256)
+#define NSVG__MAX_THREADS	64
 
 typedef struct NSVGedge {
 	float x0,y0, x1,y1;
@@ -113,6 +160,41 @@ typedef struct NSVGcachedPaint {
 	unsigned int colors[256];
 } NSVGcachedPaint;
 
+// Shape fill or stroke waiting to be rasterized in analytic mode, its edges
+// are layerEdges[first..first+count) sorted by y0.
+typedef struct NSVGlayer {
+	int first, count;
+	float ymin, ymax;
+	float maxHeight;	// Tallest edge, bounds the search for edges crossing a row.
+	char fillRule;
+	NSVGcachedPaint paint;
+} NSVGlayer;
+
+typedef struct NSVGlineEdge {
+	const NSVGedge* e;
+	float dxdy;
+} NSVGlineEdge;
+
+struct NSVGrasterizer;
+
+typedef struct NSVGworker {
+	struct NSVGrasterizer* r;
+	// Signed area and cover accumulated for the current row, width+2 entries, kept zeroed between rows.
+	float* accum;
+	unsigned char* cover;
+	int caccum;
+	NSVGlineEdge* active;
+	int cactive;
+#ifdef NANOSVGRAST_THREADS
+	int generation;
+#ifdef _WIN32
+	HANDLE thread;
+#else
+	pthread_t thread;
+#endif
+#endif
+} NSVGworker;
+
 struct NSVGrasterizer
 {
 	float px, py;
@@ -137,8 +219,40 @@ struct NSVGrasterizer
 
 	unsigned char* bitmap;
 	int width, height, stride;
+
+	// Analytic mode, see nsvgCreateRasterizerEx().
+	int flags;
+	float tx, ty, scale;
+	NSVGlayer* layers;
+	int nlayers;
+	int clayers;
+	NSVGedge* layerEdges;
+	int nlayerEdges;
+	int clayerEdges;
+
+	// Worker threads, workers[0] is the thread calling nsvgRasterize().
+	NSVGworker* workers;
+	int nthreads;
+	int nextTile;
+	int ntiles;
+#ifdef NANOSVGRAST_THREADS
+#ifdef _WIN32
+	CRITICAL_SECTION lock;
+	CONDITION_VARIABLE start;
+	CONDITION_VARIABLE done;
+#else
+	pthread_mutex_t lock;
+	pthread_cond_t start;
+	pthread_cond_t done;
+#endif
+	int generation;
+	int busy;
+	int quit;
+#endif
 };
 
+static void nsvg__stopWorkers(NSVGrasterizer* r);
+
 NSVGrasterizer* nsvgCreateRasterizer()
 {
 	NSVGrasterizer* r = (NSVGrasterizer*)malloc(sizeof(NSVGrasterizer));
@@ -161,6 +275,8 @@ void nsvgDeleteRasterizer(NSVGrasterizer* r)
 
 	if (r == NULL) return;
 
+	nsvg__stopWorkers(r);
+
 	p = r->pages;
 	while (p != NULL) {
 		NSVGmemPage* next = p->next;
@@ -171,6 +287,8 @@ void nsvgDeleteRasterizer(NSVGrasterizer* r)
 	if (r->edges) free(r->edges);
 	if (r->points) free(r->points);
 	if (r->scanline) free(r->scanline);
+	if (r->layers) free(r->layers);
+	if (r->layerEdges) free(r->layerEdges);
 
 	free(r);
 }
@@ -864,130 +982,136 @@ static inline int nsvg__div255(int x)
     return ((x+1) * 257) >> 16;
 }
 
+// Blends color c with coverage over a premultiplied pixel.
+static void nsvg__blendPixel(unsigned char* dst, int cover, unsigned int c)
+{
+	int r,g,b;
+	int a = nsvg__div255(cover * (int)((c >> 24) & 0xff));
+	int ia = 255 - a;
+	// Premultiply
+	r = nsvg__div255((int)(c & 0xff) * a);
+	g = nsvg__div255((int)((c >> 8) & 0xff) * a);
+	b = nsvg__div255((int)((c >> 16) & 0xff) * a);
+
+	// Blend over
+	r += nsvg__div255(ia * (int)dst[0]);
+	g += nsvg__div255(ia * (int)dst[1]);
+	b += nsvg__div255(ia * (int)dst[2]);
+	a += nsvg__div255(ia * (int)dst[3]);
+
+	dst[0] = (unsigned char)r;
+	dst[1] = (unsigned char)g;
+	dst[2] = (unsigned char)b;
+	dst[3] = (unsigned char)a;
+}
+
+#ifdef NSVG__SSE2
+// nsvg__div255() of 8 16-bit values.
+static inline __m128i nsvg__div255x8(__m128i x)
+{
+	return _mm_mulhi_epu16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_set1_epi16(257));
+}
+
+// nsvg__blendPixel() of two pixels unpacked to 16 bits, cover is repeated for the 4 channels of each pixel.
+static inline __m128i nsvg__blend2(__m128i dst, __m128i cover, __m128i c)
+{
+	const __m128i alphaMask = _mm_set_epi16(-1,0,0,0, -1,0,0,0);
+	__m128i ca = _mm_shufflehi_epi16(_mm_shufflelo_epi16(c, _MM_SHUFFLE(3,3,3,3)), _MM_SHUFFLE(3,3,3,3));
+	__m128i a = nsvg__div255x8(_mm_mullo_epi16(cover, ca));
+	__m128i ia = _mm_sub_epi16(_mm_set1_epi16(255), a);
+	__m128i pm = nsvg__div255x8(_mm_mullo_epi16(c, a));
+	pm = _mm_or_si128(_mm_andnot_si128(alphaMask, pm), _mm_and_si128(alphaMask, a));
+	return _mm_add_epi16(pm, nsvg__div255x8(_mm_mullo_epi16(ia, dst)));
+}
+#endif
+
+// Blends 4 pixels, same as nsvg__blendPixel() on each.
+static void nsvg__blend4(unsigned char* dst, const unsigned char* cover, const unsigned int* colors)
+{
+#ifdef NSVG__SSE2
+	__m128i zero = _mm_setzero_si128();
+	__m128i c = _mm_loadu_si128((const __m128i*)colors);
+	__m128i d = _mm_loadu_si128((const __m128i*)dst);
+	__m128i cv = _mm_unpacklo_epi8(_mm_cvtsi32_si128((int)(cover[0] | (cover[1] << 8) | (cover[2] << 16) | ((unsigned int)cover[3] << 24))), zero);
+	cv = _mm_unpacklo_epi16(cv, cv);
+	__m128i lo = nsvg__blend2(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi32(cv, cv), _mm_unpacklo_epi8(c, zero));
+	__m128i hi = nsvg__blend2(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi32(cv, cv), _mm_unpackhi_epi8(c, zero));
+	_mm_storeu_si128((__m128i*)dst, _mm_packus_epi16(lo, hi));
+#else
+	int i;
+	for (i = 0; i < 4; i++)
+		nsvg__blendPixel(&dst[i*4], cover[i], colors[i]);
+#endif
+}
+
 static void nsvg__scanlineSolid(unsigned char* dst, int count, unsigned char* cover, int x, int y,
 								float tx, float ty, float scale, NSVGcachedPaint* cache)
 {
+	unsigned int colors[4];
+	int i = 0;
 
 	if (cache->type == NSVG_PAINT_COLOR) {
-		int i, cr, cg, cb, ca;
-		cr = cache->colors[0] & 0xff;
-		cg = (cache->colors[0] >> 8) & 0xff;
-		cb = (cache->colors[0] >> 16) & 0xff;
-		ca = (cache->colors[0] >> 24) & 0xff;
-
-		for (i = 0; i < count; i++) {
-			int r,g,b;
-			int a = nsvg__div255((int)cover[0] * ca);
-			int ia = 255 - a;
-			// Premultiply
-			r = nsvg__div255(cr * a);
-			g = nsvg__div255(cg * a);
-			b = nsvg__div255(cb * a);
-
-			// Blend over
-			r += nsvg__div255(ia * (int)dst[0]);
-			g += nsvg__div255(ia * (int)dst[1]);
-			b += nsvg__div255(ia * (int)dst[2]);
-			a += nsvg__div255(ia * (int)dst[3]);
-
-			dst[0] = (unsigned char)r;
-			dst[1] = (unsigned char)g;
-			dst[2] = (unsigned char)b;
-			dst[3] = (unsigned char)a;
-
-			cover++;
-			dst += 4;
+		unsigned int c = cache->colors[0];
+		colors[0] = colors[1] = colors[2] = colors[3] = c;
+		for (; i+4 <= count; i += 4) {
+			// Fully covered opaque pixels are replaced.
+			if ((c >> 24) == 255 && (cover[i] & cover[i+1] & cover[i+2] & cover[i+3]) == 255)
+				memcpy(&dst[i*4], colors, 16);
+			else
+				nsvg__blend4(&dst[i*4], &cover[i], colors);
 		}
+		for (; i < count; i++)
+			nsvg__blendPixel(&dst[i*4], cover[i], c);
 	} else if (cache->type == NSVG_PAINT_LINEAR_GRADIENT) {
 		// TODO: spread modes.
-		// TODO: plenty of opportunities to optimize.
 		float fx, fy, dx, gy;
 		float* t = cache->xform;
-		int i, cr, cg, cb, ca;
-		unsigned int c;
+		int n;
 
 		fx = (x - tx) / scale;
 		fy = (y - ty) / scale;
 		dx = 1.0f / scale;
 
-		for (i = 0; i < count; i++) {
-			int r,g,b,a,ia;
-			gy = fx*t[1] + fy*t[3] + t[5];
-			c = cache->colors[(int)nsvg__clampf(gy*255.0f, 0, 255.0f)];
-			cr = (c) & 0xff;
-			cg = (c >> 8) & 0xff;
-			cb = (c >> 16) & 0xff;
-			ca = (c >> 24) & 0xff;
-
-			a = nsvg__div255((int)cover[0] * ca);
-			ia = 255 - a;
-
-			// Premultiply
-			r = nsvg__div255(cr * a);
-			g = nsvg__div255(cg * a);
-			b = nsvg__div255(cb * a);
-
-			// Blend over
-			r += nsvg__div255(ia * (int)dst[0]);
-			g += nsvg__div255(ia * (int)dst[1]);
-			b += nsvg__div255(ia * (int)dst[2]);
-			a += nsvg__div255(ia * (int)dst[3]);
-
-			dst[0] = (unsigned char)r;
-			dst[1] = (unsigned char)g;
-			dst[2] = (unsigned char)b;
-			dst[3] = (unsigned char)a;
-
-			cover++;
-			dst += 4;
-			fx += dx;
+		while (i < count) {
+			for (n = 0; n < 4 && i+n < count; n++) {
+				gy = fx*t[1] + fy*t[3] + t[5];
+				colors[n] = cache->colors[(int)nsvg__clampf(gy*255.0f, 0, 255.0f)];
+				fx += dx;
+			}
+			if (n == 4) {
+				nsvg__blend4(&dst[i*4], &cover[i], colors);
+			} else {
+				for (n = n-1; n >= 0; n--)
+					nsvg__blendPixel(&dst[(i+n)*4], cover[i+n], colors[n]);
+			}
+			i += 4;
 		}
 	} else if (cache->type == NSVG_PAINT_RADIAL_GRADIENT) {
 		// TODO: spread modes.
-		// TODO: plenty of opportunities to optimize.
 		// TODO: focus (fx,fy)
 		float fx, fy, dx, gx, gy, gd;
 		float* t = cache->xform;
-		int i, cr, cg, cb, ca;
-		unsigned int c;
+		int n;
 
 		fx = (x - tx) / scale;
 		fy = (y - ty) / scale;
 		dx = 1.0f / scale;
 
-		for (i = 0; i < count; i++) {
-			int r,g,b,a,ia;
-			gx = fx*t[0] + fy*t[2] + t[4];
-			gy = fx*t[1] + fy*t[3] + t[5];
-			gd = sqrtf(gx*gx + gy*gy);
-			c = cache->colors[(int)nsvg__clampf(gd*255.0f, 0, 255.0f)];
-			cr = (c) & 0xff;
-			cg = (c >> 8) & 0xff;
-			cb = (c >> 16) & 0xff;
-			ca = (c >> 24) & 0xff;
-
-			a = nsvg__div255((int)cover[0] * ca);
-			ia = 255 - a;
-
-			// Premultiply
-			r = nsvg__div255(cr * a);
-			g = nsvg__div255(cg * a);
-			b = nsvg__div255(cb * a);
-
-			// Blend over
-			r += nsvg__div255(ia * (int)dst[0]);
-			g += nsvg__div255(ia * (int)dst[1]);
-			b += nsvg__div255(ia * (int)dst[2]);
-			a += nsvg__div255(ia * (int)dst[3]);
-
-			dst[0] = (unsigned char)r;
-			dst[1] = (unsigned char)g;
-			dst[2] = (unsigned char)b;
-			dst[3] = (unsigned char)a;
-
-			cover++;
-			dst += 4;
-			fx += dx;
+		while (i < count) {
+			for (n = 0; n < 4 && i+n < count; n++) {
+				gx = fx*t[0] + fy*t[2] + t[4];
+				gy = fx*t[1] + fy*t[3] + t[5];
+				gd = sqrtf(gx*gx + gy*gy);
+				colors[n] = cache->colors[(int)nsvg__clampf(gd*255.0f, 0, 255.0f)];
+				fx += dx;
+			}
+			if (n == 4) {
+				nsvg__blend4(&dst[i*4], &cover[i], colors);
+			} else {
+				for (n = n-1; n >= 0; n--)
+					nsvg__blendPixel(&dst[(i+n)*4], cover[i+n], colors[n]);
+			}
+			i += 4;
 		}
 	}
 }
@@ -1200,6 +1324,526 @@ static void nsvg__initPaint(NSVGcachedPaint* cache, NSVGpaint* paint, float opac
 
 }
 
+// Analytic coverage
+//
+// Within a pixel row, every edge adds the signed area between it and the right side of each pixel
+// it crosses to accum[], and the pixels to the right of it get the full height the edge spans.
+// The coverage of a pixel is the running sum of accum[] up to it. Rows are rasterized in tiles of
+// NSVG__TILE_ROWS rows, which draw all layers in order, so tiles can be rasterized in parallel.
+
+static void nsvg__accumulateSegment(float* accum, float x0, float x1, float d)
+{
+	// x0 <= x1, both inside [0,width].
+	int x0i = (int)x0;
+	int x1i = (int)ceilf(x1);
+	int xi;
+	if (x1i <= x0i + 1) {
+		// Within one pixel, the area is given by the middle of the segment.
+		float xmf = 0.5f*(x0 + x1) - x0i;
+		accum[x0i] += d - d*xmf;
+		accum[x0i+1] += d*xmf;
+	} else {
+		float s = 1.0f / (x1 - x0);
+		float x0f = x0 - x0i;
+		float a0 = 0.5f * s * (1.0f - x0f) * (1.0f - x0f);
+		float x1f = x1 - x1i + 1.0f;
+		float am = 0.5f * s * x1f * x1f;
+		accum[x0i] += d*a0;
+		if (x1i == x0i + 2) {
+			accum[x0i+1] += d*(1.0f - a0 - am);
+		} else {
+			float a1 = s * (1.5f - x0f);
+			float a2 = a1 + (x1i - x0i - 3) * s;
+			accum[x0i+1] += d*(a1 - a0);
+			for (xi = x0i+2; xi < x1i-1; xi++)
+				accum[xi] += d*s;
+			accum[x1i-1] += d*(1.0f - a2 - am);
+		}
+		accum[x1i] += d*am;
+	}
+}
+
+static void nsvg__accumulateClipped(float* accum, float width, float xa, float xb, float d)
+{
+	float lo = xa < xb ? xa : xb;
+	float hi = xa < xb ? xb : xa;
+	float inv;
+
+	if (lo >= width) return;	// Only pixels right of the image.
+	if (hi <= 0.0f) {
+		accum[0] += d;			// Covers the whole row left of the image.
+		return;
+	}
+	if (lo >= 0.0f && hi <= width) {
+		nsvg__accumulateSegment(accum, lo, hi, d);
+		return;
+	}
+	// The part left of the image covers column 0, the part right of it is not visible.
+	inv = d / (hi - lo);	// Height per unit of x.
+	if (lo < 0.0f) {
+		accum[0] += -lo * inv;
+		lo = 0.0f;
+	}
+	if (hi > width)
+		hi = width;
+	nsvg__accumulateSegment(accum, lo, hi, (hi - lo) * inv);
+}
+
+// Turns accum[x0..x1] into coverage and clears it.
+static void nsvg__resolveCoverage(float* accum, unsigned char* cover, int x0, int x1, char fillRule)
+{
+	int x = x0;
+#ifdef NSVG__SSE2
+	__m128 zero = _mm_setzero_ps();
+	__m128 sign = _mm_set1_ps(-0.0f);
+	__m128 one = _mm_set1_ps(1.0f);
+	__m128 two = _mm_set1_ps(2.0f);
+	__m128 half = _mm_set1_ps(0.5f);
+	__m128 carry = zero;
+	// The buffers are padded so that the last 4 may run past x1.
+	for (; x <= x1; x += 4) {
+		__m128 v = _mm_loadu_ps(&accum[x]);
+		__m128 c;
+		__m128i ci;
+		int packed;
+		_mm_storeu_ps(&accum[x], zero);
+		v = _mm_add_ps(v, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 4)));
+		v = _mm_add_ps(v, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 8)));
+		v = _mm_add_ps(v, carry);
+		carry = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3,3,3,3));
+		c = _mm_andnot_ps(sign, v);
+		if (fillRule == NSVG_FILLRULE_EVENODD) {
+			__m128 h = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(c, half)));
+			c = _mm_sub_ps(c, _mm_add_ps(h, h));
+			c = _mm_min_ps(c, _mm_sub_ps(two, c));
+		}
+		c = _mm_min_ps(c, one);
+		ci = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(c, _mm_set1_ps(255.0f)), half));
+		ci = _mm_packs_epi32(ci, ci);
+		packed = _mm_cvtsi128_si32(_mm_packus_epi16(ci, ci));
+		memcpy(&cover[x], &packed, 4);
+	}
+#else
+	float sum = 0.0f;
+	for (; x <= x1; x++) {
+		float c;
+		sum += accum[x];
+		accum[x] = 0.0f;
+		c = nsvg__absf(sum);
+		if (fillRule == NSVG_FILLRULE_EVENODD) {
+			c -= 2.0f * (float)(int)(c * 0.5f);
+			if (c > 1.0f) c = 2.0f - c;
+		}
+		if (c > 1.0f) c = 1.0f;
+		cover[x] = (unsigned char)(int)(c * 255.0f + 0.5f);
+	}
+#endif
+}
+
+static void nsvg__rasterizeLayerRows(NSVGworker* wk, const NSVGlayer* layer, int y0, int y1)
+{
+	NSVGrasterizer* r = wk->r;
+	const NSVGedge* edges = &r->layerEdges[layer->first];
+	float width = (float)r->width;
+	int i, j, y, next, lo, hi, nactive = 0;
+	float ys;
+
+	// Edges starting more than the tallest edge above the rows end before them.
+	ys = (float)y0 - layer->maxHeight;
+	lo = 0;
+	hi = layer->count;
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+		if (edges[mid].y0 <= ys) lo = mid+1;
+		else hi = mid;
+	}
+	next = lo;
+
+	for (y = y0; y < y1; y++) {
+		float top = (float)y, bottom = (float)(y+1);
+		int xmin = r->width+1, xmax = -1, xend;
+
+		// Update the active edges, drop the ones that ended and add the ones starting on this row.
+		for (i = j = 0; i < nactive; i++) {
+			if (wk->active[i].e->y1 > top)
+				wk->active[j++] = wk->active[i];
+		}
+		nactive = j;
+		while (next < layer->count && edges[next].y0 < bottom) {
+			const NSVGedge* e = &edges[next++];
+			if (e->y1 <= top) continue;
+			if (nactive+1 > wk->cactive) {
+				NSVGlineEdge* active;
+				int cactive = wk->cactive > 0 ? wk->cactive * 2 : 64;
+				active = (NSVGlineEdge*)realloc(wk->active, sizeof(NSVGlineEdge) * cactive);
+				if (active == NULL) return;
+				wk->active = active;
+				wk->cactive = cactive;
+			}
+			wk->active[nactive].e = e;
+			wk->active[nactive].dxdy = (e->x1 - e->x0) / (e->y1 - e->y0);
+			nactive++;
+		}
+		if (nactive == 0) {
+			if (next >= layer->count) break;
+			continue;
+		}
+
+		for (i = 0; i < nactive; i++) {
+			const NSVGedge* e = wk->active[i].e;
+			float dxdy = wk->active[i].dxdy;
+			float ya = e->y0 > top ? e->y0 : top;
+			float yb = e->y1 < bottom ? e->y1 : bottom;
+			float xa = e->x0 + (ya - e->y0) * dxdy;
+			float xb = e->x0 + (yb - e->y0) * dxdy;
+			float xl = xa < xb ? xa : xb;
+			float xr = xa < xb ? xb : xa;
+			int xli, xri;
+			if (xl >= width) {
+				// Not drawn, but the pixels left of it may be covered up to the right side.
+				xmax = r->width+1;
+				continue;
+			}
+			// Pixels touched by nsvg__accumulateClipped().
+			xli = xl < 0.0f ? 0 : (int)xl;
+			xri = xr < 0.0f ? 1 : (xr + 2.0f > width + 1.0f ? r->width+1 : (int)(xr + 2.0f));
+			if (xli < xmin) xmin = xli;
+			if (xri > xmax) xmax = xri;
+			nsvg__accumulateClipped(wk->accum, width, xa, xb, (yb - ya) * e->dir);
+		}
+		if (xmin > xmax) continue;
+
+		// Everything right of the rightmost edge sums to zero.
+		xend = xmax < r->width-1 ? xmax : r->width-1;
+		nsvg__resolveCoverage(wk->accum, wk->cover, xmin, xend, layer->fillRule);
+		for (i = xend+1; i <= xmax; i++)
+			wk->accum[i] = 0.0f;
+
+		while (xmin <= xend && wk->cover[xmin] == 0) xmin++;
+		while (xend >= xmin && wk->cover[xend] == 0) xend--;
+		if (xmin <= xend) {
+			nsvg__scanlineSolid(&r->bitmap[y * r->stride] + xmin*4, xend-xmin+1, &wk->cover[xmin], xmin, y,
+								r->tx, r->ty, r->scale, (NSVGcachedPaint*)&layer->paint);
+		}
+	}
+}
+
+static void nsvg__lock(NSVGrasterizer* r)
+{
+#ifdef NANOSVGRAST_THREADS
+#ifdef _WIN32
+	EnterCriticalSection(&r->lock);
+#else
+	pthread_mutex_lock(&r->lock);
+#endif
+#else
+	(void)r;
+#endif
+}
+
+static void nsvg__unlock(NSVGrasterizer* r)
+{
+#ifdef NANOSVGRAST_THREADS
+#ifdef _WIN32
+	LeaveCriticalSection(&r->lock);
+#else
+	pthread_mutex_unlock(&r->lock);
+#endif
+#else
+	(void)r;
+#endif
+}
+
+// Rasterizes tiles until there are none left, called by all threads.
+static void nsvg__rasterizeTiles(NSVGworker* wk)
+{
+	NSVGrasterizer* r = wk->r;
+	int i;
+	for (;;) {
+		int tile, y0, y1;
+		nsvg__lock(r);
+		tile = r->nextTile < r->ntiles ? r->nextTile++ : -1;
+		nsvg__unlock(r);
+		if (tile < 0) break;
+		y0 = tile * NSVG__TILE_ROWS;
+		y1 = y0 + NSVG__TILE_ROWS < r->height ? y0 + NSVG__TILE_ROWS : r->height;
+		for (i = 0; i < r->nlayers; i++) {
+			const NSVGlayer* layer = &r->layers[i];
+			if (layer->ymin < (float)y1 && layer->ymax > (float)y0)
+				nsvg__rasterizeLayerRows(wk, layer, y0, y1);
+		}
+	}
+}
+
+#ifdef NANOSVGRAST_THREADS
+
+#ifdef _WIN32
+static DWORD WINAPI nsvg__workerMain(LPVOID arg)
+#else
+static void* nsvg__workerMain(void* arg)
+#endif
+{
+	NSVGworker* wk = (NSVGworker*)arg;
+	NSVGrasterizer* r = wk->r;
+
+	nsvg__lock(r);
+	for (;;) {
+		while (wk->generation == r->generation && !r->quit) {
+#ifdef _WIN32
+			SleepConditionVariableCS(&r->start, &r->lock, INFINITE);
+#else
+			pthread_cond_wait(&r->start, &r->lock);
+#endif
+		}
+		if (r->quit) break;
+		wk->generation = r->generation;
+		nsvg__unlock(r);
+
+		nsvg__rasterizeTiles(wk);
+
+		nsvg__lock(r);
+		if (--r->busy == 0) {
+#ifdef _WIN32
+			WakeConditionVariable(&r->done);
+#else
+			pthread_cond_signal(&r->done);
+#endif
+		}
+	}
+	nsvg__unlock(r);
+	return 0;
+}
+
+static int nsvg__cpuCount(void)
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (int)info.dwNumberOfProcessors;
+#else
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return n > 0 ? (int)n : 1;
+#endif
+}
+
+#endif // NANOSVGRAST_THREADS
+
+NSVGrasterizer* nsvgCreateRasterizerEx(int flags, int nthreads)
+{
+	NSVGrasterizer* r = nsvgCreateRasterizer();
+	int i;
+	if (r == NULL) return NULL;
+
+	r->flags = flags;
+	if (!(flags & NSVG_RAST_ANALYTIC))
+		return r;
+
+#ifdef NANOSVGRAST_THREADS
+	if (nthreads <= 0)
+		nthreads = nsvg__cpuCount();
+	if (nthreads > NSVG__MAX_THREADS)
+		nthreads = NSVG__MAX_THREADS;
+#else
+	nthreads = 1;
+#endif
+
+	r->workers = (NSVGworker*)malloc(sizeof(NSVGworker) * nthreads);
+	if (r->workers == NULL) goto error;
+	memset(r->workers, 0, sizeof(NSVGworker) * nthreads);
+	for (i = 0; i < nthreads; i++)
+		r->workers[i].r = r;
+
+#ifdef NANOSVGRAST_THREADS
+#ifdef _WIN32
+	InitializeCriticalSection(&r->lock);
+	InitializeConditionVariable(&r->start);
+	InitializeConditionVariable(&r->done);
+#else
+	pthread_mutex_init(&r->lock, NULL);
+	pthread_cond_init(&r->start, NULL);
+	pthread_cond_init(&r->done, NULL);
+#endif
+
+	for (i = 1; i < nthreads; i++) {
+#ifdef _WIN32
+		r->workers[i].thread = CreateThread(NULL, 0, nsvg__workerMain, &r->workers[i], 0, NULL);
+		if (r->workers[i].thread == NULL) break;
+#else
+		if (pthread_create(&r->workers[i].thread, NULL, nsvg__workerMain, &r->workers[i]) != 0) break;
+#endif
+	}
+	// Rasterize with the threads that could be started.
+	r->nthreads = i;
+#else
+	r->nthreads = 1;
+#endif
+
+	return r;
+
+error:
+	nsvgDeleteRasterizer(r);
+	return NULL;
+}
+
+static void nsvg__stopWorkers(NSVGrasterizer* r)
+{
+	int i;
+	if (r->workers == NULL) return;
+
+#ifdef NANOSVGRAST_THREADS
+	nsvg__lock(r);
+	r->quit = 1;
+#ifdef _WIN32
+	WakeAllConditionVariable(&r->start);
+#else
+	pthread_cond_broadcast(&r->start);
+#endif
+	nsvg__unlock(r);
+	for (i = 1; i < r->nthreads; i++) {
+#ifdef _WIN32
+		WaitForSingleObject(r->workers[i].thread, INFINITE);
+		CloseHandle(r->workers[i].thread);
+#else
+		pthread_join(r->workers[i].thread, NULL);
+#endif
+	}
+#ifdef _WIN32
+	DeleteCriticalSection(&r->lock);
+#else
+	pthread_cond_destroy(&r->start);
+	pthread_cond_destroy(&r->done);
+	pthread_mutex_destroy(&r->lock);
+#endif
+#endif
+
+	for (i = 0; i < r->nthreads; i++) {
+		if (r->workers[i].accum) free(r->workers[i].accum);
+		if (r->workers[i].cover) free(r->workers[i].cover);
+		if (r->workers[i].active) free(r->workers[i].active);
+	}
+	free(r->workers);
+	r->workers = NULL;
+}
+
+// Adds the edges of the flattened fill or stroke in r->edges as a layer.
+static void nsvg__addLayer(NSVGrasterizer* r, NSVGpaint* paint, float opacity, char fillRule)
+{
+	NSVGlayer* layer;
+	int i;
+
+	if (r->nedges == 0) return;
+
+	if (r->nlayers+1 > r->clayers) {
+		NSVGlayer* layers;
+		int clayers = r->clayers > 0 ? r->clayers * 2 : 16;
+		layers = (NSVGlayer*)realloc(r->layers, sizeof(NSVGlayer) * clayers);
+		if (layers == NULL) return;
+		r->layers = layers;
+		r->clayers = clayers;
+	}
+	if (r->nlayerEdges + r->nedges > r->clayerEdges) {
+		NSVGedge* edges;
+		int cedges = r->clayerEdges > 0 ? r->clayerEdges : 256;
+		while (cedges < r->nlayerEdges + r->nedges) cedges *= 2;
+		edges = (NSVGedge*)realloc(r->layerEdges, sizeof(NSVGedge) * cedges);
+		if (edges == NULL) return;
+		r->layerEdges = edges;
+		r->clayerEdges = cedges;
+	}
+
+	layer = &r->layers[r->nlayers++];
+	layer->first = r->nlayerEdges;
+	layer->count = r->nedges;
+	layer->ymin = 1e30f;
+	layer->ymax = -1e30f;
+	layer->maxHeight = 0.0f;
+	layer->fillRule = fillRule;
+	for (i = 0; i < r->nedges; i++) {
+		NSVGedge* e = &r->edges[i];
+		e->x0 += r->tx;
+		e->y0 += r->ty;
+		e->x1 += r->tx;
+		e->y1 += r->ty;
+		if (e->y0 < layer->ymin) layer->ymin = e->y0;
+		if (e->y1 > layer->ymax) layer->ymax = e->y1;
+		if (e->y1 - e->y0 > layer->maxHeight) layer->maxHeight = e->y1 - e->y0;
+	}
+	qsort(r->edges, r->nedges, sizeof(NSVGedge), nsvg__cmpEdge);
+	memcpy(&r->layerEdges[r->nlayerEdges], r->edges, sizeof(NSVGedge) * r->nedges);
+	r->nlayerEdges += r->nedges;
+
+	nsvg__initPaint(&layer->paint, paint, opacity);
+}
+
+static void nsvg__rasterizeAnalytic(NSVGrasterizer* r, NSVGimage* image)
+{
+	NSVGshape* shape;
+	int i;
+
+	r->nlayers = 0;
+	r->nlayerEdges = 0;
+	for (shape = image->shapes; shape != NULL; shape = shape->next) {
+		if (shape->fill.type != NSVG_PAINT_NONE) {
+			r->nedges = 0;
+			nsvg__flattenShape(r, shape, r->scale);
+			nsvg__addLayer(r, &shape->fill, shape->opacity, shape->fillRule);
+		}
+		if (shape->stroke.type != NSVG_PAINT_NONE && (shape->strokeWidth * r->scale) > 0.01f) {
+			r->nedges = 0;
+			nsvg__flattenShapeStroke(r, shape, r->scale);
+			nsvg__addLayer(r, &shape->stroke, shape->opacity, NSVG_FILLRULE_NONZERO);
+		}
+	}
+
+	// Row buffers, padded for nsvg__resolveCoverage().
+	for (i = 0; i < r->nthreads; i++) {
+		NSVGworker* wk = &r->workers[i];
+		if (wk->caccum < r->width + 6) {
+			float* accum = (float*)realloc(wk->accum, sizeof(float) * (r->width + 6));
+			unsigned char* cover;
+			if (accum == NULL) return;
+			wk->accum = accum;
+			cover = (unsigned char*)realloc(wk->cover, r->width + 6);
+			if (cover == NULL) return;
+			wk->cover = cover;
+			wk->caccum = r->width + 6;
+			memset(wk->accum, 0, sizeof(float) * wk->caccum);
+		}
+	}
+
+	nsvg__lock(r);
+	r->ntiles = (r->height + NSVG__TILE_ROWS-1) / NSVG__TILE_ROWS;
+	r->nextTile = 0;
+#ifdef NANOSVGRAST_THREADS
+	r->busy = 0;
+	// Small images are not worth waking up the workers.
+	if (r->width * r->height >= NSVG__MIN_THREADED_PIXELS && r->nthreads > 1) {
+		r->busy = r->nthreads - 1;
+		r->generation++;
+#ifdef _WIN32
+		WakeAllConditionVariable(&r->start);
+#else
+		pthread_cond_broadcast(&r->start);
+#endif
+	}
+#endif
+	nsvg__unlock(r);
+
+	nsvg__rasterizeTiles(&r->workers[0]);
+
+#ifdef NANOSVGRAST_THREADS
+	nsvg__lock(r);
+	while (r->busy > 0) {
+#ifdef _WIN32
+		SleepConditionVariableCS(&r->done, &r->lock, INFINITE);
+#else
+		pthread_cond_wait(&r->done, &r->lock);
+#endif
+	}
+	nsvg__unlock(r);
+#endif
+}
+
 /*
 static void dumpEdges(NSVGrasterizer* r, const char* name)
 {
@@ -1265,6 +1909,19 @@ void nsvgRasterize(NSVGrasterizer* r,
 	for (i = 0; i < h; i++)
 		memset(&dst[i*stride], 0, w*4);
 
+	if (r->flags & NSVG_RAST_ANALYTIC) {
+		r->tx = tx;
+		r->ty = ty;
+		r->scale = scale;
+		nsvg__rasterizeAnalytic(r, image);
+		nsvg__unpremultiplyAlpha(dst, w, h, stride);
+		r->bitmap = NULL;
+		r->width = 0;
+		r->height = 0;
+		r->stride = 0;
+		return;
+	}
+
 	for (shape = image->shapes; shape != NULL; shape = shape->next) {
 		if (shape->fill.type != NSVG_PAINT_NONE) {
 			nsvg__resetPool(r);
@@ -601,6 +601,9 @@ end
             "libs/physics/bullet2/**.h",
             "libs/physics/bullet2/**.cpp",
         }
+        excludes {
+            "libs/physics/bullet2/bench/**.cpp",
+        }
 
     project "box2d"
         kind "StaticLib"